@@ -0,0 +1,109 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef TNN_INCLUDE_TNN_CORE_BATCH_SCHEDULER_H_
+#define TNN_INCLUDE_TNN_CORE_BATCH_SCHEDULER_H_
+
+#include <future>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tnn/core/common.h"
+#include "tnn/core/instance.h"
+#include "tnn/core/macro.h"
+#include "tnn/core/mat.h"
+#include "tnn/core/status.h"
+#include "tnn/utils/blob_converter.h"
+
+#pragma warning(push)
+#pragma warning(disable : 4251)
+
+namespace TNN_NS {
+
+struct PUBLIC BatchSchedulerConfig {
+    // max batch of one forward, the instance must be created with max inputs shape of this batch
+    int max_batch_size = 8;
+    // max time in microseconds the oldest request waits for others to join its batch
+    int max_delay_us = 2000;
+    // requests submitted while this many are pending fail with TNNERR_INST_ERR, 0 for no limit
+    int max_queue_size = 0;
+    // convert params of inputs by name, default param for inputs not in the map
+    std::map<std::string, MatConvertParam> input_params = {};
+    // convert param of all outputs
+    MatConvertParam output_param = MatConvertParam();
+    // device and mat type of the output mats, must be cpu memory
+    DeviceType output_device = DEVICE_NAIVE;
+    MatType output_mat_type  = NCHW_FLOAT;
+};
+
+struct PUBLIC BatchResult {
+    Status status;
+    // output mats of the request, batch equals the batch of its input mats
+    MatMap outputs = {};
+};
+
+struct PUBLIC BatchSchedulerStats {
+    // requests waiting in the queue
+    int queue_depth = 0;
+    int64_t request_count = 0;
+    int64_t batch_count   = 0;
+    // batch_size_histogram[n] is the number of forwards run with batch n
+    std::vector<int64_t> batch_size_histogram = {};
+    // latency from submit to result of recent requests, in milliseconds
+    double latency_p50_ms = 0;
+    double latency_p90_ms = 0;
+    double latency_p99_ms = 0;
+    double latency_max_ms = 0;
+};
+
+class BatchSchedulerImpl;
+
+// @brief BatchScheduler coalesces requests into batches for one instance.
+// Requests are queued until max_batch_size samples are pending or the oldest one
+// waited max_delay_us, then their input mats are concatenated along the batch,
+// the instance is reshaped to the batch and forwarded once, and the output mats
+// are split back to the requests. Only requests of the same input shapes run in
+// one batch. Mats of inputs and outputs must be in cpu memory.
+class PUBLIC BatchScheduler {
+public:
+    BatchScheduler(std::shared_ptr<Instance> instance, BatchSchedulerConfig config);
+
+    ~BatchScheduler();
+
+    // @brief start the scheduler thread
+    Status Start();
+
+    // @brief stop the scheduler, pending requests are still run
+    Status Stop();
+
+    // @brief submit a request with input mats by input name, the mat batch is usually 1
+    std::future<BatchResult> Submit(MatMap inputs);
+
+    // @brief get queue depth, batch size histogram and latency percentiles
+    BatchSchedulerStats GetStats();
+
+    // @brief clear the counters of stats
+    void ResetStats();
+
+private:
+    std::shared_ptr<BatchSchedulerImpl> impl_ = nullptr;
+};
+
+}  // namespace TNN_NS
+
+#pragma warning(pop)
+
+#endif  // TNN_INCLUDE_TNN_CORE_BATCH_SCHEDULER_H_
@@ -69,21 +69,25 @@ typedef enum {
     // ARM: prefer fp16, enable approximate calculation
     // OPENCL: prefer fp16
     // METAL: prefer fp16
+    // X86: run with fp32
     PRECISION_AUTO = -1,
     // Normal precision
     // ARM: prefer fp16, disable approximate calculation
     // OPNECL: run with mixed pricision
     // METAL: run with fp16
+    // X86: fp16 gemm weights if the cpu has f16c, fp32 activations and accumulation
     PRECISION_NORMAL = 0,
     // High precision
     // ARM: run with fp32
     // OPENCL: run with fp32
     // METAL: run with fp16
+    // X86: run with fp32
     PRECISION_HIGH = 1,
     // Low precision
     // ARM: run with bfp16
     // OPENCL: run with fp16
     // METAL: run with fp16
+    // X86: bfp16 gemm weights, fp32 activations and accumulation
     PRECISION_LOW = 2
 } Precision;
 
@@ -124,6 +128,14 @@ typedef enum {
     SHARE_MEMORY_MODE_SET_FROM_EXTERNAL = 2
 } ShareMemoryMode;
 
+typedef enum {
+    // blobs with disjoint lifetime reuse the whole buffer of the nearest size
+    MEMORY_PLAN_MODE_NEAREST_SIZE = 0,
+    // blobs are packed into one arena by offsets solved from their live ranges,
+    // only for cpu devices
+    MEMORY_PLAN_MODE_OFFSET_PACK = 1
+} MemoryPlanMode;
+
 typedef enum {
     MODEL_TYPE_TNN      = 0x0001,
     MODEL_TYPE_NCNN     = 0x0100,
@@ -155,6 +167,9 @@ struct PUBLIC NetworkConfig {
     // raidnet instances not share memory with others
     ShareMemoryMode share_memory_mode = SHARE_MEMORY_MODE_DEFAULT;
 
+    // how blob memory is planned, works with all share memory modes
+    MemoryPlanMode memory_plan_mode = MEMORY_PLAN_MODE_NEAREST_SIZE;
+
     // dependent library path
     std::vector<std::string> library_path = {};
 
@@ -167,12 +182,36 @@ struct PUBLIC NetworkConfig {
     // network init or reshape may cost more time to select opt kernel implement if enable tune kernel
     // cache_path can set to store tune kernel info.
     bool enable_tune_kernel = false;
+
+    // max number of independent layers running concurrently, only for cpu devices.
+    // default 1 runs layers in order, threads set by SetCpuNumThreads are split
+    // across the concurrently running layers if greater than 1.
+    int inter_op_num_threads = 1;
+
+    // cpus the compute threads of x86, arm and cpu devices are bound to, empty for no binding.
+    // instances bound to disjoint cpus do not compete for cores.
+    std::vector<int> cpu_affinity = {};
+
+    // max number of input shapes whose reshape plans are kept, default 0 disables it.
+    // reshaping back to a cached shape skips the shape inference of element-wise,
+    // normalization, inner product, concat and permute layers, the other layers infer again.
+    int reshape_plan_cache_size = 0;
+
+    // threads initializing the layer accs of x86 and naive devices concurrently, opt in.
+    // default 1 initializes layers in order, 0 for the number of cpu cores.
+    int init_num_threads = 1;
+
+    // save the packed weights of the layer accs to a file in cache_path, later inits of the
+    // same model, device, precision and instruction sets map them instead of packing again.
+    bool enable_packed_weight_file = false;
 };
 
 struct PUBLIC ModelConfig {
     ModelType model_type = MODEL_TYPE_TNN;
 
     // tnn model need two params: order is proto content, model content.
+    // tnn model content can also be given as "ModelPath:" + model file path, the file
+    // is memory mapped and aligned weights are used in place instead of being copied.
     // ncnn need two: params: order is param, weights.
     // openvino model need two params: order is xml content, model path.
     // coreml model need one param: coreml model dir.
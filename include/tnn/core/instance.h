@@ -17,6 +17,7 @@
 
 #include <functional>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "tnn/core/blob.h"
@@ -32,6 +33,7 @@ namespace TNN_NS {
 
 class AbstractNetwork;
 class AbstractModelInterpreter;
+class InstanceState;
 
 struct LayerInfo;
 
@@ -57,6 +59,10 @@ public:
     //  return memory bytes required for forward
     Status GetForwardMemorySize(int& memory_size);
 
+    //  return memory bytes used by blobs alive at the same time, no memory plan needs less than it.
+    //  only supported with MEMORY_PLAN_MODE_OFFSET_PACK.
+    Status GetForwardMemoryLowerBound(int& memory_size);
+
     //  set memory to tnn instance. if success, return status code zero.
     //  only instance created with SHARE_MEMORY_MODE_SET_FROM_EXTERNAL can be set from external.
     //  the memory size need >=  GetForwardMemorySize().
@@ -100,6 +106,30 @@ public:
     // set threads run on cpu
     Status SetCpuNumThreads(int num_threads);
 
+    // @brief declare a state blob pair, the output blob output_name of one forward is the
+    // input blob input_name of the next one, e.g. hidden and cell of LSTMs. state blobs are
+    // bound to persistent memory out of the forward memory and states start from zero.
+    // call it after Init, the pairs must have the same shape and data type.
+    Status DeclareState(const std::string& input_name, const std::string& output_name);
+
+    // @brief set all states of the current stream to zero
+    Status ResetState();
+
+    // @brief copy the states of the current stream to snapshot, it is created if null
+    Status SnapshotState(std::shared_ptr<InstanceState>& snapshot);
+
+    // @brief copy the states in snapshot to the current stream
+    Status RestoreState(std::shared_ptr<InstanceState> snapshot);
+
+    // @brief create the zero states of a new stream
+    Status CreateState(std::shared_ptr<InstanceState>& state);
+
+    // @brief switch to the stream of state without copying, following forwards update it in place
+    Status SetState(std::shared_ptr<InstanceState> state);
+
+    // @brief get the state of the current stream
+    Status GetState(std::shared_ptr<InstanceState>& state);
+
 #if TNN_PROFILE
 public:
     /**start to profile each layer, dont call this func if you only want to profile the whole mode*/
@@ -116,6 +146,13 @@ private:
     ModelConfig model_config_;
     
     AbstractNetwork *GetNetwork();
+
+    Status GetStateBlobs(std::vector<std::pair<Blob *, Blob *>>& blobs, std::vector<BlobDesc>& descs);
+    Status BindState();
+
+    // state blob pairs {input, output}
+    std::vector<std::pair<std::string, std::string>> state_names_ = {};
+    std::shared_ptr<InstanceState> state_ = nullptr;
     
     //Mat interface for simple use
 public:
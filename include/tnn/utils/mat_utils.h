@@ -15,8 +15,10 @@
 #ifndef TNN_INCLUDE_TNN_UTILS_MAT_UTILS_H_
 #define TNN_INCLUDE_TNN_UTILS_MAT_UTILS_H_
 
+#include "tnn/core/blob.h"
 #include "tnn/core/status.h"
 #include "tnn/core/mat.h"
+#include "tnn/utils/blob_converter.h"
 
 namespace TNN_NS {
 
@@ -73,6 +75,15 @@ struct PUBLIC CopyMakeBorderParam {
     float border_val       = 0.0f;
 };
 
+struct PUBLIC PreprocessParam {
+    // region of src to use, the whole src when width or height is 0
+    CropParam crop;
+    // interpolation used to resize the crop region to the blob height and width
+    InterpType interp_type = INTERP_TYPE_LINEAR;
+    // scale, bias and reverse_channel applied when writing to the blob
+    MatConvertParam convert_param;
+};
+
 class PUBLIC MatUtils {
 public:
     //copy cpu <-> device, cpu<->cpu, device<->device, src and dst dims must be equal.
@@ -94,6 +105,11 @@ public:
 
     //src and dst device type must be same. param top, bottom, left and right must be non-negative.
     static Status CopyMakeBorder(Mat& src, Mat& dst, CopyMakeBorderParam param, void* command_queue);
+
+    //convert color, crop, resize and normalize src into blob. nv12/nv21 src are converted to bgr, the crop region is
+    //resized to the blob height and width. devices with a fused implementation do all steps in one pass without
+    //intermediate mats, others run CvtColor, Crop, Resize and BlobConverter::ConvertFromMat in turn.
+    static Status Preprocess(Mat& src, Blob* blob, PreprocessParam param, void* command_queue);
 };
 
 }  // namespace TNN_NS
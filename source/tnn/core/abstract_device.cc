@@ -48,6 +48,10 @@ std::shared_ptr<const ImplementedLayout> AbstractDevice::GetImplementedLayout(La
     return std::make_shared<ImplementedLayout>();
 }
 
+std::string AbstractDevice::GetIsaTag() {
+    return "";
+}
+
 AbstractDevice* GetDevice(DeviceType type) {
     return GetGlobalDeviceMap()[type].get();
 }
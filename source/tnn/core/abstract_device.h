@@ -98,6 +98,9 @@ public:
     // @brief auto network type decided by device.
     virtual NetworkType ConvertAutoNetworkType() = 0;
 
+    // @brief instruction sets weights are packed for, saved packed weights of another tag are not used
+    virtual std::string GetIsaTag();
+
 private:
     DeviceType device_type_;
 };
@@ -29,6 +29,10 @@ Status AbstractNetwork::ShareCommandQueue(AbstractNetwork *network) {
     return Status(TNNERR_COMMON_ERROR, "Subclass of AbstractNetwork must implement this func ShareCommandQueue");
 }
 
+Status AbstractNetwork::GetForwardMemoryLowerBound(int &memory_size) {
+    return Status(TNNERR_COMMON_ERROR, "Subclass of AbstractNetwork does not implement GetForwardMemoryLowerBound");
+}
+
 Status AbstractNetwork::SetCpuNumThreads(int num_threads) {
     return TNN_OK;
 }
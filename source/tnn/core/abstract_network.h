@@ -50,6 +50,13 @@ public:
     //  an error code.
     virtual Status GetForwardMemorySize(int &memory_size) = 0;
 
+    //  @brief return the max amount of memory used by blobs alive at the
+    //  same time, no memory plan of the network needs less for forward
+    //  @param memory_size: the lower bound of GetForwardMemorySize
+    //  @return error code: If successful, returns zero. Otherwise, returns
+    //  an error code.
+    virtual Status GetForwardMemoryLowerBound(int &memory_size);
+
     //  @brief: set memory used by the tnn instance without forward
     //  memory, the memory size must be at least that returned by
     //  GetForwardMemorySize(). releasing or otherwise using the memory for
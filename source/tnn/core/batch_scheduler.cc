@@ -0,0 +1,441 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "tnn/core/batch_scheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "tnn/utils/dims_utils.h"
+#include "tnn/utils/mat_converter_utils.h"
+#include "tnn/utils/string_utils_inner.h"
+
+namespace TNN_NS {
+
+typedef std::chrono::steady_clock BatchClock;
+
+// latencies of the most recent requests kept for percentiles
+static const size_t kMaxLatencyRecords = 4096;
+
+struct BatchRequest {
+    MatMap inputs;
+    int batch = 0;
+    // dims of all inputs except the batch, only requests of the same key run together
+    std::string shape_key;
+    std::promise<BatchResult> promise;
+    BatchClock::time_point submit_time;
+};
+
+class BatchSchedulerImpl {
+public:
+    BatchSchedulerImpl(std::shared_ptr<Instance> instance, BatchSchedulerConfig config)
+        : instance_(instance), config_(config) {
+        config_.max_batch_size = std::max(config_.max_batch_size, 1);
+        config_.max_delay_us   = std::max(config_.max_delay_us, 0);
+        ResetStats();
+    }
+
+    ~BatchSchedulerImpl() {
+        Stop();
+    }
+
+    Status Start();
+    Status Stop();
+    std::future<BatchResult> Submit(MatMap inputs);
+    BatchSchedulerStats GetStats();
+    void ResetStats();
+
+private:
+    void Loop();
+    int GetReadyBatch();
+    void PopRequests(std::vector<std::shared_ptr<BatchRequest>> &requests);
+    void RunRequests(std::vector<std::shared_ptr<BatchRequest>> &requests);
+    Status ForwardRequests(std::vector<std::shared_ptr<BatchRequest>> &requests, std::vector<MatMap> &outputs);
+    void RecordBatch(std::vector<std::shared_ptr<BatchRequest>> &requests, int batch);
+
+    std::shared_ptr<Instance> instance_ = nullptr;
+    BatchSchedulerConfig config_;
+    InputShapesMap current_shapes_ = {};
+
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::deque<std::shared_ptr<BatchRequest>> queue_;
+    bool running_ = false;
+    bool stop_    = false;
+
+    std::mutex stats_mutex_;
+    int64_t request_count_ = 0;
+    int64_t batch_count_   = 0;
+    std::vector<int64_t> batch_size_histogram_;
+    std::vector<double> latencies_ms_;
+    size_t latency_index_ = 0;
+};
+
+static bool IsHostDevice(DeviceType device_type) {
+    return device_type == DEVICE_NAIVE || device_type == DEVICE_X86 || device_type == DEVICE_ARM;
+}
+
+static size_t GetMatBytesPerBatch(Mat *mat) {
+    auto dims = mat->GetDims();
+    if (dims.size() < 1 || dims[0] <= 0) {
+        return 0;
+    }
+    size_t count = (size_t)DimsVectorUtils::Count(dims, 1);
+    // yuv420sp mat has dims of 3 channels and data of 1.5 channels
+    if (mat->GetMatType() == NNV12 || mat->GetMatType() == NNV21) {
+        count = count / 2;
+    }
+    return count * GetMatElementSize(mat);
+}
+
+static Status CheckInputs(const MatMap &inputs, int &batch, std::string &shape_key) {
+    if (inputs.empty()) {
+        return Status(TNNERR_PARAM_ERR, "batch request has no input mat");
+    }
+    batch     = -1;
+    shape_key = "";
+    for (const auto &iter : inputs) {
+        auto mat = iter.second;
+        if (!mat || !mat->GetData() || GetMatBytesPerBatch(mat.get()) == 0) {
+            return Status(TNNERR_PARAM_ERR, "batch request has invalid input mat");
+        }
+        if (!IsHostDevice(mat->GetDeviceType())) {
+            return Status(TNNERR_PARAM_ERR, "batch request input mat must be in cpu memory");
+        }
+        auto dims = mat->GetDims();
+        if (batch >= 0 && dims[0] != batch) {
+            return Status(TNNERR_PARAM_ERR, "batch request input mats have different batch");
+        }
+        batch = dims[0];
+        shape_key += iter.first + ":" + ToString((int)mat->GetMatType());
+        for (size_t i = 1; i < dims.size(); i++) {
+            shape_key += "," + ToString(dims[i]);
+        }
+        shape_key += ";";
+    }
+    return TNN_OK;
+}
+
+Status BatchSchedulerImpl::Start() {
+    std::unique_lock<std::mutex> lck(mutex_);
+    if (running_) {
+        return TNN_OK;
+    }
+    if (!instance_) {
+        return Status(TNNERR_NULL_PARAM, "batch scheduler instance is nil");
+    }
+    stop_    = false;
+    running_ = true;
+    thread_  = std::thread(&BatchSchedulerImpl::Loop, this);
+    return TNN_OK;
+}
+
+Status BatchSchedulerImpl::Stop() {
+    {
+        std::unique_lock<std::mutex> lck(mutex_);
+        if (!running_) {
+            return TNN_OK;
+        }
+        stop_ = true;
+    }
+    cond_.notify_all();
+    thread_.join();
+
+    std::unique_lock<std::mutex> lck(mutex_);
+    running_ = false;
+    return TNN_OK;
+}
+
+std::future<BatchResult> BatchSchedulerImpl::Submit(MatMap inputs) {
+    auto request         = std::make_shared<BatchRequest>();
+    request->inputs      = inputs;
+    request->submit_time = BatchClock::now();
+    auto future          = request->promise.get_future();
+
+    BatchResult result;
+    result.status = CheckInputs(inputs, request->batch, request->shape_key);
+    if (result.status != TNN_OK) {
+        request->promise.set_value(result);
+        return future;
+    }
+
+    {
+        std::unique_lock<std::mutex> lck(mutex_);
+        if (!running_ || stop_) {
+            result.status = Status(TNNERR_INST_ERR, "batch scheduler is not running");
+        } else if (config_.max_queue_size > 0 && (int)queue_.size() >= config_.max_queue_size) {
+            result.status = Status(TNNERR_INST_ERR, "batch scheduler queue is full");
+        } else {
+            queue_.push_back(request);
+        }
+    }
+    if (result.status != TNN_OK) {
+        request->promise.set_value(result);
+        return future;
+    }
+    cond_.notify_all();
+    return future;
+}
+
+// batch of the requests that can run together with the oldest one
+int BatchSchedulerImpl::GetReadyBatch() {
+    if (queue_.empty()) {
+        return 0;
+    }
+    const auto &shape_key = queue_.front()->shape_key;
+    int batch             = 0;
+    for (const auto &request : queue_) {
+        if (request->shape_key == shape_key) {
+            batch += request->batch;
+        }
+    }
+    return batch;
+}
+
+void BatchSchedulerImpl::PopRequests(std::vector<std::shared_ptr<BatchRequest>> &requests) {
+    // the oldest request always runs, even if its own batch exceeds max_batch_size
+    auto front = queue_.front();
+    queue_.pop_front();
+    requests.push_back(front);
+
+    int batch = front->batch;
+    for (auto iter = queue_.begin(); iter != queue_.end() && batch < config_.max_batch_size;) {
+        auto request = *iter;
+        if (request->shape_key == front->shape_key && batch + request->batch <= config_.max_batch_size) {
+            batch += request->batch;
+            requests.push_back(request);
+            iter = queue_.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+}
+
+void BatchSchedulerImpl::Loop() {
+    while (true) {
+        std::vector<std::shared_ptr<BatchRequest>> requests;
+        {
+            std::unique_lock<std::mutex> lck(mutex_);
+            cond_.wait(lck, [this] { return stop_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                break;
+            }
+            auto deadline = queue_.front()->submit_time + std::chrono::microseconds(config_.max_delay_us);
+            cond_.wait_until(lck, deadline,
+                             [this] { return stop_ || GetReadyBatch() >= config_.max_batch_size; });
+            PopRequests(requests);
+        }
+        RunRequests(requests);
+    }
+}
+
+Status BatchSchedulerImpl::ForwardRequests(std::vector<std::shared_ptr<BatchRequest>> &requests,
+                                           std::vector<MatMap> &outputs) {
+    int batch = 0;
+    for (const auto &request : requests) {
+        batch += request->batch;
+    }
+
+    // concat the input mats along the batch
+    MatMap batch_inputs;
+    InputShapesMap batch_shapes;
+    for (const auto &iter : requests[0]->inputs) {
+        auto name = iter.first;
+        auto dims = iter.second->GetDims();
+        dims[0]   = batch;
+
+        std::shared_ptr<Mat> mat = iter.second;
+        if (requests.size() > 1) {
+            mat         = std::make_shared<Mat>(DEVICE_NAIVE, iter.second->GetMatType(), dims);
+            char *dst   = reinterpret_cast<char *>(mat->GetData());
+            auto stride = GetMatBytesPerBatch(iter.second.get());
+            for (const auto &request : requests) {
+                auto src = request->inputs[name];
+                memcpy(dst, src->GetData(), stride * request->batch);
+                dst += stride * request->batch;
+            }
+        }
+        batch_inputs[name] = mat;
+        batch_shapes[name] = dims;
+    }
+
+    Status status = TNN_OK;
+    if (batch_shapes != current_shapes_) {
+        status = instance_->Reshape(batch_shapes);
+        RETURN_ON_NEQ(status, TNN_OK);
+        current_shapes_ = batch_shapes;
+    }
+
+    for (const auto &iter : batch_inputs) {
+        auto param_iter = config_.input_params.find(iter.first);
+        auto param = param_iter != config_.input_params.end() ? param_iter->second : MatConvertParam();
+        status     = instance_->SetInputMat(iter.second, param, iter.first);
+        RETURN_ON_NEQ(status, TNN_OK);
+    }
+
+    status = instance_->Forward();
+    RETURN_ON_NEQ(status, TNN_OK);
+
+    // split the output mats back to the requests
+    BlobMap output_blobs;
+    status = instance_->GetAllOutputBlobs(output_blobs);
+    RETURN_ON_NEQ(status, TNN_OK);
+
+    outputs.assign(requests.size(), MatMap());
+    for (const auto &iter : output_blobs) {
+        std::shared_ptr<Mat> mat = nullptr;
+        status = instance_->GetOutputMat(mat, config_.output_param, iter.first, config_.output_device,
+                                         config_.output_mat_type);
+        RETURN_ON_NEQ(status, TNN_OK);
+        if (!mat || mat->GetBatch() != batch) {
+            return Status(TNNERR_INVALID_DATA, "batch of output mat is different from inputs");
+        }
+
+        const char *src = reinterpret_cast<const char *>(mat->GetData());
+        auto stride     = GetMatBytesPerBatch(mat.get());
+        for (size_t i = 0; i < requests.size(); i++) {
+            auto dims = mat->GetDims();
+            dims[0]   = requests[i]->batch;
+            // output mats of the instance are reused by the next forward, always copy
+            auto request_mat = std::make_shared<Mat>(config_.output_device, mat->GetMatType(), dims);
+            memcpy(request_mat->GetData(), src, stride * requests[i]->batch);
+            src += stride * requests[i]->batch;
+            outputs[i][iter.first] = request_mat;
+        }
+    }
+    return TNN_OK;
+}
+
+void BatchSchedulerImpl::RunRequests(std::vector<std::shared_ptr<BatchRequest>> &requests) {
+    int batch = 0;
+    for (const auto &request : requests) {
+        batch += request->batch;
+    }
+
+    std::vector<MatMap> outputs;
+    Status status = ForwardRequests(requests, outputs);
+    if (status != TNN_OK) {
+        LOGE("batch scheduler forward batch %d failed: %s\n", batch, status.description().c_str());
+        // the shapes of the instance are unknown after a failure
+        current_shapes_.clear();
+    }
+
+    RecordBatch(requests, batch);
+    for (size_t i = 0; i < requests.size(); i++) {
+        BatchResult result;
+        result.status = status;
+        if (status == TNN_OK) {
+            result.outputs = outputs[i];
+        }
+        requests[i]->promise.set_value(result);
+    }
+}
+
+void BatchSchedulerImpl::RecordBatch(std::vector<std::shared_ptr<BatchRequest>> &requests, int batch) {
+    auto now = BatchClock::now();
+    std::unique_lock<std::mutex> lck(stats_mutex_);
+    request_count_ += requests.size();
+    batch_count_++;
+    if ((int)batch_size_histogram_.size() <= batch) {
+        batch_size_histogram_.resize(batch + 1, 0);
+    }
+    batch_size_histogram_[batch]++;
+
+    for (const auto &request : requests) {
+        double latency = std::chrono::duration<double, std::milli>(now - request->submit_time).count();
+        if (latencies_ms_.size() < kMaxLatencyRecords) {
+            latencies_ms_.push_back(latency);
+        } else {
+            latencies_ms_[latency_index_] = latency;
+        }
+        latency_index_ = (latency_index_ + 1) % kMaxLatencyRecords;
+    }
+}
+
+BatchSchedulerStats BatchSchedulerImpl::GetStats() {
+    BatchSchedulerStats stats;
+    {
+        std::unique_lock<std::mutex> lck(mutex_);
+        stats.queue_depth = (int)queue_.size();
+    }
+
+    std::vector<double> latencies;
+    {
+        std::unique_lock<std::mutex> lck(stats_mutex_);
+        stats.request_count        = request_count_;
+        stats.batch_count          = batch_count_;
+        stats.batch_size_histogram = batch_size_histogram_;
+        latencies                  = latencies_ms_;
+    }
+
+    if (!latencies.empty()) {
+        auto percentile = [&](double p) {
+            size_t index = (size_t)std::ceil(p * latencies.size());
+            index        = std::min(std::max(index, (size_t)1), latencies.size()) - 1;
+            std::nth_element(latencies.begin(), latencies.begin() + index, latencies.end());
+            return latencies[index];
+        };
+        stats.latency_p50_ms = percentile(0.5);
+        stats.latency_p90_ms = percentile(0.9);
+        stats.latency_p99_ms = percentile(0.99);
+        stats.latency_max_ms = *std::max_element(latencies.begin(), latencies.end());
+    }
+    return stats;
+}
+
+void BatchSchedulerImpl::ResetStats() {
+    std::unique_lock<std::mutex> lck(stats_mutex_);
+    request_count_ = 0;
+    batch_count_   = 0;
+    batch_size_histogram_.assign(config_.max_batch_size + 1, 0);
+    latencies_ms_.clear();
+    latency_index_ = 0;
+}
+
+BatchScheduler::BatchScheduler(std::shared_ptr<Instance> instance, BatchSchedulerConfig config) {
+    impl_ = std::make_shared<BatchSchedulerImpl>(instance, config);
+}
+
+BatchScheduler::~BatchScheduler() {
+    impl_ = nullptr;
+}
+
+Status BatchScheduler::Start() {
+    return impl_->Start();
+}
+
+Status BatchScheduler::Stop() {
+    return impl_->Stop();
+}
+
+std::future<BatchResult> BatchScheduler::Submit(MatMap inputs) {
+    return impl_->Submit(inputs);
+}
+
+BatchSchedulerStats BatchScheduler::GetStats() {
+    return impl_->GetStats();
+}
+
+void BatchScheduler::ResetStats() {
+    impl_->ResetStats();
+}
+
+}  // namespace TNN_NS
@@ -18,9 +18,11 @@
 #include <cstring>
 #include <set>
 
+#include "tnn/memory_manager/blob_1d_memory.h"
 #include "tnn/memory_manager/blob_memory_pool_factory.h"
 #include "tnn/memory_manager/blob_memory_size_info.h"
 #include "tnn/memory_manager/memory_mode_state_factory.h"
+#include "tnn/memory_manager/memory_offset_assign_strategy.h"
 #include "tnn/memory_manager/memory_seperate_assign_strategy.h"
 #include "tnn/memory_manager/memory_unify_assign_strategy.h"
 #include "tnn/utils/dims_utils.h"
@@ -88,6 +90,9 @@ Status BlobManager::Init(NetworkConfig &config, NetStructure *net_structure, Inp
 
     config_            = config;
     init_thread_id_    = std::this_thread::get_id();
+    for (auto blob_memory_pool_iter : blob_memory_pool_map_) {
+        blob_memory_pool_iter.second->EnableOffsetPack(IsOffsetPackEnabled());
+    }
     shared_memory_allocated_ = false;
     memory_mode_state_ = MemoryModeStateFactory::CreateMemoryModeState(config.share_memory_mode);
 
@@ -171,9 +176,15 @@ Status BlobManager::AllocateBlobMemory(int flag) {
         int use_count           = 1;
         BlobMemory *blob_memory = NULL;
         blob_memory             = blob_memory_pool_map_[info.dims.size()]->BorrowBlobMemory(use_count, info, true);
+        // input blobs are set before forward and kept alive all the time
+        blob_memory->UpdateLiveRange(0);
+        blob_memory->UpdateLiveRange((int)net_structure_->layers.size());
         blob_memory_mapping_.insert(std::make_pair(current_blob, blob_memory));
     }
 
+    // blob memory is packed by live range later, do not reuse it here
+    const bool use_new_memory = IsOffsetPackEnabled();
+
     /*
      *  We reuse blob memory of the previous layers if it is not referenced.
      *  So, a use_count is calculated here.
@@ -200,7 +211,9 @@ Status BlobManager::AllocateBlobMemory(int flag) {
 
                 BlobMemorySizeInfo info = device_->Calculate(current_blob->GetBlobDesc());
                 // find an available BlobMemory
-                BlobMemory *blob_memory = blob_memory_pool_map_[info.dims.size()]->BorrowBlobMemory(use_count, info, false);
+                BlobMemory *blob_memory =
+                    blob_memory_pool_map_[info.dims.size()]->BorrowBlobMemory(use_count, info, use_new_memory);
+                blob_memory->UpdateLiveRange((int)layer_index);
                 blob_memory_mapping_.insert(std::make_pair(current_blob, blob_memory));
             }
         }
@@ -217,6 +230,7 @@ Status BlobManager::AllocateBlobMemory(int flag) {
                 std::map<Blob *, BlobMemory *>::const_iterator blob_memory_iter =
                     blob_memory_mapping_.find(current_blob);
                 ASSERT(blob_memory_iter->second->GetUseCount() > 0);
+                blob_memory_iter->second->UpdateLiveRange((int)layer_index);
                 blob_memory_iter->second->DecrementUseCount();
                 if (blob_memory_iter->second->GetUseCount() == 0) {
                     int dimensions = blob_memory_iter->second->GetBlobMemorySizeInfo().dims.size();
@@ -226,10 +240,42 @@ Status BlobManager::AllocateBlobMemory(int flag) {
         }
     }
 
+    // blob memory still in use is alive until the end of the network, eg. output blobs
+    for (auto iter : blob_memory_mapping_) {
+        if (iter.second->GetUseCount() > 0) {
+            iter.second->UpdateLiveRange((int)net_structure_->layers.size());
+        }
+    }
+
+    if (IsOffsetPackEnabled()) {
+        for (auto blob_memory_pool_iter : blob_memory_pool_map_) {
+            LOGI("BlobManager: packed blob memory %d bytes, lower bound %d bytes\n",
+                 blob_memory_pool_iter.second->GetAllBlobMemorySize(),
+                 blob_memory_pool_iter.second->GetAllBlobMemoryLowerBound());
+        }
+    }
+
     Status status = TNN_OK;
 
     do {
-        if (config_.share_memory_mode == SHARE_MEMORY_MODE_DEFAULT) {
+        if (config_.share_memory_mode == SHARE_MEMORY_MODE_DEFAULT && IsOffsetPackEnabled()) {
+            // The packed strategy allocates one arena for each pool.
+            for (auto blob_memory_pool_iter : blob_memory_pool_map_) {
+                BlobMemorySizeInfo info;
+                info.data_type = DATA_TYPE_INT8;
+                info.dims      = {std::max(blob_memory_pool_iter.second->GetAllBlobMemorySize(), 1)};
+                std::shared_ptr<BlobMemory> arena(new Blob1DMemory(device_, info, 0));
+                status = arena->AllocateHandle();
+                BREAK_IF(status != TNN_OK);
+                arena_memory_.push_back(arena);
+
+                MemoryOffsetAssignStrategy strategy(arena->GetHandle().base);
+                status = blob_memory_pool_iter.second->AssignAllBlobMemory(strategy);
+                BREAK_IF(status != TNN_OK);
+            }
+            BREAK_IF(status != TNN_OK);
+            BindBlobMemory();
+        } else if (config_.share_memory_mode == SHARE_MEMORY_MODE_DEFAULT) {
             // The default strategy allocated the blob memory separately.
             MemorySeperateAssignStrategy strategy;
             for (auto blob_memory_pool_iter : blob_memory_pool_map_) {
@@ -248,8 +294,8 @@ Status BlobManager::AllocateBlobMemory(int flag) {
                         config_.device_id, this, status);
                 BREAK_IF(status != TNN_OK);
 		shared_memory_allocated_ = true;
-                MemoryUnifyAssignStrategy strategy(share_memory.shared_memory_data);
-                status = blob_memory_pool_iter.second->AssignAllBlobMemory(strategy);
+                auto strategy = CreateUnifyAssignStrategy(share_memory.shared_memory_data);
+                status = blob_memory_pool_iter.second->AssignAllBlobMemory(*strategy);
                 BREAK_IF(status != TNN_OK);
             }
             BREAK_IF(status != TNN_OK);
@@ -283,6 +329,23 @@ int BlobManager::GetBlobUseCount(int layer_index, std::string current_blob_name)
     return use_count;
 }
 
+/*
+ * Blob memory is packed by live range only on devices with host memory,
+ * offsets in the buffers of other devices may be unsupported.
+ */
+bool BlobManager::IsOffsetPackEnabled() {
+    auto device_type = device_->GetDeviceType();
+    return config_.memory_plan_mode == MEMORY_PLAN_MODE_OFFSET_PACK &&
+           (device_type == DEVICE_NAIVE || device_type == DEVICE_X86 || device_type == DEVICE_ARM);
+}
+
+std::shared_ptr<MemoryAssignStrategy> BlobManager::CreateUnifyAssignStrategy(void *memory) {
+    if (IsOffsetPackEnabled()) {
+        return std::make_shared<MemoryOffsetAssignStrategy>(memory);
+    }
+    return std::make_shared<MemoryUnifyAssignStrategy>(memory);
+}
+
 Status BlobManager::DeInit() {
     if(shared_memory_allocated_) {
     	SharedMemoryManager::ReleaseSharedMemory(init_thread_id_, device_, config_.device_id, this);
@@ -300,9 +363,9 @@ Status BlobManager::DeInit() {
 }
 
 void BlobManager::OnSharedForwardMemoryChanged(void *memory) {
-    MemoryUnifyAssignStrategy strategy(memory);
+    auto strategy = CreateUnifyAssignStrategy(memory);
     for (auto blob_memory_pool_iter : blob_memory_pool_map_) {
-        blob_memory_pool_iter.second->AssignAllBlobMemory(strategy);
+        blob_memory_pool_iter.second->AssignAllBlobMemory(*strategy);
     }
     BindBlobMemory();
 }
@@ -315,10 +378,10 @@ Status BlobManager::SetForwardMemory(void *memory) {
     if (config_.share_memory_mode != SHARE_MEMORY_MODE_SET_FROM_EXTERNAL) {
         return Status(TNNERR_NOT_SUPPORT_SET_FORWARD_MEM, "set memory from external is unsupported");
     }
-    MemoryUnifyAssignStrategy strategy(memory);
+    auto strategy = CreateUnifyAssignStrategy(memory);
     Status status = TNN_OK;
     for (auto blob_memory_pool_iter : blob_memory_pool_map_) {
-        status = blob_memory_pool_iter.second->AssignAllBlobMemory(strategy);
+        status = blob_memory_pool_iter.second->AssignAllBlobMemory(*strategy);
     }
     if (status == TNN_OK) {
         BindBlobMemory();
@@ -328,6 +391,7 @@ Status BlobManager::SetForwardMemory(void *memory) {
 
 void BlobManager::BindBlobMemory() {
     memory_mode_state_->SetMemoryAllocatedFlag();
+    memory_generation_++;
     // bind every blob_memory's data_ into every blob's data
     for (auto iter : blob_memory_mapping_) {
         iter.first->SetHandle(iter.second->GetHandle());
@@ -349,6 +413,17 @@ int BlobManager::GetAllBlobMemorySize() {
     return mem_size_all_blob;
 }
 
+Status BlobManager::GetAllBlobMemoryLowerBound(int &memory_size) {
+    if (!IsOffsetPackEnabled()) {
+        return Status(TNNERR_COMMON_ERROR, "the lower bound is only solved with MEMORY_PLAN_MODE_OFFSET_PACK");
+    }
+    memory_size = 0;
+    for (auto blob_memory_pool_iter : blob_memory_pool_map_) {
+        memory_size += blob_memory_pool_iter.second->GetAllBlobMemoryLowerBound();
+    }
+    return TNN_OK;
+}
+
 Status BlobManager::GetAllInputBlobs(BlobMap &blobs) {
     blobs = input_blobs_;
     return TNN_OK;
@@ -383,6 +458,10 @@ void BlobManager::ReplaceBlob(std::string name, Blob *new_blob) {
         output_blobs_[name] = new_blob;
 }
 
+int BlobManager::GetMemoryGeneration() {
+    return memory_generation_;
+}
+
 Status BlobManager::CheckBlobMemoryState() {
     return memory_mode_state_->GetStatus();
 }
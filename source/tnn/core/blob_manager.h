@@ -19,6 +19,7 @@
 #include <memory>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "tnn/core/abstract_device.h"
 #include "tnn/core/blob.h"
@@ -76,12 +77,22 @@ public:
     // @brief get all blob memory size
     int GetAllBlobMemorySize();
 
+    // @brief get the max bytes size of blob memory alive at the same time,
+    // only solved for offset packed blob memory
+    Status GetAllBlobMemoryLowerBound(int &memory_size);
+
     // @brief replace blob with new_blob, and delete the original blob if exist
     void ReplaceBlob(std::string name, Blob *new_blob);
 
+    // @brief get the number of times blob memory has been bound, it changes
+    // whenever the blobs may point to other memory
+    int GetMemoryGeneration();
+
 protected:
     void BindBlobMemory();
     int GetBlobUseCount(int layer_index, std::string current_blob_name);
+    bool IsOffsetPackEnabled();
+    std::shared_ptr<MemoryAssignStrategy> CreateUnifyAssignStrategy(void *memory);
 
     NetworkConfig config_;
     NetStructure *net_structure_;
@@ -93,7 +104,10 @@ protected:
     std::shared_ptr<MemoryAssignStrategy> strategy_;
     std::map<std::string, Blob *> blobs_;
     std::map<Blob *, BlobMemory *> blob_memory_mapping_;
+    // arena of packed blob memory in default share memory mode
+    std::vector<std::shared_ptr<BlobMemory>> arena_memory_;
     bool shared_memory_allocated_;
+    int memory_generation_ = 0;
 
     std::thread::id init_thread_id_;
     MemoryModeState *memory_mode_state_;
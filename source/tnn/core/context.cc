@@ -78,6 +78,22 @@ std::string Context::GetCacheFilePath() {
     return cache_file_path_;
 }
 
+void Context::SetModelHash(std::string model_hash) {
+    model_hash_ = model_hash;
+}
+
+std::string Context::GetModelHash() {
+    return model_hash_;
+}
+
+void Context::SetCpuAffinity(std::vector<int> cpu_affinity) {
+    cpu_affinity_ = cpu_affinity;
+}
+
+std::vector<int> Context::GetCpuAffinity() {
+    return cpu_affinity_;
+}
+
 #if TNN_PROFILE
 void Context::StartProfile() {
     profile_layer     = true;
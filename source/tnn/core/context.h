@@ -75,6 +75,16 @@ public:
 
     std::string GetCacheFilePath();
 
+    // @brief hash of the loaded model, layer accs of the same model share packed weights by it
+    void SetModelHash(std::string model_hash);
+
+    std::string GetModelHash();
+
+    // @brief cpus the compute threads of the context are bound to
+    void SetCpuAffinity(std::vector<int> cpu_affinity);
+
+    std::vector<int> GetCpuAffinity();
+
 #if TNN_PROFILE
 public:
     virtual void StartProfile();
@@ -92,6 +102,8 @@ protected:
     bool enable_tune_kernel_ = true;
     std::string cache_path_ = ""; // dir to save cache files
     std::string cache_file_path_ = "";
+    std::string model_hash_ = ""; // empty if packed weights are not shared
+    std::vector<int> cpu_affinity_ = {};
 };
 
 }  // namespace TNN_NS
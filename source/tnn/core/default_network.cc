@@ -15,8 +15,13 @@
 #include "tnn/core/default_network.h"
 
 #include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 
 #include "tnn/core/blob_int8.h"
+#include "tnn/core/packed_weight_cache.h"
 #include "tnn/core/profile.h"
 #include "tnn/interpreter/default_model_interpreter.h"
 #include "tnn/interpreter/layer_param.h"
@@ -29,7 +34,10 @@
 #include "tnn/utils/data_flag_utils.h"
 #include "tnn/utils/dims_utils.h"
 #include "tnn/utils/md5.h"
+#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 #include "tnn/utils/string_utils_inner.h"
+#include "tnn/utils/thread_pool.h"
 
 namespace TNN_NS {
 
@@ -49,12 +57,32 @@ DefaultNetwork::~DefaultNetwork() {
 }
 
 Status DefaultNetwork::SetCpuNumThreads(int num_threads) {
+    num_threads_ = num_threads;
     if (context_)
         return context_->SetNumThreads(num_threads);
     else
         return Status(TNNERR_CONTEXT_ERR, "context is nil");
 }
 
+typedef std::chrono::steady_clock InitClock;
+
+// milliseconds since start, start is moved to now for the next phase
+static double GetPhaseTime(InitClock::time_point &start) {
+    auto now    = InitClock::now();
+    double time = std::chrono::duration<double, std::milli>(now - start).count();
+    start       = now;
+    return time;
+}
+
+static std::string GenerateModelHash(DefaultModelInterpreter *interpreter) {
+    // weights generated at runtime differ between networks of the same proto, never share them
+    auto params_md5 = interpreter->GetParamsMd5();
+    if (params_md5.size() < 2 || params_md5[1] == md5("")) {
+        return "";
+    }
+    return params_md5[0] + "_" + params_md5[1];
+}
+
 /*
  * The Network holds blob, blobmanager, layers etc.
  * Those object is initialized in this function.
@@ -63,6 +91,7 @@ Status DefaultNetwork::Init(NetworkConfig &net_config, ModelConfig &model_config
                         InputShapesMap min_inputs_shape, InputShapesMap max_inputs_shape, bool enable_const_folder) {
     config_                                      = net_config;
     Status ret                                   = TNN_OK;
+    auto phase_start                             = InitClock::now();
     DefaultModelInterpreter *default_interpreter = dynamic_cast<DefaultModelInterpreter *>(interpreter);
     CHECK_PARAM_NULL(default_interpreter);
 
@@ -88,6 +117,10 @@ Status DefaultNetwork::Init(NetworkConfig &net_config, ModelConfig &model_config
 #endif
     context_->SetPrecision(net_config.precision);
     context_->SetEnableTuneKernel(net_config.enable_tune_kernel);
+    context_->SetCpuAffinity(net_config.cpu_affinity);
+    if (runtime_model_ == RUNTIME_MODE_NORMAL) {
+        context_->SetModelHash(GenerateModelHash(default_interpreter));
+    }
 
     if(!net_config.cache_path.empty()) {
         auto params_md5 = default_interpreter->GetParamsMd5();
@@ -113,16 +146,31 @@ Status DefaultNetwork::Init(NetworkConfig &net_config, ModelConfig &model_config
         RETURN_ON_NEQ(ret, TNN_OK);
     }
 
+    double optimize_time = GetPhaseTime(phase_start);
+
     blob_manager_ = new BlobManager(device_);
 
     ret = blob_manager_->Init(net_config, net_structure, max_inputs_shape, GetNetResourceDataType(net_resource));
     RETURN_ON_NEQ(ret, TNN_OK);
 
+    // packed weights saved by an earlier network of the model are mapped before the layer accs look them up
+    std::shared_ptr<void> packed_weights;
+    auto packed_weight_file = GetPackedWeightFile(net_config);
+    if (!packed_weight_file.empty()) {
+        PackedWeightCache::LoadFile(packed_weight_file, device_->GetIsaTag(), packed_weights);
+    }
+
     ret = InitLayers(net_structure, net_resource);
     RETURN_ON_NEQ(ret, TNN_OK);
+    if (!packed_weight_file.empty()) {
+        PackedWeightCache::SaveFile(packed_weight_file, context_->GetModelHash(), net_config.device_type,
+                                    context_->GetPrecision(), device_->GetIsaTag());
+    }
+    double init_layers_time = GetPhaseTime(phase_start);
 
     ret = AllocateBlobMemory();
     RETURN_ON_NEQ(ret, TNN_OK);
+    double allocate_time = GetPhaseTime(phase_start);
 
     net_structure_ = net_structure;
     net_resource_ = net_resource;
@@ -134,7 +182,59 @@ Status DefaultNetwork::Init(NetworkConfig &net_config, ModelConfig &model_config
     RETURN_ON_NEQ(ret, TNN_OK);
 
     ret = context_->OnInstanceReshapeEnd();
-    return ret;
+    RETURN_ON_NEQ(ret, TNN_OK);
+
+    ret = InitGraphExecutor();
+    RETURN_ON_NEQ(ret, TNN_OK);
+
+    ret = InitReshapePlanCache();
+    RETURN_ON_NEQ(ret, TNN_OK);
+
+    if (runtime_model_ == RUNTIME_MODE_NORMAL) {
+        LOGD("DefaultNetwork init time: optimize %.2f ms, init layers %.2f ms (%d threads), allocate %.2f ms, "
+             "reshape %.2f ms\n",
+             optimize_time, init_layers_time, GetInitNumThreads(), allocate_time, GetPhaseTime(phase_start));
+    }
+    return TNN_OK;
+}
+
+/*
+ * Layers are executed as a dependency graph if inter_op_num_threads > 1.
+ * Networks with blobs allocated in forward keep running in order.
+ */
+Status DefaultNetwork::InitGraphExecutor() {
+    if (config_.inter_op_num_threads <= 1 || runtime_model_ != RUNTIME_MODE_NORMAL) {
+        return TNN_OK;
+    }
+#if TNN_PROFILE
+    // layer timings are measured one layer at a time
+    static std::once_flag profile_log_flag;
+    std::call_once(profile_log_flag, []() {
+        LOGI("DefaultNetwork: inter_op_num_threads is ignored in profiling builds, layers run in order\n");
+    });
+    return TNN_OK;
+#else
+    if (!ParallelGraphExecutor::IsSupported(layers_, device_)) {
+        LOGI("DefaultNetwork: parallel graph executor is not supported, layers run in order\n");
+        return TNN_OK;
+    }
+    graph_executor_          = std::make_shared<ParallelGraphExecutor>(config_.inter_op_num_threads, config_.cpu_affinity);
+    graph_memory_generation_ = blob_manager_->GetMemoryGeneration();
+    return graph_executor_->Build(layers_, device_);
+#endif
+}
+
+/*
+ * Plans of recently used input shapes are cached, reshaping back to one of them
+ * takes the layer output dims and the graph of the executor from the plan.
+ */
+Status DefaultNetwork::InitReshapePlanCache() {
+    if (config_.reshape_plan_cache_size <= 0 || runtime_model_ != RUNTIME_MODE_NORMAL) {
+        return TNN_OK;
+    }
+    reshape_plan_cache_ = std::make_shared<ReshapePlanCache>(config_.reshape_plan_cache_size);
+    reshape_plan_cache_->Put(GetInputShapes(), CreateReshapePlan());
+    return TNN_OK;
 }
 
 static inline bool IsLayoutReformatLayer(std::shared_ptr<LayerInfo> layer) {
@@ -251,6 +351,7 @@ Status DefaultNetwork::InitLayers(NetStructure *net_structure, NetResource *net_
     }
 
     // init layer
+    const bool parallel_init = GetInitNumThreads() > 1;
     for (auto layer_info : net_structure->layers) {
         if (runtime_model_ == RUNTIME_MODE_NORMAL && const_layers.find(layer_info->name) != const_layers.end()) {
             continue;
@@ -316,18 +417,88 @@ Status DefaultNetwork::InitLayers(NetStructure *net_structure, NetResource *net_
         cur_layer->SetRuntimeMode(runtime_model_);
         cur_layer->SetConstantResource(&net_resource->constant_map);
         cur_layer->SetConstantResourceFlag(&net_resource->constant_blob_flags);
-        ret = cur_layer->Init(context_, layer_info->param.get(), layer_resource, inputs, outputs, device_);
+        if (parallel_init) {
+            // shapes flow through the layers in order, layer accs are initialized afterwards
+            ret = cur_layer->InitOutputs(layer_info->param.get(), layer_resource, inputs, outputs);
+        } else {
+            ret = cur_layer->Init(context_, layer_info->param.get(), layer_resource, inputs, outputs, device_);
+        }
         if (ret != TNN_OK) {
             LOGE("Error Init layer %s (err: %d or 0x%X)\n", cur_layer->GetLayerName().c_str(), (int)ret, (int)ret);
             // release layer if Init failed
             delete cur_layer;
             return ret;
         }
-        cur_layer->SetRuntimeBlobMemoryPool(runtime_blob_pool_);
+        if (!parallel_init) {
+            cur_layer->SetRuntimeBlobMemoryPool(runtime_blob_pool_);
+        }
 
         layers_.push_back(cur_layer);
     }
-    return ret;
+    return parallel_init ? InitLayerAccs() : ret;
+}
+
+int DefaultNetwork::GetInitNumThreads() {
+    auto device_type = config_.device_type;
+    if (runtime_model_ != RUNTIME_MODE_NORMAL || config_.enable_tune_kernel ||
+        (device_type != DEVICE_X86 && device_type != DEVICE_NAIVE)) {
+        return 1;
+    }
+    return config_.init_num_threads > 0 ? config_.init_num_threads : GetCpuCount();
+}
+
+/*
+ * Layer accs transform their weights in Init, e.g. gemm packing and winograd transforms,
+ * which dominates the init time of large models. On cpu devices an acc only touches its
+ * own layer, so accs of different layers are initialized concurrently and the result is
+ * the same as initializing them in order. Layers with constant inputs bind the shared
+ * constant blobs in Init and stay in order on the calling thread.
+ */
+Status DefaultNetwork::InitLayerAccs() {
+    std::vector<Status> status(layers_.size(), TNN_OK);
+    std::vector<int> serial_layers;
+    std::mutex mutex;
+    std::condition_variable cond;
+    int num_pending = 0;
+
+    {
+        ThreadPool pool(std::max(1, std::min(GetInitNumThreads(), (int)layers_.size())));
+        for (int i = 0; i < (int)layers_.size(); i++) {
+            if (layers_[i]->HasConstantInput()) {
+                serial_layers.push_back(i);
+                continue;
+            }
+            num_pending++;
+            pool.Submit([&, i]() {
+                // layers run side by side, keep the loops inside an acc on one thread
+                OMP_SET_THREADS_(1);
+                status[i] = layers_[i]->InitLayerAcc(context_, device_);
+                std::unique_lock<std::mutex> lck(mutex);
+                if (--num_pending == 0) {
+                    cond.notify_all();
+                }
+            });
+        }
+
+        for (auto index : serial_layers) {
+            status[index] = layers_[index]->InitLayerAcc(context_, device_);
+            if (status[index] != TNN_OK) {
+                break;
+            }
+        }
+        std::unique_lock<std::mutex> lck(mutex);
+        cond.wait(lck, [&]() { return num_pending == 0; });
+    }
+
+    for (size_t i = 0; i < layers_.size(); i++) {
+        if (status[i] != TNN_OK) {
+            LOGE("Error Init layer %s (err: %d or 0x%X)\n", layers_[i]->GetLayerName().c_str(), (int)status[i],
+                 (int)status[i]);
+            return status[i];
+        }
+        layers_[i]->SetRuntimeBlobMemoryPool(runtime_blob_pool_);
+    }
+    return TNN_OK;
 }
 
 Status DefaultNetwork::AllocateBlobMemory() {
@@ -431,6 +602,10 @@ Status DefaultNetwork::GetForwardMemorySize(int &memory_size) {
     return TNN_OK;
 }
 
+Status DefaultNetwork::GetForwardMemoryLowerBound(int &memory_size) {
+    return blob_manager_->GetAllBlobMemoryLowerBound(memory_size);
+}
+
 Status DefaultNetwork::SetForwardMemory(void *memory) {
     return blob_manager_->SetForwardMemory(memory);
 }
@@ -489,17 +664,46 @@ Status DefaultNetwork::DoReshape() {
         return ret;
     }
 
-    ret = ReshapeLayers();
+    InputShapesMap input_shapes;
+    std::shared_ptr<ReshapePlan> plan = nullptr;
+    if (reshape_plan_cache_) {
+        input_shapes = GetInputShapes();
+        plan         = reshape_plan_cache_->Get(input_shapes);
+    }
+
+    ret = ReshapeLayers(plan);
     if (ret != TNN_OK) {
         return ret;
     }
 
     ret = context_->OnInstanceReshapeEnd();
+    if (ret != TNN_OK) {
+        return ret;
+    }
+
+    // blob sizes changed, memory dependencies between layers may change too
+    if (graph_executor_) {
+        graph_memory_generation_ = blob_manager_->GetMemoryGeneration();
+        if (plan && plan->graph && graph_executor_->SetGraph(layers_, device_, plan->graph) == TNN_OK) {
+            return TNN_OK;
+        }
+        ret = graph_executor_->Build(layers_, device_);
+        RETURN_ON_NEQ(ret, TNN_OK);
+        if (plan) {
+            plan->graph = graph_executor_->GetGraph();
+        }
+    }
 
+    if (reshape_plan_cache_ && !plan) {
+        reshape_plan_cache_->Put(input_shapes, CreateReshapePlan());
+    }
     return ret;
 }
 
 Status DefaultNetwork::DeInit() {
+    graph_executor_     = nullptr;
+    reshape_plan_cache_ = nullptr;
+
     for (size_t i = 0; i < layers_.size(); i++) {
         if (layers_[i] != NULL) {
             delete layers_[i];
@@ -566,6 +770,26 @@ Status DefaultNetwork::Forward() {
     
     status = context_->OnInstanceForwardBegin();
     RETURN_ON_NEQ(status, TNN_OK);
+
+    if (graph_executor_) {
+        // blob memory may be rebound by SetForwardMemory or the shared memory manager
+        if (graph_memory_generation_ != blob_manager_->GetMemoryGeneration()) {
+            status = graph_executor_->Build(layers_, device_);
+            if (status == TNN_OK) {
+                graph_memory_generation_ = blob_manager_->GetMemoryGeneration();
+            }
+        }
+        if (status == TNN_OK) {
+            int intra_op_threads = std::max(1, num_threads_ / graph_executor_->GetNumWorkers());
+            status               = graph_executor_->Run(intra_op_threads);
+        }
+
+        // the forward ends even if it failed, so that the context is ready for the next one
+        context_->OnInstanceForwardEnd();
+        RETURN_ON_NEQ(status, TNN_OK);
+        context_->Synchronize();
+        return status;
+    }
     
     int cnt = 0;
     for (auto layer : layers_) {
@@ -703,9 +927,23 @@ std::string DefaultNetwork::GenerateCacheFileName(ModelConfig &model_config, std
         "_" + md5_str;
 }
 
-Status DefaultNetwork::ReshapeLayers() {
-    for (auto cur_layer : layers_) {
-        auto status = cur_layer->Reshape();
+std::string DefaultNetwork::GetPackedWeightFile(NetworkConfig &net_config) {
+    // networks without a model hash pack their weights privately
+    if (!net_config.enable_packed_weight_file || net_config.cache_path.empty() || context_->GetModelHash().empty()) {
+        return "";
+    }
+    return net_config.cache_path + "/" + CACHE_TAG + "_" + ToString(net_config.device_type) + "_" +
+           ToString(context_->GetPrecision()) + "_" + md5(context_->GetModelHash()) + ".packed";
+}
+
+Status DefaultNetwork::ReshapeLayers(std::shared_ptr<ReshapePlan> plan) {
+    if (plan && (plan->output_dims.size() != layers_.size() || plan->inferred_params.size() != layers_.size())) {
+        plan = nullptr;
+    }
+    for (size_t i = 0; i < layers_.size(); i++) {
+        auto cur_layer = layers_[i];
+        auto status    = plan ? cur_layer->ReshapeWithPlan(plan->output_dims[i], plan->inferred_params[i])
+                              : cur_layer->Reshape();
         RETURN_ON_NEQ(status, TNN_OK);
         //Note output shape may not change after reshape for const folder, but will do change after forward because shape may be determined at rumtime
         LOGD("ReshapeLayers Output Shape: [%s]\n", cur_layer->GetOutputBlobs()[0]->GetBlobDesc().description().c_str());
@@ -713,4 +951,30 @@ Status DefaultNetwork::ReshapeLayers() {
     return TNN_OK;
 }
 
+InputShapesMap DefaultNetwork::GetInputShapes() {
+    BlobMap blobs;
+    blob_manager_->GetAllInputBlobs(blobs);
+    InputShapesMap shapes;
+    for (auto iter : blobs) {
+        shapes[iter.first] = iter.second->GetBlobDesc().dims;
+    }
+    return shapes;
+}
+
+std::shared_ptr<ReshapePlan> DefaultNetwork::CreateReshapePlan() {
+    auto plan = std::make_shared<ReshapePlan>();
+    for (auto layer : layers_) {
+        std::vector<DimsVector> output_dims;
+        for (auto blob : layer->GetOutputBlobs()) {
+            output_dims.push_back(blob->GetBlobDesc().dims);
+        }
+        plan->output_dims.push_back(output_dims);
+        plan->inferred_params.push_back(layer->GetInferredParams());
+    }
+    if (graph_executor_) {
+        plan->graph = graph_executor_->GetGraph();
+    }
+    return plan;
+}
+
 }  // namespace TNN_NS
@@ -24,7 +24,9 @@
 #include "tnn/core/common.h"
 #include "tnn/core/context.h"
 #include "tnn/core/macro.h"
+#include "tnn/core/parallel_graph_executor.h"
 #include "tnn/core/profile.h"
+#include "tnn/core/reshape_plan_cache.h"
 #include "tnn/core/status.h"
 #include "tnn/interpreter/abstract_model_interpreter.h"
 #include "tnn/interpreter/layer_resource.h"
@@ -80,6 +82,9 @@ public:
     // @brief get network forward for all blob memory size
     virtual Status GetForwardMemorySize(int &memory_size);
 
+    // @brief return the max amount of memory used by blobs alive at the same time
+    virtual Status GetForwardMemoryLowerBound(int &memory_size);
+
     // @brief set forward memory when share memory mode is set from external
     virtual Status SetForwardMemory(void *memory);
 
@@ -101,6 +106,8 @@ public:
 protected:
     virtual Status InitLayers(NetStructure *net_structure, NetResource *net_resource);
     virtual Status AllocateBlobMemory();
+    Status InitLayerAccs();
+    int GetInitNumThreads();
     RuntimeMode runtime_model_ = RUNTIME_MODE_NORMAL;
     
     Status GenerateInt8Blob(const std::string &name, NetResource *net_resource, Blob **blob);
@@ -108,10 +115,15 @@ protected:
                                const std::string &name, NetResource *net_resource, Blob **blob);
 
     std::string GenerateCacheFileName(ModelConfig &model_config, std::string& md5_str);
+    // @brief file in cache_path the packed weights are saved to, empty if not enabled
+    std::string GetPackedWeightFile(NetworkConfig &net_config);
 
     Status PrepareDoReshape(const InputShapesMap &inputs, bool& shape_changed);
     Status DoReshape();
 
+    Status InitGraphExecutor();
+    Status InitReshapePlanCache();
+
     AbstractDevice *device_ = nullptr;
     Context *context_       = nullptr;
     Context *GetContext();
@@ -126,11 +138,19 @@ protected:
 
     NetworkConfig config_;
 
+    std::shared_ptr<ParallelGraphExecutor> graph_executor_ = nullptr;
+    // memory generation of the blob manager the graph of the executor was built on
+    int graph_memory_generation_ = -1;
+    std::shared_ptr<ReshapePlanCache> reshape_plan_cache_ = nullptr;
+    int num_threads_ = 1;
+
     static std::mutex optimize_mtx_;
 
 private:
 
-   Status ReshapeLayers();
+   Status ReshapeLayers(std::shared_ptr<ReshapePlan> plan = nullptr);
+   InputShapesMap GetInputShapes();
+   std::shared_ptr<ReshapePlan> CreateReshapePlan();
 
 };
 
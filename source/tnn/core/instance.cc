@@ -19,6 +19,7 @@
 #include "tnn/core/abstract_network.h"
 #include "tnn/core/common.h"
 #include "tnn/core/const_folder.h"
+#include "tnn/core/instance_state.h"
 #include "tnn/core/macro.h"
 #include "tnn/core/profile.h"
 #include "tnn/core/status.h"
@@ -128,6 +129,7 @@ Status Instance::Init(std::shared_ptr<AbstractModelInterpreter> interpreter, Inp
 }
 
 Status Instance::DeInit() {
+    state_   = nullptr;
     network_ = nullptr;
     return TNN_OK;
 }
@@ -136,6 +138,10 @@ Status Instance::GetForwardMemorySize(int &memory_size) {
     return network_->GetForwardMemorySize(memory_size);
 }
 
+Status Instance::GetForwardMemoryLowerBound(int &memory_size) {
+    return network_->GetForwardMemoryLowerBound(memory_size);
+}
+
 Status Instance::SetForwardMemory(void *memory) {
     return network_->SetForwardMemory(memory);
 }
@@ -148,6 +154,18 @@ Status Instance::Reshape(const InputShapesMap &inputs) {
         RETURN_ON_NEQ(status, TNN_OK);
     }
     status = network_->Reshape(inputs);
+    RETURN_ON_NEQ(status, TNN_OK);
+
+    // states restart from zero once the state blobs are reshaped
+    if (state_) {
+        std::vector<std::pair<Blob *, Blob *>> blobs;
+        std::vector<BlobDesc> descs;
+        status = GetStateBlobs(blobs, descs);
+        RETURN_ON_NEQ(status, TNN_OK);
+        if (!state_->IsCompatible(descs)) {
+            status = state_->Init(descs);
+        }
+    }
     return status;
 }
 
@@ -165,13 +183,25 @@ AbstractNetwork *Instance::GetNetwork() {
 
 Status Instance::Forward() {
     output_mats_convert_status_.clear();
-    return network_->Forward();
+    auto status = BindState();
+    RETURN_ON_NEQ(status, TNN_OK);
+    status = network_->Forward();
+    if (state_ && status == TNN_OK) {
+        state_->Swap();
+    }
+    return status;
 }
 
 #ifdef FORWARD_CALLBACK_ENABLE
 Status Instance::ForwardWithCallback(BlobStatisticCallback before, BlobStatisticCallback after) {
     output_mats_convert_status_.clear();
-    return network_->ForwardWithCallback(before, after);
+    auto status = BindState();
+    RETURN_ON_NEQ(status, TNN_OK);
+    status = network_->ForwardWithCallback(before, after);
+    if (state_ && status == TNN_OK) {
+        state_->Swap();
+    }
+    return status;
 }
 #endif  // end of FORWARD_CALLBACK_ENABLE
 
@@ -184,7 +214,13 @@ std::shared_ptr<AbstractModelInterpreter> Instance::GetInterpreter() {
 
 Status Instance::ForwardAsync(Callback call_back) {
     output_mats_convert_status_.clear();
-    return (Status)network_->ForwardAsync(call_back);
+    auto status = BindState();
+    RETURN_ON_NEQ(status, TNN_OK);
+    status = network_->ForwardAsync(call_back);
+    if (state_ && status == TNN_OK) {
+        state_->Swap();
+    }
+    return status;
 }
 
 Status Instance::GetAllInputBlobs(BlobMap &blobs) {
@@ -199,6 +235,131 @@ Status Instance::SetCpuNumThreads(int num_threads) {
     return network_->SetCpuNumThreads(num_threads);
 }
 
+Status Instance::GetStateBlobs(std::vector<std::pair<Blob *, Blob *>> &blobs, std::vector<BlobDesc> &descs) {
+    BlobMap input_blobs, output_blobs;
+    RETURN_ON_NEQ(network_->GetAllInputBlobs(input_blobs), TNN_OK);
+    RETURN_ON_NEQ(network_->GetAllOutputBlobs(output_blobs), TNN_OK);
+
+    blobs.clear();
+    descs.clear();
+    for (auto names : state_names_) {
+        if (input_blobs.count(names.first) == 0 || output_blobs.count(names.second) == 0) {
+            LOGE("Instance: state blob pair (%s, %s) is not input and output of the network\n", names.first.c_str(),
+                 names.second.c_str());
+            return Status(TNNERR_PARAM_ERR, "state blob is not input or output of the network");
+        }
+        auto input  = input_blobs[names.first];
+        auto output = output_blobs[names.second];
+        auto desc   = input->GetBlobDesc();
+        auto output_desc = output->GetBlobDesc();
+        if (desc.dims != output_desc.dims || desc.data_type != output_desc.data_type ||
+            desc.data_format != output_desc.data_format) {
+            LOGE("Instance: state blob pair (%s, %s) has different shape or data type\n", names.first.c_str(),
+                 names.second.c_str());
+            return Status(TNNERR_PARAM_ERR, "state blob pair has different shape or data type");
+        }
+        blobs.push_back(std::make_pair(input, output));
+        descs.push_back(desc);
+    }
+    return TNN_OK;
+}
+
+Status Instance::BindState() {
+    if (!state_) {
+        return TNN_OK;
+    }
+    // blob handles may be rebound by the blob manager, e.g. shared forward memory changed
+    std::vector<std::pair<Blob *, Blob *>> blobs;
+    std::vector<BlobDesc> descs;
+    auto status = GetStateBlobs(blobs, descs);
+    RETURN_ON_NEQ(status, TNN_OK);
+    if (!state_->IsCompatible(descs)) {
+        return Status(TNNERR_PARAM_ERR, "state is created for different state blobs");
+    }
+    return state_->Bind(blobs);
+}
+
+Status Instance::DeclareState(const std::string &input_name, const std::string &output_name) {
+    RETURN_VALUE_ON_NEQ(network_ != nullptr, true, Status(TNNERR_INST_ERR, "instance is not initialized"));
+    for (auto names : state_names_) {
+        if (names.first == input_name || names.second == output_name) {
+            return Status(TNNERR_PARAM_ERR, "state blob is declared already");
+        }
+    }
+    state_names_.push_back(std::make_pair(input_name, output_name));
+
+    std::shared_ptr<InstanceState> state;
+    auto status = CreateState(state);
+    if (status != TNN_OK) {
+        state_names_.pop_back();
+        return status;
+    }
+    state_ = state;
+    return TNN_OK;
+}
+
+Status Instance::ResetState() {
+    RETURN_VALUE_ON_NEQ(state_ != nullptr, true, Status(TNNERR_PARAM_ERR, "no state is declared"));
+    return state_->Reset();
+}
+
+Status Instance::SnapshotState(std::shared_ptr<InstanceState> &snapshot) {
+    RETURN_VALUE_ON_NEQ(state_ != nullptr, true, Status(TNNERR_PARAM_ERR, "no state is declared"));
+    if (!snapshot) {
+        auto status = CreateState(snapshot);
+        RETURN_ON_NEQ(status, TNN_OK);
+    }
+    return snapshot->CopyFrom(state_.get());
+}
+
+Status Instance::RestoreState(std::shared_ptr<InstanceState> snapshot) {
+    RETURN_VALUE_ON_NEQ(state_ != nullptr, true, Status(TNNERR_PARAM_ERR, "no state is declared"));
+    RETURN_VALUE_ON_NEQ(snapshot != nullptr, true, Status(TNNERR_NULL_PARAM, "snapshot is null"));
+    return state_->CopyFrom(snapshot.get());
+}
+
+Status Instance::CreateState(std::shared_ptr<InstanceState> &state) {
+    RETURN_VALUE_ON_NEQ(network_ != nullptr, true, Status(TNNERR_INST_ERR, "instance is not initialized"));
+    std::vector<std::pair<Blob *, Blob *>> blobs;
+    std::vector<BlobDesc> descs;
+    auto status = GetStateBlobs(blobs, descs);
+    RETURN_ON_NEQ(status, TNN_OK);
+    if (descs.empty()) {
+        return Status(TNNERR_PARAM_ERR, "no state is declared");
+    }
+
+    auto device = GetDevice(descs[0].device_type);
+    RETURN_VALUE_ON_NEQ(device != nullptr, true, TNNERR_DEVICE_NOT_SUPPORT);
+    void *command_queue = nullptr;
+    network_->GetCommandQueue(&command_queue);
+
+    auto new_state = std::make_shared<InstanceState>(device, command_queue);
+    status         = new_state->Init(descs);
+    RETURN_ON_NEQ(status, TNN_OK);
+    state = new_state;
+    return TNN_OK;
+}
+
+Status Instance::SetState(std::shared_ptr<InstanceState> state) {
+    RETURN_VALUE_ON_NEQ(state_ != nullptr, true, Status(TNNERR_PARAM_ERR, "no state is declared"));
+    RETURN_VALUE_ON_NEQ(state != nullptr, true, Status(TNNERR_NULL_PARAM, "state is null"));
+    std::vector<std::pair<Blob *, Blob *>> blobs;
+    std::vector<BlobDesc> descs;
+    auto status = GetStateBlobs(blobs, descs);
+    RETURN_ON_NEQ(status, TNN_OK);
+    if (!state->IsCompatible(descs)) {
+        return Status(TNNERR_PARAM_ERR, "state is created for different state blobs");
+    }
+    state_ = state;
+    return TNN_OK;
+}
+
+Status Instance::GetState(std::shared_ptr<InstanceState> &state) {
+    RETURN_VALUE_ON_NEQ(state_ != nullptr, true, Status(TNNERR_PARAM_ERR, "no state is declared"));
+    state = state_;
+    return TNN_OK;
+}
+
 // set input Mat
 Status Instance::SetInputMat(std::shared_ptr<Mat> mat, MatConvertParam param, std::string input_name) {
     if (!mat) {
@@ -0,0 +1,133 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "tnn/core/instance_state.h"
+
+#include <cstring>
+
+#include "tnn/memory_manager/blob_memory_size_info.h"
+
+namespace TNN_NS {
+
+InstanceState::InstanceState(AbstractDevice *device, void *command_queue)
+    : device_(device), command_queue_(command_queue) {}
+
+InstanceState::~InstanceState() {
+    Release();
+}
+
+void InstanceState::Release() {
+    for (auto &buffer : buffers_) {
+        for (int i = 0; i < 2; i++) {
+            if (buffer.handles[i].base != nullptr) {
+                device_->Free(buffer.handles[i].base);
+                buffer.handles[i].base = nullptr;
+            }
+        }
+    }
+    buffers_.clear();
+}
+
+Status InstanceState::Init(const std::vector<BlobDesc> &descs) {
+    Release();
+    for (auto desc : descs) {
+        StateBuffer buffer;
+        buffer.desc = desc;
+        auto info   = device_->Calculate(desc);
+        buffer.bytes = (size_t)GetBlobMemoryBytesSize(info);
+        for (int i = 0; i < 2; i++) {
+            auto status = device_->Allocate(&buffer.handles[i], info);
+            if (status != TNN_OK) {
+                buffers_.push_back(buffer);
+                Release();
+                return status;
+            }
+        }
+        buffers_.push_back(buffer);
+    }
+    return Reset();
+}
+
+Status InstanceState::Reset() {
+    for (auto &buffer : buffers_) {
+        std::vector<char> zeros(buffer.bytes, 0);
+        BlobHandle host_handle;
+        host_handle.base = zeros.data();
+        buffer.current   = 0;
+        auto status      = device_->CopyToDevice(&buffer.handles[0], &host_handle, buffer.desc, command_queue_);
+        RETURN_ON_NEQ(status, TNN_OK);
+    }
+    return TNN_OK;
+}
+
+Status InstanceState::CopyFrom(InstanceState *other) {
+    if (other == this) {
+        return TNN_OK;
+    }
+    std::vector<BlobDesc> descs;
+    for (auto &buffer : buffers_) {
+        descs.push_back(buffer.desc);
+    }
+    if (!other->IsCompatible(descs)) {
+        return Status(TNNERR_PARAM_ERR, "InstanceState is created for different state blobs");
+    }
+
+    for (size_t i = 0; i < buffers_.size(); i++) {
+        auto &src = other->buffers_[i];
+        auto &dst = buffers_[i];
+        std::vector<char> host(src.bytes);
+        BlobHandle host_handle;
+        host_handle.base = host.data();
+        auto status = other->device_->CopyFromDevice(&host_handle, &src.handles[src.current], src.desc,
+                                                     other->command_queue_);
+        RETURN_ON_NEQ(status, TNN_OK);
+        status = device_->CopyToDevice(&dst.handles[dst.current], &host_handle, dst.desc, command_queue_);
+        RETURN_ON_NEQ(status, TNN_OK);
+    }
+    return TNN_OK;
+}
+
+bool InstanceState::IsCompatible(const std::vector<BlobDesc> &descs) {
+    if (descs.size() != buffers_.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < descs.size(); i++) {
+        auto desc = descs[i];
+        if (device_->GetDeviceType() != desc.device_type || buffers_[i].desc.data_type != desc.data_type ||
+            buffers_[i].desc.data_format != desc.data_format || buffers_[i].desc.dims != desc.dims) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Status InstanceState::Bind(const std::vector<std::pair<Blob *, Blob *>> &blobs) {
+    if (blobs.size() != buffers_.size()) {
+        return Status(TNNERR_PARAM_ERR, "InstanceState is created for different state blobs");
+    }
+    for (size_t i = 0; i < blobs.size(); i++) {
+        auto &buffer = buffers_[i];
+        blobs[i].first->SetHandle(buffer.handles[buffer.current]);
+        blobs[i].second->SetHandle(buffer.handles[1 - buffer.current]);
+    }
+    return TNN_OK;
+}
+
+void InstanceState::Swap() {
+    for (auto &buffer : buffers_) {
+        buffer.current = 1 - buffer.current;
+    }
+}
+
+}  // namespace TNN_NS
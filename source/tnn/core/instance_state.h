@@ -0,0 +1,77 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef TNN_SOURCE_TNN_CORE_INSTANCE_STATE_H_
+#define TNN_SOURCE_TNN_CORE_INSTANCE_STATE_H_
+
+#include <vector>
+
+#include "tnn/core/abstract_device.h"
+#include "tnn/core/blob.h"
+#include "tnn/core/status.h"
+
+namespace TNN_NS {
+
+// @brief InstanceState holds the recurrent state of one stream, e.g. hidden and
+// cell of LSTMs or caches of attention. Each state blob pair owns two buffers
+// of persistent memory out of the shared forward memory: the input blob reads
+// one while the output blob writes the other, and they are swapped after
+// forward, so the state is never copied between forwards.
+class InstanceState {
+public:
+    // @brief create state of the state blob pairs on device
+    InstanceState(AbstractDevice *device, void *command_queue);
+
+    ~InstanceState();
+
+    // @brief allocate zero buffers for the blobs described by descs
+    Status Init(const std::vector<BlobDesc> &descs);
+
+    // @brief set all states to zero
+    Status Reset();
+
+    // @brief copy the states of other, both must be created for the same blobs
+    Status CopyFrom(InstanceState *other);
+
+    // @brief check if the state fits the blobs described by descs
+    bool IsCompatible(const std::vector<BlobDesc> &descs);
+
+    // @brief bind the buffers to the state blob pairs {input, output} before forward
+    Status Bind(const std::vector<std::pair<Blob *, Blob *>> &blobs);
+
+    // @brief output buffers hold the latest states after forward, read them in the next one
+    void Swap();
+
+private:
+    InstanceState(const InstanceState &);
+    InstanceState &operator=(const InstanceState &);
+
+    struct StateBuffer {
+        BlobDesc desc;
+        size_t bytes = 0;
+        // handles[current] holds the latest state
+        BlobHandle handles[2];
+        int current = 0;
+    };
+
+    void Release();
+
+    AbstractDevice *device_ = nullptr;
+    void *command_queue_    = nullptr;
+    std::vector<StateBuffer> buffers_;
+};
+
+}  // namespace TNN_NS
+
+#endif  // TNN_SOURCE_TNN_CORE_INSTANCE_STATE_H_
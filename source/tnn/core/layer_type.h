@@ -237,6 +237,7 @@ enum LayerType {
 
     LAYER_CBAM_FUSED_REDUCE                                 = 800,
     LAYER_CBAM_FUSED_POOLING                                = 801,
+    LAYER_FUSED_ATTENTION                                   = 802,
 
     // TNN Graph Matcher related LAYER_TYPES
     LAYER_DUMMY_TYPE                                        = 1000,
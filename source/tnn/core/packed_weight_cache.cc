@@ -0,0 +1,290 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "tnn/core/packed_weight_cache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "tnn/interpreter/tnn/objseri.h"
+#include "tnn/utils/mapped_file.h"
+#include "tnn/utils/string_utils_inner.h"
+
+namespace TNN_NS {
+
+struct PackedWeightEntry {
+    std::mutex mutex;
+    std::weak_ptr<RawBuffer> holder;
+    PackedWeightKey key;
+    // the packed weights are mapped from a packed weight file
+    bool from_file = false;
+};
+
+// bump the version when the layout of packed weights changes
+static const uint32_t kPackedWeightFileMagic = 0x0FABC0101;
+static const int kPackedWeightFileVersion    = 1;
+// packed weights are aligned for vector loads in the mapped file
+static const int kPackedWeightFileAlignment  = 64;
+
+static std::mutex g_cache_mutex;
+// the file may be written by several networks of the same model in the process
+static std::mutex g_file_mutex;
+
+static std::map<std::string, std::shared_ptr<PackedWeightEntry>> &GetEntries() {
+    static std::map<std::string, std::shared_ptr<PackedWeightEntry>> entries;
+    return entries;
+}
+
+// size, data type and a hash of all the data, weights differing anywhere (e.g. resources
+// changed by net optimizers) get keys of their own. One read pass, cheaper than packing.
+static std::string GetFingerprint(const RawBuffer &source) {
+    const int bytes_size = source.GetBytesSize();
+    const char *data     = source.force_to<const char *>();
+
+    uint64_t hash = 14695981039346656037ULL;
+    if (data && bytes_size > 0) {
+        int i = 0;
+        for (; i + (int)sizeof(uint64_t) <= bytes_size; i += sizeof(uint64_t)) {
+            uint64_t word;
+            memcpy(&word, data + i, sizeof(uint64_t));
+            hash = (hash ^ word) * 1099511628211ULL;
+        }
+        for (; i < bytes_size; i++) {
+            hash = (hash ^ (uint8_t)data[i]) * 1099511628211ULL;
+        }
+    }
+    return ToString(bytes_size) + "_" + ToString((int)source.GetDataType()) + "_" + ToString(hash);
+}
+
+static RawBuffer SharedBuffer(const std::shared_ptr<RawBuffer> &holder) {
+    // aliasing shared_ptr, the holder is released with the last buffer sharing it
+    RawBuffer buffer(holder->GetBytesSize(), std::shared_ptr<char>(holder, holder->force_to<char *>()),
+                     holder->GetBufferDims());
+    buffer.SetDataType(holder->GetDataType());
+    return buffer;
+}
+
+std::string PackedWeightKey::ToString() const {
+    return model_hash + "|" + layer_name + "|" + TNN_NS::ToString((int)device_type) + "|" +
+           TNN_NS::ToString((int)precision) + "|" + variant + "|" + source;
+}
+
+PackedWeightKey PackedWeightCache::CreateKey(Context *context, LayerParam *param, DeviceType device_type,
+                                             const std::string &variant, const RawBuffer &source) {
+    PackedWeightKey key;
+    if (!context || !param) {
+        return key;
+    }
+    key.model_hash  = context->GetModelHash();
+    key.layer_name  = param->name;
+    key.device_type = device_type;
+    key.precision   = context->GetPrecision();
+    key.variant     = variant;
+    key.source      = GetFingerprint(source);
+    return key;
+}
+
+Status PackedWeightCache::GetOrPack(const PackedWeightKey &key, WeightPacker packer, RawBuffer &packed) {
+    if (key.model_hash.empty() || key.layer_name.empty()) {
+        return packer(packed);
+    }
+
+    const std::string key_str = key.ToString();
+    std::shared_ptr<PackedWeightEntry> entry;
+    {
+        std::unique_lock<std::mutex> lck(g_cache_mutex);
+        auto &entries = GetEntries();
+        auto iter     = entries.find(key_str);
+        if (iter != entries.end()) {
+            entry = iter->second;
+        } else {
+            // drop the entries of released models before adding new ones
+            for (auto it = entries.begin(); it != entries.end();) {
+                if (it->second->holder.expired()) {
+                    it = entries.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            entry            = std::make_shared<PackedWeightEntry>();
+            entry->key       = key;
+            entries[key_str] = entry;
+        }
+    }
+
+    // pack once per key, networks initialized at the same time wait for the first one
+    std::unique_lock<std::mutex> lck(entry->mutex);
+    auto holder = entry->holder.lock();
+    if (holder) {
+        packed = SharedBuffer(holder);
+        return TNN_OK;
+    }
+
+    RawBuffer buffer;
+    auto status = packer(buffer);
+    if (status != TNN_OK || buffer.GetBytesSize() <= 0) {
+        packed = buffer;
+        return status;
+    }
+    holder           = std::make_shared<RawBuffer>(buffer);
+    entry->holder    = holder;
+    entry->from_file = false;
+    packed           = SharedBuffer(holder);
+    return TNN_OK;
+}
+
+int PackedWeightCache::GetSharedCount() {
+    std::unique_lock<std::mutex> lck(g_cache_mutex);
+    int count = 0;
+    for (const auto &iter : GetEntries()) {
+        count += iter.second->holder.expired() ? 0 : 1;
+    }
+    return count;
+}
+
+Status PackedWeightCache::SaveFile(const std::string &path, const std::string &model_hash, DeviceType device_type,
+                                   Precision precision, const std::string &isa_tag) {
+    if (model_hash.empty()) {
+        return Status(TNNERR_PARAM_ERR, "model hash is empty");
+    }
+
+    std::vector<std::pair<PackedWeightKey, std::shared_ptr<RawBuffer>>> weights;
+    bool all_from_file = true;
+    {
+        std::unique_lock<std::mutex> lck(g_cache_mutex);
+        for (const auto &iter : GetEntries()) {
+            const auto &key = iter.second->key;
+            auto holder     = iter.second->holder.lock();
+            if (!holder || key.model_hash != model_hash || key.device_type != device_type ||
+                key.precision != precision) {
+                continue;
+            }
+            all_from_file &= iter.second->from_file;
+            weights.push_back(std::make_pair(key, holder));
+        }
+    }
+    if (weights.empty() || all_from_file) {
+        return TNN_OK;
+    }
+
+    std::unique_lock<std::mutex> lck(g_file_mutex);
+    // write to a temp file then rename, readers never map a partial file
+    auto temp_path = path + ".tmp";
+    {
+        std::ofstream stream(temp_path, std::ios::binary);
+        if (!stream.is_open()) {
+            LOGE("packed weight file %s can not be written\n", temp_path.c_str());
+            return Status(TNNERR_PARAM_ERR, "packed weight file can not be written");
+        }
+        Serializer serializer(stream);
+        serializer.SetDataAlignment(kPackedWeightFileAlignment);
+        serializer.PutInt(kPackedWeightFileMagic);
+        serializer.PutInt(kPackedWeightFileVersion);
+        serializer.PutString(isa_tag);
+        serializer.PutInt((int)weights.size());
+        for (auto &weight : weights) {
+            serializer.PutString(weight.first.model_hash);
+            serializer.PutString(weight.first.layer_name);
+            serializer.PutInt(weight.first.device_type);
+            serializer.PutInt(weight.first.precision);
+            serializer.PutString(weight.first.variant);
+            serializer.PutString(weight.first.source);
+            serializer.PutRaw(*weight.second);
+        }
+        if (!stream.good()) {
+            LOGE("packed weight file %s write failed\n", temp_path.c_str());
+            stream.close();
+            std::remove(temp_path.c_str());
+            return Status(TNNERR_PARAM_ERR, "packed weight file write failed");
+        }
+    }
+    if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+        LOGE("packed weight file %s rename failed\n", path.c_str());
+        std::remove(temp_path.c_str());
+        return Status(TNNERR_PARAM_ERR, "packed weight file rename failed");
+    }
+    LOGI("save %d packed weights to %s\n", (int)weights.size(), path.c_str());
+    return TNN_OK;
+}
+
+Status PackedWeightCache::LoadFile(const std::string &path, const std::string &isa_tag,
+                                   std::shared_ptr<void> &holder) {
+    if (!std::ifstream(path).good()) {
+        return Status(TNNERR_PARAM_ERR, "packed weight file not found");
+    }
+    std::shared_ptr<MappedFile> mapped_file;
+    auto status = MappedFile::Open(path, mapped_file);
+    RETURN_ON_NEQ(status, TNN_OK);
+
+    MemoryStreamBuf stream_buf(mapped_file->GetData(), mapped_file->GetSize());
+    std::istream stream(&stream_buf);
+    MappedDeserializer deserializer(stream, mapped_file->GetData(), mapped_file->GetSize(), mapped_file);
+    if (static_cast<uint32_t>(deserializer.GetInt()) != kPackedWeightFileMagic ||
+        deserializer.GetInt() != kPackedWeightFileVersion || deserializer.GetString() != isa_tag) {
+        LOGI("packed weight file %s has another version or isa, ignored\n", path.c_str());
+        return Status(TNNERR_PARAM_ERR, "packed weight file version or isa mismatch");
+    }
+
+    const int count = deserializer.GetInt();
+    std::vector<std::pair<PackedWeightKey, std::shared_ptr<RawBuffer>>> weights;
+    for (int i = 0; i < count && stream.good(); ++i) {
+        PackedWeightKey key;
+        key.model_hash  = deserializer.GetString();
+        key.layer_name  = deserializer.GetString();
+        key.device_type = (DeviceType)deserializer.GetInt();
+        key.precision   = (Precision)deserializer.GetInt();
+        key.variant     = deserializer.GetString();
+        key.source      = deserializer.GetString();
+        // raw buffers aligned in the file share the mapping, which lives as long as any of them
+        auto buffer = std::make_shared<RawBuffer>();
+        deserializer.GetRaw(*buffer);
+        weights.push_back(std::make_pair(key, buffer));
+    }
+    // add nothing from a truncated file
+    if (!stream.good() || (int)weights.size() != count) {
+        LOGE("packed weight file %s is truncated\n", path.c_str());
+        return Status(TNNERR_PARAM_ERR, "packed weight file is truncated");
+    }
+
+    auto buffers = std::make_shared<std::vector<std::shared_ptr<RawBuffer>>>();
+    {
+        std::unique_lock<std::mutex> lck(g_cache_mutex);
+        auto &entries = GetEntries();
+        for (auto &weight : weights) {
+            const std::string key_str = weight.first.ToString();
+            auto &entry               = entries[key_str];
+            if (!entry) {
+                entry      = std::make_shared<PackedWeightEntry>();
+                entry->key = weight.first;
+            }
+            std::unique_lock<std::mutex> entry_lck(entry->mutex);
+            if (!entry->holder.expired()) {
+                continue;
+            }
+            entry->holder    = weight.second;
+            entry->from_file = true;
+            buffers->push_back(weight.second);
+        }
+    }
+    holder = buffers;
+    LOGI("map %d packed weights from %s\n", (int)buffers->size(), path.c_str());
+    return TNN_OK;
+}
+
+}  // namespace TNN_NS
@@ -0,0 +1,73 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef TNN_SOURCE_TNN_CORE_PACKED_WEIGHT_CACHE_H_
+#define TNN_SOURCE_TNN_CORE_PACKED_WEIGHT_CACHE_H_
+
+#include <functional>
+#include <string>
+
+#include "tnn/core/common.h"
+#include "tnn/core/context.h"
+#include "tnn/core/status.h"
+#include "tnn/interpreter/layer_param.h"
+#include "tnn/interpreter/raw_buffer.h"
+
+namespace TNN_NS {
+
+struct PackedWeightKey {
+    // hash of the model, weights are not shared if it is empty
+    std::string model_hash = "";
+    std::string layer_name = "";
+    DeviceType device_type = DEVICE_NAIVE;
+    Precision precision    = PRECISION_AUTO;
+    // layout of the packed weights, e.g. acc type and block sizes
+    std::string variant = "";
+    // fingerprint of the source weights, tells apart resources changed by net optimizers
+    std::string source = "";
+
+    std::string ToString() const;
+};
+
+typedef std::function<Status(RawBuffer &packed)> WeightPacker;
+
+// @brief PackedWeightCache shares the packed weights of layer accs among all
+// networks of the same model in the process, so that only the blob memory grows
+// with the number of instances. Packed weights are reference counted by the raw
+// buffers handed out, and released with the last layer acc using them.
+class PackedWeightCache {
+public:
+    // @brief create the key of the packed weights of a layer acc
+    static PackedWeightKey CreateKey(Context *context, LayerParam *param, DeviceType device_type,
+                                     const std::string &variant, const RawBuffer &source);
+
+    // @brief get the packed weights of the key, run packer if no layer acc holds them yet
+    static Status GetOrPack(const PackedWeightKey &key, WeightPacker packer, RawBuffer &packed);
+
+    // @brief number of packed weights currently shared
+    static int GetSharedCount();
+
+    // @brief save the shared packed weights of the model, device and precision to file, nothing is written if all
+    // of them are mapped from the file already
+    static Status SaveFile(const std::string &path, const std::string &model_hash, DeviceType device_type,
+                           Precision precision, const std::string &isa_tag);
+
+    // @brief map the packed weights saved by SaveFile and share them, they stay in the cache as long as holder
+    // or a layer acc uses them. files of another format version or isa tag are not loaded
+    static Status LoadFile(const std::string &path, const std::string &isa_tag, std::shared_ptr<void> &holder);
+};
+
+}  // namespace TNN_NS
+
+#endif  // TNN_SOURCE_TNN_CORE_PACKED_WEIGHT_CACHE_H_
@@ -0,0 +1,228 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "tnn/core/parallel_graph_executor.h"
+
+#include "tnn/memory_manager/blob_memory_size_info.h"
+
+namespace TNN_NS {
+
+static inline bool IsOverlapped(const std::vector<std::pair<uintptr_t, uintptr_t>> &a,
+                                const std::vector<std::pair<uintptr_t, uintptr_t>> &b) {
+    for (const auto &range_a : a) {
+        for (const auto &range_b : b) {
+            if (range_a.first < range_b.second && range_b.first < range_a.second) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+ParallelGraphExecutor::ParallelGraphExecutor(int num_workers, std::vector<int> cpu_affinity)
+    : cpu_affinity_(cpu_affinity), num_finished_(0), failed_(false) {
+    num_workers_ = num_workers < 1 ? 1 : num_workers;
+    pool_        = std::make_shared<ThreadPool>(num_workers_);
+    worker_pools_.resize(num_workers_);
+}
+
+ParallelGraphExecutor::~ParallelGraphExecutor() {
+    pool_ = nullptr;
+}
+
+int ParallelGraphExecutor::GetNumWorkers() const {
+    return num_workers_;
+}
+
+bool ParallelGraphExecutor::IsSupported(const std::vector<BaseLayer *> &layers, AbstractDevice *device) {
+    // only host memory devices, blob memory of other devices can not be compared by address
+    auto device_type = device->GetDeviceType();
+    if (device_type != DEVICE_NAIVE && device_type != DEVICE_X86 && device_type != DEVICE_ARM) {
+        return false;
+    }
+    for (auto layer : layers) {
+        for (auto blob : layer->GetInputBlobs()) {
+            if (blob->NeedAllocateInForward()) {
+                return false;
+            }
+        }
+        // blobs allocated in forward share the runtime blob pool of the network
+        for (auto blob : layer->GetOutputBlobs()) {
+            if (blob->NeedAllocateInForward()) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void ParallelGraphExecutor::GetMemoryRanges(const std::vector<BaseLayer *> &layers, AbstractDevice *device,
+                                            std::vector<MemoryRange> &ranges) {
+    ranges.clear();
+    auto get_range = [&](Blob *blob) {
+        auto handle = blob->GetHandle();
+        if (handle.base == nullptr) {
+            return MemoryRange(0, 0);
+        }
+        BlobMemorySizeInfo info = device->Calculate(blob->GetBlobDesc());
+        uintptr_t start         = (uintptr_t)handle.base + (uintptr_t)handle.bytes_offset;
+        return MemoryRange(start, start + (uintptr_t)GetBlobMemoryBytesSize(info));
+    };
+    for (auto layer : layers) {
+        for (auto blob : layer->GetInputBlobs()) {
+            ranges.push_back(get_range(blob));
+        }
+        for (auto blob : layer->GetOutputBlobs()) {
+            ranges.push_back(get_range(blob));
+        }
+    }
+}
+
+Status ParallelGraphExecutor::Build(const std::vector<BaseLayer *> &layers, AbstractDevice *device) {
+    GetMemoryRanges(layers, device, memory_snapshot_);
+
+    nodes_.clear();
+    nodes_.resize(layers.size());
+    int range_index = 0;
+    for (size_t i = 0; i < layers.size(); i++) {
+        auto &node = nodes_[i];
+        node.layer = layers[i];
+        for (size_t j = 0; j < layers[i]->GetInputBlobs().size(); j++) {
+            node.reads.push_back(memory_snapshot_[range_index++]);
+        }
+        for (size_t j = 0; j < layers[i]->GetOutputBlobs().size(); j++) {
+            node.writes.push_back(memory_snapshot_[range_index++]);
+        }
+    }
+
+    // keep the sequential order of every pair of layers touching the same memory,
+    // at least one of them writing it. blob memory reused by the blob manager is
+    // then never overwritten while an earlier layer still reads it.
+    for (size_t j = 0; j < nodes_.size(); j++) {
+        for (size_t i = 0; i < j; i++) {
+            if (IsOverlapped(nodes_[i].writes, nodes_[j].reads) || IsOverlapped(nodes_[i].writes, nodes_[j].writes) ||
+                IsOverlapped(nodes_[i].reads, nodes_[j].writes)) {
+                nodes_[i].successors.push_back((int)j);
+                nodes_[j].num_predecessors++;
+            }
+        }
+    }
+
+    pending_.reset(new std::atomic<int>[nodes_.size()]);
+    return TNN_OK;
+}
+
+std::shared_ptr<ParallelGraphExecutor::Graph> ParallelGraphExecutor::GetGraph() const {
+    auto graph             = std::make_shared<Graph>();
+    graph->memory_snapshot = memory_snapshot_;
+    for (const auto &node : nodes_) {
+        graph->successors.push_back(node.successors);
+        graph->num_predecessors.push_back(node.num_predecessors);
+    }
+    return graph;
+}
+
+Status ParallelGraphExecutor::SetGraph(const std::vector<BaseLayer *> &layers, AbstractDevice *device,
+                                       std::shared_ptr<Graph> graph) {
+    if (!graph || graph->successors.size() != layers.size()) {
+        return Status(TNNERR_PARAM_ERR, "ParallelGraphExecutor graph does not match the layers");
+    }
+    std::vector<MemoryRange> ranges;
+    GetMemoryRanges(layers, device, ranges);
+    if (ranges != graph->memory_snapshot) {
+        return Status(TNNERR_PARAM_ERR, "ParallelGraphExecutor graph does not match the blob memory");
+    }
+
+    memory_snapshot_ = std::move(ranges);
+    nodes_.clear();
+    nodes_.resize(layers.size());
+    for (size_t i = 0; i < layers.size(); i++) {
+        nodes_[i].layer            = layers[i];
+        nodes_[i].successors       = graph->successors[i];
+        nodes_[i].num_predecessors = graph->num_predecessors[i];
+    }
+    pending_.reset(new std::atomic<int>[nodes_.size()]);
+    return TNN_OK;
+}
+
+Status ParallelGraphExecutor::Run(int intra_op_threads) {
+    const int count = (int)nodes_.size();
+    if (count == 0) {
+        return TNN_OK;
+    }
+
+    num_finished_ = 0;
+    failed_       = false;
+    status_       = TNN_OK;
+    for (int i = 0; i < count; i++) {
+        pending_[i] = nodes_[i].num_predecessors;
+    }
+    for (int i = 0; i < count; i++) {
+        if (nodes_[i].num_predecessors == 0) {
+            pool_->Submit([this, i, intra_op_threads]() { RunNode(i, intra_op_threads); });
+        }
+    }
+
+    std::unique_lock<std::mutex> lck(mutex_);
+    cond_.wait(lck, [this, count] { return num_finished_ == count; });
+    return status_;
+}
+
+void ParallelGraphExecutor::RunNode(int index, int intra_op_threads) {
+    auto &worker_pool = worker_pools_[ThreadPool::GetWorkerIndex()];
+    if (!worker_pool || worker_pool->GetNumThreads() != intra_op_threads) {
+        worker_pool = std::make_shared<ParallelForPool>(intra_op_threads, cpu_affinity_);
+    }
+    // intra-op loops of all host devices run on this pool, it binds the worker itself to cpu_affinity_ too
+    BindParallelForPool(worker_pool);
+
+    while (index >= 0) {
+        auto &node = nodes_[index];
+        if (!failed_) {
+            Status status = node.layer->Forward();
+            LOGD("layer name: %s, forward result: %d \n", node.layer->GetLayerName().c_str(), (int)status);
+            if (status != TNN_OK) {
+                LOGE("Forward error %s, exit\n", status.description().c_str());
+                std::unique_lock<std::mutex> lck(mutex_);
+                if (!failed_) {
+                    status_ = status;
+                    failed_ = true;
+                }
+            }
+        }
+
+        // continue with the first ready successor on this worker, hand the others to the pool
+        int next_index = -1;
+        for (auto successor : node.successors) {
+            if (--pending_[successor] == 0) {
+                if (next_index < 0) {
+                    next_index = successor;
+                } else {
+                    pool_->Submit([this, successor, intra_op_threads]() { RunNode(successor, intra_op_threads); });
+                }
+            }
+        }
+        FinishNode();
+        index = next_index;
+    }
+}
+
+void ParallelGraphExecutor::FinishNode() {
+    if (++num_finished_ == (int)nodes_.size()) {
+        std::unique_lock<std::mutex> lck(mutex_);
+        cond_.notify_all();
+    }
+}
+
+}  // namespace TNN_NS
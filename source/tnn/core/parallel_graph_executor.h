@@ -0,0 +1,107 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef TNN_SOURCE_TNN_CORE_PARALLEL_GRAPH_EXECUTOR_H_
+#define TNN_SOURCE_TNN_CORE_PARALLEL_GRAPH_EXECUTOR_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "tnn/core/abstract_device.h"
+#include "tnn/core/status.h"
+#include "tnn/layer/base_layer.h"
+#include "tnn/utils/parallel_for.h"
+#include "tnn/utils/thread_pool.h"
+
+namespace TNN_NS {
+
+// @brief ParallelGraphExecutor runs the layers of a network as a dependency graph.
+// A layer depends on every previous layer whose blob memory overlaps with its own
+// in a conflicting way (read after write, write after read, write after write), so
+// both the data flow and the memory reused by the blob manager are respected.
+// Layers without pending dependencies run concurrently on a work-stealing pool.
+class ParallelGraphExecutor {
+public:
+    typedef std::pair<uintptr_t, uintptr_t> MemoryRange;
+
+    // @brief dependency graph of a Build, valid as long as the blob memory is the same
+    struct Graph {
+        std::vector<MemoryRange> memory_snapshot;
+        std::vector<std::vector<int>> successors;
+        std::vector<int> num_predecessors;
+    };
+
+    // @brief create executor running at most num_workers layers at the same time,
+    // the workers and their loop threads are bound to the cpus in cpu_affinity if not empty
+    explicit ParallelGraphExecutor(int num_workers, std::vector<int> cpu_affinity = {});
+
+    ~ParallelGraphExecutor();
+
+    // @brief check if layers can be executed out of order on the device
+    static bool IsSupported(const std::vector<BaseLayer *> &layers, AbstractDevice *device);
+
+    // @brief build the dependency graph from the blob memory bound to the layers
+    Status Build(const std::vector<BaseLayer *> &layers, AbstractDevice *device);
+
+    // @brief get the dependency graph of the last Build
+    std::shared_ptr<Graph> GetGraph() const;
+
+    // @brief restore a graph got from GetGraph without building it again,
+    // fails if the blob memory bound to the layers differs from the graph's
+    Status SetGraph(const std::vector<BaseLayer *> &layers, AbstractDevice *device, std::shared_ptr<Graph> graph);
+
+    // @brief run all layers, each running layer uses at most intra_op_threads threads
+    Status Run(int intra_op_threads);
+
+    // @brief get the max number of layers that may run concurrently
+    int GetNumWorkers() const;
+
+private:
+    struct LayerNode {
+        BaseLayer *layer = nullptr;
+        std::vector<MemoryRange> reads;
+        std::vector<MemoryRange> writes;
+        std::vector<int> successors;
+        int num_predecessors = 0;
+    };
+
+    void GetMemoryRanges(const std::vector<BaseLayer *> &layers, AbstractDevice *device,
+                         std::vector<MemoryRange> &ranges);
+    void RunNode(int index, int intra_op_threads);
+    void FinishNode();
+
+    std::shared_ptr<ThreadPool> pool_ = nullptr;
+    int num_workers_                  = 1;
+    std::vector<int> cpu_affinity_;
+    // loop pool of each worker, only touched by the worker itself
+    std::vector<std::shared_ptr<ParallelForPool>> worker_pools_;
+
+    std::vector<LayerNode> nodes_;
+    std::vector<MemoryRange> memory_snapshot_;
+
+    std::unique_ptr<std::atomic<int>[]> pending_;
+    std::atomic<int> num_finished_;
+    std::atomic<bool> failed_;
+    Status status_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+};
+
+}  // namespace TNN_NS
+
+#endif  // TNN_SOURCE_TNN_CORE_PARALLEL_GRAPH_EXECUTOR_H_
@@ -0,0 +1,55 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "tnn/core/reshape_plan_cache.h"
+
+namespace TNN_NS {
+
+ReshapePlanCache::ReshapePlanCache(int capacity) : capacity_(capacity < 0 ? 0 : capacity) {}
+
+std::shared_ptr<ReshapePlan> ReshapePlanCache::Get(const InputShapesMap &shapes) {
+    for (auto iter = plans_.begin(); iter != plans_.end(); ++iter) {
+        if (iter->first == shapes) {
+            plans_.splice(plans_.begin(), plans_, iter);
+            return plans_.front().second;
+        }
+    }
+    return nullptr;
+}
+
+void ReshapePlanCache::Put(const InputShapesMap &shapes, std::shared_ptr<ReshapePlan> plan) {
+    if (capacity_ <= 0 || !plan) {
+        return;
+    }
+    for (auto iter = plans_.begin(); iter != plans_.end(); ++iter) {
+        if (iter->first == shapes) {
+            plans_.erase(iter);
+            break;
+        }
+    }
+    plans_.emplace_front(shapes, plan);
+    while ((int)plans_.size() > capacity_) {
+        plans_.pop_back();
+    }
+}
+
+void ReshapePlanCache::Clear() {
+    plans_.clear();
+}
+
+int ReshapePlanCache::GetSize() const {
+    return (int)plans_.size();
+}
+
+}  // namespace TNN_NS
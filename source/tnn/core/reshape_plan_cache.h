@@ -0,0 +1,66 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef TNN_SOURCE_TNN_CORE_RESHAPE_PLAN_CACHE_H_
+#define TNN_SOURCE_TNN_CORE_RESHAPE_PLAN_CACHE_H_
+
+#include <list>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "tnn/core/common.h"
+#include "tnn/core/parallel_graph_executor.h"
+
+namespace TNN_NS {
+
+// @brief ReshapePlan records the result of reshaping a network to one set of input shapes
+struct ReshapePlan {
+    // output dims of every layer, in the order of the layers
+    std::vector<std::vector<DimsVector>> output_dims;
+    // params every layer wrote from its input dims, in the order of the layers
+    std::vector<std::vector<int>> inferred_params;
+    // dependency graph of the parallel graph executor, null if layers run in order
+    std::shared_ptr<ParallelGraphExecutor::Graph> graph = nullptr;
+};
+
+// @brief ReshapePlanCache keeps the plans of the most recently used input shapes,
+// so that networks flipping between a few recurring shapes, e.g. batch sizes or
+// sequence lengths, reshape without inferring the layer shapes again.
+class ReshapePlanCache {
+public:
+    // @brief create cache keeping at most capacity plans
+    explicit ReshapePlanCache(int capacity);
+
+    // @brief get the plan of the input shapes, null if not cached
+    std::shared_ptr<ReshapePlan> Get(const InputShapesMap &shapes);
+
+    // @brief cache the plan of the input shapes, the least recently used plan is dropped if full
+    void Put(const InputShapesMap &shapes, std::shared_ptr<ReshapePlan> plan);
+
+    // @brief drop all plans
+    void Clear();
+
+    // @brief number of cached plans
+    int GetSize() const;
+
+private:
+    int capacity_ = 0;
+    // most recently used first
+    std::list<std::pair<InputShapesMap, std::shared_ptr<ReshapePlan>>> plans_;
+};
+
+}  // namespace TNN_NS
+
+#endif  // TNN_SOURCE_TNN_CORE_RESHAPE_PLAN_CACHE_H_
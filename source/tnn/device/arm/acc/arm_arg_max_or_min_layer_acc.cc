@@ -15,7 +15,7 @@
 #include "tnn/device/arm/acc/arm_layer_acc.h"
 #include "tnn/utils/data_type_utils.h"
 #include "tnn/utils/dims_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 
@@ -15,7 +15,7 @@
 #include "tnn/device/arm/acc/arm_layer_acc.h"
 #include "tnn/utils/data_type_utils.h"
 #include "tnn/utils/dims_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 using namespace arm;
@@ -48,8 +48,7 @@ static void ComputeNCHW(const std::vector<Blob *> &inputs, const std::vector<Blo
         auto input_data_b  = input_base_ptr + n * channel * input_channel_area;
         auto grid_data_b   = grid_base_ptr + n * grid_area;
         auto output_data_b = output_base_ptr + n * channel * output_channel_area;
-        OMP_PARALLEL_FOR_
-        for (int i = 0; i < output_channel_area; ++i) {
+        ParallelFor(0, output_channel_area, [&](int i) {
             auto grid_position = grid_data_b + i * 2;
             float x            = grid_position[0];
             float y            = grid_position[1];
@@ -94,7 +93,7 @@ static void ComputeNCHW(const std::vector<Blob *> &inputs, const std::vector<Blo
                 res += input_data[se_index] * se;
                 *output_data = res;
             }
-        }
+        });
     }
 }
 
@@ -132,8 +131,7 @@ static void ComputeNC4HW4(const std::vector<Blob *> &inputs, const std::vector<B
             grid_buffer = reorder_grid_buffer.force_to<float *>();
         }
         for (int c = 0; c < channel_ud4; c++) {
-            OMP_PARALLEL_FOR_
-            for (int i = 0; i < output_channel_area; ++i) {
+            ParallelFor(0, output_channel_area, [&](int i) {
                 auto grid_position = grid_buffer + 2 * i;
                 float x            = grid_position[0];
                 float y            = grid_position[1];
@@ -182,7 +180,7 @@ static void ComputeNC4HW4(const std::vector<Blob *> &inputs, const std::vector<B
                     res_v = res_v + Float4::load(input_data + iy_se * input_width * 4 + ix_se * 4) * se_v;
                 }
                 Float4::save(output_data, res_v);
-            }
+            });
         }
     }
 }
@@ -22,7 +22,7 @@
 #include "tnn/utils/data_format_converter.h"
 #include "tnn/utils/data_type_utils.h"
 #include "tnn/utils/dims_vector_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 #include "tnn/utils/cpu_utils.h"
 #ifdef TNN_ARM82_USE_NEON
 #include "tnn/device/arm/acc/compute_arm82/compute_sdot_int8.h"
@@ -67,8 +67,8 @@ static void PackWeightO4(const T *src, T *dst, const int oc, const int ic) {
 // get 4 result at a time
 template <typename T>
 static void SGEMV(T *dst, const T *src, T *weight, const int oc_r4, const int ic_r4) {
-    OMP_PARALLEL_FOR_
-    for (int o = 0; o < oc_r4; o += 4) {
+    ParallelFor(0, UP_DIV(oc_r4, 4), [&](int o_i) {
+        int o = o_i * 4;
         auto weight_z = weight + o * ic_r4;
         Float4 acc(0.f);
         for (int i = 0; i < ic_r4; i += 4) {
@@ -86,7 +86,7 @@ static void SGEMV(T *dst, const T *src, T *weight, const int oc_r4, const int ic
             Float4::mla_lane1(acc, w3, v0_1);
         }
         Float4::save(dst + o, acc);
-    }
+    });
 }
 
 Status ArmInnerProductLayerAcc::allocateBufferWeight(const std::vector<Blob *> &inputs,
@@ -323,12 +323,11 @@ Status ArmInnerProductLayerAcc::Exec<float>(const std::vector<Blob *> &inputs, c
     }
 
     if (fc_param->has_bias) {
-        OMP_PARALLEL_FOR_
-        for (int b = 0; b < batch; ++b) {
+        ParallelFor(0, batch, [&](int b) {
             // output shape: [batch, oc]
             auto dst_ptr_b = tmp_output_ptr + b * oc;
             memcpy(dst_ptr_b, buffer_bias_.force_to<float *>(), bias_size);
-        }
+        });
     } else {
         memset(tmp_output_ptr, 0, output_size);
     }
@@ -441,12 +440,11 @@ Status ArmInnerProductLayerAcc::ExecNchw<float>(const std::vector<Blob *> &input
     float *tmp_output_ptr = output_ptr;
 
     if (fc_param->has_bias) {
-        OMP_PARALLEL_FOR_
-        for (int b = 0; b < batch; ++b) {
+        ParallelFor(0, batch, [&](int b) {
             // output shape: [batch, oc]
             auto dst_ptr_b = tmp_output_ptr + b * oc;
             memcpy(dst_ptr_b, buffer_bias_.force_to<float *>(), bias_size);
-        }
+        });
     } else {
         memset(tmp_output_ptr, 0, output_size);
     }
@@ -19,13 +19,13 @@
 #include "tnn/device/arm/arm_common.h"
 #include "tnn/utils/data_type_utils.h"
 #include "tnn/utils/dims_vector_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 
 static void LstmActivate(const int count, const float *g_ptr, float *c_ptr, float *h_ptr, float *o_ptr) {
-    OMP_PARALLEL_FOR_
-    for (int q = 0; q < count - 3; q += 4) {
+    ParallelFor(0, UP_DIV(count - 3, 4), [&](int q_i) {
+        int q = q_i * 4;
         Float4x4 gates_iofc = Float4x4::ld4(g_ptr + q * 4);
         Float4 I, O, F, C;
         gates_iofc.get_lane(I, 0);
@@ -43,7 +43,7 @@ static void LstmActivate(const int count, const float *g_ptr, float *c_ptr, floa
         Float4::save(c_ptr + q, cell2);
         Float4::save(h_ptr + q, H);
         Float4::save(o_ptr + q, H);
-    }
+    });
     int remain = count % 4;
     int offset = count / 4 * 4;
     g_ptr += offset * 4;
@@ -19,7 +19,7 @@
 #include "tnn/device/arm/arm_common.h"
 #include "tnn/utils/data_type_utils.h"
 #include "tnn/utils/dims_vector_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 #if TNN_ARM82
 #include "tnn/device/arm/acc/compute_arm82/compute_half.h"
 #endif
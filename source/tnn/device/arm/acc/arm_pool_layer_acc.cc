@@ -16,7 +16,7 @@
 
 #include "tnn/device/arm/acc/arm_layer_acc.h"
 #include "tnn/utils/bfp16.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 
@@ -62,8 +62,7 @@ Status ArmPoolingLayerAcc::DoForward(const std::vector<Blob *> &inputs, const st
     if (input->GetBlobDesc().data_type == DATA_TYPE_FLOAT) {
         auto input_plane_stride  = 4 * k_param_->iw * k_param_->ih;
         auto output_plane_stride = 4 * k_param_->ow * k_param_->oh;
-        OMP_PARALLEL_FOR_
-        for (int plane = (int)0; plane < batch * oc_4; plane++) {
+        ParallelFor(0, batch * oc_4, [&](int plane) {
             if (param->pool_type == 0) {
                 MaxPooling(reinterpret_cast<float *>(input_ptr) + plane * input_plane_stride, k_param_->iw,
                            k_param_->ih, reinterpret_cast<float *>(output_ptr) + output_plane_stride * plane,
@@ -76,12 +75,11 @@ Status ArmPoolingLayerAcc::DoForward(const std::vector<Blob *> &inputs, const st
                            k_param_->ow, k_param_->oh, param->kernels[0], param->kernels[1], param->strides[0],
                            param->strides[1], param->pads[0], param->pads[2]);
             }
-        }
+        });
     } else if (input->GetBlobDesc().data_type == DATA_TYPE_BFP16) {
         auto input_plane_stride  = 4 * k_param_->iw * k_param_->ih;
         auto output_plane_stride = 4 * k_param_->ow * k_param_->oh;
-        OMP_PARALLEL_FOR_
-        for (int plane = (int)0; plane < batch * oc_4; plane++) {
+        ParallelFor(0, batch * oc_4, [&](int plane) {
             if (param->pool_type == 0) {
                 MaxPooling(reinterpret_cast<bfp16_t *>(input_ptr) + plane * input_plane_stride, k_param_->iw,
                            k_param_->ih, reinterpret_cast<bfp16_t *>(output_ptr) + output_plane_stride * plane,
@@ -94,15 +92,14 @@ Status ArmPoolingLayerAcc::DoForward(const std::vector<Blob *> &inputs, const st
                            k_param_->ow, k_param_->oh, param->kernels[0], param->kernels[1], param->strides[0],
                            param->strides[1], param->pads[0], param->pads[2]);
             }
-        }
+        });
     }
 #if TNN_ARM82
     else if (input->GetBlobDesc().data_type == DATA_TYPE_HALF) {
         auto oc_8       = UP_DIV(dims_output[1], 8);
         auto input_plane_stride  = 8 * k_param_->iw * k_param_->ih;
         auto output_plane_stride = 8 * k_param_->ow * k_param_->oh;
-        OMP_PARALLEL_FOR_
-        for (int plane = (int)0; plane < batch * oc_8; plane++) {
+        ParallelFor(0, batch * oc_8, [&](int plane) {
             if (param->pool_type == 0) {
                 MaxPoolingHalf(reinterpret_cast<fp16_t *>(input_ptr) + plane * input_plane_stride, k_param_->iw,
                                k_param_->ih, reinterpret_cast<fp16_t *>(output_ptr) + output_plane_stride * plane,
@@ -114,7 +111,7 @@ Status ArmPoolingLayerAcc::DoForward(const std::vector<Blob *> &inputs, const st
                                k_param_->ow, k_param_->oh, param->kernels[0], param->kernels[1], param->strides[0],
                                param->strides[1], param->pads[0], param->pads[2]);
             }
-        }
+        });
     }
 #endif
     else if (input->GetBlobDesc().data_type == DATA_TYPE_INT8) {
@@ -18,7 +18,7 @@
 #include "tnn/device/arm/arm_context.h"
 #include "tnn/utils/data_type_utils.h"
 #include "tnn/utils/dims_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 
@@ -37,8 +37,7 @@ void ArmReduceLayerAcc::ReduceChannel(float *input_data, float *output_data, Dim
     float reduce_c = dims_in[1];
     for (int n = 0; n < dims_in[0]; n++) {
         for (int c = 0; c < c4n; c++) {
-            OMP_PARALLEL_FOR_
-            for (int i = 0; i < hw_c; i++) {
+            ParallelFor(0, hw_c, [&](int i) {
                 int p      = i * 16;
                 Float4x4 v = Float4x4::ld4(input_data + p);
                 Float4 r, t;
@@ -63,7 +62,7 @@ void ArmReduceLayerAcc::ReduceChannel(float *input_data, float *output_data, Dim
                 *(output_data + p + 4)  = r[1];
                 *(output_data + p + 8)  = r[2];
                 *(output_data + p + 12) = r[3];
-            }
+            });
 
             for (int i = 0; i < hw_r; i++) {
                 int p = hw_c * 16 + i * 4;
@@ -114,12 +113,12 @@ Status ArmReduceLayerAcc::DoForward(const std::vector<Blob *> &inputs, const std
 
         if (op_->NeedPreCalculate()) {
             auto in_count = dims_in[0] * ROUND_UP(dims_in[1], 4) * DimsVectorUtils::Count(dims_in, 2);
-            OMP_PARALLEL_FOR_
-            for (int i = 0; i < in_count; i += 4) {
+            ParallelFor(0, UP_DIV(in_count, 4), [&](int i_i) {
+                int i = i_i * 4;
                 Float4 v = Float4::load(input_data + i);
                 Float4 r = op_->PreCalculate(v);
                 Float4::save(input_data + i, r);
-            }
+            });
         }
 
         auto input_data_a  = input_data;
@@ -195,8 +194,8 @@ void ArmReduceLayerAcc::ReduceOneAxis(float *input_data, float *output_data, Dim
         int inner_dim = c4u * hw;
         int count     = outer_dim * inner_dim;
 
-        OMP_PARALLEL_FOR_
-        for (int i = 0; i < inner_dim; i += 4) {
+        ParallelFor(0, UP_DIV(inner_dim, 4), [&](int i_i) {
+            int i = i_i * 4;
             Float4 r = op_->DataInit();
             for (int j = 0; j < count; j += inner_dim) {
                 Float4 v = Float4::load(input_data + j + i);
@@ -205,13 +204,12 @@ void ArmReduceLayerAcc::ReduceOneAxis(float *input_data, float *output_data, Dim
             if (post_cal)
                 r = op_->PostCalculate(r, axis_n);
             Float4::save(output_data + i, r);
-        }
+        });
     } else {
         int outer_dim  = dims_in[0] * c4n * DimsVectorUtils::Count(dims_in, 2, axis);
         int reduce_dim = dims_in[axis];
         int inner_dim  = DimsVectorUtils::Count(dims_in, axis + 1);
-        OMP_PARALLEL_FOR_
-        for (int o = 0; o < outer_dim; ++o) {
+        ParallelFor(0, outer_dim, [&](int o) {
             auto input_data_o  = input_data + o * reduce_dim * inner_dim * 4;
             auto output_data_o = output_data + o * inner_dim * 4;
             for (int i = 0; i < inner_dim; ++i) {
@@ -226,7 +224,7 @@ void ArmReduceLayerAcc::ReduceOneAxis(float *input_data, float *output_data, Dim
                     res = op_->PostCalculate(res, axis_n);
                 Float4::save(output_data_i, res);
             }
-        }
+        });
     }
 
     dims_in[axis] = 1;
@@ -18,7 +18,7 @@
 #include "tnn/utils/data_type_utils.h"
 #include "tnn/utils/dims_utils.h"
 #include "tnn/utils/naive_compute.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 
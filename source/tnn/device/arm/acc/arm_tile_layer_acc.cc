@@ -15,7 +15,7 @@
 #include "tnn/device/arm/acc/arm_layer_acc.h"
 #include "tnn/utils/data_type_utils.h"
 #include "tnn/utils/dims_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 
@@ -30,8 +30,7 @@ Status ArmTileLayerAcc::Exec(const std::vector<Blob *> &inputs, const std::vecto
     int count        = DimsVectorUtils::Count(output_dims);
     T *input_data    = reinterpret_cast<T *>(GetBlobHandlePtr(input_blob->GetHandle()));
     T *output_data   = reinterpret_cast<T *>(GetBlobHandlePtr(output_blob->GetHandle()));
-    OMP_PARALLEL_FOR_
-    for (int index = 0; index < count; ++index) {
+    ParallelFor(0, count, [&](int index) {
         int offset = 0;
         int prod   = count;
         for (int i = 0; i < input_dims.size(); i++) {
@@ -40,7 +39,7 @@ Status ArmTileLayerAcc::Exec(const std::vector<Blob *> &inputs, const std::vecto
             offset  = offset * input_dims[i] + mod;
         }
         output_data[index] = input_data[offset];
-    }
+    });
 
     return TNN_OK;
 }
@@ -18,7 +18,7 @@
 #include "tnn/device/arm/arm_context.h"
 #include "tnn/utils/dims_vector_utils.h"
 #include "tnn/utils/dims_function_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 
@@ -54,15 +54,13 @@ Status ArmUnaryLayerAcc::Exec(const std::vector<Blob *> &inputs, const std::vect
     auto output_ptr = reinterpret_cast<T *>(GetBlobHandlePtr(output->GetHandle()));
 
     if (context_->GetPrecision() == PRECISION_HIGH) {
-        OMP_PARALLEL_FOR_
-        for (int n = 0; n < count_quad; n++) {
+        ParallelFor(0, count_quad, [&](int n) {
             Float4::save(output_ptr + n * 4, (*op_)(Float4::load(input_ptr + n * 4)));
-        }
+        });
     } else {
-        OMP_PARALLEL_FOR_
-        for (int n = 0; n < count_quad; n++) {
+        ParallelFor(0, count_quad, [&](int n) {
             Float4::save(output_ptr + n * 4, op_->fast_op(Float4::load(input_ptr + n * 4)));
-        }
+        });
     }
 
     return TNN_OK;
@@ -19,7 +19,7 @@
 #include "tnn/utils/data_type_utils.h"
 #include "tnn/utils/dims_utils.h"
 #include "tnn/utils/naive_compute.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 
@@ -43,8 +43,7 @@ static inline int upsample_nearest2d(float *output_data, const float *input_data
     const float height_scale = (float)ih / (float)oh;
     const float width_scale  = (float)iw / (float)ow;
 
-    OMP_PARALLEL_FOR_
-    for (int z = 0; z < c_4; z++) {
+    ParallelFor(0, c_4, [&](int z) {
         auto dst_z = output_data + z * dst_z_step;
         auto src_z = input_data + z * src_z_step;
         for (int h = 0; h < oh; h++) {
@@ -56,7 +55,7 @@ static inline int upsample_nearest2d(float *output_data, const float *input_data
                 Float4::save(dst_y + w * 4, Float4::load(src_y + scale_w * 4));
             }
         }
-    }
+    });
 
     return 0;
 }
@@ -71,8 +70,7 @@ static int upsample_nearest2d(int8_t *output_data, const int8_t *input_data, int
     const float height_scale = (float)ih / (float)oh;
     const float width_scale  = (float)iw / (float)ow;
 
-    OMP_PARALLEL_FOR_
-    for (int h = 0; h < oh; h++) {
+    ParallelFor(0, oh, [&](int h) {
         int scale_h = h * height_scale;
         auto dst_y  = output_data + h * dst_y_step;
         auto src_y  = input_data + scale_h * src_y_step;
@@ -122,7 +120,7 @@ static int upsample_nearest2d(int8_t *output_data, const int8_t *input_data, int
 #endif
             }
         }
-    }
+    });
 
     return 0;
 }
@@ -171,8 +169,7 @@ static inline int upsample_bilinear2d(float *output_data, const float *input_dat
         auto input_b  = input_data + b * src_plane;
         auto output_b = output_data + b * dst_plane;
 
-        OMP_PARALLEL_FOR_
-        for (int h2 = 0; h2 < oh; ++h2) {
+        ParallelFor(0, oh, [&](int h2) {
             const float h1r      = h_coeffs_ptr[h2];
             const int h1         = h1r;
             const int h1p        = (h1 < ih - 1) ? 1 : 0;
@@ -197,7 +194,7 @@ static inline int upsample_bilinear2d(float *output_data, const float *input_dat
                     Ydata += dst_z_step;
                 }
             }
-        }
+        });
     }
 
     return 0;
@@ -320,21 +317,21 @@ static inline int upsample_cubic2d(float *output_data, const float *input_data,
     Float4::save(param.rows##dst##_t[thread_id] + buf_offset, row_##dst);
 
     // loop body
-    int max_num_threads = OMP_MAX_THREADS_NUM_;
+    int max_num_threads = GetParallelMaxThreads();
     int buf_count       = ow * 4 * max_num_threads;
     RawBuffer workspace(4 * buf_count * sizeof(float));
     float *rows0 = workspace.force_to<float *>();
     float *rows1 = rows0 + buf_count;
     float *rows2 = rows1 + buf_count;
     float *rows3 = rows2 + buf_count;
-    float *rows0_t[max_num_threads];
-    float *rows1_t[max_num_threads];
-    float *rows2_t[max_num_threads];
-    float *rows3_t[max_num_threads];
-    int prev_h1[max_num_threads];
+    std::vector<float *> rows0_t(max_num_threads);
+    std::vector<float *> rows1_t(max_num_threads);
+    std::vector<float *> rows2_t(max_num_threads);
+    std::vector<float *> rows3_t(max_num_threads);
+    std::vector<int> prev_h1(max_num_threads);
 
-    UpsampleCubicKernelParm param(rows0_t, rows1_t, rows2_t, rows3_t, prev_h1, h_pos_ptr, w_pos_ptr, h_pos4_ptr,
-                                  w_pos4_ptr);
+    UpsampleCubicKernelParm param(rows0_t.data(), rows1_t.data(), rows2_t.data(), rows3_t.data(), prev_h1.data(),
+                                  h_pos_ptr, w_pos_ptr, h_pos4_ptr, w_pos4_ptr);
 
     for (int b = 0; b < batch; ++b) {
         auto input_b  = input_data + b * src_plane;
@@ -352,9 +349,7 @@ static inline int upsample_cubic2d(float *output_data, const float *input_data,
                 rows3_t[t] = rows3 + t * (ow * 4);
             }
 
-            OMP_PARALLEL_FOR_
-            for (int h2 = 0; h2 < oh; ++h2) {
-                int thread_id  = OMP_TID_;
+            ParallelForWithThreadId(0, oh, [&](int h2, int thread_id) {
                 const int h1   = param.h_pos_ptr[h2];
                 const int *hp  = param.h_pos4_ptr + 4 * h2;
                 int buf_offset = 0;
@@ -424,7 +419,7 @@ static inline int upsample_cubic2d(float *output_data, const float *input_data,
                     buf_offset += 4;
                     Ydata += dst_z_step;
                 }
-            }
+            });
         }
     }
 
@@ -666,12 +661,12 @@ static int upsample_bilinear_c4(int8_t *dst, const int8_t *src, int batch, int s
     UpsampleBilinearKernelParm param(xofs, yofs, ialpha, ibeta, src, dst, src_plane, src_stride);
 
     // loop body
-    int max_num_threads = OMP_MAX_THREADS_NUM_;
+    int max_num_threads = GetParallelMaxThreads();
     short *rows0        = new short[(w * 4) * max_num_threads];
     short *rows1        = new short[(w * 4) * max_num_threads];
-    short *rows0_t[max_num_threads];
-    short *rows1_t[max_num_threads];
-    int prev_sy[max_num_threads];
+    std::vector<short *> rows0_t(max_num_threads);
+    std::vector<short *> rows1_t(max_num_threads);
+    std::vector<int> prev_sy(max_num_threads);
 
     for (int b = 0; b < batch; ++b) {
         for (int t = 0; t < max_num_threads; ++t) {
@@ -680,11 +675,10 @@ static int upsample_bilinear_c4(int8_t *dst, const int8_t *src, int batch, int s
             rows1_t[t] = rows1 + t * (w * 4);
         }
 
-        OMP_PARALLEL_FOR_
-        for (int dy = 0; dy < h; dy++) {
-            int thread_id = OMP_TID_;
-            upsample_bilinear_one_row(param, thread_id, rows0_t, rows1_t, prev_sy, b, w, h, stride, dy);
-        }
+        ParallelForWithThreadId(0, h, [&](int dy, int thread_id) {
+            upsample_bilinear_one_row(param, thread_id, rows0_t.data(), rows1_t.data(), prev_sy.data(), b, w, h, stride,
+                                      dy);
+        });
     }
 
     delete[] rows0;
@@ -703,8 +697,7 @@ static void upsample_bilinear_cn(int8_t *output_data, const int8_t *input_data,
 
     const float INTER_RESIZE_COEF_SCALE = float(1 << 11);
 
-    OMP_PARALLEL_FOR_
-    for (int h2 = 0; h2 < oh; ++h2) {
+    ParallelFor(0, oh, [&](int h2) {
         const float h1r      = h_coeffs_ptr[h2];
         const int h1         = h1r;
         const int h1p        = (h1 < ih - 1) ? 1 : 0;
@@ -854,7 +847,7 @@ static void upsample_bilinear_cn(int8_t *output_data, const int8_t *input_data,
             }
 #endif
         }
-    }
+    });
 }
 
 template <bool do_scale>
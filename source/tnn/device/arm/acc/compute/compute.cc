@@ -23,7 +23,7 @@
 #include "tnn/device/arm/arm_util.h"
 #include "tnn/utils/bfp16.h"
 #include "tnn/utils/naive_compute.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 using namespace arm;
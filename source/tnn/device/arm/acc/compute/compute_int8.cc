@@ -21,7 +21,7 @@
 #include "tnn/device/arm/arm_util.h"
 #include "tnn/utils/bfp16.h"
 #include "tnn/utils/naive_compute.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 
@@ -106,12 +106,12 @@ static void ComputeQ8GemmTile(const Q8GemmContext* context, long mr_block_start,
 }
 
 void ComputeQ8Gemm(const Q8GemmContext* context, int32_t range_k, int32_t range_l, int32_t tile_k, int32_t tile_l) {
-    OMP_PARALLEL_FOR_GUIDED_
-    for (int32_t k = 0; k < range_k; k += tile_k) {
+    ParallelFor(0, UP_DIV(range_k, tile_k), [&](int k_i) {
+        int32_t k = k_i * tile_k;
         for (int32_t l = 0; l < range_l; l += tile_l) {
             ComputeQ8GemmTile(context, k, l, std::min(range_k - k, tile_k), std::min(range_l - l, tile_l));
         }
-    }
+    });
 }
 
 #ifndef TNN_USE_NEON
@@ -209,15 +209,15 @@ void FloatToInt8C4(int8_t* dst, const float* src, const float* scale, long batch
         int8_t* dst_c      = dst + n * c_4 * hw;
         const float* src_c = src + n * c_4 * hw;
         long idx           = hw - hw % 2;
-        OMP_PARALLEL_FOR_GUIDED_
-        for (long cnt = 0; cnt < idx; cnt += 2) {
+        ParallelFor(0, UP_DIV(idx, 2), [&](int cnt_i) {
+            long cnt = cnt_i * 2;
             // nhwc4 to nchw4
             float32x4_t val0 = vmulq_f32(vld1q_f32(src_c + cnt * c_4), scale_neon);
             float32x4_t val1 = vmulq_f32(vld1q_f32(src_c + cnt * c_4 + 4), scale_neon);
             int16x4_t s16_0  = vqmovn_s32(VCVTAQ_S32_F32(val0));
             int16x8_t s16    = VQMOVN_HIGH_S32_T(s16_0, VCVTAQ_S32_F32(val1));
             vst1_s8(dst_c + cnt * c_4, vqmovn_s16(s16));
-        }
+        });
         if (idx == hw - 1) {
             float32x4_t val0 = vmulq_f32(vld1q_f32(src_c + idx * c_4), scale_neon);
             int16x4_t s16_0  = vqmovn_s32(VCVTAQ_S32_F32(val0));
@@ -251,8 +251,7 @@ general max pooling int8 kernel
 */
 void MaxPoolingINT8(const int8_t* src, long iw, long ih, int8_t* dst, long ow, long oh, long c_r4, long kw, long kh,
                     long stride_w, long stride_h, long pad_w, long pad_h) {
-    OMP_PARALLEL_FOR_GUIDED_
-    for (long oy = 0; oy < oh; ++oy) {
+    ParallelFor(0, oh, [&](int oy) {
         for (long ox = 0; ox < ow; ++ox) {
             const long srcOriginX = ox * stride_w - pad_w;
             const long srcOriginY = oy * stride_h - pad_h;
@@ -297,7 +296,7 @@ void MaxPoolingINT8(const int8_t* src, long iw, long ih, int8_t* dst, long ow, l
                 *(int32_t*)dst_ptr = *(int32_t*)maxValue;
             }
         }
-    }
+    });
 }
 
 /*
@@ -367,8 +366,7 @@ element add int8 func
 */
 void MatrixAddInt8(int8_t* dst, const int8_t* A, const int8_t* B, float* dst_scale, const float* a_scale,
                    float* b_scale, long channel, long HW) {
-    OMP_PARALLEL_FOR_GUIDED_
-    for (long hw = 0; hw < HW; hw++) {
+    ParallelFor(0, HW, [&](int hw) {
         long c = 0;
 
 #ifdef TNN_USE_NEON
@@ -401,7 +399,7 @@ void MatrixAddInt8(int8_t* dst, const int8_t* A, const int8_t* B, float* dst_sca
             float aval  = A[offset] * a_scale[c] + B[offset] * b_scale[c];
             dst[offset] = float2int8(aval * dst_scale[c]);
         }
-    }
+    });
 }
 void Int8ToFloat(float* dst, const int8_t* src, const float* scale, long batch, long channel, long hw) {
     long c_4 = ROUND_UP(channel, 4);
@@ -531,8 +529,8 @@ gemm int8 func, used in conv int8 common(img2col + gemm)
 void GemvInt8(int8_t* dst, const int8_t* src, const int8_t* weight, const int32_t* bias, const float* scale, long ic_r4,
               long oc_r4) {
 #ifdef TNN_USE_NEON
-    OMP_PARALLEL_FOR_
-    for (long dc = 0; dc < oc_r4; dc += 4) {
+    ParallelFor(0, UP_DIV(oc_r4, 4), [&](int dc_i) {
+        long dc = dc_i * 4;
         int32x4_t acc0 = vdupq_n_s32(0);
         int32x4_t acc1 = vdupq_n_s32(0);
         int32x4_t acc2 = vdupq_n_s32(0);
@@ -613,7 +611,7 @@ void GemvInt8(int8_t* dst, const int8_t* src, const int8_t* weight, const int32_
         int32x4_t bias0       = vld1q_s32(bias + dc);
         float32x4_t scale0    = vld1q_f32(scale + dc);
         *(int32_t*)(dst + dc) = Float4ScaleTos8(vcvtq_f32_s32(vaddq_s32(acc, bias0)), scale0);
-    }
+    });
 #else
     for (long dc = 0; dc < oc_r4; dc++) {
         int32_t acc = bias[dc];
@@ -980,11 +978,11 @@ void ReluInt8(int8_t* dst, const int8_t* src, long len) {
 #ifdef TNN_USE_NEON
     int8x8_t zero = vdup_n_s8(0);
     idx           = len - len % 8;
-    OMP_PARALLEL_FOR_GUIDED_
-    for (long i = 0; i < idx; i += 8) {
+    ParallelFor(0, UP_DIV(idx, 8), [&](int i_i) {
+        long i = i_i * 8;
         int8x8_t val = vld1_s8(src + i);
         vst1_s8(dst + i, vmax_s8(val, zero));
-    }
+    });
 #endif
     for (; idx < len; idx++) {
         dst[idx] = MAX(0, src[idx]);
@@ -998,8 +996,7 @@ void Relu6Int8(int8_t* dst, const int8_t* src, const int8_t* relu6_max, long wid
     int8x8_t vzero = vdup_n_s8(0);
 #endif
 
-    OMP_PARALLEL_FOR_GUIDED_
-    for (long dx = 0; dx < width; dx++) {
+    ParallelFor(0, width, [&](int dx) {
         auto src_dx = src + dx * dst_depth;
         auto dst_dx = dst + dx * dst_depth;
 
@@ -1015,7 +1012,7 @@ void Relu6Int8(int8_t* dst, const int8_t* src, const int8_t* relu6_max, long wid
             int8_t tmp = MIN(src_dx[dc], relu6_max[dc]);
             dst_dx[dc] = MAX(0, tmp);
         }
-    }
+    });
 }
 
 }  // namespace TNN_NS
@@ -22,7 +22,7 @@
 #include "tnn/device/arm/arm_common.h"
 #include "tnn/device/arm/arm_context.h"
 #include "tnn/utils/bfp16.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 
@@ -196,9 +196,7 @@ void sgemm_repack_lhs(T *dst, T *src, float *weight, int ic4, int oc4, int plane
     int workspace_per_thread = a_block * ic4 * 4;
     int do_relu              = act_type == 1 || act_type == 2;
 
-    OMP_PARALLEL_FOR_
-    for (int db = 0; db <= loop; db++) {
-        int thread_id = OMP_TID_;
+    ParallelForWithThreadId(0, loop + 1, [&](int db, int thread_id) {
         auto dst_b    = work_space + thread_id * workspace_per_thread;
         auto src_b    = src + db * a_block * 4;
         auto width    = (db < loop) ? a_block : remain;
@@ -223,7 +221,7 @@ void sgemm_repack_lhs(T *dst, T *src, float *weight, int ic4, int oc4, int plane
                           ic4, dst_z_step, calc_b_block / 4, x_width, bias + c_o * b_block, do_relu);
             }
         }
-    }
+    });
 
     // only bias + relu6 here, bias and bias + relu has been fused to gemm kernel
     if (act_type == 2)
@@ -261,8 +259,7 @@ void sgemm_repack_rhs(T *dst, T *src, float *weight, int ic4, int oc4, int plane
 
         auto weight_z_step = ic4 * b_block * 4;
 
-        OMP_PARALLEL_FOR_
-        for (int c_o = 0; c_o < UP_DIV(oc4 * 4, b_block); c_o++) {
+        ParallelFor(0, UP_DIV(oc4 * 4, b_block), [&](int c_o) {
             /*
             a_block is much greater in sgemm_rhs than that in sgemm_lhs
             same process with sgemm_lhs, but we load data repeatedly
@@ -275,7 +272,7 @@ void sgemm_repack_rhs(T *dst, T *src, float *weight, int ic4, int oc4, int plane
                 GEMM_FUNC(output_ptr + x_i * ARM_SGEMM_TILE_M * 4, dst_b + x_i * ARM_SGEMM_TILE_M * ic4 * 4, weight_ptr,
                           ic4, dst_z_step, calc_b_block / 4, x_width, bias + c_o * b_block, do_relu);
             }
-        }
+        });
     }
 
     // only bias + relu6 here, bias and bias + relu has been fused to gemm kernel
@@ -347,8 +344,8 @@ void Kernel_12x8(int m, int n, int k, const float *sa, const float *sb, float *s
         const float *ar = sa + i * k;
         const float *br = sb;
         float *cr       = sc + i * ldc;
-        OMP_PARALLEL_FOR_
-        for (int j = 0; j < n - 7; j += 8) {
+        ParallelFor(0, UP_DIV(n - 7, 8), [&](int j_i) {
+            int j = j_i * 8;
             const float *a     = ar;
             const float *b     = br + j * k;
             float *c           = cr + j;
@@ -467,7 +464,7 @@ void Kernel_12x8(int m, int n, int k, const float *sa, const float *sb, float *s
                 : "memory", "cc", "x8", "x9", "v0", "v1", "v2", "v3", "v4", "v8", "v9", "v10", "v11", "v12", "v13",
                   "v14", "v15", "v16", "v17", "v18", "v19", "v20", "v21", "v22", "v23", "v24", "v25", "v26", "v27",
                   "v28", "v29", "v30", "v31");
-        }
+        });
         int remain = n % 8;
         if (remain) {
             const float *a     = ar;
@@ -543,8 +540,8 @@ void Kernel_4x8(int m, int n, int k, const float *sa, const float *sb, float *sc
         const float *ar = sa + i * k;
         const float *br = sb;
         float *cr       = sc + i * ldc;
-        OMP_PARALLEL_FOR_
-        for (int j = 0; j < n - 7; j += 8) {
+        ParallelFor(0, UP_DIV(n - 7, 8), [&](int j_i) {
+            int j = j_i * 8;
             const float *a = ar;
             const float *b = br + j * k;
             float *c       = cr + j;
@@ -659,7 +656,7 @@ void Kernel_4x8(int m, int n, int k, const float *sa, const float *sb, float *sc
                 : "0"(b), "1"(a), "2"(c), "3"(ldc_offset), "4"(k)
                 : "memory", "cc", "r8", "r9", "q0", "q1", "q2", "q8", "q9", "q10", "q11", "q12", "q13", "q14", "q15");
 #endif  // __aarch64__
-        }
+        });
         int remain = n % 8;
         if (remain) {
             const float *a    = ar;
@@ -708,8 +705,8 @@ void Kernel_1x8(int m, int n, int k, const float *sa, const float *sb, float *sc
         const float *ar = sa + i * k;
         const float *br = sb;
         float *cr       = sc + i * ldc;
-        OMP_PARALLEL_FOR_
-        for (int j = 0; j < n - 7; j += 8) {
+        ParallelFor(0, UP_DIV(n - 7, 8), [&](int j_i) {
+            int j = j_i * 8;
             const float *a = ar;
             const float *b = br + j * k;
             float *c       = cr + j;
@@ -838,7 +835,7 @@ void Kernel_1x8(int m, int n, int k, const float *sa, const float *sb, float *sc
                 : "0"(b), "1"(a), "2"(c), "3"(ldc_offset), "4"(k)
                 : "memory", "cc", "r8", "r9", "q0", "q1", "q2", "q3", "q4", "q8", "q9", "q10", "q11");
 #endif  // __aarch64__
-        }
+        });
         int remain = n % 8;
         if (remain) {
             const float *a = ar;
@@ -996,8 +993,7 @@ void PackA_12(int m, int k, const float *src, int lda, float *dst) {
         src_offset[11] = src_offset[10] + lda;
         src += 12 * lda;
 
-        OMP_PARALLEL_FOR_
-        for (int i = 0; i < k; ++i) {
+        ParallelFor(0, k, [&](int i) {
             float *dst_t  = dst_r + i * 12;
             *(dst_t + 0)  = *(src_offset[0] + i);
             *(dst_t + 1)  = *(src_offset[1] + i);
@@ -1011,7 +1007,7 @@ void PackA_12(int m, int k, const float *src, int lda, float *dst) {
             *(dst_t + 9)  = *(src_offset[9] + i);
             *(dst_t + 10) = *(src_offset[10] + i);
             *(dst_t + 11) = *(src_offset[11] + i);
-        }
+        });
     }
 }
 
@@ -1025,22 +1021,20 @@ void PackA_4(int m, int k, const float *src, int lda, float *dst) {
         src_offset[3] = src_offset[2] + lda;
         src += 4 * lda;
 
-        OMP_PARALLEL_FOR_
-        for (int i = 0; i < k; ++i) {
+        ParallelFor(0, k, [&](int i) {
             float *dst_t = dst_r + i * 4;
             *(dst_t + 0) = *(src_offset[0] + i);
             *(dst_t + 1) = *(src_offset[1] + i);
             *(dst_t + 2) = *(src_offset[2] + i);
             *(dst_t + 3) = *(src_offset[3] + i);
-        }
+        });
     }
 }
 
 void PackA_1(int m, int k, const float *src, int lda, float *dst) {
-    OMP_PARALLEL_FOR_
-    for (int j = 0; j < m; ++j) {
+    ParallelFor(0, m, [&](int j) {
         memcpy(dst + j * k, src + j * lda, k * sizeof(float));
-    }
+    });
 }
 
 }  // namespace TNN_NS
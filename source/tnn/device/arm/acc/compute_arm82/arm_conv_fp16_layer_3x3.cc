@@ -24,7 +24,7 @@
 #include "tnn/utils/data_format_converter.h"
 #include "tnn/utils/data_type_utils.h"
 #include "tnn/utils/dims_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 #include "tnn/device/arm/acc/Half8.h"
 
 #ifdef TNN_ARM82_A64
@@ -420,7 +420,7 @@ Status ArmConvFp16Layer3x3::Exec(const std::vector<Blob *> &inputs, const std::v
     const fp16_t *src_origin = reinterpret_cast<const fp16_t *>(GetBlobHandlePtr(input->GetHandle()));
     fp16_t *dst_origin = reinterpret_cast<fp16_t *>(GetBlobHandlePtr(output->GetHandle()));
 
-    int max_num_threads           = OMP_MAX_THREADS_NUM_;
+    int max_num_threads           = GetParallelMaxThreads();
     size_t fake_bias_size         = k_param_->oc_r8 * data_byte_size;
 
     size_t src_pad_buf_per_thread = src_unit * src_unit * 8;
@@ -496,9 +496,8 @@ Status ArmConvFp16Layer3x3::Exec(const std::vector<Blob *> &inputs, const std::v
                 tiles_info[x_i].dst_loc = (dst_x + dst_y * k_param_->ow) * 8;
             }
 
-            OMP_PARALLEL_FOR_
-            for (int z = 0; z <= k_param_->ic_r8 - 8; z += 8) {
-                int tid         = OMP_TID_;
+            ParallelForWithThreadId(0, UP_DIV(k_param_->ic_r8 - 7, 8), [&](int z_i, int tid) {
+                int z = z_i * 8;
                 auto mid_buffer = src_pad_buffer + tid * src_pad_buf_per_thread;
                 auto src_z      = input_ptr + z * src_z_step;
                 auto dst_z      = src_trans_buf + tid * src_trans_tmp_per_thread;
@@ -546,23 +545,21 @@ Status ArmConvFp16Layer3x3::Exec(const std::vector<Blob *> &inputs, const std::v
                 } else if (src_unit == 6) {
                     load_repack_half<36>(repack_buf, dst_z, x_c, z, ic, k_param_->ic_r8);
                 }
-            }
+            });
 
             // gemm multi (n8 for armv8, n4 for armv7)
-            OMP_PARALLEL_FOR_
-            for (int i = 0; i < src_unit * src_unit; i++) {
+            ParallelFor(0, src_unit * src_unit, [&](int i) {
                 GEMM_FP16_N8(dst_trans_buf + i * 8 * NEON_GEMM_TILE_HW,
                              repack_buf + i * k_param_->ic_r8 * NEON_GEMM_TILE_HW,
                              reinterpret_cast<fp16_t *>(k_param_->fil_ptr) + i * k_param_->ic_r8 * k_param_->oc_r8,
                              k_param_->ic_r8, NEON_GEMM_TILE_HW * src_unit * src_unit * 8, k_param_->oc_r8, x_c, fake_bias, 0);
-            }
+            });
 
             src_z_step = NEON_GEMM_TILE_HW * src_unit * src_unit;
             dst_z_step = k_param_->ow * k_param_->oh;
 
-            OMP_PARALLEL_FOR_
-            for (int z = 0; z <= k_param_->oc_r8 - 8; z += 8) {
-                int tid         = OMP_TID_;
+            ParallelForWithThreadId(0, UP_DIV(k_param_->oc_r8 - 7, 8), [&](int z_i, int tid) {
+                int z = z_i * 8;
                 auto mid_buffer = src_pad_buffer + tid * src_pad_buf_per_thread;
                 auto src_z      = dst_trans_buf + z * src_z_step;
                 auto dst_z      = output_ptr + z * dst_z_step;
@@ -597,7 +594,7 @@ Status ArmConvFp16Layer3x3::Exec(const std::vector<Blob *> &inputs, const std::v
                     }
                     // dst transform end
                 }
-            }
+            });
         }
     }
 
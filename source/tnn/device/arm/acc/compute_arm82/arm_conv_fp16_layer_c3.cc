@@ -17,7 +17,7 @@
 #include "tnn/device/arm/arm_context.h"
 #include "tnn/utils/data_format_converter.h"
 #include "tnn/utils/data_type_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 #include "tnn/device/arm/acc/Half8.h"
 
 namespace TNN_NS {
@@ -93,7 +93,7 @@ Status ArmConvFp16LayerC3::DoForward(const std::vector<Blob *> &inputs, const st
     const fp16_t *src_origin = reinterpret_cast<const fp16_t *>(GetBlobHandlePtr(input->GetHandle()));
     fp16_t *dst_origin       = reinterpret_cast<fp16_t *>(GetBlobHandlePtr(output->GetHandle()));
 
-    int max_num_threads = OMP_MAX_THREADS_NUM_;
+    int max_num_threads = GetParallelMaxThreads();
 
     int src_xc = 1 + (k_param_->ow - 1) * conv_param->strides[0] + conv_param->dialations[0] * (kernel_x - 1);
     int workspace_per_thread = src_xc * kernel_y * k_param_->ic_r8 * data_byte_size;
@@ -113,9 +113,7 @@ Status ArmConvFp16LayerC3::DoForward(const std::vector<Blob *> &inputs, const st
         int copy_count = src_end_x - src_start_x;
         auto src_x     = input_ptr + 8 * src_start_x;
 
-        OMP_PARALLEL_FOR_
-        for (int dy = 0; dy < k_param_->oh; dy++) {
-            int thread_id = OMP_TID_;
+        ParallelForWithThreadId(0, k_param_->oh, [&](int dy, int thread_id) {
 
             auto work_space_t = work_space + thread_id * workspace_per_thread / data_byte_size;
             memset(work_space_t, 0, workspace_per_thread);
@@ -136,7 +134,7 @@ Status ArmConvFp16LayerC3::DoForward(const std::vector<Blob *> &inputs, const st
                 GemmFp16SlidewC3(dst_z, work_space_t, weight_dz, k_param_->ow, 
                                  conv_param->strides[0] * 8, kernel_x, kernel_y, dilate_x_step, src_xc * 8);
             }
-        }
+        });
     }
 
     PostExec<fp16_t>(outputs);
@@ -19,7 +19,7 @@
 #include "tnn/device/arm/arm_context.h"
 #include "tnn/utils/data_format_converter.h"
 #include "tnn/utils/data_type_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 #include "tnn/device/arm/acc/Half8.h"
 
 #ifdef TNN_ARM82_A64 // aarch64 fp16
@@ -583,15 +583,14 @@ void ArmConvFp16LayerCommon::PostExec<fp16_t>(const std::vector<Blob *> &outputs
     const int batch = outputs[0]->GetBlobDesc().dims[0];
     auto dst_origin = reinterpret_cast<fp16_t *>(GetBlobHandlePtr(outputs[0]->GetHandle()));
     if (post_func_) {
-        OMP_PARALLEL_FOR_
-        for (int batch_idx = 0; batch_idx < batch; ++batch_idx) {
+        ParallelFor(0, batch, [&](int batch_idx) {
             auto output_ptr = dst_origin + batch_idx * k_param_->ow * k_param_->oh * k_param_->oc_r8;
             for (int dz = 0; dz < k_param_->oc_r8; dz += 8) {
                 auto dst_z    = output_ptr + dz * k_param_->ow * k_param_->oh;
                 fp16_t *bias_z = reinterpret_cast<fp16_t *>(k_param_->bias) + dz;
                 post_func_(dst_z, bias_z, k_param_->ow * k_param_->oh, 1);
             }
-        }
+        });
     }
 }
 
@@ -599,14 +598,13 @@ void ArmConvFp16LayerCommon::PostExecNoBias(const std::vector<Blob *> &outputs)
     const int batch = outputs[0]->GetBlobDesc().dims[0];
     auto dst_origin = reinterpret_cast<fp16_t *>(GetBlobHandlePtr(outputs[0]->GetHandle()));
     if (post_func_) {
-        OMP_PARALLEL_FOR_
-        for (int batch_idx = 0; batch_idx < batch; ++batch_idx) {
+        ParallelFor(0, batch, [&](int batch_idx) {
             auto output_ptr = dst_origin + batch_idx * k_param_->ow * k_param_->oh * k_param_->oc_r8;
             for (int dz = 0; dz < k_param_->oc_r8; dz += 8) {
                 auto dst_z    = output_ptr + dz * k_param_->ow * k_param_->oh;
                 post_func_(dst_z, nullptr, k_param_->ow * k_param_->oh, 1);
             }
-        }
+        });
     }
 }
 
@@ -628,7 +626,7 @@ Status ArmConvFp16LayerCommon::DoForward(const std::vector<Blob *> &inputs, cons
     const int crs_r8 = k_param_->ic_r8 * conv_param->kernels[1] * conv_param->kernels[0];
     const int tile_count = UP_DIV(k_param_->oh * k_param_->ow, tile_blk_size);
 
-    int max_num_threads = OMP_MAX_THREADS_NUM_;
+    int max_num_threads = GetParallelMaxThreads();
     size_t img2col_size = tile_blk_size * crs_r8;
     size_t repack_size = NEON_FP16CONV_TILE_HW * crs_r8;
     size_t workspace_size_per_thread = img2col_size + repack_size + NEON_KERNEL_EXTRA_LOAD;
@@ -644,9 +642,7 @@ Status ArmConvFp16LayerCommon::DoForward(const std::vector<Blob *> &inputs, cons
         const auto input_batch = input_data + n * k_param_->iw * k_param_->ih * k_param_->ic_r8;
         auto output_batch      = output_data + n * k_param_->ow * k_param_->oh * k_param_->oc_r8;
 
-        OMP_PARALLEL_FOR_DYNAMIC_
-        for (int t_idx = 0; t_idx < tile_count; t_idx++) {
-            int thread_id          = OMP_TID_;
+        ParallelForWithThreadId(0, tile_count, [&](int t_idx, int thread_id) {
             auto workspace_per_thread = work_space + thread_id * workspace_size_per_thread;
             const int hw_start     = t_idx * tile_blk_size;
             const int real_hw_tile = MIN(k_param_->oh * k_param_->ow - hw_start, tile_blk_size);
@@ -680,7 +676,7 @@ Status ArmConvFp16LayerCommon::DoForward(const std::vector<Blob *> &inputs, cons
             GEMM_FP16_N8(output_kernel, repack_dst, reinterpret_cast<fp16_t *>(k_param_->fil_ptr),
                         crs, 8 * k_param_->ow * k_param_->oh, k_param_->oc_r8, real_hw_tile, 
                         reinterpret_cast<fp16_t *>(k_param_->bias), act_type);
-        }
+        });
     }
 
     if (conv_param->activation_type == ActivationType_SIGMOID_MUL) {
@@ -19,7 +19,7 @@
 #include "tnn/interpreter/raw_buffer.h"
 #include "tnn/utils/data_format_converter.h"
 #include "tnn/utils/data_type_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 #include "tnn/device/arm/acc/Half8.h"
 
 namespace TNN_NS {
@@ -138,8 +138,8 @@ Status ArmConvFp16LayerDepthwise::DoForward(const std::vector<Blob *> &inputs, c
         auto src_ptr = src_origin + batch_idx * k_param_->iw * k_param_->ih * k_param_->ic_r8;
         auto dst_ptr = dst_origin + batch_idx * k_param_->ow * k_param_->oh * k_param_->oc_r8;
 
-        OMP_PARALLEL_FOR_
-        for (int dz = 0; dz < k_param_->oc_r8; dz += 8) {
+        ParallelFor(0, UP_DIV(k_param_->oc_r8, 8), [&](int dz_i) {
+            int dz = dz_i * 8;
             auto *dst_z     = dst_ptr + dst_z_step * dz;
             auto *src_z     = src_ptr + src_z_step * dz;
             auto *weight_dz = reinterpret_cast<fp16_t *>(k_param_->fil_ptr) + dz * weight_z_step;
@@ -157,7 +157,7 @@ Status ArmConvFp16LayerDepthwise::DoForward(const std::vector<Blob *> &inputs, c
                               weight_dz, r - l, param->strides[0] * 8, param->kernels[0], param->kernels[1], dilate_x_step,
                               dilate_y_step, b - t, k_param_->iw * 8 * param->strides[1], k_param_->ow * 8);
             }
-        }
+        });
     }
     PostExec<fp16_t>(outputs);
 
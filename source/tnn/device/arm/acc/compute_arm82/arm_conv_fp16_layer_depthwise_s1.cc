@@ -18,7 +18,7 @@
 #include "tnn/utils/data_format_converter.h"
 #include "tnn/utils/data_type_utils.h"
 
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 #include "tnn/device/arm/acc/Half8.h"
 
 #define MAX_CACHE_LINE_NUM 7
@@ -95,7 +95,7 @@ Status ArmConvFp16LayerDepthwiseS1::DoForward(const std::vector<Blob *> &inputs,
 
     const fp16_t *src_origin = reinterpret_cast<const fp16_t *>(GetBlobHandlePtr(input->GetHandle()));
     fp16_t *dst_origin       = reinterpret_cast<fp16_t *>(GetBlobHandlePtr(output->GetHandle()));
-    int max_num_threads      = OMP_MAX_THREADS_NUM_;
+    int max_num_threads      = GetParallelMaxThreads();
     int workspace_per_thread = conv_param->kernels[1] * (k_param_->iw + pad_l + pad_r) * 8 * data_byte_size;
 
     if (!SlideFunc_) {
@@ -119,12 +119,11 @@ Status ArmConvFp16LayerDepthwiseS1::DoForward(const std::vector<Blob *> &inputs,
         auto src_ptr = src_origin + batch_idx * k_param_->iw * k_param_->ih * k_param_->ic_r8;
         auto dst_ptr = dst_origin + batch_idx * k_param_->ow * k_param_->oh * k_param_->oc_r8;
 
-        OMP_PARALLEL_FOR_
-        for (int dz = 0; dz < k_param_->oc_r8; dz += 8) {
+        ParallelForWithThreadId(0, UP_DIV(k_param_->oc_r8, 8), [&](int dz_i, int thread_id) {
+            int dz = dz_i * 8;
             auto *dst_z                       = dst_ptr + dst_z_step * dz;
             auto *src_z                       = src_ptr + src_z_step * dz;
             const auto *weight_dz             = reinterpret_cast<fp16_t *>(k_param_->fil_ptr) + dz * weight_z_step;
-            int thread_id                     = OMP_TID_;
             auto thread_work_space            = work_space + thread_id * workspace_per_thread / data_byte_size;
             fp16_t *cache_line[MAX_CACHE_LINE_NUM] = {nullptr};
             for (int i = 0; i < conv_param->kernels[1]; i++) {
@@ -161,7 +160,7 @@ Status ArmConvFp16LayerDepthwiseS1::DoForward(const std::vector<Blob *> &inputs,
                 dst_y += k_param_->ow * 8;
                 cache_lines_slide(cache_line, conv_param->kernels[1]);
             }
-        }
+        });
     }
 
     PostExec<fp16_t>(outputs);
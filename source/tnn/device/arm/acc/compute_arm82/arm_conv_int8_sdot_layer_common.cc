@@ -21,7 +21,7 @@
 #include "tnn/device/arm/arm_context.h"
 #include "tnn/utils/data_format_converter.h"
 #include "tnn/utils/data_type_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 #include "tnn/utils/cpu_utils.h"
 
 #ifdef TNN_ARM82_USE_NEON
@@ -245,7 +245,7 @@ Status ArmConvInt8SdotLayerCommon::DoForward(const std::vector<Blob *> &inputs,
     int tile_count = UP_DIV(dims_output[2] * dims_output[3], tile_blk_);
 
     // for multi-threads, adjust tile_blk to make more threads parallel
-    int max_num_threads = OMP_MAX_THREADS_NUM_;
+    int max_num_threads = GetParallelMaxThreads();
     if (max_num_threads > 1) {
         while (tile_count < max_num_threads && tile_blk_ > NEON_INT8_SDOT_TILE_HW) {
             tile_blk_ = ROUND_UP(tile_blk_ / 2, NEON_INT8_SDOT_TILE_HW);
@@ -271,9 +271,7 @@ Status ArmConvInt8SdotLayerCommon::DoForward(const std::vector<Blob *> &inputs,
         auto output_batch    = output_data + n * output_batch_stride;
         auto add_input_batch = add_input_data ? add_input_data + n * output_batch_stride : nullptr;
 
-        OMP_PARALLEL_FOR_GUIDED_
-        for (int t_idx = 0; t_idx < tile_count; t_idx++) {
-            int thread_id          = OMP_TID_;
+        ParallelForWithThreadId(0, tile_count, [&](int t_idx, int thread_id) {
             int8_t *input_kernel   = nullptr;
             const int hw_start     = t_idx * tile_blk_;
             const int real_hw_tile = MIN(output_channel_stride - hw_start, tile_blk_);
@@ -302,7 +300,7 @@ Status ArmConvInt8SdotLayerCommon::DoForward(const std::vector<Blob *> &inputs,
                                    relu_, add_input_tmp, add_scale_ptr + oc_r4_align,
                                    relu6_max_ptr + oc_r4_align);
             }
-        }
+        });
     }
 
     return TNN_OK;
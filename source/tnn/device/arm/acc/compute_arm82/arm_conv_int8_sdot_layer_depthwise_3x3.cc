@@ -21,7 +21,7 @@
 #include "tnn/utils/data_type_utils.h"
 #include "tnn/utils/cpu_utils.h"
 
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 #ifdef TNN_ARM82_USE_NEON
 namespace TNN_NS {
@@ -104,10 +104,10 @@ static inline void cache_lines_slide_s2(int8_t **cache_lines, int n) {
 
 static void DepthwiseI8K3S1Sdot(int8_t* dst, int8_t** src, const int8_t* weight, const int32_t* bias_z, long width,
                               long dst_depth, const float* scale_z, const int8_t* relu6_max, int activation_type) {
-    OMP_PARALLEL_FOR_GUIDED_
-    for (long dc = 0; dc < dst_depth - 7; dc += 8) {
+    ParallelFor(0, UP_DIV(dst_depth - 7, 8), [&](int dc_i) {
+        long dc = dc_i * 8;
         ConvDw3x3Int8SdotSlideW(dst + dc, src, weight + dc * 12, bias_z + dc, scale_z + dc, dc, dst_depth, width);
-    }
+    });
     long dc = dst_depth / 8 * 8;
     if (dc < dst_depth) {
         ConvDw3x3Int8SdotSlideWLeftC4(dst + dc, src, weight + dc * 12, bias_z + dc, scale_z + dc, dc, dst_depth, width);
@@ -122,10 +122,10 @@ static void DepthwiseI8K3S1Sdot(int8_t* dst, int8_t** src, const int8_t* weight,
 
 static void DepthwiseI8K3S2Sdot(int8_t* dst, int8_t** src, const int8_t* weight, const int32_t* bias_z, long width,
                               long dst_depth, const float* scale_z, const int8_t* relu6_max, int activation_type) {
-    OMP_PARALLEL_FOR_GUIDED_
-    for (long dc = 0; dc < dst_depth - 7; dc += 8) {
+    ParallelFor(0, UP_DIV(dst_depth - 7, 8), [&](int dc_i) {
+        long dc = dc_i * 8;
         ConvDw3x3S2Int8SdotSlideW(dst + dc, src, weight + dc * 12, bias_z + dc, scale_z + dc, dc, dst_depth, width);
-    }
+    });
     long dc = dst_depth / 8 * 8;
     if (dc < dst_depth) {
         ConvDw3x3S2Int8SdotSlideWLeftC4(dst + dc, src, weight + dc * 12, bias_z + dc, scale_z + dc, dc, dst_depth, width);
@@ -19,7 +19,7 @@
 #include "tnn/utils/data_format_converter.h"
 #include "tnn/utils/data_type_utils.h"
 
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 /*
@@ -213,8 +213,7 @@ Status ArmDeconvFp16LayerCommon::DoForward(const std::vector<Blob *> &inputs, co
             // prepare init value
             memset(p_buffer, 0, pad_img_size * data_byte_size);
 
-            OMP_PARALLEL_FOR_
-            for (int z = 0; z < goc_8; z++) {
+            ParallelFor(0, goc_8, [&](int z) {
                 auto weight_z = weight_ptr + z * weight_z_step;
                 auto dst_z    = p_buffer + z * dst_z_step_pad;
                 for (int dy = 0; dy < k_param_->ih; dy++) {
@@ -234,11 +233,10 @@ Status ArmDeconvFp16LayerCommon::DoForward(const std::vector<Blob *> &inputs, co
                                     8 * conv_param->dialations[0], dst_w_pad * 8 * conv_param->dialations[1]);
                     }
                 }
-            }
+            });
 
             // crop inner image
-            OMP_PARALLEL_FOR_
-            for (int z = 0; z < goc_8; z++) {
+            ParallelFor(0, goc_8, [&](int z) {
                 auto src_z = p_buffer + z * dst_z_step_pad;
                 auto dst_z = output_g_ptr + z * dst_z_step;
                 for (int dy = 0; dy < output_height; dy++) {
@@ -246,7 +244,7 @@ Status ArmDeconvFp16LayerCommon::DoForward(const std::vector<Blob *> &inputs, co
                     auto dst_y = dst_z + dy * output_width * 8;
                     memcpy(dst_y, src_y, output_width * 8 * data_byte_size);
                 }
-            }
+            });
         }
 
         /*
@@ -17,7 +17,7 @@
 #include "tnn/device/arm/acc/compute/gemm_function.h"
 #include "tnn/utils/data_type_utils.h"
 #include "tnn/utils/dims_vector_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 
@@ -117,12 +117,11 @@ Status ArmInnerProductLayerAcc::ExecFp16(const std::vector<Blob *> &inputs, cons
     }
 
     if (fc_param->has_bias) {
-        OMP_PARALLEL_FOR_
-        for (int b = 0; b < batch; ++b) {
+        ParallelFor(0, batch, [&](int b) {
             // output shape: [batch, oc]
             auto dst_ptr_b = tmp_output_ptr + b * oc;
             memcpy(dst_ptr_b, buffer_bias_.force_to<fp16_t *>(), bias_size);
-        }
+        });
     } else {
         memset(tmp_output_ptr, 0, output_size);
     }
@@ -161,12 +160,11 @@ Status ArmInnerProductLayerAcc::ExecNchwFp16(const std::vector<Blob *> &inputs,
     fp16_t *tmp_output_ptr = output_ptr;
 
     if (fc_param->has_bias) {
-        OMP_PARALLEL_FOR_
-        for (int b = 0; b < batch; ++b) {
+        ParallelFor(0, batch, [&](int b) {
             // output shape: [batch, oc]
             auto dst_ptr_b = tmp_output_ptr + b * oc;
             memcpy(dst_ptr_b, buffer_bias_.force_to<fp16_t *>(), bias_size);
-        }
+        });
     } else {
         memset(tmp_output_ptr, 0, output_size);
     }
@@ -19,7 +19,7 @@
 #include "tnn/device/arm/arm_common.h"
 #include "tnn/utils/data_type_utils.h"
 #include "tnn/utils/dims_vector_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 
@@ -27,8 +27,8 @@ namespace TNN_NS {
 
 static void LstmActivate(const int count, const fp16_t *g_ptr, fp16_t *c_ptr, fp16_t *h_ptr, fp16_t *o_ptr) {
 #ifdef TNN_ARM82_USE_NEON
-    OMP_PARALLEL_FOR_
-    for (int q = 0; q < count - 7; q += 8) {
+    ParallelFor(0, UP_DIV(count - 7, 8), [&](int q_i) {
+        int q = q_i * 8;
         Half8x4 gates_iofc = Half8x4::ld4(g_ptr + q * 4);
         Half8 I, O, F, C;
         gates_iofc.get_lane(I, 0);
@@ -46,7 +46,7 @@ static void LstmActivate(const int count, const fp16_t *g_ptr, fp16_t *c_ptr, fp
         Half8::save(c_ptr + q, cell2);
         Half8::save(h_ptr + q, H);
         Half8::save(o_ptr + q, H);
-    }
+    });
     int remain = count % 8;
     int offset = count / 8 * 8;
     g_ptr += offset * 4;
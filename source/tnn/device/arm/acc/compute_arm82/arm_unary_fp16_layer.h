@@ -18,7 +18,7 @@
 #include "tnn/device/arm/acc/Half8.h"
 #include "tnn/device/arm/acc/arm_unary_layer_acc.h"
 #include "tnn/utils/dims_function_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 
@@ -36,10 +36,9 @@ namespace TNN_NS {
         int count_div8  = UP_DIV(count, 8);                                                                            \
         auto input_ptr  = reinterpret_cast<fp16_t *>(GetBlobHandlePtr(input->GetHandle()));                            \
         auto output_ptr = reinterpret_cast<fp16_t *>(GetBlobHandlePtr(output->GetHandle()));                           \
-        OMP_PARALLEL_FOR_                                                                                              \
-        for (int n = 0; n < count_div8; n++) {                                                                         \
+        ParallelFor(0, count_div8, [&](int n) {                                                                        \
             Half8::save(output_ptr + n * 8, op_type()(Half8::load(input_ptr + n * 8)));                                \
-        }                                                                                                              \
+        });                                                                                                            \
         return TNN_OK;                                                                                                 \
     }
 #else
@@ -24,7 +24,7 @@
 #include "tnn/device/arm/arm_util.h"
 #include "tnn/utils/half_utils_inner.h"
 #include "tnn/utils/naive_compute.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 
@@ -462,8 +462,7 @@ void FloatC4ToHalfC8(fp16_t* dst, const float* src, long batch, long channel, lo
     for (long n = 0; n < batch; n++) {
         auto dst_n = dst + n * c_r8 * hw * 8;
         auto src_n = src + n * c_r4 * hw * 4;
-        OMP_PARALLEL_FOR_GUIDED_
-        for (long ci = 0; ci < c_r4; ++ci) {
+        ParallelFor(0, c_r4, [&](int ci) {
             long co         = ci / 2;
             long dst_offset = (ci % 2) ? 4 : 0;
             auto dst_c      = dst_n + co * hw * 8 + dst_offset;
@@ -480,7 +479,7 @@ void FloatC4ToHalfC8(fp16_t* dst, const float* src, long batch, long channel, lo
                 }
 #endif
             }
-        }
+        });
 
         if (c_r4 * 4 < c_r8 * 8) {
             long co         = c_r4 / 2;
@@ -508,8 +507,7 @@ void HalfC8ToFloatC4(float* dst, const fp16_t* src, long batch, long channel, lo
     for (long n = 0; n < batch; n++) {
         auto src_n = src + n * c_r8 * hw * 8;
         auto dst_n = dst + n * c_r4 * hw * 4;
-        OMP_PARALLEL_FOR_GUIDED_
-        for (long co = 0; co < c_r4; ++co) {
+        ParallelFor(0, c_r4, [&](int co) {
             long ci         = co / 2;
             long src_offset = (co % 2) ? 4 : 0;
             auto src_c      = src_n + ci * hw * 8 + src_offset;
@@ -526,7 +524,7 @@ void HalfC8ToFloatC4(float* dst, const fp16_t* src, long batch, long channel, lo
                 }
 #endif
             }
-        }
+        });
     }
 }
 
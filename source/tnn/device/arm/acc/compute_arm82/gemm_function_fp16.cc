@@ -24,7 +24,7 @@
 #include "tnn/device/arm/arm_common.h"
 #include "tnn/device/arm/arm_context.h"
 #include "tnn/utils/bfp16.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 
@@ -34,8 +34,8 @@ void Kernel_8x16(int m, int n, int k, const fp16_t *sa, const fp16_t *sb, fp16_t
         const fp16_t *ar = sa + i * k;
         const fp16_t *br = sb;
         fp16_t *cr       = sc + i * ldc;
-        OMP_PARALLEL_FOR_
-        for (int j = 0; j < n - 15; j += 16) {
+        ParallelFor(0, UP_DIV(n - 15, 16), [&](int j_i) {
+            int j = j_i * 16;
             const fp16_t *a    = ar;
             const fp16_t *b    = br + j * k;
             fp16_t *c          = cr + j;
@@ -120,7 +120,7 @@ void Kernel_8x16(int m, int n, int k, const fp16_t *sa, const fp16_t *sb, fp16_t
                 : "0"(b), "1"(a), "2"(c), "3"(ldc_offset), "4"(k_64)
                 : "memory", "cc", "x8", "x9", "v0", "v1", "v2", "v8", "v9", "v10", "v11", "v12", "v13", "v14", "v15",
                   "v20", "v21", "v22", "v23", "v24", "v25", "v26", "v27");
-        }
+        });
         int remain = n % 16;
         if (remain) {
             const fp16_t *a   = ar;
@@ -180,8 +180,8 @@ void Kernel_4x16(int m, int n, int k, const fp16_t *sa, const fp16_t *sb, fp16_t
         const fp16_t *ar = sa + i * k;
         const fp16_t *br = sb;
         fp16_t *cr       = sc + i * ldc;
-        OMP_PARALLEL_FOR_
-        for (int j = 0; j < n - 15; j += 16) {
+        ParallelFor(0, UP_DIV(n - 15, 16), [&](int j_i) {
+            int j = j_i * 16;
             const fp16_t *a = ar;
             const fp16_t *b = br + j * k;
             fp16_t *c       = cr + j;
@@ -298,7 +298,7 @@ void Kernel_4x16(int m, int n, int k, const fp16_t *sa, const fp16_t *sb, fp16_t
                 : "0"(b), "1"(a), "2"(c), "3"(ldc_offset), "4"(k)
                 : "memory", "cc", "r8", "r9", "q0", "q1", "q2", "q8", "q9", "q10", "q11", "q12", "q13", "q14", "q15");
 #endif  // TNN_ARM82_A64
-        }
+        });
         int remain = n % 16;
         if (remain) {
             const fp16_t *a = ar;
@@ -363,8 +363,8 @@ void Kernel_1x16(int m, int n, int k, const fp16_t *sa, const fp16_t *sb, fp16_t
         const fp16_t *ar = sa + i * k;
         const fp16_t *br = sb;
         fp16_t *cr       = sc + i * ldc;
-        OMP_PARALLEL_FOR_
-        for (int j = 0; j < n - 15; j += 16) {
+        ParallelFor(0, UP_DIV(n - 15, 16), [&](int j_i) {
+            int j = j_i * 16;
             const fp16_t *a = ar;
             const fp16_t *b = br + j * k;
             fp16_t *c       = cr + j;
@@ -491,7 +491,7 @@ void Kernel_1x16(int m, int n, int k, const fp16_t *sa, const fp16_t *sb, fp16_t
                 : "0"(b), "1"(a), "2"(c), "3"(ldc_offset), "4"(k)
                 : "memory", "cc", "r8", "r9", "q0", "q1", "q2", "q3", "q4", "q8", "q9", "q10", "q11");
 #endif  // TNN_ARM82_A64
-        }
+        });
         int remain = n % 16;
         if (remain) {
             const fp16_t *a = ar;
@@ -563,8 +563,7 @@ void PackA_8(int m, int k, const fp16_t *src, int lda, fp16_t *dst) {
         src_offset[7] = src_offset[6] + lda;
         src += 8 * lda;
 
-        OMP_PARALLEL_FOR_
-        for (int i = 0; i < k; ++i) {
+        ParallelFor(0, k, [&](int i) {
             fp16_t *dst_t = dst_r + i * 8;
             *(dst_t + 0)  = *(src_offset[0] + i);
             *(dst_t + 1)  = *(src_offset[1] + i);
@@ -574,7 +573,7 @@ void PackA_8(int m, int k, const fp16_t *src, int lda, fp16_t *dst) {
             *(dst_t + 5)  = *(src_offset[5] + i);
             *(dst_t + 6)  = *(src_offset[6] + i);
             *(dst_t + 7)  = *(src_offset[7] + i);
-        }
+        });
     }
 }
 
@@ -588,22 +587,20 @@ void PackA_4(int m, int k, const fp16_t *src, int lda, fp16_t *dst) {
         src_offset[3] = src_offset[2] + lda;
         src += 4 * lda;
 
-        OMP_PARALLEL_FOR_
-        for (int i = 0; i < k; ++i) {
+        ParallelFor(0, k, [&](int i) {
             fp16_t *dst_t = dst_r + i * 4;
             *(dst_t + 0)  = *(src_offset[0] + i);
             *(dst_t + 1)  = *(src_offset[1] + i);
             *(dst_t + 2)  = *(src_offset[2] + i);
             *(dst_t + 3)  = *(src_offset[3] + i);
-        }
+        });
     }
 }
 
 void PackA_1(int m, int k, const fp16_t *src, int lda, fp16_t *dst) {
-    OMP_PARALLEL_FOR_
-    for (int j = 0; j < m; ++j) {
+    ParallelFor(0, m, [&](int j) {
         memcpy(dst + j * k, src + j * lda, k * sizeof(fp16_t));
-    }
+    });
 }
 
 }  // namespace TNN_NS
@@ -19,7 +19,7 @@
 #include "tnn/utils/data_format_converter.h"
 #include "tnn/utils/data_type_utils.h"
 #include "tnn/utils/dims_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 #include "tnn/utils/naive_compute.h"
 #ifdef TNN_USE_NEON
 #include <arm_neon.h>
@@ -404,7 +404,7 @@ Status ArmConvInt8LayerCommon::DoForward(const std::vector<Blob *> &inputs, cons
     const int crs_div8   = UP_DIV(ic_calc * conv_param->kernels[1] * conv_param->kernels[0], 8);
     const int tile_count = UP_DIV(k_param_->oh * k_param_->ow, NEON_INT8CONV_TILE_HW);
 
-    int max_num_threads  = OMP_MAX_THREADS_NUM_;
+    int max_num_threads  = GetParallelMaxThreads();
     const int crs_r16    = ROUND_UP(k_param_->ic_r4 * conv_param->kernels[1] * conv_param->kernels[0], 16);
     size_t gemm_tmp_size = crs_r16 * NEON_INT8CONV_TILE_HW * max_num_threads + NEON_KERNEL_EXTRA_LOAD;
     size_t im2col_size   = gemm_tmp_size;
@@ -424,9 +424,7 @@ Status ArmConvInt8LayerCommon::DoForward(const std::vector<Blob *> &inputs, cons
         auto add_input_batch =
             add_input_data ? add_input_data + n * k_param_->ow * k_param_->oh * k_param_->oc_r4 : nullptr;
 
-        OMP_PARALLEL_FOR_GUIDED_
-        for (int t_idx = 0; t_idx < tile_count; t_idx++) {
-            int thread_id          = OMP_TID_;
+        ParallelForWithThreadId(0, tile_count, [&](int t_idx, int thread_id) {
             int8_t *input_kernel   = nullptr;
             const int hw_start     = t_idx * NEON_INT8CONV_TILE_HW;
             const int real_hw_tile = MIN(k_param_->oh * k_param_->ow - hw_start, NEON_INT8CONV_TILE_HW);
@@ -460,7 +458,7 @@ Status ArmConvInt8LayerCommon::DoForward(const std::vector<Blob *> &inputs, cons
                          relu6_max_.force_to<int8_t *>());
                 memcpy(output_kernel, outptr_tmp, real_hw_tile * k_param_->oc_r4);
             }
-        }
+        });
     }
     return TNN_OK;
 }
@@ -18,7 +18,7 @@
 #include "tnn/device/arm/arm_context.h"
 #include "tnn/utils/data_format_converter.h"
 #include "tnn/utils/data_type_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 bool ArmConvInt8LayerDepthwise::isPrefered(ConvLayerParam *param, const std::vector<Blob *> &inputs,
@@ -156,27 +156,24 @@ Status ArmConvInt8LayerDepthwise::DoForward(const std::vector<Blob *> &inputs, c
             dwfunc = DepthwiseI8K5;
         }
 #endif
-        OMP_PARALLEL_SECTIONS_ {
-            OMP_SECTION_ {
+        // the four corners
+        ParallelFor(0, 4, [&](int corner) {
+            if (corner == 0) {
                 // top corner
                 RunCorner(output_batch, input_batch, 0, 0, k_param_->ow, t);
-            }
-            OMP_SECTION_ {
+            } else if (corner == 1) {
                 // bottom corner
                 RunCorner(output_batch, input_batch, 0, b, k_param_->ow, k_param_->oh);
-            }
-            OMP_SECTION_ {
+            } else if (corner == 2) {
                 // left corner
                 RunCorner(output_batch, input_batch, 0, t, l, b);
-            }
-            OMP_SECTION_ {
+            } else {
                 // bottom corner
                 RunCorner(output_batch, input_batch, r, t, k_param_->ow, b);
             }
-        }
+        });
         if (r > l && b > t) {
-            OMP_PARALLEL_FOR_GUIDED_
-            for (long dy = t; dy < b; ++dy) {
+            ParallelFor(t, b, [&](int dy) {
                 const long src_start_y = dy * conv_param->strides[1] - conv_param->pads[2];
                 const auto src_dy      = input_batch + src_start_y * src_y_step;
                 auto dst_y             = output_batch + dy * dst_y_step;
@@ -185,7 +182,7 @@ Status ArmConvInt8LayerDepthwise::DoForward(const std::vector<Blob *> &inputs, c
                        reinterpret_cast<int8_t *>(k_param_->fil_ptr), reinterpret_cast<int32_t *>(k_param_->bias),
                        r - l, src_y_step * dilate_y, k_param_->oc_r4 * dilate_x, src_w_step, k_param_->oc_r4,
                        conv_param->kernels[0], conv_param->kernels[1], k_param_->scale);
-            }
+            });
         }
 
         if (conv_param->activation_type == ActivationType_ReLU) {
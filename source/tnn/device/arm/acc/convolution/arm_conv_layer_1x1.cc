@@ -24,7 +24,7 @@
 #include "tnn/device/arm/arm_context.h"
 #include "tnn/utils/data_format_converter.h"
 #include "tnn/utils/data_type_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 
@@ -135,7 +135,7 @@ Status ArmConvLayer1x1::Exec(const std::vector<Blob *> &inputs, const std::vecto
     /*
     get a_block & b_block based on l2 cache size(512K most of the time)
     */
-    int max_num_threads = OMP_MAX_THREADS_NUM_;
+    int max_num_threads = GetParallelMaxThreads();
     int threadbuf_num   = plane_num > oc4 * 4 ? max_num_threads : 1;
     int a_block, b_block;
     set_block_size(a_block, b_block, 512 * 1024 / data_byte_size, plane_num, oc4 * 4, ic4 * 4, data_byte_size);
@@ -17,6 +17,7 @@
 #ifdef TNN_USE_NEON
 #include <arm_neon.h>
 #endif
+#include "tnn/core/packed_weight_cache.h"
 #include "tnn/device/arm/acc/compute/gemm_function.h"
 #include "tnn/device/arm/acc/compute/winograd_function.h"
 #include "tnn/device/arm/arm_common.h"
@@ -24,7 +25,8 @@
 #include "tnn/utils/data_format_converter.h"
 #include "tnn/utils/data_type_utils.h"
 #include "tnn/utils/dims_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
+#include "tnn/utils/string_utils_inner.h"
 
 namespace TNN_NS {
 /*
@@ -311,27 +313,33 @@ Status ArmConvLayer3x3::allocateBufferWeight(const std::vector<Blob *> &inputs,
         src_unit_ = dst_unit_ + kw - 1;
 
         const int weight_count = src_unit_ * src_unit_ * k_param_->oc_r4 * k_param_->ic_r4;
-        RawBuffer pack_weight(weight_count * data_byte_size + NEON_KERNEL_EXTRA_LOAD);
-
-        switch (dst_unit_) {
-            case 2:
-                WeightTransform4x4(src, pack_weight.force_to<float *>(), 3, input_channel, output_channel);
-                break;
-            case 4:
-                WeightTransform6x6(src, pack_weight.force_to<float *>(), 3, input_channel, output_channel);
-                break;
-            default:
-                LOGE("Unsupport winograd dst unit\n");
-                break;
-        }
+
+        auto variant = "conv_3x3_winograd_" + ToString(dst_unit_);
+        auto key     = PackedWeightCache::CreateKey(context_, param_, DEVICE_ARM, variant, conv_res->filter_handle);
+        return PackedWeightCache::GetOrPack(key, [&](RawBuffer &packed) -> Status {
+            RawBuffer pack_weight(weight_count * data_byte_size + NEON_KERNEL_EXTRA_LOAD);
+
+            switch (dst_unit_) {
+                case 2:
+                    WeightTransform4x4(src, pack_weight.force_to<float *>(), 3, input_channel, output_channel);
+                    break;
+                case 4:
+                    WeightTransform6x6(src, pack_weight.force_to<float *>(), 3, input_channel, output_channel);
+                    break;
+                default:
+                    LOGE("Unsupport winograd dst unit\n");
+                    break;
+            }
 
 #ifdef __aarch64__
-        for (int i = 0; i < src_unit_ * src_unit_; i++) {
-            ConvertWeightsC4ToC8(pack_weight.force_to<float *>() + i * k_param_->ic_r4 * k_param_->oc_r4, dims_input[1],
-                                 dims_output[1]);
-        }
+            for (int i = 0; i < src_unit_ * src_unit_; i++) {
+                ConvertWeightsC4ToC8(pack_weight.force_to<float *>() + i * k_param_->ic_r4 * k_param_->oc_r4,
+                                     dims_input[1], dims_output[1]);
+            }
 #endif
-        buffer_weight_ = pack_weight;
+            packed = pack_weight;
+            return TNN_OK;
+        }, buffer_weight_);
     }
 
     return TNN_OK;
@@ -400,7 +408,7 @@ Status ArmConvLayer3x3::Exec(const std::vector<Blob *> &inputs, const std::vecto
     T *src_origin = reinterpret_cast<T *>(GetBlobHandlePtr(input->GetHandle()));
     T *dst_origin = reinterpret_cast<T *>(GetBlobHandlePtr(output->GetHandle()));
 
-    int max_num_threads          = OMP_MAX_THREADS_NUM_;
+    int max_num_threads          = GetParallelMaxThreads();
     int transform_num_per_thread = src_unit_ * src_unit_ * 4;
     int work_num_per_thread      = (k_param_->ic_r4 * 2 + k_param_->oc_r4) * src_unit_ * src_unit_ * ARM_SGEMM_TILE_M;
 
@@ -438,9 +446,7 @@ Status ArmConvLayer3x3::Exec(const std::vector<Blob *> &inputs, const std::vecto
             int src_z_step = k_param_->iw * k_param_->ih * 4;
             int dst_z_step = x_c * src_unit_ * src_unit_ * 4;
 
-            OMP_PARALLEL_FOR_
-            for (int z = 0; z < k_param_->ic_r4 / 4; z++) {
-                int tid         = OMP_TID_;
+            ParallelForWithThreadId(0, k_param_->ic_r4 / 4, [&](int z, int tid) {
                 auto mid_buffer = transform_buffer + tid * transform_num_per_thread;
                 auto src_z      = input_ptr + z * src_z_step;
                 auto dst_z      = _src_origin + z * dst_z_step;
@@ -496,22 +502,19 @@ Status ArmConvLayer3x3::Exec(const std::vector<Blob *> &inputs, const std::vecto
                     auto repack_src = dst_z + i * 4;
                     load_repack(repack_dst, repack_src, x_c, src_unit_ * src_unit_ * 4);
                 }
-            }
+            });
 
             // gemm multi (n8 for armv8, n4 for armv7)
-            OMP_PARALLEL_FOR_
-            for (int i = 0; i < src_unit_ * src_unit_; i++) {
+            ParallelFor(0, src_unit_ * src_unit_, [&](int i) {
                 GEMM_FUNC(_dst_origin + i * 4 * x_c, repack_buf + i * k_param_->ic_r4 * x_c,
                           reinterpret_cast<float *>(k_param_->fil_ptr) + i * k_param_->ic_r4 * k_param_->oc_r4,
                           k_param_->ic_r4 / 4, x_c * src_unit_ * src_unit_ * 4, k_param_->oc_r4 / 4, x_c, fake_bias, 0);
-            }
+            });
 
             src_z_step = x_c * src_unit_ * src_unit_ * 4;
             dst_z_step = k_param_->ow * k_param_->oh * 4;
 
-            OMP_PARALLEL_FOR_
-            for (int z = 0; z < k_param_->oc_r4 / 4; z++) {
-                int tid         = OMP_TID_;
+            ParallelForWithThreadId(0, k_param_->oc_r4 / 4, [&](int z, int tid) {
                 auto mid_buffer = transform_buffer + tid * transform_num_per_thread;
                 auto src_z      = _dst_origin + z * src_z_step;
                 auto dst_z      = output_ptr + z * dst_z_step;
@@ -553,7 +556,7 @@ Status ArmConvLayer3x3::Exec(const std::vector<Blob *> &inputs, const std::vecto
                     }
                     // dst transform end
                 }
-            }
+            });
         }
     }
 
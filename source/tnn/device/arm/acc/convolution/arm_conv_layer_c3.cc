@@ -17,7 +17,7 @@
 #include "tnn/device/arm/arm_context.h"
 #include "tnn/utils/data_format_converter.h"
 #include "tnn/utils/data_type_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 // usually appears on the first conv layer
@@ -101,7 +101,7 @@ Status ArmConvLayerC3::Exec(const std::vector<Blob *> &inputs, const std::vector
     T *src_origin = reinterpret_cast<T *>(GetBlobHandlePtr(input->GetHandle()));
     T *dst_origin = reinterpret_cast<T *>(GetBlobHandlePtr(output->GetHandle()));
 
-    int max_num_threads = OMP_MAX_THREADS_NUM_;
+    int max_num_threads = GetParallelMaxThreads();
 
     int src_xc = 1 + (k_param_->ow - 1) * conv_param->strides[0] + conv_param->dialations[0] * (kernel_x - 1);
     int workspace_per_thread = src_xc * kernel_y * k_param_->ic_r4 * data_byte_size;
@@ -121,9 +121,7 @@ Status ArmConvLayerC3::Exec(const std::vector<Blob *> &inputs, const std::vector
         int copy_count = src_end_x - src_start_x;
         auto src_x     = input_ptr + 4 * src_start_x;
 
-        OMP_PARALLEL_FOR_
-        for (int dy = 0; dy < k_param_->oh; dy++) {
-            int thread_id = OMP_TID_;
+        ParallelForWithThreadId(0, k_param_->oh, [&](int dy, int thread_id) {
 
             auto work_space_t = work_space + thread_id * workspace_per_thread / sizeof(T);
             memset(work_space_t, 0, workspace_per_thread);
@@ -146,7 +144,7 @@ Status ArmConvLayerC3::Exec(const std::vector<Blob *> &inputs, const std::vector
                 GemmSlidewC3(dst_z, reinterpret_cast<T *>(work_space_t), weight_dz, k_param_->ow,
                              conv_param->strides[0] * 4, kernel_x, kernel_y, dilate_x_step, src_xc * 4);
             }
-        }
+        });
     }
 
     PostExec<T>(outputs);
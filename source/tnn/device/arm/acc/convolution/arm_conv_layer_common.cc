@@ -13,12 +13,13 @@
 // specific language governing permissions and limitations under the License.
 
 #include "tnn/device/arm/acc/convolution/arm_conv_layer_common.h"
+#include "tnn/core/packed_weight_cache.h"
 
 #include "tnn/device/arm/arm_common.h"
 #include "tnn/device/arm/arm_context.h"
 #include "tnn/utils/data_format_converter.h"
 #include "tnn/utils/data_type_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 #if defined(__aarch64__)
 #define CONVOLUTION_TILED_NUMBER (14)
@@ -64,17 +65,22 @@ Status ArmConvLayerCommon::allocateBufferWeight(const std::vector<Blob *> &input
         int weight_count   = group * goc_4 * gic_4 * kh * kw * 16;
         int data_byte_size = DataTypeUtils::GetBytesSize(conv_res->filter_handle.GetDataType());
 
-        /*
-        [ATTENTION]
-        alloc more NEON_KERNEL_EXTRA_LOAD bytes for assemble kernel prefetch
-        */
-        RawBuffer temp_buffer(weight_count * data_byte_size + NEON_KERNEL_EXTRA_LOAD);
-        float *dst = temp_buffer.force_to<float *>();
-
-        ConvertWeightsFromGOIHWToGOIHW16((float *)src, (float *)dst, group, input_channel, output_channel,
-                                         conv_param->kernels[1], conv_param->kernels[0]);
-
-        buffer_weight_ = temp_buffer;
+        auto key = PackedWeightCache::CreateKey(context_, param_, DEVICE_ARM, "conv_common_goihw16",
+                                                conv_res->filter_handle);
+        return PackedWeightCache::GetOrPack(key, [&](RawBuffer &packed) -> Status {
+            /*
+            [ATTENTION]
+            alloc more NEON_KERNEL_EXTRA_LOAD bytes for assemble kernel prefetch
+            */
+            RawBuffer temp_buffer(weight_count * data_byte_size + NEON_KERNEL_EXTRA_LOAD);
+            float *dst = temp_buffer.force_to<float *>();
+
+            ConvertWeightsFromGOIHWToGOIHW16((float *)src, (float *)dst, group, input_channel, output_channel,
+                                             conv_param->kernels[1], conv_param->kernels[0]);
+
+            packed = temp_buffer;
+            return TNN_OK;
+        }, buffer_weight_);
     }
     return TNN_OK;
 }
@@ -191,7 +197,7 @@ Status ArmConvLayerCommon::Exec(const std::vector<Blob *> &inputs, const std::ve
     T *input_orign = reinterpret_cast<T *>(GetBlobHandlePtr(input->GetHandle()));
     T *dst_origin  = reinterpret_cast<T *>(GetBlobHandlePtr(output->GetHandle()));
 
-    int max_num_threads = OMP_MAX_THREADS_NUM_;
+    int max_num_threads = GetParallelMaxThreads();
 
     int x_count = UP_DIV(k_param_->ow, CONVOLUTION_TILED_NUMBER);
     int src_xc  = 1 + (CONVOLUTION_TILED_NUMBER - 1) * conv_param->strides[0] +
@@ -240,9 +246,7 @@ Status ArmConvLayerCommon::Exec(const std::vector<Blob *> &inputs, const std::ve
             auto input_g_ptr  = input_ptr + g * k_param_->iw * k_param_->ih * gic_4 * 4;
             auto output_g_ptr = output_ptr + g * k_param_->ow * k_param_->oh * goc_4 * 4;
             auto w_g_offset   = g * goc_4 * weight_z_step;
-            OMP_PARALLEL_FOR_
-            for (int x = 0; x < x_count; x++) {
-                int thread_id = OMP_TID_;
+            ParallelForWithThreadId(0, x_count, [&](int x, int thread_id) {
 
                 auto work_space_t = work_space + thread_id * workspace_per_thread / sizeof(T);
 
@@ -295,7 +299,7 @@ Status ArmConvLayerCommon::Exec(const std::vector<Blob *> &inputs, const std::ve
                                      conv_param->kernels[1], dilate_x_step, src_xc * 4);
                     }
                 }
-            }
+            });
         }
 
         /*
@@ -323,15 +327,14 @@ void ArmConvLayerCommon::PostExec(const std::vector<Blob *> &outputs) {
     const int batch = outputs[0]->GetBlobDesc().dims[0];
     auto dst_origin = reinterpret_cast<T *>(GetBlobHandlePtr(outputs[0]->GetHandle()));
     if (post_func_) {
-        OMP_PARALLEL_FOR_
-        for (int batch_idx = 0; batch_idx < batch; ++batch_idx) {
+        ParallelFor(0, batch, [&](int batch_idx) {
             auto output_ptr = dst_origin + batch_idx * k_param_->ow * k_param_->oh * k_param_->oc_r4;
             for (int dz = 0; dz < k_param_->oc_r4; dz += 4) {
                 auto dst_z    = output_ptr + dz * k_param_->ow * k_param_->oh;
                 float *bias_z = reinterpret_cast<float *>(k_param_->bias) + dz;
                 post_func_(dst_z, bias_z, k_param_->ow * k_param_->oh, 1);
             }
-        }
+        });
     }
 }
 
@@ -16,7 +16,7 @@
 #define TNN_SOURCE_TNN_DEVICE_ARM_ARM_CONV_LAYER_ACC_COMMON_H_
 
 #include "tnn/device/arm/acc/arm_layer_acc.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 
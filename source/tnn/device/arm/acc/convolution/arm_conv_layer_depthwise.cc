@@ -13,13 +13,14 @@
 // specific language governing permissions and limitations under the License.
 
 #include "tnn/device/arm/acc/convolution/arm_conv_layer_depthwise.h"
+#include "tnn/core/packed_weight_cache.h"
 #include "tnn/device/arm/arm_common.h"
 #include "tnn/device/arm/arm_context.h"
 #include "tnn/interpreter/raw_buffer.h"
 #include "tnn/utils/bfp16.h"
 #include "tnn/utils/data_format_converter.h"
 #include "tnn/utils/data_type_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 bool ArmConvLayerDepthwise::isPrefered(ConvLayerParam *param, const std::vector<Blob *> &inputs,
@@ -57,14 +58,19 @@ Status ArmConvLayerDepthwise::allocateBufferWeight(const std::vector<Blob *> &in
         int data_byte_size = DataTypeUtils::GetBytesSize(conv_res->filter_handle.GetDataType());
 
         if (conv_res->filter_handle.GetDataType() == DATA_TYPE_FLOAT) {
-            RawBuffer temp_buffer(weight_count * data_byte_size);
-            float *dst = temp_buffer.force_to<float *>();
-
-            DataFormatConverter::ConvertFromNCHWToNCHW4Float((float *)src, (float *)dst, 1, group,
-                                                                param->kernels[1], param->kernels[0]);
-            temp_buffer.SetDataType(DATA_TYPE_FLOAT);
-
-            buffer_weight_ = temp_buffer;
+            auto key = PackedWeightCache::CreateKey(context_, param_, DEVICE_ARM, "conv_depthwise_nchw4",
+                                                    conv_res->filter_handle);
+            return PackedWeightCache::GetOrPack(key, [&](RawBuffer &packed) -> Status {
+                RawBuffer temp_buffer(weight_count * data_byte_size);
+                float *dst = temp_buffer.force_to<float *>();
+
+                DataFormatConverter::ConvertFromNCHWToNCHW4Float((float *)src, (float *)dst, 1, group,
+                                                                    param->kernels[1], param->kernels[0]);
+                temp_buffer.SetDataType(DATA_TYPE_FLOAT);
+
+                packed = temp_buffer;
+                return TNN_OK;
+            }, buffer_weight_);
         } else {
             LOGE("Error: DataType %d not support\n", conv_res->filter_handle.GetDataType());
             return Status(TNNERR_MODEL_ERR, "conv_res DataType is not supported");
@@ -152,8 +158,8 @@ Status ArmConvLayerDepthwise::Exec(const std::vector<Blob *> &inputs, const std:
         auto src_ptr = src_origin + batch_idx * k_param_->iw * k_param_->ih * k_param_->ic_r4;
         auto dst_ptr = dst_origin + batch_idx * k_param_->ow * k_param_->oh * k_param_->oc_r4;
 
-        OMP_PARALLEL_FOR_
-        for (int dz = 0; dz < k_param_->oc_r4; dz += 4) {
+        ParallelFor(0, UP_DIV(k_param_->oc_r4, 4), [&](int dz_i) {
+            int dz = dz_i * 4;
             auto *dst_z     = dst_ptr + dst_z_step * dz;
             auto *src_z     = src_ptr + src_z_step * dz;
             auto *weight_dz = reinterpret_cast<float *>(k_param_->fil_ptr) + dz * weight_z_step;
@@ -171,7 +177,7 @@ Status ArmConvLayerDepthwise::Exec(const std::vector<Blob *> &inputs, const std:
                         weight_dz, r - l, param->strides[0] * 4, param->kernels[0], param->kernels[1], dilate_x_step,
                         dilate_y_step, b - t, k_param_->iw * 4 * param->strides[1], k_param_->ow * 4);
             }
-        }
+        });
     }
 
     PostExec<T>(outputs);
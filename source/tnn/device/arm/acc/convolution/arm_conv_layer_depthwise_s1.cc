@@ -18,7 +18,7 @@
 #include "tnn/utils/data_format_converter.h"
 #include "tnn/utils/data_type_utils.h"
 
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 #define MAX_CACHE_LINE_NUM 7
 
@@ -117,7 +117,7 @@ Status ArmConvLayerDepthwiseS1::Exec(const std::vector<Blob *> &inputs, const st
 
     auto *src_origin         = reinterpret_cast<T *>(GetBlobHandlePtr(input->GetHandle()));
     auto *dst_origin         = reinterpret_cast<T *>(GetBlobHandlePtr(output->GetHandle()));
-    int max_num_threads      = OMP_MAX_THREADS_NUM_;
+    int max_num_threads      = GetParallelMaxThreads();
     int workspace_per_thread = conv_param->kernels[1] * (k_param_->iw + pad_l + pad_r) * 4 * data_byte_size;
 
     if (!SlideFunc_) {
@@ -141,12 +141,11 @@ Status ArmConvLayerDepthwiseS1::Exec(const std::vector<Blob *> &inputs, const st
         auto src_ptr = src_origin + batch_idx * k_param_->iw * k_param_->ih * k_param_->ic_r4;
         auto dst_ptr = dst_origin + batch_idx * k_param_->ow * k_param_->oh * k_param_->oc_r4;
 
-        OMP_PARALLEL_FOR_
-        for (int dz = 0; dz < k_param_->oc_r4; dz += 4) {
+        ParallelForWithThreadId(0, UP_DIV(k_param_->oc_r4, 4), [&](int dz_i, int thread_id) {
+            int dz = dz_i * 4;
             auto *dst_z                       = dst_ptr + dst_z_step * dz;
             auto *src_z                       = src_ptr + src_z_step * dz;
             const auto *weight_dz             = reinterpret_cast<float *>(k_param_->fil_ptr) + dz * weight_z_step;
-            int thread_id                     = OMP_TID_;
             auto thread_work_space            = work_space + thread_id * workspace_per_thread / data_byte_size;
             T *cache_line[MAX_CACHE_LINE_NUM] = {nullptr};
             for (int i = 0; i < conv_param->kernels[1]; i++) {
@@ -183,7 +182,7 @@ Status ArmConvLayerDepthwiseS1::Exec(const std::vector<Blob *> &inputs, const st
                 dst_y += k_param_->ow * 4;
                 cache_lines_slide(cache_line, conv_param->kernels[1]);
             }
-        }
+        });
     }
 
     PostExec<T>(outputs);
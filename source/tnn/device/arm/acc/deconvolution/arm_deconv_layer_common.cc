@@ -19,7 +19,7 @@
 #include "tnn/utils/data_format_converter.h"
 #include "tnn/utils/data_type_utils.h"
 
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 #if defined(__aarch64__)
 #define CONVOLUTION_TILED_NUMBER (14)
@@ -202,8 +202,7 @@ Status ArmDeconvLayerCommon::Exec(const std::vector<Blob *> &inputs, const std::
             // prepare init value
             memset(p_buffer, 0, pad_img_size);
 
-            OMP_PARALLEL_FOR_
-            for (int z = 0; z < goc_4; z++) {
+            ParallelFor(0, goc_4, [&](int z) {
                 auto weight_z = weight_ptr + z * weight_z_step;
                 auto dst_z    = p_buffer + z * dst_z_step_pad;
                 for (int dy = 0; dy < k_param_->ih; dy++) {
@@ -218,11 +217,10 @@ Status ArmDeconvLayerCommon::Exec(const std::vector<Blob *> &inputs, const std::
                                       conv_param->kernels[0], conv_param->kernels[1], dilate_x_step, dilate_y_step);
                     }
                 }
-            }
+            });
 
             // crop inner image
-            OMP_PARALLEL_FOR_
-            for (int z = 0; z < goc_4; z++) {
+            ParallelFor(0, goc_4, [&](int z) {
                 auto src_z = p_buffer + z * dst_z_step_pad;
                 auto dst_z = output_g_ptr + z * dst_z_step;
                 for (int dy = 0; dy < output_height; dy++) {
@@ -230,7 +228,7 @@ Status ArmDeconvLayerCommon::Exec(const std::vector<Blob *> &inputs, const std::
                     auto dst_y = dst_z + dy * output_width * 4;
                     memcpy(dst_y, src_y, output_width * 4 * data_byte_size);
                 }
-            }
+            });
         }
 
         /*
@@ -17,7 +17,7 @@
 #include "tnn/device/arm/arm_context.h"
 #include "tnn/utils/data_format_converter.h"
 #include "tnn/utils/data_type_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 bool ArmDeconvLayerDepthwise::isPrefered(ConvLayerParam *param, const std::vector<Blob *> &inputs,
@@ -15,7 +15,8 @@
 #include "tnn/device/arm/arm_context.h"
 #include "tnn/device/arm/arm_common.h"
 #include "tnn/utils/cpu_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
+#include "tnn/utils/thread_pool.h"
 
 namespace TNN_NS {
 
@@ -33,11 +34,17 @@ Status ArmContext::ShareCommandQueue(Context* context) {
 
 Status ArmContext::OnInstanceForwardBegin() {
     Context::OnInstanceForwardBegin();
-    OMP_SET_THREADS_(GetNumThreads());
+    // the pool is created on first forward after the threads or affinity change
+    if (!parallel_pool_ || parallel_pool_->GetNumThreads() != GetNumThreads() ||
+        parallel_pool_->GetCpuAffinity() != GetCpuAffinity()) {
+        parallel_pool_ = std::make_shared<ParallelForPool>(GetNumThreads(), GetCpuAffinity());
+    }
+    BindParallelForPool(parallel_pool_);
     return TNN_OK;
 }
 
 Status ArmContext::OnInstanceForwardEnd() {
+    BindParallelForPool(nullptr);
     return TNN_OK;
 }
 
@@ -46,7 +53,7 @@ Status ArmContext::Synchronize() {
 }
 
 Status ArmContext::SetNumThreads(int num_threads) {
-    num_threads_ = MIN(MAX(num_threads, 1), OMP_CORES_);
+    num_threads_ = MIN(MAX(num_threads, 1), GetCpuCount());
     return TNN_OK;
 }
 
@@ -59,13 +66,15 @@ void* ArmContext::GetSharedWorkSpace(size_t size) {
 }
 
 void* ArmContext::GetSharedWorkSpace(size_t size, int index) {
-    while(work_space_.size() < index + 1) {
-        work_space_.push_back(RawBuffer(ROUND_UP(size, 64)));
+    std::unique_lock<std::mutex> lck(work_space_mutex_);
+    auto &work_space = work_space_[ThreadPool::GetWorkerIndex()];
+    while(work_space.size() < index + 1) {
+        work_space.push_back(RawBuffer(ROUND_UP(size, 64)));
     }
-    if (work_space_[index].GetBytesSize() < size) {
-        work_space_[index] = RawBuffer(ROUND_UP(size, 64));
+    if (work_space[index].GetBytesSize() < size) {
+        work_space[index] = RawBuffer(ROUND_UP(size, 64));
     }
-    return work_space_[index].force_to<void*>();
+    return work_space[index].force_to<void*>();
 }
 
 }  // namespace TNN_NS
@@ -15,8 +15,12 @@
 #ifndef TNN_SOURCE_TNN_DEVICE_CPU_CPU_CONTEXT_H_
 #define TNN_SOURCE_TNN_DEVICE_CPU_CPU_CONTEXT_H_
 
+#include <map>
+#include <mutex>
+
 #include "tnn/core/context.h"
 #include "tnn/interpreter/raw_buffer.h"
+#include "tnn/utils/parallel_for.h"
 namespace TNN_NS {
 
 class ArmContext : public Context {
@@ -51,7 +55,10 @@ public:
 
 private:
     int num_threads_ = 1;
-    std::vector<RawBuffer> work_space_;
+    std::shared_ptr<ParallelForPool> parallel_pool_ = nullptr;
+    // shared workspace of each graph executor worker, -1 for threads out of the executor
+    std::map<int, std::vector<RawBuffer>> work_space_;
+    std::mutex work_space_mutex_;
 };
 
 }  // namespace TNN_NS
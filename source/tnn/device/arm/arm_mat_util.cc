@@ -27,7 +27,7 @@
 #include "tnn/utils/bfp16.h"
 #include "tnn/utils/mat_converter_utils.h"
 #include "tnn/utils/naive_compute.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 namespace arm {
@@ -388,12 +388,12 @@ void ResizeBilinearC1Impl(const uint8_t* src, int batch, int src_w, int src_h, i
     ResizeBilinearKernelParm param(xofs, yofs, ialpha, ibeta, src, dst, src_plane, src_stride, schannel);
 
     // loop body
-    int max_num_threads = OMP_MAX_THREADS_NUM_;
+    int max_num_threads = GetParallelMaxThreads();
     short* rows0        = new short[w * max_num_threads];
     short* rows1        = new short[w * max_num_threads];
-    short* rows0_t[max_num_threads];
-    short* rows1_t[max_num_threads];
-    int    prev_sy[max_num_threads];
+    std::vector<short*> rows0_t(max_num_threads);
+    std::vector<short*> rows1_t(max_num_threads);
+    std::vector<int> prev_sy(max_num_threads);
 
     for (int b = 0; b < batch; ++b) {
         for (int t = 0; t < max_num_threads; ++t) {
@@ -402,11 +402,9 @@ void ResizeBilinearC1Impl(const uint8_t* src, int batch, int src_w, int src_h, i
             rows1_t[t] = rows1 + t * w;
         }
 
-        OMP_PARALLEL_FOR_
-        for (int dy = 0; dy < h; dy++) {
-            int thread_id  = OMP_TID_;
-            ResizeBilinearOneRow(param, thread_id, rows0_t, rows1_t, prev_sy, b, w, h, stride, dy);
-        }
+        ParallelForWithThreadId(0, h, [&](int dy, int thread_id) {
+            ResizeBilinearOneRow(param, thread_id, rows0_t.data(), rows1_t.data(), prev_sy.data(), b, w, h, stride, dy);
+        });
     }
 
     delete[] rows0;
@@ -421,12 +419,12 @@ void ResizeBilinearC2Impl(const uint8_t* src, int batch, int src_w, int src_h, i
     ResizeBilinearKernelParm param(xofs, yofs, ialpha, ibeta, src, dst, src_plane, src_stride, schannel);
 
     // loop body
-    int max_num_threads = OMP_MAX_THREADS_NUM_;
+    int max_num_threads = GetParallelMaxThreads();
     short* rows0        = new short[(w * 2 + 2) * max_num_threads];
     short* rows1        = new short[(w * 2 + 2) * max_num_threads];
-    short* rows0_t[max_num_threads];
-    short* rows1_t[max_num_threads];
-    int    prev_sy[max_num_threads];
+    std::vector<short*> rows0_t(max_num_threads);
+    std::vector<short*> rows1_t(max_num_threads);
+    std::vector<int> prev_sy(max_num_threads);
 
     for (int b = 0; b < batch; ++b) {
         for (int t = 0; t < max_num_threads; ++t) {
@@ -435,11 +433,9 @@ void ResizeBilinearC2Impl(const uint8_t* src, int batch, int src_w, int src_h, i
             rows1_t[t] = rows1 + t * (w * 2 + 2);
         }
 
-        OMP_PARALLEL_FOR_
-        for (int dy = 0; dy < h; dy++) {
-            int thread_id  = OMP_TID_;
-            ResizeBilinearOneRow(param, thread_id, rows0_t, rows1_t, prev_sy, b, w, h, stride, dy);
-        }
+        ParallelForWithThreadId(0, h, [&](int dy, int thread_id) {
+            ResizeBilinearOneRow(param, thread_id, rows0_t.data(), rows1_t.data(), prev_sy.data(), b, w, h, stride, dy);
+        });
     }
 
     delete[] rows0;
@@ -454,12 +450,12 @@ void ResizeBilinearC3Impl(const uint8_t* src, int batch, int src_w, int src_h, i
     ResizeBilinearKernelParm param(xofs, yofs, ialpha, ibeta, src, dst, src_plane, src_stride, schannel);
 
     // loop body
-    int max_num_threads = OMP_MAX_THREADS_NUM_;
+    int max_num_threads = GetParallelMaxThreads();
     short* rows0        = new short[(w * 3 + 1) * max_num_threads];
     short* rows1        = new short[(w * 3 + 1) * max_num_threads];
-    short* rows0_t[max_num_threads];
-    short* rows1_t[max_num_threads];
-    int    prev_sy[max_num_threads];
+    std::vector<short*> rows0_t(max_num_threads);
+    std::vector<short*> rows1_t(max_num_threads);
+    std::vector<int> prev_sy(max_num_threads);
 
     for (int b = 0; b < batch; ++b) {
         for (int t = 0; t < max_num_threads; ++t) {
@@ -468,11 +464,9 @@ void ResizeBilinearC3Impl(const uint8_t* src, int batch, int src_w, int src_h, i
             rows1_t[t] = rows1 + t * (w * 3 + 1);
         }
 
-        OMP_PARALLEL_FOR_
-        for (int dy = 0; dy < h; dy++) {
-            int thread_id  = OMP_TID_;
-            ResizeBilinearOneRow(param, thread_id, rows0_t, rows1_t, prev_sy, b, w, h, stride, dy);
-        }
+        ParallelForWithThreadId(0, h, [&](int dy, int thread_id) {
+            ResizeBilinearOneRow(param, thread_id, rows0_t.data(), rows1_t.data(), prev_sy.data(), b, w, h, stride, dy);
+        });
     }
 
     delete[] rows0;
@@ -487,12 +481,12 @@ void ResizeBilinearC4Impl(const uint8_t* src, int batch, int src_w, int src_h, i
     ResizeBilinearKernelParm param(xofs, yofs, ialpha, ibeta, src, dst, src_plane, src_stride, schannel);
 
     // loop body
-    int max_num_threads = OMP_MAX_THREADS_NUM_;
+    int max_num_threads = GetParallelMaxThreads();
     short* rows0        = new short[(w * 4) * max_num_threads];
     short* rows1        = new short[(w * 4) * max_num_threads];
-    short* rows0_t[max_num_threads];
-    short* rows1_t[max_num_threads];
-    int    prev_sy[max_num_threads];
+    std::vector<short*> rows0_t(max_num_threads);
+    std::vector<short*> rows1_t(max_num_threads);
+    std::vector<int> prev_sy(max_num_threads);
 
     for (int b = 0; b < batch; ++b) {
         for (int t = 0; t < max_num_threads; ++t) {
@@ -501,11 +495,9 @@ void ResizeBilinearC4Impl(const uint8_t* src, int batch, int src_w, int src_h, i
             rows1_t[t] = rows1 + t * (w * 4);
         }
 
-        OMP_PARALLEL_FOR_
-        for (int dy = 0; dy < h; dy++) {
-            int thread_id  = OMP_TID_;
-            ResizeBilinearOneRow(param, thread_id, rows0_t, rows1_t, prev_sy, b, w, h, stride, dy);
-        }
+        ParallelForWithThreadId(0, h, [&](int dy, int thread_id) {
+            ResizeBilinearOneRow(param, thread_id, rows0_t.data(), rows1_t.data(), prev_sy.data(), b, w, h, stride, dy);
+        });
     }
 
     delete[] rows0;
@@ -600,8 +592,7 @@ void ResizeNearestC1Impl(const uint8_t* src, int batch, int src_w, int src_h, in
 
     // loop body
     for (int b = 0; b < batch; ++b) {
-        OMP_PARALLEL_FOR_
-        for (int dy = 0; dy < h; dy++) {
+        ParallelFor(0, h, [&](int dy) {
             ResizeNearestLoopPreparation();
 #ifdef TNN_USE_NEON
             int32x4_t _sx = int32x4_t();
@@ -627,7 +618,7 @@ void ResizeNearestC1Impl(const uint8_t* src, int batch, int src_w, int src_h, in
                 int sx = xofs[dx];
                 Dp[dx] = (ialpha[dx] == 0) ? Sp[sx + 1] : Sp[sx];
             }
-        }
+        });
     }
 
     delete[] buf;
@@ -639,8 +630,7 @@ void ResizeNearestC2Impl(const uint8_t* src, int batch, int src_w, int src_h, in
 
     // loop body
     for (int b = 0; b < batch; ++b) {
-        OMP_PARALLEL_FOR_
-        for (int dy = 0; dy < h; dy++) {
+        ParallelFor(0, h, [&](int dy) {
             ResizeNearestLoopPreparation();
 #ifdef TNN_USE_NEON
             int32x4_t _sx   = int32x4_t();
@@ -670,7 +660,7 @@ void ResizeNearestC2Impl(const uint8_t* src, int batch, int src_w, int src_h, in
                 Dp[dx * 2]     = (ialpha[dx] == 0) ? Sp[sx + 2] : Sp[sx];
                 Dp[dx * 2 + 1] = (ialpha[dx] == 0) ? Sp[sx + 3] : Sp[sx + 1];
             }
-        }
+        });
     }
 
     delete[] buf;
@@ -682,8 +672,7 @@ void ResizeNearestC3Impl(const uint8_t* src, int batch, int src_w, int src_h, in
 
     // loop body
     for (int b = 0; b < batch; ++b) {
-        OMP_PARALLEL_FOR_
-        for (int dy = 0; dy < h; dy++) {
+        ParallelFor(0, h, [&](int dy) {
             ResizeNearestLoopPreparation();
 #ifdef TNN_USE_NEON
             int32x4_t _sx   = int32x4_t();
@@ -715,7 +704,7 @@ void ResizeNearestC3Impl(const uint8_t* src, int batch, int src_w, int src_h, in
                 Dp[dx * 3 + 1] = (ialpha[dx] == 0) ? Sp[sx + 4] : Sp[sx + 1];
                 Dp[dx * 3 + 2] = (ialpha[dx] == 0) ? Sp[sx + 5] : Sp[sx + 2];
             }
-        }
+        });
     }
 
     delete[] buf;
@@ -727,8 +716,7 @@ void ResizeNearestC4Impl(const uint8_t* src, int batch, int src_w, int src_h, in
 
     // loop body
     for (int b = 0; b < batch; ++b) {
-        OMP_PARALLEL_FOR_
-        for (int dy = 0; dy < h; dy++) {
+        ParallelFor(0, h, [&](int dy) {
             ResizeNearestLoopPreparation();
 #ifdef TNN_USE_NEON
             int32x4_t _sx   = int32x4_t();
@@ -762,7 +750,7 @@ void ResizeNearestC4Impl(const uint8_t* src, int batch, int src_w, int src_h, in
                 Dp[dx * 4 + 2] = (ialpha[dx] == 0) ? Sp[sx + 6] : Sp[sx + 2];
                 Dp[dx * 4 + 3] = (ialpha[dx] == 0) ? Sp[sx + 7] : Sp[sx + 3];
             }
-        }
+        });
     }
 
     delete[] buf;
@@ -1376,15 +1364,13 @@ static void WarpAffineBilinear(const uint8_t* src, int batch, int src_w, int src
     int* adelta = buffer;
     int* bdelta = buffer + dst_w * 2;
 
-    int max_num_threads = OMP_MAX_THREADS_NUM_;
+    int max_num_threads = GetParallelMaxThreads();
     int* buf_loc        = new int[dst_w * max_num_threads];
     short* tab_loc      = new short[dst_w * max_num_threads];
 
     const unsigned char* src2 = src + src_w * schannel;
 
-    OMP_PARALLEL_FOR_
-    for (int y = 0; y < dst_h * batch; ++y) {
-        int thread_id    = OMP_TID_;
+    ParallelForWithThreadId(0, dst_h * batch, [&](int y, int thread_id) {
         int x_count      = 0;
         int end_x        = 0;
         int dst_loc_base = y * dst_w * schannel;
@@ -1394,7 +1380,7 @@ static void WarpAffineBilinear(const uint8_t* src, int batch, int src_w, int src
         WarpAffinePrepareOneRow(buf_loc_t, tab_loc_t, adelta, bdelta, schannel, src, src_w, src_h,
                                 dst + dst_loc_base, dst_w, y % dst_h, (y / dst_h) * src_plane, x_count, end_x, border_val);
         WarpAffineCalculateOneRow(end_x - x_count + 1, end_x, schannel, dst_loc_base, buf_loc_t, tab_loc_t, src, src2, dst);
-    }
+    });
 
     delete[] buf_loc;
     delete[] tab_loc;
@@ -1454,8 +1440,7 @@ static void WarpAffineNearest(const uint8_t* src, int batch, int src_w, int src_
 
     int src_stride = src_w * schannel;
     int src_plane  = src_h * src_w * schannel;
-    OMP_PARALLEL_FOR_
-    for (int y = 0; y < dst_h * batch; ++y) {
+    ParallelFor(0, dst_h * batch, [&](int y) {
         int y_c = y / dst_h;
         int y_r = y % dst_h;
 
@@ -1528,7 +1513,7 @@ static void WarpAffineNearest(const uint8_t* src, int batch, int src_w, int src_
                 }
             }
         }
-    }
+    });
 
     free(buffer);
 }
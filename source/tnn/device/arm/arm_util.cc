@@ -24,7 +24,7 @@
 #include "tnn/device/arm/arm_common.h"
 #include "tnn/utils/bfp16.h"
 #include "tnn/utils/naive_compute.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 namespace arm {
@@ -627,82 +627,74 @@ bool HalfBlobCanIgnorePack(size_t channel, size_t hw) {
 }
 
 int PackInt32Blob(int32_t *dst, int32_t *src, size_t batch, size_t channel, size_t hw) {
-    OMP_PARALLEL_FOR_
-    for (int n = 0; n < batch; ++n) {
+    ParallelFor(0, batch, [&](int n) {
         auto dst_ptr_n = dst + n * ROUND_UP(channel, 4) * hw;
         auto src_ptr_n = src + n * channel * hw;
         PackC4(dst_ptr_n, src_ptr_n, hw, channel);
-    }
+    });
     return 0;
 }
 
 int UnpackInt32Blob(int32_t *dst, int32_t *src, size_t batch, size_t channel, size_t hw) {
-    OMP_PARALLEL_FOR_
-    for (int n = 0; n < batch; ++n) {
+    ParallelFor(0, batch, [&](int n) {
         auto dst_ptr_n = dst + n * channel * hw;
         auto src_ptr_n = src + n * ROUND_UP(channel, 4) * hw;
         UnpackC4(dst_ptr_n, src_ptr_n, hw, channel);
-    }
+    });
     return 0;
 }
 
 int PackFloatBlob(float *dst, float *src, size_t batch, size_t channel, size_t hw) {
-    OMP_PARALLEL_FOR_
-    for (int n = 0; n < batch; ++n) {
+    ParallelFor(0, batch, [&](int n) {
         auto dst_ptr_n = dst + n * ROUND_UP(channel, 4) * hw;
         auto src_ptr_n = src + n * channel * hw;
         PackC4(dst_ptr_n, src_ptr_n, hw, channel);
-    }
+    });
     return 0;
 }
 
 int UnpackFloatBlob(float *dst, float *src, size_t batch, size_t channel, size_t hw) {
-    OMP_PARALLEL_FOR_
-    for (int n = 0; n < batch; ++n) {
+    ParallelFor(0, batch, [&](int n) {
         auto dst_ptr_n = dst + n * channel * hw;
         auto src_ptr_n = src + n * ROUND_UP(channel, 4) * hw;
         UnpackC4(dst_ptr_n, src_ptr_n, hw, channel);
-    }
+    });
     return 0;
 }
 
 int PackFloatBlob(bfp16_t *dst, bfp16_t *src, size_t batch, size_t channel, size_t hw) {
-    OMP_PARALLEL_FOR_
-    for (int n = 0; n < batch; ++n) {
+    ParallelFor(0, batch, [&](int n) {
         auto dst_ptr_n = dst + n * ROUND_UP(channel, 4) * hw;
         auto src_ptr_n = src + n * channel * hw;
         PackC4(dst_ptr_n, src_ptr_n, hw, channel);
-    }
+    });
     return 0;
 }
 
 int UnpackFloatBlob(bfp16_t *dst, bfp16_t *src, size_t batch, size_t channel, size_t hw) {
-    OMP_PARALLEL_FOR_
-    for (int n = 0; n < batch; ++n) {
+    ParallelFor(0, batch, [&](int n) {
         auto dst_ptr_n = dst + n * channel * hw;
         auto src_ptr_n = src + n * ROUND_UP(channel, 4) * hw;
         UnpackC4(dst_ptr_n, src_ptr_n, hw, channel);
-    }
+    });
     return 0;
 }
 
 int PackHalfBlob(fp16_t *dst, fp16_t *src, size_t batch, size_t channel, size_t hw) {
-    OMP_PARALLEL_FOR_
-    for (int n = 0; n < batch; ++n) {
+    ParallelFor(0, batch, [&](int n) {
         auto dst_ptr_n = dst + n * ROUND_UP(channel, 8) * hw;
         auto src_ptr_n = src + n * channel * hw;
         PackC8(dst_ptr_n, src_ptr_n, hw, channel);
-    }
+    });
     return 0;
 }
 
 int UnpackHalfBlob(fp16_t *dst, fp16_t *src, size_t batch, size_t channel, size_t hw) {
-    OMP_PARALLEL_FOR_
-    for (int n = 0; n < batch; ++n) {
+    ParallelFor(0, batch, [&](int n) {
         auto dst_ptr_n = dst + n * channel * hw;
         auto src_ptr_n = src + n * ROUND_UP(channel, 8) * hw;
         UnpackC8(dst_ptr_n, src_ptr_n, hw, channel);
-    }
+    });
     return 0;
 }
 
@@ -24,7 +24,7 @@
 #include "tnn/interpreter/layer_param.h"
 #include "tnn/utils/bfp16.h"
 #include "tnn/utils/dims_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 
@@ -39,8 +39,7 @@ void CPU_ELEWISE(const std::vector<void *> &input_ptrs, const std::vector<DimsVe
     const int count        = DimsVectorUtils::Count(shape_output);
     float *output_data     = static_cast<float *>(output);
 
-    OMP_PARALLEL_FOR_
-    for(int offset = 0; offset< count; ++offset) {
+    ParallelFor(0, count, [&](int offset) {
         DimsVector output_index = DimsOffsetUtils::ConvertOffsetToIndex(shape_output, offset);
         float result;
         for (int i = 0; i < input_ptrs.size(); i++) {
@@ -61,7 +60,7 @@ void CPU_ELEWISE(const std::vector<void *> &input_ptrs, const std::vector<DimsVe
             }
         }
         output_data[offset] = result;
-    }
+    });
 }
 
 /*
@@ -24,7 +24,7 @@
 
 #include "tnn/core/common.h"
 #include "tnn/utils/dims_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 
@@ -39,8 +39,7 @@ void CPU_ELEMENT_WISE_COMPARE(const std::vector<void *> &input_ptrs, const std::
     T_OUT *output_data  = static_cast<T_OUT *>(output);
     ASSERT(input_ptrs.size() == 2);
 
-    OMP_PARALLEL_FOR_
-    for (int offset = 0; offset < count; ++offset) {
+    ParallelFor(0, count, [&](int offset) {
         DimsVector output_index = DimsOffsetUtils::ConvertOffsetToIndex(shape_output, offset);
         T_OUT result;
         T_IN inputs[2];
@@ -56,7 +55,7 @@ void CPU_ELEMENT_WISE_COMPARE(const std::vector<void *> &input_ptrs, const std::
             inputs[i] = input_data[input_offset];
         }
         output_data[offset] = op(inputs[0], inputs[1]);
-    }
+    });
 }
 
 
@@ -70,8 +69,7 @@ void CPU_ELEMENT_WISE(const std::vector<void *> &input_ptrs, const std::vector<D
     const int count = DimsVectorUtils::Count(shape_output);
     T_OUT *output_data  = static_cast<T_OUT *>(output);
 
-    OMP_PARALLEL_FOR_
-    for (int offset = 0; offset < count; ++offset) {
+    ParallelFor(0, count, [&](int offset) {
         DimsVector output_index = DimsOffsetUtils::ConvertOffsetToIndex(shape_output, offset);
         T_OUT result;
         for (int i = 0; i < input_ptrs.size(); i++) {
@@ -90,7 +88,7 @@ void CPU_ELEMENT_WISE(const std::vector<void *> &input_ptrs, const std::vector<D
             }
         }
         output_data[offset] = result;
-    }
+    });
 }
 
 template <typename T_IN_0, typename T_IN_1, typename T_IN_2, typename T_OUT>
@@ -99,8 +97,7 @@ void CPU_ELEMENT_WISE(const std::vector<void *> &input_ptrs, const std::vector<D
     const int count = DimsVectorUtils::Count(shape_output);
     T_OUT *output_data  = static_cast<T_OUT *>(output);
 
-    OMP_PARALLEL_FOR_
-    for (int offset = 0; offset < count; ++offset) {
+    ParallelFor(0, count, [&](int offset) {
         DimsVector output_index = DimsOffsetUtils::ConvertOffsetToIndex(shape_output, offset);
         
         T_IN_0 *input_data_0 = static_cast<T_IN_0 *>(input_ptrs[0]);
@@ -121,7 +118,7 @@ void CPU_ELEMENT_WISE(const std::vector<void *> &input_ptrs, const std::vector<D
         }
 
         output_data[offset] = op(input_data_0[input_offset[0]], input_data_1[input_offset[1]], input_data_2[input_offset[2]]);
-    }
+    });
 }
 
 // float add
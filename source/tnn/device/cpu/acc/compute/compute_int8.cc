@@ -18,7 +18,7 @@
 #include "tnn/utils/bfp16.h"
 #include "tnn/utils/dims_utils.h"
 #include "tnn/utils/naive_compute.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 
@@ -31,8 +31,7 @@ void CPU_INT8_CALCULATE(const std::vector<void *> &input_ptrs, const std::vector
     int channel = dims[1];
     int count   = DimsVectorUtils::Count(dims, 2, 4);
     for (int n = 0; n < batch; n++) {
-        OMP_PARALLEL_FOR_
-        for (int c = 0; c < channel; c++) {
+        ParallelFor(0, channel, [&](int c) {
             int offset    = n * channel * count + c * count;
             int scale_idx = scale_len == 1 ? 0 : c;
             for (int hw = 0; hw < count; hw++) {
@@ -48,7 +47,7 @@ void CPU_INT8_CALCULATE(const std::vector<void *> &input_ptrs, const std::vector
                 }
                 static_cast<int8_t *>(output)[hw + offset] = float2int8(acc / scale_out[scale_idx]);
             }
-        }
+        });
     }
 }
 void CPU_INT8_BIAS_CALCULATE(const std::vector<void *> &input_ptrs, const std::vector<float *> &scale_ptrs,
@@ -58,8 +57,7 @@ void CPU_INT8_BIAS_CALCULATE(const std::vector<void *> &input_ptrs, const std::v
     int channel = dims[1];
     int count   = DimsVectorUtils::Count(dims, 2, 4);
     for (int n = 0; n < batch; n++) {
-        OMP_PARALLEL_FOR_
-        for (int c = 0; c < channel; c++) {
+        ParallelFor(0, channel, [&](int c) {
             int offset    = n * channel * count + c * count;
             int scale_idx = scale_len == 1 ? 0 : c;
             for (int hw = 0; hw < count; hw++) {
@@ -79,7 +77,7 @@ void CPU_INT8_BIAS_CALCULATE(const std::vector<void *> &input_ptrs, const std::v
                 static_cast<int8_t *>(output)[hw + offset] =
                     float2int8(acc / scale_out[scale_idx] + static_cast<float>(zero_point_out[scale_idx]));
             }
-        }
+        });
     }
 }
 
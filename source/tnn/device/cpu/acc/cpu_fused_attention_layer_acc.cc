@@ -0,0 +1,120 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include "tnn/device/cpu/acc/cpu_layer_acc.h"
+#include "tnn/utils/dims_utils.h"
+
+namespace TNN_NS {
+
+DECLARE_CPU_ACC(FusedAttention, LAYER_FUSED_ATTENTION);
+
+Status CpuFusedAttentionLayerAcc::Reshape(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
+    return TNN_OK;
+}
+
+Status CpuFusedAttentionLayerAcc::Forward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
+    auto param = dynamic_cast<FusedAttentionLayerParam *>(param_);
+    CHECK_PARAM_NULL(param);
+
+    if (inputs[0]->GetBlobDesc().data_type != DATA_TYPE_FLOAT) {
+        return Status(TNNERR_LAYER_ERR, "FusedAttention only support float");
+    }
+
+    auto q_dims      = inputs[0]->GetBlobDesc().dims;
+    auto k_dims      = inputs[1]->GetBlobDesc().dims;
+    auto v_dims      = inputs[2]->GetBlobDesc().dims;
+    auto output_dims = outputs[0]->GetBlobDesc().dims;
+    const int rank   = (int)output_dims.size();
+    const int S_q    = output_dims[rank - 2];
+    // q of a single row is broadcast by the rows of the mask
+    const int q_row_stride = q_dims[q_dims.size() - 2] == 1 ? 0 : q_dims[q_dims.size() - 1];
+    const int D      = q_dims[q_dims.size() - 1];
+    const int S_k    = k_dims[k_dims.size() - 1];
+    const int D_v    = v_dims[v_dims.size() - 1];
+    const int batch  = DimsVectorUtils::Count(output_dims, 0, rank - 2);
+
+    float *q_data      = static_cast<float *>(inputs[0]->GetHandle().base);
+    float *k_data      = static_cast<float *>(inputs[1]->GetHandle().base);
+    float *v_data      = static_cast<float *>(inputs[2]->GetHandle().base);
+    float *output_data = static_cast<float *>(outputs[0]->GetHandle().base);
+
+    // batch dims of q, k, v and mask broadcast to those of the output
+    DimsVector batch_dims(output_dims.begin(), output_dims.end() - 2);
+    auto q_offsets = DimsFunctionUtils::BroadcastMatrixOffsets(q_dims, batch_dims);
+    auto k_offsets = DimsFunctionUtils::BroadcastMatrixOffsets(k_dims, batch_dims);
+    auto v_offsets = DimsFunctionUtils::BroadcastMatrixOffsets(v_dims, batch_dims);
+
+    // mask broadcasts to [batch..., S_q, S_k]
+    float *mask_data = nullptr;
+    std::vector<int> mask_offsets;
+    int mask_row_stride = 0;
+    int mask_col_stride = 0;
+    if (inputs.size() > 3) {
+        mask_data      = static_cast<float *>(inputs[3]->GetHandle().base);
+        auto mask_dims = inputs[3]->GetBlobDesc().dims;
+        mask_offsets   = DimsFunctionUtils::BroadcastMatrixOffsets(mask_dims, batch_dims);
+        const int mask_rows = mask_dims.size() < 2 ? 1 : mask_dims[mask_dims.size() - 2];
+        const int mask_cols = mask_dims.back();
+        mask_row_stride     = mask_rows == 1 ? 0 : mask_cols;
+        mask_col_stride     = mask_cols == 1 ? 0 : 1;
+    }
+
+    std::vector<float> scores(S_k);
+    for (int b = 0; b < batch; b++) {
+        const float *q    = q_data + q_offsets[b];
+        const float *k    = k_data + k_offsets[b];
+        const float *v    = v_data + v_offsets[b];
+        float *output     = output_data + b * S_q * D_v;
+        const float *mask = mask_data ? mask_data + mask_offsets[b] : nullptr;
+
+        for (int i = 0; i < S_q; i++) {
+            float max_score = -FLT_MAX;
+            for (int j = 0; j < S_k; j++) {
+                double sum = 0;
+                for (int d = 0; d < D; d++) {
+                    sum += double(q[i * q_row_stride + d]) * double(k[d * S_k + j]);
+                }
+                scores[j] = float(sum) * param->scale;
+                if (mask) {
+                    scores[j] += mask[i * mask_row_stride + j * mask_col_stride];
+                }
+                max_score = std::max(max_score, scores[j]);
+            }
+
+            double sum_exp = 0;
+            for (int j = 0; j < S_k; j++) {
+                scores[j] = expf(scores[j] - max_score);
+                sum_exp += scores[j];
+            }
+
+            for (int d = 0; d < D_v; d++) {
+                double sum = 0;
+                for (int j = 0; j < S_k; j++) {
+                    sum += double(scores[j]) * double(v[j * D_v + d]);
+                }
+                output[i * D_v + d] = float(sum / sum_exp);
+            }
+        }
+    }
+
+    return TNN_OK;
+}
+
+REGISTER_CPU_ACC(FusedAttention, LAYER_FUSED_ATTENTION);
+
+}  // namespace TNN_NS
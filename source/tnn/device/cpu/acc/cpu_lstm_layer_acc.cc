@@ -30,6 +30,8 @@ private:
     std::shared_ptr<float> w_ = nullptr;
     std::shared_ptr<float> r_ = nullptr;
     std::shared_ptr<float> b_ = nullptr;
+    // h_t and c_t of the last forward in streaming mode
+    std::vector<float> state_;
 };
 
 static Status LSTM_Single(const float *x, float *y, const float *w, const float *r, const float *b,
@@ -278,9 +280,16 @@ Status CpuLSTMONNXLayerAcc::Forward(const std::vector<Blob *> &inputs, const std
     } else {
         memset(c_t, 0, num_directions * batch * hidden_size * sizeof(float));
     }
+
+    const int state_count = num_directions * batch * hidden_size;
+    if (layer_param->streaming && state_.size() == 2 * state_count) {
+        memcpy((void *)h_t, state_.data(), state_count * sizeof(float));
+        memcpy((void *)c_t, state_.data() + state_count, state_count * sizeof(float));
+    }
+    Status status = TNN_OK;
     
     if (layer_param->direction == 0 || layer_param->direction == 1) {
-        return LSTM_Single(x, y, w, r, b, h_t, c_t, T, batch, input_size, hidden_size, layer_param->direction);
+        status = LSTM_Single(x, y, w, r, b, h_t, c_t, T, batch, input_size, hidden_size, layer_param->direction);
     } else if (layer_param->direction == 2) {
         //Y shape [num_directions sequence batch_size hidden_size]
         auto y_temp = std::shared_ptr<float>(new float[num_directions*T*batch*hidden_size], [](float* p) { delete[] p; });
@@ -308,8 +317,12 @@ Status CpuLSTMONNXLayerAcc::Forward(const std::vector<Blob *> &inputs, const std
         return Status(TNNERR_PARAM_ERR, "LSTMONNX has invalid direction param");
     }
 
-  
-    return TNN_OK;
+    if (layer_param->streaming) {
+        state_.resize(2 * state_count);
+        memcpy(state_.data(), h_t, state_count * sizeof(float));
+        memcpy(state_.data() + state_count, c_t, state_count * sizeof(float));
+    }
+    return status;
 }
 
 REGISTER_CPU_ACC(LSTMONNX, LAYER_LSTMONNX);
@@ -19,7 +19,7 @@
 #include "tnn/utils/data_type_utils.h"
 #include "tnn/utils/dims_utils.h"
 #include "tnn/utils/naive_compute.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 
@@ -41,8 +41,7 @@ static inline int upsample_nearest2d(float *output_data, const float *input_data
     const float height_scale = (float)input_height / (float)output_height;
     const float width_scale  = (float)input_width / (float)output_width;
 
-    OMP_PARALLEL_FOR_
-    for (int i = 0; i < channels; ++i) {
+    ParallelFor(0, channels, [&](int i) {
         int output_index  = i * output_height * output_width;
         int input_index_i = i * input_height * input_width;
         for (int j = 0; j < output_height; ++j) {
@@ -53,7 +52,7 @@ static inline int upsample_nearest2d(float *output_data, const float *input_data
                 output_data[output_index++] = input_data[input_index_j + scaled_u];
             }
         }
-    }
+    });
 
     return 0;
 }
@@ -73,8 +72,7 @@ static inline int upsample_bilinear2d(float *output_data, const float *input_dat
     if (align_corners) {
         const float rheight = (output_height > 1) ? (float)(input_height - 1) / (output_height - 1) : 0.f;
         const float rwidth  = (output_width > 1) ? (float)(input_width - 1) / (output_width - 1) : 0.f;
-        OMP_PARALLEL_FOR_
-        for (int h2 = 0; h2 < output_height; ++h2) {
+        ParallelFor(0, output_height, [&](int h2) {
             const float h1r = rheight * h2;
 
             const int h1         = static_cast<int>(h1r);
@@ -97,13 +95,12 @@ static inline int upsample_bilinear2d(float *output_data, const float *input_dat
                     Ydata += output_width * output_height;
                 }
             }
-        }
+        });
     } else {
         const float rheight = (output_height > 1) ? (float)(input_height) / (output_height) : 0.f;
         const float rwidth  = (output_width > 1) ? (float)(input_width) / (output_width) : 0.f;
 
-        OMP_PARALLEL_FOR_
-        for (int h2 = 0; h2 < output_height; ++h2) {
+        ParallelFor(0, output_height, [&](int h2) {
             float h1r = static_cast<float>(rheight * (h2 + 0.5) - 0.5);
             h1r = h1r >= 0 ? h1r : 0;
             h1r = (h1r < input_height - 1) ? h1r : input_height - 1;
@@ -133,7 +130,7 @@ static inline int upsample_bilinear2d(float *output_data, const float *input_dat
                     y_data_ptr += output_width * output_height;
                 }
             }
-        }
+        });
     }
 
     return 0;
@@ -163,8 +160,7 @@ static void upsample_cubic2d_impl(float *dst, const float *src, int sh, int sw,
 #define Clip(x,X) ( (x) >=0 ? ((x)<(X)?(x):((X)-1)) : 0 )
 #define SrcValueAt(c, h, w) (src[c*sh*sw+(Clip(h,sh))*sw+(Clip(w,sw))])
 
-        OMP_PARALLEL_FOR_
-        for (int h2 = 0; h2 < dh; ++h2) {
+        ParallelFor(0, dh, [&](int h2) {
             float h1 = static_cast<float>(align_corners ? h_scale * h2 : h_scale * (h2 + 0.5) - 0.5);
             int hh = std::floor(h1);
             float wy[4];
@@ -191,7 +187,7 @@ static void upsample_cubic2d_impl(float *dst, const float *src, int sh, int sw,
                     dst[(c * dh + h2) * dw + w2] = sum;
                 }
             }
-        }
+        });
 #undef Clip
 #undef SrcValueAt
 }
@@ -13,7 +13,7 @@
 // specific language governing permissions and limitations under the License.
 
 #include "tnn/device/cpu/cpu_context.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 
@@ -31,12 +31,17 @@ Status CpuContext::ShareCommandQueue(Context* context) {
 
 Status CpuContext::OnInstanceForwardBegin() {
     Context::OnInstanceForwardBegin();
-    OMP_SET_THREADS_(GetNumThreads());
+    // the pool is created on first forward after the threads or affinity change
+    if (!parallel_pool_ || parallel_pool_->GetNumThreads() != GetNumThreads() ||
+        parallel_pool_->GetCpuAffinity() != GetCpuAffinity()) {
+        parallel_pool_ = std::make_shared<ParallelForPool>(GetNumThreads(), GetCpuAffinity());
+    }
+    BindParallelForPool(parallel_pool_);
     return TNN_OK;
 }
 
 Status CpuContext::SetNumThreads(int num_threads) {
-    num_threads_ = MIN(MAX(num_threads, 1), OMP_CORES_);
+    num_threads_ = MIN(MAX(num_threads, 1), GetCpuCount());
     return TNN_OK;
 }
 
@@ -45,6 +50,7 @@ int CpuContext::GetNumThreads() {
 }
 
 Status CpuContext::OnInstanceForwardEnd() {
+    BindParallelForPool(nullptr);
     return TNN_OK;
 }
 
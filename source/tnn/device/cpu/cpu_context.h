@@ -19,6 +19,7 @@
 #include <vector>
 
 #include "tnn/core/context.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 
@@ -51,6 +52,7 @@ public:
 
 private:
     int num_threads_ = 1;
+    std::shared_ptr<ParallelForPool> parallel_pool_ = nullptr;
 };
 
 }  // namespace TNN_NS
@@ -14,9 +14,11 @@
 
 #ifndef Float4_hpp
 #define Float4_hpp
+#include <cstring>
 #include "tnn/core/macro.h"
 #include "tnn/device/x86/x86_common.h"
 #include "tnn/device/x86/acc/sse_mathfun.h"
+#include "tnn/utils/half_utils.h"
 
 #if defined(__GNUC__) && !defined(__llvm__)
 #if __GNUC__ < 5
@@ -118,6 +120,46 @@ struct Float4 {
         v.value = _mm_loadu_ps(addr);
         return v;
     }
+    // widen 4 bfp16, bfp16 is the high half of fp32
+    static Float4 load_bf16(const uint16_t* addr) {
+        __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(addr));
+        Float4 dst;
+        dst.value = _mm_castsi128_ps(_mm_unpacklo_epi16(_mm_setzero_si128(), v));
+        return dst;
+    }
+    // widen 4 half, needs f16c
+    static Float4 load_half(const uint16_t* addr) {
+        Float4 dst;
+#ifdef __F16C__
+        dst.value = _mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(addr)));
+#else
+        float buf[4];
+        ConvertFromHalfToFloat(const_cast<uint16_t*>(addr), buf, 4);
+        dst.value = _mm_loadu_ps(buf);
+#endif
+        return dst;
+    }
+    // widen 4 int8
+    static Float4 load_int8(const int8_t* addr) {
+        int32_t bits;
+        memcpy(&bits, addr, sizeof(bits));
+        Float4 dst;
+        dst.value = _mm_cvtepi32_ps(_mm_cvtepi8_epi32(_mm_cvtsi32_si128(bits)));
+        return dst;
+    }
+    // widen 4 int4 stored with an offset of 8 in 2 bytes, the low nibble holds the even element
+    static Float4 load_int4(const uint8_t* addr) {
+        uint16_t bits;
+        memcpy(&bits, addr, sizeof(bits));
+        __m128i v    = _mm_cvtsi32_si128(bits);
+        __m128i mask = _mm_set1_epi8(0x0f);
+        __m128i lo   = _mm_and_si128(v, mask);
+        __m128i hi   = _mm_and_si128(_mm_srli_epi16(v, 4), mask);
+        __m128i q    = _mm_sub_epi8(_mm_unpacklo_epi8(lo, hi), _mm_set1_epi8(8));
+        Float4 dst;
+        dst.value = _mm_cvtepi32_ps(_mm_cvtepi8_epi32(q));
+        return dst;
+    }
     static void save(float* addr, const Float4& v) {
         _mm_store_ps(addr, v.value);
     }
@@ -14,8 +14,10 @@
 
 #ifndef Float8_hpp
 #define Float8_hpp
+#include <cstring>
 #include "tnn/core/macro.h"
 #include "tnn/device/x86/x86_common.h"
+#include "tnn/utils/half_utils.h"
 #ifdef __AVX__
 #include "tnn/device/x86/acc/avx_mathfun.h"
 #include "tnn/device/x86/acc/sse_mathfun.h"
@@ -67,6 +69,50 @@ struct Float8 {
         v.value = _mm256_loadu_ps(addr);
         return v;
     }
+    // widen 8 bfp16, bfp16 is the high half of fp32
+    static Float8 load_bf16(const uint16_t* addr) {
+        __m128i v    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(addr));
+        __m128i zero = _mm_setzero_si128();
+        __m128 lo    = _mm_castsi128_ps(_mm_unpacklo_epi16(zero, v));
+        __m128 hi    = _mm_castsi128_ps(_mm_unpackhi_epi16(zero, v));
+        Float8 dst;
+        dst.value = _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+        return dst;
+    }
+    // widen 8 half, needs f16c
+    static Float8 load_half(const uint16_t* addr) {
+        Float8 dst;
+#ifdef __F16C__
+        dst.value = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(addr)));
+#else
+        float buf[8];
+        ConvertFromHalfToFloat(const_cast<uint16_t*>(addr), buf, 8);
+        dst.value = _mm256_loadu_ps(buf);
+#endif
+        return dst;
+    }
+    // widen 8 int8
+    static Float8 load_int8(const int8_t* addr) {
+        return widen_int8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(addr)));
+    }
+    // widen 8 int4 stored with an offset of 8 in 4 bytes, the low nibble holds the even element
+    static Float8 load_int4(const uint8_t* addr) {
+        int32_t bits;
+        memcpy(&bits, addr, sizeof(bits));
+        __m128i v    = _mm_cvtsi32_si128(bits);
+        __m128i mask = _mm_set1_epi8(0x0f);
+        __m128i lo   = _mm_and_si128(v, mask);
+        __m128i hi   = _mm_and_si128(_mm_srli_epi16(v, 4), mask);
+        return widen_int8(_mm_sub_epi8(_mm_unpacklo_epi8(lo, hi), _mm_set1_epi8(8)));
+    }
+    // widen the low 8 int8 of v
+    static Float8 widen_int8(const __m128i& v) {
+        __m128i lo = _mm_cvtepi8_epi32(v);
+        __m128i hi = _mm_cvtepi8_epi32(_mm_srli_si128(v, 4));
+        Float8 dst;
+        dst.value = _mm256_cvtepi32_ps(_mm256_insertf128_si256(_mm256_castsi128_si256(lo), hi, 1));
+        return dst;
+    }
     static void save(float* addr, const Float8& v) {
         _mm256_store_ps(addr, v.value);
     }
@@ -97,22 +143,22 @@ struct Float8 {
     }
     static Float8 bsl_cle(const Float8& c1, const Float8& c2, const Float8& v1, const Float8& v2) {
         Float8 dst;
-        dst.value = _mm256_blendv_ps(v1.value, v2.value, _mm256_cmp_ps(c1.value, c2.value, _CMP_GE_OQ));
+        dst.value = _mm256_blendv_ps(v2.value, v1.value, _mm256_cmp_ps(c1.value, c2.value, _CMP_LE_OQ));
         return dst;
     }
     static Float8 bsl_clt(const Float8& c1, const Float8& c2, const Float8& v1, const Float8& v2) {
         Float8 dst;
-        dst.value = _mm256_blendv_ps(v1.value, v2.value, _mm256_cmp_ps(c1.value, c2.value, _CMP_GT_OQ));
+        dst.value = _mm256_blendv_ps(v2.value, v1.value, _mm256_cmp_ps(c1.value, c2.value, _CMP_LT_OQ));
         return dst;
     }
     static Float8 bsl_cge(const Float8& c1, const Float8& c2, const Float8& v1, const Float8& v2) {
         Float8 dst;
-        dst.value = _mm256_blendv_ps(v1.value, v2.value, _mm256_cmp_ps(c1.value, c2.value, _CMP_LE_OQ));
+        dst.value = _mm256_blendv_ps(v2.value, v1.value, _mm256_cmp_ps(c1.value, c2.value, _CMP_GE_OQ));
         return dst;
     }
     static Float8 bsl_cgt(const Float8& c1, const Float8& c2, const Float8& v1, const Float8& v2) {
         Float8 dst;
-        dst.value = _mm256_blendv_ps(v1.value, v2.value, _mm256_cmp_ps(c1.value, c2.value, _CMP_LT_OQ));
+        dst.value = _mm256_blendv_ps(v2.value, v1.value, _mm256_cmp_ps(c1.value, c2.value, _CMP_GT_OQ));
         return dst;
     }
     static Float8 max(const Float8& v1, const Float8& v2) {
@@ -146,12 +192,11 @@ struct Float8 {
         return dst;
     }
     static float reduce_add(const Float8& v) {
-        Float8 tmp;
-        tmp.value = _mm256_hadd_ps(v.value, v.value);
-        tmp.value = _mm256_hadd_ps(tmp.value, tmp.value);
-        float rst[8];
-        _mm256_store_ps(rst, tmp.value);
-        return rst[0];
+        // hadd works within the 128 bit lanes, add the high lane first
+        __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v.value), _mm256_extractf128_ps(v.value, 1));
+        sum        = _mm_hadd_ps(sum, sum);
+        sum        = _mm_hadd_ps(sum, sum);
+        return _mm_cvtss_f32(sum);
     }
     static Float8 neg(const Float8 &v) {
         Float8 dst;
@@ -157,6 +157,18 @@ void conv_gemm_config<a_t, b_t, c_t>::init_jit_kernel()
         REGISTER_KERNEL_M(8);
         REGISTER_KERNEL_M(16);
 
+#ifdef XBYAK64
+        // full 16 rows blocks go to the zmm kernels on avx512 cpus, tails keep the ymm ones
+        if (cpu_with_isa(avx512)) {
+            g_kernel_16[16][1] = std::make_shared<jit::conv_sgemm_avx512_16xi<1, 16, 6>>();
+            g_kernel_16[16][2] = std::make_shared<jit::conv_sgemm_avx512_16xi<2, 16, 6>>();
+            g_kernel_16[16][3] = std::make_shared<jit::conv_sgemm_avx512_16xi<3, 16, 6>>();
+            g_kernel_16[16][4] = std::make_shared<jit::conv_sgemm_avx512_16xi<4, 16, 6>>();
+            g_kernel_16[16][5] = std::make_shared<jit::conv_sgemm_avx512_16xi<5, 16, 6>>();
+            g_kernel_16[16][6] = std::make_shared<jit::conv_sgemm_avx512_16xi<6, 16, 6>>();
+        }
+#endif
+
 #ifdef TNN_JIT_DUMP_KERNEL
         for(int i=1;i<=nb_kernels_m;i++) {
             if (g_pack_t_ker[i]){
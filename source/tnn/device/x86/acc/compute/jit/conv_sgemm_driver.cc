@@ -22,7 +22,8 @@
 #include "tnn/device/x86/acc/compute/jit/conv_gemm_config.h"
 #include "tnn/device/x86/acc/compute/jit/utils/timer.hpp"
 #include "tnn/device/x86/acc/compute/jit/conv_sgemm_driver.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/data_type_utils.h"
+#include "tnn/utils/parallel_for.h"
 #include <xbyak/xbyak.h>
 
 namespace TNN_NS {
@@ -32,12 +33,13 @@ void conv_sgemm_block_n(
         const float * src_a, dim_t lda,
         const float * src_b, dim_t ldb,
         float * dst, dim_t ldc,
-        const float * bias, dim_t first, dim_t act_type,
+        const float * bias, dim_t first, const conv_gemm_epilogue *epilogue,
         conv_gemm_config<float, float, float> &conv_gemm_conf) 
 {
 
     dim_t K_c = conv_gemm_conf.K_c_;
     dim_t m_block = conv_gemm_conf.m_block_;
+    dim_t act_type = epilogue ? epilogue->kernel_act_type : 0;
 
     for(dim_t i=0;i<M;)  {
         dim_t cur_m = MIN(M - i, conv_gemm_conf.kernel_m_r_);
@@ -46,22 +48,20 @@ void conv_sgemm_block_n(
         const float * cur_b = src_b;
         float * cur_c = dst + i;
 
+        dim_t m_step;
         switch(cur_m) {
             case 1:
-                conv_gemm_conf.kernels_[1][N](K, cur_a, lda, cur_b, ldb, cur_c, ldc, bias, first, act_type);
-                i+=1;
+                m_step = 1;
                 break;
             case 2:
             case 3:
-                conv_gemm_conf.kernels_[2][N](K, cur_a, lda, cur_b, ldb, cur_c, ldc, bias, first, act_type);
-                i+=2;
+                m_step = 2;
                 break;
             case 4:
             case 5:
             case 6:
             case 7:
-                conv_gemm_conf.kernels_[4][N](K, cur_a, lda, cur_b, ldb, cur_c, ldc, bias, first, act_type);
-                i+=4;
+                m_step = 4;
                 break;
             case 8:
             case 9:
@@ -71,15 +71,39 @@ void conv_sgemm_block_n(
             case 13:
             case 14:
             case 15:
-                conv_gemm_conf.kernels_[8][N](K, cur_a, lda, cur_b, ldb, cur_c, ldc, bias, first, act_type);
-                i+=8;
+                m_step = 8;
                 break;
             default:
-                conv_gemm_conf.kernels_[16][N](K, cur_a, lda, cur_b, ldb, cur_c, ldc, bias, first, act_type);
-                i+=16;
+                m_step = 16;
                 break;
         }
+        conv_gemm_conf.kernels_[m_step][N](K, cur_a, lda, cur_b, ldb, cur_c, ldc, bias, first, act_type);
+
+        // the tile is still in L1 here
+        if (epilogue && epilogue->post_func) {
+            const float * cur_residual = epilogue->residual ? epilogue->residual + i : nullptr;
+            epilogue->post_func(cur_c, ldc, m_step, N, cur_residual, *epilogue);
+        }
+        i += m_step;
+    }
+}
+
+// epilogue of the tile at row i, col j of dst
+static inline const conv_gemm_epilogue *conv_tile_epilogue(
+        const conv_gemm_epilogue *epilogue, dim_t i, dim_t j, dim_t ldc,
+        conv_gemm_epilogue &tile)
+{
+    if (!epilogue || !epilogue->post_func) {
+        return epilogue;
+    }
+    tile = *epilogue;
+    if (tile.residual) {
+        tile.residual += i + j * ldc;
+    }
+    if (tile.scale) {
+        tile.scale += j;
     }
+    return &tile;
 }
 
 // sgemm col_major a no_trans, b no_trans
@@ -104,7 +128,9 @@ void conv_sgemm_nn_col_major(
     i = j = k = 0;
 
     dim_t first = 0;
-    dim_t post_type;
+    conv_gemm_epilogue act_epilogue;
+    act_epilogue.kernel_act_type = act_type;
+    const conv_gemm_epilogue *post_epilogue;
 
     auto pack_a_buf = pack_buf;
     auto pack_b_buf = pack_buf + divUp(M_c * K_c * sizeof(float), 32) / sizeof(float);
@@ -116,9 +142,9 @@ void conv_sgemm_nn_col_major(
 
     for (k = 0; k < K; k += K_c)  {
         if (k + K_c >= K) {
-            post_type = act_type;
+            post_epilogue = &act_epilogue;
         } else {
-            post_type = 0;
+            post_epilogue = nullptr;
         }
 
         dim_t cur_k = MIN(K - k, K_c);
@@ -138,7 +164,9 @@ void conv_sgemm_nn_col_major(
 
                 const float * packed_cur_b = pack_b_buf + divDown(j, n_block) * K_c + j % n_block;
                 const float * cur_bias = bias + j;
-                conv_sgemm_block_n(cur_m, cur_n, cur_k, pack_a_buf, lda, packed_cur_b, ldb, cur_c, ldc, cur_bias, first, post_type, conv_gemm_conf);
+                conv_gemm_epilogue tile_epilogue;
+                auto cur_epilogue = conv_tile_epilogue(post_epilogue, i, j, ldc, tile_epilogue);
+                conv_sgemm_block_n(cur_m, cur_n, cur_k, pack_a_buf, lda, packed_cur_b, ldb, cur_c, ldc, cur_bias, first, cur_epilogue, conv_gemm_conf);
                 j += cur_n;
             }
         }
@@ -159,6 +187,63 @@ void conv_sgemm_nn_col_major_prepack_b(
         const float * bias, dim_t act_type,
         float *src_trans_buf,
         conv_gemm_config<float, float, float> &conv_gemm_conf)
+{
+    conv_gemm_epilogue epilogue;
+    epilogue.kernel_act_type = act_type;
+    conv_sgemm_nn_col_major_prepack_b(M, N, K, src_a, lda, src_b, ldb, dst, ldc,
+                                      bias, epilogue, src_trans_buf, conv_gemm_conf);
+}
+
+// sgemm col_major a no_trans, b no_trans, with epilogue
+// src_a: M * K, lda = M
+// src_b: K * N, ldb = K, prepacked
+// dst  : M * N, ldc = M
+void conv_sgemm_nn_col_major_prepack_b(
+        dim_t M, dim_t N, dim_t K,
+        const float * src_a, dim_t lda,
+        const float * src_b, dim_t ldb,
+        float * dst, dim_t ldc,
+        const float * bias, const conv_gemm_epilogue &epilogue,
+        float *src_trans_buf,
+        conv_gemm_config<float, float, float> &conv_gemm_conf)
+{
+    conv_gemm_packed_weight packed_b;
+    packed_b.data = src_b;
+    conv_sgemm_nn_col_major_prepack_b(M, N, K, src_a, lda, packed_b, ldb, dst, ldc,
+                                      bias, epilogue, src_trans_buf, conv_gemm_conf);
+}
+
+// K block at k of the prepacked weights in fp32, expanded into block_buf if stored in other types.
+// the weights have cols_round_up rows or cols, packed in panels of K_c * block.
+static const float *conv_packed_weight_block(
+        const conv_gemm_packed_weight &weight, dim_t k, dim_t cols_round_up,
+        dim_t block, dim_t K_c)
+{
+    if (weight.data_type == DATA_TYPE_FLOAT) {
+        return reinterpret_cast<const float *>(weight.data) + k * cols_round_up;
+    }
+    const size_t data_bytes = DataTypeUtils::GetBytesSize(weight.data_type);
+    auto src_k = reinterpret_cast<const char *>(weight.data) + k * cols_round_up * data_bytes;
+    dim_t panel_size = K_c * block;
+    ParallelFor(0, cols_round_up / block, [&](int p) {
+        weight.unpack_func(src_k + p * panel_size * data_bytes, weight.block_buf + p * panel_size,
+                           panel_size, weight.data_type);
+    });
+    return weight.block_buf;
+}
+
+// sgemm col_major a no_trans, b no_trans, with epilogue
+// src_a: M * K, lda = M
+// src_b: K * N, ldb = K, prepacked in fp32 or 16 bits
+// dst  : M * N, ldc = M
+void conv_sgemm_nn_col_major_prepack_b(
+        dim_t M, dim_t N, dim_t K,
+        const float * src_a, dim_t lda,
+        const conv_gemm_packed_weight &src_b, dim_t ldb,
+        float * dst, dim_t ldc,
+        const float * bias, const conv_gemm_epilogue &epilogue,
+        float *src_trans_buf,
+        conv_gemm_config<float, float, float> &conv_gemm_conf)
 {
     dim_t M_c = conv_gemm_conf.M_c_;
     dim_t K_c = conv_gemm_conf.K_c_;
@@ -166,7 +251,7 @@ void conv_sgemm_nn_col_major_prepack_b(
     dim_t n_block = conv_gemm_conf.n_block_;
 
     dim_t first = 0;
-    dim_t post_type;
+    const conv_gemm_epilogue *post_epilogue;
 
     // if no bias, first set to 1, load c from dst
     if (bias == nullptr) {
@@ -175,19 +260,18 @@ void conv_sgemm_nn_col_major_prepack_b(
 
     for (dim_t k = 0; k < K; k += K_c)  {
         if (k + K_c >= K) {
-            post_type = act_type;
+            post_epilogue = &epilogue;
         } else {
-            post_type = 0;
+            post_epilogue = nullptr;
         }
 
         dim_t cur_k = MIN(K - k, K_c);
 
         // pack b -> K_c * N;
-        const float *pack_b_k = src_b + k * divUp(N, n_block);
+        const float *pack_b_k = conv_packed_weight_block(src_b, k, divUp(N, n_block), n_block, K_c);
 
-        OMP_PARALLEL_FOR_DYNAMIC_
-        for (dim_t i = 0; i < M; i += M_c)  {
-            int thread_id = OMP_TID_;
+        ParallelForWithThreadId(0, UP_DIV(M, M_c), [&](int i_i, int thread_id) {
+            dim_t i = i_i * M_c;
             auto src_trans_per_t = src_trans_buf + thread_id * M_c * K_c;
             dim_t cur_m = MIN(M - i, M_c);
             // pack a -> M_c * K_c;
@@ -199,10 +283,12 @@ void conv_sgemm_nn_col_major_prepack_b(
 
                 const float * packed_cur_b = pack_b_k + divDown(j, n_block) * K_c + j % n_block;
                 const float * cur_bias = bias + j;
-                conv_sgemm_block_n(cur_m, cur_n, cur_k, src_trans_per_t, lda, packed_cur_b, ldb, cur_c, ldc, cur_bias, first, post_type, conv_gemm_conf);
+                conv_gemm_epilogue tile_epilogue;
+                auto cur_epilogue = conv_tile_epilogue(post_epilogue, i, j, ldc, tile_epilogue);
+                conv_sgemm_block_n(cur_m, cur_n, cur_k, src_trans_per_t, lda, packed_cur_b, ldb, cur_c, ldc, cur_bias, first, cur_epilogue, conv_gemm_conf);
                 j += cur_n;
             }
-        }
+        });
         // if k != 0, first = 1
         first = 1;
     }
@@ -230,7 +316,9 @@ void conv_sgemm_tn_col_major_prepack_b(
     i = j = k = 0;
 
     dim_t first = 0;
-    dim_t post_type;
+    conv_gemm_epilogue act_epilogue;
+    act_epilogue.kernel_act_type = act_type;
+    const conv_gemm_epilogue *post_epilogue;
 
     // if no bias, first set to 1, load c from dst
     if (bias == nullptr) {
@@ -239,9 +327,9 @@ void conv_sgemm_tn_col_major_prepack_b(
 
     for (k = 0; k < K; k += K_c)  {
         if (k + K_c >= K) {
-            post_type = act_type;
+            post_epilogue = &act_epilogue;
         } else {
-            post_type = 0;
+            post_epilogue = nullptr;
         }
 
         dim_t cur_k = MIN(K - k, K_c);
@@ -260,7 +348,9 @@ void conv_sgemm_tn_col_major_prepack_b(
 
                 const float * packed_cur_b = pack_b_k + divDown(j, n_block) * K_c + j % n_block;
                 const float * cur_bias = bias + j;
-                conv_sgemm_block_n(cur_m, cur_n, cur_k, src_trans_buf, lda, packed_cur_b, ldb, cur_c, ldc, cur_bias, first, post_type, conv_gemm_conf);
+                conv_gemm_epilogue tile_epilogue;
+                auto cur_epilogue = conv_tile_epilogue(post_epilogue, i, j, ldc, tile_epilogue);
+                conv_sgemm_block_n(cur_m, cur_n, cur_k, src_trans_buf, lda, packed_cur_b, ldb, cur_c, ldc, cur_bias, first, cur_epilogue, conv_gemm_conf);
                 j += cur_n;
             }
         }
@@ -281,6 +371,25 @@ void conv_sgemm_tn_col_major_prepack_a(
         const float * bias, dim_t act_type,
         float *pack_b_buf,
         conv_gemm_config<float, float, float> &conv_gemm_conf)
+{
+    conv_gemm_packed_weight packed_a;
+    packed_a.data = src_a;
+    conv_sgemm_tn_col_major_prepack_a(M, N, K, packed_a, lda, src_b, ldb, dst, ldc,
+                                      bias, act_type, pack_b_buf, conv_gemm_conf);
+}
+
+// sgemm col_major a trans, b no_trans
+// src_a: K * M, lda = K, prepacked in fp32 or 16 bits
+// src_b: K * N, ldb = K
+// dst  : M * N, ldc = M
+void conv_sgemm_tn_col_major_prepack_a(
+        dim_t M, dim_t N, dim_t K,
+        const conv_gemm_packed_weight &src_a, dim_t lda,
+        const float * src_b, dim_t ldb,
+        float * dst, dim_t ldc,
+        const float * bias, dim_t act_type,
+        float *pack_b_buf,
+        conv_gemm_config<float, float, float> &conv_gemm_conf)
 {
     dim_t M_c = conv_gemm_conf.M_c_;
     dim_t K_c = conv_gemm_conf.K_c_;
@@ -288,7 +397,9 @@ void conv_sgemm_tn_col_major_prepack_a(
     dim_t n_block = conv_gemm_conf.n_block_;
 
     dim_t first = 0;
-    dim_t post_type;
+    conv_gemm_epilogue act_epilogue;
+    act_epilogue.kernel_act_type = act_type;
+    const conv_gemm_epilogue *post_epilogue;
 
     // if no bias, first set to 1, load c from dst
     if (bias == nullptr) {
@@ -297,21 +408,22 @@ void conv_sgemm_tn_col_major_prepack_a(
 
     for (dim_t k = 0; k < K; k += K_c)  {
         if (k + K_c >= K) {
-            post_type = act_type;
+            post_epilogue = &act_epilogue;
         } else {
-            post_type = 0;
+            post_epilogue = nullptr;
         }
 
         dim_t cur_k = MIN(K - k, K_c);
 
         // pack b -> K_c * N;
         pack_col_b_n(src_b + k, ldb, pack_b_buf, K_c, cur_k, N, conv_gemm_conf);
+        const float *pack_a_k = conv_packed_weight_block(src_a, k, divUp(M, m_block), m_block, K_c);
 
-        OMP_PARALLEL_FOR_DYNAMIC_
-        for (dim_t i = 0; i < M; i += M_c)  {
+        ParallelFor(0, UP_DIV(M, M_c), [&](int i_i) {
+            dim_t i = i_i * M_c;
             dim_t cur_m = MIN(M - i, M_c);
             // pack a -> M_c * K_c;
-            auto src_a_i = src_a + k * divUp(M, m_block) + i * K_c;
+            auto src_a_i = pack_a_k + i * K_c;
 
             for (dim_t j = 0; j < N;)  {
                 dim_t cur_n = MIN(N - j, conv_gemm_conf.kernel_n_r_);
@@ -319,10 +431,12 @@ void conv_sgemm_tn_col_major_prepack_a(
 
                 const float * packed_cur_b = pack_b_buf + divDown(j, n_block) * K_c + j % n_block;
                 const float * cur_bias = bias + j;
-                conv_sgemm_block_n(cur_m, cur_n, cur_k, src_a_i, lda, packed_cur_b, ldb, cur_c, ldc, cur_bias, first, post_type, conv_gemm_conf);
+                conv_gemm_epilogue tile_epilogue;
+                auto cur_epilogue = conv_tile_epilogue(post_epilogue, i, j, ldc, tile_epilogue);
+                conv_sgemm_block_n(cur_m, cur_n, cur_k, src_a_i, lda, packed_cur_b, ldb, cur_c, ldc, cur_bias, first, cur_epilogue, conv_gemm_conf);
                 j += cur_n;
             }
-        }
+        });
         // if k != 0, first = 1
         first = 1;
     }
@@ -346,6 +460,30 @@ void conv_pack_col_b_n(
     }
 }
 
+// pack col major A no_trans [M x K]
+void conv_pack_col_a_n(
+    dim_t M, dim_t K,
+    const float * src, dim_t lda,
+    float * dst,
+    conv_gemm_config<float, float, float> &conv_gemm_conf)
+{
+    dim_t M_c = conv_gemm_conf.M_c_;
+    dim_t K_c = conv_gemm_conf.K_c_;
+    dim_t m_block = conv_gemm_conf.m_block_;
+
+    for (dim_t k = 0; k < K; k += K_c)  {
+        dim_t cur_k = MIN(K - k, K_c);
+        auto src_k = src + k * lda;
+        auto dst_k = dst + k * divUp(M, m_block);
+
+        for (dim_t i = 0; i < M; i += M_c)  {
+            dim_t cur_m = MIN(M - i, M_c);
+            // pack a -> M_c * K_c;
+            pack_col_a_n(src_k + i, lda, dst_k + i * K_c, K_c, cur_k, cur_m, conv_gemm_conf);
+        }
+    }
+}
+
 // pack col major A trans [K x M]
 void conv_pack_col_a_t(
     dim_t M, dim_t K,
@@ -21,6 +21,48 @@
 
 namespace TNN_NS {
 
+struct conv_gemm_epilogue;
+
+// post ops on a col major tile [rows x cols], cols are output channels
+typedef void (*conv_gemm_post_func_t)(float *dst, dim_t ldc, dim_t rows, dim_t cols,
+                                      const float *residual, const conv_gemm_epilogue &epilogue);
+
+// epilogue of the conv sgemm, applied to each output tile after its last K block
+// while the tile is still in cache. bias, relu and relu6 are done by the jit kernels,
+// the other ops by post_func in the order: scale, add, act, add, clip.
+struct conv_gemm_epilogue {
+    // act of the jit kernels, 0: none, 1: relu, 2: relu6
+    dim_t kernel_act_type = 0;
+    // nullptr if the jit kernels do all the work
+    conv_gemm_post_func_t post_func = nullptr;
+    // scale per output channel, nullptr if none
+    const float *scale = nullptr;
+    // residual with the layout of dst, nullptr if none
+    const float *residual = nullptr;
+    // residual is added before act if true, after act otherwise
+    bool add_before_act = true;
+    // ActivationType of post_func
+    int act_type = 0;
+    bool clip = false;
+    float clip_min = -FLT_MAX;
+    float clip_max = FLT_MAX;
+};
+
+// converts count values of data_type (DATA_TYPE_BFP16, DATA_TYPE_HALF or DATA_TYPE_INT8) to fp32
+typedef void (*conv_gemm_unpack_func_t)(const void *src, float *dst, size_t count, DataType data_type);
+
+// weights prepacked by conv_pack_col_b_n or conv_pack_col_a_t. data is the packed fp32 weights, or
+// them converted to bfp16 / half / int8. such weights are expanded to fp32 in block_buf one K block
+// at a time, so the jit kernels always compute and accumulate in fp32.
+struct conv_gemm_packed_weight {
+    const void *data = nullptr;
+    DataType data_type = DATA_TYPE_FLOAT;
+    conv_gemm_unpack_func_t unpack_func = nullptr;
+    // K_c_ * (rows or cols of the weights rounded up to the block size) floats, 32 bytes aligned,
+    // only used for weights not in fp32
+    float *block_buf = nullptr;
+};
+
 // sgemm col_major a no_trans, b no_trans
 void conv_sgemm_nn_col_major(
         dim_t M, dim_t N, dim_t K,
@@ -41,6 +83,26 @@ void conv_sgemm_nn_col_major_prepack_b(
         float * src_buf,
         conv_gemm_config<float, float, float> &conv_gemm_conf);
 
+// sgemm col_major a no_trans, b no_trans prepacked, with epilogue
+void conv_sgemm_nn_col_major_prepack_b(
+        dim_t M, dim_t N, dim_t K,
+        const float * src_a, dim_t lda,
+        const float * src_b, dim_t ldb,
+        float * dst, dim_t ldc,
+        const float * bias, const conv_gemm_epilogue &epilogue,
+        float * src_buf,
+        conv_gemm_config<float, float, float> &conv_gemm_conf);
+
+// sgemm col_major a no_trans, b no_trans prepacked in fp32 or 16 bits, with epilogue
+void conv_sgemm_nn_col_major_prepack_b(
+        dim_t M, dim_t N, dim_t K,
+        const float * src_a, dim_t lda,
+        const conv_gemm_packed_weight &src_b, dim_t ldb,
+        float * dst, dim_t ldc,
+        const float * bias, const conv_gemm_epilogue &epilogue,
+        float * src_buf,
+        conv_gemm_config<float, float, float> &conv_gemm_conf);
+
 // sgemm col_major a trans, b no_trans prepacked
 void conv_sgemm_tn_col_major_prepack_b(
         dim_t M, dim_t N, dim_t K,
@@ -61,6 +123,16 @@ void conv_sgemm_tn_col_major_prepack_a(
         float *src_trans_buf,
         conv_gemm_config<float, float, float> &conv_gemm_conf);
 
+// sgemm col_major a trans prepacked in fp32 or 16 bits, b no_trans
+void conv_sgemm_tn_col_major_prepack_a(
+        dim_t M, dim_t N, dim_t K,
+        const conv_gemm_packed_weight &src_a, dim_t lda,
+        const float * src_b, dim_t ldb,
+        float * dst, dim_t ldc,
+        const float * bias, dim_t act_type,
+        float *src_trans_buf,
+        conv_gemm_config<float, float, float> &conv_gemm_conf);
+
 // sgemm col_major pack b no_trans
 void conv_pack_col_b_n(
         dim_t N, dim_t K,
@@ -68,6 +140,13 @@ void conv_pack_col_b_n(
         float * dst,
         conv_gemm_config<float, float, float> &conv_gemm_conf);
 
+// sgemm col_major pack a no_trans
+void conv_pack_col_a_n(
+    dim_t M, dim_t K,
+    const float * src, dim_t lda,
+    float * dst,
+    conv_gemm_config<float, float, float> &conv_gemm_conf);
+
 // sgemm col_major pack a trans
 void conv_pack_col_a_t(
     dim_t M, dim_t K,
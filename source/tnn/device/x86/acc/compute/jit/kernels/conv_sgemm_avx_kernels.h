@@ -38,6 +38,7 @@
 #include "tnn/device/x86/acc/compute/jit/kernels/conv_sgemm_avx_4_i.h"
 #include "tnn/device/x86/acc/compute/jit/kernels/conv_sgemm_avx_2_i.h"
 #include "tnn/device/x86/acc/compute/jit/kernels/conv_sgemm_avx_1_i.h"
+#include "tnn/device/x86/acc/compute/jit/kernels/conv_sgemm_avx512_16_i.h"
 
 namespace TNN_NS {
 namespace jit {
@@ -40,6 +40,8 @@ bool cpu_with_isa(x86_isa_t arch) {
             return cpu.has(Cpu::tAVX512F)  && cpu.has(Cpu::tAVX512BW) &&
                    cpu.has(Cpu::tAVX512VL) && cpu.has(Cpu::tAVX512DQ) &&
                    cpu.has(Cpu::tAVX512_VNNI);
+        case f16c:
+            return cpu.has(Cpu::tF16C);
         default:
             return false;
     }
@@ -38,6 +38,7 @@ typedef enum {
     avx2,
     avx512,
     avx512_vnni,
+    f16c,
 } x86_isa_t;
 
 bool cpu_with_isa(x86_isa_t arch);
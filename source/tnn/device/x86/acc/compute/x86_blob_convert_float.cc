@@ -0,0 +1,266 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "tnn/device/x86/acc/compute/x86_blob_convert_float.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "tnn/core/macro.h"
+#include "tnn/device/x86/acc/Float4.h"
+#include "tnn/device/x86/acc/Float8.h"
+#include "tnn/device/x86/acc/compute/jit/utils/cpu_isa.h"
+#include "tnn/utils/parallel_for.h"
+
+namespace TNN_NS {
+
+// elements of a nchw plane handled by one task
+static const int kPlaneBlock = 4096;
+
+// the avx512 kernel is built with function target attributes like the vnni int8 gemm,
+// the rest of the file does not need to be compiled for avx512
+#if defined(__AVX2__) && defined(__GNUC__)
+#define TNN_X86_AVX512_CONVERT_ENABLE
+#endif
+
+// byte shuffles moving channel c of 8 interleaved u8 pixels to the low 8 bytes, pixels 0-3
+// come from the 16 bytes at the pixel block and pixels 4-7 from the 16 bytes at hi_offset.
+struct U8ChannelGather {
+    __m128i lo_mask;
+    __m128i hi_mask;
+    int hi_offset;
+    bool contiguous;
+};
+
+static bool IsU8GatherSupported(int mat_channel) {
+    return mat_channel == 1 || mat_channel == 3 || mat_channel == 4;
+}
+
+static U8ChannelGather CreateU8ChannelGather(int mat_channel, int c) {
+    U8ChannelGather gather;
+    gather.contiguous = mat_channel == 1;
+    // both loads stay inside the 8 * mat_channel bytes of the block
+    gather.hi_offset = mat_channel == 3 ? 8 : 16;
+    int8_t lo[16], hi[16];
+    std::fill(lo, lo + 16, (int8_t)-1);
+    std::fill(hi, hi + 16, (int8_t)-1);
+    for (int k = 0; k < 4; ++k) {
+        lo[k]     = (int8_t)(c + k * mat_channel);
+        hi[4 + k] = (int8_t)(c + (4 + k) * mat_channel - gather.hi_offset);
+    }
+    gather.lo_mask = _mm_loadu_si128((const __m128i *)lo);
+    gather.hi_mask = _mm_loadu_si128((const __m128i *)hi);
+    return gather;
+}
+
+static inline __m128i GatherU8x8(const uint8_t *src, const U8ChannelGather &gather) {
+    if (gather.contiguous) {
+        return _mm_loadl_epi64((const __m128i *)src);
+    }
+    __m128i lo = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)src), gather.lo_mask);
+    __m128i hi = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src + gather.hi_offset)), gather.hi_mask);
+    return _mm_or_si128(lo, hi);
+}
+
+// widen the low 8 bytes of v to 8 floats
+static inline void U8x8ToFloat(__m128i v, Float8 *dst) {
+#ifdef __AVX2__
+    dst[0].value = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(v));
+#else
+    __m256i v32 = _mm256_insertf128_si256(_mm256_castsi128_si256(_mm_cvtepu8_epi32(v)),
+                                          _mm_cvtepu8_epi32(_mm_srli_si128(v, 4)), 1);
+    dst[0].value = _mm256_cvtepi32_ps(v32);
+#endif
+}
+
+static inline void U8x8ToFloat(__m128i v, Float4 *dst) {
+    dst[0].value = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(v));
+    dst[1].value = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(v, 4)));
+}
+
+template <class T, int pack>
+static void MatToFloatBlobImpl(const uint8_t *src, float *dst, int batch, int height, int width, int mat_channel,
+                               int channel, const int *channel_map, const float *scale, const float *bias) {
+    const bool gather_supported = IsU8GatherSupported(mat_channel);
+    std::vector<U8ChannelGather> gathers;
+    for (int c = 0; gather_supported && c < channel; ++c) {
+        gathers.push_back(CreateU8ChannelGather(mat_channel, channel_map[c]));
+    }
+    ParallelForRange(0, batch * height, [&](int begin, int end, int thread_id) {
+        for (int row = begin; row < end; ++row) {
+            const int b            = row / height;
+            const int y            = row % height;
+            const uint8_t *src_row = src + (size_t)row * width * mat_channel;
+            for (int c = 0; c < channel; ++c) {
+                const uint8_t *src_c = src_row + channel_map[c];
+                float *dst_c         = dst + ((size_t)(b * channel + c) * height + y) * width;
+                const T scale_v(scale[c]);
+                const T bias_v(bias[c]);
+                int x = 0;
+                for (; gather_supported && x + 8 <= width; x += 8) {
+                    T v[8 / pack];
+                    U8x8ToFloat(GatherU8x8(src_row + x * mat_channel, gathers[c]), v);
+                    for (int k = 0; k < 8 / pack; ++k) {
+                        T res = bias_v;
+                        T::mla(res, v[k], scale_v);
+                        T::saveu(dst_c + x + k * pack, res);
+                    }
+                }
+                for (; x < width; ++x) {
+                    dst_c[x] = scale[c] * src_c[x * mat_channel] + bias[c];
+                }
+            }
+        }
+    });
+}
+
+#ifdef TNN_X86_AVX512_CONVERT_ENABLE
+// one channel of one row, 16 pixels per step
+__attribute__((target("avx512f")))
+static void MatRowToFloatAVX512(const uint8_t *src_row, float *dst_c, int width, int mat_channel,
+                                const U8ChannelGather &gather, const uint8_t *src_c, float scale, float bias) {
+    const __m512 scale_v = _mm512_set1_ps(scale);
+    const __m512 bias_v  = _mm512_set1_ps(bias);
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const uint8_t *src_x = src_row + x * mat_channel;
+        __m128i v8  = _mm_unpacklo_epi64(GatherU8x8(src_x, gather), GatherU8x8(src_x + 8 * mat_channel, gather));
+        __m512 v    = _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(v8));
+        _mm512_storeu_ps(dst_c + x, _mm512_fmadd_ps(v, scale_v, bias_v));
+    }
+    for (; x < width; ++x) {
+        dst_c[x] = scale * src_c[x * mat_channel] + bias;
+    }
+}
+
+static void MatToFloatBlobAVX512(const uint8_t *src, float *dst, int batch, int height, int width, int mat_channel,
+                                 int channel, const int *channel_map, const float *scale, const float *bias) {
+    std::vector<U8ChannelGather> gathers;
+    for (int c = 0; c < channel; ++c) {
+        gathers.push_back(CreateU8ChannelGather(mat_channel, channel_map[c]));
+    }
+    ParallelForRange(0, batch * height, [&](int begin, int end, int thread_id) {
+        for (int row = begin; row < end; ++row) {
+            const int b            = row / height;
+            const int y            = row % height;
+            const uint8_t *src_row = src + (size_t)row * width * mat_channel;
+            for (int c = 0; c < channel; ++c) {
+                float *dst_c = dst + ((size_t)(b * channel + c) * height + y) * width;
+                MatRowToFloatAVX512(src_row, dst_c, width, mat_channel, gathers[c], src_row + channel_map[c],
+                                    scale[c], bias[c]);
+            }
+        }
+    });
+}
+#endif
+
+template <class T, int pack>
+static void FloatBlobToMatImpl(const float *src, uint8_t *dst, int batch, int height, int width, int mat_channel,
+                               int channel, const int *channel_map, const float *scale, const float *bias) {
+    ParallelForRange(0, batch * height, [&](int begin, int end, int thread_id) {
+        // same rounding as saturate_cast of the default converter
+        const T zero_v(0.f);
+        const T half_v(0.5f);
+        const T max_v(255.f);
+        float buf[pack];
+        for (int row = begin; row < end; ++row) {
+            const int b      = row / height;
+            const int y      = row % height;
+            uint8_t *dst_row = dst + (size_t)row * width * mat_channel;
+            for (int c = 0; c < channel; ++c) {
+                const float *src_c = src + ((size_t)(b * channel + c) * height + y) * width;
+                uint8_t *dst_c     = dst_row + channel_map[c];
+                const T scale_v(scale[c]);
+                const T bias_v(bias[c]);
+                int x = 0;
+                for (; x + pack <= width; x += pack) {
+                    T res = bias_v;
+                    T::mla(res, T::loadu(src_c + x), scale_v);
+                    res = T::min(T::max(T::add(res, half_v), zero_v), max_v);
+                    T::saveu(buf, res);
+                    for (int k = 0; k < pack; ++k) {
+                        dst_c[(x + k) * mat_channel] = static_cast<uint8_t>(buf[k]);
+                    }
+                }
+                for (; x < width; ++x) {
+                    float res              = scale[c] * src_c[x] + bias[c] + 0.5f;
+                    dst_c[x * mat_channel] = static_cast<uint8_t>(std::min(std::max(res, 0.f), 255.f));
+                }
+            }
+        }
+    });
+}
+
+template <class T, int pack>
+static void NCHWFloatScaleBiasImpl(const float *src, float *dst, int batch, int channel, int hw, const float *scale,
+                                   const float *bias) {
+    const int block_count = UP_DIV(hw, kPlaneBlock);
+    ParallelForRange(0, batch * channel * block_count, [&](int begin, int end, int thread_id) {
+        for (int i = begin; i < end; ++i) {
+            const int plane    = i / block_count;
+            const int c        = plane % channel;
+            const int start    = (i % block_count) * kPlaneBlock;
+            const int count    = std::min(hw - start, kPlaneBlock);
+            const float *src_c = src + (size_t)plane * hw + start;
+            float *dst_c       = dst + (size_t)plane * hw + start;
+            const T scale_v(scale[c]);
+            const T bias_v(bias[c]);
+            int x = 0;
+            for (; x + pack <= count; x += pack) {
+                T res = bias_v;
+                T::mla(res, T::loadu(src_c + x), scale_v);
+                T::saveu(dst_c + x, res);
+            }
+            for (; x < count; ++x) {
+                dst_c[x] = scale[c] * src_c[x] + bias[c];
+            }
+        }
+    });
+}
+
+void X86MatToFloatBlob(const uint8_t *src, float *dst, int batch, int height, int width, int mat_channel,
+                       int channel, const int *channel_map, const float *scale, const float *bias) {
+#ifdef TNN_X86_AVX512_CONVERT_ENABLE
+    static const bool has_avx512 = cpu_with_isa(avx512);
+    if (has_avx512 && IsU8GatherSupported(mat_channel)) {
+        MatToFloatBlobAVX512(src, dst, batch, height, width, mat_channel, channel, channel_map, scale, bias);
+        return;
+    }
+#endif
+    if (cpu_with_isa(avx2) || cpu_with_isa(avx)) {
+        MatToFloatBlobImpl<Float8, 8>(src, dst, batch, height, width, mat_channel, channel, channel_map, scale, bias);
+    } else {
+        MatToFloatBlobImpl<Float4, 4>(src, dst, batch, height, width, mat_channel, channel, channel_map, scale, bias);
+    }
+}
+
+void X86FloatBlobToMat(const float *src, uint8_t *dst, int batch, int height, int width, int mat_channel,
+                       int channel, const int *channel_map, const float *scale, const float *bias) {
+    if (cpu_with_isa(avx2) || cpu_with_isa(avx)) {
+        FloatBlobToMatImpl<Float8, 8>(src, dst, batch, height, width, mat_channel, channel, channel_map, scale, bias);
+    } else {
+        FloatBlobToMatImpl<Float4, 4>(src, dst, batch, height, width, mat_channel, channel, channel_map, scale, bias);
+    }
+}
+
+void X86NCHWFloatScaleBias(const float *src, float *dst, int batch, int channel, int hw, const float *scale,
+                           const float *bias) {
+    if (cpu_with_isa(avx2) || cpu_with_isa(avx)) {
+        NCHWFloatScaleBiasImpl<Float8, 8>(src, dst, batch, channel, hw, scale, bias);
+    } else {
+        NCHWFloatScaleBiasImpl<Float4, 4>(src, dst, batch, channel, hw, scale, bias);
+    }
+}
+
+}  // namespace TNN_NS
@@ -0,0 +1,38 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef SOURCE_TNN_DEVICE_X86_ACC_X86_BLOB_CONVERT_FLOAT_H_
+#define SOURCE_TNN_DEVICE_X86_ACC_X86_BLOB_CONVERT_FLOAT_H_
+
+#include <cstdint>
+
+namespace TNN_NS {
+
+// @brief uint8 mat with mat_channel interleaved channels to nchw float blob, blob channel c reads mat channel
+// channel_map[c] as src * scale[c] + bias[c]. rows are split across threads.
+void X86MatToFloatBlob(const uint8_t *src, float *dst, int batch, int height, int width, int mat_channel,
+                       int channel, const int *channel_map, const float *scale, const float *bias);
+
+// @brief nchw float blob to uint8 mat with mat_channel interleaved channels, blob channel c is written to mat channel
+// channel_map[c] as saturate(src * scale[c] + bias[c]), mat channels not in channel_map are left untouched.
+void X86FloatBlobToMat(const float *src, uint8_t *dst, int batch, int height, int width, int mat_channel,
+                       int channel, const int *channel_map, const float *scale, const float *bias);
+
+// @brief dst = src * scale[c] + bias[c] for nchw float data, src and dst may be the same
+void X86NCHWFloatScaleBias(const float *src, float *dst, int batch, int channel, int hw, const float *scale,
+                           const float *bias);
+
+}  // namespace TNN_NS
+
+#endif  // SOURCE_TNN_DEVICE_X86_ACC_X86_BLOB_CONVERT_FLOAT_H_
@@ -15,8 +15,10 @@
 #include "tnn/device/x86/acc/compute/x86_compute.h"
 #include "tnn/device/x86/acc/Float8.h"
 #include "tnn/device/x86/acc/Float4.h"
+#include "tnn/utils/bfp16.h"
+#include "tnn/utils/half_utils.h"
 #include "tnn/utils/naive_compute.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 #include <algorithm>
 #include <cstring>
@@ -579,8 +581,7 @@ template<X86ReduceOpType type>
 void reduce_kernel(float * input, float * output, size_t outer_size, size_t inner_size, size_t reduce_size) 
 {
     for(long outer_idx = 0; outer_idx < outer_size; outer_idx++) {
-        OMP_PARALLEL_FOR_GUIDED_
-        for(long inner_idx = 0; inner_idx < inner_size; inner_idx++) {
+        ParallelFor(0, inner_size, [&](long inner_idx) {
             float acc = 0;
             if (type == X86ReduceOpType::kMIN) {
                 acc = FLT_MAX;
@@ -591,7 +592,7 @@ void reduce_kernel(float * input, float * output, size_t outer_size, size_t inne
                 acc = reduce_iter_op<type>(acc, input[i * inner_size + inner_idx]);
             }
             output[inner_idx] = reduce_final_op<type>(acc, float(reduce_size));
-        }
+        });
         input += reduce_size * inner_size;
         output += inner_size;
     }
@@ -822,16 +823,40 @@ template void DepthwiseConv<ActivationType_ReLU6, Float8, 8>(
     float* dst, const float* src, const float* weight, const float* bias, long width, long src_w_step, long fw, long fh,
     long dilate_x_step, long dilate_y_step, long height, long srcHStep, long dstHStep);
 
-template <int left, int oc_>
-void X86SgemvLeft(float* dst, const float* src, const float* weight, float *bias, size_t batch_stride) {
+// load one vector of sgemv weights stored in weight_type
+template <typename VEC, int weight_type>
+static inline VEC X86SgemvLoadWeight(const void* weight, size_t offset) {
+    if (weight_type == DATA_TYPE_BFP16) {
+        return VEC::load_bf16(reinterpret_cast<const uint16_t*>(weight) + offset);
+    } else if (weight_type == DATA_TYPE_HALF) {
+        return VEC::load_half(reinterpret_cast<const uint16_t*>(weight) + offset);
+    }
+    return VEC::load(reinterpret_cast<const float*>(weight) + offset);
+}
+
+template <int weight_type>
+static inline float X86SgemvWeightValue(const void* weight, size_t offset) {
+    if (weight_type == DATA_TYPE_BFP16) {
+        return float(reinterpret_cast<const bfp16_t*>(weight)[offset]);
+    } else if (weight_type == DATA_TYPE_HALF) {
+        float value;
+        ConvertFromHalfToFloat(const_cast<uint16_t*>(reinterpret_cast<const uint16_t*>(weight) + offset), &value, 1);
+        return value;
+    }
+    return reinterpret_cast<const float*>(weight)[offset];
+}
+
+template <int left, int oc_, int weight_type>
+void X86SgemvLeft(float* dst, const float* src, const void* weight, size_t weight_offset, float *bias,
+                  size_t batch_stride) {
     float acc[8];
     for (int i = 0; i < left; i++) {
         acc[i] = bias[i];
     }
     for (size_t ic = 0; ic < batch_stride; ic++) {
-        auto weight_ic = weight + ic * oc_;
+        auto weight_ic = weight_offset + ic * oc_;
         for (int i = 0; i < left; i++) {
-            acc[i] += weight_ic[i] * src[ic];
+            acc[i] += X86SgemvWeightValue<weight_type>(weight, weight_ic + i) * src[ic];
         }
     }
     for (int i = 0; i < left; i++) {
@@ -839,8 +864,9 @@ void X86SgemvLeft(float* dst, const float* src, const float* weight, float *bias
     }
 }
 
-template <typename VEC, int pack>
-void X86Sgemv(float* dst, const float* src, const float* weight, float *bias, DimsVector dims_input, DimsVector dims_output) {
+template <typename VEC, int pack, int weight_type>
+void X86SgemvImpl(float* dst, const float* src, const void* weight, float *bias, DimsVector dims_input,
+                  DimsVector dims_output) {
     size_t batch_stride = DimsVectorUtils::Count(dims_input, 1);
     int oc_vec_size = dims_output[1] / pack * pack;
     int oc_left = dims_output[1] - oc_vec_size;
@@ -848,9 +874,9 @@ void X86Sgemv(float* dst, const float* src, const float* weight, float *bias, Di
         const float *src_batch = src + b * batch_stride;
         float *dst_batch = dst + b * dims_output[1];
 
-        OMP_PARALLEL_FOR_GUIDED_
-        for (int oc = 0; oc < oc_vec_size; oc += pack) {
-            auto weight_oc = weight + oc * batch_stride;
+        ParallelFor(0, UP_DIV(oc_vec_size, pack), [&](int oc_i) {
+            int oc = oc_i * pack;
+            size_t weight_oc = oc * batch_stride;
             VEC acc = VEC::loadu(bias + oc);
             size_t ic = 0;
             for (; ic + 3 < batch_stride; ic += 4) {
@@ -859,10 +885,10 @@ void X86Sgemv(float* dst, const float* src, const float* weight, float *bias, Di
                 VEC src_v1    = VEC(src_batch[ic + 1]);
                 VEC src_v2    = VEC(src_batch[ic + 2]);
                 VEC src_v3    = VEC(src_batch[ic + 3]);
-                VEC weight_v0 = VEC::load(weight_ic);
-                VEC weight_v1 = VEC::load(weight_ic + pack * 1);
-                VEC weight_v2 = VEC::load(weight_ic + pack * 2);
-                VEC weight_v3 = VEC::load(weight_ic + pack * 3);
+                VEC weight_v0 = X86SgemvLoadWeight<VEC, weight_type>(weight, weight_ic);
+                VEC weight_v1 = X86SgemvLoadWeight<VEC, weight_type>(weight, weight_ic + pack * 1);
+                VEC weight_v2 = X86SgemvLoadWeight<VEC, weight_type>(weight, weight_ic + pack * 2);
+                VEC weight_v3 = X86SgemvLoadWeight<VEC, weight_type>(weight, weight_ic + pack * 3);
                 VEC::mla(acc, weight_v0, src_v0);
                 VEC::mla(acc, weight_v1, src_v1);
                 VEC::mla(acc, weight_v2, src_v2);
@@ -870,36 +896,208 @@ void X86Sgemv(float* dst, const float* src, const float* weight, float *bias, Di
             }
             for (; ic < batch_stride; ic++) {
                 VEC src_v    = VEC(src_batch[ic]);
-                VEC weight_v = VEC::load(weight_oc + ic * pack);
+                VEC weight_v = X86SgemvLoadWeight<VEC, weight_type>(weight, weight_oc + ic * pack);
                 VEC::mla(acc, weight_v, src_v);
             }
             VEC::saveu(dst_batch + oc, acc);
-        }
+        });
         int left = oc_left;
         int oc = oc_vec_size;
+        size_t weight_oc = oc * batch_stride;
         if (pack == 8) {
             if (left == 7) {
-                X86SgemvLeft<7, pack>(dst_batch + oc, src_batch, weight + oc * batch_stride, bias + oc, batch_stride);
+                X86SgemvLeft<7, pack, weight_type>(dst_batch + oc, src_batch, weight, weight_oc, bias + oc, batch_stride);
             } else if (left == 6) {
-                X86SgemvLeft<6, pack>(dst_batch + oc, src_batch, weight + oc * batch_stride, bias + oc, batch_stride);
+                X86SgemvLeft<6, pack, weight_type>(dst_batch + oc, src_batch, weight, weight_oc, bias + oc, batch_stride);
             } else if (left == 5) {
-                X86SgemvLeft<5, pack>(dst_batch + oc, src_batch, weight + oc * batch_stride, bias + oc, batch_stride);
+                X86SgemvLeft<5, pack, weight_type>(dst_batch + oc, src_batch, weight, weight_oc, bias + oc, batch_stride);
             } else if (left == 4) {
-                X86SgemvLeft<4, pack>(dst_batch + oc, src_batch, weight + oc * batch_stride, bias + oc, batch_stride);
+                X86SgemvLeft<4, pack, weight_type>(dst_batch + oc, src_batch, weight, weight_oc, bias + oc, batch_stride);
             }
         }
         if (left == 3) {
-            X86SgemvLeft<3, pack>(dst_batch + oc, src_batch, weight + oc * batch_stride, bias + oc, batch_stride);
+            X86SgemvLeft<3, pack, weight_type>(dst_batch + oc, src_batch, weight, weight_oc, bias + oc, batch_stride);
         } else if (left == 2) {
-            X86SgemvLeft<2, pack>(dst_batch + oc, src_batch, weight + oc * batch_stride, bias + oc, batch_stride);
+            X86SgemvLeft<2, pack, weight_type>(dst_batch + oc, src_batch, weight, weight_oc, bias + oc, batch_stride);
         } else if (left == 1) {
-            X86SgemvLeft<1, pack>(dst_batch + oc, src_batch, weight + oc * batch_stride, bias + oc, batch_stride);
+            X86SgemvLeft<1, pack, weight_type>(dst_batch + oc, src_batch, weight, weight_oc, bias + oc, batch_stride);
         }
     }
 }
+
+template <typename VEC, int pack>
+void X86Sgemv(float* dst, const float* src, const float* weight, float *bias, DimsVector dims_input, DimsVector dims_output) {
+    X86SgemvImpl<VEC, pack, DATA_TYPE_FLOAT>(dst, src, weight, bias, dims_input, dims_output);
+}
 template void X86Sgemv<Float4, 4>(float* dst, const float* src, const float* weight, float *bias, DimsVector dims_input, DimsVector dims_output);
 template void X86Sgemv<Float8, 8>(float* dst, const float* src, const float* weight, float *bias, DimsVector dims_input, DimsVector dims_output);
 
+template <typename VEC, int pack>
+void X86Sgemv(float* dst, const float* src, const void* weight, DataType weight_type, float *bias,
+              DimsVector dims_input, DimsVector dims_output) {
+    if (weight_type == DATA_TYPE_BFP16) {
+        X86SgemvImpl<VEC, pack, DATA_TYPE_BFP16>(dst, src, weight, bias, dims_input, dims_output);
+    } else if (weight_type == DATA_TYPE_HALF) {
+        X86SgemvImpl<VEC, pack, DATA_TYPE_HALF>(dst, src, weight, bias, dims_input, dims_output);
+    } else {
+        X86SgemvImpl<VEC, pack, DATA_TYPE_FLOAT>(dst, src, weight, bias, dims_input, dims_output);
+    }
+}
+template void X86Sgemv<Float4, 4>(float* dst, const float* src, const void* weight, DataType weight_type, float *bias,
+                                  DimsVector dims_input, DimsVector dims_output);
+template void X86Sgemv<Float8, 8>(float* dst, const float* src, const void* weight, DataType weight_type, float *bias,
+                                  DimsVector dims_input, DimsVector dims_output);
+
+template <typename VEC, int weight_bits>
+static inline VEC X86SgemvLoadQuantWeight(const void* weight, size_t offset) {
+    if (weight_bits == 4) {
+        return VEC::load_int4(reinterpret_cast<const uint8_t*>(weight) + offset / 2);
+    }
+    return VEC::load_int8(reinterpret_cast<const int8_t*>(weight) + offset);
+}
+
+template <int weight_bits>
+static inline float X86SgemvQuantWeightValue(const void* weight, size_t offset) {
+    if (weight_bits == 4) {
+        uint8_t byte = reinterpret_cast<const uint8_t*>(weight)[offset / 2];
+        return (float)(((offset & 1) ? (byte >> 4) : (byte & 0x0f)) - 8);
+    }
+    return (float)reinterpret_cast<const int8_t*>(weight)[offset];
+}
+
+template <typename VEC, int pack, int weight_bits>
+void X86SgemvQuantImpl(float* dst, const float* src, const void* weight, const float* scale, int group_size,
+                       float *bias, DimsVector dims_input, DimsVector dims_output) {
+    size_t batch_stride = DimsVectorUtils::Count(dims_input, 1);
+    int oc_count        = dims_output[1];
+    int group_count     = UP_DIV(batch_stride, group_size);
+    for (int b = 0; b < dims_output[0]; ++b) {
+        const float *src_batch = src + b * batch_stride;
+        float *dst_batch = dst + b * oc_count;
+
+        ParallelFor(0, UP_DIV(oc_count, pack), [&](int oc_i) {
+            int oc = oc_i * pack;
+            size_t weight_oc = oc * batch_stride;
+            const float *scale_oc = scale + oc_i * group_count * pack;
+            if (oc + pack <= oc_count) {
+                VEC acc = VEC::loadu(bias + oc);
+                for (int g = 0; g < group_count; g++) {
+                    size_t ic     = g * group_size;
+                    size_t ic_end = MIN(ic + group_size, batch_stride);
+                    // products of a group share one scale, dequantize the sum only
+                    VEC group_acc(0.f);
+                    for (; ic + 3 < ic_end; ic += 4) {
+                        auto weight_ic = weight_oc + ic * pack;
+                        VEC src_v0     = VEC(src_batch[ic]);
+                        VEC src_v1     = VEC(src_batch[ic + 1]);
+                        VEC src_v2     = VEC(src_batch[ic + 2]);
+                        VEC src_v3     = VEC(src_batch[ic + 3]);
+                        VEC weight_v0  = X86SgemvLoadQuantWeight<VEC, weight_bits>(weight, weight_ic);
+                        VEC weight_v1  = X86SgemvLoadQuantWeight<VEC, weight_bits>(weight, weight_ic + pack * 1);
+                        VEC weight_v2  = X86SgemvLoadQuantWeight<VEC, weight_bits>(weight, weight_ic + pack * 2);
+                        VEC weight_v3  = X86SgemvLoadQuantWeight<VEC, weight_bits>(weight, weight_ic + pack * 3);
+                        VEC::mla(group_acc, weight_v0, src_v0);
+                        VEC::mla(group_acc, weight_v1, src_v1);
+                        VEC::mla(group_acc, weight_v2, src_v2);
+                        VEC::mla(group_acc, weight_v3, src_v3);
+                    }
+                    for (; ic < ic_end; ic++) {
+                        VEC src_v    = VEC(src_batch[ic]);
+                        VEC weight_v = X86SgemvLoadQuantWeight<VEC, weight_bits>(weight, weight_oc + ic * pack);
+                        VEC::mla(group_acc, weight_v, src_v);
+                    }
+                    VEC::mla(acc, group_acc, VEC::loadu(scale_oc + g * pack));
+                }
+                VEC::saveu(dst_batch + oc, acc);
+            } else {
+                for (int i = 0; i < oc_count - oc; i++) {
+                    float acc = bias[oc + i];
+                    for (int g = 0; g < group_count; g++) {
+                        size_t ic_end   = MIN((size_t)(g + 1) * group_size, batch_stride);
+                        float group_acc = 0.f;
+                        for (size_t ic = g * group_size; ic < ic_end; ic++) {
+                            group_acc += X86SgemvQuantWeightValue<weight_bits>(weight, weight_oc + ic * pack + i) *
+                                         src_batch[ic];
+                        }
+                        acc += group_acc * scale_oc[g * pack + i];
+                    }
+                    dst_batch[oc + i] = acc;
+                }
+            }
+        });
+    }
+}
+
+template <typename VEC, int pack>
+void X86SgemvQuant(float* dst, const float* src, const void* weight, int weight_bits, const float* scale,
+                   int group_size, float *bias, DimsVector dims_input, DimsVector dims_output) {
+    if (weight_bits == 4) {
+        X86SgemvQuantImpl<VEC, pack, 4>(dst, src, weight, scale, group_size, bias, dims_input, dims_output);
+    } else {
+        X86SgemvQuantImpl<VEC, pack, 8>(dst, src, weight, scale, group_size, bias, dims_input, dims_output);
+    }
+}
+template void X86SgemvQuant<Float4, 4>(float* dst, const float* src, const void* weight, int weight_bits,
+                                       const float* scale, int group_size, float *bias, DimsVector dims_input,
+                                       DimsVector dims_output);
+template void X86SgemvQuant<Float8, 8>(float* dst, const float* src, const void* weight, int weight_bits,
+                                       const float* scale, int group_size, float *bias, DimsVector dims_input,
+                                       DimsVector dims_output);
+
+Status X86ConvertFloatTo16Bit(const float *src, void *dst, size_t count, DataType data_type) {
+    if (data_type == DATA_TYPE_BFP16) {
+        auto dst_bf16 = reinterpret_cast<uint16_t *>(dst);
+        for (size_t i = 0; i < count; i++) {
+            uint32_t bits;
+            memcpy(&bits, src + i, sizeof(bits));
+            if ((bits & 0x7fffffff) > 0x7f800000) {
+                // keep nan a quiet nan
+                dst_bf16[i] = (bits >> 16) | 0x40;
+            } else {
+                dst_bf16[i] = (bits + 0x7fff + ((bits >> 16) & 1)) >> 16;
+            }
+        }
+        return TNN_OK;
+    } else if (data_type == DATA_TYPE_HALF) {
+        ConvertFromFloatToHalf(const_cast<float *>(src), dst, (int)count);
+        return TNN_OK;
+    }
+    return Status(TNNERR_PARAM_ERR, "X86ConvertFloatTo16Bit only supports bfp16 and half");
+}
+
+void X86Convert16BitToFloat(const void *src, float *dst, size_t count, DataType data_type) {
+    auto src_16 = reinterpret_cast<const uint16_t *>(src);
+    size_t i    = 0;
+    if (data_type == DATA_TYPE_BFP16) {
+        for (; i + 7 < count; i += 8) {
+            Float8::saveu(dst + i, Float8::load_bf16(src_16 + i));
+        }
+        for (; i < count; i++) {
+            dst[i] = float(reinterpret_cast<const bfp16_t *>(src_16)[i]);
+        }
+    } else if (data_type == DATA_TYPE_HALF) {
+#ifdef __F16C__
+        for (; i + 7 < count; i += 8) {
+            Float8::saveu(dst + i, Float8::load_half(src_16 + i));
+        }
+#endif
+        if (i < count) {
+            ConvertFromHalfToFloat(const_cast<uint16_t *>(src_16 + i), dst + i, (int)(count - i));
+        }
+    }
+}
+
+void X86ConvertInt8ToFloat(const void *src, float *dst, size_t count, DataType data_type) {
+    auto src_8 = reinterpret_cast<const int8_t *>(src);
+    size_t i   = 0;
+    for (; i + 7 < count; i += 8) {
+        Float8::saveu(dst + i, Float8::load_int8(src_8 + i));
+    }
+    for (; i < count; i++) {
+        dst[i] = (float)src_8[i];
+    }
+}
+
 template <int activation_type, typename VEC, int pack>
 void X86_Post_Exec(float *dst, const float *bias, long channel, long area) {
     for (long c = 0; c < channel; c++) {
@@ -942,7 +1140,109 @@ template void X86_Post_Exec<ActivationType_None, Float8, 8>(float *dst, const fl
 template void X86_Post_Exec<ActivationType_ReLU, Float8, 8>(float *dst, const float *bias, long channel, long area);
 template void X86_Post_Exec<ActivationType_ReLU6, Float8, 8>(float *dst, const float *bias, long channel, long area);
 
-//ActivationType_SIGMOID_MUL TBD
+template <int activation_type, typename VEC>
+static inline VEC X86_Activate(const VEC &v) {
+    if (activation_type == ActivationType_ReLU) {
+        return VEC::max(v, VEC(0.f));
+    } else if (activation_type == ActivationType_ReLU6) {
+        return VEC::min(VEC::max(v, VEC(0.f)), VEC(6.f));
+    } else if (activation_type == ActivationType_SIGMOID) {
+        return VEC::sigmoid(v);
+    } else if (activation_type == ActivationType_SIGMOID_MUL) {
+        return VEC::sigmoid(v) * v;
+    } else if (activation_type == ActivationType_HARDSWISH) {
+        return v * VEC::min(VEC::max(v + VEC(3.f), VEC(0.f)), VEC(6.f)) * VEC(1.f / 6.f);
+    } else if (activation_type == ActivationType_GELU) {
+        return VEC(0.5f) * v * (fast_erf_approximation<VEC>(v * VEC(0.707106793288165f)) + VEC(1.f));
+    }
+    return v;
+}
+
+template <int activation_type, typename VEC>
+static inline VEC X86_Epilogue_Op(VEC v, const VEC &residual, const VEC &scale, const conv_gemm_epilogue &epilogue,
+                                  bool has_residual) {
+    if (epilogue.scale) {
+        v = v * scale;
+    }
+    if (has_residual && epilogue.add_before_act) {
+        v = v + residual;
+    }
+    v = X86_Activate<activation_type, VEC>(v);
+    if (has_residual && !epilogue.add_before_act) {
+        v = v + residual;
+    }
+    if (epilogue.clip) {
+        v = VEC::min(VEC::max(v, VEC(epilogue.clip_min)), VEC(epilogue.clip_max));
+    }
+    return v;
+}
+
+template <int activation_type, typename VEC, int pack>
+static void X86_Conv_Epilogue_Impl(float *dst, dim_t ldc, dim_t rows, dim_t cols, const float *residual,
+                                   const conv_gemm_epilogue &epilogue) {
+    const bool has_residual = residual != nullptr;
+    for (dim_t c = 0; c < cols; c++) {
+        float *dst_c         = dst + c * ldc;
+        const float *res_c   = has_residual ? residual + c * ldc : nullptr;
+        VEC scale_v          = VEC(epilogue.scale ? epilogue.scale[c] : 1.f);
+        VEC res_v            = VEC(0.f);
+        dim_t i = 0;
+        for (; i + pack - 1 < rows; i += pack) {
+            if (has_residual) {
+                res_v = VEC::loadu(res_c + i);
+            }
+            VEC dst_v = X86_Epilogue_Op<activation_type, VEC>(VEC::loadu(dst_c + i), res_v, scale_v, epilogue,
+                                                              has_residual);
+            VEC::saveu(dst_c + i, dst_v);
+        }
+        if (i < rows) {
+            // pad the tail to a full vector, keeps the math of the tail the same as the body
+            float dst_tail[pack] = {0};
+            float res_tail[pack] = {0};
+            memcpy(dst_tail, dst_c + i, (rows - i) * sizeof(float));
+            if (has_residual) {
+                memcpy(res_tail, res_c + i, (rows - i) * sizeof(float));
+            }
+            VEC dst_v = X86_Epilogue_Op<activation_type, VEC>(VEC::loadu(dst_tail), VEC::loadu(res_tail), scale_v,
+                                                              epilogue, has_residual);
+            VEC::saveu(dst_tail, dst_v);
+            memcpy(dst_c + i, dst_tail, (rows - i) * sizeof(float));
+        }
+    }
+}
+
+template <typename VEC, int pack>
+void X86_Conv_Epilogue(float *dst, dim_t ldc, dim_t rows, dim_t cols, const float *residual,
+                       const conv_gemm_epilogue &epilogue) {
+    auto impl = X86_Conv_Epilogue_Impl<ActivationType_None, VEC, pack>;
+    switch (epilogue.act_type) {
+        case ActivationType_ReLU:
+            impl = X86_Conv_Epilogue_Impl<ActivationType_ReLU, VEC, pack>;
+            break;
+        case ActivationType_ReLU6:
+            impl = X86_Conv_Epilogue_Impl<ActivationType_ReLU6, VEC, pack>;
+            break;
+        case ActivationType_SIGMOID:
+            impl = X86_Conv_Epilogue_Impl<ActivationType_SIGMOID, VEC, pack>;
+            break;
+        case ActivationType_SIGMOID_MUL:
+            impl = X86_Conv_Epilogue_Impl<ActivationType_SIGMOID_MUL, VEC, pack>;
+            break;
+        case ActivationType_HARDSWISH:
+            impl = X86_Conv_Epilogue_Impl<ActivationType_HARDSWISH, VEC, pack>;
+            break;
+        case ActivationType_GELU:
+            impl = X86_Conv_Epilogue_Impl<ActivationType_GELU, VEC, pack>;
+            break;
+        default:
+            break;
+    }
+    impl(dst, ldc, rows, cols, residual, epilogue);
+}
+template void X86_Conv_Epilogue<Float4, 4>(float *dst, dim_t ldc, dim_t rows, dim_t cols, const float *residual,
+                                           const conv_gemm_epilogue &epilogue);
+template void X86_Conv_Epilogue<Float8, 8>(float *dst, dim_t ldc, dim_t rows, dim_t cols, const float *residual,
+                                           const conv_gemm_epilogue &epilogue);
 
 template <typename VEC, int pack>
 void X86_VectorAdd(float *dst, const float *src_a, const float *src_b, long len) {
@@ -23,6 +23,7 @@
 #include "tnn/interpreter/layer_param.h"
 #include "tnn/device/x86/acc/Float4.h"
 #include "tnn/device/x86/acc/Float8.h"
+#include "tnn/device/x86/acc/compute/jit/conv_sgemm_driver.h"
 
 namespace TNN_NS {
 
@@ -66,9 +67,64 @@ void DepthwiseConv(float* dst, const float* src, const float* weight, const floa
 template <typename VEC, int pack>
 void X86Sgemv(float* dst, const float* src, const float* weight, float *bias, DimsVector dims_input, DimsVector dims_output);
 
+// @brief sgemv with weights packed by PackC4/PackC8 in fp32, bfp16 or half, accumulates in fp32
+template <typename VEC, int pack>
+void X86Sgemv(float* dst, const float* src, const void* weight, DataType weight_type, float *bias,
+              DimsVector dims_input, DimsVector dims_output);
+
+// @brief sgemv with int8 weights, or int4 weights stored two per byte with an offset of 8, packed by PackC4/PackC8.
+// the products are summed in fp32 per group of group_size input channels and scaled once per group,
+// scale is laid out as [UP_DIV(oc, pack)][UP_DIV(ic, group_size)][pack]
+template <typename VEC, int pack>
+void X86SgemvQuant(float* dst, const float* src, const void* weight, int weight_bits, const float* scale,
+                   int group_size, float *bias, DimsVector dims_input, DimsVector dims_output);
+
+// @brief convert float to DATA_TYPE_BFP16 (round to nearest even) or DATA_TYPE_HALF
+Status X86ConvertFloatTo16Bit(const float *src, void *dst, size_t count, DataType data_type);
+
+// @brief convert DATA_TYPE_BFP16 or DATA_TYPE_HALF to float, the unpack func of 16 bit gemm weights
+void X86Convert16BitToFloat(const void *src, float *dst, size_t count, DataType data_type);
+
+// @brief convert int8 to float, the unpack func of int8 gemm weights
+void X86ConvertInt8ToFloat(const void *src, float *dst, size_t count, DataType data_type);
+
 template <int activation_type, typename VEC, int pack>
 void X86_Post_Exec(float *dst, const float *bias, long channel, long area);
 
+// @brief apply the post ops of epilogue on a col major tile [rows x cols], used as
+// conv_gemm_epilogue::post_func, scale of the epilogue points to the scale of col 0
+template <typename VEC, int pack>
+void X86_Conv_Epilogue(float *dst, dim_t ldc, dim_t rows, dim_t cols, const float *residual,
+                       const conv_gemm_epilogue &epilogue);
+
+template <typename VEC>
+VEC fast_erf_approximation(const VEC x) {
+    auto t = VEC::div(VEC(1.f), VEC(1.f) + VEC(0.5f) * VEC::abs(x));
+    auto t_2 = t * t;
+    auto t_3 = t_2 * t;
+    auto t_4 = t_3 * t;
+    auto t_5 = t_4 * t;
+    auto t_6 = t_5 * t;
+    auto t_7 = t_6 * t;
+    auto t_8 = t_7 * t;
+    auto t_9 = t_8 * t;
+
+    auto v = t * VEC::exp(VEC::neg(x) * x - VEC(1.26551223) +
+                             VEC(1.00002368) * t +
+                             VEC(0.37409196) * t_2 +
+                             VEC(0.09678418) * t_3 -
+                             VEC(0.18628806) * t_4 +
+                             VEC(0.27886807) * t_5 -
+                             VEC(1.13520398) * t_6 +
+                             VEC(1.48851587) * t_7 -
+                             VEC(0.82215223) * t_8 +
+                             VEC(0.17087277) * t_9);
+    auto v_pos = VEC(1.f) - v;
+    auto v_neg = v - VEC(1.f);
+
+    return VEC::bsl_cge(x, VEC(0.f), v_pos, v_neg);
+}
+
 template <typename VEC, int pack>
 void X86_VectorAdd(float *dst, const float *src_a, const float *src_b, long len);
 
@@ -17,7 +17,7 @@
 #include "tnn/device/x86/x86_common.h"
 #include "tnn/device/x86/x86_util.h"
 #include "tnn/utils/dims_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 using namespace x86;
@@ -178,6 +178,106 @@ void X86AVXGemmInt8Unit4x4(const int8_t* src, const int8_t* weight, int8_t* dst,
 }
 #endif
 
+#ifdef TNN_X86_VNNI_ENABLE
+// lane j of 128 bits holds the partial sums of output channel j
+__attribute__((target("avx512f,avx512bw,avx512vnni")))
+static inline __m128i ReduceI32x16To4(__m512i v) {
+    __m128i d0 = _mm_hadd_epi32(_mm512_extracti32x4_epi32(v, 0), _mm512_extracti32x4_epi32(v, 1));
+    __m128i d1 = _mm_hadd_epi32(_mm512_extracti32x4_epi32(v, 2), _mm512_extracti32x4_epi32(v, 3));
+    return _mm_hadd_epi32(d0, d1);
+}
+
+// vpdpbusd multiplies u8 by s8, src is moved to u8 by adding 128 (xor 0x80),
+// and 128 * sum(weight) of each output channel is subtracted from the result.
+// the weights of a 16 channels step are loaded once for the 4 pixels.
+__attribute__((target("avx512f,avx512bw,avx512vnni")))
+void X86VNNIGemmInt8Unit4x4(const int8_t* src, const int8_t* weight, int8_t* dst, long src_w_step, long dst_depth, long cdiv8,
+                     const float* scale, const int32_t* bias, long relu, const int8_t* add_input,
+                     const float* add_scale, const int8_t* relu6_max) {
+    DeclareRounding();
+    __m128 relu6_max_vec;
+
+    if (relu == 2) {
+        float tmp4[4];
+        tmp4[0] = (float)relu6_max[0];
+        tmp4[1] = (float)relu6_max[1];
+        tmp4[2] = (float)relu6_max[2];
+        tmp4[3] = (float)relu6_max[3];
+        relu6_max_vec = _mm_loadu_ps(tmp4);
+    }
+
+    const __m512i src_offset = _mm512_set1_epi8((char)0x80);
+    const __m512i ones_u8    = _mm512_set1_epi8(1);
+
+    __m512i weight_sum = _mm512_setzero_si512();
+    __m512i dst_i32x16[4];
+    for (long w = 0; w < 4; ++w) {
+        dst_i32x16[w] = _mm512_setzero_si512();
+    }
+
+    long sz = 0;
+    for (; sz < cdiv8 / 2; ++sz) {
+        const auto weight_sz = weight + (4 * 16) * sz;
+        __m512i w_vec        = _mm512_loadu_si512((const void*)(weight_sz));
+        weight_sum           = _mm512_dpbusd_epi32(weight_sum, ones_u8, w_vec);
+
+        for (long w = 0; w < 4; ++w) {
+            const auto src_z = src + w * src_w_step + sz * 16;
+            __m512i src_vec  = _mm512_broadcast_i32x4(_mm_loadu_si128((__m128i*)(src_z)));
+            src_vec          = _mm512_xor_si512(src_vec, src_offset);
+            dst_i32x16[w]    = _mm512_dpbusd_epi32(dst_i32x16[w], src_vec, w_vec);
+        }
+    }
+
+    if (sz < cdiv8 / 2 + cdiv8 % 2) {
+        // only the first 8 bytes of each output channel are valid
+        const auto weight_sz = weight + (4 * 16) * sz;
+        __m512i w_vec        = _mm512_maskz_loadu_epi8(0x00FF00FF00FF00FFULL, (const void*)(weight_sz));
+        weight_sum           = _mm512_dpbusd_epi32(weight_sum, ones_u8, w_vec);
+
+        for (long w = 0; w < 4; ++w) {
+            const auto src_z = src + w * src_w_step + sz * 16;
+            __m512i src_vec  = _mm512_broadcast_i32x4(_mm_loadl_epi64((__m128i*)(src_z)));
+            src_vec          = _mm512_xor_si512(src_vec, src_offset);
+            dst_i32x16[w]    = _mm512_dpbusd_epi32(dst_i32x16[w], src_vec, w_vec);
+        }
+    }
+
+    __m128i weight_comp = _mm_slli_epi32(ReduceI32x16To4(weight_sum), 7);
+    __m128i bias_vec    = _mm_sub_epi32(_mm_loadu_si128((__m128i*)bias), weight_comp);
+    __m128 scale_vec    = _mm_loadu_ps(scale);
+
+    for (long w = 0; w < 4; ++w) {
+        auto dst_x       = dst + w * dst_depth;
+        auto add_input_x = add_input ? add_input + w * dst_depth : nullptr;
+
+        __m128i dst_vec_0 = ReduceI32x16To4(dst_i32x16[w]);
+        __m128 dst_4x32   = _mm_cvtepi32_ps(_mm_add_epi32(dst_vec_0, bias_vec));
+        dst_4x32          = _mm_mul_ps(dst_4x32, scale_vec);
+
+        if (relu == -1) {
+            dst_4x32 = _mm_max_ps(dst_4x32, zero_f32);
+        }
+        if (add_input_x) {
+            int add_input_4x8 = *((int*)(add_input_x));
+            __m128 add_scale_vec = _mm_loadu_ps(add_scale);
+            __m128 add_input_vec = _mm_cvtepi32_ps(_mm_cvtepi8_epi32(_mm_cvtsi32_si128(add_input_4x8)));
+            dst_4x32 = _mm_add_ps(dst_4x32, _mm_mul_ps(add_input_vec, add_scale_vec));
+        }
+        if (relu == 1) {
+            dst_4x32 = _mm_max_ps(dst_4x32, zero_f32);
+        }
+        // Conv-Add-Relu6
+        else if (relu == 2) {
+            dst_4x32 = _mm_max_ps(dst_4x32, zero_f32);
+            dst_4x32 = _mm_min_ps(dst_4x32, relu6_max_vec);
+        }
+        F32X4TOI8X4(dst_4x32, dst_x);
+    }
+    _mm256_zeroupper();
+}
+#endif
+
 void X86SSEGemmInt8Unit4x4(const int8_t* src, const int8_t* weight, int8_t* dst, long src_w_step, long dst_depth, long cdiv8,
                      const float* scale, const int32_t* bias, long relu, const int8_t* add_input,
                      const float* add_scale, const int8_t* relu6_max) {
@@ -626,11 +726,11 @@ void X86DepthwiseI8General(int8_t* dst, const int8_t* src, const int8_t* weight,
 void X86ReluInt8(int8_t* dst, const int8_t* src, long len) {
     __m128i zero_i8 = _mm_setzero_si128();
     long idx = len - len % 16;
-    OMP_PARALLEL_FOR_GUIDED_
-    for (long i = 0; i < idx; i += 16) {
+    ParallelFor(0, UP_DIV(idx, 16), [&](int i_i) {
+        long i = i_i * 16;
         __m128i vec = _mm_loadu_si128((__m128i*)(src + i));
         _mm_storeu_si128((__m128i*)(dst + i), _mm_max_epi8(vec, zero_i8));
-    }
+    });
     for (; idx < len; idx++) {
         dst[idx] = MAX(0, src[idx]);
     }
@@ -638,8 +738,7 @@ void X86ReluInt8(int8_t* dst, const int8_t* src, long len) {
 
 void X86Relu6Int8(int8_t* dst, const int8_t* src, const int8_t* relu6_max, long width, long dst_depth) {
     __m128i zero_i8 = _mm_setzero_si128();
-    OMP_PARALLEL_FOR_GUIDED_
-    for (long dx = 0; dx < width; dx++) {
+    ParallelFor(0, width, [&](long dx) {
         auto src_dx = src + dx * dst_depth;
         auto dst_dx = dst + dx * dst_depth;
 
@@ -654,13 +753,12 @@ void X86Relu6Int8(int8_t* dst, const int8_t* src, const int8_t* relu6_max, long
             int8_t tmp = MIN(src_dx[dc], relu6_max[dc]);
             dst_dx[dc] = MAX(0, tmp);
         }
-    }
+    });
 }
 
 void X86MaxPoolingINT8(const int8_t* src, long iw, long ih, int8_t* dst, long ow, long oh, long c_r4, long kw, long kh,
                     long stride_w, long stride_h, long pad_w, long pad_h) {
-    OMP_PARALLEL_FOR_COLLAPSE_(2)
-    for (long oy = 0; oy < oh; ++oy) {
+    ParallelFor(0, oh, [&](long oy) {
         for (long ox = 0; ox < ow; ++ox) {
             const long srcOriginX = ox * stride_w - pad_w;
             const long srcOriginY = oy * stride_h - pad_h;
@@ -719,13 +817,12 @@ void X86MaxPoolingINT8(const int8_t* src, long iw, long ih, int8_t* dst, long ow
                 *(int32_t*)dst_ptr = *(int32_t*)maxValue;
             }
         }
-    }
+    });
 }
 
 void X86AvgPoolingINT8(const int8_t* src, long iw, long ih, int8_t* dst, long ow, long oh, long c_r4, long kw, long kh,
                     long stride_w, long stride_h, long pad_w, long pad_h) {
-    OMP_PARALLEL_FOR_COLLAPSE_(2)
-    for (long oy = 0; oy < oh; ++oy) {
+    ParallelFor(0, oh, [&](long oy) {
         for (long ox = 0; ox < ow; ++ox) {
             const long srcOriginX   = ox * stride_w - pad_w;
             const long srcOriginY   = oy * stride_h - pad_h;
@@ -786,7 +883,7 @@ void X86AvgPoolingINT8(const int8_t* src, long iw, long ih, int8_t* dst, long ow
                 }
             }
         }
-    }
+    });
 }
 
 /*
@@ -795,8 +892,7 @@ element add int8 func
 void X86MatrixAddInt8(int8_t* dst, const int8_t* A, const int8_t* B, float* dst_scale, const float* a_scale,
                    float* b_scale, long channel, long hw_size) {
     DeclareRounding();
-    OMP_PARALLEL_FOR_GUIDED_
-    for (long hw = 0; hw < hw_size; hw++) {
+    ParallelFor(0, hw_size, [&](long hw) {
         long c = 0;
 
         auto A_hw   = A + hw * channel;
@@ -827,14 +923,14 @@ void X86MatrixAddInt8(int8_t* dst, const int8_t* A, const int8_t* B, float* dst_
             float aval  = A_hw[c] * a_scale[c] + B_hw[c] * b_scale[c];
             dst_hw[c] = float2int8(aval * dst_scale[c]);
         }
-    }
+    });
 }
 
 void X86GemvInt8(int8_t* dst, const int8_t* src, const int8_t* weight, const int32_t* bias, const float* scale, long ic_r4,
               long oc_r4) {
     DeclareRounding();
-    OMP_PARALLEL_FOR_GUIDED_
-    for (long dc = 0; dc < oc_r4; dc += 4) {
+    ParallelFor(0, UP_DIV(oc_r4, 4), [&](int dc_i) {
+        long dc = dc_i * 4;
         __m128i acc0 = _mm_setzero_si128();
         __m128i acc1 = _mm_setzero_si128();
         __m128i acc2 = _mm_setzero_si128();
@@ -910,7 +1006,7 @@ void X86GemvInt8(int8_t* dst, const int8_t* src, const int8_t* weight, const int
         dst_4xf32         = _mm_mul_ps(dst_4xf32, scale_vec);
 
         F32X4TOI8X4(dst_4xf32, (dst + dc));
-    }
+    });
 }
 
 static bool is_per_tensor_quant(const std::vector<Blob *> &inputs) {
@@ -945,10 +1041,9 @@ void X86ConcatChannelInt8(Blob *output, const std::vector<Blob *> &inputs) {
                 auto ic_c4 = ROUND_UP(input_channel, 4);
                 auto input_ptr = handle_ptr<int8_t *>(inputs[b]->GetHandle()) + n * ic_c4 * full_hw;
                 auto output_ptr = output_origin + n * full_hw * oc_c4 + c_offset;
-                OMP_PARALLEL_FOR_GUIDED_
-                for (int cur_hw = 0; cur_hw < full_hw; cur_hw++) {
+                ParallelFor(0, full_hw, [&](int cur_hw) {
                     memcpy(output_ptr + cur_hw * oc_c4, input_ptr + cur_hw * ic_c4, input_channel);
-                }
+                });
                 c_offset += input_channel;
             }
         }
@@ -964,8 +1059,7 @@ void X86ConcatChannelInt8(Blob *output, const std::vector<Blob *> &inputs) {
                 auto ic_c4         = ROUND_UP(input_channel, 4);
                 auto input_ptr     = handle_ptr<int8_t *>(inputs[b]->GetHandle()) + n * ic_c4 * full_hw;
                 auto output_ptr    = output_origin + n * full_hw * oc_c4 + c_offset;
-                OMP_PARALLEL_FOR_GUIDED_
-                for (int cur_hw = 0; cur_hw < full_hw; cur_hw++) {
+                ParallelFor(0, full_hw, [&](int cur_hw) {
                     auto src_ic = input_ptr + cur_hw * ic_c4;
                     auto dst_ic = output_ptr + cur_hw * oc_c4;
                     int ic = 0;
@@ -982,7 +1076,7 @@ void X86ConcatChannelInt8(Blob *output, const std::vector<Blob *> &inputs) {
                     for (; ic < input_channel; ic++) {
                         dst_ic[ic] = float2int8(src_ic[ic] * scale);
                     }
-                }
+                });
                 c_offset += input_channel;
             }
         }
@@ -1091,8 +1185,7 @@ static void upsample_bilinear_cn(int8_t *output_data, const int8_t *input_data,
 
     const float INTER_RESIZE_COEF_SCALE = float(1 << 11);
 
-    OMP_PARALLEL_FOR_GUIDED_
-    for (int h2 = 0; h2 < oh; ++h2) {
+    ParallelFor(0, oh, [&](int h2) {
         const float h1r      = h_coeffs_ptr[h2];
         const int h1         = h1r;
         const int h1p        = (h1 < ih - 1) ? 1 : 0;
@@ -1120,7 +1213,7 @@ static void upsample_bilinear_cn(int8_t *output_data, const int8_t *input_data,
                 }
             }
         }
-    }
+    });
 }
 
 template <bool do_scale>
@@ -1133,8 +1226,7 @@ void X86UpsampleNearest2D(int8_t *output_data, const int8_t *input_data,
     const float height_scale = (float)ih / (float)oh;
     const float width_scale  = (float)iw / (float)ow;
 
-    OMP_PARALLEL_FOR_GUIDED_
-    for (int h = 0; h < oh; h++) {
+    ParallelFor(0, oh, [&](int h) {
         int scale_h = static_cast<int>(h * height_scale);
         auto dst_y  = output_data + h * dst_y_step;
         auto src_y  = input_data + scale_h * src_y_step;
@@ -1150,7 +1242,7 @@ void X86UpsampleNearest2D(int8_t *output_data, const int8_t *input_data,
                 }
             }
         }
-    }
+    });
 }
 
 template void X86UpsampleNearest2D<true>(int8_t *output_data, const int8_t *input_data,
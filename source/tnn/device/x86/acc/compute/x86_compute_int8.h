@@ -20,6 +20,13 @@
 #include "tnn/core/status.h"
 #include "tnn/interpreter/layer_param.h"
 
+// the vnni kernel is built with function target attributes, the rest of the
+// file does not need to be compiled for avx512
+#if defined(__AVX2__) && ((defined(__clang__) && __clang_major__ >= 6) || \
+                          (!defined(__clang__) && defined(__GNUC__) && __GNUC__ >= 8))
+#define TNN_X86_VNNI_ENABLE
+#endif
+
 namespace TNN_NS {
 
 #ifdef __AVX2__
@@ -28,6 +35,13 @@ void X86AVXGemmInt8Unit4x4(const int8_t* src, const int8_t* weight, int8_t* dst,
                      const float* add_scale, const int8_t* relu6_max);
 #endif
 
+#ifdef TNN_X86_VNNI_ENABLE
+// same layout as X86AVXGemmInt8Unit4x4, run only if cpu_with_isa(avx512_vnni)
+void X86VNNIGemmInt8Unit4x4(const int8_t* src, const int8_t* weight, int8_t* dst, long src_w_step, long dst_depth, long cdiv8,
+                     const float* scale, const int32_t* bias, long relu, const int8_t* add_input,
+                     const float* add_scale, const int8_t* relu6_max);
+#endif
+
 void X86SSEGemmInt8Unit4x4(const int8_t* src, const int8_t* weight, int8_t* dst, long src_w_step, long dst_depth, long cdiv8,
                      const float* scale, const int32_t* bias, long relu, const int8_t* add_input,
                      const float* add_scale, const int8_t* relu6_max);
@@ -0,0 +1,253 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "tnn/device/x86/acc/compute/x86_preprocess.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "tnn/device/x86/acc/Float4.h"
+#include "tnn/device/x86/acc/Float8.h"
+#include "tnn/device/x86/acc/compute/jit/utils/cpu_isa.h"
+#include "tnn/utils/dims_utils.h"
+#include "tnn/utils/naive_compute.h"
+#include "tnn/utils/parallel_for.h"
+
+namespace TNN_NS {
+
+int X86PreprocessSrcChannel(MatType mat_type) {
+    switch (mat_type) {
+        case NGRAY:
+            return 1;
+        case N8UC3:
+        case NNV12:
+        case NNV21:
+            return 3;
+        case N8UC4:
+            return 4;
+        default:
+            return 0;
+    }
+}
+
+
+// same sample positions as the mat resize kernels, pos1 is clamped for borders of a single pixel
+static void CalculateResizeTable(int length, int border, InterpType interp_type, int *pos0, int *pos1,
+                                 float *ratio) {
+    const double scale = (double)border / length;
+    for (int i = 0; i < length; ++i) {
+        float pos_f = (float)((i + 0.5) * scale - 0.5);
+        int pos_i   = static_cast<int>(std::floor(pos_f));
+        float rat_f = pos_f - pos_i;
+        if (pos_i < 0) {
+            pos_i = 0;
+            rat_f = 0.f;
+        }
+        if (pos_i >= border - 1) {
+            pos_i = std::max(border - 2, 0);
+            rat_f = border > 1 ? 1.f : 0.f;
+        }
+        if (interp_type == INTERP_TYPE_NEAREST) {
+            rat_f = rat_f <= 0.5f ? 0.f : 1.f;
+        }
+        pos0[i]  = pos_i;
+        pos1[i]  = std::min(pos_i + 1, border - 1);
+        ratio[i] = rat_f;
+    }
+}
+
+#define SATURATE_YUV(X) (float)std::min(std::max((X) >> 6, 0), 255)
+
+// expand columns [x0, x0 + width) of src row y to planar float, row[c * width + x], yuv is converted to bgr with
+// the same integer formula as NV12ToBGR and NV21ToBGR
+static void LoadSrcRow(const uint8_t *data, MatType mat_type, int src_w, int src_h, int y, int x0, int width,
+                       float *row) {
+    if (mat_type == NNV12 || mat_type == NNV21) {
+        const bool is_nv12   = mat_type == NNV12;
+        const uint8_t *yptr  = data + y * src_w;
+        const uint8_t *vuptr = data + src_w * src_h + (y >> 1) * src_w;
+        float *b_row         = row;
+        float *g_row         = row + width;
+        float *r_row         = row + 2 * width;
+        for (int x = 0; x < width; ++x) {
+            const int sx      = x0 + x;
+            const uint8_t *vu = vuptr + (sx >> 1 << 1);
+            int u, v;
+            if (is_nv12) {
+                u = (vu[0] > 240 ? 240 : vu[0]) - 128;
+                v = (vu[1] > 240 ? 240 : vu[1]) - 128;
+            } else {
+                v = (vu[0] > 240 ? 240 : vu[0]) - 128;
+                u = (vu[1] > 240 ? 240 : vu[1]) - 128;
+            }
+            const int ruv = 102 * v;
+            const int guv = -52 * v + -25 * u;
+            const int buv = 129 * u;
+            const int yy  = yptr[sx] * 74 - 1135;
+            b_row[x]      = SATURATE_YUV(yy + buv);
+            g_row[x]      = SATURATE_YUV(yy + guv);
+            r_row[x]      = SATURATE_YUV(yy + ruv);
+        }
+    } else {
+        const int channel  = X86PreprocessSrcChannel(mat_type);
+        const uint8_t *src = data + (y * src_w + x0) * channel;
+        for (int c = 0; c < channel; ++c) {
+            float *dst = row + c * width;
+            for (int x = 0; x < width; ++x) {
+                dst[x] = src[x * channel + c];
+            }
+        }
+    }
+}
+
+#undef SATURATE_YUV
+
+static void ResizeRow(const float *src, const int *xofs0, const int *xofs1, const float *fx, int width, float *dst) {
+    for (int x = 0; x < width; ++x) {
+        const float left = src[xofs0[x]];
+        dst[x]           = left + (src[xofs1[x]] - left) * fx[x];
+    }
+}
+
+template <class T, int pack>
+static void X86PreprocessImpl(const uint8_t *data, MatType mat_type, int src_w, int src_h, const CropParam &crop,
+                              InterpType interp_type, const int *channel_map, const float *scale, const float *bias,
+                              DataType data_type, const DimsVector &dims, void *dst) {
+    const int batch       = dims[0];
+    const int channel     = dims[1];
+    const int height      = dims[2];
+    const int width       = dims[3];
+    const int c_r4        = ROUND_UP(channel, 4);
+    const int src_channel = X86PreprocessSrcChannel(mat_type);
+    // a yuv batch is one image of batch * src_h rows, as in the color conversion kernels
+    const bool is_yuv     = mat_type == NNV12 || mat_type == NNV21;
+
+    std::vector<int> xofs(width * 2), yofs(height * 2);
+    std::vector<float> fx(width), fy(height);
+    CalculateResizeTable(width, crop.width, interp_type, xofs.data(), xofs.data() + width, fx.data());
+    CalculateResizeTable(height, crop.height, interp_type, yofs.data(), yofs.data() + height, fy.data());
+
+    ParallelForRange(0, batch * height, [&](int begin, int end, int thread_id) {
+        // two src rows resized horizontally, keyed by batch * crop.height + row, adjacent dst rows share them
+        std::vector<float> src_row(src_channel * crop.width);
+        std::vector<float> rows(2 * channel * width);
+        std::vector<float> int8_row(data_type == DATA_TYPE_INT8 ? channel * width : 0);
+        int row_key[2] = {-1, -1};
+
+        auto get_row = [&](int key, int keep_key) -> const float * {
+            for (int s = 0; s < 2; ++s) {
+                if (row_key[s] == key) {
+                    return rows.data() + s * channel * width;
+                }
+            }
+            const int slot = row_key[0] == keep_key ? 1 : 0;
+            const int b    = key / crop.height;
+            const int y    = crop.top_left_y + key % crop.height;
+            if (is_yuv) {
+                LoadSrcRow(data, mat_type, src_w, batch * src_h, b * src_h + y, crop.top_left_x, crop.width,
+                           src_row.data());
+            } else {
+                LoadSrcRow(data + b * src_h * src_w * src_channel, mat_type, src_w, src_h, y, crop.top_left_x,
+                           crop.width, src_row.data());
+            }
+            float *row = rows.data() + slot * channel * width;
+            for (int c = 0; c < channel; ++c) {
+                ResizeRow(src_row.data() + channel_map[c] * crop.width, xofs.data(), xofs.data() + width, fx.data(),
+                          width, row + c * width);
+            }
+            row_key[slot] = key;
+            return row;
+        };
+
+        for (int i = begin; i < end; ++i) {
+            const int b       = i / height;
+            const int y       = i % height;
+            const int key0    = b * crop.height + yofs[y];
+            const int key1    = b * crop.height + yofs[height + y];
+            const float *row0 = get_row(key0, key1);
+            const float *row1 = get_row(key1, key0);
+            const float ratio = fy[y];
+            const T ratio_v(ratio);
+
+            for (int c = 0; c < channel; ++c) {
+                float *out = data_type == DATA_TYPE_INT8
+                                 ? int8_row.data() + c * width
+                                 : reinterpret_cast<float *>(dst) + ((b * channel + c) * height + y) * width;
+                const float *r0 = row0 + c * width;
+                const float *r1 = row1 + c * width;
+                const T scale_v(scale[c]);
+                const T bias_v(bias[c]);
+                int x = 0;
+                for (; x + pack <= width; x += pack) {
+                    T v = T::loadu(r0 + x);
+                    T::mla(v, T::sub(T::loadu(r1 + x), v), ratio_v);
+                    T res = bias_v;
+                    T::mla(res, v, scale_v);
+                    T::saveu(out + x, res);
+                }
+                for (; x < width; ++x) {
+                    const float v = r0[x] + (r1[x] - r0[x]) * ratio;
+                    out[x]        = v * scale[c] + bias[c];
+                }
+            }
+
+            if (data_type == DATA_TYPE_INT8) {
+                int8_t *dst_row = reinterpret_cast<int8_t *>(dst) + (b * height + y) * width * c_r4;
+                for (int x = 0; x < width; ++x) {
+                    int8_t *dst_x = dst_row + x * c_r4;
+                    for (int c = 0; c < channel; ++c) {
+                        dst_x[c] = float2int8(int8_row[c * width + x]);
+                    }
+                    for (int c = channel; c < c_r4; ++c) {
+                        dst_x[c] = 0;
+                    }
+                }
+            }
+        }
+    });
+}
+
+Status X86Preprocess(Mat &src, const CropParam &crop, InterpType interp_type, bool reverse_channel,
+                     const float *scale, const float *bias, DataType data_type, const DimsVector &dims, void *dst) {
+    const int src_channel = X86PreprocessSrcChannel(src.GetMatType());
+    const int channel     = DimsFunctionUtils::GetDim(dims, 1);
+    if (src_channel == 0 || channel <= 0 || channel > src_channel) {
+        return Status(TNNERR_PARAM_ERR, "X86Preprocess, mat type or blob channel not support yet");
+    }
+    if (data_type != DATA_TYPE_FLOAT && data_type != DATA_TYPE_INT8) {
+        return Status(TNNERR_PARAM_ERR, "X86Preprocess, blob data type not support yet");
+    }
+    if (interp_type != INTERP_TYPE_LINEAR && interp_type != INTERP_TYPE_NEAREST) {
+        return Status(TNNERR_PARAM_ERR, "X86Preprocess, interpolation type not support yet");
+    }
+
+    // blob channel c reads src channel channel_map[c], reverse_channel swaps b and r
+    std::vector<int> channel_map(channel);
+    for (int c = 0; c < channel; ++c) {
+        channel_map[c] = (reverse_channel && src_channel >= 3 && c < 3) ? 2 - c : c;
+    }
+
+    auto data = reinterpret_cast<const uint8_t *>(src.GetData());
+    if (cpu_with_isa(avx2) || cpu_with_isa(avx)) {
+        X86PreprocessImpl<Float8, 8>(data, src.GetMatType(), src.GetWidth(), src.GetHeight(), crop, interp_type,
+                                     channel_map.data(), scale, bias, data_type, dims, dst);
+    } else {
+        X86PreprocessImpl<Float4, 4>(data, src.GetMatType(), src.GetWidth(), src.GetHeight(), crop, interp_type,
+                                     channel_map.data(), scale, bias, data_type, dims, dst);
+    }
+    return TNN_OK;
+}
+
+}  // namespace TNN_NS
@@ -0,0 +1,36 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef SOURCE_TNN_DEVICE_X86_ACC_X86_PREPROCESS_H_
+#define SOURCE_TNN_DEVICE_X86_ACC_X86_PREPROCESS_H_
+
+#include "tnn/core/common.h"
+#include "tnn/core/mat.h"
+#include "tnn/core/status.h"
+#include "tnn/utils/mat_utils.h"
+
+namespace TNN_NS {
+
+// @brief number of channels a src mat expands to in X86Preprocess, 0 if the mat type is not supported
+int X86PreprocessSrcChannel(MatType mat_type);
+
+// @brief convert color, crop, resize and normalize src into a nchw float blob or a nhwc4 int8 blob in one pass,
+// rows of dst are computed in parallel and each src row is expanded to float only once per thread.
+// scale and bias hold one value per blob channel, for int8 blobs they are already divided by the blob scale.
+Status X86Preprocess(Mat &src, const CropParam &crop, InterpType interp_type, bool reverse_channel,
+                     const float *scale, const float *bias, DataType data_type, const DimsVector &dims, void *dst);
+
+}  // namespace TNN_NS
+
+#endif  // SOURCE_TNN_DEVICE_X86_ACC_X86_PREPROCESS_H_
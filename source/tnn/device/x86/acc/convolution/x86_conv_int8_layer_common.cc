@@ -13,6 +13,7 @@
 // specific language governing permissions and limitations under the License.
 
 #include "tnn/device/x86/acc/convolution/x86_conv_int8_layer_common.h"
+#include "tnn/core/packed_weight_cache.h"
 
 #include "tnn/device/x86/x86_common.h"
 #include "tnn/device/x86/x86_context.h"
@@ -20,7 +21,7 @@
 #include "tnn/utils/data_format_converter.h"
 #include "tnn/utils/data_type_utils.h"
 #include "tnn/utils/dims_vector_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 #include "tnn/utils/naive_compute.h"
 
 namespace TNN_NS {
@@ -65,17 +66,23 @@ Status X86ConvInt8LayerCommon::allocateBufferWeight(const std::vector<Blob *> &i
 
         int weight_count   = group * oc_g_r4 * icrs_g_r16;
         int data_byte_size = weight_count * DataTypeUtils::GetBytesSize(conv_res->filter_handle.GetDataType());
-        RawBuffer temp_buffer(data_byte_size + SIMD_KERNEL_EXTRA_LOAD);
-
-        for (int g = 0; g < group; g++) {
-            auto weight_src_g = conv_res->filter_handle.force_to<int8_t *>() + g * oc_g * icrs_g;
-            auto weight_dst_g = temp_buffer.force_to<int8_t *>() + g * oc_g_r4 * icrs_g_r16;
-            // from [o][i][h][w]
-            // to: [o/4][h][w][i/16][o4][i16]
-            PackINT8Weight(weight_src_g, weight_dst_g, ic_g, oc_g,
-                           conv_param->kernels[1], conv_param->kernels[0]);
-        }
-        buffer_weight_ = temp_buffer;
+
+        auto key = PackedWeightCache::CreateKey(context_, param_, DEVICE_X86, "conv_int8_common",
+                                                conv_res->filter_handle);
+        return PackedWeightCache::GetOrPack(key, [&](RawBuffer &packed) -> Status {
+            RawBuffer temp_buffer(data_byte_size + SIMD_KERNEL_EXTRA_LOAD);
+
+            for (int g = 0; g < group; g++) {
+                auto weight_src_g = conv_res->filter_handle.force_to<int8_t *>() + g * oc_g * icrs_g;
+                auto weight_dst_g = temp_buffer.force_to<int8_t *>() + g * oc_g_r4 * icrs_g_r16;
+                // from [o][i][h][w]
+                // to: [o/4][h][w][i/16][o4][i16]
+                PackINT8Weight(weight_src_g, weight_dst_g, ic_g, oc_g,
+                               conv_param->kernels[1], conv_param->kernels[0]);
+            }
+            packed = temp_buffer;
+            return TNN_OK;
+        }, buffer_weight_);
     }
     return TNN_OK;
 }
@@ -385,6 +392,12 @@ void GemmInt8(int8_t* dst, const int8_t* src, const int8_t* weight, const int32_
         gemm_kernel = X86AVXGemmInt8Unit4x4;
     }
 #endif
+#ifdef TNN_X86_VNNI_ENABLE
+    static const bool has_vnni = cpu_with_isa(avx512_vnni);
+    if (arch == avx2 && has_vnni) {
+        gemm_kernel = X86VNNIGemmInt8Unit4x4;
+    }
+#endif
 
     for (int j = 0; j < dst_depth; j += 4) {
         int hw = 0;
@@ -477,7 +490,7 @@ Status X86ConvInt8LayerCommon::DoForward(const std::vector<Blob *> &inputs, cons
     int tile_count = UP_DIV(dims_output[2] * dims_output[3], tile_blk_);
 
     // for multi-threads, adjust tile_blk to make more threads parallel
-    int max_num_threads = OMP_MAX_THREADS_NUM_;
+    int max_num_threads = GetParallelMaxThreads();
     if (max_num_threads > 1) {
         while (tile_count < max_num_threads && tile_blk_ > SIMD_INT8CONV_TILE_HW) {
             tile_blk_ = ROUND_UP(tile_blk_ / 2, SIMD_INT8CONV_TILE_HW);
@@ -523,9 +536,7 @@ Status X86ConvInt8LayerCommon::DoForward(const std::vector<Blob *> &inputs, cons
             auto relu6_max_g = relu6_max_.force_to<int8_t *>() + g * oc_g;
             auto weight_g    = weight_ptr + g * kernel_group_stride;
 
-            OMP_PARALLEL_FOR_GUIDED_
-            for (int t_idx = 0; t_idx < tile_count; t_idx++) {
-                int thread_id          = OMP_TID_;
+            ParallelForWithThreadId(0, tile_count, [&](int t_idx, int thread_id) {
                 int8_t *input_kernel   = nullptr;
                 const int hw_start     = t_idx * tile_blk_;
                 const int real_hw_tile = MIN(output_channel_stride - hw_start, tile_blk_);
@@ -547,7 +558,7 @@ Status X86ConvInt8LayerCommon::DoForward(const std::vector<Blob *> &inputs, cons
                          real_hw_tile, crs_div8, crs_div8 * 8, oc_g_r4, relu_,
                          add_input_kernel, buffer_add_scale_.force_to<float *>(),
                          relu6_max_g, arch_);
-            }
+            });
 
             if (conv_param->group > 1) {
                 auto output_ptr = output_batch + g * oc_g;
@@ -19,7 +19,7 @@
 #include "tnn/device/x86/acc/compute/x86_compute_int8.h"
 #include "tnn/utils/data_format_converter.h"
 #include "tnn/utils/data_type_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 bool X86ConvInt8LayerDepthwise::isPrefered(ConvLayerParam *param, const std::vector<Blob *> &inputs,
@@ -156,27 +156,23 @@ Status X86ConvInt8LayerDepthwise::DoForward(const std::vector<Blob *> &inputs, c
             dwfunc = X86DepthwiseI8K5;
         }
 
-        OMP_PARALLEL_SECTIONS_ {
-            OMP_SECTION_ {
+        ParallelFor(0, 4, [&](int corner) {
+            if (corner == 0) {
                 // top corner
                 RunCorner(output_batch, input_batch, 0, 0, dims_output[3], t);
-            }
-            OMP_SECTION_ {
+            } else if (corner == 1) {
                 // bottom corner
                 RunCorner(output_batch, input_batch, 0, b, dims_output[3], dims_output[2]);
-            }
-            OMP_SECTION_ {
+            } else if (corner == 2) {
                 // left corner
                 RunCorner(output_batch, input_batch, 0, t, l, b);
-            }
-            OMP_SECTION_ {
+            } else {
                 // bottom corner
                 RunCorner(output_batch, input_batch, r, t, dims_output[3], b);
             }
-        }
+        });
         if (r > l && b > t) {
-            OMP_PARALLEL_FOR_GUIDED_
-            for (long dy = t; dy < b; ++dy) {
+            ParallelFor(t, b, [&](long dy) {
                 const long src_start_y = dy * conv_param->strides[1] - conv_param->pads[2];
                 const auto src_dy      = input_batch + src_start_y * src_y_step;
                 auto dst_y             = output_batch + dy * dst_y_step;
@@ -185,7 +181,7 @@ Status X86ConvInt8LayerDepthwise::DoForward(const std::vector<Blob *> &inputs, c
                        weight_data, bias_data,
                        r - l, src_y_step * dilate_y, oc_r4 * dilate_x, src_w_step, oc_r4,
                        conv_param->kernels[0], conv_param->kernels[1], scale_data);
-            }
+            });
         }
 
         if (conv_param->activation_type == ActivationType_ReLU) {
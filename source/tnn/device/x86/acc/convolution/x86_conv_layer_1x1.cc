@@ -20,7 +20,7 @@
 #include "tnn/interpreter/raw_buffer.h"
 #include "tnn/utils/data_format_converter.h"
 #include "tnn/utils/data_type_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 bool X86ConvLayer1x1::isPrefered(ConvLayerParam *param, const std::vector<Blob *> &inputs,
@@ -63,7 +63,6 @@ Status X86ConvLayer1x1::DoForward(const std::vector<Blob *> &inputs, const std::
     int dst_z_step     = dims_output[2] * dims_output[3];
     int src_z_step     = dims_input[2] * dims_input[3];
 
-    float *weights_data = buffer_weight_.force_to<float*>();
     float *bias_data    = buffer_bias_.force_to<float*>();
 
     const float *src_origin = handle_ptr<const float *>(input->GetHandle());
@@ -74,22 +73,37 @@ Status X86ConvLayer1x1::DoForward(const std::vector<Blob *> &inputs, const std::
     int n = src_z_step;
     int k = dims_input[1];
 
-    int max_num_threads = OMP_MAX_THREADS_NUM_;
+    int max_num_threads = GetParallelMaxThreads();
     conv_ajust_m_blk_size(max_num_threads, src_z_step, conv_gemm_conf_.M_c_);
 
     int m_c = conv_gemm_conf_.M_c_;
     int k_c = conv_gemm_conf_.K_c_;
+    int n_block = conv_gemm_conf_.n_block_;
 
-    float *src_buf = reinterpret_cast<float *>(
-        context_->GetSharedWorkSpace(m_c * k_c * max_num_threads * sizeof(float)));
+    conv_gemm_packed_weight packed_weight;
+    packed_weight.data        = buffer_weight_.force_to<void *>();
+    packed_weight.data_type   = buffer_weight_.GetDataType();
+    packed_weight.unpack_func = X86Convert16BitToFloat;
+
+    size_t src_buf_bytes = ROUND_UP(m_c * k_c * max_num_threads * sizeof(float), 32);
+    size_t weight_block_bytes =
+        packed_weight.data_type == DATA_TYPE_FLOAT ? 0 : k_c * ROUND_UP(m, n_block) * sizeof(float);
+    float *src_buf = reinterpret_cast<float *>(context_->GetSharedWorkSpace(src_buf_bytes + weight_block_bytes));
+    packed_weight.block_buf = src_buf + src_buf_bytes / sizeof(float);
+
+    const float *residual_data = nullptr;
+    RETURN_ON_NEQ(GetResidual(inputs, outputs, &residual_data), TNN_OK);
 
     for (int batch_idx = 0; batch_idx < batch; batch_idx++) {
         const float * B = src_origin + batch_idx * k * n;
-        const float * A = weights_data;
         float * C = dst_origin + batch_idx * m * n;
 
-        conv_sgemm_nn_col_major_prepack_b(n, m, k, B, n, A, k, C, n,
-            bias_data, param->activation_type, src_buf, conv_gemm_conf_);
+        conv_gemm_epilogue epilogue = epilogue_;
+        if (residual_data) {
+            epilogue.residual = residual_data + batch_idx * m * n;
+        }
+        conv_sgemm_nn_col_major_prepack_b(n, m, k, B, n, packed_weight, k, C, n,
+            bias_data, epilogue, src_buf, conv_gemm_conf_);
     }
 
     return TNN_OK;
@@ -13,6 +13,7 @@
 // specific language governing permissions and limitations under the License.
 
 #include "tnn/device/x86/acc/convolution/x86_conv_layer_3x3.h"
+#include "tnn/core/packed_weight_cache.h"
 #include "tnn/device/x86/acc/Float4.h"
 #include "tnn/device/x86/acc/Float8.h"
 #include "tnn/device/x86/acc/compute/x86_compute.h"
@@ -23,7 +24,8 @@
 #include "tnn/interpreter/raw_buffer.h"
 #include "tnn/utils/data_format_converter.h"
 #include "tnn/utils/data_type_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
+#include "tnn/utils/string_utils_inner.h"
 
 namespace TNN_NS {
 
@@ -69,10 +71,8 @@ static void weight_transform(const float *src, float *dst, int kernel_size, int
 
             auto dst_sz = dst_oz + zi * ic_stride + CH_PACK * ri;
 
-            for (int i = 0; i < unit; i++) {
-                for (int j = 0; j < unit; j++) {
-                    *(dst_sz + (j * unit + i) * unit_stride) = K_trans[i * unit + j];
-                }
+            for (int i = 0; i < unit * unit; i++) {
+                *(dst_sz + i * unit_stride) = K_trans[i];
             }
         }
     }
@@ -401,179 +401,200 @@ static void gemm_kernel_avx(float *dst, float *src, const float *weight, const f
     }
 }
 
-// BT=[1, 0, -1, 0,
-//    0, 1,  1, 0,
-//    0, -1, 1, 0,
-//    0, 1,  0, -1]
+// 1-D winograd transforms of F(m, 3), applied on rows then on columns.
+// Input computes BT * s with src_unit = m + 2 values, Output computes AT * s.
+template <typename VEC, int DST_UNIT>
+struct WinogradTransform;
+
+// BT=[1,  0, -1,  0,
+//     0,  1,  1,  0,
+//     0, -1,  1,  0,
+//     0,  1,  0, -1]
+// AT=[1,  1,  1,  0,
+//     0,  1, -1, -1]
 template <typename VEC>
-static void input_trans_4x4(const float *src, int src_stride, int src_h_stride, float *dest, int dest_stride,
-                            int dest_h_stride) {
-    VEC src00 = VEC::loadu(src);
-    VEC src01 = VEC::loadu(src + src_stride);
-    VEC src02 = VEC::loadu(src + src_stride + src_stride);
-    VEC src03 = VEC::loadu(src + src_stride + src_stride + src_stride);
-    src += src_h_stride;
-    VEC src10 = VEC::loadu(src);
-    VEC src11 = VEC::loadu(src + src_stride);
-    VEC src12 = VEC::loadu(src + src_stride + src_stride);
-    VEC src13 = VEC::loadu(src + src_stride + src_stride + src_stride);
-    src += src_h_stride;
-    VEC src20 = VEC::loadu(src);
-    VEC src21 = VEC::loadu(src + src_stride);
-    VEC src22 = VEC::loadu(src + src_stride + src_stride);
-    VEC src23 = VEC::loadu(src + src_stride + src_stride + src_stride);
-    src += src_h_stride;
-    VEC src30 = VEC::loadu(src);
-    VEC src31 = VEC::loadu(src + src_stride);
-    VEC src32 = VEC::loadu(src + src_stride + src_stride);
-    VEC src33 = VEC::loadu(src + src_stride + src_stride + src_stride);
-
-    VEC dst00 = (src00 - src02);
-    VEC dst10 = (src01 + src02);
-    VEC dst20 = (src02 - src01);
-    VEC dst30 = (src01 - src03);
-
-    VEC dst01 = (src10 - src12);
-    VEC dst11 = (src11 + src12);
-    VEC dst21 = (src12 - src11);
-    VEC dst31 = (src11 - src13);
-
-    VEC dst02 = (src20 - src22);
-    VEC dst12 = (src21 + src22);
-    VEC dst22 = (src22 - src21);
-    VEC dst32 = (src21 - src23);
-
-    VEC dst03 = (src30 - src32);
-    VEC dst13 = (src31 + src32);
-    VEC dst23 = (src32 - src31);
-    VEC dst33 = (src31 - src33);
-
-    VEC dest00 = (dst00 - dst02);
-    VEC dest10 = (dst01 + dst02);
-    VEC dest20 = (dst02 - dst01);
-    VEC dest30 = (dst01 - dst03);
-
-    VEC dest01 = (dst10 - dst12);
-    VEC dest11 = (dst11 + dst12);
-    VEC dest21 = (dst12 - dst11);
-    VEC dest31 = (dst11 - dst13);
-
-    VEC dest02 = (dst20 - dst22);
-    VEC dest12 = (dst21 + dst22);
-    VEC dest22 = (dst22 - dst21);
-    VEC dest32 = (dst21 - dst23);
-
-    VEC dest03 = (dst30 - dst32);
-    VEC dest13 = (dst31 + dst32);
-    VEC dest23 = (dst32 - dst31);
-    VEC dest33 = (dst31 - dst33);
-
-    VEC::saveu(dest, dest00);
-    VEC::saveu(dest + dest_stride, dest10);
-    VEC::saveu(dest + dest_stride + dest_stride, dest20);
-    VEC::saveu(dest + dest_stride + dest_stride + dest_stride, dest30);
-    dest += dest_h_stride;
-    VEC::saveu(dest, dest01);
-    VEC::saveu(dest + dest_stride, dest11);
-    VEC::saveu(dest + dest_stride + dest_stride, dest21);
-    VEC::saveu(dest + dest_stride + dest_stride + dest_stride, dest31);
-    dest += dest_h_stride;
-    VEC::saveu(dest, dest02);
-    VEC::saveu(dest + dest_stride, dest12);
-    VEC::saveu(dest + dest_stride + dest_stride, dest22);
-    VEC::saveu(dest + dest_stride + dest_stride + dest_stride, dest32);
-    dest += dest_h_stride;
-    VEC::saveu(dest, dest03);
-    VEC::saveu(dest + dest_stride, dest13);
-    VEC::saveu(dest + dest_stride + dest_stride, dest23);
-    VEC::saveu(dest + dest_stride + dest_stride + dest_stride, dest33);
-}
-template void input_trans_4x4<Float8>(const float *src, int src_stride, int src_h_stride, float *dest, int dest_stride,
-                                      int dest_h_stride);
-template void input_trans_4x4<Float4>(const float *src, int src_stride, int src_h_stride, float *dest, int dest_stride,
-                                      int dest_h_stride);
-
-// AT=[1, 1,  1,  0,
-//    0, 1, -1, -1
+struct WinogradTransform<VEC, 2> {
+    static void Input(const VEC *s, VEC *d) {
+        d[0] = s[0] - s[2];
+        d[1] = s[1] + s[2];
+        d[2] = s[2] - s[1];
+        d[3] = s[1] - s[3];
+    }
+    static void Output(const VEC *s, VEC *d) {
+        d[0] = s[0] + s[1] + s[2];
+        d[1] = s[1] - s[2] - s[3];
+    }
+};
+
+// BT=[4,  0, -5,  0, 1, 0,
+//     0, -4, -4,  1, 1, 0,
+//     0,  4, -4, -1, 1, 0,
+//     0, -2, -1,  2, 1, 0,
+//     0,  2, -1, -2, 1, 0,
+//     0,  4,  0, -5, 0, 1]
+// AT=[1,  1,  1,  1,  1, 0,
+//     0,  1, -1,  2, -2, 0,
+//     0,  1,  1,  4,  4, 0,
+//     0,  1, -1,  8, -8, 1]
 template <typename VEC>
-static void output_trans_post_2x4(const float *src, int src_stride, int src_h_stride, float *dest, int dest_stride,
-                                  int dest_h_stride, const float *bias_value, int relu_type) {
-    VEC src00 = VEC::loadu(src);
-    VEC src01 = VEC::loadu(src + src_stride);
-    VEC src02 = VEC::loadu(src + src_stride + src_stride);
-    VEC src03 = VEC::loadu(src + src_stride + src_stride + src_stride);
-    src += src_h_stride;
-    VEC src10 = VEC::loadu(src);
-    VEC src11 = VEC::loadu(src + src_stride);
-    VEC src12 = VEC::loadu(src + src_stride + src_stride);
-    VEC src13 = VEC::loadu(src + src_stride + src_stride + src_stride);
-    src += src_h_stride;
-    VEC src20 = VEC::loadu(src);
-    VEC src21 = VEC::loadu(src + src_stride);
-    VEC src22 = VEC::loadu(src + src_stride + src_stride);
-    VEC src23 = VEC::loadu(src + src_stride + src_stride + src_stride);
-    src += src_h_stride;
-    VEC src30 = VEC::loadu(src);
-    VEC src31 = VEC::loadu(src + src_stride);
-    VEC src32 = VEC::loadu(src + src_stride + src_stride);
-    VEC src33 = VEC::loadu(src + src_stride + src_stride + src_stride);
-
-    VEC dst00 = (src00 + src01 + src02);
-    VEC dst10 = (src01 - src02 - src03);
-    VEC dst01 = (src10 + src11 + src12);
-    VEC dst11 = (src11 - src12 - src13);
-    VEC dst02 = (src20 + src21 + src22);
-    VEC dst12 = (src21 - src22 - src23);
-    VEC dst03 = (src30 + src31 + src32);
-    VEC dst13 = (src31 - src32 - src33);
-
-    VEC dest00 = (dst00 + dst01 + dst02);
-    VEC dest10 = (dst01 - dst02 - dst03);
-    VEC dest01 = (dst10 + dst11 + dst12);
-    VEC dest11 = (dst11 - dst12 - dst13);
-
-    if (bias_value) {
-        VEC bias = VEC::loadu(bias_value);
-        dest00   = (dest00 + bias);
-        dest10   = (dest10 + bias);
-        dest01   = (dest01 + bias);
-        dest11   = (dest11 + bias);
+struct WinogradTransform<VEC, 4> {
+    static void Input(const VEC *s, VEC *d) {
+        VEC t0 = s[4] - s[2] * 4.f;
+        VEC t1 = s[3] - s[1] * 4.f;
+        VEC t2 = s[4] - s[2];
+        VEC t3 = (s[3] - s[1]) * 2.f;
+        d[0]   = s[0] * 4.f - s[2] * 5.f + s[4];
+        d[1]   = t0 + t1;
+        d[2]   = t0 - t1;
+        d[3]   = t2 + t3;
+        d[4]   = t2 - t3;
+        d[5]   = s[1] * 4.f - s[3] * 5.f + s[5];
     }
-
-    if (relu_type == ActivationType_ReLU || relu_type == ActivationType_ReLU6) {
-        VEC zeros = VEC(0.f);
-        dest00    = VEC::max(dest00, zeros);
-        dest10    = VEC::max(dest10, zeros);
-        dest01    = VEC::max(dest01, zeros);
-        dest11    = VEC::max(dest11, zeros);
+    static void Output(const VEC *s, VEC *d) {
+        VEC a = s[1] + s[2];
+        VEC b = s[1] - s[2];
+        VEC c = s[3] + s[4];
+        VEC e = s[3] - s[4];
+        d[0]  = s[0] + a + c;
+        d[1]  = b + e * 2.f;
+        d[2]  = a + c * 4.f;
+        d[3]  = b + e * 8.f + s[5];
+    }
+};
+
+// BT=[1,    0, -5.25,     0,  5.25,     0, -1, 0,
+//     0,    1,     1, -4.25, -4.25,     1,  1, 0,
+//     0,   -1,     1,  4.25, -4.25,    -1,  1, 0,
+//     0,  0.5,  0.25,  -2.5, -1.25,     2,  1, 0,
+//     0, -0.5,  0.25,   2.5, -1.25,    -2,  1, 0,
+//     0,    2,     4,  -2.5,    -5,   0.5,  1, 0,
+//     0,   -2,     4,   2.5,    -5,  -0.5,  1, 0,
+//     0,   -1,     0,  5.25,     0, -5.25,  0, 1]
+// AT=[1,  1,  1,  1,   1, 32,  32, 0,
+//     0,  1, -1,  2,  -2, 16, -16, 0,
+//     0,  1,  1,  4,   4,  8,   8, 0,
+//     0,  1, -1,  8,  -8,  4,  -4, 0,
+//     0,  1,  1, 16,  16,  2,   2, 0,
+//     0,  1, -1, 32, -32,  1,  -1, 1]
+template <typename VEC>
+struct WinogradTransform<VEC, 6> {
+    static void Input(const VEC *s, VEC *d) {
+        VEC t0 = s[2] + s[6] - s[4] * 4.25f;
+        VEC t1 = s[1] + s[5] - s[3] * 4.25f;
+        VEC t2 = s[6] + s[2] * 0.25f - s[4] * 1.25f;
+        VEC t3 = s[1] * 0.5f - s[3] * 2.5f + s[5] * 2.f;
+        VEC t4 = s[6] + (s[2] - s[4] * 1.25f) * 4.f;
+        VEC t5 = s[1] * 2.f - s[3] * 2.5f + s[5] * 0.5f;
+        d[0]   = s[0] - s[6] + (s[4] - s[2]) * 5.25f;
+        d[1]   = t0 + t1;
+        d[2]   = t0 - t1;
+        d[3]   = t2 + t3;
+        d[4]   = t2 - t3;
+        d[5]   = t4 + t5;
+        d[6]   = t4 - t5;
+        d[7]   = s[7] - s[1] + (s[3] - s[5]) * 5.25f;
+    }
+    static void Output(const VEC *s, VEC *d) {
+        VEC a = s[1] + s[2];
+        VEC b = s[1] - s[2];
+        VEC c = s[3] + s[4];
+        VEC e = s[3] - s[4];
+        VEC f = s[5] + s[6];
+        VEC h = s[5] - s[6];
+        d[0]  = s[0] + a + c + f * 32.f;
+        d[1]  = b + e * 2.f + h * 16.f;
+        d[2]  = a + c * 4.f + f * 8.f;
+        d[3]  = b + e * 8.f + h * 4.f;
+        d[4]  = a + c * 16.f + f * 2.f;
+        d[5]  = s[7] + b + e * 32.f + h;
+    }
+};
+
+// G of F(m, 3) by dst unit, weights are transformed as G * g * GT
+static const float g_winograd_g2[4][3] = {{1.0f, 0.0f, 0.0f}, {0.5f, 0.5f, 0.5f}, {0.5f, -0.5f, 0.5f}, {0.0f, 0.0f, 1.0f}};
+static const float g_winograd_g4[6][3] = {{1.0f / 4, 0.0f, 0.0f},          {-1.0f / 6, -1.0f / 6, -1.0f / 6},
+                                          {-1.0f / 6, 1.0f / 6, -1.0f / 6}, {1.0f / 24, 1.0f / 12, 1.0f / 6},
+                                          {1.0f / 24, -1.0f / 12, 1.0f / 6}, {0.0f, 0.0f, 1.0f}};
+static const float g_winograd_g6[8][3] = {{1.0f, 0.0f, 0.0f},           {-2.0f / 9, -2.0f / 9, -2.0f / 9},
+                                          {-2.0f / 9, 2.0f / 9, -2.0f / 9}, {1.0f / 90, 1.0f / 45, 2.0f / 45},
+                                          {1.0f / 90, -1.0f / 45, 2.0f / 45}, {1.0f / 45, 1.0f / 90, 1.0f / 180},
+                                          {1.0f / 45, -1.0f / 90, 1.0f / 180}, {0.0f, 0.0f, 1.0f}};
+
+// element (y, x) of the transformed tile is stored at dest + x * dest_stride + y * dest_h_stride
+template <typename VEC, int DST_UNIT>
+static void input_trans(const float *src, int src_stride, int src_h_stride, float *dest, int dest_stride,
+                        int dest_h_stride) {
+    const int src_unit = DST_UNIT + 2;
+    VEC s[src_unit];
+    VEC d[src_unit];
+    VEC m[src_unit][src_unit];
+
+    for (int y = 0; y < src_unit; y++) {
+        for (int x = 0; x < src_unit; x++) {
+            s[x] = VEC::loadu(src + y * src_h_stride + x * src_stride);
+        }
+        WinogradTransform<VEC, DST_UNIT>::Input(s, m[y]);
     }
-    if (relu_type == ActivationType_ReLU6) {
-        VEC sixs  = VEC(6.f);
-        dest00    = VEC::min(dest00, sixs);
-        dest10    = VEC::min(dest10, sixs);
-        dest01    = VEC::min(dest01, sixs);
-        dest11    = VEC::min(dest11, sixs);
+    for (int x = 0; x < src_unit; x++) {
+        for (int y = 0; y < src_unit; y++) {
+            s[y] = m[y][x];
+        }
+        WinogradTransform<VEC, DST_UNIT>::Input(s, d);
+        for (int y = 0; y < src_unit; y++) {
+            VEC::saveu(dest + x * dest_stride + y * dest_h_stride, d[y]);
+        }
+    }
+}
+
+template <typename VEC, int DST_UNIT>
+static void output_trans_post(const float *src, int src_stride, int src_h_stride, float *dest, int dest_stride,
+                              int dest_h_stride, const float *bias_value, int relu_type) {
+    const int src_unit = DST_UNIT + 2;
+    VEC s[src_unit];
+    VEC d[DST_UNIT];
+    VEC m[src_unit][DST_UNIT];
+
+    for (int y = 0; y < src_unit; y++) {
+        for (int x = 0; x < src_unit; x++) {
+            s[x] = VEC::loadu(src + y * src_h_stride + x * src_stride);
+        }
+        WinogradTransform<VEC, DST_UNIT>::Output(s, m[y]);
     }
 
-    VEC::saveu(dest, dest00);
-    VEC::saveu(dest + dest_stride, dest10);
-    dest += dest_h_stride;
-    VEC::saveu(dest, dest01);
-    VEC::saveu(dest + dest_stride, dest11);
+    VEC bias  = bias_value ? VEC::loadu(bias_value) : VEC(0.f);
+    VEC zeros = VEC(0.f);
+    VEC sixs  = VEC(6.f);
+    for (int x = 0; x < DST_UNIT; x++) {
+        for (int y = 0; y < src_unit; y++) {
+            s[y] = m[y][x];
+        }
+        WinogradTransform<VEC, DST_UNIT>::Output(s, d);
+        for (int y = 0; y < DST_UNIT; y++) {
+            VEC v = d[y] + bias;
+            if (relu_type == ActivationType_ReLU || relu_type == ActivationType_ReLU6) {
+                v = VEC::max(v, zeros);
+            }
+            if (relu_type == ActivationType_ReLU6) {
+                v = VEC::min(v, sixs);
+            }
+            VEC::saveu(dest + x * dest_stride + y * dest_h_stride, v);
+        }
+    }
 }
-template void output_trans_post_2x4<Float8>(const float *src, int src_stride, int src_h_stride, float *dest,
-                                            int dest_stride, int dest_h_stride, const float *bias_value, int relu_type);
-template void output_trans_post_2x4<Float4>(const float *src, int src_stride, int src_h_stride, float *dest,
-                                            int dest_stride, int dest_h_stride, const float *bias_value, int relu_type);
 
-bool X86ConvLayer3x3::isPrefered(ConvLayerParam *param, const std::vector<Blob *> &inputs,
-                                 const std::vector<Blob *> &outputs) {
+/*
+dst unit of winograd F(m, 3) for the conv, 0 if winograd is not used
+x86_winograd_unit2, x86_winograd_unit4 and x86_winograd_unit6 in extra config force the unit,
+otherwise the unit with the lowest estimated cost is chosen, F(2, 3) by default
+*/
+int X86ConvLayer3x3::SelectWinogradUnit(ConvLayerParam *param, const std::vector<Blob *> &inputs,
+                                        const std::vector<Blob *> &outputs) {
     if (!param) {
-        return false;
+        return 0;
     }
 
     if (param->group != 1) {
-        return false;
+        return 0;
     }
 
     const int kw = param->kernels[0];
@@ -584,11 +605,52 @@ bool X86ConvLayer3x3::isPrefered(ConvLayerParam *param, const std::vector<Blob *
     const int sh = param->strides[1];
     const int ic = inputs[0]->GetBlobDesc().dims[1];
 
-    return kw == 3 && kh == 3 && dw == 1 && dh == 1 && sw == 1 && sh == 1 && ic >= 16;
+    if (!(kw == 3 && kh == 3 && dw == 1 && dh == 1 && sw == 1 && sh == 1 && ic >= 16)) {
+        return 0;
+    }
+
+    if (param->extra_config.count("x86_winograd_unit2")) {
+        return 2;
+    } else if (param->extra_config.count("x86_winograd_unit4")) {
+        return 4;
+    } else if (param->extra_config.count("x86_winograd_unit6")) {
+        return 6;
+    }
+
+    const int oc = outputs[0]->GetBlobDesc().dims[1];
+    const int oh = outputs[0]->GetBlobDesc().dims[2];
+    const int ow = outputs[0]->GetBlobDesc().dims[3];
+    const float ic_r = (float)ROUND_UP(ic, 8);
+    const float oc_r = (float)ROUND_UP(oc, 8);
+
+    int dst_unit   = 2;
+    float min_cost = 0;
+    for (int u = 2; u <= 6; u += 2) {
+        float src_unit = (float)(u + 2);
+        // src transform + gemm + dst transform of all tiles
+        float cost = (2 * src_unit * src_unit * src_unit * ic_r + src_unit * src_unit * ic_r * oc_r +
+                      2 * src_unit * u * u * oc_r) *
+                     (UP_DIV(ow, u) * UP_DIV(oh, u));
+        // larger tiles need 10% gain, they touch more memory per tile and lose some precision
+        if (u == 2 || cost * 1.1f < min_cost) {
+            min_cost = cost;
+            dst_unit = u;
+        }
+    }
+    return dst_unit;
+}
+
+bool X86ConvLayer3x3::isPrefered(ConvLayerParam *param, const std::vector<Blob *> &inputs,
+                                 const std::vector<Blob *> &outputs) {
+    return SelectWinogradUnit(param, inputs, outputs) > 0;
 }
 
 X86ConvLayer3x3::~X86ConvLayer3x3() {}
 
+void X86ConvLayer3x3::SetWinogradUnit(int dst_unit) {
+    tuned_unit_ = dst_unit;
+}
+
 Status X86ConvLayer3x3::allocateBufferWeight(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
     ConvLayerParam *param = dynamic_cast<ConvLayerParam *>(param_);
     CHECK_PARAM_NULL(param);
@@ -604,20 +666,38 @@ Status X86ConvLayer3x3::allocateBufferWeight(const std::vector<Blob *> &inputs,
         if (arch_ == avx2)
             CH_PACK = 8;
 
+        dst_unit_ = tuned_unit_ > 0 ? tuned_unit_ : SelectWinogradUnit(param, inputs, outputs);
+        if (dst_unit_ != 4 && dst_unit_ != 6) {
+            dst_unit_ = 2;
+        }
+        const int src_unit = dst_unit_ + 2;
+
         const int input_channel  = dims_input[1];
         const int output_channel = dims_output[1];
-        const int weight_count   = ROUND_UP(input_channel, CH_PACK) * ROUND_UP(output_channel, CH_PACK) * 4 * 4;
+        const int weight_count =
+            ROUND_UP(input_channel, CH_PACK) * ROUND_UP(output_channel, CH_PACK) * src_unit * src_unit;
         const int data_byte_size = DataTypeUtils::GetBytesSize(conv_res->filter_handle.GetDataType());
 
         if (conv_res->filter_handle.GetDataType() == DATA_TYPE_FLOAT) {
-            RawBuffer pack_buffer(weight_count * data_byte_size);
-            float *dst = pack_buffer.force_to<float *>();
-
-            const float G[4][3] = {{1.0f, 0.0f, 0.0f}, {0.5f, 0.5f, 0.5f}, {0.5f, -0.5f, 0.5f}, {0.0f, 0.0f, 1.0f}};
-            weight_transform(src, dst, 3, 4, input_channel, output_channel, CH_PACK, G);
+            auto variant = "conv_3x3_winograd_" + ToString(src_unit) + "x" + ToString(src_unit) + "_" +
+                           ToString(CH_PACK);
+            auto key     = PackedWeightCache::CreateKey(context_, param_, DEVICE_X86, variant, conv_res->filter_handle);
+            return PackedWeightCache::GetOrPack(key, [&](RawBuffer &packed) -> Status {
+                RawBuffer pack_buffer(weight_count * data_byte_size);
+                float *dst = pack_buffer.force_to<float *>();
+
+                const float(*G)[3] = g_winograd_g2;
+                if (dst_unit_ == 4) {
+                    G = g_winograd_g4;
+                } else if (dst_unit_ == 6) {
+                    G = g_winograd_g6;
+                }
+                weight_transform(src, dst, 3, src_unit, input_channel, output_channel, CH_PACK, G);
 
-            pack_buffer.SetDataType(DATA_TYPE_FLOAT);
-            buffer_weight_ = pack_buffer;
+                pack_buffer.SetDataType(DATA_TYPE_FLOAT);
+                packed = pack_buffer;
+                return TNN_OK;
+            }, buffer_weight_);
         } else {
             LOGE("Error: DataType %d not support\n", conv_res->filter_handle.GetDataType());
             return Status(TNNERR_MODEL_ERR, "conv_res DataType is not supported");
@@ -665,26 +745,40 @@ Status X86ConvLayer3x3::DoForward(const std::vector<Blob *> &inputs, const std::
     int ic_stride    = width_in * height_in;
     int oc_stride    = width_out * height_out;
 
-    auto input_trans_func  = input_trans_4x4<Float4>;
-    auto output_trans_func = output_trans_post_2x4<Float4>;
+    const int dst_unit = dst_unit_;
+    const int src_unit = dst_unit + 2;
+
+    auto input_trans_func  = input_trans<Float4, 2>;
+    auto output_trans_func = output_trans_post<Float4, 2>;
     auto pack_func         = pack_input_c4;
     auto unpack_func       = unpack_output_c4;
     auto gemm_func         = gemm_kernel_avx<Float4, 6, 4, 4>;
     auto CH_PACK           = 4;
     if (arch_ == avx2) {
-        input_trans_func  = input_trans_4x4<Float8>;
-        output_trans_func = output_trans_post_2x4<Float8>;
+        input_trans_func  = input_trans<Float8, 2>;
+        output_trans_func = output_trans_post<Float8, 2>;
         pack_func         = pack_input_c8;
         unpack_func       = unpack_output_c8;
         gemm_func         = gemm_kernel_avx<Float8, 6, 8, 8>;
         CH_PACK           = 8;
+        if (dst_unit == 4) {
+            input_trans_func  = input_trans<Float8, 4>;
+            output_trans_func = output_trans_post<Float8, 4>;
+        } else if (dst_unit == 6) {
+            input_trans_func  = input_trans<Float8, 6>;
+            output_trans_func = output_trans_post<Float8, 6>;
+        }
+    } else if (dst_unit == 4) {
+        input_trans_func  = input_trans<Float4, 4>;
+        output_trans_func = output_trans_post<Float4, 4>;
+    } else if (dst_unit == 6) {
+        input_trans_func  = input_trans<Float4, 6>;
+        output_trans_func = output_trans_post<Float4, 6>;
     }
 
     int ic_8 = UP_DIV(channel_in, CH_PACK);
     int oc_8 = UP_DIV(channel_out, CH_PACK);
 
-    const int src_unit = 4;
-    const int dst_unit = 2;
     int w_unit         = UP_DIV(width_out, dst_unit);
     int h_unit         = UP_DIV(height_out, dst_unit);
     int total_cnt      = UP_DIV(w_unit * h_unit, TILE_NUM);
@@ -697,7 +791,7 @@ Status X86ConvLayer3x3::DoForward(const std::vector<Blob *> &inputs, const std::
     int ic_8_stride  = w_pad * h_pad * CH_PACK;
     int oc_8_stride  = width_out * height_out * CH_PACK;
 
-    int max_num_threads = OMP_MAX_THREADS_NUM_;
+    int max_num_threads = GetParallelMaxThreads();
     size_t zero_size = ROUND_UP(w_pad * sizeof(float), 32);
     size_t pack_input_size = ROUND_UP(w_pad * h_pad * ROUND_UP(channel_in, CH_PACK) * sizeof(float), 32);
     size_t tmp_size = ROUND_UP((ic_8 + oc_8) * src_unit * src_unit * CH_PACK * TILE_NUM * sizeof(float), 32);
@@ -715,6 +809,10 @@ Status X86ConvLayer3x3::DoForward(const std::vector<Blob *> &inputs, const std::
     float *src_trans_tmp_data = tmp_data + tmp_size / sizeof(float);
     float *dst_trans_tmp_data = src_trans_tmp_data + max_num_threads * src_trans_size / sizeof(float);
 
+    const float *residual_origin = nullptr;
+    RETURN_ON_NEQ(GetResidual(inputs, outputs, &residual_origin), TNN_OK);
+    const int kernel_act_type = (int)epilogue_.kernel_act_type;
+
     for (int ni = 0; ni < batch; ni++) {
         auto input_ptr  = src_origin + ni * in_n_stride;
         auto output_ptr = dst_origin + ni * out_n_stride;
@@ -735,9 +833,7 @@ Status X86ConvLayer3x3::DoForward(const std::vector<Blob *> &inputs, const std::
             int c_gi_stride = tile_count * oc_8 * CH_PACK;
             int b_gi_stride = tile_count * ic_8 * CH_PACK;
 
-            OMP_PARALLEL_FOR_DYNAMIC_
-            for (int x_i = 0; x_i < tile_count; x_i++) {
-                int thread_id = OMP_TID_;
+            ParallelForWithThreadId(0, tile_count, [&](int x_i, int thread_id) {
                 auto src_trans_tmp_per_thread = src_trans_tmp_data + thread_id * (src_trans_size / sizeof(float));
 
                 int index = tile_index + x_i;
@@ -764,7 +860,7 @@ Status X86ConvLayer3x3::DoForward(const std::vector<Blob *> &inputs, const std::
                     for (int ci = 0; ci < ic_8; ++ci) {
                         const float *src_ci = src_ptr + ci * ic_8_stride;
                         // pad
-                        memset(src_trans_tmp_per_thread, 0, 16 * CH_PACK * sizeof(float));  // src_unit * src_unit * ch_pack
+                        memset(src_trans_tmp_per_thread, 0, src_unit * src_unit * CH_PACK * sizeof(float));
                         if (x_size > 0) {
                             for (int yi = 0; yi < ey; ++yi) {
                                 float *dst_yi       = src_trans_tmp_per_thread + yi * src_unit * CH_PACK;
@@ -779,27 +875,24 @@ Status X86ConvLayer3x3::DoForward(const std::vector<Blob *> &inputs, const std::
                                          b_gi_stride * src_unit);
                     }
                 }
-            }
+            });
 
             // ---------------------------------------- gemm func ----------------------------------------
             // gemm
-            float *dst_temp_data = tmp_data + TILE_NUM * ic_8 * 16 * CH_PACK;  // src_unit * src_unit * ch_pack
+            float *dst_temp_data = tmp_data + TILE_NUM * ic_8 * src_unit * src_unit * CH_PACK;
             float *b_ptr         = tmp_data;
             int w_gi_stride      = ic_8 * oc_8 * CH_PACK * CH_PACK;
-            OMP_PARALLEL_FOR_GUIDED_
-            for (int gi = 0; gi < src_unit * src_unit; ++gi) {
+            ParallelFor(0, src_unit * src_unit, [&](int gi) {
                 float *trans_dst          = dst_temp_data + gi * c_gi_stride;
                 float *trans_src          = b_ptr + gi * b_gi_stride;
                 const float *trans_weight = weight_ptr + gi * w_gi_stride;
 
                 gemm_func(trans_dst, trans_src, trans_weight, nullptr, ic_8, oc_8, tile_count);
-            }
+            });
 
             // ---------------------------------------- output trans --------------------------------------
 
-            OMP_PARALLEL_FOR_DYNAMIC_
-            for (int ti = 0; ti < tile_count; ++ti) {
-                int thread_id = OMP_TID_;
+            ParallelForWithThreadId(0, tile_count, [&](int ti, int thread_id) {
                 auto src_trans_tmp_per_thread = src_trans_tmp_data + thread_id * (src_trans_size / sizeof(float));
                 auto dst_trans_tmp_per_thread = dst_trans_tmp_data + thread_id * (dst_trans_size / sizeof(float));
 
@@ -817,14 +910,14 @@ Status X86ConvLayer3x3::DoForward(const std::vector<Blob *> &inputs, const std::
                 float *dst_ptr = output_ptr + (dst_y * width_out + dst_x) * CH_PACK;
                 float *src_ptr = dst_temp_data + ti * CH_PACK;
 
-                if (ex == 2) {
+                if (ex == dst_unit) {
                     // trans output
                     for (int ci = 0; ci < oc_8; ++ci) {
                         const float *bias_ci = bias_ptr + ci * CH_PACK;
                         float *dst_ci = dst_ptr + ci * oc_8_stride;
                         float *src_ci = src_ptr + ci * tile_count * CH_PACK;
                         output_trans_func(src_ci, c_gi_stride, c_gi_stride * src_unit, src_trans_tmp_per_thread, CH_PACK,
-                                          dst_unit * CH_PACK, bias_ci, param->activation_type);
+                                          dst_unit * CH_PACK, bias_ci, kernel_act_type);
                         unpack_func(src_trans_tmp_per_thread, output_ptr, ci * CH_PACK, ci * CH_PACK + CH_PACK, dst_y,
                                     dst_y + ey, dst_x, dst_x + ex, channel_out, height_out, width_out, false, zero_ptr);
                     }
@@ -835,9 +928,9 @@ Status X86ConvLayer3x3::DoForward(const std::vector<Blob *> &inputs, const std::
                         float *dst_ci = dst_ptr + ci * oc_8_stride;
                         float *src_ci = src_ptr + ci * tile_count * CH_PACK;
                         output_trans_func(src_ci, c_gi_stride, c_gi_stride * src_unit, src_trans_tmp_per_thread, CH_PACK,
-                                          dst_unit * CH_PACK, bias_ci, param->activation_type);
+                                          dst_unit * CH_PACK, bias_ci, kernel_act_type);
                         // copy to dest
-                        memset(dst_trans_tmp_per_thread, 0, 4 * CH_PACK * sizeof(float));  // dst_unit * dst_unit * ch_pack
+                        memset(dst_trans_tmp_per_thread, 0, dst_unit * dst_unit * CH_PACK * sizeof(float));
                         for (int i = 0; i < ey; ++i) {
                             memcpy(dst_trans_tmp_per_thread + i * ex * CH_PACK, src_trans_tmp_per_thread + i * CH_PACK * dst_unit,
                                    ex * sizeof(float) * CH_PACK);
@@ -846,8 +939,14 @@ Status X86ConvLayer3x3::DoForward(const std::vector<Blob *> &inputs, const std::
                                     dst_y + ey, dst_x, dst_x + ex, channel_out, height_out, width_out, false, zero_ptr);
                     }
                 }
-            }
+            });
         }
+
+        // the other post ops run once the channels are unpacked
+        auto residual_ptr = residual_origin ? residual_origin + ni * out_n_stride : nullptr;
+        ParallelFor(0, oc_8, [&](int ci) {
+            ApplyEpilogue(output_ptr, residual_ptr, ci * CH_PACK, MIN(channel_out, ci * CH_PACK + CH_PACK), oc_stride);
+        });
     }
 
     return TNN_OK;
@@ -28,7 +28,18 @@ public:
     static bool isPrefered(ConvLayerParam *param, const std::vector<Blob *> &inputs,
                            const std::vector<Blob *> &outputs);
 
+    // @brief get dst unit 2, 4 or 6 of winograd F(m, 3), 0 if not supported
+    static int SelectWinogradUnit(ConvLayerParam *param, const std::vector<Blob *> &inputs,
+                                  const std::vector<Blob *> &outputs);
+
     virtual Status allocateBufferWeight(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs);
+
+    // @brief set dst unit 2, 4 or 6 before Init, 0 to select it by SelectWinogradUnit
+    void SetWinogradUnit(int dst_unit);
+
+private:
+    int dst_unit_   = 2;
+    int tuned_unit_ = 0;
 };
 
 }  // namespace TNN_NS
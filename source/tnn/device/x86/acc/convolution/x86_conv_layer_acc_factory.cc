@@ -14,12 +14,17 @@
 
 #include "tnn/device/x86/acc/convolution/x86_conv_layer_acc_factory.h"
 
+#include <chrono>
+#include <sstream>
+
 #include "tnn/device/x86/acc/convolution/x86_conv_layer_depthwise.h"
 #include "tnn/device/x86/acc/convolution/x86_conv_layer_1x1.h"
 #include "tnn/device/x86/acc/convolution/x86_conv_layer_3x3.h"
 #include "tnn/device/x86/acc/convolution/x86_conv_layer_common.h"
 #include "tnn/device/x86/acc/convolution/x86_conv_int8_layer_common.h"
 #include "tnn/device/x86/acc/convolution/x86_conv_int8_layer_depthwise.h"
+#include "tnn/device/x86/x86_context.h"
+#include "tnn/utils/dims_utils.h"
 
 namespace TNN_NS {
 
@@ -63,4 +68,200 @@ void X86ConvLayerAccFactory::CreateImpInt8(const std::vector<Blob *> &inputs, co
     }
 }
 
+// config of a fp32 conv impl, stored in the tune cache as "<impl> <winograd unit> <m_c> <k_c>"
+struct X86ConvTuneConfig {
+    std::string impl  = "common";
+    int winograd_unit = 0;
+    int m_c           = 0;
+    int k_c           = 0;
+
+    std::string ToString() const {
+        std::ostringstream os;
+        os << impl << " " << winograd_unit << " " << m_c << " " << k_c;
+        return os.str();
+    }
+
+    bool FromString(const std::string &str) {
+        std::istringstream is(str);
+        is >> impl >> winograd_unit >> m_c >> k_c;
+        return !is.fail();
+    }
+};
+
+static std::string GetIsaName() {
+    if (cpu_with_isa(avx512_vnni)) {
+        return "avx512_vnni";
+    } else if (cpu_with_isa(avx512)) {
+        return "avx512";
+    } else if (cpu_with_isa(avx2)) {
+        return "avx2";
+    } else if (cpu_with_isa(avx)) {
+        return "avx";
+    }
+    return "sse42";
+}
+
+static std::string DimsToString(const DimsVector &dims) {
+    std::ostringstream os;
+    for (size_t i = 0; i < dims.size(); i++) {
+        os << (i ? "x" : "") << dims[i];
+    }
+    return os.str();
+}
+
+static std::string GetTuneKey(X86Context *context, ConvLayerParam *param, const std::vector<Blob *> &inputs,
+                              const std::vector<Blob *> &outputs) {
+    std::ostringstream os;
+    os << "conv_i" << DimsToString(inputs[0]->GetBlobDesc().dims) << "_o"
+       << DimsToString(outputs[0]->GetBlobDesc().dims) << "_k" << DimsToString(param->kernels) << "_s"
+       << DimsToString(param->strides) << "_p" << DimsToString(param->pads) << "_d"
+       << DimsToString(param->dialations) << "_g" << param->group << "_" << GetIsaName() << "_t"
+       << context->GetNumThreads();
+    return os.str();
+}
+
+static std::shared_ptr<X86LayerAcc> CreateImpByConfig(const X86ConvTuneConfig &config) {
+    std::shared_ptr<X86ConvLayerCommon> impl = nullptr;
+    if (config.impl == "depthwise") {
+        impl = std::make_shared<X86ConvLayerDepthwise>();
+    } else if (config.impl == "1x1") {
+        impl = std::make_shared<X86ConvLayer1x1>();
+    } else if (config.impl == "winograd") {
+        auto winograd = std::make_shared<X86ConvLayer3x3>();
+        winograd->SetWinogradUnit(config.winograd_unit);
+        impl = winograd;
+    } else if (config.impl == "common") {
+        impl = std::make_shared<X86ConvLayerCommon>();
+    } else {
+        return nullptr;
+    }
+    impl->SetGemmBlockSize(config.m_c, config.k_c);
+    return impl;
+}
+
+static std::vector<X86ConvTuneConfig> GetTuneCandidates(ConvLayerParam *param, const std::vector<Blob *> &inputs,
+                                                        const std::vector<Blob *> &outputs) {
+    // M_c must be a multiple of the m block of conv_gemm_config
+    const std::vector<std::pair<int, int>> gemm_blocks = {{64, 256}, {32, 256}, {128, 256}, {64, 128}, {64, 512}};
+
+    std::vector<X86ConvTuneConfig> candidates;
+    X86ConvTuneConfig config;
+    if (X86ConvLayerDepthwise::isPrefered(param, inputs, outputs)) {
+        config.impl = "depthwise";
+        candidates.push_back(config);
+    }
+    if (X86ConvLayer1x1::isPrefered(param, inputs, outputs)) {
+        config.impl = "1x1";
+        for (auto &block : gemm_blocks) {
+            config.m_c = block.first;
+            config.k_c = block.second;
+            candidates.push_back(config);
+        }
+        config.m_c = config.k_c = 0;
+    }
+    if (X86ConvLayer3x3::isPrefered(param, inputs, outputs)) {
+        config.impl = "winograd";
+        for (int unit = 2; unit <= 6; unit += 2) {
+            config.winograd_unit = unit;
+            candidates.push_back(config);
+        }
+        config.winograd_unit = 0;
+    }
+    config.impl = "common";
+    for (auto &block : gemm_blocks) {
+        config.m_c = block.first;
+        config.k_c = block.second;
+        candidates.push_back(config);
+    }
+    return candidates;
+}
+
+// @brief time of the fastest of a few forwards in ms, on scratch blobs of the same shape
+static double BenchmarkImp(X86Context *context, LayerParam *param, LayerResource *resource,
+                           const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs,
+                           std::shared_ptr<X86LayerAcc> impl) {
+    const int warmup_count = 1, run_count = 3;
+
+    std::vector<RawBuffer> buffers;
+    std::vector<std::shared_ptr<Blob>> blobs;
+    std::vector<Blob *> scratch_inputs, scratch_outputs;
+    for (auto blob : inputs) {
+        BlobDesc desc = blob->GetBlobDesc();
+        buffers.push_back(RawBuffer(DimsVectorUtils::Count(desc.dims) * sizeof(float), 32));
+        BlobHandle handle;
+        handle.base = buffers.back().force_to<void *>();
+        blobs.push_back(std::make_shared<Blob>(desc, handle));
+        scratch_inputs.push_back(blobs.back().get());
+    }
+    for (auto blob : outputs) {
+        BlobDesc desc = blob->GetBlobDesc();
+        buffers.push_back(RawBuffer(DimsVectorUtils::Count(desc.dims) * sizeof(float), 32));
+        BlobHandle handle;
+        handle.base = buffers.back().force_to<void *>();
+        blobs.push_back(std::make_shared<Blob>(desc, handle));
+        scratch_outputs.push_back(blobs.back().get());
+    }
+
+    if (impl->Init(context, param, resource, scratch_inputs, scratch_outputs) != TNN_OK) {
+        return -1;
+    }
+
+    double best_time = -1;
+    context->OnInstanceForwardBegin();
+    for (int i = 0; i < warmup_count + run_count; i++) {
+        auto start  = std::chrono::steady_clock::now();
+        auto status = impl->DoForward(scratch_inputs, scratch_outputs);
+        auto time   = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (status != TNN_OK) {
+            best_time = -1;
+            break;
+        }
+        if (i >= warmup_count && (best_time < 0 || time < best_time)) {
+            best_time = time;
+        }
+    }
+    context->OnInstanceForwardEnd();
+    return best_time;
+}
+
+Status X86ConvLayerAccFactory::CreateImpFPTuned(Context *context, LayerParam *param, LayerResource *resource,
+                                                const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs,
+                                                std::shared_ptr<X86LayerAcc> &conv_acc_impl) {
+    auto x86_context = dynamic_cast<X86Context *>(context);
+    auto conv_param  = dynamic_cast<ConvLayerParam *>(param);
+    if (!x86_context || !conv_param) {
+        CreateImpFP(inputs, outputs, param, conv_acc_impl);
+        return TNN_OK;
+    }
+
+    auto key = GetTuneKey(x86_context, conv_param, inputs, outputs);
+    X86ConvTuneConfig config;
+    std::string value;
+    if (x86_context->GetTuneResult(key, value) && config.FromString(value)) {
+        conv_acc_impl = CreateImpByConfig(config);
+        if (conv_acc_impl) {
+            LOGD("x86 conv %s uses tuned config %s\n", conv_param->name.c_str(), value.c_str());
+            return TNN_OK;
+        }
+    }
+
+    double best_time = -1;
+    for (auto &candidate : GetTuneCandidates(conv_param, inputs, outputs)) {
+        auto time = BenchmarkImp(x86_context, param, resource, inputs, outputs, CreateImpByConfig(candidate));
+        LOGD("x86 conv %s config %s: %.3f ms\n", conv_param->name.c_str(), candidate.ToString().c_str(), time);
+        if (time >= 0 && (best_time < 0 || time < best_time)) {
+            best_time = time;
+            config    = candidate;
+        }
+    }
+    if (best_time < 0) {
+        CreateImpFP(inputs, outputs, param, conv_acc_impl);
+        return TNN_OK;
+    }
+
+    x86_context->SetTuneResult(key, config.ToString());
+    conv_acc_impl = CreateImpByConfig(config);
+    return TNN_OK;
+}
+
 }  // namespace TNN_NS
@@ -28,6 +28,12 @@ public:
 
     static void CreateImpInt8(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs, LayerParam *param,
                             std::shared_ptr<X86LayerAcc> &conv_acc_impl);
+
+    // @brief create the fp32 impl by benchmarking the candidate impls and gemm block sizes
+    // for the layer shape, the winner is cached in context by shape, isa and number of threads
+    static Status CreateImpFPTuned(Context *context, LayerParam *param, LayerResource *resource,
+                                   const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs,
+                                   std::shared_ptr<X86LayerAcc> &conv_acc_impl);
 };
 
 }  // namespace TNN_NS
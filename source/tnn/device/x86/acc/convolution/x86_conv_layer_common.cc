@@ -13,9 +13,12 @@
 // specific language governing permissions and limitations under the License.
 
 #include "tnn/device/x86/acc/convolution/x86_conv_layer_common.h"
+#include "tnn/core/packed_weight_cache.h"
 #include "tnn/device/x86/acc/compute/x86_compute.h"
 #include "tnn/device/x86/x86_context.h"
 #include "tnn/utils/data_type_utils.h"
+#include "tnn/utils/parallel_for.h"
+#include "tnn/utils/string_utils_inner.h"
 
 namespace TNN_NS {
 /*
@@ -29,6 +32,11 @@ bool X86ConvLayerCommon::isPrefered(ConvLayerParam *param, const std::vector<Blo
 
 X86ConvLayerCommon::~X86ConvLayerCommon() {}
 
+void X86ConvLayerCommon::SetGemmBlockSize(int m_c, int k_c) {
+    gemm_m_c_ = m_c;
+    gemm_k_c_ = k_c;
+}
+
 Status X86ConvLayerCommon::Reshape(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
     return TNN_OK;
 }
@@ -55,17 +63,32 @@ Status X86ConvLayerCommon::allocateBufferWeight(const std::vector<Blob *> &input
         const float *src = conv_res->filter_handle.force_to<float *>();
 
         if (conv_res->filter_handle.GetDataType() == DATA_TYPE_FLOAT) {
-            RawBuffer temp_buffer(weight_pack_per_group * param->group * sizeof(float));
-            float *dst = temp_buffer.force_to<float *>();
+            auto weight_type = GetPackedWeightDataType();
+            auto variant     = "conv_common_" + ToString(k_c) + "_" + ToString(n_block) + "_" + ToString(weight_type);
+            auto key         = PackedWeightCache::CreateKey(context_, param_, DEVICE_X86, variant, conv_res->filter_handle);
+            return PackedWeightCache::GetOrPack(key, [&](RawBuffer &packed) -> Status {
+                size_t weight_count = weight_pack_per_group * param->group;
+                RawBuffer temp_buffer(weight_count * sizeof(float));
+                float *dst = temp_buffer.force_to<float *>();
 
-            for (int g = 0; g < param->group; g++) {
-                auto src_g = src + K * M * g;
-                auto dst_g = dst + weight_pack_per_group * g;
-                conv_pack_col_b_n(M, K, src_g, K, dst_g, conv_gemm_conf_);
-            }
+                for (int g = 0; g < param->group; g++) {
+                    auto src_g = src + K * M * g;
+                    auto dst_g = dst + weight_pack_per_group * g;
+                    conv_pack_col_b_n(M, K, src_g, K, dst_g, conv_gemm_conf_);
+                }
 
-            temp_buffer.SetDataType(DATA_TYPE_FLOAT);
-            buffer_weight_ = temp_buffer;
+                temp_buffer.SetDataType(DATA_TYPE_FLOAT);
+                if (weight_type != DATA_TYPE_FLOAT) {
+                    // keep the packed layout, the sgemm expands one K block at a time
+                    RawBuffer half_buffer(weight_count * DataTypeUtils::GetBytesSize(weight_type));
+                    RETURN_ON_NEQ(X86ConvertFloatTo16Bit(dst, half_buffer.force_to<void *>(), weight_count, weight_type),
+                                  TNN_OK);
+                    half_buffer.SetDataType(weight_type);
+                    temp_buffer = half_buffer;
+                }
+                packed = temp_buffer;
+                return TNN_OK;
+            }, buffer_weight_);
         } else {
             LOGE("Error: DataType %d not support\n", conv_res->filter_handle.GetDataType());
             return Status(TNNERR_MODEL_ERR, "conv_res DataType is not supported");
@@ -101,13 +124,111 @@ Status X86ConvLayerCommon::Init(Context *context, LayerParam *param, LayerResour
         return status;
     }
     conv_gemm_conf_ = conv_gemm_config<float, float, float>();
+    if (gemm_m_c_ > 0) {
+        conv_gemm_conf_.M_c_ = gemm_m_c_;
+    }
+    if (gemm_k_c_ > 0) {
+        conv_gemm_conf_.K_c_ = gemm_k_c_;
+    }
 
     RETURN_ON_NEQ(allocateBufferWeight(inputs, outputs), TNN_OK);
     RETURN_ON_NEQ(allocateBufferBias(inputs, outputs), TNN_OK);
+    RETURN_ON_NEQ(InitEpilogue(inputs, outputs), TNN_OK);
+
+    return TNN_OK;
+}
+
+Status X86ConvLayerCommon::InitEpilogue(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
+    auto param = dynamic_cast<ConvLayerParam *>(param_);
+    CHECK_PARAM_NULL(param);
+
+    epilogue_                = conv_gemm_epilogue();
+    const int act_type       = param->activation_type;
+    const bool has_residual  = param->fusion_type != FusionType_None;
+    epilogue_.add_before_act = param->fusion_type == FusionType_Conv_Add_Activation;
+
+    // relu and relu6 stay in the jit kernels, unless the residual has to be added before them
+    if ((act_type == ActivationType_ReLU || act_type == ActivationType_ReLU6) &&
+        !(has_residual && epilogue_.add_before_act)) {
+        epilogue_.kernel_act_type = act_type;
+    } else {
+        epilogue_.act_type = act_type;
+    }
+
+    if (has_residual || epilogue_.act_type != ActivationType_None) {
+        epilogue_.post_func = (arch_ == avx2) ? X86_Conv_Epilogue<Float8, 8> : X86_Conv_Epilogue<Float4, 4>;
+    }
+    return TNN_OK;
+}
+
+Status X86ConvLayerCommon::GetResidual(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs,
+                                       const float **residual) {
+    auto param = dynamic_cast<ConvLayerParam *>(param_);
+    CHECK_PARAM_NULL(param);
+
+    *residual = nullptr;
+    if (param->fusion_type == FusionType_None) {
+        return TNN_OK;
+    }
+    if (inputs.size() < 2) {
+        LOGE("Error: x86 conv add fusion needs a residual input\n");
+        return Status(TNNERR_LAYER_ERR, "Error: x86 conv add fusion needs a residual input");
+    }
+    auto residual_dims = inputs[1]->GetBlobDesc().dims;
+    auto output_dims   = outputs[0]->GetBlobDesc().dims;
+    if (DimsVectorUtils::Equal(residual_dims, output_dims)) {
+        *residual = handle_ptr<const float *>(inputs[1]->GetHandle());
+        return TNN_OK;
+    }
+
+    // the add is fused without the shapes known, a residual broadcast to the output is expanded first
+    Status status = TNN_OK;
+    auto expand_dims = DimsFunctionUtils::Expand(output_dims, residual_dims, &status);
+    if (status != TNN_OK || residual_dims.size() > output_dims.size() ||
+        !DimsVectorUtils::Equal(expand_dims, output_dims)) {
+        LOGE("Error: x86 conv add fusion needs a residual broadcast to the output shape\n");
+        return Status(TNNERR_LAYER_ERR, "Error: x86 conv add fusion needs a residual broadcast to the output shape");
+    }
+
+    const int rank = (int)output_dims.size();
+    DimsVector residual_pad_dims(rank - residual_dims.size(), 1);
+    residual_pad_dims.insert(residual_pad_dims.end(), residual_dims.begin(), residual_dims.end());
+    std::vector<int> residual_strides(rank, 0);
+    for (int d = rank - 1, stride = 1; d >= 0; d--) {
+        residual_strides[d] = residual_pad_dims[d] == 1 ? 0 : stride;
+        stride *= residual_pad_dims[d];
+    }
 
+    const int count = DimsVectorUtils::Count(output_dims);
+    if (buffer_residual_.GetBytesSize() < count * sizeof(float)) {
+        buffer_residual_ = RawBuffer(count * sizeof(float));
+    }
+    auto src = handle_ptr<const float *>(inputs[1]->GetHandle());
+    auto dst = buffer_residual_.force_to<float *>();
+    for (int i = 0; i < count; i++) {
+        int offset = 0;
+        for (int d = rank - 1, index = i; d >= 0; d--) {
+            offset += (index % output_dims[d]) * residual_strides[d];
+            index /= output_dims[d];
+        }
+        dst[i] = src[offset];
+    }
+    *residual = dst;
     return TNN_OK;
 }
 
+void X86ConvLayerCommon::ApplyEpilogue(float *dst, const float *residual, int c_begin, int c_end, int area) {
+    if (!epilogue_.post_func || c_end <= c_begin) {
+        return;
+    }
+    conv_gemm_epilogue epilogue = epilogue_;
+    if (epilogue.scale) {
+        epilogue.scale += c_begin;
+    }
+    epilogue.post_func(dst + c_begin * area, area, area, c_end - c_begin,
+                       residual ? residual + c_begin * area : nullptr, epilogue);
+}
+
 Status X86ConvLayerCommon::DoForward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
     Blob *input_blob    = inputs[0];
     Blob *output_blob   = outputs[0];
@@ -127,7 +248,7 @@ Status X86ConvLayerCommon::DoForward(const std::vector<Blob *> &inputs, const st
     int output_offset_ = output_dims[1] * conv_out_spatial_dim_ / param->group;
     size_t col_offset_ = param->kernels[0] * param->kernels[1] * oh * ow * (input_dims[1] / param->group);
 
-    int max_num_threads = OMP_MAX_THREADS_NUM_;
+    int max_num_threads = GetParallelMaxThreads();
     conv_ajust_m_blk_size(max_num_threads, conv_out_spatial_dim_, conv_gemm_conf_.M_c_);
 
     int m_c = conv_gemm_conf_.M_c_;
@@ -135,22 +256,34 @@ Status X86ConvLayerCommon::DoForward(const std::vector<Blob *> &inputs, const st
     int n_block = conv_gemm_conf_.n_block_;
     size_t src_trans_size = m_c * k_c;
 
+    int K = input_dims[1] * param->kernels[0] * param->kernels[1] / param->group;
+    int M = output_dims[1] / param->group;
+    int N = conv_out_spatial_dim_;
+    size_t weight_offset_per_group = ROUND_UP(K, k_c) * ROUND_UP(M, n_block);
+
+    auto weight_type = buffer_weight_.GetDataType();
     size_t im2col_size = ROUND_UP(col_offset_ * param->group * sizeof(float), 32);
-    size_t workspace_size = (im2col_size + ROUND_UP(src_trans_size * max_num_threads * sizeof(float), 32));
+    size_t src_trans_bytes = ROUND_UP(src_trans_size * max_num_threads * sizeof(float), 32);
+    size_t weight_block_bytes = weight_type == DATA_TYPE_FLOAT ? 0 : k_c * ROUND_UP(M, n_block) * sizeof(float);
+    size_t workspace_size = im2col_size + src_trans_bytes + weight_block_bytes;
     float *workspace = reinterpret_cast<float *>(context_->GetSharedWorkSpace(workspace_size));
 
     float *im2col_workspace = workspace;
     float *src_trans_workspace = workspace + im2col_size / sizeof(float);
 
-    int K = input_dims[1] * param->kernels[0] * param->kernels[1] / param->group;
-    int M = output_dims[1] / param->group;
-    int N = conv_out_spatial_dim_;
-    size_t weight_offset_per_group = ROUND_UP(K, k_c) * ROUND_UP(M, n_block);
+    conv_gemm_packed_weight packed_weight;
+    packed_weight.data_type   = weight_type;
+    packed_weight.unpack_func = X86Convert16BitToFloat;
+    packed_weight.block_buf   = src_trans_workspace + src_trans_bytes / sizeof(float);
+    const size_t weight_group_bytes = weight_offset_per_group * DataTypeUtils::GetBytesSize(weight_type);
+
+    const float *residual_data = nullptr;
+    RETURN_ON_NEQ(GetResidual(inputs, outputs, &residual_data), TNN_OK);
 
     if (outputs[0]->GetBlobDesc().data_type == DATA_TYPE_FLOAT) {
         auto input_data = static_cast<float*>(input_ptr);
         auto output_data = static_cast<float*>(output_ptr);
-        auto weights_data = buffer_weight_.force_to<float*>();
+        auto weights_data = buffer_weight_.force_to<char*>();
         float *bias_data  = buffer_bias_.force_to<float*>();
         for (size_t b = 0; b < outputs[0]->GetBlobDesc().dims[0]; b++) {
             X86_IM2COL(input_data + b * conv_in_offset_, input_dims[1],
@@ -163,12 +296,17 @@ Status X86ConvLayerCommon::DoForward(const std::vector<Blob *> &inputs, const st
                         im2col_workspace);
 
             for (int g = 0; g < param->group; g++) {
+                conv_gemm_epilogue epilogue = epilogue_;
+                if (residual_data) {
+                    epilogue.residual = residual_data + (b * param->group + g) * output_offset_;
+                }
+                packed_weight.data = weights_data + weight_group_bytes * g;
                 conv_sgemm_nn_col_major_prepack_b(N, M, K,
                     im2col_workspace + col_offset_ * g, N,
-                    weights_data + weight_offset_per_group * g, K,
+                    packed_weight, K,
                     output_data + (b * param->group + g) * output_offset_, N,
                     bias_data + g * param->output_channel / param->group,
-                    param->activation_type, src_trans_workspace, conv_gemm_conf_);
+                    epilogue, src_trans_workspace, conv_gemm_conf_);
             }
         }
     } else {
@@ -44,11 +44,30 @@ public:
 
     virtual Status allocateBufferBias(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs);
 
+    // @brief set gemm block sizes before Init, 0 to keep the defaults of conv_gemm_config
+    void SetGemmBlockSize(int m_c, int k_c);
+
 protected:
+    // @brief set up epilogue_ from the activation and fusion of param
+    Status InitEpilogue(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs);
+
+    // @brief get residual of the conv add fusion, nullptr if not fused.
+    // a residual broadcast to the output shape is expanded to buffer_residual_
+    Status GetResidual(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs,
+                       const float **residual);
+
+    // @brief apply the post ops of epilogue_ on the channels [c_begin, c_end) of one output batch,
+    // for the impls not running the sgemm driver
+    void ApplyEpilogue(float *dst, const float *residual, int c_begin, int c_end, int area);
+
     bool do_im2col_ = true;
+    int gemm_m_c_   = 0;
+    int gemm_k_c_   = 0;
     RawBuffer buffer_weight_;
     RawBuffer buffer_bias_;
+    RawBuffer buffer_residual_;
     conv_gemm_config<float, float, float> conv_gemm_conf_;
+    conv_gemm_epilogue epilogue_;
 };
 
 }  // namespace TNN_NS
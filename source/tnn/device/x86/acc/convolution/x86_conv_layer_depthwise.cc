@@ -13,6 +13,7 @@
 // specific language governing permissions and limitations under the License.
 
 #include "tnn/device/x86/acc/convolution/x86_conv_layer_depthwise.h"
+#include "tnn/core/packed_weight_cache.h"
 #include "tnn/device/x86/x86_common.h"
 #include "tnn/device/x86/x86_context.h"
 #include "tnn/device/x86/x86_util.h"
@@ -20,7 +21,8 @@
 #include "tnn/interpreter/raw_buffer.h"
 #include "tnn/utils/data_format_converter.h"
 #include "tnn/utils/data_type_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
+#include "tnn/utils/string_utils_inner.h"
 
 namespace TNN_NS {
 using namespace x86;
@@ -62,16 +64,21 @@ Status X86ConvLayerDepthwise::allocateBufferWeight(const std::vector<Blob *> &in
         int data_byte_size = DataTypeUtils::GetBytesSize(conv_res->filter_handle.GetDataType());
 
         if (conv_res->filter_handle.GetDataType() == DATA_TYPE_FLOAT) {
-            RawBuffer temp_buffer(weight_count * data_byte_size);
-            float *dst = temp_buffer.force_to<float *>();
-
-            if (arch_ == avx2) {
-                PackC8(dst, src, kh * kw, kh * kw, kh * kw, group);
-            } else if (arch_ == sse42) {
-                PackC4(dst, src, kh * kw, kh * kw, kh * kw, group);
-            }
-            temp_buffer.SetDataType(DATA_TYPE_FLOAT);
-            buffer_weight_ = temp_buffer;
+            auto variant = "conv_depthwise_" + ToString((int)arch_);
+            auto key     = PackedWeightCache::CreateKey(context_, param_, DEVICE_X86, variant, conv_res->filter_handle);
+            return PackedWeightCache::GetOrPack(key, [&](RawBuffer &packed) -> Status {
+                RawBuffer temp_buffer(weight_count * data_byte_size);
+                float *dst = temp_buffer.force_to<float *>();
+
+                if (arch_ == avx2) {
+                    PackC8(dst, src, kh * kw, kh * kw, kh * kw, group);
+                } else if (arch_ == sse42) {
+                    PackC4(dst, src, kh * kw, kh * kw, kh * kw, group);
+                }
+                temp_buffer.SetDataType(DATA_TYPE_FLOAT);
+                packed = temp_buffer;
+                return TNN_OK;
+            }, buffer_weight_);
         } else {
             LOGE("Error: DataType %d not support\n", conv_res->filter_handle.GetDataType());
             return Status(TNNERR_MODEL_ERR, "conv_res DataType is not supported");
@@ -128,7 +135,7 @@ Status X86ConvLayerDepthwise::DoForward(const std::vector<Blob *> &inputs, const
     int dilate_x_step  = c_pack * param->dialations[0];
     int weight_z_step  = param->kernels[0] * param->kernels[1];
 
-    int max_num_threads = OMP_MAX_THREADS_NUM_;
+    int max_num_threads = GetParallelMaxThreads();
     size_t src_pad_size = ROUND_UP(src_pad_w * (dims_input[2] + param->pads[2] + param->pads[3]) * c_pack * sizeof(float), 32);
     size_t dst_tmp_size = ROUND_UP(dst_z_step * c_pack * sizeof(float), 32);
     float *workspace = reinterpret_cast<float *>(context_->GetSharedWorkSpace(
@@ -137,17 +144,21 @@ Status X86ConvLayerDepthwise::DoForward(const std::vector<Blob *> &inputs, const
     const float *src_origin = handle_ptr<const float *>(input->GetHandle());
     float *dst_origin = handle_ptr<float *>(output->GetHandle());
 
+    const float *residual_origin = nullptr;
+    RETURN_ON_NEQ(GetResidual(inputs, outputs, &residual_origin), TNN_OK);
+
+    const int kernel_act_type = (int)epilogue_.kernel_act_type;
     auto dw_full = DepthwiseConv<ActivationType_None, Float8, 8>;
-    if (param->activation_type == ActivationType_ReLU) {
+    if (kernel_act_type == ActivationType_ReLU) {
         dw_full  = DepthwiseConv<ActivationType_ReLU, Float8, 8>;
-    } else if (param->activation_type == ActivationType_ReLU6) {
+    } else if (kernel_act_type == ActivationType_ReLU6) {
         dw_full  = DepthwiseConv<ActivationType_ReLU6, Float8, 8>;
     }
     if (arch_ == sse42) {
         dw_full = DepthwiseConv<ActivationType_None, Float4, 4>;
-        if (param->activation_type == ActivationType_ReLU) {
+        if (kernel_act_type == ActivationType_ReLU) {
             dw_full  = DepthwiseConv<ActivationType_ReLU, Float4, 4>;
-        } else if (param->activation_type == ActivationType_ReLU6) {
+        } else if (kernel_act_type == ActivationType_ReLU6) {
             dw_full  = DepthwiseConv<ActivationType_ReLU6, Float4, 4>;
         }
     }
@@ -168,15 +179,15 @@ Status X86ConvLayerDepthwise::DoForward(const std::vector<Blob *> &inputs, const
     for (int batch_idx = 0; batch_idx < batch; batch_idx++) {
         auto src_ptr = src_origin + batch_idx * dims_input[1] * src_z_step;
         auto dst_ptr = dst_origin + batch_idx * dims_output[1] * dst_z_step;
+        auto res_ptr = residual_origin ? residual_origin + batch_idx * dims_output[1] * dst_z_step : nullptr;
 
-        OMP_PARALLEL_FOR_GUIDED_
-        for (int dz = 0; dz < dims_output[1]; dz += c_pack) {
+        ParallelForWithThreadId(0, UP_DIV(dims_output[1], c_pack), [&](int dz_i, int thread_id) {
+            int dz = dz_i * c_pack;
             int real_dz     = MIN(c_pack, dims_output[1] - dz);
             auto *dst_z     = dst_ptr + dst_z_step * dz;
             auto *src_z     = src_ptr + src_z_step * dz;
             auto *weight_dz = weights_data + dz * weight_z_step;
             auto *bias_z    = bias_data + dz;
-            int thread_id   = OMP_TID_;
             auto *tmp_buf   = workspace + thread_id * ((src_pad_size + dst_tmp_size) / sizeof(float));
             auto *src_buf   = tmp_buf;
             auto *dst_buf   = tmp_buf + src_pad_size / sizeof(float);
@@ -186,7 +197,8 @@ Status X86ConvLayerDepthwise::DoForward(const std::vector<Blob *> &inputs, const
                     param->kernels[0], param->kernels[1], dilate_x_step, dilate_y_step,
                     dims_output[2], src_pad_w * c_pack * param->strides[1], dims_output[3] * c_pack);
             UnpackAcc(dst_z, dst_buf, dst_z_step, dst_z_step, dst_z_step, real_dz);
-        }
+            ApplyEpilogue(dst_ptr, res_ptr, dz, dz + real_dz, dst_z_step);
+        });
     }
     return TNN_OK;
 }
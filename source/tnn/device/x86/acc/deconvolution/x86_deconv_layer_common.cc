@@ -16,6 +16,7 @@
 #include "tnn/device/x86/acc/compute/x86_compute.h"
 #include "tnn/device/x86/x86_context.h"
 #include "tnn/utils/data_type_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 using namespace x86;
@@ -151,7 +152,7 @@ Status X86DeconvLayerCommon::DoForward(const std::vector<Blob *> &inputs, const
     size_t col_offset_ =
         param->kernels[0] * param->kernels[1] * input_dims[2] * input_dims[3] * (output_dims[1] / param->group);
 
-    int max_num_threads = OMP_MAX_THREADS_NUM_;
+    int max_num_threads = GetParallelMaxThreads();
     conv_ajust_m_blk_size(max_num_threads, conv_in_spatial_dim_, conv_gemm_conf_.M_c_);
 
     int m_c               = conv_gemm_conf_.M_c_;
@@ -44,6 +44,9 @@ Status X86ConvLayerAcc::Init(Context *context, LayerParam *param, LayerResource
     auto data_type = inputs[0]->GetBlobDesc().data_type;
     if (data_type == DATA_TYPE_INT8) {
         X86ConvLayerAccFactory::CreateImpInt8(inputs, outputs, param_, conv_acc_impl_);
+    } else if (context_->GetEnableTuneKernel()) {
+        RETURN_ON_NEQ(X86ConvLayerAccFactory::CreateImpFPTuned(context_, param_, resource_, inputs, outputs,
+                                                               conv_acc_impl_), TNN_OK);
     } else {
         X86ConvLayerAccFactory::CreateImpFP(inputs, outputs, param_, conv_acc_impl_);
     }
@@ -90,6 +90,8 @@ Status X86CpuAdapterAcc::Init(Context *context, LayerParam *param, LayerResource
         desc.data_type   = GetCpuLayerAccPrecision(desc.data_type);
         cpu_blob_out_.push_back(new Blob(desc, false));
     }
+    // constant inputs may be read in init
+    RETURN_ON_NEQ(ConvertBlobForAdaptorAcc(inputs, cpu_blob_in_, true), TNN_OK);
 
     // cpu acc init
     status = cpu_adapter_acc_->Init(impl_device_context_, param, resource, cpu_blob_in_, cpu_blob_out_);
@@ -151,6 +153,12 @@ Status X86CpuAdapterAcc::Forward(const std::vector<Blob *> &inputs, const std::v
 
     // cpu acc forward
     status = cpu_adapter_acc_->Forward(cpu_blob_in_, cpu_blob_out_);
+    RETURN_ON_NEQ(status, TNN_OK);
+
+    // output shape may be determined in forward
+    for (int i = 0; i < outputs.size(); ++i) {
+        outputs[i]->GetBlobDesc().dims = cpu_blob_out_[i]->GetBlobDesc().dims;
+    }
 
     return status;
 }
@@ -163,8 +171,12 @@ Status X86CpuAdapterAcc::ConvertBlobForAdaptorAcc(const std::vector<Blob *> &dev
         auto device_blob = device_blobs[i];
         auto cpu_blob    = cpu_blobs[i];
 
-        auto device_handle = device_blob->GetHandle();
-        cpu_blob->SetHandle(device_handle);
+        // x86 blobs of adapter accs are nchw float, int32 or int8 as the cpu blobs, so the cpu blobs
+        // share their memory and consecutive fallback layers do not convert anything
+        if (device_blob->GetBlobDesc().data_type != cpu_blob->GetBlobDesc().data_type) {
+            return Status(TNNERR_LAYER_ERR, "X86CpuAdapterAcc got blobs of different data types");
+        }
+        cpu_blob->SetHandle(device_blob->GetHandle());
     }
     return status;
 }
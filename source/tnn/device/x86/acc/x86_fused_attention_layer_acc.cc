@@ -0,0 +1,236 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "tnn/device/x86/acc/x86_fused_attention_layer_acc.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+#include "tnn/device/x86/acc/Float4.h"
+#include "tnn/device/x86/acc/Float8.h"
+#include "tnn/utils/dims_utils.h"
+#include "tnn/utils/parallel_for.h"
+
+namespace TNN_NS {
+
+// floats of the scores of one tile, fits in L1 together with the panels
+static const int kScoreTileSize = 8 * 1024;
+
+// softmax(scores * scale + mask) in place over one row of scores
+template <typename VEC, int pack>
+static void attention_softmax_func(float *scores, int len, float scale, const float *mask, int mask_stride) {
+    float vec_buf[pack];
+    float max_value = -FLT_MAX;
+    auto v_max      = VEC(-FLT_MAX);
+    auto v_scale    = VEC(scale);
+
+    int i = 0;
+    for (; i + pack - 1 < len; i += pack) {
+        auto v = VEC::loadu(scores + i) * v_scale;
+        if (mask) {
+            v = v + (mask_stride ? VEC::loadu(mask + i) : VEC(mask[0]));
+        }
+        VEC::saveu(scores + i, v);
+        v_max = VEC::max(v_max, v);
+    }
+    for (; i < len; i++) {
+        scores[i] = scores[i] * scale + (mask ? mask[i * mask_stride] : 0.f);
+        max_value = std::max(max_value, scores[i]);
+    }
+    VEC::saveu(vec_buf, v_max);
+    for (int p = 0; p < pack; p++) {
+        max_value = std::max(max_value, vec_buf[p]);
+    }
+
+    // exp and sum
+    float sum   = 0.f;
+    auto v_sum  = VEC(0.f);
+    auto v_base = VEC(max_value);
+    i           = 0;
+    for (; i + pack - 1 < len; i += pack) {
+        auto v = VEC::exp(VEC::loadu(scores + i) - v_base);
+        VEC::saveu(scores + i, v);
+        v_sum = v_sum + v;
+    }
+    for (; i < len; i++) {
+        scores[i] = expf(scores[i] - max_value);
+        sum += scores[i];
+    }
+    VEC::saveu(vec_buf, v_sum);
+    for (int p = 0; p < pack; p++) {
+        sum += vec_buf[p];
+    }
+
+    // division
+    float inv_sum = 1.f / sum;
+    i             = 0;
+    for (; i + pack - 1 < len; i += pack) {
+        VEC::saveu(scores + i, VEC::loadu(scores + i) * inv_sum);
+    }
+    for (; i < len; i++) {
+        scores[i] *= inv_sum;
+    }
+}
+
+X86FusedAttentionLayerAcc::~X86FusedAttentionLayerAcc() {}
+
+Status X86FusedAttentionLayerAcc::Reshape(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
+    auto q_dims      = inputs[0]->GetBlobDesc().dims;
+    auto k_dims      = inputs[1]->GetBlobDesc().dims;
+    auto v_dims      = inputs[2]->GetBlobDesc().dims;
+    auto output_dims = outputs[0]->GetBlobDesc().dims;
+    const int rank   = (int)output_dims.size();
+    batch_           = DimsVectorUtils::Count(output_dims, 0, rank - 2);
+    seq_q_           = output_dims[rank - 2];
+    q_row_broadcast_ = q_dims[q_dims.size() - 2] == 1 && seq_q_ > 1;
+    head_size_       = q_dims[q_dims.size() - 1];
+    seq_k_           = k_dims[k_dims.size() - 1];
+    v_size_          = v_dims[v_dims.size() - 1];
+
+    // q, k, v and mask of each batch of the output, broadcast batch dims repeat the same matrix
+    DimsVector batch_dims(output_dims.begin(), output_dims.end() - 2);
+    q_offsets_ = DimsFunctionUtils::BroadcastMatrixOffsets(q_dims, batch_dims);
+    k_offsets_ = DimsFunctionUtils::BroadcastMatrixOffsets(k_dims, batch_dims);
+    v_offsets_ = DimsFunctionUtils::BroadcastMatrixOffsets(v_dims, batch_dims);
+
+    // rows of a tile are the N of the gemms, keep them a multiple of the kernel width
+    int n_block = conv_gemm_conf_.n_block_;
+    tile_rows_  = std::max(n_block, kScoreTileSize / std::max(seq_k_, 1) / n_block * n_block);
+    tile_rows_  = std::min(tile_rows_, seq_q_);
+
+    int bias_size = ROUND_UP(tile_rows_, 8) * sizeof(float);
+    if (buffer_zero_bias_.GetBytesSize() < bias_size) {
+        buffer_zero_bias_ = RawBuffer(bias_size, 32);
+    }
+
+    mask_offsets_.clear();
+    mask_row_stride_ = 0;
+    mask_col_stride_ = 0;
+    if (inputs.size() > 3) {
+        auto mask_dims = inputs[3]->GetBlobDesc().dims;
+        mask_offsets_  = DimsFunctionUtils::BroadcastMatrixOffsets(mask_dims, batch_dims);
+        const int mask_rows = mask_dims.size() < 2 ? 1 : mask_dims[mask_dims.size() - 2];
+        const int mask_cols = mask_dims.back();
+        mask_row_stride_    = mask_rows == 1 ? 0 : mask_cols;
+        mask_col_stride_    = mask_cols == 1 ? 0 : 1;
+    }
+    return TNN_OK;
+}
+
+Status X86FusedAttentionLayerAcc::DoForward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
+    auto param = dynamic_cast<FusedAttentionLayerParam *>(param_);
+    CHECK_PARAM_NULL(param);
+
+    if (inputs[0]->GetBlobDesc().data_type != DATA_TYPE_FLOAT) {
+        return Status(TNNERR_LAYER_ERR, "FusedAttention only support float");
+    }
+
+    auto q_data      = handle_ptr<float *>(inputs[0]->GetHandle());
+    auto k_data      = handle_ptr<float *>(inputs[1]->GetHandle());
+    auto v_data      = handle_ptr<float *>(inputs[2]->GetHandle());
+    auto output_data = handle_ptr<float *>(outputs[0]->GetHandle());
+    float *mask_data = inputs.size() > 3 ? handle_ptr<float *>(inputs[3]->GetHandle()) : nullptr;
+    float *bias      = buffer_zero_bias_.force_to<float *>();
+
+    auto softmax_func = attention_softmax_func<Float8, 8>;
+    if (arch_ == sse42) {
+        softmax_func = attention_softmax_func<Float4, 4>;
+    }
+
+    int k_c     = conv_gemm_conf_.K_c_;
+    int m_block = conv_gemm_conf_.m_block_;
+    int n_block = conv_gemm_conf_.n_block_;
+
+    // k_t and v of one batch are packed once, and shared by all tiles of the batch
+    size_t packed_k_size = ROUND_UP(ROUND_UP(head_size_, k_c) * ROUND_UP(seq_k_, m_block), 8);
+    size_t packed_v_size = ROUND_UP(ROUND_UP(seq_k_, k_c) * ROUND_UP(v_size_, m_block), 8);
+    size_t scores_size   = ROUND_UP(tile_rows_ * seq_k_, 8);
+    size_t panel_size    = ROUND_UP(k_c * ROUND_UP(tile_rows_, n_block), 8);
+    size_t packed_size   = packed_k_size + packed_v_size;
+    size_t tile_size     = scores_size + panel_size;
+
+    // enough batches, e.g. heads, to keep all threads busy run one batch per thread,
+    // otherwise the tiles of one batch run in parallel
+    const int max_num_threads = GetParallelMaxThreads();
+    const int num_tiles       = UP_DIV(seq_q_, tile_rows_);
+    const bool batch_parallel = batch_ >= max_num_threads || num_tiles == 1;
+    const int num_packed      = batch_parallel ? max_num_threads : 1;
+
+    size_t workspace_size = num_packed * packed_size + max_num_threads * tile_size;
+    float *workspace      = reinterpret_cast<float *>(context_->GetSharedWorkSpace(workspace_size * sizeof(float)));
+    float *tile_workspace = workspace + num_packed * packed_size;
+
+    auto pack_kv = [&](int b, float *packed_k, float *packed_v) {
+        conv_pack_col_a_n(seq_k_, head_size_, k_data + k_offsets_[b], seq_k_, packed_k, conv_gemm_conf_);
+        conv_pack_col_a_n(v_size_, seq_k_, v_data + v_offsets_[b], v_size_, packed_v, conv_gemm_conf_);
+    };
+
+    // row major q[rows * D] * k_t[D * S_k] equals to col major k_t[S_k * D] * q[D * rows]
+    auto compute_tile = [&](int b, int tile, const float *packed_k, const float *packed_v, float *scores,
+                            float *panel) {
+        int row  = tile * tile_rows_;
+        int rows = std::min(tile_rows_, seq_q_ - row);
+
+        if (q_row_broadcast_) {
+            // q of a single row broadcast by the mask, the scores of all rows are the same before the mask
+            conv_sgemm_tn_col_major_prepack_a(seq_k_, 1, head_size_, packed_k, head_size_, q_data + q_offsets_[b],
+                                              head_size_, scores, seq_k_, bias, ActivationType_None, panel,
+                                              conv_gemm_conf_);
+            for (int r = 1; r < rows; r++) {
+                memcpy(scores + r * seq_k_, scores, seq_k_ * sizeof(float));
+            }
+        } else {
+            conv_sgemm_tn_col_major_prepack_a(seq_k_, rows, head_size_, packed_k, head_size_,
+                                              q_data + q_offsets_[b] + row * head_size_, head_size_, scores, seq_k_,
+                                              bias, ActivationType_None, panel, conv_gemm_conf_);
+        }
+
+        const float *mask = mask_data ? mask_data + mask_offsets_[b] + row * mask_row_stride_ : nullptr;
+        for (int r = 0; r < rows; r++) {
+            softmax_func(scores + r * seq_k_, seq_k_, param->scale, mask ? mask + r * mask_row_stride_ : nullptr,
+                         mask_col_stride_);
+        }
+
+        conv_sgemm_tn_col_major_prepack_a(v_size_, rows, seq_k_, packed_v, seq_k_, scores, seq_k_,
+                                          output_data + (b * seq_q_ + row) * v_size_, v_size_, bias,
+                                          ActivationType_None, panel, conv_gemm_conf_);
+    };
+
+    if (batch_parallel) {
+        ParallelForWithThreadId(0, batch_, [&](int b, int thread_id) {
+            float *packed_k = workspace + thread_id * packed_size;
+            float *scores   = tile_workspace + thread_id * tile_size;
+            pack_kv(b, packed_k, packed_k + packed_k_size);
+            for (int tile = 0; tile < num_tiles; tile++) {
+                compute_tile(b, tile, packed_k, packed_k + packed_k_size, scores, scores + scores_size);
+            }
+        });
+    } else {
+        for (int b = 0; b < batch_; b++) {
+            pack_kv(b, workspace, workspace + packed_k_size);
+            ParallelForWithThreadId(0, num_tiles, [&](int tile, int thread_id) {
+                float *scores = tile_workspace + thread_id * tile_size;
+                compute_tile(b, tile, workspace, workspace + packed_k_size, scores, scores + scores_size);
+            });
+        }
+    }
+
+    return TNN_OK;
+}
+
+REGISTER_X86_ACC(FusedAttention, LAYER_FUSED_ATTENTION);
+
+}  // namespace TNN_NS
@@ -0,0 +1,60 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef TNN_SOURCE_TNN_DEVICE_X86_X86_FUSED_ATTENTION_LAYER_ACC_H_
+#define TNN_SOURCE_TNN_DEVICE_X86_X86_FUSED_ATTENTION_LAYER_ACC_H_
+
+#include "tnn/device/x86/acc/x86_layer_acc.h"
+#include "tnn/device/x86/acc/compute/jit/conv_sgemm_driver.h"
+
+namespace TNN_NS {
+
+// @brief softmax(q * k_t * scale + mask) * v, computed by tiles of rows of q, so
+// that the scores of a tile stay in cache between the two gemms.
+class X86FusedAttentionLayerAcc : public X86LayerAcc {
+public:
+    virtual ~X86FusedAttentionLayerAcc();
+
+    virtual Status Reshape(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) override;
+
+    virtual Status DoForward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) override;
+
+protected:
+    conv_gemm_config<float, float, float> conv_gemm_conf_;
+
+    int batch_     = 0;
+    int seq_q_     = 0;
+    int seq_k_     = 0;
+    int head_size_ = 0;
+    int v_size_    = 0;
+    // q has a single row that the mask broadcasts to seq_q_ rows
+    bool q_row_broadcast_ = false;
+    // rows of q per tile
+    int tile_rows_ = 0;
+
+    // offset of the q, k, v and mask planes of each batch, and strides of the broadcast mask
+    std::vector<int> q_offsets_;
+    std::vector<int> k_offsets_;
+    std::vector<int> v_offsets_;
+    std::vector<int> mask_offsets_;
+    int mask_row_stride_ = 0;
+    int mask_col_stride_ = 0;
+
+    // zero bias of the gemms
+    RawBuffer buffer_zero_bias_;
+};
+
+}  // namespace TNN_NS
+
+#endif  // TNN_SOURCE_TNN_DEVICE_X86_X86_FUSED_ATTENTION_LAYER_ACC_H_
@@ -0,0 +1,122 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <cmath>
+
+#include "tnn/device/x86/acc/x86_layer_acc.h"
+#include "tnn/utils/dims_utils.h"
+#include "tnn/utils/parallel_for.h"
+
+namespace TNN_NS {
+
+DECLARE_X86_ACC(GridSample, LAYER_GRIDSAMPLE);
+
+static inline bool within_bounds_2d(int h, int w, int H, int W) {
+    return h >= 0 && h < H && w >= 0 && w < W;
+}
+
+// corner indices and weights of one output row, shared by all channels
+static void grid_sample_row_weights(const float *grid, int output_width, int input_height, int input_width,
+                                    int *index, float *weight) {
+    for (int w = 0; w < output_width; ++w) {
+        float x = grid[w * 2];
+        float y = grid[w * 2 + 1];
+        // unnormalize
+        float ix  = (x + 1) * input_width * 0.5 - 0.5;
+        float iy  = (y + 1) * input_height * 0.5 - 0.5;
+        int ix_nw = static_cast<int>(std::floor(ix));
+        int iy_nw = static_cast<int>(std::floor(iy));
+        int ix_se = ix_nw + 1;
+        int iy_se = iy_nw + 1;
+
+        // north-west, north-east, south-west, south-east
+        bool nw_within_bound = within_bounds_2d(iy_nw, ix_nw, input_height, input_width);
+        bool ne_within_bound = within_bounds_2d(iy_nw, ix_se, input_height, input_width);
+        bool sw_within_bound = within_bounds_2d(iy_se, ix_nw, input_height, input_width);
+        bool se_within_bound = within_bounds_2d(iy_se, ix_se, input_height, input_width);
+        int *w_index         = index + w * 4;
+        float *w_weight      = weight + w * 4;
+        w_weight[0]          = nw_within_bound ? (ix_se - ix) * (iy_se - iy) : 0;
+        w_weight[1]          = ne_within_bound ? (ix - ix_nw) * (iy_se - iy) : 0;
+        w_weight[2]          = sw_within_bound ? (ix_se - ix) * (iy - iy_nw) : 0;
+        w_weight[3]          = se_within_bound ? (ix - ix_nw) * (iy - iy_nw) : 0;
+        w_index[0]           = nw_within_bound ? iy_nw * input_width + ix_nw : 0;
+        w_index[1]           = ne_within_bound ? iy_nw * input_width + ix_se : 0;
+        w_index[2]           = sw_within_bound ? iy_se * input_width + ix_nw : 0;
+        w_index[3]           = se_within_bound ? iy_se * input_width + ix_se : 0;
+    }
+}
+
+Status X86GridSampleLayerAcc::DoForward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
+    auto layer_param = dynamic_cast<GridSampleLayerParam *>(param_);
+    CHECK_PARAM_NULL(layer_param);
+    if (layer_param->mode != 2 || layer_param->pad_type != 0 || layer_param->align_corners != 0) {
+        return Status(TNNERR_PARAM_ERR, "X86GridSampleLayerAcc dont support some mode or pade type or align_corners");
+    }
+    if (inputs[0]->GetBlobDesc().data_type != DATA_TYPE_FLOAT) {
+        return Status(TNNERR_PARAM_ERR, "X86GridSampleLayerAcc now only support float data");
+    }
+    auto input_dims  = inputs[0]->GetBlobDesc().dims;
+    auto grid_dims   = inputs[1]->GetBlobDesc().dims;
+    auto output_dims = outputs[0]->GetBlobDesc().dims;
+    if (output_dims.size() != 4) {
+        return Status(TNNERR_PARAM_ERR, "X86GridSampleLayerAcc only support 4D sampler");
+    }
+    const int batch               = input_dims[0];
+    const int channel             = input_dims[1];
+    const int input_height        = input_dims[2];
+    const int input_width         = input_dims[3];
+    const int input_channel_area  = DimsVectorUtils::Count(input_dims, 2);
+    const int output_channel_area = DimsVectorUtils::Count(output_dims, 2);
+    const int grid_area           = DimsVectorUtils::Count(grid_dims, 1);
+    const int output_height       = output_dims[2];
+    const int output_width        = output_dims[3];
+
+    float *input_base_ptr  = handle_ptr<float *>(inputs[0]->GetHandle());
+    float *grid_base_ptr   = handle_ptr<float *>(inputs[1]->GetHandle());
+    float *output_base_ptr = handle_ptr<float *>(outputs[0]->GetHandle());
+
+    const int threads = GetParallelMaxThreads();
+    size_t row_size   = output_width * 4;
+    auto workspace    = reinterpret_cast<char *>(
+        context_->GetSharedWorkSpace(threads * row_size * (sizeof(int) + sizeof(float))));
+
+    ParallelForWithThreadId(0, batch * output_height, [&](int task, int thread_id) {
+        const int n   = task / output_height;
+        const int h   = task % output_height;
+        int *index    = reinterpret_cast<int *>(workspace + thread_id * row_size * (sizeof(int) + sizeof(float)));
+        float *weight = reinterpret_cast<float *>(index + row_size);
+        grid_sample_row_weights(grid_base_ptr + n * grid_area + h * output_width * 2, output_width, input_height,
+                                input_width, index, weight);
+
+        const float *input_data = input_base_ptr + n * channel * input_channel_area;
+        float *output_data      = output_base_ptr + n * channel * output_channel_area + h * output_width;
+        for (int c = 0; c < channel; ++c) {
+            const float *src = input_data + c * input_channel_area;
+            float *dst       = output_data + c * output_channel_area;
+            for (int w = 0; w < output_width; ++w) {
+                const int *w_index    = index + w * 4;
+                const float *w_weight = weight + w * 4;
+                dst[w] = src[w_index[0]] * w_weight[0] + src[w_index[1]] * w_weight[1] +
+                         src[w_index[2]] * w_weight[2] + src[w_index[3]] * w_weight[3];
+            }
+        }
+    });
+
+    return TNN_OK;
+}
+
+REGISTER_X86_ACC(GridSample, LAYER_GRIDSAMPLE);
+
+}  // namespace TNN_NS
@@ -12,6 +12,9 @@
 // CONDITIONS OF ANY KIND, either express or implied. See the License for the
 // specific language governing permissions and limitations under the License.
 
+#include <algorithm>
+#include <cmath>
+
 #include "tnn/device/x86/x86_common.h"
 #include "tnn/device/x86/x86_context.h"
 #include "tnn/device/x86/x86_util.h"
@@ -92,19 +95,41 @@ Status X86InnerProductLayerAcc::allocateBufferWeight(const std::vector<Blob *> &
     auto input_dims   = inputs[0]->GetBlobDesc().dims;
     auto output_dims  = outputs[0]->GetBlobDesc().dims;
 
+    // int8 weights of dynamic range quantized models stay quantized for float blobs
+    bool quant_weight = res->weight_handle.GetDataType() == DATA_TYPE_INT8 &&
+                        output_blob->GetBlobDesc().data_type == DATA_TYPE_FLOAT;
+
     if (!buffer_weight_.GetBytesSize()) {
-        if (res->weight_handle.GetDataType() == DATA_TYPE_FLOAT) {
+        if (res->weight_handle.GetDataType() == DATA_TYPE_FLOAT || quant_weight) {
+            auto weight_type = GetPackedWeightDataType();
+            int K = DimsVectorUtils::Count(input_dims, 1);
+            int M = DimsVectorUtils::Count(output_dims, 1);
+
+            // pack the int8 values in fp32 first, packing them is exact
+            RawBuffer int8_values;
+            const float *src = res->weight_handle.force_to<float *>();
+            if (quant_weight) {
+                int weight_count = res->weight_handle.GetDataCount();
+                int8_values      = RawBuffer(weight_count * sizeof(float));
+                X86ConvertInt8ToFloat(res->weight_handle.force_to<void *>(), int8_values.force_to<float *>(),
+                                      weight_count, DATA_TYPE_INT8);
+                src = int8_values.force_to<float *>();
+
+                // int4 groups are laid out for sgemv only, sgemm is compute bound and keeps int8
+                auto precision     = context_ ? context_->GetPrecision() : PRECISION_AUTO;
+                quant_weight_bits_ = (precision == PRECISION_LOW && impl_ == InnerProductSgemv) ? 4 : 8;
+                quant_group_size_  = quant_weight_bits_ == 4 ? MIN(K, kInt4WeightGroupSize) : K;
+            }
+
             if (impl_ == InnerProductSgemv) {
                 int oc_rup = 8;
                 if (arch_ == sse42) {
                     oc_rup = 4;
                 }
-                const float *src = res->weight_handle.force_to<float *>();
-                size_t input_stride = DimsVectorUtils::Count(input_dims, 1);
+                size_t input_stride = K;
                 size_t weight_count = ROUND_UP(output_dims[1], oc_rup) * input_stride;
-                int data_byte_size = DataTypeUtils::GetBytesSize(res->weight_handle.GetDataType());
 
-                RawBuffer temp_buffer(weight_count * data_byte_size, oc_rup * 4);
+                RawBuffer temp_buffer(weight_count * sizeof(float), oc_rup * 4);
                 float *dst = temp_buffer.force_to<float *>();
 
                 if (arch_ == avx2) {
@@ -114,14 +139,16 @@ Status X86InnerProductLayerAcc::allocateBufferWeight(const std::vector<Blob *> &
                 }
 
                 temp_buffer.SetDataType(DATA_TYPE_FLOAT);
+                if (quant_weight) {
+                    RETURN_ON_NEQ(QuantizePackedWeight(temp_buffer, oc_rup, K, M, res->scale_handle), TNN_OK);
+                } else {
+                    RETURN_ON_NEQ(ConvertPackedWeight(temp_buffer, weight_type), TNN_OK);
+                }
                 buffer_weight_ = temp_buffer;
             } else {
                 int k_c = conv_gemm_conf_.K_c_;
                 int m_block = conv_gemm_conf_.m_block_;
-                int K = DimsVectorUtils::Count(input_dims, 1);
-                int M = DimsVectorUtils::Count(output_dims, 1);
                 size_t weight_pack_size = ROUND_UP(K, k_c) * ROUND_UP(M, m_block);
-                const float *src = res->weight_handle.force_to<float *>();
 
                 // align pointer of packed weights, since gemm use aligned load for input A
                 RawBuffer temp_buffer(weight_pack_size * sizeof(float), 32);
@@ -130,6 +157,11 @@ Status X86InnerProductLayerAcc::allocateBufferWeight(const std::vector<Blob *> &
                 conv_pack_col_a_t(M, K, src, K, dst, conv_gemm_conf_);
 
                 temp_buffer.SetDataType(DATA_TYPE_FLOAT);
+                if (quant_weight) {
+                    RETURN_ON_NEQ(QuantizePackedWeight(temp_buffer, m_block, K, M, res->scale_handle), TNN_OK);
+                } else {
+                    RETURN_ON_NEQ(ConvertPackedWeight(temp_buffer, weight_type), TNN_OK);
+                }
                 buffer_weight_ = temp_buffer;
             }
         } else if (res->weight_handle.GetDataType() == DATA_TYPE_INT8) {
@@ -175,6 +207,80 @@ Status X86InnerProductLayerAcc::allocateBufferWeight(const std::vector<Blob *> &
     return TNN_OK;
 }
 
+Status X86InnerProductLayerAcc::ConvertPackedWeight(RawBuffer &buffer, DataType weight_type) {
+    if (weight_type == DATA_TYPE_FLOAT) {
+        return TNN_OK;
+    }
+    size_t count = buffer.GetBytesSize() / sizeof(float);
+    RawBuffer half_buffer(count * DataTypeUtils::GetBytesSize(weight_type), 32);
+    RETURN_ON_NEQ(X86ConvertFloatTo16Bit(buffer.force_to<float *>(), half_buffer.force_to<void *>(), count, weight_type),
+                  TNN_OK);
+    half_buffer.SetDataType(weight_type);
+    buffer = half_buffer;
+    return TNN_OK;
+}
+
+Status X86InnerProductLayerAcc::QuantizePackedWeight(RawBuffer &buffer, int pack, int ic, int oc, RawBuffer w_scale) {
+    if (w_scale.GetDataType() == DATA_TYPE_HALF) {
+        w_scale = ConvertHalfHandle(w_scale);
+    }
+    const float *w_scale_ptr = w_scale.force_to<float *>();
+    CHECK_PARAM_NULL(w_scale_ptr);
+    const int w_scale_count = w_scale.GetDataCount();
+
+    const int group_count = UP_DIV(ic, quant_group_size_);
+    const int oc_blocks   = UP_DIV(oc, pack);
+    RawBuffer scale_buffer(oc_blocks * group_count * pack * sizeof(float));
+    float *scale_ptr = scale_buffer.force_to<float *>();
+    const float *src = buffer.force_to<float *>();
+
+    if (quant_weight_bits_ == 8) {
+        // one group, the layout of the packed weights does not matter
+        size_t count = buffer.GetBytesSize() / sizeof(float);
+        RawBuffer int8_buffer(count, 32);
+        int8_t *dst = int8_buffer.force_to<int8_t *>();
+        for (size_t i = 0; i < count; i++) {
+            dst[i] = static_cast<int8_t>(src[i]);
+        }
+        for (int i = 0; i < oc; i++) {
+            scale_ptr[i] = w_scale_ptr[w_scale_count == 1 ? 0 : i];
+        }
+        int8_buffer.SetDataType(DATA_TYPE_INT8);
+        buffer = int8_buffer;
+    } else {
+        // requantize each group of every output channel to [-8, 7] with its own step
+        RawBuffer int4_buffer(oc_blocks * ic * pack / 2, 32);
+        uint8_t *dst = int4_buffer.force_to<uint8_t *>();
+        for (int ob = 0; ob < oc_blocks; ob++) {
+            const float *src_ob = src + (size_t)ob * ic * pack;
+            for (int g = 0; g < group_count; g++) {
+                const int ic_begin = g * quant_group_size_;
+                const int ic_end   = MIN(ic_begin + quant_group_size_, ic);
+                for (int l = 0; l < pack; l++) {
+                    float amax = 0.f;
+                    for (int i = ic_begin; i < ic_end; i++) {
+                        amax = std::max(amax, std::fabs(src_ob[i * pack + l]));
+                    }
+                    const float step = amax > 0.f ? amax / 7.f : 1.f;
+                    const int o      = ob * pack + l;
+                    scale_ptr[(ob * group_count + g) * pack + l] =
+                        o < oc ? step * w_scale_ptr[w_scale_count == 1 ? 0 : o] : 0.f;
+                    for (int i = ic_begin; i < ic_end; i++) {
+                        int q      = static_cast<int>(std::round(src_ob[i * pack + l] / step));
+                        q          = std::min(std::max(q, -8), 7) + 8;
+                        size_t idx = ((size_t)ob * ic + i) * pack + l;
+                        dst[idx / 2] |= (idx & 1) ? (q << 4) : q;
+                    }
+                }
+            }
+        }
+        int4_buffer.SetDataType(DATA_TYPE_INT8);
+        buffer = int4_buffer;
+    }
+    buffer_scale_ = scale_buffer;
+    return TNN_OK;
+}
+
 Status X86InnerProductLayerAcc::allocateBufferBias(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
     InnerProductLayerParam *param = dynamic_cast<InnerProductLayerParam *>(param_);
     CHECK_PARAM_NULL(param);
@@ -235,40 +341,67 @@ Status X86InnerProductLayerAcc::DoForward(const std::vector<Blob *> &inputs, con
     auto output_dims  = outputs[0]->GetBlobDesc().dims;
 
     if (output_blob->GetBlobDesc().data_type == DATA_TYPE_FLOAT) {
-        auto X86SgemvFunc = X86Sgemv<Float4, 4>;
+        void (*X86SgemvFunc)(float*, const float*, const void*, DataType, float*, DimsVector, DimsVector) =
+            X86Sgemv<Float4, 4>;
+        void (*X86SgemvQuantFunc)(float*, const float*, const void*, int, const float*, int, float*, DimsVector,
+                                  DimsVector) = X86SgemvQuant<Float4, 4>;
         void (*X86VecAddFunc)(float*, const float*, long) = X86_VectorAdd<Float4, 4>;
         if (arch_ == avx2) {
             X86SgemvFunc = X86Sgemv<Float8, 8>;
+            X86SgemvQuantFunc = X86SgemvQuant<Float8, 8>;
             X86VecAddFunc = X86_VectorAdd<Float8, 8>;
         }
 
         float *input_data  = handle_ptr<float*>(input_blob->GetHandle());
         float *output_data = handle_ptr<float*>(output_blob->GetHandle());
-        float *weight_data = buffer_weight_.force_to<float *>();
+        void *weight_data  = buffer_weight_.force_to<void *>();
+        auto weight_type   = buffer_weight_.GetDataType();
         float *bias_data   = buffer_bias_.force_to<float *>();
 
+        float *scale_data  = buffer_scale_.force_to<float *>();
+
         if (impl_ == InnerProductSgemv) {
-            X86SgemvFunc(output_data, input_data, weight_data, bias_data, input_dims, output_dims);
+            if (quant_weight_bits_) {
+                X86SgemvQuantFunc(output_data, input_data, weight_data, quant_weight_bits_, scale_data,
+                                  quant_group_size_, bias_data, input_dims, output_dims);
+            } else {
+                X86SgemvFunc(output_data, input_data, weight_data, weight_type, bias_data, input_dims, output_dims);
+            }
         } else {
             int k_c = conv_gemm_conf_.K_c_;
+            int m_block = conv_gemm_conf_.m_block_;
             int n_block = conv_gemm_conf_.n_block_;
             int K = DimsVectorUtils::Count(input_dims, 1);
             int N = input_dims[0];
             int M = DimsVectorUtils::Count(output_dims, 1);
 
-            size_t workspace_size = k_c * ROUND_UP(N, n_block) * sizeof(float);
-            float *workspace = reinterpret_cast<float *>(context_->GetSharedWorkSpace(workspace_size));
+            size_t pack_b_bytes = ROUND_UP(k_c * ROUND_UP(N, n_block) * sizeof(float), 32);
+            size_t weight_block_bytes = weight_type == DATA_TYPE_FLOAT ? 0 : k_c * ROUND_UP(M, m_block) * sizeof(float);
+            float *workspace = reinterpret_cast<float *>(context_->GetSharedWorkSpace(pack_b_bytes + weight_block_bytes));
+
+            conv_gemm_packed_weight packed_weight;
+            packed_weight.data        = weight_data;
+            packed_weight.data_type   = weight_type;
+            packed_weight.unpack_func = weight_type == DATA_TYPE_INT8 ? X86ConvertInt8ToFloat : X86Convert16BitToFloat;
+            packed_weight.block_buf   = workspace + pack_b_bytes / sizeof(float);
 
             RawBuffer fake_bias(N * sizeof(float));
             float *fake_bias_ptr = fake_bias.force_to<float *>();
 
-            conv_sgemm_tn_col_major_prepack_a(M, N, K, weight_data, K,
+            conv_sgemm_tn_col_major_prepack_a(M, N, K, packed_weight, K,
                                 input_data, K, output_data, M,
                                 fake_bias_ptr, ActivationType_None,
                                 workspace, conv_gemm_conf_);
             for (int i = 0; i < N; i++) {
                 auto dst = output_data + i * M;
-                X86VecAddFunc(dst, bias_data, M);
+                if (quant_weight_bits_) {
+                    // int8 weights have one group, a scale per output channel
+                    for (int m = 0; m < M; m++) {
+                        dst[m] = dst[m] * scale_data[m] + bias_data[m];
+                    }
+                } else {
+                    X86VecAddFunc(dst, bias_data, M);
+                }
             }
         }
     } else if (output_blob->GetBlobDesc().data_type == DATA_TYPE_INT8) {
@@ -24,6 +24,10 @@ enum InnerProductCompute {
 };
 
 namespace TNN_NS {
+
+// input channels sharing one scale of int4 weights
+const int kInt4WeightGroupSize = 32;
+
 class X86InnerProductLayerAcc : public X86LayerAcc {
 public:
     virtual ~X86InnerProductLayerAcc();
@@ -35,12 +39,21 @@ public:
     virtual Status allocateBufferBias(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs);
 
 protected:
+    // @brief convert the packed fp32 weights to weight_type in place, keeping the layout
+    Status ConvertPackedWeight(RawBuffer &buffer, DataType weight_type);
+    // @brief quantize the packed weights holding int8 values in fp32 to quant_weight_bits_, packed in blocks of
+    // pack output channels. the scales of each group of quant_group_size_ input channels go to buffer_scale_
+    Status QuantizePackedWeight(RawBuffer &buffer, int pack, int ic, int oc, RawBuffer w_scale);
+
     RawBuffer buffer_weight_;
     RawBuffer buffer_bias_;
     RawBuffer buffer_scale_;
     conv_gemm_config<float, float, float> conv_gemm_conf_;
     InnerProductCompute impl_;
     std::shared_ptr<LayerResource> fc_acc_f32_resource_ = nullptr;
+    // bits of the weights kept quantized for float blobs, 0 if they are not
+    int quant_weight_bits_ = 0;
+    int quant_group_size_  = 0;
 };
 
 }  // namespace TNN_NS
@@ -80,6 +80,16 @@ Status X86LayerAcc::DoForward(const std::vector<Blob *> &inputs, const std::vect
     return Status(TNNERR_LAYER_ERR, "DoForward not implement");
 }
 
+DataType X86LayerAcc::GetPackedWeightDataType() {
+    auto precision = context_ ? context_->GetPrecision() : PRECISION_AUTO;
+    if (precision == PRECISION_LOW) {
+        return DATA_TYPE_BFP16;
+    } else if (precision == PRECISION_NORMAL && cpu_with_isa(f16c)) {
+        return DATA_TYPE_HALF;
+    }
+    return DATA_TYPE_FLOAT;
+}
+
 Status X86LayerAcc::ReloadConstantBlobs(const std::vector<Blob *> &inputs, bool only_reload_shape_differ_blob) {
     auto const_resource = const_resource_;
     auto const_resource_flag = const_resource_flag_;
@@ -50,6 +50,10 @@ public:
 #endif
 
 protected:
+    // @brief data type to store the packed weights of gemm based accs in: bfp16 for PRECISION_LOW,
+    // half for PRECISION_NORMAL if the cpu has f16c, float otherwise. compute is fp32 in all cases.
+    DataType GetPackedWeightDataType();
+
     LayerParam* param_          = nullptr;
     LayerResource* resource_    = nullptr;
     X86Context *context_           = nullptr;
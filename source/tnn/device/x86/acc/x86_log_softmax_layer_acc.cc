@@ -0,0 +1,185 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+
+#include "tnn/device/x86/acc/Float4.h"
+#include "tnn/device/x86/acc/Float8.h"
+#include "tnn/device/x86/acc/x86_layer_acc.h"
+#include "tnn/utils/dims_utils.h"
+#include "tnn/utils/parallel_for.h"
+
+namespace TNN_NS {
+
+DECLARE_X86_ACC(LogSoftMax, LAYER_LOGSOFTMAX);
+
+// log softmax over contiguous channels, output = input - max - log(sum(exp(input - max)))
+template <typename VEC, int pack>
+static void log_softmax_channel_func(const float *input_ptr, float *output_ptr, int channel) {
+    float vec_buf[pack];
+    // max
+    float max_val = input_ptr[0];
+    int ele       = 0;
+    auto v_max    = VEC(max_val);
+    for (; ele + pack - 1 < channel; ele += pack) {
+        v_max = VEC::max(v_max, VEC::loadu(input_ptr + ele));
+    }
+    for (; ele < channel; ele++) {
+        max_val = std::max(max_val, input_ptr[ele]);
+    }
+    VEC::saveu(vec_buf, v_max);
+    for (int i = 0; i < pack; i++) {
+        max_val = std::max(max_val, vec_buf[i]);
+    }
+
+    // sum of exp
+    float sum  = 0.f;
+    auto v_sum = VEC(0.f);
+    ele        = 0;
+    for (; ele + pack - 1 < channel; ele += pack) {
+        v_sum = v_sum + VEC::exp(VEC::loadu(input_ptr + ele) - VEC(max_val));
+    }
+    for (; ele < channel; ele++) {
+        sum += expf(input_ptr[ele] - max_val);
+    }
+    VEC::saveu(vec_buf, v_sum);
+    for (int i = 0; i < pack; i++) {
+        sum += vec_buf[i];
+    }
+
+    const float shift = max_val + logf(sum);
+    ele               = 0;
+    for (; ele + pack - 1 < channel; ele += pack) {
+        VEC::saveu(output_ptr + ele, VEC::loadu(input_ptr + ele) - VEC(shift));
+    }
+    for (; ele < channel; ele++) {
+        output_ptr[ele] = input_ptr[ele] - shift;
+    }
+}
+
+// log softmax of elements [begin, end) of channels with stride count
+template <typename VEC, int pack>
+static void log_softmax_func(const float *input_ptr, float *output_ptr, int channel, int count, int begin, int end,
+                             float *temp) {
+    const int len = end - begin;
+    float *max    = temp;
+    float *sum    = temp + ROUND_UP(len, 8);
+    input_ptr += begin;
+    output_ptr += begin;
+
+    // max
+    memcpy(max, input_ptr, len * sizeof(float));
+    for (int c = 1; c < channel; c++) {
+        const float *input_channel = input_ptr + c * count;
+        int ele                    = 0;
+        for (; ele + pack - 1 < len; ele += pack) {
+            VEC::saveu(max + ele, VEC::max(VEC::loadu(max + ele), VEC::loadu(input_channel + ele)));
+        }
+        for (; ele < len; ele++) {
+            max[ele] = std::max(max[ele], input_channel[ele]);
+        }
+    }
+
+    // sum of exp
+    memset(sum, 0, len * sizeof(float));
+    for (int c = 0; c < channel; c++) {
+        const float *input_channel = input_ptr + c * count;
+        int ele                    = 0;
+        for (; ele + pack - 1 < len; ele += pack) {
+            VEC v_exp = VEC::exp(VEC::loadu(input_channel + ele) - VEC::loadu(max + ele));
+            VEC::saveu(sum + ele, VEC::loadu(sum + ele) + v_exp);
+        }
+        for (; ele < len; ele++) {
+            sum[ele] += expf(input_channel[ele] - max[ele]);
+        }
+    }
+
+    // shift = max + log(sum)
+    int ele = 0;
+    for (; ele + pack - 1 < len; ele += pack) {
+        VEC::saveu(max + ele, VEC::loadu(max + ele) + VEC::log(VEC::loadu(sum + ele)));
+    }
+    for (; ele < len; ele++) {
+        max[ele] += logf(sum[ele]);
+    }
+
+    for (int c = 0; c < channel; c++) {
+        const float *input_channel = input_ptr + c * count;
+        float *output_channel      = output_ptr + c * count;
+        int ele                    = 0;
+        for (; ele + pack - 1 < len; ele += pack) {
+            VEC::saveu(output_channel + ele, VEC::loadu(input_channel + ele) - VEC::loadu(max + ele));
+        }
+        for (; ele < len; ele++) {
+            output_channel[ele] = input_channel[ele] - max[ele];
+        }
+    }
+}
+
+Status X86LogSoftMaxLayerAcc::DoForward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
+    auto params = dynamic_cast<LogSoftmaxLayerParam *>(param_);
+    if (!params) {
+        LOGE("Error: LogSoftmaxLayerParam is unsupported\n");
+        return Status(TNNERR_MODEL_ERR, "Error: LogSoftmaxLayerParam is unsupported");
+    }
+
+    float *input_data  = handle_ptr<float *>(inputs[0]->GetHandle());
+    float *output_data = handle_ptr<float *>(outputs[0]->GetHandle());
+    auto dims          = inputs[0]->GetBlobDesc().dims;
+    int axis           = static_cast<int>((params->axis + dims.size()) % dims.size());
+    int batch          = DimsVectorUtils::Count(dims, 0, axis);
+    int channel        = dims[axis];
+    int count          = DimsVectorUtils::Count(dims, axis + 1);
+
+    if (count == 1) {
+        auto func = log_softmax_channel_func<Float8, 8>;
+        if (arch_ == sse42) {
+            func = log_softmax_channel_func<Float4, 4>;
+        }
+        ParallelFor(0, batch, [&](int n) { func(input_data + n * channel, output_data + n * channel, channel); });
+        return TNN_OK;
+    }
+
+    auto func = log_softmax_func<Float8, 8>;
+    if (arch_ == sse42) {
+        func = log_softmax_func<Float4, 4>;
+    }
+
+    // split the inner elements into blocks if there are not enough batches to keep threads busy
+    const int threads = GetParallelMaxThreads();
+    int block         = count;
+    if (batch < threads) {
+        block = std::max(ROUND_UP(UP_DIV(count, UP_DIV(threads, batch)), 8), 64);
+        block = std::min(block, count);
+    }
+    const int num_blocks = UP_DIV(count, block);
+
+    size_t temp_size = 2 * ROUND_UP(block, 8);
+    float *workspace = reinterpret_cast<float *>(context_->GetSharedWorkSpace(threads * temp_size * sizeof(float)));
+
+    ParallelForWithThreadId(0, batch * num_blocks, [&](int task, int thread_id) {
+        const int n     = task / num_blocks;
+        const int begin = (task % num_blocks) * block;
+        const int end   = std::min(begin + block, count);
+        func(input_data + n * channel * count, output_data + n * channel * count, channel, count, begin, end,
+             workspace + thread_id * temp_size);
+    });
+
+    return TNN_OK;
+}
+
+REGISTER_X86_ACC(LogSoftMax, LAYER_LOGSOFTMAX);
+
+}  // namespace TNN_NS
@@ -17,103 +17,94 @@
 #include "tnn/utils/dims_vector_utils.h"
 #include "tnn/device/x86/acc/x86_lstm_layer_acc.h"
 #include "tnn/device/x86/acc/Float4.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/device/x86/acc/Float8.h"
+#include "tnn/utils/parallel_for.h"
 namespace TNN_NS {
 
-static void X86LSTMActivate(const float *gates, float *h_t, float *c_t, float *y, int len) {
-    int len_vec  = len / 4 * 4;
-    OMP_PARALLEL_FOR_GUIDED_
-    for (int i = 0; i < len_vec; i += 4) {
-        Float4x4 vec = Float4x4::ld4u(gates + i * 4);
-        Float4 I, O, F, C;
-        vec.get_lane(I, 0);
-        vec.get_lane(O, 1);
-        vec.get_lane(F, 2);
-        vec.get_lane(C, 3);
-
-        I = Float4::sigmoid(I);
-        O = Float4::sigmoid(O);
-        F = Float4::sigmoid(F);
-        C = Float4::tanh(C);
-
-        Float4 cell2_vec = F * Float4::loadu(c_t + i) + I * C;
-        Float4 h_vec = O * Float4::tanh(cell2_vec);
-        Float4::saveu(c_t + i, cell2_vec);
-        Float4::saveu(h_t + i, h_vec);
-        Float4::saveu(y + i, h_vec);
-    }
-    for (int i = len_vec; i < len; i++) {
-        float I = gates[i * 4];
-        float O = gates[i * 4 + 1];
-        float F = gates[i * 4 + 2];
-        float C = gates[i * 4 + 3];
-
-        I = 1.f / (1.f + exp(-I));
-        F = 1.f / (1.f + exp(-F));
-        O = 1.f / (1.f + exp(-O));
-        C = tanh(C);
-
-        float cell2 = F * c_t[i] + I * C;
-        float H = O * tanh(cell2);
-        c_t[i] = cell2;
-        h_t[i] = H;
-        y[i] = H;
+// hidden units of one gate block
+static const int kGateBlock = 8;
+// recurrent gemms of fewer MACs per step run the two directions in parallel
+static const size_t kSmallStepSize = 1 << 20;
+
+// index of gate g of hidden unit u in the blocked gates
+static inline int X86LSTMGateIndex(int g, int u) {
+    return (u / kGateBlock) * 4 * kGateBlock + g * kGateBlock + u % kGateBlock;
+}
+
+// add bias and activate the gates of one step in one pass, update h_t, c_t and y
+template <typename VEC, int pack>
+static void X86LSTMActivate(const float *gates, const float *bias, float *h_t, float *c_t, float *y,
+                            int hidden_size) {
+    float c_buf[kGateBlock];
+    float h_buf[kGateBlock];
+    for (int u = 0; u < hidden_size; u += kGateBlock) {
+        const float *gates_u = gates + u * 4;
+        const float *bias_u  = bias + u * 4;
+        const int count      = MIN(kGateBlock, hidden_size - u);
+
+        float *c_ptr = c_t + u;
+        float *h_ptr = h_t + u;
+        if (count < kGateBlock) {
+            memset(c_buf, 0, sizeof(c_buf));
+            memcpy(c_buf, c_t + u, count * sizeof(float));
+            c_ptr = c_buf;
+            h_ptr = h_buf;
+        }
+
+        for (int p = 0; p < kGateBlock; p += pack) {
+            VEC I = VEC::sigmoid(VEC::loadu(gates_u + p) + VEC::loadu(bias_u + p));
+            VEC O = VEC::sigmoid(VEC::loadu(gates_u + kGateBlock + p) + VEC::loadu(bias_u + kGateBlock + p));
+            VEC F = VEC::sigmoid(VEC::loadu(gates_u + 2 * kGateBlock + p) + VEC::loadu(bias_u + 2 * kGateBlock + p));
+            VEC C = VEC::tanh(VEC::loadu(gates_u + 3 * kGateBlock + p) + VEC::loadu(bias_u + 3 * kGateBlock + p));
+
+            VEC cell = F * VEC::loadu(c_ptr + p) + I * C;
+            VEC h    = O * VEC::tanh(cell);
+            VEC::saveu(c_ptr + p, cell);
+            VEC::saveu(h_ptr + p, h);
+        }
+
+        if (count < kGateBlock) {
+            memcpy(c_t + u, c_buf, count * sizeof(float));
+            memcpy(h_t + u, h_buf, count * sizeof(float));
+        }
+        memcpy(y + u, h_t + u, count * sizeof(float));
     }
 }
 
 Status X86LSTMONNXLayerAcc::LSTMOneDirection(const float *x, float *y, const float *w, const float *r,
                               const float *b, float *h_t, float *c_t, int seq_len, int batch_size,
-                              int input_size, int hidden_size, int reverse) {
-    int k_c = conv_gemm_conf_.K_c_;
-    int n_block = conv_gemm_conf_.n_block_;
+                              int input_size, int hidden_size, int y_stride, int reverse,
+                              float *gemm_buf, float *gates_buf) {
+    auto activate_func = X86LSTMActivate<Float8, 8>;
+    if (arch_ == sse42) {
+        activate_func = X86LSTMActivate<Float4, 4>;
+    }
 
-    // sgemm for weight tensor
-    // weights: [4*hidden_size, input_size]
+    // sgemm for weight tensor of all steps at once
+    // weights: [4*hidden_pad, input_size]
     // inputs: [seq_len, batch, input_size]
     int K = input_size;
     int N = seq_len * batch_size;
-    int M = 4 * hidden_size;
-
-    // two temp buf: gemm_buf and gates_buf
-    size_t gemm_buf_size = ROUND_UP(k_c * ROUND_UP(N, n_block) * sizeof(float), 32);
-    size_t gates_buf_size = ROUND_UP(N * M * sizeof(float), 32);
-    size_t workspace_size = gemm_buf_size + gates_buf_size;
-    float *workspace = reinterpret_cast<float *>(context_->GetSharedWorkSpace(workspace_size));
-    float *gemm_buf = workspace;
-    float *gates_buf = workspace + gemm_buf_size / sizeof(float);
-
-    RawBuffer fake_bias(N * sizeof(float));
-    float *fake_bias_ptr = fake_bias.force_to<float *>();
+    int M = 4 * hidden_pad_;
     conv_sgemm_tn_col_major_prepack_a(M, N, K, w, K, x, K, gates_buf, M,
-            fake_bias_ptr, ActivationType_None, gemm_buf, conv_gemm_conf_);
-    
+            buffer_zero_bias_.force_to<float *>(), ActivationType_None, gemm_buf, conv_gemm_conf_);
+
     for (int t = 0; t < seq_len; t++) {
         int ti = reverse ? seq_len - 1 - t : t;
-        auto gates_t = gates_buf +  ti * batch_size * 4 * hidden_size;
-        auto y_t = y + ti * batch_size * hidden_size;
-
-        // add bias
-        OMP_PARALLEL_FOR_GUIDED_
-        for (int i = 0; i < batch_size; i++) {
-            auto gates_b = gates_t + i * 4 * hidden_size;
-            for (int j = 0; j < hidden_size; j++) {
-                auto gates_j = gates_b + j * 4;
-                auto bias_j = b + j * 4;
-                Float4::saveu(gates_j, Float4::loadu(gates_j) + Float4::loadu(bias_j));
-            }
-        }
+        auto gates_t = gates_buf + ti * batch_size * M;
+        auto y_t = y + ti * batch_size * y_stride;
 
         // sgemm for recurrence weight
-        // weights: [4*hidden_size, hidden_size]
+        // weights: [4*hidden_pad, hidden_size]
         // inputs: [batch, hidden_size]
-        K = hidden_size;
-        N = batch_size;
-        M = 4 * hidden_size;
-        conv_sgemm_tn_col_major_prepack_a(M, N, K, r, K, h_t, K, gates_t, M,
+        conv_sgemm_tn_col_major_prepack_a(M, batch_size, hidden_size, r, hidden_size, h_t, hidden_size, gates_t, M,
                 nullptr, ActivationType_None, gemm_buf, conv_gemm_conf_);
 
-        // activation for h_t, c_t, output
-        X86LSTMActivate(gates_t, h_t, c_t, y_t, batch_size * hidden_size);
+        // bias and activation for h_t, c_t, output
+        ParallelFor(0, batch_size, [&](int i) {
+            activate_func(gates_t + i * M, b, h_t + i * hidden_size, c_t + i * hidden_size, y_t + i * y_stride,
+                          hidden_size);
+        });
     }
     return TNN_OK;
 }
@@ -135,6 +126,29 @@ Status X86LSTMONNXLayerAcc::Init(Context *context, LayerParam *param, LayerResou
     return TNN_OK;
 }
 
+Status X86LSTMONNXLayerAcc::Reshape(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
+    auto layer_param = dynamic_cast<LSTMONNXLayerParam *>(param_);
+    CHECK_PARAM_NULL(layer_param);
+    int num_directions = layer_param->direction >= 2 ? 2 : 1;
+
+    const auto input_dims = inputs[0]->GetBlobDesc().dims;
+    const int T = input_dims[0];
+    const int batch = input_dims[1];
+
+    int bias_size = ROUND_UP(T * batch, 8) * sizeof(float);
+    if (buffer_zero_bias_.GetBytesSize() < bias_size) {
+        buffer_zero_bias_ = RawBuffer(bias_size, 32);
+    }
+
+    // the state restarts from h_0 and c_0 once the batch changes
+    int state_size = 2 * num_directions * batch * layer_param->hidden_size * sizeof(float);
+    if (layer_param->streaming && buffer_state_.GetBytesSize() != state_size) {
+        buffer_state_      = RawBuffer(state_size);
+        state_initialized_ = false;
+    }
+    return TNN_OK;
+}
+
 Status X86LSTMONNXLayerAcc::allocateBufferWeight(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
     // weights for gates, [num_direction, 4 * hidden_size, input_size]
     auto w_dims = inputs[1]->GetBlobDesc().dims;
@@ -148,27 +162,29 @@ Status X86LSTMONNXLayerAcc::allocateBufferWeight(const std::vector<Blob *> &inpu
 
     int k_c = conv_gemm_conf_.K_c_;
     int m_block = conv_gemm_conf_.m_block_;
+    int hidden_size = w_dims[1] / 4;
+    hidden_pad_ = ROUND_UP(hidden_size, kGateBlock);
+
     // gate weights
     int K = w_dims[2];
-    int M = w_dims[1];
-    size_t w_pack_size = ROUND_UP(K, k_c) * ROUND_UP(M, m_block);
+    int M = 4 * hidden_pad_;
+    w_pack_size_ = ROUND_UP(K, k_c) * ROUND_UP(M, m_block);
     // align pointer of packed weights, since gemm use aligned load for input A
-    RawBuffer w_temp_buffer(w_dims[0] * w_pack_size * sizeof(float), 32);
-    
-    // before conv_pack, trans from 4 * hidden_size to hidden_size * 4
-    size_t trans_size = MAX(w_direction_size, r_direction_size);
+    RawBuffer w_temp_buffer(w_dims[0] * w_pack_size_ * sizeof(float), 32);
+
+    // before conv_pack, trans from 4 * hidden_size to blocks of [4 x 8], padded rows are zero
+    size_t trans_size = 4 * hidden_pad_ * MAX(w_dims[2], r_dims[2]);
     RawBuffer trans_buf(trans_size * sizeof(float));
-    int hidden_size = w_dims[1] / 4;
     float *trans_ptr = trans_buf.force_to<float *>();
 
     for (int d = 0; d < w_dims[0]; d++) {
         float *w_src = w_ptr + d * w_direction_size;
-        float *w_dst = w_temp_buffer.force_to<float *>() + d * w_pack_size;
+        float *w_dst = w_temp_buffer.force_to<float *>() + d * w_pack_size_;
 
         // transpose
         for (int i = 0; i < 4; i++) {
             for (int j = 0; j < hidden_size; j++) {
-                auto trans_dst = trans_ptr + j * 4 * w_dims[2] + i * w_dims[2];
+                auto trans_dst = trans_ptr + X86LSTMGateIndex(i, j) * w_dims[2];
                 auto trans_src = w_src + i * hidden_size * w_dims[2] + j * w_dims[2];
                 memcpy(trans_dst, trans_src, w_dims[2] * sizeof(float));
             }
@@ -179,17 +195,17 @@ Status X86LSTMONNXLayerAcc::allocateBufferWeight(const std::vector<Blob *> &inpu
 
     // recurrence weights
     K = r_dims[2];
-    M = r_dims[1];
-    size_t r_pack_size = ROUND_UP(K, k_c) * ROUND_UP(M, m_block);
-    RawBuffer r_temp_buffer(r_dims[0] * r_pack_size * sizeof(float), 32);
+    r_pack_size_ = ROUND_UP(K, k_c) * ROUND_UP(M, m_block);
+    RawBuffer r_temp_buffer(r_dims[0] * r_pack_size_ * sizeof(float), 32);
+    memset(trans_ptr, 0, trans_size * sizeof(float));
     for (int d = 0; d < r_dims[0]; d++) {
         float *r_src = r_ptr + d * r_direction_size;
-        float *r_dst = r_temp_buffer.force_to<float *>() + d * r_pack_size;
+        float *r_dst = r_temp_buffer.force_to<float *>() + d * r_pack_size_;
 
         // transpose
         for (int i = 0; i < 4; i++) {
             for (int j = 0; j < hidden_size; j++) {
-                auto trans_dst = trans_ptr + j * 4 * r_dims[2] + i * r_dims[2];
+                auto trans_dst = trans_ptr + X86LSTMGateIndex(i, j) * r_dims[2];
                 auto trans_src = r_src + i * hidden_size * r_dims[2] + j * r_dims[2];
                 memcpy(trans_dst, trans_src, r_dims[2] * sizeof(float));
             }
@@ -210,7 +226,7 @@ Status X86LSTMONNXLayerAcc::allocateBufferBias(const std::vector<Blob *> &inputs
     // bias for gate and recurrence, [num_directions, 8*hidden_size]
     auto b_dims = inputs[3]->GetBlobDesc().dims;
     int hidden_size = b_dims[1] / 8;
-    int bias_size = hidden_size * 4;
+    int bias_size = hidden_pad_ * 4;
     RawBuffer b_temp_buffer(b_dims[0] * bias_size * sizeof(float));
 
     float *b_ptr = (float *)((char*)(inputs[3]->GetHandle().base) + inputs[3]->GetHandle().bytes_offset);
@@ -221,12 +237,11 @@ Status X86LSTMONNXLayerAcc::allocateBufferBias(const std::vector<Blob *> &inputs
         float *rb_d = b_d + 4 * hidden_size;
         float *b_dst = b_temp_buffer.force_to<float *>() + d * bias_size;
 
-        // add bias and transpose to hidden_size * 4
-        for (int i = 0; i < hidden_size; i++) {
-            b_dst[i * 4 + 0] = wb_d[i + 0 * hidden_size] + rb_d[i + 0 * hidden_size];
-            b_dst[i * 4 + 1] = wb_d[i + 1 * hidden_size] + rb_d[i + 1 * hidden_size];
-            b_dst[i * 4 + 2] = wb_d[i + 2 * hidden_size] + rb_d[i + 2 * hidden_size];
-            b_dst[i * 4 + 3] = wb_d[i + 3 * hidden_size] + rb_d[i + 3 * hidden_size];
+        // add bias and transpose to blocks of [4 x 8]
+        for (int i = 0; i < 4; i++) {
+            for (int j = 0; j < hidden_size; j++) {
+                b_dst[X86LSTMGateIndex(i, j)] = wb_d[i * hidden_size + j] + rb_d[i * hidden_size + j];
+            }
         }
     }
     b_temp_buffer.SetDataType(DATA_TYPE_FLOAT);
@@ -238,90 +253,104 @@ Status X86LSTMONNXLayerAcc::allocateBufferBias(const std::vector<Blob *> &inputs
 Status X86LSTMONNXLayerAcc::DoForward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
     auto layer_param = dynamic_cast<LSTMONNXLayerParam *>(param_);
     int num_directions = layer_param->direction >=2 ? 2 : 1;
-    
-    bool reverse = false;
+
     if (inputs.size() < 4) {
         return Status(TNNERR_LAYER_ERR, "LSTM has invalid inputs");
     }
+    if (layer_param->direction < 0 || layer_param->direction > 2) {
+        return Status(TNNERR_PARAM_ERR, "LSTMONNX has invalid direction param");
+    }
     Blob * blob_h0 = nullptr;
     Blob * blob_c0 = nullptr;
-    
+
     if (inputs.size() >= 6) {
         blob_h0 = inputs[4];
         blob_c0 = inputs[5];
     }
-    
+
     const auto input_dims = inputs[0]->GetBlobDesc().dims;
     const auto T = input_dims[0]; // length of sequence
     const auto batch = input_dims[1];  // batch_size
     const auto input_size = DimsVectorUtils::Count(input_dims, 2); // input dimension
-    const auto output_dims = outputs[0]->GetBlobDesc().dims;
     const auto hidden_size = layer_param->hidden_size; // output dimension
     // block size for gemm
     int k_c = conv_gemm_conf_.K_c_;
-    int m_block = conv_gemm_conf_.m_block_;
-    
+    int n_block = conv_gemm_conf_.n_block_;
+
     //X shape [sequence batch_size input_size]
     float *x = (float *)((char*)(inputs[0]->GetHandle().base) + inputs[0]->GetHandle().bytes_offset);
-    
+
     //Y shape [sequence batch_size num_directions *hidden_size]
     float *y = (float *)((char*)(outputs[0]->GetHandle().base) + outputs[0]->GetHandle().bytes_offset);
-    
-    //W[iofc], weight tensor for the gates, shape [num_directions, 4*hidden_size, input_size]
+
+    //W[iofc], weight tensor for the gates, packed per direction
     float *w = (float *)buffer_w_.force_to<float *>();
-    auto w_dims = inputs[1]->GetBlobDesc().dims;
-    size_t w_pack_size = ROUND_UP(w_dims[2], k_c) * ROUND_UP(w_dims[1], m_block);
 
-    //R[iofc], recurrence weight tensor, shape [num_directions, 4*hidden_size, hidden_size]
+    //R[iofc], recurrence weight tensor, packed per direction
     float *r = (float *)buffer_r_.force_to<float *>();
-    auto r_dims = inputs[2]->GetBlobDesc().dims;
-    size_t r_pack_size = ROUND_UP(r_dims[2], k_c) * ROUND_UP(r_dims[1], m_block);
-    
-    //B[iofc] Concatenation of [Wb[iofc], Rb[iofc]], [num_directions, 8*hidden_size]
+
+    //B[iofc] sum of Wb[iofc] and Rb[iofc], [num_directions, 4*hidden_pad]
     float *b = (float *)buffer_b_.force_to<float *>();
-    
+
     //initial_h, initial value of the hidden, If not specified - assumed to be 0. shape [num_directions, batch_size, hidden_size]
     auto h_t = (float *)((char*)(outputs[1]->GetHandle().base) + outputs[1]->GetHandle().bytes_offset);
     //initial_c, initial value of the cell, If not specified - assumed to be 0. shape [num_directions, batch_size, hidden_size]
     auto c_t = (float *)((char*)(outputs[2]->GetHandle().base) + outputs[2]->GetHandle().bytes_offset);
 
-    if (inputs.size() >= 6) {
-        auto h_0 = (float *)((char*)(blob_h0->GetHandle().base) + blob_h0->GetHandle().bytes_offset);
-        auto c_0 = (float *)((char*)(blob_c0->GetHandle().base) + blob_c0->GetHandle().bytes_offset);
-        memcpy((void *)h_t, h_0, num_directions * batch * hidden_size * sizeof(float));
-        memcpy((void *)c_t, c_0, num_directions * batch * hidden_size * sizeof(float));
-    } else {
-        memset((void *)h_t, 0, num_directions * batch * hidden_size * sizeof(float));
-        memset((void *)c_t, 0, num_directions * batch * hidden_size * sizeof(float));
+    // in streaming mode the state lives in the acc, output blobs may be reused by other layers
+    const size_t state_bytes = num_directions * batch * hidden_size * sizeof(float);
+    float *state_h = h_t;
+    float *state_c = c_t;
+    if (layer_param->streaming) {
+        state_h = buffer_state_.force_to<float *>();
+        state_c = state_h + num_directions * batch * hidden_size;
     }
-    
-    if (layer_param->direction == 0 || layer_param->direction == 1) {
-        return LSTMOneDirection(x, y, w, r, b, h_t, c_t, T, batch, input_size, hidden_size, layer_param->direction);
-    } else if (layer_param->direction == 2) {
-        //Y shape [num_directions sequence batch_size hidden_size]
-        auto y_temp = std::shared_ptr<float>(new float[num_directions*T*batch*hidden_size], [](float* p) { delete[] p; });
-        auto y0 = y_temp.get();
-        auto y1 = y0 + T * batch * hidden_size;
-        LSTMOneDirection(x, y0, w, r, b, h_t, c_t, T, batch, input_size, hidden_size, 0);
-        
-        auto w1 = w + w_pack_size;
-        auto r1 = r + r_pack_size;
-        auto b1 = b + 4 * hidden_size;
-        auto h_t1 = h_t + batch * hidden_size;
-        auto c_t1 = c_t + batch * hidden_size;
-        LSTMOneDirection(x, y1, w1, r1, b1, h_t1, c_t1, T, batch, input_size, hidden_size, 1);
-        
-        //transpose [num_directions sequence batch_size hidden_size] to [sequence batch_size num_directions*hidden_size]
-        for (int i = 0; i < T*batch; i++) {
-            auto y0_data = y0 + i * hidden_size;
-            auto y1_data = y1 + i * hidden_size;
-            auto y_data = y + i * num_directions * hidden_size;
-
-            memcpy(y_data, y0_data, hidden_size * sizeof(float));
-            memcpy(y_data + hidden_size, y1_data, hidden_size * sizeof(float));
+
+    if (!layer_param->streaming || !state_initialized_) {
+        if (inputs.size() >= 6) {
+            auto h_0 = (float *)((char*)(blob_h0->GetHandle().base) + blob_h0->GetHandle().bytes_offset);
+            auto c_0 = (float *)((char*)(blob_c0->GetHandle().base) + blob_c0->GetHandle().bytes_offset);
+            memcpy((void *)state_h, h_0, state_bytes);
+            memcpy((void *)state_c, c_0, state_bytes);
+        } else {
+            memset((void *)state_h, 0, state_bytes);
+            memset((void *)state_c, 0, state_bytes);
         }
+        state_initialized_ = true;
+    }
+
+    // two temp buf per direction: gemm_buf and gates_buf
+    int N = T * batch;
+    int M = 4 * hidden_pad_;
+    size_t gemm_buf_size  = ROUND_UP(k_c * ROUND_UP(N, n_block), 8);
+    size_t gates_buf_size = ROUND_UP(N * M, 8);
+    size_t direction_size = gemm_buf_size + gates_buf_size;
+    float *workspace = reinterpret_cast<float *>(
+        context_->GetSharedWorkSpace(num_directions * direction_size * sizeof(float)));
+
+    //Y of both directions are written in place, [sequence batch_size num_directions*hidden_size]
+    auto lstm_direction = [&](int d) {
+        int reverse  = layer_param->direction == 2 ? d : layer_param->direction;
+        float *buf   = workspace + d * direction_size;
+        LSTMOneDirection(x, y + d * hidden_size, w + d * w_pack_size_, r + d * r_pack_size_, b + d * M,
+                         state_h + d * batch * hidden_size, state_c + d * batch * hidden_size, T, batch,
+                         input_size, hidden_size, num_directions * hidden_size, reverse, buf, buf + gemm_buf_size);
+    };
+
+    // small steps can not keep threads busy, run the directions on separate threads instead
+    bool parallel_directions = num_directions == 2 &&
+        (GetParallelMaxThreads() <= 2 || (size_t)batch * M * hidden_size < kSmallStepSize);
+    if (parallel_directions) {
+        ParallelFor(0, num_directions, lstm_direction);
     } else {
-        return Status(TNNERR_PARAM_ERR, "LSTMONNX has invalid direction param");
+        for (int d = 0; d < num_directions; d++) {
+            lstm_direction(d);
+        }
+    }
+
+    if (layer_param->streaming) {
+        memcpy((void *)h_t, state_h, state_bytes);
+        memcpy((void *)c_t, state_c, state_bytes);
     }
 
     return TNN_OK;
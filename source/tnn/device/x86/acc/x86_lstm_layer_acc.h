@@ -26,18 +26,30 @@ public:
 
     Status Init(Context *context, LayerParam *param, LayerResource *resource, const std::vector<Blob *> &inputs,
                 const std::vector<Blob *> &outputs) override;
+    virtual Status Reshape(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) override;
     virtual Status DoForward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) override;
     virtual Status allocateBufferWeight(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs);
     virtual Status allocateBufferBias(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs);
 protected:
     Status LSTMOneDirection(const float *x, float *y, const float *w, const float *r,
                            const float *b, float *h_t, float *c_t, int seq_len, int batch_size,
-                           int input_size, int hidden_size, int reverse);
+                           int input_size, int hidden_size, int y_stride, int reverse,
+                           float *gemm_buf, float *gates_buf);
 
+    // gates of every 8 hidden units are packed as [i, o, f, c] x 8, hidden size is padded to 8
     RawBuffer buffer_w_;
     RawBuffer buffer_r_;
     RawBuffer buffer_b_;
+    size_t w_pack_size_ = 0;
+    size_t r_pack_size_ = 0;
+    int hidden_pad_     = 0;
     conv_gemm_config<float, float, float> conv_gemm_conf_;
+
+    // zero bias of the gemm of the input weights
+    RawBuffer buffer_zero_bias_;
+    // h_t and c_t carried across forwards in streaming mode
+    RawBuffer buffer_state_;
+    bool state_initialized_ = false;
 };
 
 }  // namespace TNN_NS
@@ -15,10 +15,47 @@
 #include "tnn/device/x86/acc/x86_layer_acc.h"
 #include "tnn/utils/dims_vector_utils.h"
 #include "tnn/device/x86/acc/x86_mat_mul_layer_acc.h"
+#include "tnn/core/packed_weight_cache.h"
 #include "tnn/interpreter/layer_resource_generator.h"
+#include "tnn/utils/parallel_for.h"
+#include "tnn/utils/string_utils_inner.h"
 
 namespace TNN_NS {
 
+// gemms of fewer MACs run one per thread when there are several of them
+static const size_t kSmallGemmSize = 1 << 20;
+
+struct X86MatMulDims {
+    int M       = 0;
+    int N       = 0;
+    int K       = 0;
+    int batch_a = 1;
+    int batch_b = 1;
+    int batch_c = 1;
+};
+
+// row major A[N * K] * B[K * M] = C[N * M]
+static X86MatMulDims GetMatMulDims(MatMulLayerParam *param, Blob *output) {
+    DimsVector matrix_a_dims = param->matrix_a_dims;
+    DimsVector matrix_b_dims = param->matrix_b_dims;
+    if (matrix_a_dims.size() == 1) {
+        matrix_a_dims.insert(matrix_a_dims.begin(), 1);
+    }
+    if (matrix_b_dims.size() == 1) {
+        matrix_b_dims.push_back(1);
+    }
+    auto matrix_c_dims = output->GetBlobDesc().dims;
+
+    X86MatMulDims dims;
+    dims.M       = matrix_b_dims[matrix_b_dims.size() - 1];
+    dims.K       = matrix_a_dims[matrix_a_dims.size() - 1];
+    dims.N       = matrix_a_dims[matrix_a_dims.size() - 2];
+    dims.batch_a = DimsVectorUtils::Count(matrix_a_dims) / (dims.K * dims.N);
+    dims.batch_b = DimsVectorUtils::Count(matrix_b_dims) / (dims.M * dims.K);
+    dims.batch_c = DimsVectorUtils::Count(matrix_c_dims) / (dims.M * dims.N);
+    return dims;
+}
+
 X86MatMulLayerAcc::~X86MatMulLayerAcc() {}
 
 Status X86MatMulLayerAcc::Init(Context *context, LayerParam *param, LayerResource *resource,
@@ -43,70 +80,143 @@ Status X86MatMulLayerAcc::Init(Context *context, LayerParam *param, LayerResourc
     }
 
     RETURN_ON_NEQ(ret, TNN_OK);
+    return allocateBufferWeight(inputs, outputs);
+}
+
+Status X86MatMulLayerAcc::allocateBufferWeight(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
+    auto param = dynamic_cast<MatMulLayerParam *>(param_);
+    CHECK_PARAM_NULL(param);
+    auto res = dynamic_cast<MatMulLayerResource *>(resource_);
+    CHECK_PARAM_NULL(res);
+
+    if (res->weight.GetDataType() != DATA_TYPE_FLOAT) {
+        LOGE("Error: DataType %d not support\n", res->weight.GetDataType());
+        return Status(TNNERR_MODEL_ERR, "matmul weight DataType is not supported");
+    }
+
+    auto dims   = GetMatMulDims(param, outputs[0]);
+    int k_c     = conv_gemm_conf_.K_c_;
+    int m_block = conv_gemm_conf_.m_block_;
+    int n_block = conv_gemm_conf_.n_block_;
+
+    // weight A is the col major B of the gemm, weight B is the col major A
+    int batch_w = dims.batch_a;
+    std::string variant;
+    if (param->weight_position == 0) {
+        weight_pack_size_ = ROUND_UP(dims.K, k_c) * ROUND_UP(dims.N, n_block);
+        variant           = "matmul_a_" + ToString(k_c) + "_" + ToString(n_block);
+    } else {
+        weight_pack_size_ = ROUND_UP(dims.K, k_c) * ROUND_UP(dims.M, m_block);
+        batch_w           = dims.batch_b;
+        variant           = "matmul_b_" + ToString(k_c) + "_" + ToString(m_block);
+    }
+
+    const float *src = res->weight.force_to<float *>();
+    auto key         = PackedWeightCache::CreateKey(context_, param_, DEVICE_X86, variant, res->weight);
+    return PackedWeightCache::GetOrPack(key, [&](RawBuffer &packed) -> Status {
+        // align pointer of packed weights, since gemm use aligned load for the packed panels
+        RawBuffer temp_buffer(weight_pack_size_ * batch_w * sizeof(float), 32);
+        float *dst = temp_buffer.force_to<float *>();
+        for (int b = 0; b < batch_w; b++) {
+            if (param->weight_position == 0) {
+                conv_pack_col_b_n(dims.N, dims.K, src + b * dims.N * dims.K, dims.K,
+                                  dst + b * weight_pack_size_, conv_gemm_conf_);
+            } else {
+                conv_pack_col_a_n(dims.M, dims.K, src + b * dims.M * dims.K, dims.M,
+                                  dst + b * weight_pack_size_, conv_gemm_conf_);
+            }
+        }
+        temp_buffer.SetDataType(DATA_TYPE_FLOAT);
+        packed = temp_buffer;
+        return TNN_OK;
+    }, buffer_weight_);
+}
+
+Status X86MatMulLayerAcc::Reshape(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
+    auto param = dynamic_cast<MatMulLayerParam *>(param_);
+    CHECK_PARAM_NULL(param);
+
+    auto dims = GetMatMulDims(param, outputs[0]);
+    int bias_size = ROUND_UP(dims.N, 8) * sizeof(float);
+    if (buffer_zero_bias_.GetBytesSize() < bias_size) {
+        buffer_zero_bias_ = RawBuffer(bias_size, 32);
+    }
     return TNN_OK;
 }
 
 Status X86MatMulLayerAcc::DoForward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
-    auto param               = dynamic_cast<MatMulLayerParam *>(param_);
-    auto resource            = dynamic_cast<MatMulLayerResource *>(resource_);
-    DimsVector matrix_a_dims = param->matrix_a_dims;
-    DimsVector matrix_b_dims = param->matrix_b_dims;
-    if (matrix_a_dims.size() == 1) {
-        matrix_a_dims.insert(matrix_a_dims.begin(), 1);
+    auto param         = dynamic_cast<MatMulLayerParam *>(param_);
+    DataType data_type = inputs[0]->GetBlobDesc().data_type;
+    if (data_type != DATA_TYPE_FLOAT) {
+        return TNN_OK;
     }
-    if (matrix_b_dims.size() == 1) {
-        matrix_b_dims.push_back(1);
+
+    auto dims = GetMatMulDims(param, outputs[0]);
+    const int M = dims.M, N = dims.N, K = dims.K;
+
+    // constant operand is prepacked
+    const bool packed_a = inputs.size() == 1 && param->weight_position == 0;
+    const bool packed_b = inputs.size() == 1 && param->weight_position == 1;
+    float *matrix_a     = packed_a ? buffer_weight_.force_to<float *>() : handle_ptr<float *>(inputs[0]->GetHandle());
+    float *matrix_b     = packed_b ? buffer_weight_.force_to<float *>()
+                                   : handle_ptr<float *>(inputs[inputs.size() == 2 ? 1 : 0]->GetHandle());
+    auto matrix_c       = handle_ptr<float *>(outputs[0]->GetHandle());
+    float *bias         = buffer_zero_bias_.force_to<float *>();
+
+    // many small matrices, e.g. attention heads, run one gemm per thread
+    const int max_num_threads = GetParallelMaxThreads();
+    const bool batch_parallel = dims.batch_c > 1 && max_num_threads > 1 &&
+                                (UP_DIV(M, conv_gemm_conf_.M_c_) < max_num_threads || (size_t)M * N * K < kSmallGemmSize);
+    if (!batch_parallel) {
+        conv_ajust_m_blk_size(max_num_threads, M, conv_gemm_conf_.M_c_);
     }
-    DataType data_type       = inputs[0]->GetBlobDesc().data_type;
-    auto matrix_c_dims       = outputs[0]->GetBlobDesc().dims;
-    if (data_type == DATA_TYPE_FLOAT) {
-        float *matrix_a;
-        float *matrix_b;
-
-        if (inputs.size() == 2) {
-            matrix_a = handle_ptr<float *>(inputs[0]->GetHandle());
-            matrix_b = handle_ptr<float *>(inputs[1]->GetHandle());
+
+    int k_c     = conv_gemm_conf_.K_c_;
+    int m_c     = conv_gemm_conf_.M_c_;
+    int n_block = conv_gemm_conf_.n_block_;
+
+    // per thread: panel of A for the gemm kernels, then panel of B of one K block
+    size_t trans_size   = ROUND_UP(m_c * k_c, 8);
+    size_t panel_size   = ROUND_UP(k_c * ROUND_UP(N, n_block), 8);
+    size_t pack_all_size = ROUND_UP(K, k_c) * ROUND_UP(N, n_block);
+    size_t workspace_size = batch_parallel ? max_num_threads * (trans_size + panel_size)
+                                           : max_num_threads * trans_size + std::max(panel_size, pack_all_size);
+    float *workspace = reinterpret_cast<float *>(context_->GetSharedWorkSpace(workspace_size * sizeof(float)));
+
+    // row major A[N * K] * B[K * M] = C[N * M]
+    // equals to
+    // col major B[M * K] * A[K * N] = C[M * N]
+    auto gemm = [&](int bc, float *trans_buf, float *panel_buf) {
+        int ba     = bc < dims.batch_a ? bc : 0;
+        int bb     = bc < dims.batch_b ? bc : 0;
+        auto c_ptr = matrix_c + bc * M * N;
+        if (packed_a) {
+            conv_sgemm_nn_col_major_prepack_b(M, N, K, matrix_b + bb * M * K, M, matrix_a + ba * weight_pack_size_, K,
+                                              c_ptr, M, bias, ActivationType_None, trans_buf, conv_gemm_conf_);
+        } else if (packed_b) {
+            conv_sgemm_tn_col_major_prepack_a(M, N, K, matrix_b + bb * weight_pack_size_, K, matrix_a + ba * K * N, K,
+                                              c_ptr, M, bias, ActivationType_None, panel_buf, conv_gemm_conf_);
+        } else if (batch_parallel) {
+            // trans_buf and panel_buf are contiguous, as the pack buffer of the gemm wants
+            conv_sgemm_nn_col_major(M, N, K, matrix_b + bb * M * K, M, matrix_a + ba * K * N, K, c_ptr, M, bias,
+                                    ActivationType_None, trans_buf, conv_gemm_conf_);
         } else {
-            auto weight = resource->weight.force_to<float *>();
-            matrix_a    = param->weight_position == 0 ? weight : handle_ptr<float *>(inputs[0]->GetHandle());
-            matrix_b    = param->weight_position == 1 ? weight : handle_ptr<float *>(inputs[0]->GetHandle());
+            // pack the whole A once, then the gemm runs in parallel over M
+            conv_pack_col_b_n(N, K, matrix_a + ba * K * N, K, panel_buf, conv_gemm_conf_);
+            conv_sgemm_nn_col_major_prepack_b(M, N, K, matrix_b + bb * M * K, M, panel_buf, K, c_ptr, M, bias,
+                                              ActivationType_None, trans_buf, conv_gemm_conf_);
         }
-        auto matrix_c = handle_ptr<float *>(outputs[0]->GetHandle());
-
-        int k_c = conv_gemm_conf_.K_c_;
-        int m_c = conv_gemm_conf_.M_c_;
-        int n_block = conv_gemm_conf_.n_block_;
-
-        int M = matrix_b_dims[matrix_b_dims.size() - 1];
-        int K = matrix_a_dims[matrix_a_dims.size() - 1];
-        int N = matrix_a_dims[matrix_a_dims.size() - 2];
-
-        size_t pack_a_size = ROUND_UP(m_c * k_c * sizeof(float), 32);
-        size_t pack_b_size = k_c * ROUND_UP(N, n_block) * sizeof(float);
-        size_t workspace_size = pack_a_size + pack_b_size;
-        float *workspace = reinterpret_cast<float *>(context_->GetSharedWorkSpace(workspace_size));
-
-        RawBuffer fake_bias(N * sizeof(float));
-        float *fake_bias_ptr = fake_bias.force_to<float *>();
-
-        int count_a     = DimsVectorUtils::Count(matrix_a_dims);
-        int count_b     = DimsVectorUtils::Count(matrix_b_dims);
-        int count_c     = DimsVectorUtils::Count(matrix_c_dims);
-        int batch_a   = count_a / (K * N);
-        int batch_b   = count_b / (M * K);
-        int batch_c   = count_c / (M * N);
-        for (int bc = 0; bc < batch_c; ++bc) {
-            int ba = bc < batch_a ? bc : 0;
-            int bb = bc < batch_b ? bc : 0;
-            auto a_ptr = matrix_a + ba * K * N;
-            auto b_ptr = matrix_b + bb * M * K;
-            auto c_ptr = matrix_c + bc * M * N;
-
-            // row major A[N * K] * B[K * M] = C[N * M]
-            // equals to
-            // col major B[M * K] * A[K * N] = C[M * N]
-            conv_sgemm_nn_col_major(M, N, K, b_ptr, M, a_ptr, K, c_ptr, M,
-                fake_bias_ptr, ActivationType_None, workspace, conv_gemm_conf_);
+    };
+
+    if (batch_parallel) {
+        // nested loops of the gemm run on the calling thread with thread id 0
+        ParallelForWithThreadId(0, dims.batch_c, [&](int bc, int thread_id) {
+            float *trans_buf = workspace + thread_id * (trans_size + panel_size);
+            gemm(bc, trans_buf, trans_buf + trans_size);
+        });
+    } else {
+        for (int bc = 0; bc < dims.batch_c; ++bc) {
+            gemm(bc, workspace, workspace + max_num_threads * trans_size);
         }
     }
 
@@ -26,12 +26,22 @@ public:
     Status Init(Context *context, LayerParam *param, LayerResource *resource, const std::vector<Blob *> &inputs,
                 const std::vector<Blob *> &outputs) override;
 
+    virtual Status Reshape(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) override;
+
     virtual Status DoForward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) override;
 
 protected:
+    // pack the constant operand into the panel layout of the gemm
+    Status allocateBufferWeight(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs);
+
     conv_gemm_config<float, float, float> conv_gemm_conf_;
     std::shared_ptr<LayerResource> matmul_acc_f32_resource_ = nullptr;
 
+    // packed constant operand, one panel set per batch of the weight
+    RawBuffer buffer_weight_;
+    size_t weight_pack_size_ = 0;
+    // zero bias of the gemm, sized in Reshape
+    RawBuffer buffer_zero_bias_;
 };
 
 }  // namespace TNN_NS
@@ -0,0 +1,193 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <algorithm>
+#include <cfloat>
+
+#include "tnn/device/x86/acc/Float4.h"
+#include "tnn/device/x86/acc/Float8.h"
+#include "tnn/device/x86/acc/x86_layer_acc.h"
+#include "tnn/utils/dims_utils.h"
+#include "tnn/utils/parallel_for.h"
+
+namespace TNN_NS {
+
+DECLARE_X86_ACC(NonMaxSuppression, LAYER_NON_MAX_SUPPRESSION);
+
+// corners and areas of the boxes of one batch, stored as x_min, y_min, x_max, y_max, area planes
+static void nms_box_planes(const float *boxes, int num_boxes, int center_point_box, float *planes) {
+    float *x_min = planes;
+    float *y_min = planes + num_boxes;
+    float *x_max = planes + 2 * num_boxes;
+    float *y_max = planes + 3 * num_boxes;
+    float *area  = planes + 4 * num_boxes;
+    for (int i = 0; i < num_boxes; i++) {
+        const float *box = boxes + i * 4;
+        if (0 == center_point_box) {
+            // boxes data format [y1, x1, y2, x2]
+            x_min[i] = std::min(box[1], box[3]);
+            x_max[i] = std::max(box[1], box[3]);
+            y_min[i] = std::min(box[0], box[2]);
+            y_max[i] = std::max(box[0], box[2]);
+        } else {
+            // boxes data format [x_center, y_center, width, height]
+            float width_half  = box[2] / 2;
+            float height_half = box[3] / 2;
+            x_min[i]          = box[0] - width_half;
+            x_max[i]          = box[0] + width_half;
+            y_min[i]          = box[1] - height_half;
+            y_max[i]          = box[1] + height_half;
+        }
+        area[i] = (x_max[i] - x_min[i]) * (y_max[i] - y_min[i]);
+    }
+}
+
+// check the box against the selected boxes pack by pack, selected boxes are padded with empty ones
+template <typename VEC, int pack>
+static bool nms_suppress_func(const float *box, const float *selected, int selected_stride, int num_selected,
+                              float iou_threshold) {
+    if (box[4] <= 0.f) {
+        return false;
+    }
+    VEC x_min(box[0]), y_min(box[1]), x_max(box[2]), y_max(box[3]), area(box[4]);
+    VEC zero(0.f), invalid(-FLT_MAX), threshold(iou_threshold);
+    float iou_buf[pack];
+    for (int i = 0; i < num_selected; i += pack) {
+        VEC w     = VEC::min(x_max, VEC::loadu(selected + 2 * selected_stride + i)) -
+                    VEC::max(x_min, VEC::loadu(selected + i));
+        VEC h     = VEC::min(y_max, VEC::loadu(selected + 3 * selected_stride + i)) -
+                    VEC::max(y_min, VEC::loadu(selected + selected_stride + i));
+        VEC inter = w * h;
+        VEC sel_area = VEC::loadu(selected + 4 * selected_stride + i);
+        VEC uni      = area + sel_area - inter;
+        VEC iou      = VEC::div(inter, VEC::max(uni, VEC(FLT_MIN)));
+        iou          = VEC::bsl_cgt(w, zero, iou, invalid);
+        iou          = VEC::bsl_cgt(h, zero, iou, invalid);
+        iou          = VEC::bsl_cgt(sel_area, zero, iou, invalid);
+        iou          = VEC::bsl_cgt(uni, zero, iou, invalid);
+        iou          = VEC::bsl_cgt(iou, threshold, VEC(1.f), zero);
+        VEC::saveu(iou_buf, iou);
+        for (int j = 0; j < pack; j++) {
+            if (iou_buf[j] != 0.f) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+Status X86NonMaxSuppressionLayerAcc::DoForward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
+    auto param = dynamic_cast<NonMaxSuppressionLayerParam *>(param_);
+    CHECK_PARAM_NULL(param);
+    if (inputs.size() < 2) {
+        return Status(TNNERR_LAYER_ERR, "NonMaxSuppression has invalid inputs");
+    }
+
+    Blob *output_blob = outputs[0];
+    auto boxes_dims   = inputs[0]->GetBlobDesc().dims;
+    auto scores_dims  = inputs[1]->GetBlobDesc().dims;
+    if (0 == param->max_output_boxes_per_class) {
+        output_blob->GetBlobDesc().dims = {0, 3};
+        return TNN_OK;
+    }
+
+    const int num_batches = boxes_dims[0];
+    const int num_boxes   = boxes_dims[1];
+    const int num_classes = scores_dims[1];
+    const int max_output  = (int)std::min<int64_t>(param->max_output_boxes_per_class, num_boxes);
+    // stride of the planes of the selected boxes
+    const int selected_stride = ROUND_UP(max_output, 8);
+
+    auto boxes_data  = handle_ptr<float *>(inputs[0]->GetHandle());
+    auto scores_data = handle_ptr<float *>(inputs[1]->GetHandle());
+
+    auto suppress_func = nms_suppress_func<Float8, 8>;
+    if (arch_ == sse42) {
+        suppress_func = nms_suppress_func<Float4, 4>;
+    }
+
+    const int threads    = GetParallelMaxThreads();
+    size_t planes_size   = (size_t)num_batches * num_boxes * 5;
+    size_t selected_size = (size_t)selected_stride * 5;
+    float *workspace     = reinterpret_cast<float *>(
+        context_->GetSharedWorkSpace((planes_size + threads * selected_size) * sizeof(float)));
+    float *planes = workspace;
+
+    ParallelFor(0, num_batches, [&](int b) {
+        nms_box_planes(boxes_data + b * num_boxes * 4, num_boxes, param->center_point_box,
+                       planes + b * num_boxes * 5);
+    });
+
+    // selected box indices of each batch and class
+    std::vector<std::vector<int>> selected_indices(num_batches * num_classes);
+    ParallelForWithThreadId(0, num_batches * num_classes, [&](int task, int thread_id) {
+        const int b            = task / num_classes;
+        const float *scores    = scores_data + task * num_boxes;
+        const float *planes_b  = planes + b * num_boxes * 5;
+        float *selected        = workspace + planes_size + thread_id * selected_size;
+        std::vector<int> &kept = selected_indices[task];
+
+        std::vector<std::pair<float, int>> candidates;
+        for (int i = 0; i < num_boxes; i++) {
+            if (scores[i] > param->score_threshold) {
+                candidates.emplace_back(scores[i], i);
+            }
+        }
+        // higher score first, the smaller index first for the same score
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const std::pair<float, int> &lhs, const std::pair<float, int> &rhs) {
+                      return lhs.first > rhs.first || (lhs.first == rhs.first && lhs.second < rhs.second);
+                  });
+
+        memset(selected, 0, selected_size * sizeof(float));
+        float box[5];
+        for (auto &candidate : candidates) {
+            if ((int)kept.size() >= max_output) {
+                break;
+            }
+            const int index = candidate.second;
+            for (int p = 0; p < 5; p++) {
+                box[p] = planes_b[p * num_boxes + index];
+            }
+            if (suppress_func(box, selected, selected_stride, (int)kept.size(), param->iou_threshold)) {
+                continue;
+            }
+            for (int p = 0; p < 5; p++) {
+                selected[p * selected_stride + kept.size()] = box[p];
+            }
+            kept.push_back(index);
+        }
+    });
+
+    int num_selected = 0;
+    for (auto &kept : selected_indices) {
+        num_selected += (int)kept.size();
+    }
+    output_blob->GetBlobDesc().dims = {num_selected, 3};
+    int *output_data                = handle_ptr<int *>(output_blob->GetHandle());
+    for (int task = 0; task < num_batches * num_classes; task++) {
+        for (auto index : selected_indices[task]) {
+            output_data[0] = task / num_classes;
+            output_data[1] = task % num_classes;
+            output_data[2] = index;
+            output_data += 3;
+        }
+    }
+
+    return TNN_OK;
+}
+
+REGISTER_X86_ACC(NonMaxSuppression, LAYER_NON_MAX_SUPPRESSION);
+
+}  // namespace TNN_NS
@@ -0,0 +1,180 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include "tnn/device/x86/acc/x86_layer_acc.h"
+#include "tnn/utils/dims_utils.h"
+#include "tnn/utils/parallel_for.h"
+
+namespace TNN_NS {
+
+DECLARE_X86_ACC(RoiAlign, LAYER_ROIALIGN);
+
+// bilinear sample of one point, shared by all channels of the roi
+struct X86RoiAlignSample {
+    int pos[4];
+    float w[4];
+};
+
+struct X86RoiAlignBins {
+    int grid_h = 1;
+    int grid_w = 1;
+    std::vector<X86RoiAlignSample> samples;
+};
+
+static void roialign_precalc(const float *roi, float spatial_scale, int height, int width, int pooled_height,
+                             int pooled_width, int sampling_ratio, X86RoiAlignBins &bins) {
+    // Do not using rounding; this implementation detail is critical
+    float roi_start_w = roi[0] * spatial_scale;
+    float roi_start_h = roi[1] * spatial_scale;
+    float roi_end_w   = roi[2] * spatial_scale;
+    float roi_end_h   = roi[3] * spatial_scale;
+
+    // Force malformed ROIs to be 1x1
+    float roi_width  = std::max(roi_end_w - roi_start_w, 1.f);
+    float roi_height = std::max(roi_end_h - roi_start_h, 1.f);
+    float bin_size_h = roi_height / static_cast<float>(pooled_height);
+    float bin_size_w = roi_width / static_cast<float>(pooled_width);
+
+    bins.grid_h = sampling_ratio > 0 ? sampling_ratio : static_cast<int>(std::ceil(roi_height / pooled_height));
+    bins.grid_w = sampling_ratio > 0 ? sampling_ratio : static_cast<int>(std::ceil(roi_width / pooled_width));
+    bins.samples.resize(bins.grid_h * bins.grid_w * pooled_width * pooled_height);
+
+    auto sample = bins.samples.data();
+    for (int ph = 0; ph < pooled_height; ph++) {
+        for (int pw = 0; pw < pooled_width; pw++) {
+            for (int iy = 0; iy < bins.grid_h; iy++) {
+                const float yy = roi_start_h + ph * bin_size_h +
+                                 static_cast<float>(iy + .5f) * bin_size_h / static_cast<float>(bins.grid_h);
+                for (int ix = 0; ix < bins.grid_w; ix++, sample++) {
+                    const float xx = roi_start_w + pw * bin_size_w +
+                                     static_cast<float>(ix + .5f) * bin_size_w / static_cast<float>(bins.grid_w);
+                    float x = xx;
+                    float y = yy;
+                    // inverse elements are out of feature map boundary
+                    if (y < -1.0 || y > height || x < -1.0 || x > width) {
+                        memset(sample, 0, sizeof(X86RoiAlignSample));
+                        continue;
+                    }
+                    y = std::max(y, 0.f);
+                    x = std::max(x, 0.f);
+
+                    int y_low = static_cast<int>(y);
+                    int x_low = static_cast<int>(x);
+                    int y_high, x_high;
+                    if (y_low >= height - 1) {
+                        y_high = y_low = height - 1;
+                        y              = (float)y_low;
+                    } else {
+                        y_high = y_low + 1;
+                    }
+                    if (x_low >= width - 1) {
+                        x_high = x_low = width - 1;
+                        x              = (float)x_low;
+                    } else {
+                        x_high = x_low + 1;
+                    }
+
+                    float ly      = y - y_low;
+                    float lx      = x - x_low;
+                    float hy      = 1.f - ly;
+                    float hx      = 1.f - lx;
+                    sample->pos[0] = y_low * width + x_low;
+                    sample->pos[1] = y_low * width + x_high;
+                    sample->pos[2] = y_high * width + x_low;
+                    sample->pos[3] = y_high * width + x_high;
+                    sample->w[0]   = hy * hx;
+                    sample->w[1]   = hy * lx;
+                    sample->w[2]   = ly * hx;
+                    sample->w[3]   = ly * lx;
+                }
+            }
+        }
+    }
+}
+
+static void roialign_avg(const float *src, const X86RoiAlignBins &bins, int bin_count, float *dst) {
+    const int count = bins.grid_h * bins.grid_w;
+    auto sample     = bins.samples.data();
+    for (int i = 0; i < bin_count; i++) {
+        float val = 0.f;
+        for (int s = 0; s < count; s++, sample++) {
+            val += sample->w[0] * src[sample->pos[0]] + sample->w[1] * src[sample->pos[1]] +
+                   sample->w[2] * src[sample->pos[2]] + sample->w[3] * src[sample->pos[3]];
+        }
+        dst[i] = val / count;
+    }
+}
+
+static void roialign_max(const float *src, const X86RoiAlignBins &bins, int bin_count, float *dst) {
+    const int count = bins.grid_h * bins.grid_w;
+    auto sample     = bins.samples.data();
+    for (int i = 0; i < bin_count; i++) {
+        float val = -FLT_MAX;
+        for (int s = 0; s < count; s++, sample++) {
+            val = std::max(val, std::max(std::max(sample->w[0] * src[sample->pos[0]], sample->w[1] * src[sample->pos[1]]),
+                                         std::max(sample->w[2] * src[sample->pos[2]], sample->w[3] * src[sample->pos[3]])));
+        }
+        dst[i] = val;
+    }
+}
+
+Status X86RoiAlignLayerAcc::DoForward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
+    auto param = dynamic_cast<RoiAlignLayerParam *>(param_);
+    CHECK_PARAM_NULL(param);
+    if (inputs.size() < 3) {
+        return Status(TNNERR_LAYER_ERR, "RoiAlign has invalid inputs");
+    }
+
+    auto input_dims   = inputs[0]->GetBlobDesc().dims;
+    auto rois_dims    = inputs[1]->GetBlobDesc().dims;
+    auto output_dims  = outputs[0]->GetBlobDesc().dims;
+    const int num_rois      = inputs[2]->GetBlobDesc().dims[0];
+    const int channels      = output_dims[1];
+    const int pooled_height = output_dims[2];
+    const int pooled_width  = output_dims[3];
+    const int height        = input_dims[2];
+    const int width         = input_dims[3];
+    const int num_roi_cols  = rois_dims[1];
+    const int bin_count     = pooled_height * pooled_width;
+
+    auto input_ptr         = handle_ptr<float *>(inputs[0]->GetHandle());
+    auto rois_ptr          = handle_ptr<float *>(inputs[1]->GetHandle());
+    auto batch_indices_ptr = handle_ptr<int *>(inputs[2]->GetHandle());
+    auto output_ptr        = handle_ptr<float *>(outputs[0]->GetHandle());
+
+    // sample positions and weights only depend on the roi, share them among the channels
+    std::vector<X86RoiAlignBins> roi_bins(num_rois);
+    ParallelFor(0, num_rois, [&](int n) {
+        roialign_precalc(rois_ptr + n * num_roi_cols, param->spatial_scale, height, width, pooled_height,
+                         pooled_width, param->sampling_ratio, roi_bins[n]);
+    });
+
+    auto func = param->mode == 1 ? roialign_avg : roialign_max;
+    ParallelFor(0, num_rois * channels, [&](int task) {
+        const int n = task / channels;
+        const int c = task % channels;
+        const float *src = input_ptr + ((size_t)batch_indices_ptr[n] * channels + c) * height * width;
+        func(src, roi_bins[n], bin_count, output_ptr + (size_t)task * bin_count);
+    });
+
+    return TNN_OK;
+}
+
+REGISTER_X86_ACC(RoiAlign, LAYER_ROIALIGN);
+
+}  // namespace TNN_NS
@@ -20,7 +20,7 @@
 #include "tnn/device/x86/acc/Float8.h"
 #include "tnn/device/x86/acc/x86_layer_acc.h"
 #include "tnn/utils/dims_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 
@@ -55,10 +55,10 @@ void unary2_kernel_avx(std::vector<int> dims, const float *src, float *dst, Laye
     auto count = DimsVectorUtils::Count(dims);
     auto count_vec = count / 8 * 8;
 
-    OMP_PARALLEL_FOR_GUIDED_
-    for (int x = 0; x < count_vec; x += 8) {
+    ParallelFor(0, UP_DIV(count_vec, 8), [&](int x_i) {
+        int x = x_i * 8;
         Float8::saveu(dst + x, op(Float8::loadu(src + x)));
-    }
+    });
     for (int x = count_vec; x < count; x++) {
         dst[x] = op(src[x]);
     }
@@ -72,10 +72,10 @@ void unary2_kernel_sse(std::vector<int> dims, const float *src, float *dst, Laye
     auto count = DimsVectorUtils::Count(dims);
     auto count_vec = count / 4 * 4;
 
-    OMP_PARALLEL_FOR_GUIDED_
-    for (int x = 0; x < count_vec; x += 4) {
+    ParallelFor(0, UP_DIV(count_vec, 4), [&](int x_i) {
+        int x = x_i * 4;
         Float4::save(dst + x, op(Float4::load(src + x)));
-    }
+    });
     for (int x = count_vec; x < count; x++) {
         dst[x] = op(src[x]);
     }
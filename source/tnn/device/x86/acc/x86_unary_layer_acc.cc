@@ -15,7 +15,7 @@
 #include "tnn/device/x86/acc/x86_unary_layer_acc.h"
 #include "tnn/device/x86/x86_context.h"
 #include "tnn/utils/dims_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 using namespace x86;
@@ -38,10 +38,9 @@ Status X86UnaryLayerAcc::DoForward(const std::vector<Blob *> &inputs, const std:
     auto input_data  = handle_ptr<float*>(input->GetHandle());
     auto output_data = handle_ptr<float*>(output->GetHandle());
 
-    OMP_PARALLEL_FOR_GUIDED_
-    for (int n = 0; n < count; n++) {
+    ParallelFor(0, count, [&](int n) {
         output_data[n] = (*op_)(input_data[n]);
-    }
+    });
 
     return TNN_OK;
 }
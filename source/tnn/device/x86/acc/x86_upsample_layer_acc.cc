@@ -18,7 +18,7 @@
 #include "tnn/utils/data_type_utils.h"
 #include "tnn/utils/dims_utils.h"
 #include "tnn/utils/naive_compute.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 #include "tnn/device/x86/acc/compute/x86_compute_int8.h"
 
 namespace TNN_NS {
@@ -41,8 +41,7 @@ static inline int upsample_nearest2d(float *output_data, const float *input_data
     const float height_scale = (float)input_height / (float)output_height;
     const float width_scale  = (float)input_width / (float)output_width;
 
-    OMP_PARALLEL_FOR_
-    for (int i = 0; i < channels; ++i) {
+    ParallelFor(0, channels, [&](int i) {
         int output_index  = i * output_height * output_width;
         int input_index_i = i * input_height * input_width;
         for (int j = 0; j < output_height; ++j) {
@@ -53,7 +52,7 @@ static inline int upsample_nearest2d(float *output_data, const float *input_data
                 output_data[output_index++] = input_data[input_index_j + scaled_u];
             }
         }
-    }
+    });
 
     return 0;
 }
@@ -101,8 +100,7 @@ static inline int upsample_bilinear2d(float *output_data, const float *input_dat
 
     get_bilinear_coeffs(h_coeffs_ptr, w_coeffs_ptr, input_height, input_width, output_height, output_width, align_corners);
 
-    OMP_PARALLEL_FOR_
-    for (int h2 = 0; h2 < output_height; ++h2) {
+    ParallelFor(0, output_height, [&](int h2) {
         const float h1r      = h_coeffs_ptr[h2];
         const int h1         = h1r;
         const int h1p        = (h1 < input_height - 1) ? 1 : 0;
@@ -124,7 +122,7 @@ static inline int upsample_bilinear2d(float *output_data, const float *input_dat
                 Ydata += output_width * output_height;
             }
         }
-    }
+    });
 
     return 0;
 }
@@ -153,8 +151,7 @@ static void upsample_cubic2d_impl(float *dst, const float *src, int sh, int sw,
 #define Clip(x,X) ( (x) >=0 ? ((x)<(X)?(x):((X)-1)) : 0 )
 #define SrcValueAt(c, h, w) (src[c*sh*sw+(Clip(h,sh))*sw+(Clip(w,sw))])
 
-        OMP_PARALLEL_FOR_
-        for (int h2 = 0; h2 < dh; ++h2) {
+        ParallelFor(0, dh, [&](int h2) {
             float h1 = static_cast<float>(align_corners ? h_scale * h2 : h_scale * (h2 + 0.5) - 0.5);
             int hh = std::floor(h1);
             float wy[4];
@@ -181,7 +178,7 @@ static void upsample_cubic2d_impl(float *dst, const float *src, int sh, int sw,
                     dst[(c * dh + h2) * dw + w2] = sum;
                 }
             }
-        }
+        });
 #undef Clip
 #undef SrcValueAt
 }
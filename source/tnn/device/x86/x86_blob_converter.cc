@@ -15,6 +15,8 @@
 #include "tnn/core/macro.h"
 #include "tnn/core/blob_int8.h"
 #include "tnn/device/x86/x86_blob_converter.h"
+#include "tnn/device/x86/acc/compute/x86_blob_convert_float.h"
+#include "tnn/device/x86/acc/compute/x86_preprocess.h"
 #include "tnn/device/x86/x86_mat_util.h"
 #include "tnn/utils/data_format_converter.h"
 #include "tnn/utils/naive_compute.h"
@@ -53,6 +55,12 @@ Status X86BlobConverterAcc::GetBlobConvertFunc(MatType mat_type, DataType data_t
     return TNN_OK;
 }
 
+bool X86BlobConverterAcc::HasBlobConvertFunc(MatType mat_type, DataType data_type, BlobConvertDirection cvt_dir) {
+    const auto& cvt_map = GetBlobConvertFuncMap();
+    auto iter           = cvt_map.find(GetUniqueBlobConvertKey(mat_type, data_type, cvt_dir));
+    return iter != cvt_map.end() && iter->second != nullptr;
+}
+
 Status X86BlobConverterAcc::ConvertToMatAsync(Mat &image, MatConvertParam param, void *command_queue) {
     Status ret = TNN_OK;
     if (blob_ == nullptr) {
@@ -87,6 +95,14 @@ Status X86BlobConverterAcc::ConvertToMatAsync(Mat &image, MatConvertParam param,
         } else {
             return ret;
         }
+    } else if (desc.data_type == DATA_TYPE_FLOAT && desc.data_format == DATA_FORMAT_NCHW &&
+               HasBlobConvertFunc(image.GetMatType(), DATA_TYPE_FLOAT, CVT_DIR_BLOB2MAT)) {
+        auto dims = desc.dims;
+        auto hw   = DimsVectorUtils::Count(dims, 2);
+        auto c_r4 = ROUND_UP(DimsFunctionUtils::GetDim(dims, 1), 4);
+        RETURN_ON_NEQ(GetBlobConvertFunc(image.GetMatType(), DATA_TYPE_FLOAT, CVT_DIR_BLOB2MAT, cvt_func_), TNN_OK);
+        return cvt_func_(image, handle_ptr<char *>(blob_->GetHandle()), param, dims, hw, c_r4, fused_int8_scale,
+                         fused_int8_bias);
     } else {
         return DefaultBlobConverterAcc::ConvertToMatAsync(image, param, command_queue);
     }
@@ -130,6 +146,14 @@ Status X86BlobConverterAcc::ConvertFromMatAsync(Mat &image, MatConvertParam para
         } else {
             return ret;
         }
+    } else if (desc.data_type == DATA_TYPE_FLOAT && desc.data_format == DATA_FORMAT_NCHW &&
+               HasBlobConvertFunc(image.GetMatType(), DATA_TYPE_FLOAT, CVT_DIR_MAT2BLOB)) {
+        auto dims = desc.dims;
+        auto hw   = DimsVectorUtils::Count(dims, 2);
+        auto c_r4 = ROUND_UP(DimsFunctionUtils::GetDim(dims, 1), 4);
+        RETURN_ON_NEQ(GetBlobConvertFunc(image.GetMatType(), DATA_TYPE_FLOAT, CVT_DIR_MAT2BLOB, cvt_func_), TNN_OK);
+        return cvt_func_(image, handle_ptr<char *>(blob_->GetHandle()), param, dims, hw, c_r4, fused_int8_scale,
+                         fused_int8_bias);
     } else {
         return DefaultBlobConverterAcc::ConvertFromMatAsync(image, param, command_queue);
     }
@@ -211,20 +235,6 @@ static void GrayToBlob(const uint8_t *src, int8_t *dst, const float scale, const
     }
 }
 
-static Mat GetBGRFromYUV(Mat& image, const DimsVector& dims, const int hw, bool is_nv12) {
-    Mat bgr(DEVICE_X86, N8UC3, image.GetDims());
-    for (int n = 0; n < dims[0]; n++) {
-        if (is_nv12) {
-            NV12ToBGR(reinterpret_cast<uint8_t *>(image.GetData()) + n * 3 * hw / 2,
-                      reinterpret_cast<uint8_t *>(bgr.GetData()) + n * 3 * hw, dims[2], dims[3]);
-        } else {
-            NV21ToBGR(reinterpret_cast<uint8_t *>(image.GetData()) + n * 3 * hw / 2,
-                      reinterpret_cast<uint8_t *>(bgr.GetData()) + n * 3 * hw, dims[2], dims[3]);
-        }
-    }
-    return bgr;
-}
-
 static void NCHWToBlob(const float *src, int8_t *dst, int channel, int hw, float *scale) {
     int idx  = 0;
     int c_r4 = ROUND_UP(channel, 4);
@@ -273,20 +283,28 @@ static Status ConvertNGRAYToInt8Blob(Mat& image, char* handle_ptr,
     return TNN_OK;
 }
 
+// yuv is converted to bgr while packing, without a bgr copy of the whole image
+static Status ConvertYUVToInt8Blob(Mat& image, char* handle_ptr, const MatConvertParam& param, const DimsVector& dims,
+                                   std::vector<float>& fused_int8_scale, std::vector<float>& fused_int8_bias) {
+    CropParam crop;
+    crop.width  = image.GetWidth();
+    crop.height = image.GetHeight();
+    return X86Preprocess(image, crop, INTERP_TYPE_NEAREST, param.reverse_channel, fused_int8_scale.data(),
+                         fused_int8_bias.data(), DATA_TYPE_INT8, dims, handle_ptr);
+}
+
 static Status ConvertNNV12ToInt8Blob(Mat& image, char* handle_ptr,
                                      const MatConvertParam& param, const DimsVector& dims,
                                      const int hw, const int c_r4,
                                      std::vector<float>& fused_int8_scale, std::vector<float>& fused_int8_bias) {
-    Mat bgr = GetBGRFromYUV(image, dims, hw, true);
-    return ConvertN8UC3ToInt8Blob(bgr, handle_ptr, param, dims, hw, c_r4, fused_int8_scale, fused_int8_bias);
+    return ConvertYUVToInt8Blob(image, handle_ptr, param, dims, fused_int8_scale, fused_int8_bias);
 }
 
 static Status ConvertNNV21ToInt8Blob(Mat& image, char* handle_ptr,
                                      const MatConvertParam& param, const DimsVector& dims,
                                      const int hw, const int c_r4,
                                      std::vector<float>& fused_int8_scale, std::vector<float>& fused_int8_bias) {
-    Mat bgr = GetBGRFromYUV(image, dims, hw, false);
-    return ConvertN8UC3ToInt8Blob(bgr, handle_ptr, param, dims, hw, c_r4, fused_int8_scale, fused_int8_bias);
+    return ConvertYUVToInt8Blob(image, handle_ptr, param, dims, fused_int8_scale, fused_int8_bias);
 }
 
 static Status ConvertNCHWFloatToInt8Blob(Mat& image, char* handle_ptr,
@@ -425,4 +443,168 @@ REGISTER_X86_BLOB_CONVERT_FUNC(N8UC3,               DATA_TYPE_INT8,  CVT_DIR_BLO
 REGISTER_X86_BLOB_CONVERT_FUNC(NCHW_FLOAT,          DATA_TYPE_INT8,  CVT_DIR_BLOB2MAT, ConvertInt8BlobToNCHWFloat)
 REGISTER_X86_BLOB_CONVERT_FUNC(RESERVED_INT8_TEST,  DATA_TYPE_INT8,  CVT_DIR_BLOB2MAT, ConvertInt8BlobToInt8Mat)
 
+/*
+float blob converters, x86 float blobs are nchw
+*/
+// blob channel c maps to mat channel GetChannelMap()[c], reverse_channel swaps b and r
+static std::vector<int> GetChannelMap(int channel, bool reverse_channel) {
+    std::vector<int> channel_map(channel);
+    for (int c = 0; c < channel; ++c) {
+        channel_map[c] = (reverse_channel && channel >= 3 && c < 3) ? 2 - c : c;
+    }
+    return channel_map;
+}
+
+static Status CheckFloatBlobChannel(MatType mat_type, int channel, bool reverse_channel) {
+    bool match = (mat_type == N8UC4 && (channel == 3 || channel == 4)) || (mat_type == NGRAY && channel == 1) ||
+                 ((mat_type == N8UC3 || mat_type == NNV12 || mat_type == NNV21) && channel == 3);
+    if (!match) {
+        return Status(TNNERR_PARAM_ERR, "blob channel not match mat type: " + ToString(mat_type));
+    }
+    if (reverse_channel && mat_type == NGRAY) {
+        return Status(TNNERR_PARAM_ERR, "reverse type not support yet, mat type: " + ToString(mat_type));
+    }
+    return TNN_OK;
+}
+
+static Status ConvertImageToFloatBlob(Mat& image, char* handle_ptr, const MatConvertParam& param,
+                                      const DimsVector& dims, int mat_channel) {
+    const int channel = DimsFunctionUtils::GetDim(dims, 1);
+    RETURN_ON_NEQ(CheckFloatBlobChannel(image.GetMatType(), channel, param.reverse_channel), TNN_OK);
+    auto channel_map = GetChannelMap(channel, param.reverse_channel);
+    X86MatToFloatBlob(reinterpret_cast<uint8_t *>(image.GetData()), reinterpret_cast<float *>(handle_ptr), dims[0],
+                      DimsFunctionUtils::GetDim(dims, 2), DimsVectorUtils::Count(dims, 3), mat_channel, channel,
+                      channel_map.data(), param.scale.data(), param.bias.data());
+    return TNN_OK;
+}
+
+static Status ConvertFloatBlobToImage(Mat& image, char* handle_ptr, const MatConvertParam& param,
+                                      const DimsVector& dims, int mat_channel) {
+    const int channel = DimsFunctionUtils::GetDim(dims, 1);
+    RETURN_ON_NEQ(CheckFloatBlobChannel(image.GetMatType(), channel, param.reverse_channel), TNN_OK);
+    auto channel_map = GetChannelMap(channel, param.reverse_channel);
+    X86FloatBlobToMat(reinterpret_cast<float *>(handle_ptr), reinterpret_cast<uint8_t *>(image.GetData()), dims[0],
+                      DimsFunctionUtils::GetDim(dims, 2), DimsVectorUtils::Count(dims, 3), mat_channel, channel,
+                      channel_map.data(), param.scale.data(), param.bias.data());
+    return TNN_OK;
+}
+
+static Status ConvertN8UC4ToFloatBlob(Mat& image, char* handle_ptr,
+                                      const MatConvertParam& param, const DimsVector& dims,
+                                      const int hw, const int c_r4,
+                                      std::vector<float>& fused_int8_scale, std::vector<float>& fused_int8_bias) {
+    return ConvertImageToFloatBlob(image, handle_ptr, param, dims, 4);
+}
+
+static Status ConvertN8UC3ToFloatBlob(Mat& image, char* handle_ptr,
+                                      const MatConvertParam& param, const DimsVector& dims,
+                                      const int hw, const int c_r4,
+                                      std::vector<float>& fused_int8_scale, std::vector<float>& fused_int8_bias) {
+    return ConvertImageToFloatBlob(image, handle_ptr, param, dims, 3);
+}
+
+static Status ConvertNGRAYToFloatBlob(Mat& image, char* handle_ptr,
+                                      const MatConvertParam& param, const DimsVector& dims,
+                                      const int hw, const int c_r4,
+                                      std::vector<float>& fused_int8_scale, std::vector<float>& fused_int8_bias) {
+    return ConvertImageToFloatBlob(image, handle_ptr, param, dims, 1);
+}
+
+// yuv is converted to bgr while writing the blob, without a bgr copy of the whole image
+static Status ConvertYUVToFloatBlob(Mat& image, char* handle_ptr, const MatConvertParam& param,
+                                    const DimsVector& dims) {
+    RETURN_ON_NEQ(CheckFloatBlobChannel(image.GetMatType(), DimsFunctionUtils::GetDim(dims, 1),
+                                        param.reverse_channel), TNN_OK);
+    CropParam crop;
+    crop.width  = image.GetWidth();
+    crop.height = image.GetHeight();
+
+    // every batch of the mat is an image of its own, as in the default converter
+    const int hw          = image.GetHeight() * image.GetWidth();
+    DimsVector mat_dims   = image.GetDims();
+    DimsVector batch_dims = dims;
+    mat_dims[0]           = 1;
+    batch_dims[0]         = 1;
+    for (int n = 0; n < dims[0]; n++) {
+        Mat batch_image(image.GetDeviceType(), image.GetMatType(), mat_dims,
+                        reinterpret_cast<uint8_t *>(image.GetData()) + n * hw * 3 / 2);
+        RETURN_ON_NEQ(X86Preprocess(batch_image, crop, INTERP_TYPE_NEAREST, param.reverse_channel,
+                                    param.scale.data(), param.bias.data(), DATA_TYPE_FLOAT, batch_dims,
+                                    handle_ptr + n * DimsVectorUtils::Count(batch_dims) * sizeof(float)),
+                      TNN_OK);
+    }
+    return TNN_OK;
+}
+
+static Status ConvertNNV12ToFloatBlob(Mat& image, char* handle_ptr,
+                                      const MatConvertParam& param, const DimsVector& dims,
+                                      const int hw, const int c_r4,
+                                      std::vector<float>& fused_int8_scale, std::vector<float>& fused_int8_bias) {
+    return ConvertYUVToFloatBlob(image, handle_ptr, param, dims);
+}
+
+static Status ConvertNNV21ToFloatBlob(Mat& image, char* handle_ptr,
+                                      const MatConvertParam& param, const DimsVector& dims,
+                                      const int hw, const int c_r4,
+                                      std::vector<float>& fused_int8_scale, std::vector<float>& fused_int8_bias) {
+    return ConvertYUVToFloatBlob(image, handle_ptr, param, dims);
+}
+
+static Status ConvertNCHWFloatToFloatBlob(Mat& image, char* handle_ptr,
+                                          const MatConvertParam& param, const DimsVector& dims,
+                                          const int hw, const int c_r4,
+                                          std::vector<float>& fused_int8_scale, std::vector<float>& fused_int8_bias) {
+    if (param.reverse_channel) {
+        return Status(TNNERR_PARAM_ERR, "reverse type not support yet, mat type: " + ToString(image.GetMatType()));
+    }
+    X86NCHWFloatScaleBias(reinterpret_cast<float *>(image.GetData()), reinterpret_cast<float *>(handle_ptr), dims[0],
+                          DimsFunctionUtils::GetDim(dims, 1), hw, param.scale.data(), param.bias.data());
+    return TNN_OK;
+}
+
+REGISTER_X86_BLOB_CONVERT_FUNC(N8UC4,               DATA_TYPE_FLOAT, CVT_DIR_MAT2BLOB, ConvertN8UC4ToFloatBlob)
+REGISTER_X86_BLOB_CONVERT_FUNC(N8UC3,               DATA_TYPE_FLOAT, CVT_DIR_MAT2BLOB, ConvertN8UC3ToFloatBlob)
+REGISTER_X86_BLOB_CONVERT_FUNC(NGRAY,               DATA_TYPE_FLOAT, CVT_DIR_MAT2BLOB, ConvertNGRAYToFloatBlob)
+REGISTER_X86_BLOB_CONVERT_FUNC(NNV12,               DATA_TYPE_FLOAT, CVT_DIR_MAT2BLOB, ConvertNNV12ToFloatBlob)
+REGISTER_X86_BLOB_CONVERT_FUNC(NNV21,               DATA_TYPE_FLOAT, CVT_DIR_MAT2BLOB, ConvertNNV21ToFloatBlob)
+REGISTER_X86_BLOB_CONVERT_FUNC(NCHW_FLOAT,          DATA_TYPE_FLOAT, CVT_DIR_MAT2BLOB, ConvertNCHWFloatToFloatBlob)
+
+static Status ConvertFloatBlobToN8UC4(Mat& image, char* handle_ptr,
+                                      const MatConvertParam& param, const DimsVector& dims,
+                                      const int hw, const int c_r4,
+                                      std::vector<float>& fused_int8_scale, std::vector<float>& fused_int8_bias) {
+    return ConvertFloatBlobToImage(image, handle_ptr, param, dims, 4);
+}
+
+static Status ConvertFloatBlobToN8UC3(Mat& image, char* handle_ptr,
+                                      const MatConvertParam& param, const DimsVector& dims,
+                                      const int hw, const int c_r4,
+                                      std::vector<float>& fused_int8_scale, std::vector<float>& fused_int8_bias) {
+    return ConvertFloatBlobToImage(image, handle_ptr, param, dims, 3);
+}
+
+static Status ConvertFloatBlobToNGRAY(Mat& image, char* handle_ptr,
+                                      const MatConvertParam& param, const DimsVector& dims,
+                                      const int hw, const int c_r4,
+                                      std::vector<float>& fused_int8_scale, std::vector<float>& fused_int8_bias) {
+    return ConvertFloatBlobToImage(image, handle_ptr, param, dims, 1);
+}
+
+static Status ConvertFloatBlobToNCHWFloat(Mat& image, char* handle_ptr,
+                                          const MatConvertParam& param, const DimsVector& dims,
+                                          const int hw, const int c_r4,
+                                          std::vector<float>& fused_int8_scale, std::vector<float>& fused_int8_bias) {
+    if (param.reverse_channel) {
+        return Status(TNNERR_PARAM_ERR, "reverse type not support yet, mat type: " + ToString(image.GetMatType()));
+    }
+    X86NCHWFloatScaleBias(reinterpret_cast<float *>(handle_ptr), reinterpret_cast<float *>(image.GetData()), dims[0],
+                          DimsFunctionUtils::GetDim(dims, 1), hw, param.scale.data(), param.bias.data());
+    return TNN_OK;
+}
+
+REGISTER_X86_BLOB_CONVERT_FUNC(N8UC4,               DATA_TYPE_FLOAT, CVT_DIR_BLOB2MAT, ConvertFloatBlobToN8UC4)
+REGISTER_X86_BLOB_CONVERT_FUNC(N8UC3,               DATA_TYPE_FLOAT, CVT_DIR_BLOB2MAT, ConvertFloatBlobToN8UC3)
+REGISTER_X86_BLOB_CONVERT_FUNC(NGRAY,               DATA_TYPE_FLOAT, CVT_DIR_BLOB2MAT, ConvertFloatBlobToNGRAY)
+REGISTER_X86_BLOB_CONVERT_FUNC(NCHW_FLOAT,          DATA_TYPE_FLOAT, CVT_DIR_BLOB2MAT, ConvertFloatBlobToNCHWFloat)
+
 }  // namespace TNN_NS
@@ -57,6 +57,7 @@ private:
 
     static Status GetBlobConvertFunc(MatType mat_type, DataType data_type, BlobConvertDirection cvt_dir,
                                      X86BlobConvertFunc& cvt_func);
+    static bool HasBlobConvertFunc(MatType mat_type, DataType data_type, BlobConvertDirection cvt_dir);
     static std::string GetUniqueBlobConvertKey(MatType mat_type, DataType data_type, BlobConvertDirection cvt_dir);
     static std::map<std::string, X86BlobConvertFunc>& GetBlobConvertFuncMap();
 };
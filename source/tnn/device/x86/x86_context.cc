@@ -13,10 +13,42 @@
 // specific language governing permissions and limitations under the License.
 
 #include "tnn/device/x86/x86_context.h"
-#include "tnn/utils/omp_utils.h"
+
+#include <cstdio>
+#include <fstream>
+
+#include "tnn/utils/parallel_for.h"
+#include "tnn/utils/thread_pool.h"
 
 namespace TNN_NS {
 
+// bump the version if the meaning of tuned configs changes, old files are ignored then
+static const char *kTuneCacheVersion = "tnn_x86_tune_v1";
+static const char *kTuneCacheName    = "tnn_x86_tune.cache";
+// the cache file may be shared by all instances in the process
+static std::mutex g_tune_cache_mutex;
+
+static void LoadTuneCache(const std::string &file, std::map<std::string, std::string> &tune_map) {
+    std::ifstream cache_stream(file);
+    if (!cache_stream.is_open()) {
+        return;
+    }
+    std::string version;
+    std::getline(cache_stream, version);
+    if (version != kTuneCacheVersion) {
+        LOGD("x86 tune cache %s has version %s, ignored\n", file.c_str(), version.c_str());
+        return;
+    }
+    std::string line;
+    while (std::getline(cache_stream, line)) {
+        auto pos = line.find(' ');
+        if (pos == std::string::npos || pos == 0) {
+            continue;
+        }
+        tune_map[line.substr(0, pos)] = line.substr(pos + 1);
+    }
+}
+
 Status X86Context::LoadLibrary(std::vector<std::string> path) {
     return TNN_OK;
 }
@@ -27,11 +59,17 @@ Status X86Context::GetCommandQueue(void** command_queue) {
 
 Status X86Context::OnInstanceForwardBegin() {
     Context::OnInstanceForwardBegin();
-    OMP_SET_THREADS_(GetNumThreads());
+    // the pool is created on first forward after the threads or affinity change
+    if (!parallel_pool_ || parallel_pool_->GetNumThreads() != GetNumThreads() ||
+        parallel_pool_->GetCpuAffinity() != GetCpuAffinity()) {
+        parallel_pool_ = std::make_shared<ParallelForPool>(GetNumThreads(), GetCpuAffinity());
+    }
+    BindParallelForPool(parallel_pool_);
     return TNN_OK;
 }
 
 Status X86Context::OnInstanceForwardEnd() {
+    BindParallelForPool(nullptr);
     return TNN_OK;
 }
 
@@ -40,7 +78,7 @@ Status X86Context::Synchronize() {
 }
 
 Status X86Context::SetNumThreads(int num_threads) {
-    num_threads_ = MIN(MAX(num_threads, 1), OMP_CORES_);
+    num_threads_ = MIN(MAX(num_threads, 1), GetCpuCount());
     return TNN_OK;
 }
 
@@ -48,18 +86,89 @@ int X86Context::GetNumThreads() {
     return num_threads_;
 }
 
+Status X86Context::OnInstanceReshapeEnd() {
+    auto file = GetTuneCacheFile();
+    if (!tune_map_dirty_ || file.empty()) {
+        return TNN_OK;
+    }
+
+    std::lock_guard<std::mutex> lock(g_tune_cache_mutex);
+    // merge with the results stored by other instances since loading
+    std::map<std::string, std::string> tune_map;
+    LoadTuneCache(file, tune_map);
+    for (auto &iter : tune_map_) {
+        tune_map[iter.first] = iter.second;
+    }
+
+    // write to a temp file then rename, readers never see a partial file
+    auto temp_file = file + ".tmp";
+    {
+        std::ofstream cache_stream(temp_file);
+        if (!cache_stream.is_open()) {
+            LOGE("x86 tune cache %s can not be written\n", temp_file.c_str());
+            return TNN_OK;
+        }
+        cache_stream << kTuneCacheVersion << std::endl;
+        for (auto &iter : tune_map) {
+            cache_stream << iter.first << " " << iter.second << std::endl;
+        }
+        if (!cache_stream.good()) {
+            LOGE("x86 tune cache %s write failed\n", temp_file.c_str());
+            return TNN_OK;
+        }
+    }
+    if (std::rename(temp_file.c_str(), file.c_str()) != 0) {
+        LOGE("x86 tune cache %s rename failed\n", file.c_str());
+        std::remove(temp_file.c_str());
+        return TNN_OK;
+    }
+    tune_map_dirty_ = false;
+    return TNN_OK;
+}
+
 void* X86Context::GetSharedWorkSpace(size_t size) {
     return GetSharedWorkSpace(size, 0);
 }
 
 void* X86Context::GetSharedWorkSpace(size_t size, int index) {
-    while(work_space_.size() < index + 1) {
-        work_space_.push_back(RawBuffer(size, 32));
+    std::unique_lock<std::mutex> lck(work_space_mutex_);
+    auto &work_space = work_space_[ThreadPool::GetWorkerIndex()];
+    while(work_space.size() < index + 1) {
+        work_space.push_back(RawBuffer(size, 32));
     }
-    if (work_space_[index].GetBytesSize() < size) {
-        work_space_[index] = RawBuffer(size, 32);
+    if (work_space[index].GetBytesSize() < size) {
+        work_space[index] = RawBuffer(size, 32);
+    }
+    return work_space[index].force_to<void*>();
+}
+
+std::string X86Context::GetTuneCacheFile() {
+    if (cache_path_.empty()) {
+        return "";
     }
-    return work_space_[index].force_to<void*>();
+    return cache_path_ + "/" + kTuneCacheName;
+}
+
+bool X86Context::GetTuneResult(const std::string &key, std::string &value) {
+    if (!tune_map_loaded_) {
+        tune_map_loaded_ = true;
+        auto file        = GetTuneCacheFile();
+        if (!file.empty()) {
+            std::lock_guard<std::mutex> lock(g_tune_cache_mutex);
+            LoadTuneCache(file, tune_map_);
+        }
+    }
+    auto iter = tune_map_.find(key);
+    if (iter == tune_map_.end()) {
+        return false;
+    }
+    value = iter->second;
+    return true;
+}
+
+void X86Context::SetTuneResult(const std::string &key, const std::string &value) {
+    tune_map_[key]  = value;
+    tune_map_dirty_ = true;
 }
 
 }  // namespace TNN_NS
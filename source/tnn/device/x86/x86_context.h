@@ -15,11 +15,14 @@
 #ifndef TNN_SOURCE_TNN_DEVICE_X86_X86_CONTEXT_H_
 #define TNN_SOURCE_TNN_DEVICE_X86_X86_CONTEXT_H_
 
+#include <map>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include "tnn/core/context.h"
 #include "tnn/interpreter/raw_buffer.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 
@@ -38,6 +41,9 @@ public:
     // @brief after instance forward
     virtual Status OnInstanceForwardEnd() override;
 
+    // @brief after instance reshape, store the new tuning results to the cache file
+    virtual Status OnInstanceReshapeEnd() override;
+
     // @brief wait for jobs in the current context to complete
     virtual Status Synchronize() override;
 
@@ -50,9 +56,26 @@ public:
     void* GetSharedWorkSpace(size_t size);
     void* GetSharedWorkSpace(size_t size, int index);
 
+    // @brief get the tuned config of a layer, the cache file under cache path is loaded on first call
+    // @param key layer shape, isa and number of threads
+    // @return false if the key is not tuned yet
+    bool GetTuneResult(const std::string &key, std::string &value);
+
+    // @brief set the tuned config of a layer, stored to the cache file after reshape
+    void SetTuneResult(const std::string &key, const std::string &value);
+
 private:
+    std::string GetTuneCacheFile();
+
     int num_threads_ = 1;
-    std::vector<RawBuffer> work_space_;
+    std::shared_ptr<ParallelForPool> parallel_pool_ = nullptr;
+    // shared workspace of each graph executor worker, -1 for threads out of the executor
+    std::map<int, std::vector<RawBuffer>> work_space_;
+    std::mutex work_space_mutex_;
+    // tuned configs of layer accs, key -> config
+    std::map<std::string, std::string> tune_map_;
+    bool tune_map_loaded_ = false;
+    bool tune_map_dirty_  = false;
 };
 
 }  // namespace TNN_NS
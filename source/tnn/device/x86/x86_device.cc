@@ -12,6 +12,7 @@
 // CONDITIONS OF ANY KIND, either express or implied. See the License for the
 // specific language governing permissions and limitations under the License.
 
+#include "tnn/device/x86/acc/compute/jit/utils/cpu_isa.h"
 #include "tnn/device/x86/acc/x86_cpu_adapter_acc.h"
 #include "tnn/device/x86/x86_device.h"
 #include "tnn/device/x86/x86_context.h"
@@ -126,6 +127,19 @@ NetworkType X86Device::ConvertAutoNetworkType() {
     return NETWORK_TYPE_DEFAULT;
 }
 
+// gemm block sizes and kernels are chosen by the instruction sets at runtime
+std::string X86Device::GetIsaTag() {
+    static const std::vector<std::pair<x86_isa_t, std::string>> isa_names = {
+        {sse42, "sse42"}, {avx, "avx"}, {avx2, "avx2"}, {avx512, "avx512"}, {avx512_vnni, "avx512_vnni"}, {f16c, "f16c"}};
+    std::string tag = "";
+    for (auto &isa : isa_names) {
+        if (cpu_with_isa(isa.first)) {
+            tag += tag.empty() ? isa.second : "," + isa.second;
+        }
+    }
+    return tag;
+}
+
 Status X86Device::RegisterLayerAccCreator(LayerType type, LayerAccCreator* creator) {
     GetLayerCreatorMap()[type] = std::shared_ptr<LayerAccCreator>(creator);
     return TNN_OK;
@@ -56,6 +56,8 @@ public:
 
     virtual NetworkType ConvertAutoNetworkType();
 
+    virtual std::string GetIsaTag();
+
     static Status RegisterLayerAccCreator(LayerType type, LayerAccCreator* creator);
 
 private:
@@ -14,6 +14,8 @@
 
 #include "tnn/device/x86/x86_mat_converter.h"
 
+#include "tnn/core/blob_int8.h"
+#include "tnn/device/x86/acc/compute/x86_preprocess.h"
 #include "tnn/device/x86/x86_mat_util.h"
 
 #include "tnn/utils/dims_utils.h"
@@ -284,6 +286,41 @@ Status X86MatConverterAcc::CopyMakeBorder(Mat& src, Mat& dst, CopyMakeBorderPara
     return ret;
 }
 
+// fused path for host mats into nchw float or nhwc4 int8 blobs, everything else runs the step by step chain
+Status X86MatConverterAcc::Preprocess(Mat& src, Blob* blob, PreprocessParam param, void* command_queue) {
+    auto desc             = blob->GetBlobDesc();
+    const int channel     = DimsFunctionUtils::GetDim(desc.dims, 1);
+    const int src_channel = X86PreprocessSrcChannel(src.GetMatType());
+    const bool host_src   = src.GetDeviceType() == DEVICE_X86 || src.GetDeviceType() == DEVICE_NAIVE;
+    const bool fusable_blob =
+        (desc.data_type == DATA_TYPE_FLOAT && desc.data_format == DATA_FORMAT_NCHW) || desc.data_type == DATA_TYPE_INT8;
+    // same channel requirements as BlobConverter, bgra may drop the alpha channel
+    const bool fusable_channel = channel == src_channel || (src.GetMatType() == N8UC4 && channel == 3);
+    if (!host_src || !fusable_blob || !fusable_channel) {
+        return MatConverterAcc::Preprocess(src, blob, param, command_queue);
+    }
+
+    auto& convert_param = param.convert_param;
+    if (convert_param.scale.size() < channel || convert_param.bias.size() < channel) {
+        return Status(TNNERR_PARAM_ERR, "X86MatConverterAcc::Preprocess, scale or bias size less than blob channel");
+    }
+    std::vector<float> scale(convert_param.scale.begin(), convert_param.scale.begin() + channel);
+    std::vector<float> bias(convert_param.bias.begin(), convert_param.bias.begin() + channel);
+    if (desc.data_type == DATA_TYPE_INT8) {
+        auto scale_handle = reinterpret_cast<BlobInt8*>(blob)->GetIntResource()->scale_handle;
+        auto scale_data   = scale_handle.force_to<float*>();
+        auto scale_count  = scale_handle.GetDataCount();
+        for (int c = 0; c < channel; ++c) {
+            auto blob_scale = scale_data[scale_count == 1 ? 0 : c];
+            scale[c]        = blob_scale != 0 ? scale[c] / blob_scale : 0;
+            bias[c]         = blob_scale != 0 ? bias[c] / blob_scale : 0;
+        }
+    }
+
+    return X86Preprocess(src, param.crop, param.interp_type, convert_param.reverse_channel, scale.data(),
+                         bias.data(), desc.data_type, desc.dims, handle_ptr<char*>(blob->GetHandle()));
+}
+
 DECLARE_MAT_CONVERTER_CREATER(X86);
 REGISTER_MAT_CONVERTER(X86, DEVICE_X86);
 
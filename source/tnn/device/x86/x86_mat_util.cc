@@ -22,7 +22,7 @@
 #include "tnn/utils/bfp16.h"
 #include "tnn/utils/mat_converter_utils.h"
 #include "tnn/utils/naive_compute.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 
 namespace TNN_NS {
 namespace x86 {
@@ -638,7 +638,7 @@ void ResizeBilinearC1Impl(const uint8_t* src, int batch, int src_w, int src_h, i
     ResizeBilinearKernelParm param(xofs, yofs, ialpha, ibeta, src, dst, src_plane, src_stride, schannel);
 
     // loop body
-    int max_num_threads = OMP_MAX_THREADS_NUM_;
+    int max_num_threads = GetParallelMaxThreads();
     short* rows0        = new short[w * max_num_threads];
     short* rows1        = new short[w * max_num_threads];
     short** rows0_t     = new short*[max_num_threads];
@@ -652,11 +652,9 @@ void ResizeBilinearC1Impl(const uint8_t* src, int batch, int src_w, int src_h, i
             rows1_t[t] = rows1 + t * w;
         }
 
-        OMP_PARALLEL_FOR_
-        for (int dy = 0; dy < h; dy++) {
-            int thread_id = OMP_TID_;
+        ParallelForWithThreadId(0, h, [&](int dy, int thread_id) {
             ResizeBilinearOneRow<1>(param, thread_id, rows0_t, rows1_t, prev_sy, b, w, h, stride, dy);
-        }
+        });
     }
 
     delete[] rows0;
@@ -674,7 +672,7 @@ void ResizeBilinearC2Impl(const uint8_t* src, int batch, int src_w, int src_h, i
     ResizeBilinearKernelParm param(xofs, yofs, ialpha, ibeta, src, dst, src_plane, src_stride, schannel);
 
     // loop body
-    int max_num_threads = OMP_MAX_THREADS_NUM_;
+    int max_num_threads = GetParallelMaxThreads();
     short* rows0        = new short[(w * 2 + 2) * max_num_threads];
     short* rows1        = new short[(w * 2 + 2) * max_num_threads];
     short** rows0_t     = new short*[max_num_threads];
@@ -688,11 +686,9 @@ void ResizeBilinearC2Impl(const uint8_t* src, int batch, int src_w, int src_h, i
             rows1_t[t] = rows1 + t * (w * 2 + 2);
         }
 
-        OMP_PARALLEL_FOR_
-        for (int dy = 0; dy < h; dy++) {
-            int thread_id = OMP_TID_;
+        ParallelForWithThreadId(0, h, [&](int dy, int thread_id) {
             ResizeBilinearOneRow<2>(param, thread_id, rows0_t, rows1_t, prev_sy, b, w, h, stride, dy);
-        }
+        });
     }
 
     delete[] rows0;
@@ -710,7 +706,7 @@ void ResizeBilinearC3Impl(const uint8_t* src, int batch, int src_w, int src_h, i
     ResizeBilinearKernelParm param(xofs, yofs, ialpha, ibeta, src, dst, src_plane, src_stride, schannel);
 
     // loop body
-    int max_num_threads = OMP_MAX_THREADS_NUM_;
+    int max_num_threads = GetParallelMaxThreads();
     short* rows0        = new short[(w * 3 + 1) * max_num_threads];
     short* rows1        = new short[(w * 3 + 1) * max_num_threads];
     short** rows0_t     = new short*[max_num_threads];
@@ -724,11 +720,9 @@ void ResizeBilinearC3Impl(const uint8_t* src, int batch, int src_w, int src_h, i
             rows1_t[t] = rows1 + t * (w * 3 + 1);
         }
 
-        OMP_PARALLEL_FOR_
-        for (int dy = 0; dy < h; dy++) {
-            int thread_id = OMP_TID_;
+        ParallelForWithThreadId(0, h, [&](int dy, int thread_id) {
             ResizeBilinearOneRow<3>(param, thread_id, rows0_t, rows1_t, prev_sy, b, w, h, stride, dy);
-        }
+        });
     }
 
     delete[] rows0;
@@ -746,7 +740,7 @@ void ResizeBilinearC4Impl(const uint8_t* src, int batch, int src_w, int src_h, i
     ResizeBilinearKernelParm param(xofs, yofs, ialpha, ibeta, src, dst, src_plane, src_stride, schannel);
 
     // loop body
-    int max_num_threads = OMP_MAX_THREADS_NUM_;
+    int max_num_threads = GetParallelMaxThreads();
     short* rows0        = new short[(w * 4) * max_num_threads];
     short* rows1        = new short[(w * 4) * max_num_threads];
     short** rows0_t     = new short*[max_num_threads];
@@ -760,11 +754,9 @@ void ResizeBilinearC4Impl(const uint8_t* src, int batch, int src_w, int src_h, i
             rows1_t[t] = rows1 + t * (w * 4);
         }
 
-        OMP_PARALLEL_FOR_
-        for (int dy = 0; dy < h; dy++) {
-            int thread_id = OMP_TID_;
+        ParallelForWithThreadId(0, h, [&](int dy, int thread_id) {
             ResizeBilinearOneRow<4>(param, thread_id, rows0_t, rows1_t, prev_sy, b, w, h, stride, dy);
-        }
+        });
     }
 
     delete[] rows0;
@@ -832,8 +824,7 @@ void ResizeNearestC1Impl(const uint8_t* src, int batch, int src_w, int src_h, in
 
     // loop body
     for (int b = 0; b < batch; ++b) {
-        OMP_PARALLEL_FOR_
-        for (int dy = 0; dy < h; dy++) {
+        ParallelFor(0, h, [&](int dy) {
             ResizeNearestLoopPreparation();
 #ifdef __SSE4_2__
             int* xofs_p       = xofs;
@@ -871,7 +862,7 @@ void ResizeNearestC1Impl(const uint8_t* src, int batch, int src_w, int src_h, in
                 int sx = xofs[dx];
                 Dp[dx] = (ialpha[dx] == 0) ? Sp[sx + 1] : Sp[sx];
             }
-        }
+        });
     }
 
     delete[] buf;
@@ -883,8 +874,7 @@ void ResizeNearestC2Impl(const uint8_t* src, int batch, int src_w, int src_h, in
 
     // loop body
     for (int b = 0; b < batch; ++b) {
-        OMP_PARALLEL_FOR_
-        for (int dy = 0; dy < h; dy++) {
+        ParallelFor(0, h, [&](int dy) {
             ResizeNearestLoopPreparation();
 #ifdef __SSE4_2__
             int* xofs_p       = xofs;
@@ -926,7 +916,7 @@ void ResizeNearestC2Impl(const uint8_t* src, int batch, int src_w, int src_h, in
                 Dp[dx * 2]     = (ialpha[dx] == 0) ? Sp[sx + 2] : Sp[sx];
                 Dp[dx * 2 + 1] = (ialpha[dx] == 0) ? Sp[sx + 3] : Sp[sx + 1];
             }
-        }
+        });
     }
 
     delete[] buf;
@@ -938,8 +928,7 @@ void ResizeNearestC3Impl(const uint8_t* src, int batch, int src_w, int src_h, in
 
     // loop body
     for (int b = 0; b < batch; ++b) {
-        OMP_PARALLEL_FOR_
-        for (int dy = 0; dy < h; dy++) {
+        ParallelFor(0, h, [&](int dy) {
             ResizeNearestLoopPreparation();
 #ifdef __SSE4_2__
             int* xofs_p       = xofs;
@@ -996,7 +985,7 @@ void ResizeNearestC3Impl(const uint8_t* src, int batch, int src_w, int src_h, in
                 Dp[dx * 3 + 1] = (ialpha[dx] == 0) ? Sp[sx + 4] : Sp[sx + 1];
                 Dp[dx * 3 + 2] = (ialpha[dx] == 0) ? Sp[sx + 5] : Sp[sx + 2];
             }
-        }
+        });
     }
 
     delete[] buf;
@@ -1008,8 +997,7 @@ void ResizeNearestC4Impl(const uint8_t* src, int batch, int src_w, int src_h, in
 
     // loop body
     for (int b = 0; b < batch; ++b) {
-        OMP_PARALLEL_FOR_
-        for (int dy = 0; dy < h; dy++) {
+        ParallelFor(0, h, [&](int dy) {
             ResizeNearestLoopPreparation();
 #ifdef __SSE4_2__
             int* xofs_p       = xofs;
@@ -1062,7 +1050,7 @@ void ResizeNearestC4Impl(const uint8_t* src, int batch, int src_w, int src_h, in
                 Dp[dx * 4 + 2] = (ialpha[dx] == 0) ? Sp[sx + 6] : Sp[sx + 2];
                 Dp[dx * 4 + 3] = (ialpha[dx] == 0) ? Sp[sx + 7] : Sp[sx + 3];
             }
-        }
+        });
     }
 
     delete[] buf;
@@ -1683,15 +1671,13 @@ static void WarpAffineBilinear(const uint8_t* src, int batch, int src_w, int src
     int* adelta = buffer;
     int* bdelta = buffer + dst_w * 2;
 
-    int max_num_threads = OMP_MAX_THREADS_NUM_;
+    int max_num_threads = GetParallelMaxThreads();
     int* buf_loc        = new int[dst_w * max_num_threads];
     short* tab_loc      = new short[dst_w * max_num_threads];
 
     const unsigned char* src2 = src + src_w * schannel;
 
-    OMP_PARALLEL_FOR_
-    for (int y = 0; y < dst_h * batch; ++y) {
-        int thread_id    = OMP_TID_;
+    ParallelForWithThreadId(0, dst_h * batch, [&](int y, int thread_id) {
         int x_count      = 0;
         int end_x        = 0;
         int dst_loc_base = y * dst_w * schannel;
@@ -1702,7 +1688,7 @@ static void WarpAffineBilinear(const uint8_t* src, int batch, int src_w, int src
                                 dst_w, y % dst_h, (y / dst_h) * src_plane, x_count, end_x, border_val);
         WarpAffineCalculateOneRow<schannel>(end_x - x_count + 1, end_x, schannel, dst_loc_base, buf_loc_t, tab_loc_t,
                                             src, src2, dst);
-    }
+    });
 
     delete[] buf_loc;
     delete[] tab_loc;
@@ -1763,8 +1749,7 @@ static void WarpAffineNearest(const uint8_t* src, int batch, int src_w, int src_
 
     int src_stride = src_w * schannel;
     int src_plane  = src_h * src_w * schannel;
-    OMP_PARALLEL_FOR_
-    for (int y = 0; y < dst_h * batch; ++y) {
+    ParallelFor(0, dst_h * batch, [&](int y) {
         int y_c = y / dst_h;
         int y_r = y % dst_h;
 
@@ -1824,7 +1809,7 @@ static void WarpAffineNearest(const uint8_t* src, int batch, int src_w, int src_
                 }
             }
         }
-    }
+    });
 
     free(buffer);
 }
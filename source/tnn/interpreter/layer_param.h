@@ -61,6 +61,10 @@ enum ActivationType {
     ActivationType_None        = 0x0000,
     ActivationType_ReLU        = 0x0001,
     ActivationType_ReLU6       = 0x0002,
+    ActivationType_SIGMOID     = 0x0003,
+    // x * relu6(x + 3) / 6
+    ActivationType_HARDSWISH   = 0x0004,
+    ActivationType_GELU        = 0x0005,
     ActivationType_SIGMOID_MUL = 0x0100,
 };
 
@@ -613,6 +617,9 @@ struct LSTMONNXLayerParam : public LayerParam {
     int hidden_size      = 0;
     // 0: forward 1:reverse 2:bidirection
     int direction = 0;
+    // 1: h_t and c_t of the last forward are the initial state of the next one,
+    // h_0 and c_0 only initialize the first forward after the batch size changes
+    int streaming = 0;
 
     PARAM_COPY(LSTMONNXLayerParam)
 };
@@ -704,6 +711,13 @@ struct GLULayerParam : public LayerParam {
     PARAM_COPY(GLULayerParam);
 };
 
+// softmax(Q * K_t * scale + mask) * V, inputs are q, k_t, v and the optional mask
+struct FusedAttentionLayerParam : public LayerParam {
+    float scale = 1.0f;
+
+    PARAM_COPY(FusedAttentionLayerParam);
+};
+
 };  // namespace TNN_NS
 
 #endif  // TNN_SOURCE_TNN_INTERPRETER_LAYER_PARAM_H
@@ -34,6 +34,8 @@ public:
     RawBuffer(int bytes_size, DimsVector dims);
     RawBuffer(int bytes_size, char *buffer);
     RawBuffer(int bytes_size, char* buffer, DimsVector dims);
+    // share the buffer without copy, the buffer keeps its owner (e.g. a mapped model file) alive
+    RawBuffer(int bytes_size, shared_ptr<char> buffer, DimsVector dims);
     RawBuffer(const RawBuffer &buf);
     RawBuffer(int bytes_size, int alignment);
     RawBuffer &operator=(RawBuffer buf);
@@ -23,6 +23,7 @@ Status LSTMONNXLayerInterpreter::InterpretProto(str_arr layer_cfg_arr, int index
     GET_FLOAT_1_OR_DEFAULT(layer_param->clip_threshold, 0);
     GET_INT_1_OR_DEFAULT(layer_param->hidden_size, 0);
     GET_INT_1_OR_DEFAULT(layer_param->direction, 0);
+    GET_INT_1_OR_DEFAULT(layer_param->streaming, 0);
     return TNN_OK;
 }
 
@@ -37,6 +38,9 @@ Status LSTMONNXLayerInterpreter::SaveProto(std::ofstream& output_stream, LayerPa
         return Status(TNNERR_NULL_PARAM, "invalid layer param to save");
     }
     output_stream << layer_param->clip_threshold << " " << layer_param->hidden_size << " " << layer_param->direction << " ";
+    if (layer_param->streaming) {
+        output_stream << layer_param->streaming << " ";
+    }
 
     return TNN_OK;
 }
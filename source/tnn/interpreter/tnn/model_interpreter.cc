@@ -14,6 +14,7 @@
 
 #include "tnn/interpreter/tnn/model_interpreter.h"
 #include <stdlib.h>
+#include <chrono>
 #include <sstream>
 
 #include "tnn/core/common.h"
@@ -39,6 +40,11 @@ std::shared_ptr<Deserializer> ModelInterpreter::GetDeserializer(std::istream &is
     return std::make_shared<Deserializer>(is);
 }
 
+std::shared_ptr<Deserializer> ModelInterpreter::GetMappedDeserializer(std::istream &is,
+                                                                      std::shared_ptr<MappedFile> file) {
+    return std::make_shared<MappedDeserializer>(is, file->GetData(), file->GetSize(), file);
+}
+
 ModelInterpreter::ModelInterpreter() {}
 
 ModelInterpreter::ModelInterpreter(const ModelInterpreter &interp) {
@@ -116,22 +122,40 @@ Status ModelInterpreter::Interpret(std::vector<std::string> &params) {
         }
     }
 
+    typedef std::chrono::steady_clock Clock;
+    auto time_ms = [](Clock::time_point start, Clock::time_point end) {
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    };
+    auto parse_start = Clock::now();
+
     auto &proto_content = params.size() > 0 ? params[0] : empty_content;
     Status status       = InterpretProto(proto_content);
     if (status != TNN_OK) {
         return status;
     }
+    auto interpret_start = Clock::now();
 
+    // len of "ModelPath:" is 10, the model is mapped from the file and hashed while mapped
     auto &model_content = params.size() > 1 ? params[1] : empty_content;
-    status              = InterpretModel(model_content);
+    const bool mapped   = model_content.size() > 10 && model_content.compare(0, 10, "ModelPath:") == 0;
+    std::string model_md5;
+    if (mapped) {
+        status = InterpretMappedModel(model_content.substr(10), model_md5);
+    } else {
+        status = InterpretModel(model_content);
+    }
     if (status != TNN_OK) {
         return status;
     }
+    auto md5_start = Clock::now();
 
-    for (const auto& item : params) {
-        params_md5_.push_back(md5(item));
-        LOGD("model params md5: %s\n", md5(item).c_str());
+    for (size_t i = 0; i < params.size(); i++) {
+        auto item_md5 = (mapped && i == 1) ? model_md5 : md5(params[i]);
+        params_md5_.push_back(item_md5);
+        LOGD("model params md5: %s\n", item_md5.c_str());
     }
+    LOGD("ModelInterpreter time: parse proto %.2f ms, interpret model %.2f ms, md5 %.2f ms\n",
+         time_ms(parse_start, interpret_start), time_ms(interpret_start, md5_start), time_ms(md5_start, Clock::now()));
 
     if (!config_map.empty()) {
         status          = InterpretConfig(config_map);
@@ -398,8 +422,6 @@ Status ModelInterpreter::InterpretLayer(const std::string &layer_str) {
 }
 
 Status ModelInterpreter::InterpretModel(std::string &model_content) {
-    NetResource *net_resource = GetNetResource();
-
     const auto model_length = model_content.length();
     if (model_length <= 0) {
 #ifdef GENERATE_RESOURCE
@@ -410,8 +432,37 @@ Status ModelInterpreter::InterpretModel(std::string &model_content) {
 #endif
     }
 
-    std::istringstream content_stream;
-    content_stream.str(model_content);
+    // read the content in place, copying it into a string stream doubles the peak memory
+    MemoryStreamBuf stream_buf(model_content.data(), model_content.size());
+    std::istream content_stream(&stream_buf);
+    return InterpretModel(content_stream, GetDeserializer(content_stream));
+}
+
+Status ModelInterpreter::InterpretMappedModel(const std::string &model_path, std::string &model_md5) {
+    std::shared_ptr<MappedFile> mapped_file;
+    Status status = MappedFile::Open(model_path, mapped_file);
+    if (status != TNN_OK) {
+        return status;
+    }
+    if (mapped_file->GetSize() <= 0) {
+        return Status(TNNERR_LOAD_MODEL, "model content is invalid");
+    }
+
+    MD5 model_hash;
+    const size_t chunk_size = 1 << 30;
+    for (size_t offset = 0; offset < mapped_file->GetSize(); offset += chunk_size) {
+        auto length = std::min(chunk_size, mapped_file->GetSize() - offset);
+        model_hash.update(mapped_file->GetData() + offset, (MD5::size_type)length);
+    }
+    model_md5 = model_hash.finalize().hexdigest();
+
+    MemoryStreamBuf stream_buf(mapped_file->GetData(), mapped_file->GetSize());
+    std::istream content_stream(&stream_buf);
+    return InterpretModel(content_stream, GetMappedDeserializer(content_stream, mapped_file));
+}
+
+Status ModelInterpreter::InterpretModel(std::istream &content_stream, std::shared_ptr<Deserializer> deserializer) {
+    NetResource *net_resource = GetNetResource();
 
     uint32_t magic_version_number = 0;
     content_stream.read(reinterpret_cast<char *>(&magic_version_number), sizeof(g_version_magic_number));
@@ -420,7 +471,6 @@ Status ModelInterpreter::InterpretModel(std::string &model_content) {
     }
 
     res_header header;
-    auto deserializer = GetDeserializer(content_stream);
     header.deserialize(*deserializer);
     if (header.layer_cnt_ < 0 || header.layer_cnt_ >= 10000) {
         LOGE("tnnmodel is invalid, maybe you should upgrade TNN\n");
@@ -18,6 +18,7 @@
 #include <algorithm>
 #include "tnn/interpreter/default_model_interpreter.h"
 #include "tnn/interpreter/tnn/objseri.h"
+#include "tnn/utils/mapped_file.h"
 #include "tnn/utils/safe_map.h"
 
 using namespace TNN_NS;
@@ -117,6 +118,8 @@ private:
 protected:
     virtual Status InterpretProto(std::string& content);
     virtual Status InterpretModel(std::string& model_content);
+    virtual Status InterpretModel(std::istream& content_stream, std::shared_ptr<Deserializer> deserializer);
+    virtual Status InterpretMappedModel(const std::string& model_path, std::string& model_md5);
     virtual Status InterpretInput(const std::string& inputs_content);
     virtual Status InterpretOutput(const std::string& outputs_content);
     virtual Status InterpretLayer(const std::string& layer_str);
@@ -125,7 +128,7 @@ protected:
     virtual std::string Transfer(std::string content);
     virtual bool IsValidVersionNumber(uint32_t number);
     virtual std::shared_ptr<Deserializer> GetDeserializer(std::istream& is);
-    ;
+    virtual std::shared_ptr<Deserializer> GetMappedDeserializer(std::istream& is, std::shared_ptr<MappedFile> file);
 
 protected:
     uint32_t version_magic_number = 0;
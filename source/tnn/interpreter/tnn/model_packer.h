@@ -32,6 +32,10 @@ public:
     // @brief set the model version to pack
     void SetVersion(int version);
 
+    // @brief align weights data in the model file, so that the file can be memory mapped
+    // and weights used in place. 0 keeps the compact layout readable by older versions.
+    void SetDataAlignment(int alignment);
+
 private:
     std::shared_ptr<LayerInfo> FindLayerInfo(std::string layer_name);
     Status PackProto(std::string file_path);
@@ -41,7 +45,8 @@ private:
                         std::shared_ptr<Serializer> &serializer);
 
 protected:
-    int model_version_ = 1;
+    int model_version_  = 1;
+    int data_alignment_ = 0;
 
     virtual std::string Transfer(std::string content);
     virtual uint32_t GetMagicNumber();
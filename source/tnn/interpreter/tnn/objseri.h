@@ -17,6 +17,8 @@
 
 #include <string>
 #include <fstream>
+#include <memory>
+#include <streambuf>
 #include <string>
 #include <typeinfo>
 #include "tnn/core/common.h"
@@ -28,6 +30,8 @@
 namespace TNN_NS {
     static const uint32_t g_version_magic_number = 0x0FABC0002;
     static const uint32_t g_version_magic_number_v2 = 0x0FABC0004;
+    // raw buffer with dims whose data is padded to the alignment set in Serializer
+    static const uint32_t g_raw_aligned_magic_number = 0x0FABC0006;
 
     class Serializer {
     public:
@@ -56,7 +60,7 @@ namespace TNN_NS {
         
         void PutRaw(int length, char* buffer, std::vector<int> dims, DataType data_type = DATA_TYPE_FLOAT)
         {
-            PutInt(g_version_magic_number_v2);
+            PutInt(data_alignment_ > 0 ? g_raw_aligned_magic_number : g_version_magic_number_v2);
             PutInt(data_type);
             PutInt(static_cast<int>(length));
             if (length <= 0) {
@@ -70,15 +74,30 @@ namespace TNN_NS {
             }
             if (_ostream.bad())
                 return;
+
+            if (data_alignment_ > 0) {
+                // data offset in the file is aligned, so is data in the mapped file
+                auto data_pos = static_cast<int64_t>(_ostream.tellp()) + static_cast<int64_t>(sizeof(int));
+                int padding   = static_cast<int>((data_alignment_ - data_pos % data_alignment_) % data_alignment_);
+                PutInt(padding);
+                std::string zeros(padding, '\0');
+                _ostream.write(zeros.data(), padding);
+            }
  
             _ostream.write(reinterpret_cast<char *>(buffer),
                            static_cast<std::streamsize>(length));
             return;
         }
 
+        // @brief align data of the following raw buffers in the stream, 0 keeps the compact layout
+        void SetDataAlignment(int alignment) {
+            data_alignment_ = alignment;
+        }
+
 
     protected:
         std::ostream &_ostream;
+        int data_alignment_ = 0;
         
         template <typename T>
         void put_basic_t(T value);
@@ -139,19 +158,11 @@ namespace TNN_NS {
         }
 
         virtual void GetRaw(TNN_NS::RawBuffer &value) {
-            auto magic_number  = static_cast<uint32_t>(GetInt());
-            auto data_type = (TNN_NS::DataType)GetInt();
-            int length = GetInt();
-            if (length <= 0) {
-                return;
-            }
-
+            DataType data_type;
+            int length;
             DimsVector dims;
-            if(magic_number == g_version_magic_number_v2) {
-                int size = GetInt();
-                for (int i = 0; i < size; ++i) {
-                    dims.push_back(GetInt());
-                }
+            if (!GetRawHeader(data_type, length, dims)) {
+                return;
             }
  
             value = TNN_NS::RawBuffer(length);
@@ -168,7 +179,29 @@ namespace TNN_NS {
 
     protected:
         std::istream &_istream;
-        
+
+        // @brief read the raw buffer fields before data, return false if it has no data
+        bool GetRawHeader(DataType &data_type, int &length, DimsVector &dims) {
+            auto magic_number = static_cast<uint32_t>(GetInt());
+            data_type         = (TNN_NS::DataType)GetInt();
+            length            = GetInt();
+            if (length <= 0) {
+                return false;
+            }
+
+            if (magic_number == g_version_magic_number_v2 || magic_number == g_raw_aligned_magic_number) {
+                int size = GetInt();
+                for (int i = 0; i < size; ++i) {
+                    dims.push_back(GetInt());
+                }
+            }
+            if (magic_number == g_raw_aligned_magic_number) {
+                int padding = GetInt();
+                _istream.ignore(padding);
+            }
+            return true;
+        }
+
         template <typename T>
         T get_basic_t();
         template <typename T>
@@ -204,6 +237,75 @@ namespace TNN_NS {
         return value;
     }
 
+    // @brief MemoryStreamBuf reads a memory block as stream without copying it
+    class MemoryStreamBuf : public std::streambuf {
+    public:
+        MemoryStreamBuf(const char *data, size_t size) {
+            char *begin = const_cast<char *>(data);
+            setg(begin, begin, begin + size);
+        }
+
+    protected:
+        virtual pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                                 std::ios_base::openmode which = std::ios_base::in) {
+            off_type base = 0;
+            if (dir == std::ios_base::cur) {
+                base = gptr() - eback();
+            } else if (dir == std::ios_base::end) {
+                base = egptr() - eback();
+            }
+            return seekpos(pos_type(base + off), which);
+        }
+
+        virtual pos_type seekpos(pos_type pos, std::ios_base::openmode which = std::ios_base::in) {
+            if (!(which & std::ios_base::in) || off_type(pos) < 0 || off_type(pos) > egptr() - eback()) {
+                return pos_type(off_type(-1));
+            }
+            setg(eback(), eback() + off_type(pos), egptr());
+            return pos;
+        }
+    };
+
+    // @brief MappedDeserializer reads a stream over a mapped model file. Raw buffer data
+    // aligned in the file is shared with the mapping instead of being copied.
+    class MappedDeserializer : public Deserializer {
+    public:
+        MappedDeserializer(std::istream &is, char *data, size_t size, std::shared_ptr<void> owner)
+            : Deserializer(is), data_(data), size_(size), owner_(owner) {}
+
+        virtual void GetRaw(TNN_NS::RawBuffer &value) {
+            DataType data_type;
+            int length;
+            DimsVector dims;
+            if (!GetRawHeader(data_type, length, dims)) {
+                return;
+            }
+
+            auto pos = static_cast<int64_t>(_istream.tellg());
+            // keep the alignment new[] guarantees to raw buffers, copy the data otherwise
+            if (pos < 0 || pos + length > static_cast<int64_t>(size_) ||
+                reinterpret_cast<uintptr_t>(data_ + pos) % kMinDataAlignment != 0) {
+                value = TNN_NS::RawBuffer(length);
+                if (!_istream.eof()) {
+                    _istream.read(value.force_to<char *>(), static_cast<std::streamsize>(length));
+                }
+            } else {
+                // aliasing shared_ptr, the mapping is released with the last buffer using it
+                value = TNN_NS::RawBuffer(length, std::shared_ptr<char>(owner_, data_ + pos), dims);
+                _istream.seekg(length, std::ios_base::cur);
+            }
+            value.SetDataType(data_type);
+            value.SetBufferDims(dims);
+        }
+
+    private:
+        static const int kMinDataAlignment = 16;
+
+        char *data_ = nullptr;
+        size_t size_ = 0;
+        std::shared_ptr<void> owner_;
+    };
+
     class Serializable {
     public:
         Serializable() {}
@@ -17,6 +17,7 @@
 #include "tnn/utils/string_utils_inner.h"
 
 #include <mutex>
+#include <set>
 #include <sstream>
 
 #include "tnn/core/macro.h"
@@ -38,6 +39,13 @@ BaseLayer::~BaseLayer() {
 
 Status BaseLayer::Init(Context* context, LayerParam* param, LayerResource* resource, std::vector<Blob*>& input_blobs,
                        std::vector<Blob*>& output_blobs, AbstractDevice* device, bool enable_const_folder) {
+    auto status = InitOutputs(param, resource, input_blobs, output_blobs, enable_const_folder);
+    RETURN_ON_NEQ(status, TNN_OK);
+    return InitLayerAcc(context, device);
+}
+
+Status BaseLayer::InitOutputs(LayerParam* param, LayerResource* resource, std::vector<Blob*>& input_blobs,
+                              std::vector<Blob*>& output_blobs, bool enable_const_folder) {
     input_blobs_  = input_blobs;
     output_blobs_ = output_blobs;
 
@@ -57,6 +65,7 @@ Status BaseLayer::Init(Context* context, LayerParam* param, LayerResource* resou
             LOGE("InferOutputShape failed\n");
             return status;
         }
+        inferred_input_ranks_ = GetInputRanks();
     }
     
     if (runtime_model_ == RUNTIME_MODE_NORMAL) {
@@ -71,15 +80,18 @@ Status BaseLayer::Init(Context* context, LayerParam* param, LayerResource* resou
             }
         }
     }
+    return TNN_OK;
+}
 
+Status BaseLayer::InitLayerAcc(Context* context, AbstractDevice* device) {
     if (device->GetDeviceType() == DEVICE_NAIVE || !IsOutputConstant() ||
-            (device->GetDeviceType() == DEVICE_CUDA && !enable_const_folder)) {
+            (device->GetDeviceType() == DEVICE_CUDA && !enable_const_folder_)) {
         layer_acc_ = device->CreateLayerAcc(type_);
         if (layer_acc_ != NULL) {
             layer_acc_->SetRuntimeMode(runtime_model_);
             layer_acc_->SetConstantResource(const_resource_);
             layer_acc_->SetConstantResourceFlag(const_resource_flag_);
-            return layer_acc_->Init(context, param, resource, input_blobs_, output_blobs_);
+            return layer_acc_->Init(context, param_, resource_, input_blobs_, output_blobs_);
         } else {
             LOGE("layer acc of type(%d) is nil\n", type_);
             return Status(TNNERR_LAYER_ERR, "layer acc is nil");
@@ -88,6 +100,18 @@ Status BaseLayer::Init(Context* context, LayerParam* param, LayerResource* resou
     return TNN_OK;
 }
 
+bool BaseLayer::HasConstantInput() {
+    if (const_resource_ == nullptr) {
+        return false;
+    }
+    for (auto blob : input_blobs_) {
+        if (const_resource_->find(blob->GetBlobDesc().name) != const_resource_->end()) {
+            return true;
+        }
+    }
+    return false;
+}
+
 Status BaseLayer::FillLayerParamWithConstantResource() {
     return TNN_OK;
 }
@@ -164,18 +188,123 @@ Status BaseLayer::InferOutputDataType() {
     return TNN_OK;
 }
 
+Status BaseLayer::InferAndCheckOutputShape() {
+    auto status = InferOutputShape();
+    RETURN_ON_NEQ(status, TNN_OK);
+    inferred_input_ranks_ = GetInputRanks();
+
+    auto dims = output_blobs_[0]->GetBlobDesc().dims;
+    for (auto item : dims) {
+        if (item < 0) {
+            LOGE("Error: layer(%s) output dims is invalid\n", layer_name_.c_str());
+            return Status(TNNERR_LAYER_ERR, "layer output dims is invalid");
+        }
+    }
+    return TNN_OK;
+}
+
+std::vector<int> BaseLayer::GetInputRanks() {
+    std::vector<int> ranks;
+    for (auto blob : input_blobs_) {
+        ranks.push_back((int)blob->GetBlobDesc().dims.size());
+    }
+    return ranks;
+}
+
+/*
+ * Only the layers below take their output dims from a reshape plan, their output dims
+ * follow from the input dims and params alone. Params conv, deconv and pooling write from
+ * the input sizes (pads of SAME padding, kernels of global pooling) are kept in the plan
+ * too, see GetInferredParams. Layers whose output dims depend on data are not listed and
+ * always infer again.
+ * Params written from the input ranks only, e.g. normalized axes, are kept valid by
+ * inferring again whenever the ranks differ from the last InferOutputShape.
+ */
+bool BaseLayer::IsOutputShapeCacheable() {
+    static const std::set<LayerType> input_dims_only_layers = {
+        // unary
+        LAYER_RELU, LAYER_RELU6, LAYER_PRELU, LAYER_SIGMOID, LAYER_TANH, LAYER_ABS, LAYER_NEG, LAYER_ELU, LAYER_SELU,
+        LAYER_EXP, LAYER_LOG, LAYER_SQRT, LAYER_RECIPROCAL, LAYER_FLOOR, LAYER_CEIL, LAYER_SIGN, LAYER_COS,
+        LAYER_ACOS, LAYER_SIN, LAYER_ASIN, LAYER_TAN, LAYER_ATAN, LAYER_ERF, LAYER_GELU, LAYER_SWISH,
+        LAYER_HARDSWISH, LAYER_HARDSIGMOID, LAYER_SOFTPLUS, LAYER_SOFTSIGN, LAYER_LOGSIGMOID, LAYER_CLIP, LAYER_NOT,
+        // broadcast binary
+        LAYER_ADD, LAYER_SUB, LAYER_MUL, LAYER_DIV, LAYER_MAXIMUM, LAYER_MINIMUM, LAYER_SQUARED_DIFFERENCE,
+        LAYER_EQUAL, LAYER_GREATER, LAYER_LESS, LAYER_AND,
+        // normalization
+        LAYER_BATCH_NORM, LAYER_SCALE, LAYER_INST_BATCH_NORM, LAYER_LAYER_NORM, LAYER_GROUP_NORM, LAYER_NORMALIZE,
+        LAYER_SOFTMAX, LAYER_LOGSOFTMAX,
+        LAYER_INNER_PRODUCT, LAYER_CONCAT, LAYER_PERMUTE,
+        // params inferred from the input sizes are restored from the plan
+        LAYER_CONVOLUTION, LAYER_DECONVOLUTION, LAYER_POOLING,
+    };
+    if (input_dims_only_layers.find(type_) == input_dims_only_layers.end()) {
+        return false;
+    }
+    for (auto blob : output_blobs_) {
+        if (blob->NeedAllocateInForward()) {
+            return false;
+        }
+    }
+    // output dims may depend on the data of constant inputs
+    return !HasConstantInput();
+}
+
+std::vector<int> BaseLayer::GetInferredParams() {
+    std::vector<int> inferred_params;
+    if (type_ == LAYER_CONVOLUTION || type_ == LAYER_DECONVOLUTION) {
+        auto conv_param = dynamic_cast<ConvLayerParam*>(param_);
+        if (conv_param) {
+            inferred_params = conv_param->pads;
+        }
+    } else if (type_ == LAYER_POOLING) {
+        auto pool_param = dynamic_cast<PoolingLayerParam*>(param_);
+        if (pool_param) {
+            inferred_params = pool_param->pads;
+            inferred_params.insert(inferred_params.end(), pool_param->kernels.begin(), pool_param->kernels.end());
+        }
+    }
+    return inferred_params;
+}
+
+void BaseLayer::SetInferredParams(const std::vector<int>& inferred_params) {
+    if (type_ == LAYER_CONVOLUTION || type_ == LAYER_DECONVOLUTION) {
+        auto conv_param = dynamic_cast<ConvLayerParam*>(param_);
+        if (conv_param) {
+            conv_param->pads = inferred_params;
+        }
+    } else if (type_ == LAYER_POOLING) {
+        auto pool_param = dynamic_cast<PoolingLayerParam*>(param_);
+        if (pool_param) {
+            const size_t pads_size = pool_param->pads.size();
+            pool_param->pads.assign(inferred_params.begin(), inferred_params.begin() + pads_size);
+            pool_param->kernels.assign(inferred_params.begin() + pads_size, inferred_params.end());
+        }
+    }
+}
+
+Status BaseLayer::ReshapeWithPlan(const std::vector<DimsVector>& output_dims, const std::vector<int>& inferred_params) {
+    if (output_dims.size() != output_blobs_.size() || !IsOutputShapeCacheable() ||
+        GetInputRanks() != inferred_input_ranks_ || inferred_params.size() != GetInferredParams().size()) {
+        return Reshape();
+    }
+    for (size_t i = 0; i < output_blobs_.size(); i++) {
+        output_blobs_[i]->GetBlobDesc().dims = output_dims[i];
+    }
+    SetInferredParams(inferred_params);
+    if (layer_acc_ != NULL) {
+        auto status = layer_acc_->ReloadConstantBlobs(input_blobs_, true);
+        RETURN_ON_NEQ(status, TNN_OK);
+        return layer_acc_->Reshape(input_blobs_, output_blobs_);
+    } else {
+        LOGE("layer acc is nil\n");
+        return Status(TNNERR_LAYER_ERR, "layer acc is nil");
+    }
+}
+
 Status BaseLayer::Reshape() {
     if (!output_blobs_[0]->NeedAllocateInForward()) {
-        auto status = InferOutputShape();
+        auto status = InferAndCheckOutputShape();
         RETURN_ON_NEQ(status, TNN_OK);
-
-        auto dims = output_blobs_[0]->GetBlobDesc().dims;
-        for (auto item : dims) {
-            if (item < 0) {
-                LOGE("Error: layer(%s) output dims is invalid\n", layer_name_.c_str());
-                return Status(TNNERR_LAYER_ERR, "layer output dims is invalid");
-            }
-        }
     }
     if (layer_acc_ != NULL) {
         auto status = layer_acc_->ReloadConstantBlobs(input_blobs_, true);
@@ -43,9 +43,25 @@ public:
     virtual Status Init(Context* context, LayerParam* param, LayerResource* resource, std::vector<Blob*>& inputs,
                 std::vector<Blob*>& outputs, AbstractDevice* device, bool enable_const_folder=true);
 
+    // @brief infer the output data types and dims, the first step of Init
+    Status InitOutputs(LayerParam* param, LayerResource* resource, std::vector<Blob*>& inputs,
+                       std::vector<Blob*>& outputs, bool enable_const_folder = true);
+
+    // @brief create and init the layer acc, the second step of Init. accs of different
+    // layers can be initialized concurrently once all layers finished InitOutputs
+    Status InitLayerAcc(Context* context, AbstractDevice* device);
+
     //@brief Reshape recalculate the output tensor dims
     virtual Status Reshape();
 
+    //@brief Reshape with the output dims and inferred params of a cached reshape plan, the
+    // output dims are inferred again if the layer can not take them from the plan
+    Status ReshapeWithPlan(const std::vector<DimsVector>& output_dims, const std::vector<int>& inferred_params);
+
+    //@brief get the params written from the input dims by the last InferOutputShape,
+    // e.g. the pads of SAME padding, to be kept in a reshape plan
+    std::vector<int> GetInferredParams();
+
     //@brief layer infer
     virtual Status Forward();
 
@@ -83,6 +99,9 @@ public:
     // @brief set runtime mode
     void SetRuntimeMode(RuntimeMode mode);
 
+    // @brief check if any input is a constant of the constant resource
+    bool HasConstantInput();
+
 protected:
     LayerType type_;
 
@@ -104,6 +123,18 @@ protected:
     virtual Status InferOutputDataType();
     //@brief fill layer param with constant resource
     virtual Status FillLayerParamWithConstantResource();
+    //@brief check if the output dims only depend on the input dims, so they can be taken from a reshape plan
+    virtual bool IsOutputShapeCacheable();
+
+private:
+    //@brief infer output dims and record the input ranks they were inferred with
+    Status InferAndCheckOutputShape();
+    std::vector<int> GetInputRanks();
+    void SetInferredParams(const std::vector<int>& inferred_params);
+
+    // ranks of the input blobs at the last InferOutputShape, params updated from the
+    // input ranks there stay valid for plans of the same ranks
+    std::vector<int> inferred_input_ranks_;
 };
 
 //@brief LayerCreator define the create layer interface
@@ -0,0 +1,86 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "tnn/layer/base_layer.h"
+#include "tnn/utils/dims_utils.h"
+
+namespace TNN_NS {
+
+DECLARE_LAYER(FusedAttention, LAYER_FUSED_ATTENTION);
+
+Status FusedAttentionLayer::InferOutputDataType() {
+    return BaseLayer::InferOutputDataType();
+}
+
+// q [..., S_q, D], k_t [..., D, S_k], v [..., S_k, D_v] and mask [..., S_q, S_k], the batch dims
+// broadcast like those of MatMul and Add, and a mask of S_q rows broadcasts q of a single row.
+Status FusedAttentionLayer::InferOutputShape(bool ignore_error) {
+    auto status = BaseLayer::InferOutputShape(ignore_error);
+    RETURN_ON_NEQ(status, TNN_OK);
+
+    if (input_blobs_.size() < 3) {
+        LOGE_IF(!ignore_error, "Error: FusedAttention layer need q, k and v\n");
+        return Status(TNNERR_PARAM_ERR, "FusedAttention layer need q, k and v");
+    }
+
+    auto q_dims = input_blobs_[0]->GetBlobDesc().dims;
+    auto k_dims = input_blobs_[1]->GetBlobDesc().dims;
+    auto v_dims = input_blobs_[2]->GetBlobDesc().dims;
+    if (q_dims.size() < 2 || k_dims.size() < 2 || v_dims.size() < 2 ||
+        q_dims[q_dims.size() - 1] != k_dims[k_dims.size() - 2] ||
+        k_dims[k_dims.size() - 1] != v_dims[v_dims.size() - 2]) {
+        LOGE_IF(!ignore_error, "Error: FusedAttention layer got wrong shape of q, k or v\n");
+        return Status(TNNERR_PARAM_ERR, "FusedAttention layer got wrong shape of q, k or v");
+    }
+    int seq_q        = q_dims[q_dims.size() - 2];
+    const int seq_k  = k_dims[k_dims.size() - 1];
+    const int v_size = v_dims[v_dims.size() - 1];
+
+    Status broadcast_status = TNN_OK;
+    DimsVector batch_dims(q_dims.begin(), q_dims.end() - 2);
+    batch_dims = DimsFunctionUtils::Expand(batch_dims, DimsVector(k_dims.begin(), k_dims.end() - 2), &broadcast_status);
+    batch_dims = DimsFunctionUtils::Expand(batch_dims, DimsVector(v_dims.begin(), v_dims.end() - 2), &broadcast_status);
+
+    if (input_blobs_.size() > 3) {
+        auto mask_dims = input_blobs_[3]->GetBlobDesc().dims;
+        while (mask_dims.size() < 2) {
+            mask_dims.insert(mask_dims.begin(), 1);
+        }
+        const int mask_rows = mask_dims[mask_dims.size() - 2];
+        const int mask_cols = mask_dims[mask_dims.size() - 1];
+        if (seq_q == 1) {
+            seq_q = mask_rows;
+        }
+        if ((mask_rows != 1 && mask_rows != seq_q) || (mask_cols != 1 && mask_cols != seq_k)) {
+            LOGE_IF(!ignore_error, "Error: FusedAttention layer got wrong shape of mask\n");
+            return Status(TNNERR_PARAM_ERR, "FusedAttention layer got wrong shape of mask");
+        }
+        batch_dims = DimsFunctionUtils::Expand(batch_dims, DimsVector(mask_dims.begin(), mask_dims.end() - 2),
+                                               &broadcast_status);
+    }
+    if (broadcast_status != TNN_OK) {
+        LOGE_IF(!ignore_error, "Error: FusedAttention layer got batch dims that do not broadcast\n");
+        return Status(TNNERR_PARAM_ERR, "FusedAttention layer got batch dims that do not broadcast");
+    }
+
+    auto output_dims = batch_dims;
+    output_dims.push_back(seq_q);
+    output_dims.push_back(v_size);
+    output_blobs_[0]->GetBlobDesc().dims = output_dims;
+    return TNN_OK;
+}
+
+REGISTER_LAYER(FusedAttention, LAYER_FUSED_ATTENTION);
+
+}  // namespace TNN_NS
@@ -48,6 +48,9 @@ Status NonMaxSuppressionLayer::InferOutputShape(bool ignore_error) {
         output_dim_max_box = boxes_dims[1];
     }
 
+    // at most output_dim_max_box boxes are selected for each batch and class
+    output_dim_max_box *= boxes_dims[0] * scores_dims[1];
+
     int last_dim     = 3;
     auto output_dims = {(int)output_dim_max_box, last_dim};
 
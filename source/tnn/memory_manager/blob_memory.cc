@@ -14,11 +14,15 @@
 
 #include "tnn/memory_manager/blob_memory.h"
 
+#include <algorithm>
+
 namespace TNN_NS {
 
 BlobMemory::BlobMemory(AbstractDevice* device, BlobMemorySizeInfo& size_info, int use_count)
     : device_(device), size_info_(size_info), use_count_(use_count) {
     need_release_memory_ = false;
+    live_begin_          = -1;
+    live_end_            = -1;
 }
 BlobMemory::~BlobMemory() {
     if (need_release_memory_) {
@@ -48,6 +52,24 @@ bool BlobMemory::DecrementUseCount() {
     }
 }
 
+void BlobMemory::UpdateLiveRange(int layer_index) {
+    if (live_begin_ < 0) {
+        live_begin_ = layer_index;
+        live_end_   = layer_index;
+    } else {
+        live_begin_ = std::min(live_begin_, layer_index);
+        live_end_   = std::max(live_end_, layer_index);
+    }
+}
+
+int BlobMemory::GetLiveBegin() const {
+    return live_begin_;
+}
+
+int BlobMemory::GetLiveEnd() const {
+    return live_end_;
+}
+
 Status BlobMemory::AllocateHandle() {
     auto status = device_->Allocate(&handle_, size_info_);
     if (status != TNN_OK) {
@@ -32,6 +32,13 @@ public:
     int GetUseCount() const;
     bool DecrementUseCount();
 
+    // @brief extend the live range of the memory to include the layer index
+    void UpdateLiveRange(int layer_index);
+    // @brief get index of the first layer using the memory, -1 if unknown
+    int GetLiveBegin() const;
+    // @brief get index of the last layer using the memory, -1 if unknown
+    int GetLiveEnd() const;
+
     Status AllocateHandle();
     void SetHandleFromExternal(BlobHandle handle);
     BlobHandle GetHandle();
@@ -47,6 +54,8 @@ private:
     BlobHandle handle_;
     bool need_release_memory_;
     int use_count_;
+    int live_begin_;
+    int live_end_;
 };
 
 }  // namespace TNN_NS
@@ -125,9 +125,21 @@ int BlobMemoryPool::GetAllBlobMemorySize() {
     return all_blob_memory_size_;
 }
 
+int BlobMemoryPool::GetAllBlobMemoryLowerBound() {
+    return (int)MemoryOffsetAssignStrategy::GetLowerBound(blob_memory_library_);
+}
+
+void BlobMemoryPool::EnableOffsetPack(bool enable) {
+    offset_pack_ = enable;
+}
+
 void BlobMemoryPool::CalculateAllBlobMemorySize() {
     typename std::set<BlobMemory *>::iterator iter;
     all_blob_memory_size_ = 0;
+    if (offset_pack_) {
+        all_blob_memory_size_ = (int)MemoryOffsetAssignStrategy::Plan(blob_memory_library_).peak_size;
+        return;
+    }
     for (auto iter : blob_memory_library_) {
         BlobMemorySizeInfo info = iter->GetBlobMemorySizeInfo();
         all_blob_memory_size_ += GetBlobMemoryBytesSize(info);
@@ -20,6 +20,7 @@
 
 #include "tnn/core/abstract_device.h"
 #include "tnn/memory_manager/blob_memory.h"
+#include "tnn/memory_manager/memory_offset_assign_strategy.h"
 #include "tnn/memory_manager/memory_seperate_assign_strategy.h"
 #include "tnn/memory_manager/memory_unify_assign_strategy.h"
 
@@ -36,6 +37,9 @@ public:
     BlobMemory *BorrowBlobMemory(int use_count, BlobMemorySizeInfo &size_info, bool use_new_memory = false);
     void RefundBlobMemory(BlobMemory *blob_memory);
     int GetAllBlobMemorySize();
+    int GetAllBlobMemoryLowerBound();
+    // @brief size blob memory as packed by live range, see MemoryOffsetAssignStrategy
+    void EnableOffsetPack(bool enable);
     Status AssignAllBlobMemory(MemoryAssignStrategy &strategy);
     virtual void ClearBlobMemoryPool();
     AbstractDevice *GetDevice();
@@ -57,6 +61,7 @@ private:
     virtual BlobMemoryNode *ExtractNearestBlobMemoryNode(BlobMemorySizeInfo &size_info);
 
     int all_blob_memory_size_ = 0;;
+    bool offset_pack_ = false;
     std::set<BlobMemory *> blob_memory_library_ = {};
 };
 
@@ -0,0 +1,203 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "tnn/memory_manager/memory_offset_assign_strategy.h"
+
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <vector>
+
+namespace TNN_NS {
+
+// offsets are aligned for simd loads of any device
+static const int64_t kBlobMemoryAlignment = 64;
+
+struct OffsetPlanItem {
+    BlobMemory* blob_memory = nullptr;
+    int64_t size            = 0;
+    int begin               = 0;
+    int end                 = 0;
+
+    int64_t LifeTime() const {
+        return (int64_t)end - begin + 1;
+    }
+};
+
+typedef std::function<bool(const OffsetPlanItem&, const OffsetPlanItem&)> OffsetPlanOrder;
+
+static std::vector<OffsetPlanItem> GetPlanItems(const std::set<BlobMemory*>& blob_memory_library) {
+    std::vector<OffsetPlanItem> items;
+    for (auto blob_memory : blob_memory_library) {
+        OffsetPlanItem item;
+        BlobMemorySizeInfo size_info = blob_memory->GetBlobMemorySizeInfo();
+        item.blob_memory             = blob_memory;
+        item.size  = (GetBlobMemoryBytesSize(size_info) + kBlobMemoryAlignment - 1) / kBlobMemoryAlignment *
+                    kBlobMemoryAlignment;
+        item.begin = blob_memory->GetLiveBegin();
+        item.end   = blob_memory->GetLiveEnd();
+        // memory without live range is regarded as alive all the time
+        if (item.begin < 0) {
+            item.begin = 0;
+            item.end   = INT_MAX;
+        }
+        items.push_back(item);
+    }
+    return items;
+}
+
+static int64_t GetItemsLowerBound(const std::vector<OffsetPlanItem>& items) {
+    // sweep the layer index, size is alive in [begin, end]
+    std::vector<std::pair<int, int64_t>> events;
+    for (const auto& item : items) {
+        events.push_back(std::make_pair(item.begin, item.size));
+        if (item.end < INT_MAX) {
+            events.push_back(std::make_pair(item.end + 1, -item.size));
+        }
+    }
+    std::sort(events.begin(), events.end());
+
+    int64_t alive = 0, lower_bound = 0;
+    for (size_t i = 0; i < events.size(); i++) {
+        alive += events[i].second;
+        // sizes released and allocated at the same index are never alive together
+        if (i + 1 == events.size() || events[i + 1].first != events[i].first) {
+            lower_bound = std::max(lower_bound, alive);
+        }
+    }
+    return lower_bound;
+}
+
+static int64_t PlaceItems(const std::vector<OffsetPlanItem>& items, std::vector<int64_t>& offsets) {
+    offsets.assign(items.size(), -1);
+    std::vector<size_t> placed;
+    std::vector<std::pair<int64_t, int64_t>> used;
+    int64_t peak_size = 0;
+
+    for (size_t i = 0; i < items.size(); i++) {
+        const auto& item = items[i];
+        used.clear();
+        for (auto j : placed) {
+            if (items[j].begin <= item.end && item.begin <= items[j].end) {
+                used.push_back(std::make_pair(offsets[j], offsets[j] + items[j].size));
+            }
+        }
+        std::sort(used.begin(), used.end());
+
+        // best fit: the smallest gap between memory alive at the same time
+        int64_t offset = -1, best_gap = LLONG_MAX, gap_begin = 0;
+        for (const auto& range : used) {
+            int64_t gap = range.first - gap_begin;
+            if (gap >= item.size && gap < best_gap) {
+                best_gap = gap;
+                offset   = gap_begin;
+            }
+            gap_begin = std::max(gap_begin, range.second);
+        }
+        if (offset < 0) {
+            offset = gap_begin;
+        }
+
+        offsets[i] = offset;
+        placed.push_back(i);
+        peak_size = std::max(peak_size, offset + item.size);
+    }
+    return peak_size;
+}
+
+MemoryOffsetAssignStrategy::MemoryOffsetAssignStrategy(void* data) {
+    all_blob_memory_data_ = data;
+}
+
+MemoryOffsetPlan MemoryOffsetAssignStrategy::Plan(const std::set<BlobMemory*>& blob_memory_library) {
+    std::vector<OffsetPlanItem> items = GetPlanItems(blob_memory_library);
+
+    MemoryOffsetPlan plan;
+    plan.lower_bound = GetItemsLowerBound(items);
+    plan.peak_size   = LLONG_MAX;
+
+    auto tie_break = [](const OffsetPlanItem& a, const OffsetPlanItem& b) {
+        if (a.begin != b.begin) {
+            return a.begin < b.begin;
+        }
+        return a.end < b.end;
+    };
+    std::vector<OffsetPlanOrder> orders = {
+        // greedy by size
+        [&](const OffsetPlanItem& a, const OffsetPlanItem& b) {
+            if (a.size != b.size) {
+                return a.size > b.size;
+            }
+            if (a.LifeTime() != b.LifeTime()) {
+                return a.LifeTime() > b.LifeTime();
+            }
+            return tie_break(a, b);
+        },
+        // greedy by area of size x lifetime
+        [&](const OffsetPlanItem& a, const OffsetPlanItem& b) {
+            double area_a = (double)a.size * a.LifeTime(), area_b = (double)b.size * b.LifeTime();
+            if (area_a != area_b) {
+                return area_a > area_b;
+            }
+            return tie_break(a, b);
+        },
+        // greedy by lifetime
+        [&](const OffsetPlanItem& a, const OffsetPlanItem& b) {
+            if (a.LifeTime() != b.LifeTime()) {
+                return a.LifeTime() > b.LifeTime();
+            }
+            if (a.size != b.size) {
+                return a.size > b.size;
+            }
+            return tie_break(a, b);
+        },
+    };
+
+    std::vector<int64_t> offsets;
+    for (auto& order : orders) {
+        std::stable_sort(items.begin(), items.end(), order);
+        int64_t peak_size = PlaceItems(items, offsets);
+        if (peak_size < plan.peak_size) {
+            plan.peak_size = peak_size;
+            plan.offsets.clear();
+            for (size_t i = 0; i < items.size(); i++) {
+                plan.offsets[items[i].blob_memory] = offsets[i];
+            }
+        }
+        if (plan.peak_size <= plan.lower_bound) {
+            break;
+        }
+    }
+    if (items.empty()) {
+        plan.peak_size = 0;
+    }
+    return plan;
+}
+
+int64_t MemoryOffsetAssignStrategy::GetLowerBound(const std::set<BlobMemory*>& blob_memory_library) {
+    return GetItemsLowerBound(GetPlanItems(blob_memory_library));
+}
+
+Status MemoryOffsetAssignStrategy::AssignAllBlobMemory(std::set<BlobMemory*>& blob_memory_library) {
+    MemoryOffsetPlan plan = Plan(blob_memory_library);
+    for (auto& iter : blob_memory_library) {
+        BlobHandle handle;
+        handle.base         = all_blob_memory_data_;
+        handle.bytes_offset = plan.offsets[iter];
+        iter->SetHandleFromExternal(handle);
+    }
+    return TNN_OK;
+}
+
+}  // namespace TNN_NS
@@ -0,0 +1,55 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef TNN_SOURCE_TNN_MEMORY_MANAGER_MEMORY_OFFSET_ASSIGN_STRATEGY_H_
+#define TNN_SOURCE_TNN_MEMORY_MANAGER_MEMORY_OFFSET_ASSIGN_STRATEGY_H_
+
+#include <map>
+#include <set>
+
+#include "tnn/memory_manager/memory_assign_strategy.h"
+
+namespace TNN_NS {
+
+struct MemoryOffsetPlan {
+    // bytes offset of every blob memory in the arena
+    std::map<BlobMemory*, int64_t> offsets;
+    // arena bytes size required by the plan
+    int64_t peak_size = 0;
+    // max bytes size of blob memory alive at the same time, no plan can be smaller
+    int64_t lower_bound = 0;
+};
+
+// @brief MemoryOffsetAssignStrategy places all blob memory in one arena.
+// Blob memory whose live ranges overlap get disjoint bytes ranges, the others
+// may share bytes. Offsets are solved greedily with several orderings
+// (size, size x lifetime, lifetime) and the plan with the smallest peak is kept.
+class MemoryOffsetAssignStrategy : public MemoryAssignStrategy {
+public:
+    explicit MemoryOffsetAssignStrategy(void* data);
+    virtual Status AssignAllBlobMemory(std::set<BlobMemory*>& blob_memory_library);
+
+    // @brief solve the bytes offsets of all blob memory
+    static MemoryOffsetPlan Plan(const std::set<BlobMemory*>& blob_memory_library);
+
+    // @brief get max bytes size of blob memory alive at the same time
+    static int64_t GetLowerBound(const std::set<BlobMemory*>& blob_memory_library);
+
+private:
+    void* all_blob_memory_data_;
+};
+
+}  // namespace TNN_NS
+
+#endif  // TNN_SOURCE_TNN_MEMORY_MANAGER_MEMORY_OFFSET_ASSIGN_STRATEGY_H_
@@ -33,6 +33,11 @@ namespace optimizer {
         virtual std::string Strategy()                                          = 0;
         virtual bool IsSupported(const NetworkConfig &net_config)               = 0;
         virtual Status Optimize(NetStructure *structure, NetResource *resource) = 0;
+        // @brief optimize for a network config, the optimizers are shared by all networks,
+        // so the ones depending on the config take it here instead of keeping it from IsSupported
+        virtual Status Optimize(NetStructure *structure, NetResource *resource, const NetworkConfig &net_config) {
+            return Optimize(structure, resource);
+        }
     };
 
 }  // namespace optimizer
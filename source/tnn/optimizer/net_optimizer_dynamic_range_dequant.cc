@@ -39,6 +39,15 @@ namespace optimizer {
     }
 
     Status NetOptimizerDynamicRangeDequant::Optimize(NetStructure *structure, NetResource *resource) {
+        return Optimize(structure, resource, NetworkConfig());
+    }
+
+    Status NetOptimizerDynamicRangeDequant::Optimize(NetStructure *structure, NetResource *resource,
+                                                     const NetworkConfig &net_config) {
+        // x86 inner product computes with the int8 weights, dequantized in its gemv and gemm kernels
+        const bool keep_int8_inner_product =
+            net_config.device_type == DEVICE_X86 && net_config.network_type != NETWORK_TYPE_OPENVINO;
+
         if (!structure) {
             LOGE("Error: empty NetStructure\n");
             return Status(TNNERR_NET_ERR, "Error: empty NetStructure");
@@ -64,7 +73,9 @@ namespace optimizer {
                     DequantMatMul(layer, structure, resource);
                     break;
                 case LAYER_INNER_PRODUCT:
-                    DequantInnerProduct(layer, structure, resource);
+                    if (!keep_int8_inner_product) {
+                        DequantInnerProduct(layer, structure, resource);
+                    }
                     break;
                 case LAYER_GATHER:
                     DequantGatherEmbedding(layer, structure, resource);
@@ -33,6 +33,7 @@ namespace optimizer {
         virtual std::string Strategy();
         virtual bool IsSupported(const NetworkConfig &net_config);
         virtual Status Optimize(NetStructure *structure, NetResource *resource);
+        virtual Status Optimize(NetStructure *structure, NetResource *resource, const NetworkConfig &net_config);
 
     private:
         Status DequantConv(std::shared_ptr<LayerInfo> &layer, NetStructure *structure, NetResource *resource);
@@ -0,0 +1,288 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "tnn/optimizer/net_optimizer_fuse_attention.h"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "tnn/core/layer_type.h"
+#include "tnn/interpreter/layer_param.h"
+#include "tnn/interpreter/layer_resource.h"
+#include "tnn/optimizer/graph_matcher/graph_matcher.h"
+#include "tnn/optimizer/graph_matcher/graph_parser.h"
+#include "tnn/optimizer/graph_matcher/ir.h"
+#include "tnn/optimizer/graph_matcher/logger.h"
+#include "tnn/optimizer/net_optimizer_manager.h"
+#include "tnn/optimizer/optimizer_const.h"
+
+namespace TNN_NS {
+
+namespace optimizer {
+
+    NetOptimizerRegister<NetOptimizerFuseAttention> g_net_optimizer_fuse_attention(OptPriority::P1);
+
+    std::string NetOptimizerFuseAttention::Strategy() {
+        return kNetOptimizerFuseAttention;
+    }
+
+    bool NetOptimizerFuseAttention::IsSupported(const NetworkConfig &net_config) {
+#ifdef TNN_CONVERTER_RUNTIME
+        return false;
+#else
+        return net_config.device_type == DEVICE_X86 && net_config.network_type != NETWORK_TYPE_OPENVINO;
+#endif
+    }
+
+    // pattern of the scaled dot product attention, the scale and the mask are optional,
+    // and the mask may be either input of the Add
+    static std::string AttentionPattern(const std::string &scale_type, int mask_position) {
+        std::string graph_str = mask_position < 0 ? "graph(%q, %k, %v):\n" : "graph(%q, %k, %v, %mask):\n";
+        graph_str += "    %scores = MatMul(%q, %k)\n";
+        std::string scaled = "%scores";
+        if (!scale_type.empty()) {
+            graph_str += "    %scaled = " + scale_type + "(%scores)\n";
+            scaled = "%scaled";
+        }
+        std::string logits = scaled;
+        if (mask_position == 0) {
+            graph_str += "    %masked = Add(%mask, " + scaled + ")\n";
+            logits = "%masked";
+        } else if (mask_position == 1) {
+            graph_str += "    %masked = Add(" + scaled + ", %mask)\n";
+            logits = "%masked";
+        }
+        graph_str += "    %probs = Softmax(" + logits + ")\n";
+        graph_str += "    %out = MatMul(%probs, %v)\n";
+        graph_str += "    return (%out)\n";
+        return graph_str;
+    }
+
+    // get the scale of the Div or Mul by a scalar weight
+    static bool GetAttentionScale(std::shared_ptr<Node> node, NetResource *resource, float &scale) {
+        auto param = std::dynamic_pointer_cast<MultidirBroadcastLayerParam>(node->info->param);
+        if (!param || resource->resource_map.count(node->info->name) == 0) {
+            return false;
+        }
+        // scores / weight, weight / scores is not an attention
+        if (node->info->type == LAYER_DIV && param->weight_input_index != 1) {
+            return false;
+        }
+        auto layer_resource = std::dynamic_pointer_cast<EltwiseLayerResource>(resource->resource_map.at(node->info->name));
+        if (!layer_resource || layer_resource->element_handle.GetDataCount() != 1) {
+            return false;
+        }
+        auto weight = ConvertHalfHandle(layer_resource->element_handle);
+        if (weight.GetDataType() != DATA_TYPE_FLOAT) {
+            return false;
+        }
+        float value = weight.force_to<float *>()[0];
+        if (node->info->type == LAYER_DIV) {
+            if (value == 0.f) {
+                return false;
+            }
+            value = 1.f / value;
+        }
+        scale = value;
+        return true;
+    }
+
+    // rank of a blob known before the layers are built, 0 if unknown. it is known for net inputs, constants,
+    // shapes found by constant folding and the outputs of a Reshape to a fixed shape or a Permute of a known rank
+    static int GetKnownRank(const NetStructure *structure, const NetResource *resource, const std::string &name) {
+        if (resource->blob_shapes_map.count(name) > 0) {
+            return (int)resource->blob_shapes_map.at(name).size();
+        }
+        if (structure->inputs_shape_map.count(name) > 0) {
+            return (int)structure->inputs_shape_map.at(name).size();
+        }
+        if (resource->constant_map.count(name) > 0) {
+            return (int)resource->constant_map.at(name)->GetBufferDims().size();
+        }
+        for (auto &layer : structure->layers) {
+            if (layer->outputs.size() != 1 || layer->outputs[0] != name) {
+                continue;
+            }
+            if (layer->type == LAYER_RESHAPE) {
+                auto param = std::dynamic_pointer_cast<ReshapeLayerParam>(layer->param);
+                if (param && layer->inputs.size() == 1 && param->axis == 0 && !param->shape.empty() &&
+                    (param->num_axes == -1 || param->num_axes == (int)param->shape.size())) {
+                    return (int)param->shape.size();
+                }
+            } else if (layer->type == LAYER_PERMUTE && layer->inputs.size() == 1) {
+                return GetKnownRank(structure, resource, layer->inputs[0]);
+            }
+            return 0;
+        }
+        return 0;
+    }
+
+    // rank of the softmax input, resolved from the ranks of the MatMul operands and of the mask, 0 if unknown
+    static int GetLogitsRank(const NetStructure *structure, const NetResource *resource,
+                             std::shared_ptr<Node> qk_node, std::shared_ptr<Node> scale_node,
+                             std::shared_ptr<Node> softmax_node, const std::string &mask_name) {
+        int rank = GetKnownRank(structure, resource, softmax_node->info->inputs[0]);
+        if (rank > 0 || qk_node->info->inputs.size() != 2) {
+            return rank;
+        }
+        // a MatMul of operands of rank 2 or more broadcasts their batch dims
+        for (auto &name : qk_node->info->inputs) {
+            int operand_rank = GetKnownRank(structure, resource, name);
+            if (operand_rank < 2) {
+                return 0;
+            }
+            rank = std::max(rank, operand_rank);
+        }
+        if (scale_node) {
+            auto layer_resource = std::dynamic_pointer_cast<EltwiseLayerResource>(
+                resource->resource_map.at(scale_node->info->name));
+            rank = std::max(rank, (int)layer_resource->element_shape.size());
+        }
+        if (!mask_name.empty()) {
+            int mask_rank = GetKnownRank(structure, resource, mask_name);
+            if (mask_rank == 0) {
+                return 0;
+            }
+            rank = std::max(rank, mask_rank);
+        }
+        return rank;
+    }
+
+    /*
+     * The attention of transformers lowered to
+     * graph(%q, %k, %v, %mask):
+     *      %scores = MatMul(%q, %k)
+     *      %scaled = Div(%scores)
+     *      %masked = Add(%scaled, %mask)
+     *      %probs = Softmax(%masked)
+     *      %out = MatMul(%probs, %v)
+     *      return (%out)
+     *
+     * is replaced by
+     * graph(%q, %k, %v, %mask):
+     *      %out = FusedAttention(%q, %k, %v, %mask)
+     *      return (%out)
+     *
+     * so that the scores of S_q * S_k are never materialized.
+     * */
+    Status NetOptimizerFuseAttention::Optimize(NetStructure *structure, NetResource *resource) {
+        if (!structure) {
+            LOGE("Error: empty NetStructure\n");
+            return Status(TNNERR_NET_ERR, "Error: empty NetStructure");
+        }
+
+        bool has_softmax = false;
+        for (auto &layer : structure->layers) {
+            has_softmax |= layer->type == LAYER_SOFTMAX;
+        }
+        if (!has_softmax) {
+            return TNN_OK;
+        }
+
+        std::shared_ptr<Graph> graph = std::make_shared<Graph>();
+        auto status = graph->fromInterpreted(structure, resource);
+        if (status != TNN_OK) {
+            LOGE("%s", status.description().c_str());
+            return TNN_OK;
+        }
+
+        for (std::string scale_type : {"Div", "Mul", ""}) {
+            for (int mask_position : {1, 0, -1}) {
+                GraphRegistry registry;
+                GraphParser graph_parser(&registry);
+                std::shared_ptr<Graph> pattern = nullptr;
+                if (graph_parser.parseFromString(AttentionPattern(scale_type, mask_position))) {
+                    pattern = graph_parser.getGraph();
+                } else {
+                    return Status(TNNERR_PARAM_ERR, "invalid pattern syntax.");
+                }
+                const int num_inputs = mask_position < 0 ? 3 : 4;
+
+                auto gen = [&](std::shared_ptr<AnchorGraph> in) -> std::shared_ptr<Graph> {
+                    if (in->inputs().size() != (size_t)num_inputs || in->outputs().size() != 1) {
+                        return nullptr;
+                    }
+
+                    auto qk_node      = in->getNodeByTensorName(std::string("@scores"));
+                    auto softmax_node = in->getNodeByTensorName(std::string("@probs"));
+                    auto pv_node      = in->getNodeByTensorName(std::string("@out"));
+                    if (!qk_node || !softmax_node || !pv_node) {
+                        WARN("node of interest not found in fuse attention optimizer");
+                        return nullptr;
+                    }
+
+                    float scale = 1.f;
+                    std::shared_ptr<Node> scale_node = nullptr;
+                    if (!scale_type.empty()) {
+                        scale_node = in->getNodeByTensorName(std::string("@scaled"));
+                        if (!scale_node || !GetAttentionScale(scale_node, resource, scale)) {
+                            DEBUG("the scale of attention: %s is not a scalar", qk_node->name().c_str());
+                            return nullptr;
+                        }
+                    }
+
+                    // FusedAttention normalizes over the last axis, a positive axis is known to be the
+                    // last one only if the rank of the scores is known. the batch dims of q, k, v and the
+                    // mask may broadcast, FusedAttention supports that like MatMul and Add do.
+                    auto softmax_param = std::dynamic_pointer_cast<SoftmaxLayerParam>(softmax_node->info->param);
+                    if (!softmax_param) {
+                        return nullptr;
+                    }
+                    if (softmax_param->axis != -1) {
+                        std::string mask_name = "";
+                        if (mask_position >= 0) {
+                            auto mask_node = in->getNodeByTensorName(std::string("@masked"));
+                            if (!mask_node || mask_node->info->inputs.size() != 2) {
+                                return nullptr;
+                            }
+                            mask_name = mask_node->info->inputs[mask_position];
+                        }
+                        int rank = GetLogitsRank(structure, resource, qk_node, scale_node, softmax_node, mask_name);
+                        if (rank == 0 || softmax_param->axis != rank - 1) {
+                            DEBUG("softmax: %s is not known to be over the last axis", softmax_node->name().c_str());
+                            return nullptr;
+                        }
+                    }
+
+                    INFO("found attention at Node:%s", qk_node->name().c_str());
+
+                    auto g = std::make_shared<Graph>();
+                    std::vector<std::string> in_names = {"q", "k", "v"};
+                    if (mask_position >= 0) {
+                        in_names.push_back("mask");
+                    }
+                    for (auto &name : in_names) {
+                        g->getNodeOrCreatePlaceHolder(name);
+                    }
+
+                    const std::string out_name = pv_node->info->name + "_fused_attention";
+                    CREATE_NODE(new_node, g, LAYER_FUSED_ATTENTION, in_names, {out_name});
+                    RETURN_VALUE_ON_NEQ(new_node->createParam<FusedAttentionLayerParam>(), TNN_OK, nullptr);
+                    new_node->param<FusedAttentionLayerParam>()->scale = scale;
+
+                    return g;
+                };
+
+                RETURN_ON_FAIL(graph->rewrite(pattern, gen));
+            }
+        }
+
+        return TNN_OK;
+    }
+
+}  // namespace optimizer
+
+}  // namespace TNN_NS
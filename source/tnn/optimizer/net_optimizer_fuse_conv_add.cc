@@ -23,6 +23,7 @@
 #include "tnn/optimizer/net_optimizer_fuse_conv_post.h"
 #include "tnn/optimizer/net_optimizer_manager.h"
 #include "tnn/optimizer/optimizer_const.h"
+#include "tnn/utils/dims_utils.h"
 
 namespace TNN_NS {
 
@@ -40,16 +41,7 @@ namespace optimizer {
         return false;
 #else
         auto device = net_config.device_type;
-        if (device == DEVICE_ARM || device == DEVICE_NAIVE || device == DEVICE_X86) {
-            auto conv_post_optimizer = NetOptimizerManager::GetNetOptimizerByName(kNetOptimizerFuseConvPost);
-            if (conv_post_optimizer && conv_post_optimizer->IsSupported(net_config)) {
-                conv_post_opt_ = conv_post_optimizer;
-            } else {
-                conv_post_opt_ = nullptr;
-            }
-            return true;
-        }
-        return false;
+        return device == DEVICE_ARM || device == DEVICE_NAIVE || device == DEVICE_X86;
 #endif
     }
 
@@ -72,28 +64,68 @@ namespace optimizer {
         return (layer_info->type == LAYER_ADD && layer_info->param->quantized);
     }
 
-    static bool NeedConvAddFusion(std::shared_ptr<LayerInfo> prev, std::shared_ptr<LayerInfo> current) {
+    static bool IsFloatLayersSupportFusion(std::shared_ptr<LayerInfo> prev, std::shared_ptr<LayerInfo> current,
+                                           NetResource *resource) {
+        auto param = dynamic_cast<ConvLayerParam *>(prev->param.get());
+        if (!param || param->quantized || prev->type != LAYER_CONVOLUTION || param->fusion_type != FusionType_None) {
+            return false;
+        }
+        // add of two blobs, the one other than the conv output is the residual
+        if (current->type != LAYER_ADD || current->param->quantized || current->inputs.size() != 2 ||
+            current->inputs[0] == current->inputs[1]) {
+            return false;
+        }
+        // a residual known to be broadcast stays a separate add, the conv expands unknown ones at forward
+        if (!resource) {
+            return true;
+        }
+        auto &shapes_map = resource->blob_shapes_map;
+        for (const auto &name : current->inputs) {
+            if (name != prev->outputs[0] && shapes_map.count(name) > 0 && shapes_map.count(prev->outputs[0]) > 0 &&
+                !DimsVectorUtils::Equal(shapes_map[name], shapes_map[prev->outputs[0]])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static bool NeedConvAddFusion(std::shared_ptr<LayerInfo> prev, std::shared_ptr<LayerInfo> current,
+                                  NetResource *resource, bool fuse_float) {
+        if (fuse_float && IsFloatLayersSupportFusion(prev, current, resource)) {
+            return true;
+        }
         return (IsPreviousLayerSupportFusion(prev) && IsCurrentLayerSupportFusion(current));
     }
 
     Status NetOptimizerFuseConvAdd::Optimize(NetStructure *structure, NetResource *resource) {
+        return Optimize(structure, resource, NetworkConfig());
+    }
+
+    Status NetOptimizerFuseConvAdd::Optimize(NetStructure *structure, NetResource *resource,
+                                             const NetworkConfig &net_config) {
         auto ret = Status(TNN_OK);
         if (!structure) {
             LOGE("Error: empty NetStructure\n");
             return Status(TNNERR_NET_ERR, "Error: empty NetStructure");
         }
 
-        // Only fuse quantized network now
+        // Only fuse quantized network now, and float conv on x86, the add runs in the conv epilogue
         auto is_quantized_net = GetQuantizedInfoFromNetStructure(structure);
-        if (!is_quantized_net) {
+        const bool fuse_float = net_config.device_type == DEVICE_X86 &&
+                                net_config.network_type != NETWORK_TYPE_OPENVINO;
+        if (!is_quantized_net && !fuse_float) {
             return TNN_OK;
         }
         if (structure->layers.size() <= 1) {
             return TNN_OK;
         }
         // step1: do conv_post fusion before conv_add fusion
-        if (conv_post_opt_) {
-            ret = conv_post_opt_->Optimize(structure, resource);
+        auto conv_post_opt = NetOptimizerManager::GetNetOptimizerByName(kNetOptimizerFuseConvPost);
+        if (conv_post_opt && !conv_post_opt->IsSupported(net_config)) {
+            conv_post_opt = nullptr;
+        }
+        if (conv_post_opt) {
+            ret = conv_post_opt->Optimize(structure, resource, net_config);
             if (ret != TNN_OK) {
                 return ret;
             }
@@ -113,7 +145,7 @@ namespace optimizer {
             auto layer_info_current = layers_orig[index];
             auto layer_info_prev    = layers_orig[index - 1];
             auto conv_param = dynamic_cast<ConvLayerParam *>(layer_info_prev->param.get());
-            if (NeedConvAddFusion(layer_info_prev, layer_info_current)) {
+            if (NeedConvAddFusion(layer_info_prev, layer_info_current, resource, fuse_float)) {
                 auto conv_output_name   = layer_info_prev->outputs[0];
                 auto conv_inputs        = layer_info_prev->inputs;
                 // inputs of add should contain conv_outputs, and others are pushed back to conv_inputs
@@ -125,8 +157,8 @@ namespace optimizer {
                         is_add_after_conv = true;
                     }
                 }
-                // outputs of conv cannot be inputs of other layeres except add
-                bool is_input_of_others = false;
+                // outputs of conv cannot be inputs of other layeres except add, nor outputs of the net
+                bool is_input_of_others = structure->outputs.count(conv_output_name) > 0;
                 for (int next = index + 1; next < count; next++) {
                     auto layer_info_next = layers_orig[next];
                     for (auto input_next : layer_info_next->inputs) {
@@ -158,8 +190,8 @@ namespace optimizer {
         structure->layers = layers_fused;
 
         // step3: do conv_post fusion after conv_add fusion
-        if (conv_post_opt_) {
-            ret = conv_post_opt_->Optimize(structure, resource);
+        if (conv_post_opt) {
+            ret = conv_post_opt->Optimize(structure, resource, net_config);
         }
 
         return ret;
@@ -33,8 +33,7 @@ namespace optimizer {
         virtual std::string Strategy();
         virtual bool IsSupported(const NetworkConfig &net_config);
         virtual Status Optimize(NetStructure *structure, NetResource *resource);
-    private:
-        std::shared_ptr<NetOptimizer> conv_post_opt_ = nullptr;
+        virtual Status Optimize(NetStructure *structure, NetResource *resource, const NetworkConfig &net_config);
     };
 
 }  // namespace optimizer
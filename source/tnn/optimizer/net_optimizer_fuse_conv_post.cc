@@ -14,6 +14,7 @@
 
 #include "tnn/optimizer/net_optimizer_fuse_conv_post.h"
 
+#include <cmath>
 #include <map>
 #include <memory>
 #include <vector>
@@ -34,28 +35,55 @@ namespace optimizer {
         return kNetOptimizerFuseConvPost;
     }
 
-    bool NetOptimizerFuseConvPost::IsSupported(const NetworkConfig &net_config) {
-        auto device = net_config.device_type;
+    // activations other than relu and relu6 are fused into float 2d conv only on x86 (conv_epilogue_only),
+    // and a sigmoid not followed by mul is fused as ActivationType_SIGMOID
+    static bool GetFusionActivations(const NetworkConfig &net_config,
+                                     std::map<LayerType, ActivationType> &layer_activation_map,
+                                     bool &conv_epilogue_only) {
+        auto device        = net_config.device_type;
+        conv_epilogue_only = false;
         if (device == DEVICE_METAL || device == DEVICE_OPENCL || device == DEVICE_ARM || device == DEVICE_NAIVE) {
-            kLayerActivationMap[LAYER_RELU]    = ActivationType_ReLU;
-            kLayerActivationMap[LAYER_RELU6]   = ActivationType_ReLU6;
-            kLayerActivationMap[LAYER_SIGMOID] = ActivationType_SIGMOID_MUL;
-            kLayerActivationMap[LAYER_SWISH]   = ActivationType_SIGMOID_MUL;
+            layer_activation_map[LAYER_RELU]    = ActivationType_ReLU;
+            layer_activation_map[LAYER_RELU6]   = ActivationType_ReLU6;
+            layer_activation_map[LAYER_SIGMOID] = ActivationType_SIGMOID_MUL;
+            layer_activation_map[LAYER_SWISH]   = ActivationType_SIGMOID_MUL;
             return true;
         }
         if (device == DEVICE_RK_NPU) {
-            kLayerActivationMap[LAYER_RELU] = ActivationType_ReLU;
+            layer_activation_map[LAYER_RELU] = ActivationType_ReLU;
             return true;
         }
         if (device == DEVICE_X86 && net_config.network_type != NETWORK_TYPE_OPENVINO) {
-            kLayerActivationMap[LAYER_RELU]  = ActivationType_ReLU;
-            kLayerActivationMap[LAYER_RELU6] = ActivationType_ReLU6;
+            layer_activation_map[LAYER_RELU]      = ActivationType_ReLU;
+            layer_activation_map[LAYER_RELU6]     = ActivationType_ReLU6;
+            layer_activation_map[LAYER_SIGMOID]   = ActivationType_SIGMOID_MUL;
+            layer_activation_map[LAYER_SWISH]     = ActivationType_SIGMOID_MUL;
+            layer_activation_map[LAYER_HARDSWISH] = ActivationType_HARDSWISH;
+            layer_activation_map[LAYER_GELU]      = ActivationType_GELU;
+            conv_epilogue_only                    = true;
             return true;
         }
         return false;
     }
 
+    bool NetOptimizerFuseConvPost::IsSupported(const NetworkConfig &net_config) {
+        std::map<LayerType, ActivationType> layer_activation_map;
+        bool conv_epilogue_only = false;
+        return GetFusionActivations(net_config, layer_activation_map, conv_epilogue_only);
+    }
+
     Status NetOptimizerFuseConvPost::Optimize(NetStructure *structure, NetResource *resource) {
+        return Optimize(structure, resource, NetworkConfig());
+    }
+
+    Status NetOptimizerFuseConvPost::Optimize(NetStructure *structure, NetResource *resource,
+                                              const NetworkConfig &net_config) {
+        std::map<LayerType, ActivationType> layer_activation_map;
+        bool conv_epilogue_only = false;
+        if (!GetFusionActivations(net_config, layer_activation_map, conv_epilogue_only)) {
+            return TNN_OK;
+        }
+
         if (!structure) {
             LOGE("Error: empty NetStructure\n");
             return Status(TNNERR_NET_ERR, "Error: empty NetStructure");
@@ -76,11 +104,27 @@ namespace optimizer {
             auto layer_current_type = layer_info_current->type;
 
             auto conv_param = dynamic_cast<ConvLayerParam *>(layer_info_prev->param.get());
-            auto activation = kLayerActivationMap.find(layer_current_type);
-            if (conv_param && activation != kLayerActivationMap.end()) {
+            auto activation = layer_activation_map.find(layer_current_type);
+            if (conv_param && activation != layer_activation_map.end()) {
                 auto conv_output_name       = layer_info_prev->outputs[0];
                 auto activation_type        = activation->second;
                 bool conv_output_name_check = false;
+                if (conv_epilogue_only && activation_type != ActivationType_ReLU &&
+                    activation_type != ActivationType_ReLU6 &&
+                    (layer_info_prev->type != LAYER_CONVOLUTION || conv_param->quantized)) {
+                    layers_fused.push_back(layer_info_current);
+                    continue;
+                }
+                if (activation_type == ActivationType_HARDSWISH) {
+                    // only the hardswish of x * relu6(x + 3) / 6
+                    auto hardswish_param = dynamic_cast<HardSwishLayerParam *>(layer_info_current->param.get());
+                    if (!hardswish_param || layer_info_current->inputs.size() != 1 ||
+                        std::fabs(hardswish_param->alpha - 1.0f / 6.0f) > 1e-6f ||
+                        std::fabs(hardswish_param->beta - 0.5f) > 1e-6f) {
+                        layers_fused.push_back(layer_info_current);
+                        continue;
+                    }
+                }
                 if (activation_type == ActivationType_SIGMOID_MUL && layer_current_type == LAYER_SIGMOID) {
                     auto sigmoid_output_name = layer_info_current->outputs[0];
                     if (index + 1 < count) {
@@ -94,6 +138,10 @@ namespace optimizer {
                             conv_output_name_check = true;
                         }
                     }
+                    if (!conv_output_name_check && conv_epilogue_only) {
+                        activation_type        = ActivationType_SIGMOID;
+                        conv_output_name_check = true;
+                    }
                 } else {
                     conv_output_name_check = true;
                 }
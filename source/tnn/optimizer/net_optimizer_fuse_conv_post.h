@@ -33,8 +33,7 @@ namespace optimizer {
         virtual std::string Strategy();
         virtual bool IsSupported(const NetworkConfig &net_config);
         virtual Status Optimize(NetStructure *structure, NetResource *resource);
-    private:
-        std::map<LayerType, ActivationType> kLayerActivationMap;
+        virtual Status Optimize(NetStructure *structure, NetResource *resource, const NetworkConfig &net_config);
     };
 
 }  // namespace optimizer
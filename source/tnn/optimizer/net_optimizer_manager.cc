@@ -37,7 +37,7 @@ namespace optimizer {
         for (auto iter : NetOptimizerManager::GetNetOptimizerSeq()) {
             auto optimizer = optimizer_map[iter.second];
             if (optimizer->IsSupported(net_config)) {
-                auto status = optimizer->Optimize(structure, resource);
+                auto status = optimizer->Optimize(structure, resource, net_config);
                 if (status != TNN_OK) {
                     return status;
                 }
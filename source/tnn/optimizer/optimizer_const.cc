@@ -54,4 +54,7 @@ const char * kNetOptimizerDynamicRangeDequant =
 const char * kNetOptimizerConvertMatMulToConv =
     "net_optimizer_convert_matmul_to_conv";
 
+const char * kNetOptimizerFuseAttention =
+    "net_optimizer_fuse_attention";
+
 }  // namespace TNN_NS
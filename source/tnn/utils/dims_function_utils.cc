@@ -14,6 +14,7 @@
 
 #include "tnn/utils/dims_function_utils.h"
 #include "tnn/utils/dims_vector_utils.h"
+#include "tnn/utils/dims_offset_utils.h"
 
 
 #include <cmath>
@@ -39,7 +40,7 @@ DimsVector DimsFunctionUtils::Expand(DimsVector dims0, DimsVector dims1, Status
             if (min_dims[i] > output_dims[offset + i]) {
                 output_dims[offset + i] = min_dims[i];
             }
-        } else if (max_dims[offset + i] != min_dims[i]) {
+        } else if (min_dims[i] != 1 && max_dims[offset + i] != min_dims[i]) {
             if (status) {
                 *status = Status(TNNERR_PARAM_ERR, "expand param dims error");
             }
@@ -297,6 +298,22 @@ DimsVector DimsFunctionUtils::ModIndex(DimsVector index, const DimsVector shape)
     return index;
 }
 
+std::vector<int> DimsFunctionUtils::BroadcastMatrixOffsets(DimsVector dims, const DimsVector batch_dims) {
+    while (dims.size() < batch_dims.size() + 2) {
+        dims.insert(dims.begin(), 1);
+    }
+    const int plane = dims[dims.size() - 2] * dims[dims.size() - 1];
+    DimsVector input_batch_dims(dims.begin(), dims.end() - 2);
+
+    std::vector<int> offsets;
+    const int batch = DimsVectorUtils::Count(batch_dims);
+    for (int b = 0; b < batch; b++) {
+        auto index = ModIndex(DimsOffsetUtils::ConvertOffsetToIndex(batch_dims, b), input_batch_dims);
+        offsets.push_back(DimsOffsetUtils::ConvertIndexToOffset(input_batch_dims, index) * plane);
+    }
+    return offsets;
+}
+
 int DimsFunctionUtils::GetDim(const DimsVector dims, const int index) {
     return dims.size() > index ? dims[index] : 1;
 }
@@ -82,6 +82,10 @@ public:
 
     static DimsVector ModIndex(DimsVector index, const DimsVector shape);
 
+    // @brief offset of the matrix of a batched matmul operand for each matrix of the output,
+    // the batch dims of dims broadcast to batch_dims like those of MatMul
+    static std::vector<int> BroadcastMatrixOffsets(DimsVector dims, const DimsVector batch_dims);
+
     // @brief Get dim in dims vector, if index is larger than dims size, return 1
     static int GetDim(const DimsVector dims, const int index); 
 
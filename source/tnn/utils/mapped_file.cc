@@ -0,0 +1,121 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "tnn/utils/mapped_file.h"
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#undef LoadLibrary
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace TNN_NS {
+
+#if defined(_WIN32)
+
+MappedFile::~MappedFile() {
+    if (data_) {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_handle_) {
+        CloseHandle((HANDLE)mapping_handle_);
+    }
+    if (file_handle_ && file_handle_ != INVALID_HANDLE_VALUE) {
+        CloseHandle((HANDLE)file_handle_);
+    }
+}
+
+Status MappedFile::Open(const std::string &path, std::shared_ptr<MappedFile> &mapped_file) {
+    std::shared_ptr<MappedFile> file(new MappedFile());
+    file->file_handle_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                                     FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file->file_handle_ == INVALID_HANDLE_VALUE) {
+        LOGE("MappedFile open %s failed\n", path.c_str());
+        return Status(TNNERR_INVALID_MODEL, "open model file failed");
+    }
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx((HANDLE)file->file_handle_, &file_size)) {
+        return Status(TNNERR_INVALID_MODEL, "get model file size failed");
+    }
+    file->size_ = (size_t)file_size.QuadPart;
+    if (file->size_ > 0) {
+        file->mapping_handle_ = CreateFileMappingA((HANDLE)file->file_handle_, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (!file->mapping_handle_) {
+            LOGE("MappedFile map %s failed\n", path.c_str());
+            return Status(TNNERR_INVALID_MODEL, "map model file failed");
+        }
+        file->data_ = (char *)MapViewOfFile((HANDLE)file->mapping_handle_, FILE_MAP_READ, 0, 0, 0);
+        if (!file->data_) {
+            LOGE("MappedFile map %s failed\n", path.c_str());
+            return Status(TNNERR_INVALID_MODEL, "map model file failed");
+        }
+    }
+    mapped_file = file;
+    return TNN_OK;
+}
+
+#else
+
+MappedFile::~MappedFile() {
+    if (data_) {
+        munmap(data_, size_);
+    }
+}
+
+Status MappedFile::Open(const std::string &path, std::shared_ptr<MappedFile> &mapped_file) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        LOGE("MappedFile open %s failed\n", path.c_str());
+        return Status(TNNERR_INVALID_MODEL, "open model file failed");
+    }
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0) {
+        close(fd);
+        return Status(TNNERR_INVALID_MODEL, "get model file size failed");
+    }
+
+    std::shared_ptr<MappedFile> file(new MappedFile());
+    file->size_ = (size_t)file_stat.st_size;
+    if (file->size_ > 0) {
+        void *data = mmap(nullptr, file->size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            LOGE("MappedFile map %s failed\n", path.c_str());
+            return Status(TNNERR_INVALID_MODEL, "map model file failed");
+        }
+        file->data_ = (char *)data;
+    }
+    // the mapping stays valid after the descriptor is closed
+    close(fd);
+
+    mapped_file = file;
+    return TNN_OK;
+}
+
+#endif
+
+char *MappedFile::GetData() const {
+    return data_;
+}
+
+size_t MappedFile::GetSize() const {
+    return size_;
+}
+
+}  // namespace TNN_NS
@@ -0,0 +1,54 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef TNN_SOURCE_TNN_UTILS_MAPPED_FILE_H_
+#define TNN_SOURCE_TNN_UTILS_MAPPED_FILE_H_
+
+#include <memory>
+#include <string>
+
+#include "tnn/core/macro.h"
+#include "tnn/core/status.h"
+
+namespace TNN_NS {
+
+// @brief MappedFile maps a whole file into memory, pages are read by the os on first access.
+// The mapping is read only, buffers sharing it must not be written: layers transforming
+// their weights write them to buffers of their own.
+class MappedFile {
+public:
+    ~MappedFile();
+
+    // @brief map the file, the mapping lives as long as the returned object
+    static Status Open(const std::string &path, std::shared_ptr<MappedFile> &mapped_file);
+
+    char *GetData() const;
+    size_t GetSize() const;
+
+private:
+    MappedFile() = default;
+    MappedFile(const MappedFile &)            = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    char *data_  = nullptr;
+    size_t size_ = 0;
+#if defined(_WIN32)
+    void *file_handle_    = nullptr;
+    void *mapping_handle_ = nullptr;
+#endif
+};
+
+}  // namespace TNN_NS
+
+#endif  // TNN_SOURCE_TNN_UTILS_MAPPED_FILE_H_
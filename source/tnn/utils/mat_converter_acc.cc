@@ -17,9 +17,47 @@
 #include "tnn/utils/blob_converter.h"
 
 #include "tnn/utils/mat_converter_acc.h"
+#include "tnn/utils/dims_utils.h"
 
 namespace TNN_NS {
 
+Status MatConverterAcc::Preprocess(Mat& src, Blob* blob, PreprocessParam param, void* command_queue) {
+    Mat mat = src;
+    if (mat.GetMatType() == NNV12 || mat.GetMatType() == NNV21) {
+        DimsVector dims = mat.GetDims();
+        dims[1]         = 3;
+        Mat bgr(mat.GetDeviceType(), N8UC3, dims);
+        auto type = mat.GetMatType() == NNV12 ? COLOR_CONVERT_NV12TOBGR : COLOR_CONVERT_NV21TOBGR;
+        RETURN_ON_NEQ(CvtColor(mat, bgr, type, command_queue), TNN_OK);
+        mat = bgr;
+    }
+
+    if (param.crop.top_left_x != 0 || param.crop.top_left_y != 0 || param.crop.width != mat.GetWidth() ||
+        param.crop.height != mat.GetHeight()) {
+        DimsVector dims = {mat.GetBatch(), mat.GetChannel(), param.crop.height, param.crop.width};
+        Mat cropped(mat.GetDeviceType(), mat.GetMatType(), dims);
+        RETURN_ON_NEQ(Crop(mat, cropped, param.crop, command_queue), TNN_OK);
+        mat = cropped;
+    }
+
+    const auto& blob_dims = blob->GetBlobDesc().dims;
+    const int height      = DimsFunctionUtils::GetDim(blob_dims, 2);
+    const int width       = DimsFunctionUtils::GetDim(blob_dims, 3);
+    if (mat.GetHeight() != height || mat.GetWidth() != width) {
+        DimsVector dims = {mat.GetBatch(), mat.GetChannel(), height, width};
+        Mat resized(mat.GetDeviceType(), mat.GetMatType(), dims);
+        ResizeParam resize_param;
+        resize_param.scale_w = width * 1.0 / mat.GetWidth();
+        resize_param.scale_h = height * 1.0 / mat.GetHeight();
+        resize_param.type    = param.interp_type;
+        RETURN_ON_NEQ(Resize(mat, resized, resize_param, command_queue), TNN_OK);
+        mat = resized;
+    }
+
+    BlobConverter converter(blob);
+    return converter.ConvertFromMat(mat, param.convert_param, command_queue);
+}
+
 std::shared_ptr<MatConverterManager>& MatConverterManager::Shared() {
     static std::once_flag once;
     static std::shared_ptr<MatConverterManager> g_global_blob_converter_manager;
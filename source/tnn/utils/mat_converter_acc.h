@@ -38,6 +38,8 @@ public:
     virtual Status WarpAffine(Mat& src, Mat& dst, WarpAffineParam param, void* command_queue = NULL)         = 0;
     virtual Status CvtColor(Mat& src, Mat& dst, ColorConversionType type, void* command_queue = NULL)        = 0;
     virtual Status CopyMakeBorder(Mat& src, Mat& dst, CopyMakeBorderParam param, void* command_queue = NULL) = 0;
+    // default runs CvtColor, Crop, Resize and BlobConverter::ConvertFromMat in turn
+    virtual Status Preprocess(Mat& src, Blob* blob, PreprocessParam param, void* command_queue = NULL);
 };
 
 class MatConverterAccCreater {
@@ -213,6 +213,39 @@ Status MatUtils::CopyMakeBorder(Mat& src, Mat& dst, CopyMakeBorderParam param, v
     return converter->CopyMakeBorder(src, dst, param, command_queue);
 }
 
+Status MatUtils::Preprocess(Mat& src, Blob* blob, PreprocessParam param, void* command_queue) {
+    if (blob == nullptr) {
+        return Status(TNNERR_NULL_PARAM, "blob is null");
+    }
+    if (src.GetData() == nullptr || src.GetWidth() <= 0 || src.GetHeight() <= 0) {
+        return Status(TNNERR_INVALID_INPUT, "src is empty or src size is zero or negnative");
+    }
+
+    const auto& dims = blob->GetBlobDesc().dims;
+    if (dims.size() != 4 || dims[2] <= 0 || dims[3] <= 0) {
+        return Status(TNNERR_PARAM_ERR, "blob dims must be nchw with positive height and width");
+    }
+    if (src.GetBatch() != dims[0]) {
+        return Status(TNNERR_PARAM_ERR, "src and blob batch not equal");
+    }
+
+    auto& crop = param.crop;
+    if (crop.width <= 0 || crop.height <= 0) {
+        crop.width  = src.GetWidth() - crop.top_left_x;
+        crop.height = src.GetHeight() - crop.top_left_y;
+    }
+    if (crop.top_left_x < 0 || crop.top_left_y < 0 || crop.width <= 0 || crop.height <= 0 ||
+        crop.top_left_x + crop.width > src.GetWidth() || crop.top_left_y + crop.height > src.GetHeight()) {
+        return Status(TNNERR_PARAM_ERR, "crop region is out of src");
+    }
+
+    auto converter = MatConverterManager::Shared()->CreateMatConverterAcc(blob->GetBlobDesc().device_type);
+    if (!converter) {
+        return Status(TNNERR_INIT_LAYER, "image converter is nil, check device type");
+    }
+    return converter->Preprocess(src, blob, param, command_queue);
+}
+
 #undef CHECK_DST_DATA_NULL
 #undef MAT_CONVERTER_PREPARATION
 
@@ -24,7 +24,7 @@
 #include "tnn/utils/bbox_util.h"
 #include "tnn/utils/bfp16.h"
 #include "tnn/utils/dims_utils.h"
-#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/parallel_for.h"
 #include "tnn/utils/half_utils_inner.h"
 
 namespace TNN_NS {
@@ -274,8 +274,7 @@ void NaiveFC(T *input_ptr, T *output_ptr, T *weight_data, float *bias, DimsVecto
     for (int n = 0; n < dims_output[0]; ++n) {
         T *in_current_batch = input_ptr + n * ip_dim_in;
         T *ou_current_batch = output_ptr + n * dims_output[1];
-        OMP_PARALLEL_FOR_
-        for (int oc = 0; oc < dims_output[1]; ++oc) {
+        ParallelFor(0, dims_output[1], [&](int oc) {
             float acc = 0;
             for (int ic = 0; ic < ip_dim_in; ++ic) {
                 acc += float(static_cast<T *>(weight_data)[oc * ip_dim_in + ic]) * float(in_current_batch[ic]);
@@ -283,7 +282,7 @@ void NaiveFC(T *input_ptr, T *output_ptr, T *weight_data, float *bias, DimsVecto
             if (bias)
                 acc += bias[oc];
             ou_current_batch[oc] = acc;
-        }
+        });
     }
 }
 
@@ -300,8 +299,7 @@ void NaiveFC(void *input_ptr, void *output_ptr, void *weight_data, float *scale,
     for (int n = 0; n < dims_output[0]; ++n) {
         int8_t *in_current_batch = static_cast<int8_t *>(input_ptr) + n * ip_dim_in;
         int8_t *ou_current_batch = static_cast<int8_t *>(output_ptr) + n * dims_output[1];
-        OMP_PARALLEL_FOR_
-        for (int oc = 0; oc < dims_output[1]; ++oc) {
+        ParallelFor(0, dims_output[1], [&](int oc) {
             float cur_scale = scale_len == 1 ? scale[0] : scale[oc];
             int32_t acc     = 0;
             for (int ic = 0; ic < ip_dim_in; ++ic) {
@@ -310,7 +308,7 @@ void NaiveFC(void *input_ptr, void *output_ptr, void *weight_data, float *scale,
             if (bias)
                 acc += static_cast<int32_t *>(bias)[oc];
             ou_current_batch[oc] = float2int8(acc * cur_scale);
-        }
+        });
     }
 }
 void NaiveFCBias(void *input_ptr, void *output_ptr, void *weight_data, float *scale, int scale_len, void *bias,
@@ -324,8 +322,7 @@ void NaiveFCBias(void *input_ptr, void *output_ptr, void *weight_data, float *sc
     for (int n = 0; n < dims_output[0]; ++n) {
         int8_t *in_current_batch = static_cast<int8_t *>(input_ptr) + n * ip_dim_in;
         int8_t *ou_current_batch = static_cast<int8_t *>(output_ptr) + n * dims_output[1];
-        OMP_PARALLEL_FOR_
-        for (int oc = 0; oc < dims_output[1]; ++oc) {
+        ParallelFor(0, dims_output[1], [&](int oc) {
             float cur_scale         = scale_len == 1 ? scale[0] : scale[oc];
             float cur_bias_output   = zero_point_len_o == 1 ? zero_point_handle_o[0] : zero_point_handle_o[oc];
             int8_t cur_zero_point_w = zero_point_len_w == 1 ? zero_point_handle_w[0] : zero_point_handle_w[oc];
@@ -342,7 +339,7 @@ void NaiveFCBias(void *input_ptr, void *output_ptr, void *weight_data, float *sc
             if (bias)
                 acc += static_cast<int32_t *>(bias)[oc];
             ou_current_batch[oc] = float2int8(acc * cur_scale + cur_bias_output);
-        }
+        });
     }
 }
 
@@ -358,6 +355,14 @@ void FloatActivate(Tacc &result, const int activation_type) {
         }
     } else if(activation_type == ActivationType_SIGMOID_MUL) {
         result = 1.0f / (1.0f + exp(-result)) * result;
+    } else if (activation_type == ActivationType_SIGMOID) {
+        result = static_cast<Tacc>(1.0f / (1.0f + exp(-result)));
+    } else if (activation_type == ActivationType_HARDSWISH) {
+        float value = static_cast<float>(result);
+        result      = static_cast<Tacc>(value * std::min(std::max(value + 3.0f, 0.0f), 6.0f) / 6.0f);
+    } else if (activation_type == ActivationType_GELU) {
+        float value = static_cast<float>(result);
+        result      = static_cast<Tacc>(0.5f * value * (erff(value * 0.707106793288165f) + 1.0f));
     }
 }
 
@@ -377,8 +382,7 @@ void NaiveConv1D(void *input_ptr, void *output_ptr, void *weight_ptr, void *bias
     int output_channels_per_group = output_channel / group;
     int input_channels_per_group  = input_channel / group;
 
-    OMP_PARALLEL_FOR_
-    for (int n = 0; n < number; ++n) {
+    ParallelFor(0, number, [&](int n) {
         for (int g = 0; g < group; ++g) {
             int output_c_start = g * output_channels_per_group;
             int output_c_end   = (g + 1) * output_channels_per_group;
@@ -431,7 +435,7 @@ void NaiveConv1D(void *input_ptr, void *output_ptr, void *weight_ptr, void *bias
                 }
             }
         }
-    }
+    });
 }
 
 template void NaiveConv1D<float, float, float, float>(void *input_ptr, void *output_ptr, void *weight_ptr, void *bias,
@@ -464,8 +468,7 @@ void NaiveConv(void *input_ptr, void *output_ptr, void *weight_ptr, void *bias,
     int output_channels_per_group = output_channel / group;
     int input_channels_per_group  = input_channel / group;
 
-    OMP_PARALLEL_FOR_
-    for (int n = 0; n < number; ++n) {
+    ParallelFor(0, number, [&](int n) {
         for (int g = 0; g < group; ++g) {
             int output_c_start = g * output_channels_per_group;
             int output_c_end   = (g + 1) * output_channels_per_group;
@@ -510,7 +513,13 @@ void NaiveConv(void *input_ptr, void *output_ptr, void *weight_ptr, void *bias,
                             result += bias_data[output_c];
                         }
                         if (sizeof(Tin) > 1) {  // float
+                            if (add_input && fusion_type == FusionType_Conv_Add_Activation) {
+                                result += static_cast<Tout *>(add_input)[output_position];
+                            }
                             FloatActivate(result, activation_type);
+                            if (add_input && fusion_type == FusionType_Conv_Activation_Add) {
+                                result += static_cast<Tout *>(add_input)[output_position];
+                            }
                             output_data[output_position] = result;
                         } else {
                             int scale_idx = weight_scale_len == 1 ? 0 : output_c;
@@ -536,7 +545,7 @@ void NaiveConv(void *input_ptr, void *output_ptr, void *weight_ptr, void *bias,
                 }
             }
         }
-    }
+    });
 }
 template <typename Tin, typename Tw, typename Tacc, typename Tout>
 void NaiveConvBias(void *input_ptr, void *output_ptr, void *weight_ptr, void *bias, DimsVector dims_input,
@@ -564,8 +573,7 @@ void NaiveConvBias(void *input_ptr, void *output_ptr, void *weight_ptr, void *bi
     Tacc *buffer_weight_x_bias    = static_cast<Tacc *>(weight_x_bias_ptr);
     Tin *add_bias_i               = static_cast<Tin *>(add_bias_input);
 
-    OMP_PARALLEL_FOR_
-    for (int n = 0; n < number; ++n) {
+    ParallelFor(0, number, [&](int n) {
         for (int g = 0; g < group; ++g) {
             int output_c_start = g * output_channels_per_group;
             int output_c_end   = (g + 1) * output_channels_per_group;
@@ -653,7 +661,7 @@ void NaiveConvBias(void *input_ptr, void *output_ptr, void *weight_ptr, void *bi
                 }
             }
         }
-    }
+    });
 }
 template <typename Tin, typename Tw, typename Tacc, typename Tout>
 void NaiveConvBias(void *input_ptr, void *output_ptr, void *weight_ptr, void *bias, DimsVector dims_input,
@@ -680,8 +688,7 @@ void NaiveConvBias(void *input_ptr, void *output_ptr, void *weight_ptr, void *bi
     Tout *zero_point_handle_o     = static_cast<Tout *>(zero_point_o_ptr);
     Tin *add_bias_i               = static_cast<Tin *>(add_bias_input);
 
-    OMP_PARALLEL_FOR_
-    for (int n = 0; n < number; ++n) {
+    ParallelFor(0, number, [&](int n) {
         for (int g = 0; g < group; ++g) {
             int output_c_start = g * output_channels_per_group;
             int output_c_end   = (g + 1) * output_channels_per_group;
@@ -763,7 +770,7 @@ void NaiveConvBias(void *input_ptr, void *output_ptr, void *weight_ptr, void *bi
                 }
             }
         }
-    }
+    });
 }
 
 template void NaiveConvBias<int8_t, int8_t, int32_t, int8_t>(
@@ -831,8 +838,7 @@ void NaiveConv3D(void *input_ptr, void *output_ptr, void *weight_ptr, void *bias
     int output_channels_per_group = output_channel / group;
     int input_channels_per_group  = input_channel / group;
 
-    OMP_PARALLEL_FOR_
-    for (int n = 0; n < number; ++n) {
+    ParallelFor(0, number, [&](int n) {
         for (int g = 0; g < group; ++g) {
             int output_c_start = g * output_channels_per_group;
             int output_c_end   = (g + 1) * output_channels_per_group;
@@ -913,7 +919,7 @@ void NaiveConv3D(void *input_ptr, void *output_ptr, void *weight_ptr, void *bias
                 }
             }
         }
-    }
+    });
 }
 
 template void NaiveConv3D<float, float, float, float>(void *input_ptr, void *output_ptr, void *weight_ptr, void *bias, DimsVector dims_input,
@@ -1621,14 +1627,13 @@ void NaiveDequant(const int8_t *input_ptr, const float *scale_ptr, int scale_len
     int channel = DimsFunctionUtils::GetDim(dims, 1);
     int hw_size = DimsVectorUtils::Count(dims, 2);
     for (int n = 0; n < batch; n++) {
-        OMP_PARALLEL_FOR_
-        for (int c = 0; c < channel; c++) {
+        ParallelFor(0, channel, [&](int c) {
             int offset    = n * channel * hw_size + c * hw_size;
             int scale_idx = scale_len == 1 ? 0 : c;
             for (int hw = 0; hw < hw_size; hw++) {
                 output[offset + hw] = scale_ptr[scale_idx] * static_cast<float>(input_ptr[offset + hw]);
             }
-        }
+        });
     }
 }
 
@@ -1637,8 +1642,7 @@ void NaiveQuant(const float *input_ptr, const float *scale_ptr, int scale_len, i
     int channel = DimsFunctionUtils::GetDim(dims, 1);
     int hw_size = DimsVectorUtils::Count(dims, 2);
     for (int n = 0; n < batch; n++) {
-        OMP_PARALLEL_FOR_
-        for (int c = 0; c < channel; c++) {
+        ParallelFor(0, channel, [&](int c) {
             int offset    = n * channel * hw_size + c * hw_size;
             int scale_idx = scale_len == 1 ? 0 : c;
             for (int hw = 0; hw < hw_size; hw++) {
@@ -1647,7 +1651,7 @@ void NaiveQuant(const float *input_ptr, const float *scale_ptr, int scale_len, i
                 else
                     output[offset + hw] = 0;
             }
-        }
+        });
     }
 }
 void NaiveDequantBias(const int8_t *input_ptr, const float *scale_ptr, const int8_t *zero_point_ptr, int scale_len,
@@ -1656,15 +1660,14 @@ void NaiveDequantBias(const int8_t *input_ptr, const float *scale_ptr, const int
     int channel = DimsFunctionUtils::GetDim(dims, 1);
     int hw_size = DimsVectorUtils::Count(dims, 2);
     for (int n = 0; n < batch; n++) {
-        OMP_PARALLEL_FOR_
-        for (int c = 0; c < channel; c++) {
+        ParallelFor(0, channel, [&](int c) {
             int offset    = n * channel * hw_size + c * hw_size;
             int scale_idx = scale_len == 1 ? 0 : c;
             for (int hw = 0; hw < hw_size; hw++) {
                 output[offset + hw] = scale_ptr[scale_idx] * (static_cast<float>(input_ptr[offset + hw]) -
                                                               static_cast<float>(zero_point_ptr[scale_idx]));
             }
-        }
+        });
     }    
 }
 
@@ -1674,8 +1677,7 @@ void NaiveQuantBias(const float *input_ptr, const float *scale_ptr, const int8_t
     int channel = DimsFunctionUtils::GetDim(dims, 1);
     int hw_size = DimsVectorUtils::Count(dims, 2);
     for (int n = 0; n < batch; n++) {
-        OMP_PARALLEL_FOR_
-        for (int c = 0; c < channel; c++) {
+        ParallelFor(0, channel, [&](int c) {
             int offset    = n * channel * hw_size + c * hw_size;
             int scale_idx = scale_len == 1 ? 0 : c;
             for (int hw = 0; hw < hw_size; hw++) {
@@ -1685,7 +1687,7 @@ void NaiveQuantBias(const float *input_ptr, const float *scale_ptr, const int8_t
               } else
                     output[offset + hw] = 0;
             }
-       }
+       });
     }
 }    
 
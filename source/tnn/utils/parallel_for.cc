@@ -0,0 +1,248 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "tnn/utils/parallel_for.h"
+
+#include <algorithm>
+
+#if defined(__linux__) || defined(__ANDROID__)
+#include <sched.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+#include "tnn/utils/omp_utils.h"
+
+namespace TNN_NS {
+
+// iterations a worker spins before sleeping, about a millisecond
+static const int kSpinCount = 1 << 14;
+// chunks per thread of a loop, balances uneven iterations
+static const int kChunksPerThread = 4;
+
+static thread_local std::weak_ptr<ParallelForPool> g_bound_pool;
+#if defined(__linux__) || defined(__ANDROID__)
+// affinity of the calling thread before it was bound to the cpus of a pool
+static thread_local bool g_affinity_saved = false;
+static thread_local cpu_set_t g_saved_affinity;
+#endif
+// pool of the loop running on the thread and the thread id in it, set on pool workers
+// and on the calling thread while a loop is running
+static thread_local const ParallelForPool *g_parallel_pool = nullptr;
+static thread_local int g_parallel_thread_id               = 0;
+
+static inline void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield" ::: "memory");
+#else
+    std::this_thread::yield();
+#endif
+}
+
+static void SetThreadAffinity(const std::vector<int> &cpus) {
+#if defined(__linux__) || defined(__ANDROID__)
+    if (cpus.empty()) {
+        return;
+    }
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    for (auto cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &mask);
+        }
+    }
+    if (sched_setaffinity(0, sizeof(mask), &mask) != 0) {
+        LOGD("ParallelForPool set thread affinity failed\n");
+    }
+#endif
+}
+
+ParallelForPool::ParallelForPool(int num_threads, std::vector<int> cpu_affinity)
+    : cpu_affinity_(cpu_affinity), generation_(0), working_(0), stop_(false), next_(0) {
+    num_threads = std::max(num_threads, 1);
+    for (int i = 1; i < num_threads; i++) {
+        workers_.emplace_back(&ParallelForPool::WorkerLoop, this, i);
+    }
+}
+
+ParallelForPool::~ParallelForPool() {
+    {
+        std::unique_lock<std::mutex> lck(mutex_);
+        stop_ = true;
+    }
+    cond_.notify_all();
+    for (auto &worker : workers_) {
+        worker.join();
+    }
+}
+
+int ParallelForPool::GetNumThreads() const {
+    return (int)workers_.size() + 1;
+}
+
+std::vector<int> ParallelForPool::GetCpuAffinity() const {
+    return cpu_affinity_;
+}
+
+void ParallelForPool::RunChunks(int thread_id) {
+    while (true) {
+        int begin = next_.fetch_add(chunk_);
+        if (begin >= end_) {
+            break;
+        }
+        (*task_)(begin, std::min(begin + chunk_, end_), thread_id);
+    }
+}
+
+void ParallelForPool::WorkerLoop(int thread_id) {
+    SetThreadAffinity(cpu_affinity_);
+    g_parallel_pool      = this;
+    g_parallel_thread_id = thread_id;
+
+    unsigned int seen = 0;
+    while (true) {
+        int spins = 0;
+        while (generation_.load(std::memory_order_acquire) == seen && !stop_) {
+            if (++spins < kSpinCount) {
+                CpuRelax();
+                continue;
+            }
+            std::unique_lock<std::mutex> lck(mutex_);
+            cond_.wait(lck, [this, seen] { return stop_ || generation_.load() != seen; });
+        }
+        if (stop_) {
+            break;
+        }
+        seen = generation_.load(std::memory_order_acquire);
+        RunChunks(thread_id);
+        if (working_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            // the last worker wakes the calling thread up
+            std::unique_lock<std::mutex> lck(mutex_);
+            done_cond_.notify_one();
+        }
+    }
+}
+
+void ParallelForPool::Run(int begin, int end, const RangeTask &task) {
+    if (end <= begin) {
+        return;
+    }
+    // a nested loop runs on the thread of the outer one, with its thread id
+    if (g_parallel_pool == this) {
+        task(begin, end, g_parallel_thread_id);
+        return;
+    }
+    // another thread running a loop on the pool uses thread id 0 and the workers, the
+    // caller waits for it instead of sharing the per thread scratch of one of them
+    std::unique_lock<std::mutex> run_lck(run_mutex_);
+    auto outer_pool      = g_parallel_pool;
+    auto outer_thread_id = g_parallel_thread_id;
+    g_parallel_pool      = this;
+    g_parallel_thread_id = 0;
+    if (workers_.empty() || end - begin == 1) {
+        task(begin, end, 0);
+        g_parallel_pool      = outer_pool;
+        g_parallel_thread_id = outer_thread_id;
+        return;
+    }
+
+    const int num_threads = GetNumThreads();
+    task_  = &task;
+    end_   = end;
+    chunk_ = std::max(1, (end - begin) / (num_threads * kChunksPerThread));
+    next_.store(begin);
+    working_.store((int)workers_.size());
+    {
+        std::unique_lock<std::mutex> lck(mutex_);
+        generation_.fetch_add(1, std::memory_order_release);
+    }
+    cond_.notify_all();
+
+    RunChunks(0);
+    g_parallel_pool      = outer_pool;
+    g_parallel_thread_id = outer_thread_id;
+
+    if (working_.load(std::memory_order_acquire) > 0) {
+        std::unique_lock<std::mutex> lck(mutex_);
+        done_cond_.wait(lck, [this] { return working_.load(std::memory_order_acquire) == 0; });
+    }
+    task_ = nullptr;
+}
+
+void BindParallelForPool(std::shared_ptr<ParallelForPool> pool) {
+    if (pool && pool == g_bound_pool.lock()) {
+        return;
+    }
+    g_bound_pool = pool;
+#if defined(__linux__) || defined(__ANDROID__)
+    // the calling thread works as thread 0 of the pool, it runs on the cpus of the pool until unbound
+    if (pool && !pool->GetCpuAffinity().empty()) {
+        if (!g_affinity_saved) {
+            g_affinity_saved = sched_getaffinity(0, sizeof(g_saved_affinity), &g_saved_affinity) == 0;
+        }
+        SetThreadAffinity(pool->GetCpuAffinity());
+    } else if (g_affinity_saved) {
+        sched_setaffinity(0, sizeof(g_saved_affinity), &g_saved_affinity);
+        g_affinity_saved = false;
+    }
+#endif
+}
+
+std::shared_ptr<ParallelForPool> GetParallelForPool() {
+    return g_bound_pool.lock();
+}
+
+int GetParallelMaxThreads() {
+    auto pool = g_bound_pool.lock();
+    if (pool) {
+        return pool->GetNumThreads();
+    }
+    return OMP_MAX_THREADS_NUM_;
+}
+
+int GetCpuCount() {
+    int count = (int)std::thread::hardware_concurrency();
+    return std::max(count, OMP_CORES_);
+}
+
+void ParallelForRange(int begin, int end, const ParallelForPool::RangeTask &task) {
+    if (end <= begin) {
+        return;
+    }
+    auto pool = g_bound_pool.lock();
+    if (pool) {
+        pool->Run(begin, end, task);
+        return;
+    }
+
+    // no pool bound, e.g. mat conversion out of forward, keep the OpenMP behavior
+    const int num_threads = OMP_MAX_THREADS_NUM_;
+    if (num_threads <= 1 || end - begin == 1) {
+        task(begin, end, 0);
+        return;
+    }
+    const int count     = end - begin;
+    const int chunk     = std::max(1, count / (num_threads * kChunksPerThread));
+    const int num_chunk = (count + chunk - 1) / chunk;
+    OMP_PARALLEL_FOR_DYNAMIC_
+    for (int c = 0; c < num_chunk; c++) {
+        int chunk_begin = begin + c * chunk;
+        task(chunk_begin, std::min(chunk_begin + chunk, end), OMP_TID_);
+    }
+}
+
+}  // namespace TNN_NS
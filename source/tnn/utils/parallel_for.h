@@ -0,0 +1,123 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef TNN_SOURCE_TNN_UTILS_PARALLEL_FOR_H_
+#define TNN_SOURCE_TNN_UTILS_PARALLEL_FOR_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "tnn/core/macro.h"
+
+namespace TNN_NS {
+
+// @brief fork-join pool running the loops of layer accs. the calling thread
+// works as thread 0 and num_threads - 1 persistent workers join it. idle workers
+// spin for a while before sleeping, so back to back loops of one forward do not
+// pay for waking them up. each context owns its pool, instances in one process
+// do not share threads with each other.
+class ParallelForPool {
+public:
+    // @brief run the iterations [begin, end) on thread thread_id
+    typedef std::function<void(int begin, int end, int thread_id)> RangeTask;
+
+    // @brief create pool of num_threads threads including the calling one,
+    // workers are bound to the cpus in cpu_affinity if not empty.
+    ParallelForPool(int num_threads, std::vector<int> cpu_affinity = {});
+
+    ~ParallelForPool();
+
+    // @brief run task over [begin, end) and wait for it, iterations are split into
+    // chunks taken dynamically by the threads. nested calls run on the calling thread
+    // only, with its thread id. calls while the pool is busy wait for it, so that two
+    // threads never run loops with the same thread id at the same time.
+    void Run(int begin, int end, const RangeTask &task);
+
+    // @brief get number of threads including the calling one
+    int GetNumThreads() const;
+
+    // @brief get cpus the workers are bound to
+    std::vector<int> GetCpuAffinity() const;
+
+private:
+    ParallelForPool(const ParallelForPool &);
+    ParallelForPool &operator=(const ParallelForPool &);
+
+    void WorkerLoop(int thread_id);
+    void RunChunks(int thread_id);
+
+    std::vector<std::thread> workers_;
+    std::vector<int> cpu_affinity_;
+
+    std::mutex run_mutex_;
+    std::mutex mutex_;
+    // workers wait on cond_ for a loop, the calling thread waits on done_cond_ for the workers
+    std::condition_variable cond_;
+    std::condition_variable done_cond_;
+    std::atomic<unsigned int> generation_;
+    std::atomic<int> working_;
+    std::atomic<bool> stop_;
+
+    const RangeTask *task_ = nullptr;
+    std::atomic<int> next_;
+    int end_   = 0;
+    int chunk_ = 1;
+};
+
+// @brief set the pool used by ParallelFor on the calling thread, nullptr to fall
+// back to OpenMP. contexts bind their pool before forward. the calling thread is
+// bound to the cpus of the pool too, and gets its former cpus back when unbound.
+void BindParallelForPool(std::shared_ptr<ParallelForPool> pool);
+
+// @brief get the pool bound to the calling thread
+std::shared_ptr<ParallelForPool> GetParallelForPool();
+
+// @brief get max number of threads of ParallelFor on the calling thread, thread
+// ids passed to the loops are less than it.
+int GetParallelMaxThreads();
+
+// @brief get number of cpus of the machine
+int GetCpuCount();
+
+// @brief run task over [begin, end) with the pool bound to the calling thread
+void ParallelForRange(int begin, int end, const ParallelForPool::RangeTask &task);
+
+// @brief parallel for loop, func(i) is called for i in [begin, end)
+template <typename Func>
+void ParallelFor(int begin, int end, const Func &func) {
+    ParallelForRange(begin, end, [&func](int range_begin, int range_end, int thread_id) {
+        for (int i = range_begin; i < range_end; i++) {
+            func(i);
+        }
+    });
+}
+
+// @brief parallel for loop, func(i, thread_id) is called for i in [begin, end)
+template <typename Func>
+void ParallelForWithThreadId(int begin, int end, const Func &func) {
+    ParallelForRange(begin, end, [&func](int range_begin, int range_end, int thread_id) {
+        for (int i = range_begin; i < range_end; i++) {
+            func(i, thread_id);
+        }
+    });
+}
+
+}  // namespace TNN_NS
+
+#endif  // TNN_SOURCE_TNN_UTILS_PARALLEL_FOR_H_
@@ -0,0 +1,117 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "tnn/utils/thread_pool.h"
+
+namespace TNN_NS {
+
+static thread_local const ThreadPool *g_current_pool = nullptr;
+static thread_local int g_worker_index               = -1;
+
+ThreadPool::ThreadPool(int num_threads) : pending_tasks_(0), next_queue_(0) {
+    num_threads = num_threads < 1 ? 1 : num_threads;
+    for (int i = 0; i < num_threads; i++) {
+        queues_.emplace_back(new WorkQueue());
+    }
+    for (int i = 0; i < num_threads; i++) {
+        workers_.emplace_back(&ThreadPool::WorkerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::unique_lock<std::mutex> lck(mutex_);
+        stop_ = true;
+    }
+    cond_.notify_all();
+    for (auto &worker : workers_) {
+        worker.join();
+    }
+}
+
+int ThreadPool::GetNumThreads() const {
+    return (int)workers_.size();
+}
+
+int ThreadPool::GetWorkerIndex() {
+    return g_worker_index;
+}
+
+void ThreadPool::Submit(Task task) {
+    int queue_index = 0;
+    if (g_current_pool == this) {
+        queue_index = g_worker_index;
+    } else {
+        queue_index = (int)(next_queue_++ % queues_.size());
+    }
+    {
+        std::unique_lock<std::mutex> lck(queues_[queue_index]->mutex);
+        queues_[queue_index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::unique_lock<std::mutex> lck(mutex_);
+        pending_tasks_++;
+    }
+    cond_.notify_one();
+}
+
+bool ThreadPool::PopTask(int index, Task &task) {
+    // newest task of the own queue first, its inputs are most likely still in cache
+    {
+        auto &queue = *queues_[index];
+        std::unique_lock<std::mutex> lck(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            return true;
+        }
+    }
+    // steal the oldest task from the other workers
+    const int count = (int)queues_.size();
+    for (int i = 1; i < count; i++) {
+        auto &queue = *queues_[(index + i) % count];
+        std::unique_lock<std::mutex> lck(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::WorkerLoop(int index) {
+    g_current_pool = this;
+    g_worker_index = index;
+
+    while (true) {
+        Task task;
+        if (PopTask(index, task)) {
+            {
+                std::unique_lock<std::mutex> lck(mutex_);
+                pending_tasks_--;
+            }
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lck(mutex_);
+        cond_.wait(lck, [this] { return stop_ || pending_tasks_ > 0; });
+        if (stop_) {
+            break;
+        }
+    }
+}
+
+}  // namespace TNN_NS
@@ -0,0 +1,79 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef TNN_SOURCE_TNN_UTILS_THREAD_POOL_H_
+#define TNN_SOURCE_TNN_UTILS_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "tnn/core/macro.h"
+
+namespace TNN_NS {
+
+// @brief work-stealing thread pool. every worker owns a task queue, tasks
+// submitted from a worker go to its own queue and idle workers steal from
+// the others, so dependent tasks tend to stay on the same core.
+class ThreadPool {
+public:
+    typedef std::function<void()> Task;
+
+    // @brief create pool with num_threads persistent workers
+    explicit ThreadPool(int num_threads);
+
+    // @brief stop all workers, pending tasks are dropped
+    ~ThreadPool();
+
+    // @brief submit a task to the pool, it never runs on the calling thread
+    void Submit(Task task);
+
+    // @brief get number of workers in the pool
+    int GetNumThreads() const;
+
+    // @brief get index of the pool worker running the calling thread,
+    // -1 if the calling thread is not a pool worker.
+    static int GetWorkerIndex();
+
+private:
+    ThreadPool(const ThreadPool &);
+    ThreadPool &operator=(const ThreadPool &);
+
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void WorkerLoop(int index);
+    bool PopTask(int index, Task &task);
+
+    std::vector<std::unique_ptr<WorkQueue>> queues_;
+    std::vector<std::thread> workers_;
+
+    // pending_tasks_ is guarded by mutex_, the workers wait on it
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    int pending_tasks_;
+    std::atomic<unsigned int> next_queue_;
+    bool stop_ = false;
+};
+
+}  // namespace TNN_NS
+
+#endif  // TNN_SOURCE_TNN_UTILS_THREAD_POOL_H_
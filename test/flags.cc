@@ -46,6 +46,8 @@ DEFINE_bool(ub, false, unit_test_benchmark_message);
 
 DEFINE_int32(th, 1, cpu_thread_num_message);
 
+DEFINE_int32(ith, 1, inter_op_thread_num_message);
+
 DEFINE_int32(it, 0, input_format_message);
 
 DEFINE_string(pr, "AUTO", precision_message);
@@ -58,4 +60,6 @@ DEFINE_string(sc, "", scale_message);
 
 DEFINE_string(bi, "", bias_message);
 
+DEFINE_bool(mm, false, mmap_message);
+
 }  // namespace TNN_NS
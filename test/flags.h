@@ -51,6 +51,8 @@ static const char unit_test_benchmark_message[] = "enable unit benchmark(default
 
 static const char cpu_thread_num_message[] = "cpu thread num(eg: 0,1,2,3, default 1)";
 
+static const char inter_op_thread_num_message[] = "max number of layers running concurrently(default 1)";
+
 static const char input_format_message[] = "input format(0: nchw float; 1: bgr u8; 2: gray u8; 3: int32; 4: int8;), default nchw float";
 
 static const char precision_message[] = "compute precision(HIGH, NORMAL, LOW)";
@@ -65,6 +67,8 @@ static const char scale_message[] = "input scale: s0,s1,s2,...)";
 
 static const char bias_message[] = "input bias: b0,b1,b2,...)";
 
+static const char mmap_message[] = "memory map tnn model file instead of reading it(default false)";
+
 DECLARE_bool(h);
 
 DECLARE_string(mt);
@@ -95,6 +99,8 @@ DECLARE_bool(ub);
 
 DECLARE_int32(th);
 
+DECLARE_int32(ith);
+
 DECLARE_int32(it);
 
 DECLARE_string(pr);
@@ -107,6 +113,8 @@ DECLARE_string(sc);
 
 DECLARE_string(bi);
 
+DECLARE_bool(mm);
+
 }  // namespace TNN_NS
 
 #endif  // TNN_TEST_FLAGS_H_
@@ -201,6 +201,7 @@ namespace test {
         printf("    -op \"<path>\"          \t%s \n", output_path_message);
         printf("    -dl \"<device list>\"   \t%s \n", device_list_message);
         printf("    -th \"<thread umber>\"  \t%s \n", cpu_thread_num_message);
+        printf("    -ith \"<thread number>\"\t%s \n", inter_op_thread_num_message);
         printf("    -it \"<input type>\"    \t%s \n", input_format_message);
         printf("    -pr \"<precision >\"    \t%s \n", precision_message);
         printf("    -is \"<input shape>\"   \t%s \n", input_shape_message);
@@ -209,6 +210,7 @@ namespace test {
         printf("    -et \"<enable tune>\t%s \n", enable_tune_message);
         printf("    -sc \"<input scale>\t%s \n", scale_message);
         printf("    -bi \"<input bias>\t%s \n", bias_message);
+        printf("    -mm \"<mmap model>\t%s \n", mmap_message);
     }
 
     void SetCpuAffinity() {
@@ -285,7 +287,9 @@ namespace test {
                     std::string((std::istreambuf_iterator<char>(proto_stream)), std::istreambuf_iterator<char>());
             config.params.push_back(buffer);
 
-            if (config.model_type == MODEL_TYPE_TNN || config.model_type == MODEL_TYPE_NCNN) {
+            if (config.model_type == MODEL_TYPE_TNN && FLAGS_mm) {
+                config.params.push_back("ModelPath:" + model_path);
+            } else if (config.model_type == MODEL_TYPE_TNN || config.model_type == MODEL_TYPE_NCNN) {
                 std::ifstream model_stream(model_path, std::ios::binary);
                 if (!model_stream.is_open() || !model_stream.good()) {
                     config.params.push_back("");
@@ -310,6 +314,8 @@ namespace test {
         config.precision = ConvertPrecision(FLAGS_pr);
 
         config.enable_tune_kernel = FLAGS_et;
+
+        config.inter_op_num_threads = std::max(FLAGS_ith, 1);
 #if defined(__ANDROID__)
         config.cache_path = "/data/local/tmp/";
 #else
@@ -0,0 +1,116 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "test/unit_test/unit_test_common.h"
+#include "tnn/core/batch_scheduler.h"
+#include "tnn/core/instance.h"
+#include "tnn/utils/dims_utils.h"
+
+namespace TNN_NS {
+
+static std::shared_ptr<Instance> CreateReluInstance(int max_batch) {
+    std::vector<int> input_dims = {1, 3, 4, 4};
+    auto interpreter            = GenerateInterpreter("ReLU", {input_dims}, std::make_shared<LayerParam>());
+
+    ModelConfig model_config;
+    model_config.params.push_back("");
+    model_config.params.push_back("");
+    NetworkConfig network_config;
+    network_config.device_type = DEVICE_NAIVE;
+
+    auto instance             = std::make_shared<Instance>(network_config, model_config);
+    InputShapesMap min_shapes = {{"input0", input_dims}};
+    InputShapesMap max_shapes = {{"input0", {max_batch, 3, 4, 4}}};
+    if (instance->Init(interpreter, min_shapes, max_shapes) != TNN_OK) {
+        return nullptr;
+    }
+    return instance;
+}
+
+TEST(BatchSchedulerTest, SplitsOutputsByRequest) {
+    const int max_batch = 4;
+    auto instance       = CreateReluInstance(max_batch);
+    ASSERT_TRUE(instance != nullptr);
+
+    BatchSchedulerConfig config;
+    config.max_batch_size = max_batch;
+    config.max_delay_us   = 5000;
+    BatchScheduler scheduler(instance, config);
+    ASSERT_TRUE(scheduler.Start() == TNN_OK);
+
+    const int thread_count = 4, request_count = 8;
+    std::vector<std::thread> threads;
+    std::vector<int> failures(thread_count, 0);
+    for (int t = 0; t < thread_count; t++) {
+        threads.emplace_back([&, t] {
+            for (int r = 0; r < request_count; r++) {
+                int batch = 1 + (t + r) % 2;
+                auto mat  = std::make_shared<Mat>(DEVICE_NAIVE, NCHW_FLOAT, std::vector<int>{batch, 3, 4, 4});
+                int count = DimsVectorUtils::Count(mat->GetDims());
+                float *data = reinterpret_cast<float *>(mat->GetData());
+                for (int i = 0; i < count; i++) {
+                    data[i] = (i % 2 ? -1.0f : 1.0f) * (t * 1000 + r * 10 + i % 7);
+                }
+
+                auto result = scheduler.Submit({{"input0", mat}}).get();
+                if (result.status != TNN_OK || result.outputs.count("output0") == 0) {
+                    failures[t]++;
+                    continue;
+                }
+                auto output = result.outputs["output0"];
+                if (output->GetBatch() != batch) {
+                    failures[t]++;
+                    continue;
+                }
+                float *out = reinterpret_cast<float *>(output->GetData());
+                for (int i = 0; i < count; i++) {
+                    if (out[i] != std::max(data[i], 0.0f)) {
+                        failures[t]++;
+                        break;
+                    }
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    for (int t = 0; t < thread_count; t++) {
+        EXPECT_EQ(failures[t], 0);
+    }
+
+    auto stats = scheduler.GetStats();
+    EXPECT_EQ(stats.request_count, thread_count * request_count);
+    EXPECT_EQ(stats.queue_depth, 0);
+    int64_t batch_count = 0;
+    for (size_t n = max_batch + 1; n < stats.batch_size_histogram.size(); n++) {
+        EXPECT_EQ(stats.batch_size_histogram[n], 0);
+    }
+    for (auto count : stats.batch_size_histogram) {
+        batch_count += count;
+    }
+    EXPECT_EQ(batch_count, stats.batch_count);
+    EXPECT_LE(stats.latency_p50_ms, stats.latency_max_ms);
+
+    EXPECT_TRUE(scheduler.Stop() == TNN_OK);
+    auto mat    = std::make_shared<Mat>(DEVICE_NAIVE, NCHW_FLOAT, std::vector<int>{1, 3, 4, 4});
+    auto result = scheduler.Submit({{"input0", mat}}).get();
+    EXPECT_TRUE(result.status != TNN_OK);
+}
+
+}  // namespace TNN_NS
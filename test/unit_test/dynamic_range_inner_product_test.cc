@@ -0,0 +1,137 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "test/unit_test/unit_test_common.h"
+#include "tnn/core/abstract_device.h"
+#include "tnn/interpreter/default_model_interpreter.h"
+#include "tnn/optimizer/net_optimizer_dynamic_range_dequant.h"
+#include "tnn/utils/dims_utils.h"
+
+namespace TNN_NS {
+
+// dynamic range quantized inner product followed by abs, the dequant optimizer skips single layer nets
+static std::shared_ptr<AbstractModelInterpreter> CreateQuantizedInterpreter(std::vector<int> input_dims,
+                                                                            int num_output) {
+    auto param                     = std::make_shared<InnerProductLayerParam>();
+    param->name                    = "InnerProduct";
+    param->num_output              = num_output;
+    param->has_bias                = 1;
+    param->axis                    = 1;
+    param->dynamic_range_quantized = true;
+
+    // every 15 consecutive weights of an output channel span [-21, 21] in steps of 3, so that int4 groups are exact
+    const int input_count = DimsVectorUtils::Count(input_dims, 1);
+    auto resource         = std::make_shared<InnerProductLayerResource>();
+    RawBuffer weight(input_count * num_output * sizeof(int8_t));
+    RawBuffer scale(sizeof(float));
+    RawBuffer bias(num_output * sizeof(float));
+    auto weight_data = weight.force_to<int8_t *>();
+    for (int i = 0; i < input_count * num_output; i++) {
+        weight_data[i] = (int8_t)((i % 15 - 7) * 3);
+    }
+    scale.force_to<float *>()[0] = 0.01f;
+    for (int i = 0; i < num_output; i++) {
+        bias.force_to<float *>()[i] = (float)(i % 4) - 1.5f;
+    }
+    weight.SetDataType(DATA_TYPE_INT8);
+    resource->weight_handle = weight;
+    resource->scale_handle  = scale;
+    resource->bias_handle   = bias;
+
+    auto interpreter   = GenerateInterpreter("InnerProduct", {input_dims}, param, resource);
+    auto net_structure = dynamic_cast<DefaultModelInterpreter *>(interpreter.get())->GetNetStructure();
+    net_structure->layers[0]->outputs = {"inner_product_output"};
+    net_structure->blobs.insert("inner_product_output");
+
+    auto abs_param       = std::make_shared<LayerParam>();
+    abs_param->name      = "Abs";
+    auto abs_layer       = std::make_shared<LayerInfo>();
+    abs_layer->type      = LAYER_ABS;
+    abs_layer->type_str  = "Abs";
+    abs_layer->name      = "abs";
+    abs_layer->inputs    = {"inner_product_output"};
+    abs_layer->outputs   = {"output0"};
+    abs_layer->param     = abs_param;
+    net_structure->layers.push_back(abs_layer);
+    return interpreter;
+}
+
+class DynamicRangeInnerProductTest : public ::testing::TestWithParam<std::tuple<int, Precision>> {};
+
+INSTANTIATE_TEST_SUITE_P(DynamicRangeInnerProductTest, DynamicRangeInnerProductTest,
+                         // batch 1 runs sgemv, batch 16 runs sgemm
+                         ::testing::Combine(testing::Values(1, 16), testing::Values(PRECISION_HIGH, PRECISION_LOW)));
+
+// x86 keeps the int8 weights (int4 groups for low precision gemv), naive computes with dequantized fp32 weights
+TEST_P(DynamicRangeInnerProductTest, SameResultAsDequantized) {
+    if (GetDevice(DEVICE_X86) == nullptr) {
+        GTEST_SKIP();
+    }
+    const int batch               = std::get<0>(GetParam());
+    const Precision precision     = std::get<1>(GetParam());
+    const int num_output          = 21;
+    std::vector<int> input_dims   = {batch, 24, 2, 2};
+
+    NetworkConfig naive_config, x86_config;
+    naive_config.device_type = DEVICE_NAIVE;
+    naive_config.precision   = PRECISION_HIGH;
+    x86_config.device_type   = DEVICE_X86;
+    x86_config.precision     = precision;
+
+    // the optimizer changes the resources in place, every instance gets its own interpreter
+    std::map<std::string, std::vector<float>> expect_outputs, actual_outputs;
+    ASSERT_TRUE(ForwardInstance(naive_config, CreateQuantizedInterpreter(input_dims, num_output),
+                                {{"input0", input_dims}}, expect_outputs) == TNN_OK);
+    ASSERT_TRUE(ForwardInstance(x86_config, CreateQuantizedInterpreter(input_dims, num_output),
+                                {{"input0", input_dims}}, actual_outputs) == TNN_OK);
+    auto &expect = expect_outputs["output0"];
+    auto &actual = actual_outputs["output0"];
+    ASSERT_EQ(expect.size(), (size_t)(batch * num_output));
+    ASSERT_EQ(actual.size(), expect.size());
+    for (int i = 0; i < expect.size(); i++) {
+        EXPECT_NEAR(actual[i], expect[i], 1e-4f * std::fabs(expect[i]) + 1e-4f) << "index " << i;
+    }
+}
+
+static DataType OptimizedWeightDataType(optimizer::NetOptimizerDynamicRangeDequant &optimizer,
+                                        const NetworkConfig &network_config) {
+    auto interpreter         = CreateQuantizedInterpreter({1, 24, 2, 2}, 21);
+    auto default_interpreter = dynamic_cast<DefaultModelInterpreter *>(interpreter.get());
+    auto resource            = default_interpreter->GetNetResource();
+    EXPECT_TRUE(optimizer.Optimize(default_interpreter->GetNetStructure(), resource, network_config) == TNN_OK);
+    auto inner_product_resource =
+        std::dynamic_pointer_cast<InnerProductLayerResource>(resource->resource_map["layer_name"]);
+    return inner_product_resource->weight_handle.GetDataType();
+}
+
+// the optimizer is shared by all networks, the int8 weights are kept for the config optimized for,
+// not for the last config asked about
+TEST(DynamicRangeDequantTest, KeepsInt8WeightsOnlyForX86) {
+    NetworkConfig x86_config, naive_config;
+    x86_config.device_type   = DEVICE_X86;
+    naive_config.device_type = DEVICE_NAIVE;
+
+    optimizer::NetOptimizerDynamicRangeDequant optimizer;
+    ASSERT_TRUE(optimizer.IsSupported(x86_config));
+    ASSERT_TRUE(optimizer.IsSupported(naive_config));
+    EXPECT_EQ(OptimizedWeightDataType(optimizer, x86_config), DATA_TYPE_INT8);
+
+    ASSERT_TRUE(optimizer.IsSupported(x86_config));
+    EXPECT_EQ(OptimizedWeightDataType(optimizer, naive_config), DATA_TYPE_FLOAT);
+}
+
+}  // namespace TNN_NS
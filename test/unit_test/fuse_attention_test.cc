@@ -0,0 +1,128 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "test/unit_test/unit_test_common.h"
+#include "tnn/interpreter/default_model_interpreter.h"
+#include "tnn/optimizer/net_optimizer_fuse_attention.h"
+
+namespace TNN_NS {
+
+// q [2, 3, 5, 8] attends to k and v shared by all batches and heads
+static const InputShapesMap kAttentionShapes = {
+    {"q", {2, 3, 5, 8}}, {"k", {1, 1, 8, 7}}, {"v", {7, 6}}, {"mask", {2, 1, 1, 7}}};
+
+// the rank of the mask is unknown to the optimizer if it is the output of a ReLU
+static std::shared_ptr<AbstractModelInterpreter> CreateAttentionInterpreter(int softmax_axis,
+                                                                            bool mask_rank_unknown = false) {
+    auto interpreter = GenerateEmptyInterpreter(kAttentionShapes, {"output"});
+    std::string mask = "mask";
+    if (mask_rank_unknown) {
+        AddLayer(interpreter, "ReLU", "mask_relu", {"mask"}, {"mask_relu"}, std::make_shared<LayerParam>());
+        mask = "mask_relu";
+    }
+    AddLayer(interpreter, "MatMul", "qk", {"q", "k"}, {"scores"}, std::make_shared<MatMulLayerParam>());
+
+    auto scale_param                = std::make_shared<MultidirBroadcastLayerParam>();
+    scale_param->weight_input_index = 1;
+    auto scale_resource             = std::make_shared<EltwiseLayerResource>();
+    scale_resource->element_handle  = RawBuffer(sizeof(float));
+    scale_resource->element_handle.force_to<float *>()[0] = std::sqrt(8.f);
+    scale_resource->element_shape                         = {1};
+    AddLayer(interpreter, "Div", "scale", {"scores"}, {"scaled"}, scale_param, scale_resource);
+
+    auto add_param                = std::make_shared<MultidirBroadcastLayerParam>();
+    add_param->weight_input_index = -1;
+    AddLayer(interpreter, "Add", "add_mask", {"scaled", mask}, {"masked"}, add_param);
+
+    auto softmax_param  = std::make_shared<SoftmaxLayerParam>();
+    softmax_param->axis = softmax_axis;
+    AddLayer(interpreter, "Softmax", "softmax", {"masked"}, {"probs"}, softmax_param);
+    AddLayer(interpreter, "MatMul", "pv", {"probs", "v"}, {"output"}, std::make_shared<MatMulLayerParam>());
+    return interpreter;
+}
+
+static int CountLayers(NetStructure *structure, LayerType type) {
+    int count = 0;
+    for (auto &layer : structure->layers) {
+        count += layer->type == type;
+    }
+    return count;
+}
+
+TEST(FuseAttentionTest, FusesBroadcastKeyAndValue) {
+    auto interpreter = CreateAttentionInterpreter(-1);
+    auto default_interpreter = dynamic_cast<DefaultModelInterpreter *>(interpreter.get());
+    auto structure           = default_interpreter->GetNetStructure();
+
+    optimizer::NetOptimizerFuseAttention optimizer;
+    ASSERT_TRUE(optimizer.Optimize(structure, default_interpreter->GetNetResource()) == TNN_OK);
+    EXPECT_EQ(CountLayers(structure, LAYER_FUSED_ATTENTION), 1);
+    EXPECT_EQ(CountLayers(structure, LAYER_SOFTMAX), 0);
+}
+
+// softmax over axis 3 is over the last axis only if the scores are of rank 4
+TEST(FuseAttentionTest, PositiveSoftmaxAxisNeedsKnownRank) {
+    // the rank of the scores is resolved from the ranks of q, k and the mask
+    for (int softmax_axis : {3, 2}) {
+        auto interpreter         = CreateAttentionInterpreter(softmax_axis);
+        auto default_interpreter = dynamic_cast<DefaultModelInterpreter *>(interpreter.get());
+        auto structure           = default_interpreter->GetNetStructure();
+
+        optimizer::NetOptimizerFuseAttention optimizer;
+        ASSERT_TRUE(optimizer.Optimize(structure, default_interpreter->GetNetResource()) == TNN_OK);
+        EXPECT_EQ(CountLayers(structure, LAYER_FUSED_ATTENTION), softmax_axis == 3 ? 1 : 0);
+    }
+
+    // the mask may raise the rank, it must be known too
+    auto interpreter         = CreateAttentionInterpreter(3, true);
+    auto default_interpreter = dynamic_cast<DefaultModelInterpreter *>(interpreter.get());
+    auto structure           = default_interpreter->GetNetStructure();
+    auto resource            = default_interpreter->GetNetResource();
+
+    optimizer::NetOptimizerFuseAttention optimizer;
+    ASSERT_TRUE(optimizer.Optimize(structure, resource) == TNN_OK);
+    EXPECT_EQ(CountLayers(structure, LAYER_FUSED_ATTENTION), 0);
+
+    resource->blob_shapes_map["masked"] = {2, 3, 5, 7};
+    ASSERT_TRUE(optimizer.Optimize(structure, resource) == TNN_OK);
+    EXPECT_EQ(CountLayers(structure, LAYER_FUSED_ATTENTION), 1);
+}
+
+// the attention fused on x86 gives the result of the layers run one by one on the naive device
+TEST(FuseAttentionTest, BroadcastSameResultAsUnfused) {
+    if (GetDevice(DEVICE_X86) == nullptr || GetDevice(DEVICE_NAIVE) == nullptr) {
+        GTEST_SKIP();
+    }
+    NetworkConfig network_config;
+    network_config.precision = PRECISION_HIGH;
+
+    std::map<std::string, std::vector<float>> expect, actual;
+    network_config.device_type = DEVICE_NAIVE;
+    ASSERT_TRUE(ForwardInstance(network_config, CreateAttentionInterpreter(-1), kAttentionShapes, expect) == TNN_OK);
+    network_config.device_type = DEVICE_X86;
+    ASSERT_TRUE(ForwardInstance(network_config, CreateAttentionInterpreter(-1), kAttentionShapes, actual) == TNN_OK);
+
+    auto &output = actual["output"];
+    ASSERT_EQ(output.size(), 2 * 3 * 5 * 6);
+    ASSERT_EQ(output.size(), expect["output"].size());
+    for (int i = 0; i < output.size(); i++) {
+        EXPECT_NEAR(output[i], expect["output"][i], 1e-4f * std::fabs(expect["output"][i]) + 1e-4f) << "index " << i;
+    }
+}
+
+}  // namespace TNN_NS
@@ -0,0 +1,88 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "test/unit_test/unit_test_common.h"
+#include "tnn/interpreter/default_model_interpreter.h"
+#include "tnn/optimizer/net_optimizer_fuse_conv_add.h"
+
+namespace TNN_NS {
+
+// conv [1, 8, 6, 6] followed by an add of the residual input
+static std::shared_ptr<AbstractModelInterpreter> CreateConvAddInterpreter(DimsVector residual_dims,
+                                                                          std::vector<std::string> outputs) {
+    auto interpreter = GenerateEmptyInterpreter({{"input", {1, 4, 6, 6}}, {"residual", residual_dims}}, outputs);
+    AddConvLayer(interpreter, "conv", "input", "conv_output", 4, 8, 3);
+    auto add_param                = std::make_shared<MultidirBroadcastLayerParam>();
+    add_param->weight_input_index = -1;
+    AddLayer(interpreter, "Add", "add", {"conv_output", "residual"}, {"output"}, add_param);
+    return interpreter;
+}
+
+static int OptimizeAndCountLayers(std::shared_ptr<AbstractModelInterpreter> interpreter) {
+    auto default_interpreter = dynamic_cast<DefaultModelInterpreter *>(interpreter.get());
+    NetworkConfig network_config;
+    network_config.device_type = DEVICE_X86;
+    optimizer::NetOptimizerFuseConvAdd optimizer;
+    EXPECT_TRUE(optimizer.Optimize(default_interpreter->GetNetStructure(), default_interpreter->GetNetResource(),
+                                   network_config) == TNN_OK);
+    return (int)default_interpreter->GetNetStructure()->layers.size();
+}
+
+TEST(FuseConvAddTest, FusesOnlyFusableAdds) {
+    EXPECT_EQ(OptimizeAndCountLayers(CreateConvAddInterpreter({1, 8, 6, 6}, {"output"})), 1);
+    // fusing would remove the conv output from the net outputs
+    EXPECT_EQ(OptimizeAndCountLayers(CreateConvAddInterpreter({1, 8, 6, 6}, {"conv_output", "output"})), 2);
+
+    // a residual known to be broadcast is not fused
+    auto interpreter = CreateConvAddInterpreter({1, 8, 1, 1}, {"output"});
+    auto resource    = dynamic_cast<DefaultModelInterpreter *>(interpreter.get())->GetNetResource();
+    resource->blob_shapes_map["conv_output"] = {1, 8, 6, 6};
+    resource->blob_shapes_map["residual"]    = {1, 8, 1, 1};
+    EXPECT_EQ(OptimizeAndCountLayers(interpreter), 2);
+}
+
+// without shapes at optimize time the add of a broadcast residual is fused, and the x86 conv
+// expands the residual to give the result of the layers run one by one on the naive device
+TEST(FuseConvAddTest, BroadcastResidualSameResultAsUnfused) {
+    if (GetDevice(DEVICE_X86) == nullptr || GetDevice(DEVICE_NAIVE) == nullptr) {
+        GTEST_SKIP();
+    }
+    for (auto residual_dims : std::vector<DimsVector>{{1, 8, 6, 6}, {1, 8, 1, 1}, {6}, {1}}) {
+        InputShapesMap input_shapes = {{"input", {1, 4, 6, 6}}, {"residual", residual_dims}};
+        NetworkConfig network_config;
+        network_config.precision = PRECISION_HIGH;
+
+        std::map<std::string, std::vector<float>> expect, actual;
+        network_config.device_type = DEVICE_NAIVE;
+        ASSERT_TRUE(ForwardInstance(network_config, CreateConvAddInterpreter(residual_dims, {"output"}), input_shapes,
+                                    expect) == TNN_OK);
+        network_config.device_type = DEVICE_X86;
+        ASSERT_TRUE(ForwardInstance(network_config, CreateConvAddInterpreter(residual_dims, {"output"}), input_shapes,
+                                    actual) == TNN_OK);
+
+        auto &output = actual["output"];
+        ASSERT_EQ(output.size(), 8 * 6 * 6);
+        ASSERT_EQ(output.size(), expect["output"].size());
+        for (int i = 0; i < output.size(); i++) {
+            EXPECT_NEAR(output[i], expect["output"][i], 1e-4f * std::fabs(expect["output"][i]) + 1e-4f)
+                << "residual rank " << residual_dims.size() << " index " << i;
+        }
+    }
+}
+
+}  // namespace TNN_NS
@@ -0,0 +1,100 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "test/unit_test/unit_test_common.h"
+#include "tnn/core/instance.h"
+#include "tnn/utils/dims_utils.h"
+
+namespace TNN_NS {
+
+// output0 = input0 + input1, input1 is the state of output0
+static std::shared_ptr<Instance> CreateAccumulateInstance(std::vector<int> dims) {
+    auto param                = std::make_shared<MultidirBroadcastLayerParam>();
+    param->name               = "Accumulate";
+    param->weight_input_index = -1;
+    auto interpreter          = GenerateInterpreter("Add", {dims, dims}, param);
+
+    ModelConfig model_config;
+    model_config.params.push_back("");
+    model_config.params.push_back("");
+    NetworkConfig network_config;
+    network_config.device_type = DEVICE_NAIVE;
+
+    auto instance = std::make_shared<Instance>(network_config, model_config);
+    if (instance->Init(interpreter, {{"input0", dims}, {"input1", dims}}) != TNN_OK) {
+        return nullptr;
+    }
+    return instance;
+}
+
+static float ForwardOnes(std::shared_ptr<Instance> instance, int count) {
+    BlobMap input_blobs, output_blobs;
+    instance->GetAllInputBlobs(input_blobs);
+    auto input = reinterpret_cast<float *>(input_blobs["input0"]->GetHandle().base);
+    for (int i = 0; i < count; i++) {
+        input[i] = 1.0f;
+    }
+    if (instance->Forward() != TNN_OK) {
+        return -1.0f;
+    }
+    instance->GetAllOutputBlobs(output_blobs);
+    auto output = reinterpret_cast<float *>(output_blobs["output0"]->GetHandle().base);
+    for (int i = 1; i < count; i++) {
+        if (output[i] != output[0]) {
+            return -1.0f;
+        }
+    }
+    return output[0];
+}
+
+TEST(InstanceStateTest, CarriesStateAcrossForwards) {
+    std::vector<int> dims = {1, 2, 3, 3};
+    int count             = DimsVectorUtils::Count(dims);
+    auto instance         = CreateAccumulateInstance(dims);
+    ASSERT_TRUE(instance != nullptr);
+
+    EXPECT_TRUE(instance->ResetState() != TNN_OK);
+    EXPECT_TRUE(instance->DeclareState("input0", "missing") != TNN_OK);
+    ASSERT_TRUE(instance->DeclareState("input1", "output0") == TNN_OK);
+    EXPECT_TRUE(instance->DeclareState("input1", "output0") != TNN_OK);
+
+    EXPECT_EQ(ForwardOnes(instance, count), 1.0f);
+    EXPECT_EQ(ForwardOnes(instance, count), 2.0f);
+    EXPECT_EQ(ForwardOnes(instance, count), 3.0f);
+
+    // snapshot and restore
+    std::shared_ptr<InstanceState> snapshot;
+    ASSERT_TRUE(instance->SnapshotState(snapshot) == TNN_OK);
+    EXPECT_EQ(ForwardOnes(instance, count), 4.0f);
+    ASSERT_TRUE(instance->RestoreState(snapshot) == TNN_OK);
+    EXPECT_EQ(ForwardOnes(instance, count), 4.0f);
+
+    // multiplex two streams
+    std::shared_ptr<InstanceState> stream0, stream1;
+    ASSERT_TRUE(instance->GetState(stream0) == TNN_OK);
+    ASSERT_TRUE(instance->CreateState(stream1) == TNN_OK);
+    ASSERT_TRUE(instance->SetState(stream1) == TNN_OK);
+    EXPECT_EQ(ForwardOnes(instance, count), 1.0f);
+    ASSERT_TRUE(instance->SetState(stream0) == TNN_OK);
+    EXPECT_EQ(ForwardOnes(instance, count), 5.0f);
+    ASSERT_TRUE(instance->SetState(stream1) == TNN_OK);
+    EXPECT_EQ(ForwardOnes(instance, count), 2.0f);
+
+    ASSERT_TRUE(instance->ResetState() == TNN_OK);
+    EXPECT_EQ(ForwardOnes(instance, count), 1.0f);
+}
+
+}  // namespace TNN_NS
@@ -127,6 +127,7 @@ Status LayerTest::Init(std::shared_ptr<AbstractModelInterpreter> interp, Precisi
     } else {
         config_device.precision = precision;
     }
+    precision_ = config_device.precision;
     if (FLAGS_lp.length() > 0) {
         config_device.library_path = {FLAGS_lp};
     }
@@ -384,10 +385,13 @@ int LayerTest::CompareBlob(Blob* cpu_blob, Blob* device_blob, void* command_queu
 
     // compare data
     int cmp_result = 0;
-    if (blob_desc_device.data_type == DATA_TYPE_FLOAT) {
+    // x86 keeps float blobs with 16 bit weights in reduced precision
+    bool reduced_precision = blob_desc_device.device_type == DEVICE_X86 &&
+                             (precision_ == PRECISION_NORMAL || precision_ == PRECISION_LOW);
+    if (blob_desc_device.data_type == DATA_TYPE_FLOAT && !reduced_precision) {
         cmp_result |= CompareData(static_cast<float*>(cpu_mat.GetData()), static_cast<float*>(dev_cpu_mat.GetData()),
                                   count, 0.01, 0.0001);
-    } else if (blob_desc_device.data_type == DATA_TYPE_HALF) {
+    } else if (blob_desc_device.data_type == DATA_TYPE_FLOAT || blob_desc_device.data_type == DATA_TYPE_HALF) {
         cmp_result |= CompareData(static_cast<float*>(cpu_mat.GetData()), static_cast<float*>(dev_cpu_mat.GetData()),
                                   count, 0.01, 0.001);
     } else if (blob_desc_device.data_type == DATA_TYPE_BFP16) {
@@ -63,6 +63,9 @@ protected:
     static std::shared_ptr<Instance> instance_ocl_cache_;
 
 private:
+    // precision of instance_device_, x86 keeps fp32 blobs but may store weights in 16 bits
+    Precision precision_ = PRECISION_AUTO;
+
     Status GenerateRandomBlob(Blob* cpu_blob, Blob* device_blob, void* command_queue_dev, int magic_num);
     int CompareBlob(Blob* cpu_blob, Blob* device_blob, void* command_queue_dev);
     int CompareDims(DimsVector dims_a, DimsVector dims_b);
@@ -47,7 +47,8 @@ INSTANTIATE_TEST_SUITE_P(LayerTest, ConvLayerTest,
                              testing::Values(DATA_TYPE_FLOAT, DATA_TYPE_HALF),
                              // activation_type
                              testing::Values(ActivationType_None, ActivationType_ReLU, ActivationType_ReLU6,
-                                             ActivationType_SIGMOID_MUL)));
+                                             ActivationType_SIGMOID_MUL, ActivationType_SIGMOID,
+                                             ActivationType_HARDSWISH, ActivationType_GELU)));
 
 TEST_P(ConvLayerTest, ConvLayer) {
     // get param
@@ -80,7 +81,11 @@ TEST_P(ConvLayerTest, ConvLayer) {
     if (activation_type == ActivationType_ReLU6 && DEVICE_X86 == dev) {
         GTEST_SKIP();
     }
-    if (activation_type == ActivationType_SIGMOID_MUL && DEVICE_X86 == dev) {
+
+    // fused by the conv epilogue of x86 only
+    if ((activation_type == ActivationType_SIGMOID || activation_type == ActivationType_HARDSWISH ||
+         activation_type == ActivationType_GELU) &&
+        DEVICE_X86 != dev && DEVICE_NAIVE != dev) {
         GTEST_SKIP();
     }
 
@@ -105,4 +110,115 @@ TEST_P(ConvLayerTest, ConvLayer) {
     Run(interpreter, precision);
 }
 
+class ConvAddLayerTest : public LayerTest,
+                         public ::testing::WithParamInterface<std::tuple<int, int, int, int, int, bool, ActivationType,
+                                                                         FusionType>> {};
+
+INSTANTIATE_TEST_SUITE_P(LayerTest, ConvAddLayerTest,
+                         ::testing::Combine(  // batch
+                             testing::Values(1, 2),
+                             // channel
+                             testing::Values(3, 16, 48),
+                             // hw
+                             testing::Values(9, 16),
+                             // kernel
+                             testing::Values(1, 3, 5),
+                             // stride
+                             testing::Values(1, 2),
+                             // depthwise
+                             testing::Values(false, true),
+                             // activation_type
+                             testing::Values(ActivationType_None, ActivationType_ReLU, ActivationType_ReLU6,
+                                             ActivationType_SIGMOID_MUL, ActivationType_HARDSWISH),
+                             // fusion_type
+                             testing::Values(FusionType_Conv_Add_Activation, FusionType_Conv_Activation_Add)));
+
+TEST_P(ConvAddLayerTest, ConvLayer) {
+    // get param
+    int batch            = std::get<0>(GetParam());
+    int channel          = std::get<1>(GetParam());
+    int input_size       = std::get<2>(GetParam());
+    int kernel           = std::get<3>(GetParam());
+    int stride           = std::get<4>(GetParam());
+    bool depthwise       = std::get<5>(GetParam());
+    auto activation_type = std::get<6>(GetParam());
+    auto fusion_type     = std::get<7>(GetParam());
+    DeviceType dev       = ConvertDeviceType(FLAGS_dt);
+
+    // float conv add fusion runs on x86 only
+    if (DEVICE_X86 != dev && DEVICE_NAIVE != dev) {
+        GTEST_SKIP();
+    }
+
+    // param
+    std::shared_ptr<ConvLayerParam> param(new ConvLayerParam());
+    param->name            = "Conv";
+    param->input_channel   = channel;
+    param->output_channel  = channel;
+    param->group           = depthwise ? channel : 1;
+    param->kernels         = {kernel, kernel};
+    param->dialations      = {1, 1};
+    param->strides         = {stride, stride};
+    param->pads            = {kernel / 2, kernel / 2, kernel / 2, kernel / 2};
+    param->bias            = 1;
+    param->activation_type = activation_type;
+    param->fusion_type     = fusion_type;
+
+    // the residual has the shape of the conv output
+    int output_size             = (input_size + kernel / 2 * 2 - kernel) / stride + 1;
+    std::vector<int> input_dims = {batch, channel, input_size, input_size};
+    std::vector<int> add_dims   = {batch, channel, output_size, output_size};
+
+    auto interpreter = GenerateInterpreter("Convolution", {input_dims, add_dims}, param);
+    Run(interpreter, SetPrecision(dev, DATA_TYPE_FLOAT));
+}
+
+class ConvWinogradLayerTest : public LayerTest,
+                              public ::testing::WithParamInterface<std::tuple<int, int, int, int, ActivationType>> {};
+
+INSTANTIATE_TEST_SUITE_P(LayerTest, ConvWinogradLayerTest,
+                         ::testing::Combine(  // batch
+                             testing::Values(1, 2),
+                             // channel
+                             testing::Values(16, 24),
+                             // hw, including sizes that leave partial tiles
+                             testing::Values(4, 6, 7, 13),
+                             // winograd dst unit
+                             testing::Values(2, 4, 6),
+                             // activation_type
+                             testing::Values(ActivationType_None, ActivationType_ReLU, ActivationType_ReLU6)));
+
+TEST_P(ConvWinogradLayerTest, ConvLayer) {
+    // get param
+    int batch            = std::get<0>(GetParam());
+    int channel          = std::get<1>(GetParam());
+    int input_size       = std::get<2>(GetParam());
+    int winograd_unit    = std::get<3>(GetParam());
+    auto activation_type = std::get<4>(GetParam());
+    DeviceType dev       = ConvertDeviceType(FLAGS_dt);
+
+    // the winograd unit is forced by the x86 conv only
+    if (DEVICE_X86 != dev) {
+        GTEST_SKIP();
+    }
+
+    // param
+    std::shared_ptr<ConvLayerParam> param(new ConvLayerParam());
+    param->name            = "Conv";
+    param->input_channel   = channel;
+    param->output_channel  = channel + 8;
+    param->group           = 1;
+    param->kernels         = {3, 3};
+    param->dialations      = {1, 1};
+    param->strides         = {1, 1};
+    param->pads            = {1, 1, 1, 1};
+    param->bias            = 1;
+    param->activation_type = activation_type;
+    param->extra_config.insert("x86_winograd_unit" + std::to_string(winograd_unit));
+
+    std::vector<int> input_dims = {batch, channel, input_size, input_size};
+    auto interpreter            = GenerateInterpreter("Convolution", {input_dims}, param);
+    Run(interpreter, SetPrecision(dev, DATA_TYPE_FLOAT));
+}
+
 }  // namespace TNN_NS
@@ -0,0 +1,71 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <cmath>
+
+#include "test/unit_test/layer_test/layer_test.h"
+#include "test/unit_test/unit_test_common.h"
+#include "test/unit_test/utils/network_helpers.h"
+#include "tnn/utils/dims_utils.h"
+
+namespace TNN_NS {
+
+class FusedAttentionLayerTest : public LayerTest,
+                                public ::testing::WithParamInterface<std::tuple<int, int, int, int, int, int>> {};
+
+INSTANTIATE_TEST_SUITE_P(LayerTest, FusedAttentionLayerTest,
+                         ::testing::Combine(
+                             // batch, head
+                             testing::Values(1, 2), testing::Values(1, 3),
+                             // sequence length of q and k
+                             testing::Values(1, 7, 40), testing::Values(5, 64, 384),
+                             // head size
+                             testing::Values(8, 64),
+                             // mask: none, [B, 1, 1, S_k], [B, 1, S_q, S_k]
+                             testing::Values(0, 1, 2)));
+
+TEST_P(FusedAttentionLayerTest, FusedAttentionLayer) {
+    // get param
+    int batch      = std::get<0>(GetParam());
+    int head       = std::get<1>(GetParam());
+    int seq_q      = std::get<2>(GetParam());
+    int seq_k      = std::get<3>(GetParam());
+    int head_size  = std::get<4>(GetParam());
+    int mask_type  = std::get<5>(GetParam());
+    DeviceType dev = ConvertDeviceType(FLAGS_dt);
+
+    if (dev != DEVICE_X86 && dev != DEVICE_NAIVE) {
+        GTEST_SKIP();
+    }
+
+    // param
+    std::shared_ptr<FusedAttentionLayerParam> param(new FusedAttentionLayerParam());
+    param->name  = "FusedAttention";
+    param->scale = 1.0f / std::sqrt((float)head_size);
+
+    std::vector<std::vector<int>> input_dims = {{batch, head, seq_q, head_size},
+                                                {batch, head, head_size, seq_k},
+                                                {batch, head, seq_k, head_size}};
+    if (mask_type == 1) {
+        input_dims.push_back({batch, 1, 1, seq_k});
+    } else if (mask_type == 2) {
+        input_dims.push_back({batch, 1, seq_q, seq_k});
+    }
+
+    // generate interpreter
+    auto interpreter = GenerateInterpreter("FusedAttention", input_dims, param);
+    Run(interpreter);
+}
+
+}  // namespace TNN_NS
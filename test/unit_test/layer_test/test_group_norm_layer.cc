@@ -91,4 +91,34 @@ TEST_P(GroupNormLayerTest, GroupNormLayer) {
     Run(interpreter, precision);
 }
 
+// the mean and variance of a group sum every float of the avx2 packs, the input pattern differs between
+// the two 128 bit lanes of a pack
+TEST(GroupNormTest, SumsFullPacks) {
+    if (GetDevice(DEVICE_X86) == nullptr || GetDevice(DEVICE_NAIVE) == nullptr) {
+        GTEST_SKIP();
+    }
+    InputShapesMap input_shapes = {{"input", {2, 4, 4, 4}}, {"scale", {4}}, {"bias", {4}}};
+
+    std::map<std::string, std::vector<float>> expect, actual;
+    for (auto device_type : {DEVICE_NAIVE, DEVICE_X86}) {
+        auto param       = std::make_shared<GroupNormLayerParam>();
+        param->group     = 2;
+        param->eps       = 1e-5f;
+        auto interpreter = GenerateEmptyInterpreter(input_shapes, {"output"});
+        AddLayer(interpreter, "GroupNorm", "group_norm", {"input", "scale", "bias"}, {"output"}, param);
+        NetworkConfig network_config;
+        network_config.device_type = device_type;
+        network_config.precision   = PRECISION_HIGH;
+        ASSERT_TRUE(ForwardInstance(network_config, interpreter, input_shapes,
+                                    device_type == DEVICE_NAIVE ? expect : actual) == TNN_OK);
+    }
+
+    auto &output = actual["output"];
+    ASSERT_EQ(output.size(), 2 * 4 * 4 * 4);
+    ASSERT_EQ(output.size(), expect["output"].size());
+    for (int i = 0; i < output.size(); i++) {
+        EXPECT_NEAR(output[i], expect["output"][i], 1e-4f * std::fabs(expect["output"][i]) + 1e-4f) << "index " << i;
+    }
+}
+
 }  // namespace TNN_NS
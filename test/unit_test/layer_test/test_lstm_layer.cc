@@ -15,6 +15,7 @@
 #include "test/unit_test/layer_test/layer_test.h"
 #include "test/unit_test/unit_test_common.h"
 #include "test/unit_test/utils/network_helpers.h"
+#include "tnn/interpreter/default_model_interpreter.h"
 #include "tnn/utils/dims_vector_utils.h"
 
 namespace TNN_NS {
@@ -95,4 +96,98 @@ TEST_P(LSTMLayerTest, LSTMONNXLayer) {
     Run(interpreter, precision, format, device_format);
 }
 
+// streaming lstm of 3 steps with input size 5, hidden size 8 and constant weights
+static std::shared_ptr<AbstractModelInterpreter> CreateStreamingLSTMInterpreter(int batch, int direction) {
+    const int num_directions = direction == 2 ? 2 : 1;
+    const int input_size = 5, hidden_size = 8;
+    auto interpreter = GenerateEmptyInterpreter({{"input", {3, batch, input_size}}}, {"y", "h", "c"});
+
+    auto default_interpreter = dynamic_cast<DefaultModelInterpreter *>(interpreter.get());
+    auto net_structure       = default_interpreter->GetNetStructure();
+    auto net_resource        = default_interpreter->GetNetResource();
+    std::map<std::string, DimsVector> weight_dims = {{"w", {num_directions, 4 * hidden_size, input_size}},
+                                                     {"r", {num_directions, 4 * hidden_size, hidden_size}},
+                                                     {"b", {num_directions, 8 * hidden_size}}};
+    for (auto item : weight_dims) {
+        const int count = DimsVectorUtils::Count(item.second);
+        auto buffer     = std::make_shared<RawBuffer>(count * sizeof(float));
+        for (int i = 0; i < count; i++) {
+            buffer->force_to<float *>()[i] = (float)((i * 7) % 11 - 5) * 0.05f;
+        }
+        buffer->SetDataType(DATA_TYPE_FLOAT);
+        buffer->SetBufferDims(item.second);
+        net_resource->constant_map[item.first] = buffer;
+        net_structure->blobs.insert(item.first);
+    }
+
+    auto param         = std::make_shared<LSTMONNXLayerParam>();
+    param->hidden_size = hidden_size;
+    param->direction   = direction;
+    param->streaming   = 1;
+    AddLayer(interpreter, "LSTMONNX", "lstm", {"input", "w", "r", "b"}, {"y", "h", "c"}, param);
+    return interpreter;
+}
+
+// forward twice with the first batch size, then twice with each following one, the input is the same every time
+static void ForwardStreamingLSTM(DeviceType device_type, int direction, std::vector<int> batches,
+                                 std::vector<std::vector<float>> &outputs) {
+    NetworkConfig network_config;
+    network_config.device_type = device_type;
+    network_config.precision   = PRECISION_HIGH;
+    ModelConfig model_config;
+    model_config.params.push_back("");
+    model_config.params.push_back("");
+    Instance instance(network_config, model_config);
+    ASSERT_TRUE(instance.Init(CreateStreamingLSTMInterpreter(batches[0], direction),
+                              {{"input", {3, batches[0], 5}}}) == TNN_OK);
+
+    outputs.clear();
+    for (int batch : batches) {
+        ASSERT_TRUE(instance.Reshape({{"input", {3, batch, 5}}}) == TNN_OK);
+        for (int i = 0; i < 2; i++) {
+            std::map<std::string, std::vector<float>> output;
+            ASSERT_TRUE(FillInputBlobs(instance) == TNN_OK);
+            ASSERT_TRUE(instance.Forward() == TNN_OK);
+            ASSERT_TRUE(GetOutputBlobsData(instance, output) == TNN_OK);
+            outputs.push_back(output["y"]);
+        }
+    }
+}
+
+static void ExpectNear(const std::vector<float> &actual, const std::vector<float> &expect, std::string message) {
+    ASSERT_EQ(actual.size(), expect.size()) << message;
+    for (int i = 0; i < expect.size(); i++) {
+        EXPECT_NEAR(actual[i], expect[i], 1e-4f * std::fabs(expect[i]) + 1e-4f) << message << " index " << i;
+    }
+}
+
+// the state of one forward is the initial state of the next one, and restarts when the batch changes
+TEST(LSTMStreamingTest, SameResultAsNaive) {
+    if (GetDevice(DEVICE_X86) == nullptr || GetDevice(DEVICE_NAIVE) == nullptr) {
+        GTEST_SKIP();
+    }
+    for (int direction : {0, 1, 2}) {
+        std::vector<std::vector<float>> expect, actual, fresh;
+        ForwardStreamingLSTM(DEVICE_NAIVE, direction, {2, 1}, expect);
+        ForwardStreamingLSTM(DEVICE_X86, direction, {2, 1}, actual);
+        ASSERT_EQ(actual.size(), 4);
+        ASSERT_EQ(expect.size(), 4);
+        for (int i = 0; i < 4; i++) {
+            ExpectNear(actual[i], expect[i], "direction " + std::to_string(direction) + " forward " +
+                                                 std::to_string(i));
+        }
+        // the second forward of a batch starts from the state of the first one
+        EXPECT_NE(actual[0], actual[1]);
+        EXPECT_NE(actual[2], actual[3]);
+
+        // after the batch change the state restarts, as in a new instance of that batch
+        for (auto device_type : {DEVICE_NAIVE, DEVICE_X86}) {
+            ForwardStreamingLSTM(device_type, direction, {1}, fresh);
+            auto &outputs = device_type == DEVICE_NAIVE ? expect : actual;
+            ExpectNear(outputs[2], fresh[0], "batch change, device " + std::to_string(device_type));
+            ExpectNear(outputs[3], fresh[1], "batch change, device " + std::to_string(device_type));
+        }
+    }
+}
+
 }  // namespace TNN_NS
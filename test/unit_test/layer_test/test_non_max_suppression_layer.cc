@@ -0,0 +1,138 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "test/unit_test/layer_test/layer_test.h"
+#include "test/unit_test/unit_test_common.h"
+#include "test/unit_test/utils/network_helpers.h"
+#include "tnn/utils/dims_utils.h"
+
+namespace TNN_NS {
+
+class NonMaxSuppressionLayerTest
+    : public LayerTest,
+      public ::testing::WithParamInterface<std::tuple<int, int, int, int, int, float, float>> {};
+
+INSTANTIATE_TEST_SUITE_P(LayerTest, NonMaxSuppressionLayerTest,
+                         ::testing::Combine(testing::Values(1, 2),
+                                            // num_boxes
+                                            testing::Values(7, 64, 300),
+                                            // num_classes
+                                            testing::Values(1, 3),
+                                            // center_point_box
+                                            testing::Values(0, 1),
+                                            // max_output_boxes_per_class
+                                            testing::Values(1, 5, 1000),
+                                            // iou_threshold
+                                            testing::Values(0.f, 0.3f, 0.7f),
+                                            // score_threshold
+                                            testing::Values(-1.f, 0.2f)));
+
+TEST_P(NonMaxSuppressionLayerTest, NonMaxSuppressionLayer) {
+    // get param
+    int batch             = std::get<0>(GetParam());
+    int num_boxes         = std::get<1>(GetParam());
+    int num_classes       = std::get<2>(GetParam());
+    int center_point_box  = std::get<3>(GetParam());
+    int max_output        = std::get<4>(GetParam());
+    float iou_threshold   = std::get<5>(GetParam());
+    float score_threshold = std::get<6>(GetParam());
+
+    DeviceType dev = ConvertDeviceType(FLAGS_dt);
+    if (DEVICE_NAIVE != dev && DEVICE_X86 != dev) {
+        GTEST_SKIP();
+    }
+
+    // param
+    std::shared_ptr<NonMaxSuppressionLayerParam> param(new NonMaxSuppressionLayerParam());
+    param->name                       = "NonMaxSuppression";
+    param->center_point_box           = center_point_box;
+    param->max_output_boxes_per_class = max_output;
+    param->iou_threshold              = iou_threshold;
+    param->score_threshold            = score_threshold;
+
+    // generate interpreter
+    std::vector<int> boxes_dims  = {batch, num_boxes, 4};
+    std::vector<int> scores_dims = {batch, num_classes, num_boxes};
+    auto interpreter             = GenerateInterpreter("NonMaxSuppression", {boxes_dims, scores_dims}, param);
+    Run(interpreter);
+}
+
+// run the nms of one batch and class on the naive and x86 devices, boxes are [y1, x1, y2, x2] sorted by score
+static void CheckSelectedIndices(const std::vector<float> &boxes, float iou_threshold,
+                                 const std::vector<int> &expect) {
+    const int num_boxes = (int)boxes.size() / 4;
+    std::vector<float> scores;
+    for (int i = 0; i < num_boxes; i++) {
+        scores.push_back(0.9f - 0.1f * i);
+    }
+    InputShapesMap input_shapes = {{"boxes", {1, num_boxes, 4}}, {"scores", {1, 1, num_boxes}}};
+
+    auto param                        = std::make_shared<NonMaxSuppressionLayerParam>();
+    param->center_point_box           = 0;
+    param->max_output_boxes_per_class = 10;
+    param->iou_threshold              = iou_threshold;
+    param->score_threshold            = 0.f;
+    auto interpreter                  = GenerateEmptyInterpreter(input_shapes, {"selected"});
+    AddLayer(interpreter, "NonMaxSuppression", "nms", {"boxes", "scores"}, {"selected"}, param);
+
+    for (auto device_type : {DEVICE_NAIVE, DEVICE_X86}) {
+        if (GetDevice(device_type) == nullptr) {
+            continue;
+        }
+        NetworkConfig network_config;
+        network_config.device_type = device_type;
+        ModelConfig model_config;
+        model_config.params.push_back("");
+        model_config.params.push_back("");
+        Instance instance(network_config, model_config);
+        ASSERT_TRUE(instance.Init(interpreter, input_shapes) == TNN_OK);
+
+        BlobMap input_blobs, output_blobs;
+        ASSERT_TRUE(instance.GetAllInputBlobs(input_blobs) == TNN_OK);
+        auto boxes_handle  = input_blobs["boxes"]->GetHandle();
+        auto scores_handle = input_blobs["scores"]->GetHandle();
+        memcpy(static_cast<char *>(boxes_handle.base) + boxes_handle.bytes_offset, boxes.data(),
+               boxes.size() * sizeof(float));
+        memcpy(static_cast<char *>(scores_handle.base) + scores_handle.bytes_offset, scores.data(),
+               scores.size() * sizeof(float));
+        ASSERT_TRUE(instance.Forward() == TNN_OK);
+
+        ASSERT_TRUE(instance.GetAllOutputBlobs(output_blobs) == TNN_OK);
+        auto output        = output_blobs["selected"];
+        auto output_handle = output->GetHandle();
+        auto selected = reinterpret_cast<int *>(static_cast<char *>(output_handle.base) + output_handle.bytes_offset);
+        ASSERT_EQ(output->GetBlobDesc().dims[0], (int)expect.size()) << "device " << device_type;
+        for (int i = 0; i < expect.size(); i++) {
+            EXPECT_EQ(selected[i * 3 + 0], 0);
+            EXPECT_EQ(selected[i * 3 + 1], 0);
+            EXPECT_EQ(selected[i * 3 + 2], expect[i]) << "device " << device_type;
+        }
+    }
+}
+
+// boxes sharing only an edge or a corner have no overlap, so they survive a threshold of 0
+TEST(NonMaxSuppressionTest, TouchingBoxesWithZeroThreshold) {
+    // box 3 overlaps box 0 and the others only touch
+    CheckSelectedIndices({0.f, 0.f, 1.f, 1.f, 0.f, 1.f, 1.f, 2.f, 1.f, 1.f, 2.f, 2.f, 0.5f, 0.5f, 1.5f, 1.5f, 2.f, 0.f,
+                          3.f, 1.f},
+                         0.f, {0, 1, 2, 4});
+}
+
+// a box is suppressed only by an iou above the threshold, an iou equal to it keeps the box
+TEST(NonMaxSuppressionTest, IouEqualToThreshold) {
+    // box 1 has an iou of exactly 0.5 with box 0, box 2 of 0.75
+    CheckSelectedIndices({0.f, 0.f, 1.f, 2.f, 0.f, 0.f, 1.f, 1.f, 0.f, 0.f, 1.f, 1.5f}, 0.5f, {0, 1});
+}
+
+}  // namespace TNN_NS
@@ -0,0 +1,109 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "test/unit_test/unit_test_common.h"
+#include "tnn/core/abstract_device.h"
+#include "tnn/core/tnn.h"
+#include "tnn/interpreter/default_model_interpreter.h"
+#include "tnn/interpreter/tnn/model_packer.h"
+
+namespace TNN_NS {
+
+static const char *kProtoFile = "mapped_model_test.tnnproto";
+static const char *kModelFile = "mapped_model_test.tnnmodel";
+
+static std::string ReadFile(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+// a model loaded from "ModelPath:" maps the file read only and uses the aligned weights in place
+TEST(MappedModelTest, SameResultAsModelContent) {
+    std::vector<int> input_dims = {1, 4, 8, 8};
+    auto interpreter            = GenerateEmptyInterpreter({{"input0", input_dims}}, {"output0"});
+    AddConvLayer(interpreter, "conv", "input0", "conv_output", 4, 8, 3);
+    AddInnerProductLayer(interpreter, "inner_product", "conv_output", "output0", 8 * 8 * 8, 10);
+
+    auto default_interpreter = dynamic_cast<DefaultModelInterpreter *>(interpreter.get());
+    ModelPacker packer(default_interpreter->GetNetStructure(), default_interpreter->GetNetResource());
+    packer.SetDataAlignment(64);
+    ASSERT_TRUE(packer.Pack(kProtoFile, kModelFile) == TNN_OK);
+    const std::string proto = ReadFile(kProtoFile);
+
+    for (auto device_type : {DEVICE_NAIVE, DEVICE_X86}) {
+        if (GetDevice(device_type) == nullptr) {
+            continue;
+        }
+        NetworkConfig network_config;
+        network_config.device_type = device_type;
+        network_config.precision   = PRECISION_HIGH;
+        std::map<std::string, std::vector<float>> expect, actual;
+        ASSERT_TRUE(ForwardInstance(network_config, interpreter, {{"input0", input_dims}}, expect) == TNN_OK);
+
+        ModelConfig model_config;
+        model_config.params = {proto, std::string("ModelPath:") + kModelFile};
+        TNN net;
+        ASSERT_TRUE(net.Init(model_config) == TNN_OK);
+        Status status;
+        auto instance = net.CreateInst(network_config, status, {{"input0", input_dims}});
+        ASSERT_TRUE(status == TNN_OK);
+        ASSERT_TRUE(FillInputBlobs(*instance) == TNN_OK);
+        ASSERT_TRUE(instance->Forward() == TNN_OK);
+        ASSERT_TRUE(GetOutputBlobsData(*instance, actual) == TNN_OK);
+        EXPECT_EQ(actual, expect);
+    }
+
+    std::remove(kProtoFile);
+    std::remove(kModelFile);
+}
+
+// the params md5 of a mapped model is the md5 of the file content, not of its path
+TEST(MappedModelTest, ParamsMd5OfFileContent) {
+    std::vector<int> input_dims = {1, 4, 8, 8};
+    auto interpreter            = GenerateEmptyInterpreter({{"input0", input_dims}}, {"output0"});
+    AddConvLayer(interpreter, "conv", "input0", "output0", 4, 8, 3);
+
+    auto default_interpreter = dynamic_cast<DefaultModelInterpreter *>(interpreter.get());
+    ModelPacker packer(default_interpreter->GetNetStructure(), default_interpreter->GetNetResource());
+    packer.SetDataAlignment(64);
+    ASSERT_TRUE(packer.Pack(kProtoFile, kModelFile) == TNN_OK);
+
+    std::vector<std::string> content_params = {ReadFile(kProtoFile), ReadFile(kModelFile)};
+    std::vector<std::string> mapped_params  = {content_params[0], std::string("ModelPath:") + kModelFile};
+    std::shared_ptr<AbstractModelInterpreter> content_interpreter(CreateModelInterpreter(MODEL_TYPE_TNN));
+    std::shared_ptr<AbstractModelInterpreter> mapped_interpreter(CreateModelInterpreter(MODEL_TYPE_TNN));
+    ASSERT_TRUE(content_interpreter->Interpret(content_params) == TNN_OK);
+    ASSERT_TRUE(mapped_interpreter->Interpret(mapped_params) == TNN_OK);
+
+    auto content_md5 = dynamic_cast<DefaultModelInterpreter *>(content_interpreter.get())->GetParamsMd5();
+    auto mapped_md5  = dynamic_cast<DefaultModelInterpreter *>(mapped_interpreter.get())->GetParamsMd5();
+    EXPECT_EQ(mapped_md5, content_md5);
+
+    std::vector<std::string> missing_params = {content_params[0], "ModelPath:mapped_model_test.missing"};
+    std::shared_ptr<AbstractModelInterpreter> missing_interpreter(CreateModelInterpreter(MODEL_TYPE_TNN));
+    EXPECT_FALSE(missing_interpreter->Interpret(missing_params) == TNN_OK);
+
+    std::remove(kProtoFile);
+    std::remove(kModelFile);
+}
+
+}  // namespace TNN_NS
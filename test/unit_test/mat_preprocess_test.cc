@@ -0,0 +1,87 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "test/unit_test/unit_test_common.h"
+#include "tnn/core/abstract_device.h"
+#include "tnn/utils/dims_utils.h"
+#include "tnn/utils/mat_utils.h"
+
+namespace TNN_NS {
+
+class MatPreprocessTest : public ::testing::TestWithParam<std::tuple<MatType, InterpType, bool>> {};
+
+INSTANTIATE_TEST_SUITE_P(MatPreprocessTest, MatPreprocessTest,
+                         ::testing::Combine(testing::Values(N8UC3, N8UC4, NGRAY, NNV12, NNV21),
+                                            testing::Values(INTERP_TYPE_LINEAR, INTERP_TYPE_NEAREST),
+                                            testing::Values(false, true)));
+
+// the fused x86 path matches the step by step chain of the naive device, up to the uint8 rounding of the
+// intermediate mats in the chain
+TEST_P(MatPreprocessTest, SameResultAsStepByStep) {
+    if (GetDevice(DEVICE_X86) == nullptr) {
+        GTEST_SKIP();
+    }
+    const MatType mat_type     = std::get<0>(GetParam());
+    const InterpType interp    = std::get<1>(GetParam());
+    const bool reverse_channel = std::get<2>(GetParam());
+    const bool is_yuv          = mat_type == NNV12 || mat_type == NNV21;
+
+    const int batch = 2, src_h = 30, src_w = 38;
+    int channel     = mat_type == NGRAY ? 1 : 3;
+    int mat_channel = mat_type == N8UC4 ? 4 : channel;
+    int mat_count   = is_yuv ? batch * src_h * src_w * 3 / 2 : batch * mat_channel * src_h * src_w;
+
+    Mat src(DEVICE_NAIVE, mat_type, {batch, mat_channel, src_h, src_w});
+    auto src_data = reinterpret_cast<uint8_t *>(src.GetData());
+    for (int i = 0; i < mat_count; i++) {
+        src_data[i] = (uint8_t)((i * 37 + i / 7) % 256);
+    }
+
+    PreprocessParam param;
+    param.crop.top_left_x               = 4;
+    param.crop.top_left_y               = 2;
+    param.crop.width                    = 30;
+    param.crop.height                   = 22;
+    param.interp_type                   = interp;
+    param.convert_param.scale           = {0.5f, 0.25f, 2.0f, 1.0f};
+    param.convert_param.bias            = {-10.0f, 3.0f, 0.5f, 0.0f};
+    // the naive blob converter reverses channels of bgr(a) mats only
+    param.convert_param.reverse_channel = reverse_channel && (mat_type == N8UC3 || mat_type == N8UC4);
+
+    BlobDesc desc;
+    desc.dims        = {batch, channel, 17, 45};
+    desc.data_type   = DATA_TYPE_FLOAT;
+    desc.data_format = DATA_FORMAT_NCHW;
+    desc.device_type = DEVICE_NAIVE;
+    Blob expect(desc, true);
+    desc.device_type = DEVICE_X86;
+    Blob actual(desc, true);
+
+    ASSERT_TRUE(MatUtils::Preprocess(src, &expect, param, nullptr) == TNN_OK);
+    ASSERT_TRUE(MatUtils::Preprocess(src, &actual, param, nullptr) == TNN_OK);
+
+    const int count  = DimsVectorUtils::Count(desc.dims);
+    const int hw     = DimsVectorUtils::Count(desc.dims, 2);
+    auto expect_data = reinterpret_cast<float *>(expect.GetHandle().base);
+    auto actual_data = reinterpret_cast<float *>(actual.GetHandle().base);
+    for (int i = 0; i < count; i++) {
+        const float scale = param.convert_param.scale[i / hw % channel];
+        ASSERT_NEAR(actual_data[i], expect_data[i], scale + 1e-3f) << "index " << i;
+    }
+}
+
+}  // namespace TNN_NS
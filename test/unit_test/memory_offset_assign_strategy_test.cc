@@ -0,0 +1,193 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "test/unit_test/unit_test_common.h"
+#include "tnn/core/abstract_device.h"
+#include "tnn/memory_manager/blob_1d_memory.h"
+#include "tnn/memory_manager/memory_offset_assign_strategy.h"
+
+namespace TNN_NS {
+
+// blob memory of bytes_size bytes alive from layer begin to layer end, begin -1 for no live range
+struct TestBlobMemory {
+    int64_t bytes_size;
+    int begin;
+    int end;
+};
+
+class MemoryOffsetPlanTest {
+public:
+    explicit MemoryOffsetPlanTest(std::vector<TestBlobMemory> infos) : infos_(infos) {
+        for (auto &info : infos) {
+            BlobMemorySizeInfo size_info;
+            size_info.data_type = DATA_TYPE_INT8;
+            size_info.dims      = {(int)info.bytes_size};
+            auto blob_memory    = std::make_shared<Blob1DMemory>(nullptr, size_info);
+            if (info.begin >= 0) {
+                blob_memory->UpdateLiveRange(info.begin);
+                blob_memory->UpdateLiveRange(info.end);
+            }
+            memories_.push_back(blob_memory);
+            library_.insert(blob_memory.get());
+        }
+        plan_ = MemoryOffsetAssignStrategy::Plan(library_);
+    }
+
+    const MemoryOffsetPlan &GetPlan() {
+        return plan_;
+    }
+
+    int64_t GetOffset(int index) {
+        return plan_.offsets[memories_[index].get()];
+    }
+
+    // every memory is aligned, fits in the arena and does not share bytes with memory alive at the same time
+    void CheckValid() {
+        ASSERT_EQ(plan_.offsets.size(), infos_.size());
+        for (int i = 0; i < infos_.size(); i++) {
+            const int64_t offset = GetOffset(i);
+            EXPECT_GE(offset, 0);
+            EXPECT_EQ(offset % 64, 0);
+            EXPECT_LE(offset + infos_[i].bytes_size, plan_.peak_size);
+            for (int j = i + 1; j < infos_.size(); j++) {
+                if (!IsAliveTogether(infos_[i], infos_[j])) {
+                    continue;
+                }
+                const int64_t other = GetOffset(j);
+                EXPECT_TRUE(offset + infos_[i].bytes_size <= other || other + infos_[j].bytes_size <= offset)
+                    << "memory " << i << " [" << offset << ", " << offset + infos_[i].bytes_size << ") and " << j
+                    << " [" << other << ", " << other + infos_[j].bytes_size << ") overlap";
+            }
+        }
+        EXPECT_GE(plan_.peak_size, plan_.lower_bound);
+    }
+
+private:
+    static bool IsAliveTogether(const TestBlobMemory &a, const TestBlobMemory &b) {
+        if (a.begin < 0 || b.begin < 0) {
+            return true;
+        }
+        return a.begin <= b.end && b.begin <= a.end;
+    }
+
+    std::vector<TestBlobMemory> infos_;
+    std::vector<std::shared_ptr<BlobMemory>> memories_;
+    std::set<BlobMemory *> library_;
+    MemoryOffsetPlan plan_;
+};
+
+TEST(MemoryOffsetAssignStrategyTest, OverlappingRangesGetDisjointBytes) {
+    // every pair overlaps at layer 2
+    MemoryOffsetPlanTest test({{256, 0, 2}, {128, 1, 3}, {64, 2, 2}, {512, 2, 5}});
+    test.CheckValid();
+    EXPECT_EQ(test.GetPlan().lower_bound, 256 + 128 + 64 + 512);
+    EXPECT_EQ(test.GetPlan().peak_size, test.GetPlan().lower_bound);
+
+    // memory without live range is alive with all the others
+    MemoryOffsetPlanTest unknown({{128, -1, -1}, {128, 0, 0}, {128, 1, 1}});
+    unknown.CheckValid();
+    EXPECT_EQ(unknown.GetPlan().peak_size, 256);
+}
+
+TEST(MemoryOffsetAssignStrategyTest, DisjointRangesReuseBytes) {
+    // a chain of layers, each output dies at the layer after the one creating it
+    MemoryOffsetPlanTest chain({{256, 0, 1}, {256, 1, 2}, {256, 2, 3}, {256, 3, 4}});
+    chain.CheckValid();
+    EXPECT_EQ(chain.GetPlan().lower_bound, 512);
+    EXPECT_EQ(chain.GetPlan().peak_size, 512);
+    EXPECT_EQ(chain.GetOffset(0), chain.GetOffset(2));
+    EXPECT_EQ(chain.GetOffset(1), chain.GetOffset(3));
+
+    // a small memory fits in the gap left by a large one
+    MemoryOffsetPlanTest gap({{1024, 0, 1}, {256, 2, 3}, {512, 2, 3}, {1024, 0, 3}});
+    gap.CheckValid();
+    EXPECT_EQ(gap.GetPlan().peak_size, 2048);
+}
+
+TEST(MemoryOffsetAssignStrategyTest, PeakSizeBound) {
+    // sizes are rounded up to the alignment
+    MemoryOffsetPlanTest aligned({{1, 0, 0}, {65, 0, 0}});
+    aligned.CheckValid();
+    EXPECT_EQ(aligned.GetPlan().lower_bound, 64 + 128);
+    EXPECT_EQ(aligned.GetPlan().peak_size, 64 + 128);
+
+    MemoryOffsetPlanTest empty({});
+    EXPECT_EQ(empty.GetPlan().peak_size, 0);
+    EXPECT_EQ(empty.GetPlan().lower_bound, 0);
+
+    // a deterministic net like pattern: the peak stays between the lower bound and no reuse at all
+    std::vector<TestBlobMemory> infos;
+    int64_t total_size = 0;
+    for (int i = 0; i < 40; i++) {
+        const int begin          = (i * 7) % 30;
+        const int64_t bytes_size = 64 * (1 + (i * 13) % 9);
+        infos.push_back({bytes_size, begin, begin + 1 + (i * 5) % 4});
+        total_size += bytes_size;
+    }
+    MemoryOffsetPlanTest net(infos);
+    net.CheckValid();
+    EXPECT_LT(net.GetPlan().peak_size, total_size);
+}
+
+// a chain of convs with a skip branch, the forward memory of an instance is reported next to its lower bound
+TEST(MemoryOffsetAssignStrategyTest, InstanceReportsLowerBound) {
+    std::vector<int> input_dims = {1, 8, 16, 16};
+    auto interpreter            = GenerateEmptyInterpreter({{"input0", input_dims}}, {"output0"});
+    AddConvLayer(interpreter, "conv0", "input0", "conv0_output", 8, 16, 3);
+    AddConvLayer(interpreter, "conv1", "conv0_output", "conv1_output", 16, 32, 1);
+    AddConvLayer(interpreter, "conv2", "conv1_output", "conv2_output", 32, 16, 3);
+    AddConvLayer(interpreter, "conv3", "conv2_output", "conv3_output", 16, 16, 1);
+    auto add_param                = std::make_shared<MultidirBroadcastLayerParam>();
+    add_param->weight_input_index = -1;
+    AddLayer(interpreter, "Add", "add", {"conv0_output", "conv3_output"}, {"output0"}, add_param);
+
+    for (auto device_type : {DEVICE_NAIVE, DEVICE_X86}) {
+        if (GetDevice(device_type) == nullptr) {
+            continue;
+        }
+        ModelConfig model_config;
+        model_config.params.push_back("");
+        model_config.params.push_back("");
+        NetworkConfig network_config;
+        network_config.device_type = device_type;
+        network_config.precision   = PRECISION_HIGH;
+
+        // the nearest size strategy does not solve a lower bound
+        int memory_size = 0, lower_bound = 0;
+        {
+            Instance instance(network_config, model_config);
+            ASSERT_TRUE(instance.Init(interpreter, {{"input0", input_dims}}) == TNN_OK);
+            EXPECT_FALSE(instance.GetForwardMemoryLowerBound(lower_bound) == TNN_OK);
+        }
+
+        network_config.memory_plan_mode = MEMORY_PLAN_MODE_OFFSET_PACK;
+        Instance instance(network_config, model_config);
+        ASSERT_TRUE(instance.Init(interpreter, {{"input0", input_dims}}) == TNN_OK);
+        ASSERT_TRUE(instance.GetForwardMemorySize(memory_size) == TNN_OK);
+        ASSERT_TRUE(instance.GetForwardMemoryLowerBound(lower_bound) == TNN_OK);
+        // conv0_output is alive until the add, next to the largest blob conv1_output
+        const int conv0_bytes = 16 * 16 * 16 * sizeof(float);
+        const int conv1_bytes = 32 * 16 * 16 * sizeof(float);
+        EXPECT_GE(lower_bound, conv0_bytes + conv1_bytes);
+        EXPECT_GE(memory_size, lower_bound);
+    }
+}
+
+}  // namespace TNN_NS
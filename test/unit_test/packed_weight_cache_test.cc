@@ -0,0 +1,65 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "tnn/core/abstract_device.h"
+#include "tnn/core/packed_weight_cache.h"
+
+namespace TNN_NS {
+
+static const int kFilterCount = 4096;
+
+static RawBuffer CreateTestFilter(int changed_index) {
+    RawBuffer filter(kFilterCount * sizeof(float));
+    for (int i = 0; i < kFilterCount; i++) {
+        filter.force_to<float *>()[i] = (float)(i % 11) * 0.5f;
+    }
+    filter.force_to<float *>()[changed_index] += 1.0f;
+    return filter;
+}
+
+// filters of the same layer that differ in a single value must not share packed weights
+TEST(PackedWeightCacheTest, FiltersDifferingInOneValue) {
+    auto device = GetDevice(DEVICE_NAIVE);
+    ASSERT_TRUE(device != nullptr);
+    std::shared_ptr<Context> context(device->CreateContext(0));
+    context->SetModelHash("packed_weight_cache_test");
+    ConvLayerParam param;
+    param.name = "conv";
+
+    // a byte sampling stride of 64 would skip the changed values
+    RawBuffer filter0 = CreateTestFilter(1);
+    RawBuffer filter1 = CreateTestFilter(kFilterCount - 3);
+    auto key0 = PackedWeightCache::CreateKey(context.get(), &param, DEVICE_NAIVE, "test", filter0);
+    auto key1 = PackedWeightCache::CreateKey(context.get(), &param, DEVICE_NAIVE, "test", filter1);
+    EXPECT_NE(key0.ToString(), key1.ToString());
+    auto key0_again = PackedWeightCache::CreateKey(context.get(), &param, DEVICE_NAIVE, "test", filter0);
+    EXPECT_EQ(key0.ToString(), key0_again.ToString());
+
+    auto copy_packer = [](const RawBuffer &filter) {
+        return [filter](RawBuffer &packed) {
+            packed = RawBuffer(filter.GetBytesSize(), filter.force_to<char *>());
+            return Status(TNN_OK);
+        };
+    };
+    RawBuffer packed0, packed1;
+    ASSERT_TRUE(PackedWeightCache::GetOrPack(key0, copy_packer(filter0), packed0) == TNN_OK);
+    ASSERT_TRUE(PackedWeightCache::GetOrPack(key1, copy_packer(filter1), packed1) == TNN_OK);
+    EXPECT_NE(packed0.force_to<float *>(), packed1.force_to<float *>());
+    EXPECT_EQ(packed0.force_to<float *>()[1], filter0.force_to<float *>()[1]);
+    EXPECT_EQ(packed1.force_to<float *>()[kFilterCount - 3], filter1.force_to<float *>()[kFilterCount - 3]);
+}
+
+}  // namespace TNN_NS
@@ -0,0 +1,165 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "test/unit_test/unit_test_common.h"
+#include "tnn/core/abstract_device.h"
+#include "tnn/core/packed_weight_cache.h"
+#include "tnn/interpreter/tnn/model_interpreter.h"
+#include "tnn/utils/md5.h"
+#include "tnn/utils/string_utils_inner.h"
+
+namespace TNN_NS {
+
+static const char *kPackedWeightFile = "packed_weight_file_test.packed";
+static const int kWeightCount        = 1000;
+
+static PackedWeightKey CreateTestKey(const std::string &layer_name) {
+    PackedWeightKey key;
+    key.model_hash  = "packed_weight_file_test";
+    key.layer_name  = layer_name;
+    key.device_type = DEVICE_X86;
+    key.precision   = PRECISION_HIGH;
+    key.variant     = "test";
+    key.source      = "source";
+    return key;
+}
+
+static Status PackTestWeight(RawBuffer &packed) {
+    RawBuffer buffer(kWeightCount * sizeof(float));
+    for (int i = 0; i < kWeightCount; i++) {
+        buffer.force_to<float *>()[i] = (float)i * 0.5f;
+    }
+    packed = buffer;
+    return TNN_OK;
+}
+
+// weights packed by the first network are mapped by the later ones instead of packed again
+TEST(PackedWeightFileTest, MapSavedWeights) {
+    std::remove(kPackedWeightFile);
+    {
+        RawBuffer conv1, conv2;
+        ASSERT_TRUE(PackedWeightCache::GetOrPack(CreateTestKey("conv1"), PackTestWeight, conv1) == TNN_OK);
+        ASSERT_TRUE(PackedWeightCache::GetOrPack(CreateTestKey("conv2"), PackTestWeight, conv2) == TNN_OK);
+        ASSERT_TRUE(PackedWeightCache::SaveFile(kPackedWeightFile, "packed_weight_file_test", DEVICE_X86,
+                                                PRECISION_HIGH, "isa") == TNN_OK);
+    }
+
+    // another isa packs again
+    std::shared_ptr<void> holder;
+    EXPECT_FALSE(PackedWeightCache::LoadFile(kPackedWeightFile, "other_isa", holder) == TNN_OK);
+    ASSERT_TRUE(PackedWeightCache::LoadFile(kPackedWeightFile, "isa", holder) == TNN_OK);
+
+    bool packed_again = false;
+    auto packer       = [&](RawBuffer &packed) {
+        packed_again = true;
+        return PackTestWeight(packed);
+    };
+    RawBuffer conv1;
+    ASSERT_TRUE(PackedWeightCache::GetOrPack(CreateTestKey("conv1"), packer, conv1) == TNN_OK);
+    EXPECT_FALSE(packed_again);
+    ASSERT_EQ(conv1.GetBytesSize(), kWeightCount * sizeof(float));
+    for (int i = 0; i < kWeightCount; i++) {
+        ASSERT_EQ(conv1.force_to<float *>()[i], (float)i * 0.5f) << "index " << i;
+    }
+
+    // the mapped weights outlive the holder while a layer uses them
+    holder = nullptr;
+    RawBuffer conv1_shared, conv2;
+    ASSERT_TRUE(PackedWeightCache::GetOrPack(CreateTestKey("conv1"), packer, conv1_shared) == TNN_OK);
+    EXPECT_FALSE(packed_again);
+    EXPECT_EQ(conv1_shared.force_to<float *>(), conv1.force_to<float *>());
+    ASSERT_TRUE(PackedWeightCache::GetOrPack(CreateTestKey("conv2"), packer, conv2) == TNN_OK);
+    EXPECT_TRUE(packed_again);
+
+    std::remove(kPackedWeightFile);
+}
+
+static std::string ReadFile(const std::string &path) {
+    std::ifstream stream(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+// networks with a cache path need the params md5, which generated nets do not have
+class PackedWeightTestInterpreter : public ModelInterpreter {
+public:
+    PackedWeightTestInterpreter() {
+        params_md5_ = {"packed_weight_file_test_proto", "packed_weight_file_test_model"};
+    }
+};
+
+// a matmul of the input by a constant weight, packed by X86MatMulLayerAcc through PackedWeightCache
+static std::shared_ptr<AbstractModelInterpreter> CreateMatMulInterpreter(std::vector<int> input_dims, int m) {
+    auto interpreter                = std::make_shared<PackedWeightTestInterpreter>();
+    NetStructure *net_structure     = interpreter->GetNetStructure();
+    net_structure->inputs_shape_map = {{"input0", input_dims}};
+    net_structure->blobs.insert("input0");
+    net_structure->outputs.insert("output0");
+
+    const int k            = input_dims.back();
+    auto param             = std::make_shared<MatMulLayerParam>();
+    param->weight_position = 1;
+    auto resource          = std::make_shared<MatMulLayerResource>();
+    resource->weight       = RawBuffer(k * m * sizeof(float));
+    for (int i = 0; i < k * m; i++) {
+        resource->weight.force_to<float *>()[i] = (float)(i % 11 - 5) * 0.125f;
+    }
+    resource->weight.SetBufferDims({k, m});
+    AddLayer(interpreter, "MatMul", "matmul", {"input0"}, {"output0"}, param, resource);
+    return interpreter;
+}
+
+// the packed matmul weight is saved by the first network and mapped by the next one, which writes nothing
+TEST(PackedWeightFileTest, MapSavedMatMulWeights) {
+    if (GetDevice(DEVICE_X86) == nullptr) {
+        GTEST_SKIP();
+    }
+    std::vector<int> input_dims = {1, 2, 8, 40};
+    auto interpreter            = CreateMatMulInterpreter(input_dims, 24);
+
+    NetworkConfig config;
+    config.device_type               = DEVICE_X86;
+    config.precision                 = PRECISION_HIGH;
+    config.enable_packed_weight_file = true;
+    config.cache_path                = ".";
+    // named by DefaultNetwork from the model hash, the md5 of proto and model
+    const std::string file = "./d1_" + ToString(DEVICE_X86) + "_" + ToString(PRECISION_HIGH) + "_" +
+                             md5("packed_weight_file_test_proto_packed_weight_file_test_model") + ".packed";
+    std::remove(file.c_str());
+
+    std::map<std::string, std::vector<float>> expect, actual;
+    ASSERT_TRUE(ForwardInstance(config, interpreter, {{"input0", input_dims}}, expect) == TNN_OK);
+    auto saved = ReadFile(file);
+    ASSERT_FALSE(saved.empty());
+    EXPECT_NE(saved.find("matmul_b_"), std::string::npos);
+
+    // trailing bytes are not read by the loader, and dropped if the weights are packed and saved again
+    {
+        std::ofstream stream(file, std::ios::binary | std::ios::app);
+        stream << "untouched_marker";
+    }
+    ASSERT_TRUE(ForwardInstance(config, interpreter, {{"input0", input_dims}}, actual) == TNN_OK);
+    EXPECT_EQ(ReadFile(file), saved + "untouched_marker");
+    EXPECT_EQ(actual["output0"], expect["output0"]);
+
+    std::remove(file.c_str());
+}
+
+}  // namespace TNN_NS
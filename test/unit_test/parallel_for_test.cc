@@ -0,0 +1,127 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "tnn/utils/parallel_for.h"
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace TNN_NS {
+
+TEST(ParallelForTest, RunsEveryIterationOnce) {
+    auto pool = std::make_shared<ParallelForPool>(3);
+    std::vector<std::atomic<int>> visits(1000);
+    for (auto &v : visits) {
+        v = 0;
+    }
+    pool->Run(0, (int)visits.size(), [&](int begin, int end, int thread_id) {
+        for (int i = begin; i < end; i++) {
+            visits[i]++;
+        }
+    });
+    for (auto &v : visits) {
+        EXPECT_EQ(v.load(), 1);
+    }
+}
+
+// loops run by several threads on one pool never use a thread id at the same time,
+// and nested loops keep the thread id of the outer one
+TEST(ParallelForTest, ConcurrentLoopsUseDistinctThreadIds) {
+    auto pool = std::make_shared<ParallelForPool>(3);
+    std::vector<std::atomic<int>> in_use(pool->GetNumThreads());
+    for (auto &v : in_use) {
+        v = 0;
+    }
+    std::atomic<int> shared_ids(0), nested_ids(0);
+    auto run_loops = [&]() {
+        for (int r = 0; r < 50; r++) {
+            pool->Run(0, 16, [&](int begin, int end, int thread_id) {
+                if (in_use[thread_id]++ != 0) {
+                    shared_ids++;
+                }
+                pool->Run(0, 2, [&](int nested_begin, int nested_end, int nested_thread_id) {
+                    if (nested_thread_id != thread_id) {
+                        nested_ids++;
+                    }
+                });
+                std::this_thread::yield();
+                in_use[thread_id]--;
+            });
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 3; i++) {
+        threads.emplace_back(run_loops);
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(shared_ids.load(), 0);
+    EXPECT_EQ(nested_ids.load(), 0);
+}
+
+#if defined(__linux__)
+static std::vector<int> GetThreadCpus() {
+    std::vector<int> cpus;
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (sched_getaffinity(0, sizeof(mask), &mask) != 0) {
+        return cpus;
+    }
+    for (int i = 0; i < CPU_SETSIZE; i++) {
+        if (CPU_ISSET(i, &mask)) {
+            cpus.push_back(i);
+        }
+    }
+    return cpus;
+}
+
+// workers of the pool and the forwarding thread only run on the cpus of the pool,
+// the forwarding thread gets its former cpus back when the pool is unbound
+TEST(ParallelForTest, BindsThreadsToCpuAffinity) {
+    auto initial_cpus = GetThreadCpus();
+    ASSERT_FALSE(initial_cpus.empty());
+    const int cpu = initial_cpus.back();
+
+    auto pool = std::make_shared<ParallelForPool>(3, std::vector<int>({cpu}));
+    BindParallelForPool(pool);
+    EXPECT_EQ(GetThreadCpus(), std::vector<int>({cpu}));
+
+    std::vector<std::vector<int>> thread_cpus(pool->GetNumThreads());
+    std::vector<int> thread_used(pool->GetNumThreads(), 0);
+    ParallelForWithThreadId(0, 64, [&](int i, int thread_id) {
+        if (!thread_used[thread_id]) {
+            thread_used[thread_id] = 1;
+            thread_cpus[thread_id] = GetThreadCpus();
+        }
+    });
+    for (int i = 0; i < pool->GetNumThreads(); i++) {
+        if (thread_used[i]) {
+            EXPECT_EQ(thread_cpus[i], std::vector<int>({cpu})) << "thread " << i;
+        }
+    }
+
+    BindParallelForPool(nullptr);
+    EXPECT_EQ(GetThreadCpus(), initial_cpus);
+}
+#endif
+
+}  // namespace TNN_NS
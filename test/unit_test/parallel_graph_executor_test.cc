@@ -0,0 +1,83 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "test/unit_test/unit_test_common.h"
+#include "tnn/core/abstract_device.h"
+#include "tnn/utils/dims_utils.h"
+
+namespace TNN_NS {
+
+// input -> conv -> conv -+-> add -> output0
+//       -> conv ---------+
+//       -> inner product ---> output1
+static std::shared_ptr<AbstractModelInterpreter> CreateBranchedInterpreter(std::vector<int> input_dims) {
+    const int channel = input_dims[1];
+    auto interpreter  = GenerateEmptyInterpreter({{"input0", input_dims}}, {"output0", "output1"});
+    AddConvLayer(interpreter, "conv_a0", "input0", "conv_a0_output", channel, 16, 3);
+    AddConvLayer(interpreter, "conv_a1", "conv_a0_output", "conv_a1_output", 16, 16, 1);
+    AddConvLayer(interpreter, "conv_b0", "input0", "conv_b0_output", channel, 16, 3);
+
+    auto add_param                = std::make_shared<MultidirBroadcastLayerParam>();
+    add_param->weight_input_index = -1;
+    AddLayer(interpreter, "Add", "add", {"conv_a1_output", "conv_b0_output"}, {"output0"}, add_param);
+
+    AddInnerProductLayer(interpreter, "inner_product", "input0", "output1", DimsVectorUtils::Count(input_dims, 1), 10);
+    return interpreter;
+}
+
+TEST(ParallelGraphExecutorTest, SameResultAsSerial) {
+    std::vector<int> input_dims = {2, 8, 12, 12};
+    auto interpreter            = CreateBranchedInterpreter(input_dims);
+
+    for (auto device_type : {DEVICE_NAIVE, DEVICE_X86}) {
+        if (GetDevice(device_type) == nullptr) {
+            continue;
+        }
+        NetworkConfig network_config;
+        network_config.device_type = device_type;
+        network_config.precision   = PRECISION_HIGH;
+
+        std::map<std::string, std::vector<float>> expect, actual;
+        ASSERT_TRUE(ForwardInstance(network_config, interpreter, {{"input0", input_dims}}, expect) == TNN_OK);
+
+        network_config.inter_op_num_threads = 3;
+        ModelConfig model_config;
+        model_config.params.push_back("");
+        model_config.params.push_back("");
+        Instance instance(network_config, model_config);
+        ASSERT_TRUE(instance.Init(interpreter, {{"input0", input_dims}}) == TNN_OK);
+        instance.SetCpuNumThreads(4);
+        ASSERT_TRUE(FillInputBlobs(instance) == TNN_OK);
+        // forward twice, the graph is built once and reused
+        for (int i = 0; i < 2; i++) {
+            ASSERT_TRUE(instance.Forward() == TNN_OK);
+            ASSERT_TRUE(GetOutputBlobsData(instance, actual) == TNN_OK);
+            ASSERT_EQ(actual.size(), expect.size());
+            for (auto item : expect) {
+                auto &output = actual[item.first];
+                ASSERT_EQ(output.size(), item.second.size());
+                for (int j = 0; j < output.size(); j++) {
+                    EXPECT_NEAR(output[j], item.second[j], 1e-4f * std::fabs(item.second[j]) + 1e-4f)
+                        << item.first << " index " << j;
+                }
+            }
+        }
+    }
+}
+
+}  // namespace TNN_NS
@@ -0,0 +1,76 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+#include <gtest/gtest.h>
+
+#include "test/unit_test/unit_test_common.h"
+#include "tnn/core/abstract_device.h"
+#include "tnn/utils/dims_utils.h"
+
+namespace TNN_NS {
+
+// branches of conv and inner product layers on one input, many more layers than init threads,
+// so that layer accs of different shapes and impls are initialized side by side
+static std::shared_ptr<AbstractModelInterpreter> CreateWideInterpreter(std::vector<int> input_dims, int num_branches,
+                                                                       std::vector<std::string> &outputs) {
+    outputs.clear();
+    for (int i = 0; i < num_branches; i++) {
+        outputs.push_back("output" + std::to_string(i));
+    }
+    auto interpreter  = GenerateEmptyInterpreter({{"input0", input_dims}}, outputs);
+    const int channel = input_dims[1];
+    for (int i = 0; i < num_branches; i++) {
+        const std::string branch = "branch" + std::to_string(i);
+        if (i % 3 == 2) {
+            AddInnerProductLayer(interpreter, branch + "_ip", "input0", outputs[i], DimsVectorUtils::Count(input_dims, 1),
+                                 8 + i);
+            continue;
+        }
+        const int kernel         = i % 3 == 0 ? 3 : 1;
+        const int output_channel = 8 + 4 * (i % 4);
+        AddConvLayer(interpreter, branch + "_conv0", "input0", branch + "_conv0_output", channel, output_channel,
+                     kernel);
+        AddConvLayer(interpreter, branch + "_conv1", branch + "_conv0_output", outputs[i], output_channel, 16,
+                     i % 2 ? 3 : 5);
+    }
+    return interpreter;
+}
+
+TEST(ParallelInitTest, SameResultAsInitInOrder) {
+    std::vector<int> input_dims = {1, 8, 10, 10};
+    std::vector<std::string> outputs;
+    auto interpreter = CreateWideInterpreter(input_dims, 12, outputs);
+
+    for (auto device_type : {DEVICE_NAIVE, DEVICE_X86}) {
+        if (GetDevice(device_type) == nullptr) {
+            continue;
+        }
+        NetworkConfig network_config;
+        network_config.device_type = device_type;
+        network_config.precision   = PRECISION_HIGH;
+
+        std::map<std::string, std::vector<float>> expect, actual;
+        network_config.init_num_threads = 1;
+        ASSERT_TRUE(ForwardInstance(network_config, interpreter, {{"input0", input_dims}}, expect) == TNN_OK);
+        network_config.init_num_threads = 4;
+        ASSERT_TRUE(ForwardInstance(network_config, interpreter, {{"input0", input_dims}}, actual) == TNN_OK);
+
+        ASSERT_EQ(expect.size(), outputs.size());
+        for (auto &name : outputs) {
+            ASSERT_EQ(actual.count(name), 1);
+            EXPECT_EQ(expect[name], actual[name]) << "output " << name;
+        }
+    }
+}
+
+}  // namespace TNN_NS
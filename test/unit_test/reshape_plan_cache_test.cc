@@ -0,0 +1,211 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+#include "test/unit_test/unit_test_common.h"
+#include "tnn/core/abstract_device.h"
+#include "tnn/core/instance.h"
+#include "tnn/interpreter/default_model_interpreter.h"
+#include "tnn/core/reshape_plan_cache.h"
+#include "tnn/utils/dims_utils.h"
+
+namespace TNN_NS {
+
+TEST(ReshapePlanCacheTest, DropsLeastRecentlyUsed) {
+    ReshapePlanCache cache(2);
+    InputShapesMap shape0 = {{"input", {1, 3}}};
+    InputShapesMap shape1 = {{"input", {2, 3}}};
+    InputShapesMap shape2 = {{"input", {4, 3}}};
+    auto plan0            = std::make_shared<ReshapePlan>();
+    auto plan1            = std::make_shared<ReshapePlan>();
+
+    cache.Put(shape0, plan0);
+    cache.Put(shape1, plan1);
+    EXPECT_EQ(cache.Get(shape0), plan0);
+    // shape1 is the least recently used
+    cache.Put(shape2, std::make_shared<ReshapePlan>());
+    EXPECT_EQ(cache.GetSize(), 2);
+    EXPECT_TRUE(cache.Get(shape1) == nullptr);
+    EXPECT_EQ(cache.Get(shape0), plan0);
+
+    ReshapePlanCache disabled(0);
+    disabled.Put(shape0, plan0);
+    EXPECT_TRUE(disabled.Get(shape0) == nullptr);
+}
+
+TEST(ReshapePlanCacheTest, ReshapesBackToCachedShapes) {
+    std::vector<int> max_dims = {4, 2, 3, 3};
+    auto param                = std::make_shared<MultidirBroadcastLayerParam>();
+    param->name               = "Add";
+    param->weight_input_index = -1;
+    auto interpreter          = GenerateInterpreter("Add", {max_dims, max_dims}, param);
+
+    ModelConfig model_config;
+    model_config.params.push_back("");
+    model_config.params.push_back("");
+    NetworkConfig network_config;
+    network_config.device_type             = DEVICE_NAIVE;
+    network_config.reshape_plan_cache_size = 2;
+
+    Instance instance(network_config, model_config);
+    ASSERT_TRUE(instance.Init(interpreter, {{"input0", max_dims}, {"input1", max_dims}}) == TNN_OK);
+
+    for (int batch : {1, 2, 1, 4, 3, 1, 2}) {
+        std::vector<int> dims = {batch, 2, 3, 3};
+        ASSERT_TRUE(instance.Reshape({{"input0", dims}, {"input1", dims}}) == TNN_OK);
+
+        BlobMap input_blobs, output_blobs;
+        instance.GetAllInputBlobs(input_blobs);
+        const int count = DimsVectorUtils::Count(dims);
+        auto input0     = reinterpret_cast<float *>(input_blobs["input0"]->GetHandle().base);
+        auto input1     = reinterpret_cast<float *>(input_blobs["input1"]->GetHandle().base);
+        for (int i = 0; i < count; i++) {
+            input0[i] = (float)i;
+            input1[i] = (float)batch;
+        }
+        ASSERT_TRUE(instance.Forward() == TNN_OK);
+
+        instance.GetAllOutputBlobs(output_blobs);
+        auto output = output_blobs["output0"];
+        ASSERT_TRUE(DimsVectorUtils::Equal(output->GetBlobDesc().dims, dims));
+        auto output_data = reinterpret_cast<float *>(output->GetHandle().base);
+        for (int i = 0; i < count; i++) {
+            ASSERT_EQ(output_data[i], (float)(i + batch));
+        }
+    }
+}
+
+// convs with SAME padding and pools whose pads or kernels follow from the input sizes
+static std::shared_ptr<AbstractModelInterpreter> CreateConvPoolInterpreter(std::vector<int> input_dims,
+                                                                           int num_blocks) {
+    auto interpreter = GenerateEmptyInterpreter({{"input0", input_dims}}, {"output0"});
+    auto structure   = dynamic_cast<DefaultModelInterpreter *>(interpreter.get())->GetNetStructure();
+    std::string input = "input0";
+    int channel       = input_dims[1];
+    for (int i = 0; i < num_blocks; i++) {
+        const std::string block = "block" + std::to_string(i);
+        // the first blocks downsample, the others keep the size
+        const bool downsample = i < 2;
+        AddConvLayer(interpreter, block + "_conv", input, block + "_conv_output", channel, 8, 3, downsample ? 2 : 1);
+        auto conv_param      = dynamic_cast<ConvLayerParam *>(structure->layers.back()->param.get());
+        conv_param->pad_type = 0;
+
+        auto pool_param            = std::make_shared<PoolingLayerParam>();
+        pool_param->pool_type      = 0;
+        pool_param->kernels_params = {3, 3};
+        pool_param->kernels        = {3, 3};
+        pool_param->kernel_indexs  = {-1, -1};
+        pool_param->strides        = downsample ? std::vector<int>({2, 2}) : std::vector<int>({1, 1});
+        pool_param->pads           = downsample ? std::vector<int>({0, 0, 0, 0}) : std::vector<int>({1, 1, 1, 1});
+        pool_param->pad_type       = -1;
+        pool_param->ceil_mode      = downsample ? 1 : 0;
+        AddLayer(interpreter, "Pooling", block + "_pool", {block + "_conv_output"}, {block + "_pool_output"},
+                 pool_param);
+        input   = block + "_pool_output";
+        channel = 8;
+    }
+
+    // global average pooling takes its kernels from the input sizes
+    auto global_param            = std::make_shared<PoolingLayerParam>();
+    global_param->pool_type      = 1;
+    global_param->kernels_params = {0, 0};
+    global_param->kernels        = {0, 0};
+    global_param->kernel_indexs  = {-1, -1};
+    global_param->strides        = {1, 1};
+    global_param->pads           = {0, 0, 0, 0};
+    global_param->pad_type       = -1;
+    AddLayer(interpreter, "Pooling", "global_pool", {input}, {"output0"}, global_param);
+    return interpreter;
+}
+
+// reshaping back to a cached shape restores the pads and kernels conv and pooling inferred for it
+TEST(ReshapePlanCacheTest, RestoresInferredConvAndPoolingParams) {
+    std::vector<int> max_dims = {1, 3, 19, 19};
+    auto interpreter          = CreateConvPoolInterpreter(max_dims, 2);
+
+    for (auto device_type : {DEVICE_NAIVE, DEVICE_X86}) {
+        if (GetDevice(device_type) == nullptr) {
+            continue;
+        }
+        ModelConfig model_config;
+        model_config.params.push_back("");
+        model_config.params.push_back("");
+        NetworkConfig network_config;
+        network_config.device_type = device_type;
+        network_config.precision   = PRECISION_HIGH;
+        EXPECT_EQ(network_config.reshape_plan_cache_size, 0);
+
+        NetworkConfig cached_config            = network_config;
+        cached_config.reshape_plan_cache_size = 4;
+        Instance instance(cached_config, model_config);
+        ASSERT_TRUE(instance.Init(interpreter, {{"input0", max_dims}}) == TNN_OK);
+        for (int size : {12, 19, 12, 15, 19, 15, 12}) {
+            InputShapesMap input_shapes = {{"input0", {1, 3, size, size}}};
+            ASSERT_TRUE(instance.Reshape(input_shapes) == TNN_OK);
+            ASSERT_TRUE(FillInputBlobs(instance) == TNN_OK);
+            ASSERT_TRUE(instance.Forward() == TNN_OK);
+            std::map<std::string, std::vector<float>> expect, actual;
+            ASSERT_TRUE(GetOutputBlobsData(instance, actual) == TNN_OK);
+
+            // an instance created at this shape infers every layer
+            ASSERT_TRUE(ForwardInstance(network_config, interpreter, input_shapes, expect) == TNN_OK);
+            ASSERT_EQ(actual["output0"].size(), expect["output0"].size());
+            for (size_t i = 0; i < expect["output0"].size(); i++) {
+                EXPECT_NEAR(actual["output0"][i], expect["output0"][i], 1e-4f * std::fabs(expect["output0"][i]) + 1e-4f)
+                    << "size " << size << " index " << i;
+            }
+        }
+    }
+}
+
+// reshape time of a deep conv net flipping between recurring shapes, printed for both settings
+TEST(ReshapePlanCacheTest, CachedReshapeTime) {
+    std::vector<int> max_dims = {1, 3, 64, 64};
+    auto interpreter          = CreateConvPoolInterpreter(max_dims, 16);
+    const int reshape_count   = 200;
+
+    for (auto device_type : {DEVICE_NAIVE, DEVICE_X86}) {
+        if (GetDevice(device_type) == nullptr) {
+            continue;
+        }
+        double time_ms[2] = {0, 0};
+        for (int cache_size : {0, 4}) {
+            ModelConfig model_config;
+            model_config.params.push_back("");
+            model_config.params.push_back("");
+            NetworkConfig network_config;
+            network_config.device_type             = device_type;
+            network_config.precision               = PRECISION_HIGH;
+            network_config.reshape_plan_cache_size = cache_size;
+
+            Instance instance(network_config, model_config);
+            ASSERT_TRUE(instance.Init(interpreter, {{"input0", max_dims}}) == TNN_OK);
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < reshape_count; i++) {
+                const int size = i % 2 ? 64 : 48 + 8 * (i % 3);
+                ASSERT_TRUE(instance.Reshape({{"input0", {1, 3, size, size}}}) == TNN_OK);
+            }
+            time_ms[cache_size > 0] =
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+        printf("ReshapePlanCacheTest device %d: %d reshapes of 33 layers %.3f ms, with the plan cache %.3f ms\n",
+               (int)device_type, reshape_count, time_ms[0], time_ms[1]);
+    }
+}
+
+}  // namespace TNN_NS
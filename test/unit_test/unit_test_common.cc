@@ -22,6 +22,7 @@
 #include "tnn/core/macro.h"
 #include "tnn/interpreter/default_model_interpreter.h"
 #include "tnn/utils/bfp16.h"
+#include "tnn/utils/dims_utils.h"
 
 namespace TNN_NS {
 
@@ -160,4 +161,143 @@ std::shared_ptr<AbstractModelInterpreter> GenerateInterpreter(std::string layer_
     return std::shared_ptr<AbstractModelInterpreter>(interpreter);
 }
 
+std::shared_ptr<AbstractModelInterpreter> GenerateEmptyInterpreter(InputShapesMap input_shapes,
+                                                                   std::vector<std::string> outputs) {
+    auto interpreter = CreateModelInterpreter(MODEL_TYPE_TNN);
+    if (!interpreter) {
+        return nullptr;
+    }
+    DefaultModelInterpreter* default_interpreter = dynamic_cast<DefaultModelInterpreter*>(interpreter);
+    if (!default_interpreter) {
+        delete interpreter;
+        return nullptr;
+    }
+
+    NetStructure* net_structure    = default_interpreter->GetNetStructure();
+    net_structure->inputs_shape_map = input_shapes;
+    for (auto item : input_shapes) {
+        net_structure->blobs.insert(item.first);
+    }
+    for (auto name : outputs) {
+        net_structure->outputs.insert(name);
+    }
+    return std::shared_ptr<AbstractModelInterpreter>(interpreter);
+}
+
+void AddLayer(std::shared_ptr<AbstractModelInterpreter> interpreter, std::string layer_type_str,
+              std::string layer_name, std::vector<std::string> inputs, std::vector<std::string> outputs,
+              std::shared_ptr<LayerParam> param, std::shared_ptr<LayerResource> resource) {
+    auto default_interpreter = dynamic_cast<DefaultModelInterpreter*>(interpreter.get());
+    NetStructure* net_structure = default_interpreter->GetNetStructure();
+    NetResource* net_resource   = default_interpreter->GetNetResource();
+
+    std::shared_ptr<LayerInfo> layer_info = std::make_shared<LayerInfo>();
+    layer_info->type                      = GlobalConvertLayerType(layer_type_str);
+    layer_info->type_str                  = layer_type_str;
+    layer_info->name                      = layer_name;
+    layer_info->inputs                    = inputs;
+    layer_info->outputs                   = outputs;
+    layer_info->param                     = param;
+    param->type                           = layer_type_str;
+    param->name                           = layer_name;
+    for (auto name : outputs) {
+        net_structure->blobs.insert(name);
+    }
+    net_structure->layers.push_back(layer_info);
+
+    if (nullptr != resource) {
+        net_resource->resource_map[layer_name] = resource;
+    }
+}
+
+void AddConvLayer(std::shared_ptr<AbstractModelInterpreter> interpreter, std::string layer_name, std::string input,
+                  std::string output, int input_channel, int output_channel, int kernel, int stride) {
+    auto param            = std::make_shared<ConvLayerParam>();
+    param->input_channel  = input_channel;
+    param->output_channel = output_channel;
+    param->kernels        = {kernel, kernel};
+    param->dialations     = {1, 1};
+    param->strides        = {stride, stride};
+    param->pads           = {kernel / 2, kernel / 2, kernel / 2, kernel / 2};
+    param->bias           = 1;
+
+    auto resource         = std::make_shared<ConvLayerResource>();
+    const int filter_size = output_channel * input_channel * kernel * kernel;
+    RawBuffer filter(filter_size * sizeof(float));
+    RawBuffer bias(output_channel * sizeof(float));
+    for (int i = 0; i < filter_size; i++) {
+        filter.force_to<float*>()[i] = (float)(i % 7 - 3) * 0.125f;
+    }
+    for (int i = 0; i < output_channel; i++) {
+        bias.force_to<float*>()[i] = (float)(i % 3 - 1) * 0.5f;
+    }
+    resource->filter_handle = filter;
+    resource->bias_handle   = bias;
+
+    AddLayer(interpreter, "Convolution", layer_name, {input}, {output}, param, resource);
+}
+
+void AddInnerProductLayer(std::shared_ptr<AbstractModelInterpreter> interpreter, std::string layer_name,
+                          std::string input, std::string output, int input_count, int num_output) {
+    auto param        = std::make_shared<InnerProductLayerParam>();
+    param->num_output = num_output;
+    param->has_bias   = 1;
+    param->axis       = 1;
+
+    auto resource = std::make_shared<InnerProductLayerResource>();
+    RawBuffer weight(input_count * num_output * sizeof(float));
+    RawBuffer bias(num_output * sizeof(float));
+    for (int i = 0; i < input_count * num_output; i++) {
+        weight.force_to<float*>()[i] = (float)(i % 7 - 3) * 0.25f;
+    }
+    for (int i = 0; i < num_output; i++) {
+        bias.force_to<float*>()[i] = (float)i;
+    }
+    resource->weight_handle = weight;
+    resource->bias_handle   = bias;
+
+    AddLayer(interpreter, "InnerProduct", layer_name, {input}, {output}, param, resource);
+}
+
+Status FillInputBlobs(Instance& instance) {
+    BlobMap input_blobs;
+    RETURN_ON_NEQ(instance.GetAllInputBlobs(input_blobs), TNN_OK);
+    int offset = 0;
+    for (auto item : input_blobs) {
+        auto handle = item.second->GetHandle();
+        auto data   = reinterpret_cast<float*>(static_cast<char*>(handle.base) + handle.bytes_offset);
+        const int count = DimsVectorUtils::Count(item.second->GetBlobDesc().dims);
+        for (int i = 0; i < count; i++) {
+            data[i] = (float)((i + offset) % 5) * 0.5f - 1.0f;
+        }
+        offset++;
+    }
+    return TNN_OK;
+}
+
+Status GetOutputBlobsData(Instance& instance, std::map<std::string, std::vector<float>>& outputs) {
+    BlobMap output_blobs;
+    RETURN_ON_NEQ(instance.GetAllOutputBlobs(output_blobs), TNN_OK);
+    outputs.clear();
+    for (auto item : output_blobs) {
+        auto handle = item.second->GetHandle();
+        auto data   = reinterpret_cast<float*>(static_cast<char*>(handle.base) + handle.bytes_offset);
+        outputs[item.first].assign(data, data + DimsVectorUtils::Count(item.second->GetBlobDesc().dims));
+    }
+    return TNN_OK;
+}
+
+Status ForwardInstance(NetworkConfig network_config, std::shared_ptr<AbstractModelInterpreter> interpreter,
+                       InputShapesMap input_shapes, std::map<std::string, std::vector<float>>& outputs) {
+    ModelConfig model_config;
+    model_config.params.push_back("");
+    model_config.params.push_back("");
+
+    Instance instance(network_config, model_config);
+    RETURN_ON_NEQ(instance.Init(interpreter, input_shapes), TNN_OK);
+    RETURN_ON_NEQ(FillInputBlobs(instance), TNN_OK);
+    RETURN_ON_NEQ(instance.Forward(), TNN_OK);
+    return GetOutputBlobsData(instance, outputs);
+}
+
 }  // namespace TNN_NS
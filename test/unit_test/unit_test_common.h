@@ -16,12 +16,14 @@
 #define TNN_TEST_UNIT_TEST_COMMON_H_
 
 #include <chrono>
+#include <map>
 #include <random>
 #include <string>
 #include <vector>
 
 #include "tnn/core/abstract_device.h"
 #include "tnn/core/context.h"
+#include "tnn/core/instance.h"
 #include "tnn/core/macro.h"
 #include "tnn/interpreter/abstract_model_interpreter.h"
 #include "tnn/interpreter/layer_param.h"
@@ -40,6 +42,27 @@ std::shared_ptr<AbstractModelInterpreter> GenerateInterpreter(std::string layer_
                                                               int output_count                        = 1,
                                                               std::vector<DataType> input_dtype       = {});
 
+// helpers to build small multi-layer nets, the weights are deterministic so that
+// every instance of one interpreter computes the same
+std::shared_ptr<AbstractModelInterpreter> GenerateEmptyInterpreter(InputShapesMap input_shapes,
+                                                                   std::vector<std::string> outputs);
+void AddLayer(std::shared_ptr<AbstractModelInterpreter> interpreter, std::string layer_type_str,
+              std::string layer_name, std::vector<std::string> inputs, std::vector<std::string> outputs,
+              std::shared_ptr<LayerParam> param, std::shared_ptr<LayerResource> resource = nullptr);
+// same padding for odd kernels
+void AddConvLayer(std::shared_ptr<AbstractModelInterpreter> interpreter, std::string layer_name, std::string input,
+                  std::string output, int input_channel, int output_channel, int kernel, int stride = 1);
+void AddInnerProductLayer(std::shared_ptr<AbstractModelInterpreter> interpreter, std::string layer_name,
+                          std::string input, std::string output, int input_count, int num_output);
+
+// fill the nchw float inputs of an initialized instance with a fixed pattern
+Status FillInputBlobs(Instance &instance);
+// copy the nchw float outputs of an instance
+Status GetOutputBlobsData(Instance &instance, std::map<std::string, std::vector<float>> &outputs);
+// init an instance, fill its inputs and forward it
+Status ForwardInstance(NetworkConfig network_config, std::shared_ptr<AbstractModelInterpreter> interpreter,
+                       InputShapesMap input_shapes, std::map<std::string, std::vector<float>> &outputs);
+
 }  // namespace TNN_NS
 
 #endif  // TNN_TEST_UNIT_TEST_COMMON_H_
@@ -0,0 +1,196 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "test/unit_test/unit_test_common.h"
+#include "tnn/core/blob.h"
+#include "tnn/core/mat.h"
+#include "tnn/utils/blob_converter.h"
+#include "tnn/utils/dims_utils.h"
+
+namespace TNN_NS {
+
+// the x86 float blob converters against the scalar default converter of the naive device,
+// widths cover the vector loops and their tails
+
+struct FloatConvertCase {
+    MatType mat_type;
+    int channel;
+    bool reverse_channel;
+};
+
+static int GetMatChannel(MatType mat_type, int channel) {
+    if (mat_type == N8UC4) {
+        return 4;
+    } else if (mat_type == N8UC3) {
+        return 3;
+    } else if (mat_type == NGRAY) {
+        return 1;
+    }
+    return channel;
+}
+
+static int GetMatCount(MatType mat_type, int batch, int channel, int height, int width) {
+    if (mat_type == NNV12 || mat_type == NNV21) {
+        return batch * height * width * 3 / 2;
+    }
+    return batch * GetMatChannel(mat_type, channel) * height * width;
+}
+
+static MatConvertParam GetConvertParam(int channel, bool reverse_channel) {
+    MatConvertParam param;
+    param.scale.resize(channel);
+    param.bias.resize(channel);
+    for (int c = 0; c < channel; c++) {
+        param.scale[c] = c % 2 ? 0.5f : 1.0f;
+        param.bias[c]  = c % 2 ? -8.0f : 1.0f;
+    }
+    param.reverse_channel = reverse_channel;
+    return param;
+}
+
+// mat to blob on the device, the blob is returned as nchw float
+static Status ConvertFromMat(DeviceType device_type, const FloatConvertCase &test_case, DimsVector dims,
+                             std::vector<uint8_t> &mat_data, std::vector<float> &blob_data) {
+    BlobDesc desc;
+    desc.device_type = device_type;
+    desc.data_type   = DATA_TYPE_FLOAT;
+    desc.data_format = DATA_FORMAT_NCHW;
+    desc.dims        = dims;
+    Blob blob(desc, true);
+
+    Mat mat(DEVICE_NAIVE, test_case.mat_type, dims, mat_data.data());
+    BlobConverter converter(&blob);
+    RETURN_ON_NEQ(converter.ConvertFromMat(mat, GetConvertParam(test_case.channel, test_case.reverse_channel),
+                                           nullptr),
+                  TNN_OK);
+    auto data = static_cast<float *>(blob.GetHandle().base);
+    blob_data.assign(data, data + DimsVectorUtils::Count(dims));
+    return TNN_OK;
+}
+
+// blob to mat on the device, mat_data keeps its bytes where the converter does not write
+static Status ConvertToMat(DeviceType device_type, const FloatConvertCase &test_case, DimsVector dims,
+                           std::vector<float> &blob_data, std::vector<uint8_t> &mat_data) {
+    BlobDesc desc;
+    desc.device_type = device_type;
+    desc.data_type   = DATA_TYPE_FLOAT;
+    desc.data_format = DATA_FORMAT_NCHW;
+    desc.dims        = dims;
+    BlobHandle handle;
+    handle.base = blob_data.data();
+    Blob blob(desc, handle);
+
+    Mat mat(DEVICE_NAIVE, test_case.mat_type, dims, mat_data.data());
+    BlobConverter converter(&blob);
+    return converter.ConvertToMat(mat, GetConvertParam(test_case.channel, test_case.reverse_channel), nullptr);
+}
+
+static std::string GetCaseName(const FloatConvertCase &test_case, DimsVector dims) {
+    return "mat type " + std::to_string(test_case.mat_type) + " channel " + std::to_string(test_case.channel) +
+           " reverse " + std::to_string(test_case.reverse_channel) + " dims " + std::to_string(dims[0]) + "x" +
+           std::to_string(dims[1]) + "x" + std::to_string(dims[2]) + "x" + std::to_string(dims[3]);
+}
+
+TEST(X86BlobConvertFloatTest, MatToBlobSameAsDefault) {
+    if (GetDevice(DEVICE_X86) == nullptr || GetDevice(DEVICE_NAIVE) == nullptr) {
+        GTEST_SKIP();
+    }
+    // the default converter does not reverse yuv mats
+    std::vector<FloatConvertCase> cases = {{N8UC4, 4, false}, {N8UC4, 3, true},  {N8UC3, 3, false},
+                                           {N8UC3, 3, true},  {NGRAY, 1, false}, {NNV12, 3, false},
+                                           {NNV21, 3, false}, {NCHW_FLOAT, 4, false}};
+    for (const auto &test_case : cases) {
+        const bool is_yuv = test_case.mat_type == NNV12 || test_case.mat_type == NNV21;
+        for (int width : {1, 3, 5, 7, 9, 15, 17, 31, 33, 63, 65}) {
+            for (int height : {1, 3}) {
+                // yuv420 has one uv pair per 2x2 pixels
+                DimsVector dims = {2, test_case.channel, is_yuv ? height + 1 : height, is_yuv ? width + 1 : width};
+                const int count = GetMatCount(test_case.mat_type, dims[0], dims[1], dims[2], dims[3]);
+
+                std::vector<uint8_t> mat_data;
+                if (test_case.mat_type == NCHW_FLOAT) {
+                    std::vector<float> float_data(count);
+                    for (int i = 0; i < count; i++) {
+                        float_data[i] = (float)((i * 37) % 300 - 20) + 0.3f;
+                    }
+                    mat_data.assign((uint8_t *)float_data.data(), (uint8_t *)(float_data.data() + count));
+                } else {
+                    mat_data.resize(count);
+                    for (int i = 0; i < count; i++) {
+                        mat_data[i] = (uint8_t)((i * 37) % 256);
+                    }
+                }
+
+                std::vector<float> expect, actual;
+                ASSERT_TRUE(ConvertFromMat(DEVICE_NAIVE, test_case, dims, mat_data, expect) == TNN_OK);
+                ASSERT_TRUE(ConvertFromMat(DEVICE_X86, test_case, dims, mat_data, actual) == TNN_OK);
+                ASSERT_EQ(actual.size(), expect.size());
+                for (int i = 0; i < expect.size(); i++) {
+                    EXPECT_NEAR(actual[i], expect[i], 1e-5f * std::fabs(expect[i]) + 1e-5f)
+                        << GetCaseName(test_case, dims) << " index " << i;
+                }
+            }
+        }
+    }
+}
+
+TEST(X86BlobConvertFloatTest, BlobToMatSameAsDefault) {
+    if (GetDevice(DEVICE_X86) == nullptr || GetDevice(DEVICE_NAIVE) == nullptr) {
+        GTEST_SKIP();
+    }
+    std::vector<FloatConvertCase> cases = {{N8UC4, 4, false}, {N8UC4, 3, false}, {N8UC4, 4, true},
+                                           {N8UC3, 3, false}, {N8UC3, 3, true},  {NGRAY, 1, false},
+                                           {NCHW_FLOAT, 4, false}};
+    for (const auto &test_case : cases) {
+        for (int width : {1, 3, 5, 7, 9, 15, 17, 31, 33, 63, 65}) {
+            for (int height : {1, 3}) {
+                DimsVector dims       = {2, test_case.channel, height, width};
+                const int blob_count  = DimsVectorUtils::Count(dims);
+                const int mat_count   = GetMatCount(test_case.mat_type, dims[0], dims[1], dims[2], dims[3]);
+                const int bytes_count = test_case.mat_type == NCHW_FLOAT ? mat_count * sizeof(float) : mat_count;
+
+                // values out of [0, 255] saturate, and no value rounds from a tie
+                std::vector<float> blob_data(blob_count);
+                for (int i = 0; i < blob_count; i++) {
+                    blob_data[i] = (float)((i * 37) % 300 - 20) + 0.3f;
+                }
+
+                std::vector<uint8_t> expect(bytes_count, 7), actual(bytes_count, 7);
+                ASSERT_TRUE(ConvertToMat(DEVICE_NAIVE, test_case, dims, blob_data, expect) == TNN_OK);
+                ASSERT_TRUE(ConvertToMat(DEVICE_X86, test_case, dims, blob_data, actual) == TNN_OK);
+                if (test_case.mat_type == NCHW_FLOAT) {
+                    auto expect_data = reinterpret_cast<float *>(expect.data());
+                    auto actual_data = reinterpret_cast<float *>(actual.data());
+                    for (int i = 0; i < mat_count; i++) {
+                        EXPECT_NEAR(actual_data[i], expect_data[i], 1e-5f * std::fabs(expect_data[i]) + 1e-5f)
+                            << GetCaseName(test_case, dims) << " index " << i;
+                    }
+                } else {
+                    for (int i = 0; i < mat_count; i++) {
+                        EXPECT_EQ(actual[i], expect[i]) << GetCaseName(test_case, dims) << " index " << i;
+                    }
+                }
+            }
+        }
+    }
+}
+
+}  // namespace TNN_NS
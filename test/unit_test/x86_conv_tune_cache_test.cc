@@ -0,0 +1,129 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "test/unit_test/unit_test_common.h"
+#include "tnn/core/abstract_device.h"
+#include "tnn/interpreter/tnn/model_interpreter.h"
+
+namespace TNN_NS {
+
+static const char *kTuneCacheFile    = "./tnn_x86_tune.cache";
+static const char *kTuneCacheVersion = "tnn_x86_tune_v1";
+// lines without a config are skipped by the loader, and dropped when the file is written again
+static const char *kUntouchedMarker = "untouched_marker";
+
+static std::vector<std::string> ReadLines(const std::string &file) {
+    std::vector<std::string> lines;
+    std::ifstream stream(file);
+    std::string line;
+    while (std::getline(stream, line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+static void WriteLines(const std::string &file, const std::vector<std::string> &lines) {
+    std::ofstream stream(file);
+    for (auto &line : lines) {
+        stream << line << std::endl;
+    }
+}
+
+// networks with a cache path need the params md5, which generated nets do not have
+class TuneCacheTestInterpreter : public ModelInterpreter {
+public:
+    TuneCacheTestInterpreter() {
+        params_md5_ = {"x86_conv_tune_cache_test"};
+    }
+};
+
+static std::shared_ptr<AbstractModelInterpreter> CreateConvInterpreter(std::vector<int> input_dims) {
+    auto interpreter                = std::make_shared<TuneCacheTestInterpreter>();
+    NetStructure *net_structure     = interpreter->GetNetStructure();
+    net_structure->inputs_shape_map = {{"input0", input_dims}};
+    net_structure->blobs.insert("input0");
+    net_structure->outputs.insert("output0");
+    AddConvLayer(interpreter, "conv3x3", "input0", "conv3x3_output", input_dims[1], 16, 3);
+    AddConvLayer(interpreter, "conv1x1", "conv3x3_output", "output0", 16, 8, 1);
+    return interpreter;
+}
+
+static void ExpectSameAsNaive(std::shared_ptr<AbstractModelInterpreter> interpreter, std::vector<int> input_dims) {
+    NetworkConfig naive_config, x86_config;
+    naive_config.device_type      = DEVICE_NAIVE;
+    naive_config.precision        = PRECISION_HIGH;
+    x86_config.device_type        = DEVICE_X86;
+    x86_config.precision          = PRECISION_HIGH;
+    x86_config.enable_tune_kernel = true;
+    x86_config.cache_path         = ".";
+
+    std::map<std::string, std::vector<float>> expect, actual;
+    ASSERT_TRUE(ForwardInstance(naive_config, interpreter, {{"input0", input_dims}}, expect) == TNN_OK);
+    ASSERT_TRUE(ForwardInstance(x86_config, interpreter, {{"input0", input_dims}}, actual) == TNN_OK);
+    ASSERT_EQ(actual["output0"].size(), expect["output0"].size());
+    for (size_t i = 0; i < expect["output0"].size(); i++) {
+        EXPECT_NEAR(actual["output0"][i], expect["output0"][i], 1e-4f * std::fabs(expect["output0"][i]) + 1e-4f)
+            << "index " << i;
+    }
+}
+
+// the first init benchmarks the convs and stores their configs, later inits take them from the file
+TEST(X86ConvTuneCacheTest, StoresAndReusesTunedConfigs) {
+    if (GetDevice(DEVICE_X86) == nullptr || GetDevice(DEVICE_NAIVE) == nullptr) {
+        GTEST_SKIP();
+    }
+    std::vector<int> input_dims = {1, 8, 12, 12};
+    auto interpreter            = CreateConvInterpreter(input_dims);
+    std::remove(kTuneCacheFile);
+
+    ExpectSameAsNaive(interpreter, input_dims);
+    auto lines = ReadLines(kTuneCacheFile);
+    // the version line and one config per conv
+    ASSERT_EQ(lines.size(), 3);
+    EXPECT_EQ(lines[0], kTuneCacheVersion);
+    for (size_t i = 1; i < lines.size(); i++) {
+        EXPECT_EQ(lines[i].compare(0, 5, "conv_"), 0) << lines[i];
+        EXPECT_NE(lines[i].find(' '), std::string::npos) << lines[i];
+    }
+
+    // no conv is benchmarked again, so the file is not written again and keeps the marker
+    auto marked_lines = lines;
+    marked_lines.push_back(kUntouchedMarker);
+    WriteLines(kTuneCacheFile, marked_lines);
+    ExpectSameAsNaive(interpreter, input_dims);
+    EXPECT_EQ(ReadLines(kTuneCacheFile), marked_lines);
+
+    // configs of another version are ignored, the convs are tuned and stored again
+    auto stale_lines = marked_lines;
+    stale_lines[0]   = "tnn_x86_tune_v0";
+    WriteLines(kTuneCacheFile, stale_lines);
+    ExpectSameAsNaive(interpreter, input_dims);
+    auto tuned_lines = ReadLines(kTuneCacheFile);
+    ASSERT_EQ(tuned_lines.size(), 3);
+    EXPECT_EQ(tuned_lines[0], kTuneCacheVersion);
+    for (size_t i = 1; i < tuned_lines.size(); i++) {
+        EXPECT_EQ(tuned_lines[i].substr(0, tuned_lines[i].find(' ')), lines[i].substr(0, lines[i].find(' ')));
+    }
+
+    std::remove(kTuneCacheFile);
+}
+
+}  // namespace TNN_NS
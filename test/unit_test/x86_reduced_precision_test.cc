@@ -0,0 +1,109 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "test/unit_test/unit_test_common.h"
+#include "tnn/core/abstract_device.h"
+#include "tnn/interpreter/default_model_interpreter.h"
+#include "tnn/utils/dims_utils.h"
+
+namespace TNN_NS {
+
+// x86 conv, conv 1x1 and inner product with 16 bit weights against naive fp32
+
+enum ReducedPrecisionLayer { REDUCED_PRECISION_CONV, REDUCED_PRECISION_CONV_1X1, REDUCED_PRECISION_INNER_PRODUCT };
+
+// weights of the shared helpers are exact in bf16, these are not
+static void FillWeights(RawBuffer &buffer) {
+    auto data       = buffer.force_to<float *>();
+    const int count = buffer.GetBytesSize() / sizeof(float);
+    for (int i = 0; i < count; i++) {
+        data[i] = 0.2f * std::sin(0.37f * i + 0.1f);
+    }
+}
+
+static std::shared_ptr<AbstractModelInterpreter> CreateInterpreter(ReducedPrecisionLayer layer,
+                                                                   std::vector<int> input_dims) {
+    auto interpreter = GenerateEmptyInterpreter({{"input0", input_dims}}, {"output0"});
+    auto resource_map = &dynamic_cast<DefaultModelInterpreter *>(interpreter.get())->GetNetResource()->resource_map;
+    if (layer == REDUCED_PRECISION_INNER_PRODUCT) {
+        AddInnerProductLayer(interpreter, "layer", "input0", "output0", DimsVectorUtils::Count(input_dims, 1), 40);
+        auto resource = std::dynamic_pointer_cast<InnerProductLayerResource>((*resource_map)["layer"]);
+        FillWeights(resource->weight_handle);
+    } else {
+        AddConvLayer(interpreter, "layer", "input0", "output0", input_dims[1], 24,
+                     layer == REDUCED_PRECISION_CONV ? 5 : 1);
+        auto resource = std::dynamic_pointer_cast<ConvLayerResource>((*resource_map)["layer"]);
+        FillWeights(resource->filter_handle);
+    }
+    return interpreter;
+}
+
+class X86ReducedPrecisionTest
+    : public ::testing::TestWithParam<std::tuple<ReducedPrecisionLayer, int, Precision>> {};
+
+INSTANTIATE_TEST_SUITE_P(X86ReducedPrecisionTest, X86ReducedPrecisionTest,
+                         ::testing::Combine(testing::Values(REDUCED_PRECISION_CONV, REDUCED_PRECISION_CONV_1X1,
+                                                            REDUCED_PRECISION_INNER_PRODUCT),
+                                            // batch 1 runs the inner product sgemv, batch 4 the sgemm
+                                            testing::Values(1, 4),
+                                            testing::Values(PRECISION_LOW, PRECISION_NORMAL)));
+
+TEST_P(X86ReducedPrecisionTest, SameResultAsNaiveFloat) {
+    if (GetDevice(DEVICE_X86) == nullptr || GetDevice(DEVICE_NAIVE) == nullptr) {
+        GTEST_SKIP();
+    }
+    const auto layer            = std::get<0>(GetParam());
+    const int batch             = std::get<1>(GetParam());
+    const auto precision        = std::get<2>(GetParam());
+    std::vector<int> input_dims = {batch, 32, 9, 9};
+    auto interpreter            = CreateInterpreter(layer, input_dims);
+
+    NetworkConfig naive_config, x86_config;
+    naive_config.device_type = DEVICE_NAIVE;
+    naive_config.precision   = PRECISION_HIGH;
+    x86_config.device_type   = DEVICE_X86;
+    x86_config.precision     = PRECISION_HIGH;
+
+    std::map<std::string, std::vector<float>> expect_outputs, high_outputs, actual_outputs;
+    ASSERT_TRUE(ForwardInstance(naive_config, interpreter, {{"input0", input_dims}}, expect_outputs) == TNN_OK);
+    ASSERT_TRUE(ForwardInstance(x86_config, interpreter, {{"input0", input_dims}}, high_outputs) == TNN_OK);
+    x86_config.precision = precision;
+    ASSERT_TRUE(ForwardInstance(x86_config, interpreter, {{"input0", input_dims}}, actual_outputs) == TNN_OK);
+
+    auto &expect = expect_outputs["output0"];
+    auto &high   = high_outputs["output0"];
+    auto &actual = actual_outputs["output0"];
+    ASSERT_FALSE(expect.empty());
+    ASSERT_EQ(actual.size(), expect.size());
+    float max_abs = 0;
+    for (auto value : expect) {
+        max_abs = std::max(max_abs, std::fabs(value));
+    }
+    // 16 bit weights keep 8 (bf16) or 11 (fp16) significant bits, the sums stay in fp32 but the rounding
+    // errors of the 800 weights of a 5x5 conv add up to about 1% of the output range in bf16
+    const float tolerance = (precision == PRECISION_LOW ? 2e-2f : 2e-3f) * max_abs;
+    for (size_t i = 0; i < expect.size(); i++) {
+        ASSERT_NEAR(actual[i], expect[i], tolerance) << "index " << i;
+    }
+    // bf16 weights are always used in low precision, so the result is not the fp32 one
+    if (precision == PRECISION_LOW) {
+        EXPECT_NE(actual, high);
+    }
+}
+
+}  // namespace TNN_NS
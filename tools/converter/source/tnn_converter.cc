@@ -79,7 +79,8 @@ int Run(int argc, char* argv[]) {
     resource_manager.converter(net_structure, net_resource);
     // wright the model
     std::string file_name = GetFileName(model_config.model_path_);
-    status                = GenerateModel(net_structure, net_resource, model_config.output_dir_, file_name);
+    status                = GenerateModel(net_structure, net_resource, model_config.output_dir_, file_name,
+                                          FLAGS_align_weights);
     if (status != TNN_NS::TNN_CONVERT_OK) {
         LOGE("Converter: generate tnn model failed!\n");
         return status;
@@ -28,4 +28,6 @@ DEFINE_string(sp, "", save_path_message);
 
 DEFINE_bool(half, false, half_message);
 
+DEFINE_bool(align_weights, false, align_weights_message);
+
 }  // namespace TNN_CONVERTER
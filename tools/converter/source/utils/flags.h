@@ -31,6 +31,8 @@ static const char save_path_message[] = "Specify the save path of the results af
 
 static const char half_message[] = "Convert float model to half";
 
+static const char align_weights_message[] = "Align weights in tnnmodel, so that it can be memory mapped without copy";
+
 DECLARE_bool(h);
 
 DECLARE_string(mp);
@@ -43,6 +45,8 @@ DECLARE_string(sp);
 
 DECLARE_bool(half);
 
+DECLARE_bool(align_weights);
+
 }  // namespace TNN_CONVERTER
 
 #endif  // TNNCONVERTER_SRC_FLAGS_H_
@@ -23,7 +23,7 @@ namespace TNN_CONVERTER {
 std::string GetFileName(std::string& file_path);
 
 TNN_NS::Status GenerateModel(TNN_NS::NetStructure& net_structure, TNN_NS::NetResource& net_resource,
-                             std::string& output_dir, std::string& file_name);
+                             std::string& output_dir, std::string& file_name, bool align_weights = false);
 
 }  // namespace TNN_CONVERTER
 
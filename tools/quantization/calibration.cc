@@ -14,13 +14,16 @@
 
 #include "calibration.h"
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <random>
+#include <thread>
 #include "file_reader.h"
 #include "tnn/core/macro.h"
 #include "tnn/core/tnn.h"
 #include "tnn/interpreter/tnn/model_packer.h"
 #include "tnn/interpreter/tnn/objseri.h"
+#include "tnn/utils/blob_converter.h"
 #include "tnn/utils/dims_vector_utils.h"
 
 namespace TNN_NS {
@@ -30,6 +33,11 @@ static const std::set<LayerType> kQuantizedLayerTypeStr = {LAYER_CONVOLUTION, LA
 
 static const std::set<LayerType> kBlobScaleMergeLayerTypeStr = {LAYER_RELU, LAYER_POOLING};
 
+// number of input files forwarded for each step of the mixed precision search
+static const int kSearchSampleCount = 8;
+// saved latency in ms below which a layer is considered as free to keep in fp32
+static const double kMinSavedTime = 1.0e-3;
+
 static void InitWeightScaleADMM(const float* weights, const int size, const int output_channel, bool merge_channel,
                                 float* weight_scale, const int quantize_bits) {
     int weight_scale_count = merge_channel ? 1 : output_channel;
@@ -93,11 +101,60 @@ static void UpdateAlphaADMM(const float* weights, const int size, const int outp
     }
 }
 
+static int GetSearchSampleCount(DataSet& dataset) {
+    return std::min((int)dataset.file_list.size(), kSearchSampleCount);
+}
+
+static Status ReadSearchSample(std::shared_ptr<Instance> instance, FileReader& file_reader,
+                               std::pair<std::string, FileFormat>& file_pack) {
+    BlobMap input_blobs;
+    Status status = instance->GetAllInputBlobs(input_blobs);
+    if (status != TNN_OK) {
+        return status;
+    }
+    return file_reader.Read(input_blobs.begin()->second, file_pack.first, file_pack.second);
+}
+
+// int8 blobs are dequantized by the blob converter
+static Status GetBlobFloatData(std::shared_ptr<Instance> instance, Blob* blob, std::vector<float>& data) {
+    auto blob_desc = blob->GetBlobDesc();
+    if (blob_desc.data_type != DATA_TYPE_FLOAT && blob_desc.data_type != DATA_TYPE_HALF &&
+        blob_desc.data_type != DATA_TYPE_INT8) {
+        return Status(TNNERR_PARAM_ERR, "blob data type not support in mixed precision search");
+    }
+    data.resize(DimsVectorUtils::Count(blob_desc.dims));
+
+    void* command_queue;
+    instance->GetCommandQueue(&command_queue);
+    BlobConverter blob_converter(blob);
+    Mat mat(DEVICE_NAIVE, NCHW_FLOAT, blob_desc.dims, data.data());
+    return blob_converter.ConvertToMat(mat, MatConvertParam(), command_queue);
+}
+
+// 1 - cosine similarity, the same measure as the COSINE compare of model_check
+static double CosineDistance(const std::vector<float>& data, const std::vector<float>& ref_data) {
+    if (data.size() != ref_data.size()) {
+        return 1.0;
+    }
+    double mul       = 0;
+    double ref_sum2  = 0.000001;
+    double data_sum2 = 0.000001;
+    for (size_t i = 0; i < data.size(); ++i) {
+        mul += data[i] * ref_data[i];
+        ref_sum2 += ref_data[i] * ref_data[i];
+        data_sum2 += data[i] * data[i];
+    }
+    return 1.0 - mul / std::sqrt(ref_sum2) / std::sqrt(data_sum2);
+}
+
 Calibration::Calibration() {}
 
 Calibration::~Calibration() {}
 
 Status Calibration::Init(NetworkConfig& net_config, ModelConfig& model_config, InputShapesMap inputs_shape) {
+    net_config_   = net_config;
+    model_config_ = model_config;
+
     TNN tnn;
     Status status = tnn.Init(model_config);
     if (status != TNN_OK) {
@@ -135,6 +192,19 @@ int Calibration::SetCalibrationParams(CalibrationParam params) {
         return -1;
     }
 
+    if (cali_params_.num_threads < 1) {
+        LOGE("invalid num_threads (%d) for calibration!\n", cali_params_.num_threads);
+        cali_params_.num_threads = 1;
+        return -1;
+    }
+
+    if (cali_params_.max_output_error < 0) {
+        LOGE("invalid max_output_error (%f) for calibration!\n", cali_params_.max_output_error);
+        cali_params_.max_output_error = 0;
+        return -1;
+    }
+    fp32_layers_ = cali_params_.fp32_layers;
+
     return 0;
 }
 
@@ -160,6 +230,13 @@ Status Calibration::RunCalibration(DataSet& dataset) {
         return TNNERR_QUANTIZE_ERROR;
     }
 
+    // Keep the sensitive layers in fp32
+    ret = SearchMixedPrecision(dataset);
+    if (ret != 0) {
+        LOGE("search mixed precision failed!\n");
+        return TNNERR_QUANTIZE_ERROR;
+    }
+
     return TNN_OK;
 }
 
@@ -186,38 +263,51 @@ int Calibration::CalBlobScale(DataSet& dataset) {
     printf("Start to calculate blob scale ...\n");
     NetResource* net_resource = interpreter_->GetNetResource();
 
-    Status status = instance_->Reshape(dataset.input_shape);
-    if (status != TNN_OK) {
-        LOGE("instance reshape failed!\n");
-        return -1;
+    int ret = InitInstancePool(dataset);
+    if (ret != 0) {
+        LOGE("init instance pool failed!\n");
+        return ret;
     }
+    printf("\tInit %d Instances done!\n", (int)instances_.size());
 
     // Init Feature map
-    int ret = InitFeatureMap();
-    if (ret != 0) {
-        LOGE("init feautre map for quantize failed!\n");
-        return ret;
+    for (int i = 0; i < instances_.size(); ++i) {
+        ret = InitFeatureMap(instances_[i], feature_maps_[i]);
+        if (ret != 0) {
+            LOGE("init feautre map for quantize failed!\n");
+            return ret;
+        }
     }
     printf("\tInit Feature Map done!\n");
 
-    // Collect the Range of Feature map
-    ret = UpdateBlobRange(dataset);
-    if (ret != 0) {
-        LOGE("collect feautre map range failed!\n");
-        return ret;
-    }
-    printf("\tCollect Blob Range done!\n");
+    if (cali_params_.single_pass) {
+        // Collect the Range and Distribute of Feature map together
+        ret = UpdateBlobRangeAndDistribute(dataset);
+        if (ret != 0) {
+            LOGE("collect feautre map range and distribute failed!\n");
+            return ret;
+        }
+        printf("\tCollect Blob Range and Distribution done!\n");
+    } else {
+        // Collect the Range of Feature map
+        ret = UpdateBlobRange(dataset);
+        if (ret != 0) {
+            LOGE("collect feautre map range failed!\n");
+            return ret;
+        }
+        printf("\tCollect Blob Range done!\n");
 
-    // Calculate Distribute of Feature map
-    ret = UpdateBlobDistribute(dataset);
-    if (ret != 0) {
-        LOGE("update feautre map distribute failed!\n");
-        return ret;
+        // Calculate Distribute of Feature map
+        ret = UpdateBlobDistribute(dataset);
+        if (ret != 0) {
+            LOGE("update feautre map distribute failed!\n");
+            return ret;
+        }
+        printf("\tCollect Blob Distribution done!\n");
     }
-    printf("\tCollect Blob Distribution done!\n");
 
     // Compute Scale of Feature map and save to resource map
-    for (auto& item : feature_map_) {
+    for (auto& item : feature_maps_[0]) {
         std::vector<float> scale_vec;
         std::vector<int8_t> zero_point_vec;
 
@@ -236,123 +326,253 @@ int Calibration::CalBlobScale(DataSet& dataset) {
     return 0;
 }
 
-int Calibration::InitFeatureMap() {
-    feature_map_.clear();
+int Calibration::InitInstancePool(DataSet& dataset) {
+    Status status = instance_->Reshape(dataset.input_shape);
+    if (status != TNN_OK) {
+        LOGE("instance reshape failed!\n");
+        return -1;
+    }
+
+    // instances without files would stay idle
+    int instance_count = std::max(1, std::min(cali_params_.num_threads, (int)dataset.file_list.size()));
+    instances_         = {instance_};
+    if (instance_count > 1) {
+        TNN tnn;
+        status = tnn.Init(model_config_);
+        if (status != TNN_OK) {
+            LOGE("tnn init failed!\n");
+            return -1;
+        }
+        for (int i = 1; i < instance_count; ++i) {
+            auto instance = tnn.CreateInst(net_config_, status, dataset.input_shape);
+            if (status != TNN_OK || instance == nullptr) {
+                LOGE("tnn create instance failed!\n");
+                return -1;
+            }
+            instances_.push_back(instance);
+        }
+    }
+    feature_maps_.assign(instances_.size(), FeatureMap());
+
+    return 0;
+}
+
+int Calibration::InitFeatureMap(std::shared_ptr<Instance> instance, FeatureMap& feature_map) {
+    feature_map.clear();
 
     BlobStatisticCallback func = [&](std::vector<Blob*>& blobs, LayerInfo* info) {
         LayerType layer_type = info->type;
         if (kQuantizedLayerTypeStr.find(layer_type) != kQuantizedLayerTypeStr.end() ||
             kBlobScaleMergeLayerTypeStr.find(layer_type) != kBlobScaleMergeLayerTypeStr.end()) {
             for (auto blob : blobs) {
-                if (feature_map_.find(blob) == feature_map_.end()) {
+                if (feature_map.find(blob) == feature_map.end()) {
                     std::shared_ptr<ScaleCalculator> scale_cal(new ScaleCalculator());
                     if (scale_cal->Init(blob, cali_params_.merge_blob_channel, cali_params_.blob_quantize_method) ==
                         0) {
-                        feature_map_[blob] = scale_cal;
+                        feature_map[blob] = scale_cal;
                     }
                 }
 
                 // set FC layer input and output blob to merge channel
                 if (layer_type == LAYER_INNER_PRODUCT) {
-                    if (feature_map_.find(blob) != feature_map_.end()) {
-                        feature_map_[blob]->SetMergeChannel(true);
+                    if (feature_map.find(blob) != feature_map.end()) {
+                        feature_map[blob]->SetMergeChannel(true);
                     }
                 }
             }
         }
     };
 
-    instance_->ForwardWithCallback(func, func);
+    instance->ForwardWithCallback(func, func);
 
     // set input blob quantize method to MIN_MAX
     BlobMap input_blobs;
-    Status status = instance_->GetAllInputBlobs(input_blobs);
+    Status status = instance->GetAllInputBlobs(input_blobs);
     if (status != TNN_OK) {
         LOGE("instance get input blobs failed!\n");
         return -1;
     }
     for (auto item : input_blobs) {
-        if (feature_map_.find(item.second) != feature_map_.end()) {
-            feature_map_[item.second]->SetQuantizeMethod(MIN_MAX);
+        if (feature_map.find(item.second) != feature_map.end()) {
+            feature_map[item.second]->SetQuantizeMethod(MIN_MAX);
         }
     }
 
     return 0;
 }
 
-int Calibration::UpdateBlobRange(DataSet& dataset) {
-    BlobMap input_blobs;
-    Status status = instance_->GetAllInputBlobs(input_blobs);
-    if (status != TNN_OK) {
-        LOGE("instance get input blobs failed!\n");
-        return -1;
-    }
-    Blob* input_blob = input_blobs.begin()->second;
+int Calibration::ForwardDataSet(DataSet& dataset, ScaleCalculatorFunc clear_func, ScaleCalculatorFunc update_func) {
+    const int instance_count = instances_.size();
+    std::vector<int> results(instance_count, 0);
 
-    BlobStatisticCallback func = [&](std::vector<Blob*>& blobs, LayerInfo* info) {
-        for (auto blob : blobs) {
-            if (feature_map_.find(blob) != feature_map_.end()) {
-                feature_map_[blob]->UpdateRange();
+    auto forward_shard = [&](int index) {
+        auto instance     = instances_[index];
+        auto& feature_map = feature_maps_[index];
+
+        BlobMap input_blobs;
+        Status status = instance->GetAllInputBlobs(input_blobs);
+        if (status != TNN_OK) {
+            LOGE("instance get input blobs failed!\n");
+            results[index] = -1;
+            return;
+        }
+        Blob* input_blob = input_blobs.begin()->second;
+
+        BlobStatisticCallback func = [&](std::vector<Blob*>& blobs, LayerInfo* info) {
+            for (auto blob : blobs) {
+                auto iter = feature_map.find(blob);
+                if (iter != feature_map.end()) {
+                    update_func(iter->second.get());
+                }
+            }
+        };
+
+        FileReader file_reader;
+        file_reader.SetBiasValue(cali_params_.input_bias);
+        file_reader.SetScaleValue(cali_params_.input_scale);
+        file_reader.SetReverseChannel(cali_params_.reverse_channel);
+        for (size_t i = index; i < dataset.file_list.size(); i += instance_count) {
+            auto& file_pack = dataset.file_list[i];
+            for (auto& item : feature_map) {
+                clear_func(item.second.get());
             }
+
+            status = file_reader.Read(input_blob, file_pack.first, file_pack.second);
+            if (status != TNN_OK) {
+                LOGE("read input file (%s) failed!\n", file_pack.first.c_str());
+                continue;
+            }
+            instance->ForwardWithCallback(func, func);
         }
     };
 
-    FileReader file_reader;
-    file_reader.SetBiasValue(cali_params_.input_bias);
-    file_reader.SetScaleValue(cali_params_.input_scale);
-    file_reader.SetReverseChannel(cali_params_.reverse_channel);
-    for (auto file_pack : dataset.file_list) {
-        for (auto item : feature_map_) {
-            item.second->ClearRangeFlag();
+    if (instance_count == 1) {
+        forward_shard(0);
+    } else {
+        std::vector<std::thread> threads;
+        for (int i = 0; i < instance_count; ++i) {
+            threads.emplace_back(forward_shard, i);
+        }
+        for (auto& thread : threads) {
+            thread.join();
         }
+    }
 
-        status = file_reader.Read(input_blob, file_pack.first, file_pack.second);
-        if (status != TNN_OK) {
-            LOGE("read input file (%s) failed!\n", file_pack.first.c_str());
-            continue;
+    for (auto result : results) {
+        if (result != 0) {
+            return result;
+        }
+    }
+    return 0;
+}
+
+int Calibration::ForEachWorkerCalculator(std::function<int(ScaleCalculator* first, ScaleCalculator* worker)> func) {
+    // blobs of different instances are matched by name
+    std::map<std::string, ScaleCalculator*> first_calculators;
+    for (auto& item : feature_maps_[0]) {
+        first_calculators[item.first->GetBlobDesc().name] = item.second.get();
+    }
+
+    for (int i = 1; i < feature_maps_.size(); ++i) {
+        for (auto& item : feature_maps_[i]) {
+            auto iter = first_calculators.find(item.first->GetBlobDesc().name);
+            if (iter == first_calculators.end()) {
+                LOGE("blob (%s) is not found in the first instance!\n", item.first->GetBlobDesc().name.c_str());
+                return -1;
+            }
+            int ret = func(iter->second, item.second.get());
+            if (ret != 0) {
+                return ret;
+            }
         }
-        instance_->ForwardWithCallback(func, func);
     }
 
     return 0;
 }
 
+int Calibration::UpdateBlobRange(DataSet& dataset) {
+    int ret = ForwardDataSet(
+        dataset, [](ScaleCalculator* cal) { cal->ClearRangeFlag(); }, [](ScaleCalculator* cal) { cal->UpdateRange(); });
+    if (ret != 0) {
+        return ret;
+    }
+
+    return ForEachWorkerCalculator([](ScaleCalculator* first, ScaleCalculator* worker) {
+        return first->MergeRange(*worker);
+    });
+}
+
 int Calibration::UpdateBlobDistribute(DataSet& dataset) {
-    for (auto& item : feature_map_) {
-        item.second->ResetDistribute();
+    // every instance bins with the merged range
+    int ret = ForEachWorkerCalculator([](ScaleCalculator* first, ScaleCalculator* worker) {
+        worker->CopyRange(*first);
+        return 0;
+    });
+    if (ret != 0) {
+        return ret;
     }
 
-    BlobMap input_blobs;
-    Status status = instance_->GetAllInputBlobs(input_blobs);
-    if (status != TNN_OK) {
-        LOGE("instance get input blobs failed!\n");
-        return -1;
+    bool need_distribute = false;
+    for (auto& feature_map : feature_maps_) {
+        for (auto& item : feature_map) {
+            item.second->ResetDistribute();
+            need_distribute |= item.second->GetQuantizeMethod() == KL_DIVERGENCE;
+        }
+    }
+    // the other methods only read the range or the interval
+    if (!need_distribute) {
+        return 0;
     }
-    Blob* input_blob = input_blobs.begin()->second;
 
-    BlobStatisticCallback func = [&](std::vector<Blob*>& blobs, LayerInfo* info) {
-        for (auto blob : blobs) {
-            if (feature_map_.find(blob) != feature_map_.end()) {
-                feature_map_[blob]->UpdateDistribute();
-            }
+    ret = ForwardDataSet(
+        dataset, [](ScaleCalculator* cal) { cal->ClearDistributeFlag(); },
+        [](ScaleCalculator* cal) { cal->UpdateDistribute(); });
+    if (ret != 0) {
+        return ret;
+    }
+
+    return ForEachWorkerCalculator([](ScaleCalculator* first, ScaleCalculator* worker) {
+        return first->MergeDistribute(*worker);
+    });
+}
+
+int Calibration::UpdateBlobRangeAndDistribute(DataSet& dataset) {
+    for (auto& feature_map : feature_maps_) {
+        for (auto& item : feature_map) {
+            item.second->ClearDistribute();
         }
-    };
+    }
 
-    FileReader file_reader;
-    file_reader.SetBiasValue(cali_params_.input_bias);
-    file_reader.SetScaleValue(cali_params_.input_scale);
-    file_reader.SetReverseChannel(cali_params_.reverse_channel);
-    for (auto file_pack : dataset.file_list) {
-        for (auto& item : feature_map_) {
-            item.second->ClearDistributeFlag();
+    int ret = ForwardDataSet(
+        dataset,
+        [](ScaleCalculator* cal) {
+            cal->ClearRangeFlag();
+            cal->ClearDistributeFlag();
+        },
+        [](ScaleCalculator* cal) {
+            cal->UpdateRange();
+            cal->UpdateStreamDistribute();
+        });
+    if (ret != 0) {
+        return ret;
+    }
+
+    ret = ForEachWorkerCalculator([](ScaleCalculator* first, ScaleCalculator* worker) {
+        int ret = first->MergeRange(*worker);
+        if (ret != 0) {
+            return ret;
         }
+        return first->MergeDistribute(*worker);
+    });
+    if (ret != 0) {
+        return ret;
+    }
 
-        status = file_reader.Read(input_blob, file_pack.first, file_pack.second);
-        if (status != TNN_OK) {
-            LOGE("read input file (%s) failed!\n", file_pack.first.c_str());
-            continue;
+    // min max only reads the interval, take it from the range rather than the power of two histogram
+    for (auto& item : feature_maps_[0]) {
+        if (item.second->GetQuantizeMethod() == MIN_MAX) {
+            item.second->ResetDistribute();
         }
-        instance_->ForwardWithCallback(func, func);
     }
 
     return 0;
@@ -414,6 +634,11 @@ int Calibration::QuantizeParams() {
         }
 
         if (kQuantizedLayerTypeStr.find(layer_type) != kQuantizedLayerTypeStr.end()) {
+            if (cali_params_.fp32_layers.find(item->name) != cali_params_.fp32_layers.end()) {
+                printf("\tKeep %s in fp32\n", item->name.c_str());
+                continue;
+            }
+
             // assign NetStructure
             item->param->quantized = true;
 
@@ -435,6 +660,7 @@ int Calibration::QuantizeParams() {
                 }
                 IntScaleResource* blob_scale =
                     dynamic_cast<IntScaleResource*>(net_resource->resource_map[input_blob_scale_name].get());
+                fp32_resources_[item->name] = std::make_shared<ConvLayerResource>(*conv_res);
                 int ret = QuantizeConvParams(conv_res, conv_param, blob_scale);
                 if (ret != 0) {
                     LOGE(
@@ -462,6 +688,7 @@ int Calibration::QuantizeParams() {
                 }
                 IntScaleResource* blob_scale =
                     dynamic_cast<IntScaleResource*>(net_resource->resource_map[input_blob_scale_name].get());
+                fp32_resources_[item->name] = std::make_shared<InnerProductLayerResource>(*fc_res);
                 int ret = QuantizeFcParams(fc_res, fc_param, blob_scale);
                 if (ret != 0) {
                     LOGE(
@@ -816,4 +1043,294 @@ LayerInfo* Calibration::GetLayerInfoFromOutpubBlobName(std::string blob_name, Ne
     return layer_info;
 }
 
+int Calibration::SearchMixedPrecision(DataSet& dataset) {
+    if (cali_params_.max_output_error <= 0) {
+        return 0;
+    }
+    printf("Start to Search Mixed Precision ...\n");
+    NetStructure* net_struct  = interpreter_->GetNetStructure();
+    NetResource* net_resource = interpreter_->GetNetResource();
+
+    std::set<std::string> candidates;
+    for (auto& item : net_struct->layers) {
+        if (item->param->quantized && kQuantizedLayerTypeStr.find(item->type) != kQuantizedLayerTypeStr.end()) {
+            candidates.insert(item->name);
+        }
+    }
+    if (candidates.empty()) {
+        return 0;
+    }
+
+    // the net with all the candidates in fp32 is the reference
+    auto reference = CreateSearchInstance(candidates, dataset);
+    auto quantized = CreateSearchInstance(fp32_layers_, dataset);
+    if (reference == nullptr || quantized == nullptr) {
+        return -1;
+    }
+
+    SearchProfile fp32_profile, int8_profile;
+    int ret = ProfileSearchInstances(reference, quantized, dataset, fp32_profile, int8_profile);
+    if (ret != 0) {
+        return ret;
+    }
+    reference = nullptr;
+    quantized = nullptr;
+    const int sample_count = GetSearchSampleCount(dataset);
+    printf("\tProfile %d samples on device %d done!\n", sample_count, cali_params_.search_device);
+
+    // rank the candidates by the error each adds to its inputs over the latency it saves in int8, the latency of the
+    // reformat layers between int8 and fp32 is not counted
+    auto get_error = [&](const std::vector<std::string>& names) {
+        double error = 0;
+        for (auto& name : names) {
+            auto iter = int8_profile.blob_error.find(name);
+            if (iter != int8_profile.blob_error.end()) {
+                error = std::max(error, iter->second / sample_count);
+            }
+        }
+        return error;
+    };
+    std::vector<std::pair<double, std::string>> ranking;
+    for (auto& item : net_struct->layers) {
+        if (candidates.find(item->name) == candidates.end()) {
+            continue;
+        }
+        double layer_error = std::max(get_error(item->outputs) - get_error(item->inputs), 0.0);
+        double fp32_time   = fp32_profile.layer_time[item->name] / sample_count;
+        double int8_time   = int8_profile.layer_time[item->name] / sample_count;
+        printf("\t%s: error %f, fp32 %.3f ms, int8 %.3f ms\n", item->name.c_str(), layer_error, fp32_time, int8_time);
+        ranking.push_back(std::make_pair(layer_error / std::max(fp32_time - int8_time, kMinSavedTime), item->name));
+    }
+    std::stable_sort(ranking.begin(), ranking.end(),
+                     [](const std::pair<double, std::string>& a, const std::pair<double, std::string>& b) {
+                         return a.first > b.first;
+                     });
+
+    double error = 0;
+    for (auto& item : fp32_profile.output_data) {
+        error = std::max(error, int8_profile.blob_error[item.first] / sample_count);
+    }
+    printf("\tOutput error of int8: %f\n", error);
+
+    for (auto& item : ranking) {
+        if (error <= cali_params_.max_output_error) {
+            break;
+        }
+        fp32_layers_.insert(item.second);
+        auto instance = CreateSearchInstance(fp32_layers_, dataset);
+        if (instance == nullptr) {
+            return -1;
+        }
+        ret = CalOutputError(instance, dataset, fp32_profile, error);
+        if (ret != 0) {
+            return ret;
+        }
+        printf("\t====> Keep %s in fp32, output error: %f\n", item.second.c_str(), error);
+    }
+    if (error > cali_params_.max_output_error) {
+        LOGE("output error %f is still above %f with all quantized layers in fp32\n", error,
+             cali_params_.max_output_error);
+    }
+
+    ApplyFp32Layers(net_struct, net_resource, fp32_layers_);
+    printf("\tKeep %d layers in fp32\n", (int)fp32_layers_.size());
+
+    return 0;
+}
+
+std::shared_ptr<Instance> Calibration::CreateSearchInstance(const std::set<std::string>& fp32_layers,
+                                                            DataSet& dataset) {
+    // layers are copied by the interpreter, resources are shared
+    auto interpreter = std::dynamic_pointer_cast<DefaultModelInterpreter>(interpreter_->Copy());
+    if (interpreter == nullptr) {
+        LOGE("copy interpreter failed!\n");
+        return nullptr;
+    }
+    ApplyFp32Layers(interpreter->GetNetStructure(), interpreter->GetNetResource(), fp32_layers);
+
+    // reformat layers are inserted between int8 and fp32 layers by the net optimizer
+    NetworkConfig net_config = net_config_;
+    net_config.device_type   = cali_params_.search_device;
+    auto instance            = std::make_shared<Instance>(net_config, model_config_);
+    Status status            = instance->Init(interpreter, dataset.input_shape);
+    if (status != TNN_OK) {
+        LOGE("search instance init failed (%s)!\n", status.description().c_str());
+        return nullptr;
+    }
+
+    return instance;
+}
+
+int Calibration::ProfileSearchInstances(std::shared_ptr<Instance> reference, std::shared_ptr<Instance> quantized,
+                                        DataSet& dataset, SearchProfile& fp32_profile, SearchProfile& int8_profile) {
+    BlobMap output_blobs;
+    Status status = reference->GetAllOutputBlobs(output_blobs);
+    if (status != TNN_OK) {
+        LOGE("instance get output blobs failed!\n");
+        return -1;
+    }
+
+    FileReader file_reader;
+    file_reader.SetBiasValue(cali_params_.input_bias);
+    file_reader.SetScaleValue(cali_params_.input_scale);
+    file_reader.SetReverseChannel(cali_params_.reverse_channel);
+
+    std::chrono::time_point<std::chrono::steady_clock> start;
+    auto elapsed_ms = [&]() {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+    BlobStatisticCallback func_before = [&](std::vector<Blob*>& blobs, LayerInfo* info) {
+        start = std::chrono::steady_clock::now();
+    };
+
+    for (int i = 0; i < GetSearchSampleCount(dataset); ++i) {
+        auto& file_pack = dataset.file_list[i];
+
+        // blob data of the reference and blob error of the quantized instance for this sample
+        std::map<std::string, std::vector<float>> ref_data;
+        std::map<std::string, double> sample_error;
+
+        BlobStatisticCallback fp32_func_after = [&](std::vector<Blob*>& blobs, LayerInfo* info) {
+            fp32_profile.layer_time[info->name] += elapsed_ms();
+            for (auto blob : blobs) {
+                std::vector<float> data;
+                if (GetBlobFloatData(reference, blob, data) == TNN_OK) {
+                    ref_data[blob->GetBlobDesc().name] = std::move(data);
+                }
+            }
+        };
+
+        BlobStatisticCallback int8_func_after = [&](std::vector<Blob*>& blobs, LayerInfo* info) {
+            int8_profile.layer_time[info->name] += elapsed_ms();
+            // blobs not in the reference, like the outputs of reformat layers, take the error of the inputs
+            double input_error = 0;
+            for (auto& name : info->inputs) {
+                auto iter = sample_error.find(name);
+                if (iter != sample_error.end()) {
+                    input_error = std::max(input_error, iter->second);
+                }
+            }
+            for (auto blob : blobs) {
+                const std::string& name = blob->GetBlobDesc().name;
+                auto iter               = ref_data.find(name);
+                std::vector<float> data;
+                if (iter != ref_data.end() && GetBlobFloatData(quantized, blob, data) == TNN_OK) {
+                    sample_error[name] = CosineDistance(data, iter->second);
+                } else {
+                    sample_error[name] = input_error;
+                }
+            }
+        };
+
+        status = ReadSearchSample(reference, file_reader, file_pack);
+        if (status != TNN_OK) {
+            LOGE("read input file (%s) failed!\n", file_pack.first.c_str());
+            return -1;
+        }
+        status = reference->ForwardWithCallback(func_before, fp32_func_after);
+        if (status != TNN_OK) {
+            LOGE("reference instance forward failed (%s)!\n", status.description().c_str());
+            return -1;
+        }
+        for (auto& item : output_blobs) {
+            fp32_profile.output_data[item.first].push_back(ref_data[item.first]);
+        }
+
+        status = ReadSearchSample(quantized, file_reader, file_pack);
+        if (status != TNN_OK) {
+            LOGE("read input file (%s) failed!\n", file_pack.first.c_str());
+            return -1;
+        }
+        status = quantized->ForwardWithCallback(func_before, int8_func_after);
+        if (status != TNN_OK) {
+            LOGE("quantized instance forward failed (%s)!\n", status.description().c_str());
+            return -1;
+        }
+        for (auto& item : sample_error) {
+            int8_profile.blob_error[item.first] += item.second;
+        }
+    }
+
+    return 0;
+}
+
+int Calibration::CalOutputError(std::shared_ptr<Instance> instance, DataSet& dataset, SearchProfile& reference,
+                                double& error) {
+    BlobMap output_blobs;
+    Status status = instance->GetAllOutputBlobs(output_blobs);
+    if (status != TNN_OK) {
+        LOGE("instance get output blobs failed!\n");
+        return -1;
+    }
+
+    FileReader file_reader;
+    file_reader.SetBiasValue(cali_params_.input_bias);
+    file_reader.SetScaleValue(cali_params_.input_scale);
+    file_reader.SetReverseChannel(cali_params_.reverse_channel);
+
+    const int sample_count = GetSearchSampleCount(dataset);
+    std::map<std::string, double> output_error;
+    for (int i = 0; i < sample_count; ++i) {
+        status = ReadSearchSample(instance, file_reader, dataset.file_list[i]);
+        if (status != TNN_OK) {
+            LOGE("read input file (%s) failed!\n", dataset.file_list[i].first.c_str());
+            return -1;
+        }
+        status = instance->Forward();
+        if (status != TNN_OK) {
+            LOGE("search instance forward failed (%s)!\n", status.description().c_str());
+            return -1;
+        }
+
+        for (auto& item : output_blobs) {
+            auto iter = reference.output_data.find(item.first);
+            if (iter == reference.output_data.end()) {
+                LOGE("output (%s) is not found in the reference!\n", item.first.c_str());
+                return -1;
+            }
+            // outputs of other data types are not compared
+            if (iter->second[i].empty()) {
+                continue;
+            }
+            std::vector<float> data;
+            status = GetBlobFloatData(instance, item.second, data);
+            if (status != TNN_OK) {
+                LOGE("get output (%s) data failed!\n", item.first.c_str());
+                return -1;
+            }
+            output_error[item.first] += CosineDistance(data, iter->second[i]);
+        }
+    }
+
+    error = 0;
+    for (auto& item : output_error) {
+        error = std::max(error, item.second / sample_count);
+    }
+
+    return 0;
+}
+
+void Calibration::ApplyFp32Layers(NetStructure* net_struct, NetResource* net_resource,
+                                  const std::set<std::string>& fp32_layers) {
+    // layers are in topological order, the input layer of a merged layer is updated before it
+    for (auto& item : net_struct->layers) {
+        if (!item->param->quantized) {
+            continue;
+        }
+        if (fp32_layers.find(item->name) != fp32_layers.end()) {
+            item->param->quantized = false;
+            auto iter              = fp32_resources_.find(item->name);
+            if (iter != fp32_resources_.end()) {
+                net_resource->resource_map[item->name] = iter->second;
+            }
+        } else if (kBlobScaleMergeLayerTypeStr.find(item->type) != kBlobScaleMergeLayerTypeStr.end()) {
+            // quantized by MergeBlobScale because the input layer is quantized
+            LayerInfo* pre_layer_info = GetLayerInfoFromOutpubBlobName(item->inputs[0], net_struct);
+            if (pre_layer_info != nullptr && !pre_layer_info->param->quantized) {
+                item->param->quantized = false;
+            }
+        }
+    }
+}
+
 }  // namespace TNN_NS
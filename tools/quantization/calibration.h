@@ -15,6 +15,7 @@
 #ifndef TNN_TOOLS_QUANTIZATION_CALIBRATION_H_
 #define TNN_TOOLS_QUANTIZATION_CALIBRATION_H_
 
+#include <functional>
 #include <memory>
 #include "tnn/core/blob.h"
 #include "tnn/core/instance.h"
@@ -27,6 +28,19 @@
 
 namespace TNN_NS {
 
+typedef std::map<Blob*, std::shared_ptr<ScaleCalculator>> FeatureMap;
+typedef std::function<void(ScaleCalculator*)> ScaleCalculatorFunc;
+
+// measurements of the mixed precision search, accumulated over the search samples
+struct SearchProfile {
+    // blob name -> sum of (1 - cosine similarity) against the fp32 reference
+    std::map<std::string, double> blob_error;
+    // layer name -> sum of the forward time in ms
+    std::map<std::string, double> layer_time;
+    // output blob name -> fp32 data of each sample, only filled for the reference
+    std::map<std::string, std::vector<std::vector<float>>> output_data;
+};
+
 class Calibration {
 public:
     // @brief Calibration Constructor
@@ -57,9 +71,17 @@ public:
 
 private:
     int CalBlobScale(DataSet& dataset);
-    int InitFeatureMap();
+    int InitInstancePool(DataSet& dataset);
+    int InitFeatureMap(std::shared_ptr<Instance> instance, FeatureMap& feature_map);
     int UpdateBlobRange(DataSet& dataset);
     int UpdateBlobDistribute(DataSet& dataset);
+    int UpdateBlobRangeAndDistribute(DataSet& dataset);
+    // @brief forward the files of dataset on the instance pool, instance i reads the files i, i + n, ...
+    // clear_func and update_func are called on the calculators of the feature map of the instance
+    int ForwardDataSet(DataSet& dataset, ScaleCalculatorFunc clear_func, ScaleCalculatorFunc update_func);
+    // @brief call func with each calculator of the first instance and the calculators of the same blob
+    // in the other instances
+    int ForEachWorkerCalculator(std::function<int(ScaleCalculator* first, ScaleCalculator* worker)> func);
     IntScaleResource* CreateIntScale(std::vector<float> scale_vec);
     IntScaleResource* CreateIntScale(std::vector<float> scale_vec, std::vector<int8_t> zero_point_vec);
 
@@ -76,10 +98,32 @@ private:
     void MergeBlobScaleRecursion(LayerInfo* layer_info, NetStructure* net_struct, NetResource* net_resource);
     LayerInfo* GetLayerInfoFromOutpubBlobName(std::string blob_name, NetStructure* net_struct);
 
+    // @brief greedily keep the quantized layers with the largest error per saved latency in fp32 until the error of
+    // the outputs is within max_output_error
+    int SearchMixedPrecision(DataSet& dataset);
+    // @brief create an instance on the search device with the quantized net, the layers in fp32_layers are in fp32
+    std::shared_ptr<Instance> CreateSearchInstance(const std::set<std::string>& fp32_layers, DataSet& dataset);
+    // @brief forward the search samples on the fp32 reference and the quantized instance, profile the layers of both
+    // and compare each blob of the quantized instance with the reference like the per layer check of model_check
+    int ProfileSearchInstances(std::shared_ptr<Instance> reference, std::shared_ptr<Instance> quantized,
+                               DataSet& dataset, SearchProfile& fp32_profile, SearchProfile& int8_profile);
+    // @brief max mean error of the outputs of instance against the reference outputs
+    int CalOutputError(std::shared_ptr<Instance> instance, DataSet& dataset, SearchProfile& reference, double& error);
+    // @brief restore the quantized layers in fp32_layers to fp32, merged relu and pooling layers follow their inputs
+    void ApplyFp32Layers(NetStructure* net_struct, NetResource* net_resource,
+                         const std::set<std::string>& fp32_layers);
+
     std::shared_ptr<DefaultModelInterpreter> interpreter_;
     std::shared_ptr<Instance> instance_;
-    std::map<Blob*, std::shared_ptr<ScaleCalculator>> feature_map_;
+    NetworkConfig net_config_;
+    ModelConfig model_config_;
+    // instance_ and the instances created for num_threads, each with the feature map of its own blobs
+    std::vector<std::shared_ptr<Instance>> instances_;
+    std::vector<FeatureMap> feature_maps_;
     CalibrationParam cali_params_;
+    // fp32 resources of the quantized layers, to restore the layers kept in fp32
+    std::map<std::string, std::shared_ptr<LayerResource>> fp32_resources_;
+    std::set<std::string> fp32_layers_;
 };
 
 }  // namespace TNN_NS
@@ -16,6 +16,7 @@
 #define TNN_TOOLS_QUANTIZATION_CALIBRATION_COMMON_H_
 
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -54,6 +55,16 @@ struct CalibrationParam {
     std::vector<float> input_bias             = {0, 0, 0, 0};
     std::vector<float> input_scale            = {1.0f, 1.0f, 1.0f, 1.0f};
     bool reverse_channel                      = false;
+    /* number of instances forwarding shards of the data set in parallel */
+    int num_threads                           = 1;
+    /* collect blob ranges and distributes in one pass over the data set */
+    bool single_pass                          = false;
+    /* names of the layers kept in fp32 */
+    std::set<std::string> fp32_layers;
+    /* max error (1 - cosine similarity) of the outputs against fp32, if > 0, more layers are kept in fp32 to meet it */
+    float max_output_error                    = 0.0f;
+    /* device to measure the error and the latency of layers on in the mixed precision search */
+    DeviceType search_device                  = DEVICE_NAIVE;
 };
 
 }  // namespace TNN_NS
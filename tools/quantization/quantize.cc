@@ -178,7 +178,8 @@ bool CheckFileName(std::string name) {
 void PrintConfig() {
     printf(
         "usage:\n./quantization_cmd [-h] [-p] <proto file> [-m] <model file> [-i] <input folder> [-b] <val> [-w] <val> "
-        "[-n] <val> [-s] <val> [-t] <val> [-o] <output_name>\n"
+        "[-n] <val> [-s] <val> [-t] <val> [-j] <val> [-a] <val> [-f] <layers> [-e] <val> [-d] <device> "
+        "[-o] <output_name>\n"
         "\t-h, --help        \t show this message\n"
         "\t-p, --proto       \t(require) tnn proto file name\n"
         "\t-m, --model       \t(require) tnn model file name\n"
@@ -207,6 +208,14 @@ void PrintConfig() {
         "\t\t0: per-channel mode  (default)\n"
         "\t\t1: mix mode          weight: per-channel  blob: per-tensor\n"
         "\t\t2: per-tensor mode\n"
+        "\t-j, --num_threads \t(optional) number of instances calibrating in parallel, 1 by default\n"
+        "\t-a, --single_pass \t(optional) collect blob range and distribution in one pass over the inputs\n"
+        "\t\t0: two passes  (default)\n"
+        "\t\t1: one pass, the distribution of KL_DIVERGENCE is rebinned as the range grows\n"
+        "\t-f, --fp32_layers \t(optional) names of the layers kept in fp32, ie, conv1,fc2\n"
+        "\t-e, --max_error   \t(optional) max error (1 - cosine similarity) of the outputs against the fp32 model,\n"
+        "\t\tif set, the layers with the largest error per saved latency are kept in fp32 until it is met\n"
+        "\t-d, --search_device\t(optional) device to measure the error and the latency on, NAIVE (default), X86, ARM\n"
         "\t-o, --output       \t(optional) specify the name of output\n");
 }
 
@@ -228,11 +237,16 @@ int main(int argc, char* argv[]) {
                                     {"bias", required_argument, 0, 'n'},
                                     {"scale", required_argument, 0, 's'},
                                     {"merge_type", required_argument, 0, 't'},
+                                    {"num_threads", required_argument, 0, 'j'},
+                                    {"single_pass", required_argument, 0, 'a'},
+                                    {"fp32_layers", required_argument, 0, 'f'},
+                                    {"max_error", required_argument, 0, 'e'},
+                                    {"search_device", required_argument, 0, 'd'},
                                     {"output", required_argument, 0, 'o'},
                                     {"help", no_argument, 0, 'h'},
                                     {0, 0, 0, 0}};
 
-    const char* optstring = "p:m:i:b:w:r:n:s:t:o:h";
+    const char* optstring = "p:m:i:b:w:r:n:s:t:j:a:f:e:d:o:h";
 
     if (argc == 1) {
         PrintConfig();
@@ -317,6 +331,43 @@ int main(int argc, char* argv[]) {
                     cali_params.merge_weights_channel = false;
                 }
             } break;
+            case 'j':
+                printf("num threads: %s\n", optarg);
+                cali_params.num_threads = atoi(optarg);
+                break;
+            case 'a':
+                printf("single pass: %s\n", optarg);
+                cali_params.single_pass = atoi(optarg) == 1;
+                break;
+            case 'f': {
+                printf("fp32 layers: %s\n", optarg);
+                std::vector<std::string> array;
+                SplitUtils::SplitStr(optarg, array, ",");
+                cali_params.fp32_layers.insert(array.begin(), array.end());
+            } break;
+            case 'e':
+                printf("max output error: %s\n", optarg);
+                if (!CheckNumberString(optarg)) {
+                    printf("invalid max error value: %s\n", optarg);
+                    return -1;
+                }
+                cali_params.max_output_error = atof(optarg);
+                break;
+            case 'd': {
+                printf("search device: %s\n", optarg);
+                std::string device = optarg;
+                std::transform(device.begin(), device.end(), device.begin(), ::toupper);
+                if ("X86" == device) {
+                    cali_params.search_device = DEVICE_X86;
+                } else if ("ARM" == device) {
+                    cali_params.search_device = DEVICE_ARM;
+                } else if ("NAIVE" == device) {
+                    cali_params.search_device = DEVICE_NAIVE;
+                } else {
+                    printf("invalid search device: %s\n", optarg);
+                    return -1;
+                }
+            } break;
             case 'o':
                 printf("output name: %s\n", optarg);
                 output_name = optarg;
@@ -22,6 +22,9 @@
 
 namespace TNN_NS {
 
+// initial count of every bin, keeps the kl divergence finite
+static const float kDistributeInitValue = 1.0e-7;
+
 // Given distribution P and Q, KL-Divergence is
 // Sum(P[i] * log(P[i] / Q[i]))
 static float KlDivergence(const std::vector<float>& dis_ref, const std::vector<float>& dis_epd) {
@@ -104,6 +107,10 @@ int ScaleCalculator::SetQuantizeMethod(CalibrationMethod method) {
     return 0;
 }
 
+CalibrationMethod ScaleCalculator::GetQuantizeMethod() {
+    return cali_method_;
+}
+
 void ScaleCalculator::SetMergeChannel(bool merge) {
     merge_channel_ = merge;
 }
@@ -181,7 +188,7 @@ int ScaleCalculator::ResetDistribute() {
     }
 
     for (auto& item : distribute_per_channel_) {
-        std::fill(item.begin(), item.end(), 1.0e-7);
+        std::fill(item.begin(), item.end(), kDistributeInitValue);
     }
 
     return 0;
@@ -227,6 +234,122 @@ int ScaleCalculator::UpdateDistribute() {
     return 0;
 }
 
+int ScaleCalculator::ClearDistribute() {
+    std::fill(interval_per_channel_.begin(), interval_per_channel_.end(), 0.0f);
+    std::fill(valid_channel_.begin(), valid_channel_.end(), false);
+    for (auto& item : distribute_per_channel_) {
+        std::fill(item.begin(), item.end(), kDistributeInitValue);
+    }
+
+    return 0;
+}
+
+void ScaleCalculator::GrowDistribute(int channel_index, int factor) {
+    if (factor <= 1) {
+        return;
+    }
+    std::vector<float>& distribute = distribute_per_channel_[channel_index];
+    std::vector<float> merged(bin_nums_, kDistributeInitValue);
+    for (int i = 0; i < bin_nums_; ++i) {
+        merged[i / factor] += distribute[i] - kDistributeInitValue;
+    }
+    distribute = merged;
+    interval_per_channel_[channel_index] /= factor;
+}
+
+int ScaleCalculator::UpdateStreamDistribute() {
+    if (distribute_done_flag_) {
+        return 0;
+    }
+
+    for (unsigned int i = 0; i < interval_per_channel_.size(); ++i) {
+        float max_val = std::max(std::abs(range_per_channel_[i].first), std::abs(range_per_channel_[i].second));
+        if (max_val > 0.00001) {
+            // power of two ranges, so that histograms of other instances can be merged
+            float range = std::pow(2.0f, std::ceil(std::log2(max_val)));
+            if (!valid_channel_[i]) {
+                valid_channel_[i]        = true;
+                interval_per_channel_[i] = (float)bin_nums_ / range;
+            } else {
+                float cur_range = (float)bin_nums_ / interval_per_channel_[i];
+                if (range > cur_range) {
+                    GrowDistribute(i, static_cast<int>(std::round(range / cur_range)));
+                }
+            }
+        }
+
+        if (merge_channel_)
+            break;
+    }
+
+    return UpdateDistribute();
+}
+
+int ScaleCalculator::MergeRange(const ScaleCalculator& other) {
+    if (other.range_per_channel_.size() != range_per_channel_.size()) {
+        LOGE("merge range of blobs with different channels!\n");
+        return -1;
+    }
+
+    for (unsigned int i = 0; i < range_per_channel_.size(); ++i) {
+        range_per_channel_[i].first  = std::min(range_per_channel_[i].first, other.range_per_channel_[i].first);
+        range_per_channel_[i].second = std::max(range_per_channel_[i].second, other.range_per_channel_[i].second);
+
+        // means of all images, weighted by the number of images of each
+        int index       = index_image_per_channel_[i];
+        int other_index = other.index_image_per_channel_[i];
+        if (index + other_index > 0) {
+            mean_per_channel_[i] =
+                (mean_per_channel_[i] * index + other.mean_per_channel_[i] * other_index) / (index + other_index);
+            mean_abs_per_channel_[i] =
+                (mean_abs_per_channel_[i] * index + other.mean_abs_per_channel_[i] * other_index) /
+                (index + other_index);
+        }
+        index_image_per_channel_[i] = index + other_index;
+    }
+
+    return 0;
+}
+
+void ScaleCalculator::CopyRange(const ScaleCalculator& other) {
+    range_per_channel_       = other.range_per_channel_;
+    mean_per_channel_        = other.mean_per_channel_;
+    mean_abs_per_channel_    = other.mean_abs_per_channel_;
+    index_image_per_channel_ = other.index_image_per_channel_;
+}
+
+int ScaleCalculator::MergeDistribute(const ScaleCalculator& other) {
+    if (other.distribute_per_channel_.size() != distribute_per_channel_.size()) {
+        LOGE("merge distribute of blobs with different channels!\n");
+        return -1;
+    }
+
+    for (unsigned int i = 0; i < distribute_per_channel_.size(); ++i) {
+        if (!other.valid_channel_[i]) {
+            continue;
+        }
+        if (!valid_channel_[i]) {
+            valid_channel_[i]          = true;
+            interval_per_channel_[i]   = other.interval_per_channel_[i];
+            distribute_per_channel_[i] = other.distribute_per_channel_[i];
+            continue;
+        }
+
+        // rebin to the wider of the two histograms
+        if (other.interval_per_channel_[i] < interval_per_channel_[i]) {
+            GrowDistribute(i, static_cast<int>(std::round(interval_per_channel_[i] / other.interval_per_channel_[i])));
+        }
+        const int factor = static_cast<int>(std::round(other.interval_per_channel_[i] / interval_per_channel_[i]));
+        const std::vector<float>& src = other.distribute_per_channel_[i];
+        std::vector<float>& dst       = distribute_per_channel_[i];
+        for (int j = 0; j < bin_nums_; ++j) {
+            dst[j / factor] += src[j] - kDistributeInitValue;
+        }
+    }
+
+    return 0;
+}
+
 int ScaleCalculator::CalculateScale(std::vector<float>& val, std::vector<int8_t>& bias) {
     val.clear();
     bias.clear();
@@ -45,6 +45,9 @@ public:
     // param 0 : method, the method to set
     int SetQuantizeMethod(CalibrationMethod method);
 
+    // @brief: get the quantize method
+    CalibrationMethod GetQuantizeMethod();
+
     // @brief: set merge channel param
     // param 0 : method, the method to set
     void SetMergeChannel(bool merge);
@@ -64,6 +67,23 @@ public:
     // @brief: update distribute.
     int UpdateDistribute();
 
+    // @brief: clear distribute without a range, for UpdateStreamDistribute.
+    int ClearDistribute();
+
+    // @brief: update distribute in the same pass as the range, the histogram range is a power of two and
+    // doubles as often as needed to hold the range seen so far, merging pairs of bins each time.
+    int UpdateStreamDistribute();
+
+    // @brief: merge the range collected by a calculator of the same blob in another instance.
+    int MergeRange(const ScaleCalculator& other);
+
+    // @brief: take the range of other, ResetDistribute then gives the same intervals.
+    void CopyRange(const ScaleCalculator& other);
+
+    // @brief: merge the distribute collected by a calculator of the same blob in another instance, the
+    // intervals of both are the same or differ by a power of two.
+    int MergeDistribute(const ScaleCalculator& other);
+
     // @brief: get the per-channel scale of the given blob
     int CalculateScale(std::vector<float>& val);
     int CalculateScale(std::vector<float>& val, std::vector<int8_t>& bias);
@@ -73,6 +93,8 @@ private:
     int CalculateScalePerDis(std::vector<float>& distribute, float interval, float& output);
     // @brief: analytical-based methods
     int CalculateScaleAnalysis(int channel_index, float& blob_scale, int8_t& bias);
+    // @brief: widen the histogram of the channel by factor, a power of two
+    void GrowDistribute(int channel_index, int factor);
 
     Blob* origin_blob_;
     bool merge_channel_;